@@ -756,7 +756,7 @@ sys_errno_t sys_ipc_hangup(cap_phone_handle_t handle)
 	return rc;
 }
 
-/** Wait for an incoming IPC call or an answer.
+/** Wait for an incoming IPC call or an answer and copy it to userspace.
  *
  * @param calldata Pointer to buffer where the call/answer data is stored.
  * @param usec     Timeout. See waitq_sleep_timeout() for explanation.
@@ -765,7 +765,7 @@ sys_errno_t sys_ipc_hangup(cap_phone_handle_t handle)
  *
  * @return An error code on error.
  */
-sys_errno_t sys_ipc_wait_for_call(ipc_data_t *calldata, uint32_t usec,
+static errno_t wait_for_call(ipc_data_t *calldata, uint32_t usec,
     unsigned int flags)
 {
 	call_t *call = NULL;
@@ -865,6 +865,81 @@ error:
 	return rc;
 }
 
+/** Wait for an incoming IPC call or an answer.
+ *
+ * @param calldata Pointer to buffer where the call/answer data is stored.
+ * @param usec     Timeout. See waitq_sleep_timeout() for explanation.
+ * @param flags    Select mode of sleep operation. See waitq_sleep_timeout()
+ *                 for explanation.
+ *
+ * @return An error code on error.
+ */
+sys_errno_t sys_ipc_wait_for_call(ipc_data_t *calldata, uint32_t usec,
+    unsigned int flags)
+{
+	return wait_for_call(calldata, usec, flags);
+}
+
+/** Wait for incoming IPC calls or answers and receive several at once.
+ *
+ * Waits for the first call the same way as sys_ipc_wait_for_call() and
+ * then also receives the calls that are already pending, so that a busy
+ * task can drain its answerbox with fewer syscalls.
+ *
+ * @param calldata Pointer to an array of @a count buffers where the
+ *                 call/answer data is stored.
+ * @param count    Maximal number of calls to receive.
+ * @param received Pointer to where the number of received calls is stored.
+ * @param usec     Timeout for the first call. See waitq_sleep_timeout() for
+ *                 explanation.
+ * @param flags    Select mode of sleep operation for the first call. See
+ *                 waitq_sleep_timeout() for explanation.
+ *
+ * @return An error code if no call was received or if the number of
+ *         received calls could not be stored. In the latter case,
+ *         @a received still counts the calls received before.
+ */
+sys_errno_t sys_ipc_wait_for_calls(ipc_data_t *calldata, size_t count,
+    size_t *received, uint32_t usec, unsigned int flags)
+{
+	if (count == 0)
+		return EINVAL;
+
+	/*
+	 * Make sure we can report the number of calls before we receive any,
+	 * since they could not be returned to the answerbox afterwards.
+	 */
+	size_t n = 0;
+	errno_t rc = copy_to_uspace(received, &n, sizeof(n));
+	if (rc != EOK)
+		return rc;
+
+	rc = wait_for_call(&calldata[0], usec, flags);
+	if (rc != EOK)
+		return rc;
+
+	/*
+	 * Update the number of calls after each call, so that the calls
+	 * already delivered stay accounted for should storing it fail.
+	 */
+	n = 1;
+	while (true) {
+		rc = copy_to_uspace(received, &n, sizeof(n));
+		if (rc != EOK || n == count)
+			return rc;
+
+		/*
+		 * Stop at the first failure. This includes a wakeup by
+		 * sys_ipc_poke(), which we are returning to userspace for anyway.
+		 */
+		if (wait_for_call(&calldata[n], SYNCH_NO_TIMEOUT,
+		    SYNCH_FLAGS_NON_BLOCKING) != EOK)
+			return EOK;
+
+		n++;
+	}
+}
+
 /** Interrupt one thread from sys_ipc_wait_for_call().
  *
  */
@@ -47,6 +47,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <deque>
@@ -100,11 +101,31 @@
 
 #include <__bits/trycatch.hpp>
 
-int main()
+int main(int argc, char* argv[])
 {
+    if (argc > 1 && std::string{argv[1]} == "--bench")
+    {
+        std::test::test_set bs{};
+        bs.add<std::test::sort_benchmark>();
+        bs.add<std::test::flat_hash_benchmark>();
+        bs.add<std::test::async_benchmark>();
+        bs.add<std::test::io_benchmark>();
+        bs.add<std::test::numconv_benchmark>();
+        bs.add<std::test::node_alloc_benchmark>();
+        bs.add<std::test::pmr_benchmark>();
+        bs.add<std::test::random_benchmark>();
+        bs.add<std::test::regex_benchmark>();
+        bs.add<std::test::valarray_benchmark>();
+        bs.add<std::test::container_benchmark>();
+
+        return bs.run(true) ? 0 : 1;
+    }
+
     std::test::test_set ts{};
     ts.add<std::test::vector_test>();
     ts.add<std::test::string_test>();
+    ts.add<std::test::string_view_test>();
+    ts.add<std::test::span_test>();
     ts.add<std::test::array_test>();
     ts.add<std::test::bitset_test>();
     ts.add<std::test::deque_test>();
@@ -113,13 +134,22 @@ int main()
     ts.add<std::test::set_test>();
     ts.add<std::test::unordered_map_test>();
     ts.add<std::test::unordered_set_test>();
+    ts.add<std::test::flat_hash_test>();
     ts.add<std::test::numeric_test>();
     ts.add<std::test::adaptors_test>();
     ts.add<std::test::memory_test>();
+    ts.add<std::test::memory_resource_test>();
     ts.add<std::test::list_test>();
     ts.add<std::test::ratio_test>();
     ts.add<std::test::functional_test>();
     ts.add<std::test::algorithm_test>();
+    ts.add<std::test::atomic_test>();
+    ts.add<std::test::future_test>();
+    ts.add<std::test::mutex_test>();
+    ts.add<std::test::charconv_test>();
+    ts.add<std::test::random_test>();
+    ts.add<std::test::regex_test>();
+    ts.add<std::test::valarray_test>();
 
     return ts.run(true) ? 0 : 1;
 }
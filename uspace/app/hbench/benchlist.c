@@ -40,6 +40,9 @@
 benchmark_t *benchmarks[] = {
 	&benchmark_dir_read,
 	&benchmark_fibril_mutex,
+	&benchmark_fibril_spawn,
+	&benchmark_fibril_timeout,
+	&benchmark_fibril_yield,
 	&benchmark_file_read,
 	&benchmark_malloc1,
 	&benchmark_malloc2,
@@ -118,6 +118,16 @@ static inline void bench_run_stop(bench_run_t *run)
 	stopwatch_stop(&run->stopwatch);
 }
 
+/** Workload executed by bench_run_parallel().
+ *
+ * Arguments are the same as with benchmark_entry_t.
+ */
+typedef bool (*bench_worker_t)(bench_run_t *, uint64_t);
+
+extern bool bench_run_parallel(bench_env_t *, bench_run_t *, uint64_t,
+    bench_worker_t);
+extern bool bench_run_runners(bench_env_t *, bench_run_t *);
+
 extern errno_t csv_report_open(const char *);
 extern void csv_report_add_entry(bench_run_t *, int, benchmark_t *, uint64_t);
 extern void csv_report_close(void);
@@ -133,6 +143,9 @@ extern size_t benchmark_count;
 /* Put your benchmark descriptors here (and also to benchlist.c). */
 extern benchmark_t benchmark_dir_read;
 extern benchmark_t benchmark_fibril_mutex;
+extern benchmark_t benchmark_fibril_spawn;
+extern benchmark_t benchmark_fibril_timeout;
+extern benchmark_t benchmark_fibril_yield;
 extern benchmark_t benchmark_file_read;
 extern benchmark_t benchmark_malloc1;
 extern benchmark_t benchmark_malloc2;
@@ -31,9 +31,12 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <ipc_test.h>
+#include <ipc/ipc_test.h>
 #include <async.h>
 #include <errno.h>
+#include <str.h>
 #include <str_error.h>
 #include "../hbench.h"
 
@@ -57,12 +60,76 @@ static bool teardown(bench_env_t *env, bench_run_t *run)
 	return true;
 }
 
+/*
+ * Keeps up to pipeline pings in flight, so that the server and the client
+ * find several calls or answers pending whenever they wait for IPC.
+ */
+static bool runner_pipelined(bench_run_t *run, uint64_t niter,
+    uint64_t pipeline)
+{
+	aid_t *pending = calloc(pipeline, sizeof(aid_t));
+	if (pending == NULL) {
+		return bench_run_fail(run, "failed to allocate %" PRIu64
+		    " pending pings", pipeline);
+	}
+
+	errno_t rc = EOK;
+	uint64_t sent = 0;
+	uint64_t done = 0;
+
+	bench_run_start(run);
+
+	async_exch_t *exch = async_exchange_begin(test->sess);
+
+	while (done < niter) {
+		while (sent < niter && sent - done < pipeline) {
+			pending[sent % pipeline] = async_send_0(exch,
+			    IPC_TEST_PING, NULL);
+			sent++;
+		}
+
+		errno_t retval;
+		async_wait_for(pending[done % pipeline], &retval);
+		done++;
+
+		if (retval != EOK && rc == EOK) {
+			rc = retval;
+			/* Do not send any more, only collect what is pending. */
+			niter = sent;
+		}
+	}
+
+	async_exchange_end(exch);
+
+	bench_run_stop(run);
+
+	free(pending);
+
+	if (rc != EOK) {
+		return bench_run_fail(run, "failed sending ping message: %s (%d)",
+		    str_error(rc), rc);
+	}
+
+	return true;
+}
+
 static bool runner(bench_env_t *env, bench_run_t *run, uint64_t niter)
 {
+	const char *pipeline_str = bench_env_param_get(env, "pipeline", "1");
+	uint64_t pipeline;
+	errno_t rc = str_uint64_t(pipeline_str, NULL, 10, true, &pipeline);
+	if ((rc != EOK) || (pipeline == 0)) {
+		return bench_run_fail(run, "invalid pipeline depth '%s'",
+		    pipeline_str);
+	}
+
+	if (pipeline > 1)
+		return runner_pipelined(run, niter, pipeline);
+
 	bench_run_start(run);
 
 	for (uint64_t count = 0; count < niter; count++) {
-		errno_t rc = ipc_test_ping(test);
+		rc = ipc_test_ping(test);
 
 		if (rc != EOK) {
 			return bench_run_fail(run, "failed sending ping message: %s (%d)",
@@ -77,7 +144,8 @@ static bool runner(bench_env_t *env, bench_run_t *run, uint64_t niter)
 
 benchmark_t benchmark_ping_pong = {
 	.name = "ping_pong",
-	.desc = "IPC ping-pong benchmark",
+	.desc = "IPC ping-pong benchmark "
+	    "(-p pipeline=N keeps N pings in flight)",
 	.entry = &runner,
 	.setup = &setup,
 	.teardown = &teardown
@@ -35,9 +35,8 @@
 #include <stdlib.h>
 #include "../hbench.h"
 
-static bool runner(bench_env_t *env, bench_run_t *run, uint64_t size)
+static bool worker(bench_run_t *run, uint64_t size)
 {
-	bench_run_start(run);
 	for (uint64_t i = 0; i < size; i++) {
 		void *p = malloc(1);
 		if (p == NULL) {
@@ -47,14 +46,19 @@ static bool runner(bench_env_t *env, bench_run_t *run, uint64_t size)
 		}
 		free(p);
 	}
-	bench_run_stop(run);
 
 	return true;
 }
 
+static bool runner(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	return bench_run_parallel(env, run, size, worker);
+}
+
 benchmark_t benchmark_malloc1 = {
 	.name = "malloc1",
-	.desc = "User-space memory allocator benchmark, repeatedly allocate one block",
+	.desc = "User-space memory allocator benchmark, repeatedly allocate one block "
+	    "(-p threads=N runs it in N threads at once)",
 	.entry = &runner,
 	.setup = NULL,
 	.teardown = NULL
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2019 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup hbench
+ * @{
+ */
+
+#include <fibril.h>
+#include <fibril_synch.h>
+#include "../hbench.h"
+
+/*
+ * Throughput of the fibril scheduler with many short-lived fibrils.
+ * The fibrils are started by one fibril, but with more runners, they are
+ * taken over by the other threads.
+ *
+ * Fibrils are started in batches, so that there are never too many
+ * stacks allocated at once.
+ */
+
+#define SPAWN_BATCH 64
+
+static errno_t worker(void *arg)
+{
+	fibril_semaphore_t *done = arg;
+
+	fibril_semaphore_up(done);
+	return EOK;
+}
+
+static bool runner(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	if (!bench_run_runners(env, run))
+		return false;
+
+	fibril_semaphore_t done;
+	fibril_semaphore_initialize(&done, 0);
+
+	bool ok = true;
+	uint64_t running = 0;
+
+	bench_run_start(run);
+
+	for (uint64_t i = 0; i < size; i++) {
+		fid_t fibril = fibril_create(worker, &done);
+		if (fibril == 0) {
+			ok = bench_run_fail(run, "failed to create fibril %"
+			    PRIu64 " (out of %" PRIu64 ")", i + 1, size);
+			break;
+		}
+
+		fibril_start(fibril);
+		running++;
+
+		if (running == SPAWN_BATCH) {
+			for (; running > 0; running--)
+				fibril_semaphore_down(&done);
+		}
+	}
+
+	for (; running > 0; running--)
+		fibril_semaphore_down(&done);
+
+	bench_run_stop(run);
+
+	return ok;
+}
+
+benchmark_t benchmark_fibril_spawn = {
+	.name = "fibril_spawn",
+	.desc = "Speed of starting fibrils that finish right away "
+	    "(-p runners=N runs them in N threads)",
+	.entry = &runner,
+	.setup = NULL,
+	.teardown = NULL
+};
+
+/** @}
+ */
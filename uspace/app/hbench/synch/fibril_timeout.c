@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2019 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/** @addtogroup hbench
+ * @{
+ */
+
+#include <as.h>
+#include <fibril.h>
+#include <fibril_synch.h>
+#include <str.h>
+#include "../hbench.h"
+
+/*
+ * Cost of arming and cancelling a fibril timeout while many other timeouts
+ * are pending. Two fibrils take turns, each waiting on a condition variable
+ * with a timeout, while a crowd of sleepers waits for timeouts far in the
+ * future.
+ *
+ * Sleepers only block, so they get small stacks to keep the memory needed
+ * for many of them low.
+ */
+
+#define SLEEPER_STACK_SIZE (4 * PAGE_SIZE)
+
+/*
+ * Sleepers wait from one to two hours. Takers wait longer, so that their
+ * timeouts come after all the others.
+ */
+#define SLEEPER_TIMEOUT_USEC  (3600 * 1000 * 1000LL)
+#define TURN_TIMEOUT_USEC     (3 * 3600 * 1000 * 1000LL)
+
+typedef struct {
+	fibril_mutex_t lock;
+	fibril_condvar_t sleep_cv;
+	fibril_condvar_t turn_cv;
+	bool stop;
+	uint64_t sleepers;
+	uint64_t takers;
+	uint64_t turn;
+	uint64_t turns;
+	fibril_semaphore_t done;
+} shared_t;
+
+static errno_t sleeper(void *arg)
+{
+	shared_t *shared = arg;
+
+	fibril_mutex_lock(&shared->lock);
+
+	/* Spread the timeouts over an hour. */
+	usec_t timeout = SLEEPER_TIMEOUT_USEC +
+	    (usec_t) (shared->sleepers++ % 3600) * 1000 * 1000;
+
+	while (!shared->stop) {
+		fibril_condvar_wait_timeout(&shared->sleep_cv, &shared->lock,
+		    timeout);
+	}
+
+	fibril_mutex_unlock(&shared->lock);
+
+	fibril_semaphore_up(&shared->done);
+	return EOK;
+}
+
+static errno_t taker(void *arg)
+{
+	shared_t *shared = arg;
+
+	fibril_mutex_lock(&shared->lock);
+
+	/* Alternate with the other taker, this one goes when turn is odd. */
+	uint64_t parity = shared->takers++ % 2;
+
+	for (uint64_t i = 0; i < shared->turns; i++) {
+		while (shared->turn % 2 != parity) {
+			fibril_condvar_wait_timeout(&shared->turn_cv,
+			    &shared->lock, TURN_TIMEOUT_USEC);
+		}
+
+		shared->turn++;
+		fibril_condvar_broadcast(&shared->turn_cv);
+	}
+
+	fibril_mutex_unlock(&shared->lock);
+
+	fibril_semaphore_up(&shared->done);
+	return EOK;
+}
+
+static void stop_sleepers(shared_t *shared, uint64_t count)
+{
+	fibril_mutex_lock(&shared->lock);
+	shared->stop = true;
+	fibril_condvar_broadcast(&shared->sleep_cv);
+	fibril_mutex_unlock(&shared->lock);
+
+	for (uint64_t i = 0; i < count; i++)
+		fibril_semaphore_down(&shared->done);
+}
+
+static bool runner(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	const char *timers_str = bench_env_param_get(env, "timers", "100000");
+	uint64_t timer_count;
+	errno_t rc = str_uint64_t(timers_str, NULL, 10, true, &timer_count);
+	if (rc != EOK) {
+		return bench_run_fail(run, "invalid timer count '%s'",
+		    timers_str);
+	}
+
+	shared_t shared;
+	fibril_mutex_initialize(&shared.lock);
+	fibril_condvar_initialize(&shared.sleep_cv);
+	fibril_condvar_initialize(&shared.turn_cv);
+	shared.stop = false;
+	shared.sleepers = 0;
+	shared.takers = 0;
+	shared.turn = 0;
+	shared.turns = size / 2;
+	fibril_semaphore_initialize(&shared.done, 0);
+
+	for (uint64_t i = 0; i < timer_count; i++) {
+		fid_t fibril = fibril_create_generic(sleeper, &shared,
+		    SLEEPER_STACK_SIZE);
+		if (fibril == 0) {
+			stop_sleepers(&shared, i);
+			return bench_run_fail(run, "failed to create sleeper %"
+			    PRIu64 " (out of %" PRIu64 ")", i + 1, timer_count);
+		}
+
+		fibril_start(fibril);
+	}
+
+	/* Let all the sleepers arm their timeouts. */
+	fibril_yield();
+
+	fid_t takers[2];
+	for (int i = 0; i < 2; i++) {
+		takers[i] = fibril_create(taker, &shared);
+		if (takers[i] == 0) {
+			if (i > 0)
+				fibril_destroy(takers[0]);
+			stop_sleepers(&shared, timer_count);
+			return bench_run_fail(run, "failed to create fibril");
+		}
+	}
+
+	bench_run_start(run);
+
+	fibril_start(takers[0]);
+	fibril_start(takers[1]);
+	fibril_semaphore_down(&shared.done);
+	fibril_semaphore_down(&shared.done);
+
+	bench_run_stop(run);
+
+	stop_sleepers(&shared, timer_count);
+	return true;
+}
+
+benchmark_t benchmark_fibril_timeout = {
+	.name = "fibril_timeout",
+	.desc = "Speed of arming and cancelling a fibril timeout "
+	    "while many others are pending (-p timers=N sets their count)",
+	.entry = &runner,
+	.setup = NULL,
+	.teardown = NULL
+};
+
+/** @}
+ */
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2019 Vojtech Horky
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** @addtogroup hbench
+ * @{
+ */
+
+#include <fibril.h>
+#include <fibril_synch.h>
+#include <stdlib.h>
+#include <str.h>
+#include "../hbench.h"
+
+/*
+ * Throughput of the fibril scheduler when several fibrils keep yielding
+ * to each other. With more runners, they are spread over more threads.
+ */
+
+typedef struct {
+	uint64_t yields;
+	fibril_semaphore_t done;
+} shared_t;
+
+static errno_t yielder(void *arg)
+{
+	shared_t *shared = arg;
+
+	for (uint64_t i = 0; i < shared->yields; i++)
+		fibril_yield();
+
+	fibril_semaphore_up(&shared->done);
+	return EOK;
+}
+
+static bool runner(bench_env_t *env, bench_run_t *run, uint64_t size)
+{
+	if (!bench_run_runners(env, run))
+		return false;
+
+	const char *fibrils_str = bench_env_param_get(env, "fibrils", "4");
+	uint64_t fibril_count;
+	errno_t rc = str_uint64_t(fibrils_str, NULL, 10, true, &fibril_count);
+	if ((rc != EOK) || (fibril_count == 0)) {
+		return bench_run_fail(run, "invalid fibril count '%s'",
+		    fibrils_str);
+	}
+
+	fid_t *fibrils = calloc(fibril_count, sizeof(fid_t));
+	if (fibrils == NULL) {
+		return bench_run_fail(run, "failed to allocate %" PRIu64
+		    " fibrils", fibril_count);
+	}
+
+	shared_t shared;
+	shared.yields = size / fibril_count;
+	fibril_semaphore_initialize(&shared.done, 0);
+
+	for (uint64_t i = 0; i < fibril_count; i++) {
+		fibrils[i] = fibril_create(yielder, &shared);
+		if (fibrils[i] == 0) {
+			for (uint64_t j = 0; j < i; j++)
+				fibril_destroy(fibrils[j]);
+			free(fibrils);
+			return bench_run_fail(run, "failed to create fibril %"
+			    PRIu64, i + 1);
+		}
+	}
+
+	bench_run_start(run);
+
+	for (uint64_t i = 0; i < fibril_count; i++)
+		fibril_start(fibrils[i]);
+
+	for (uint64_t i = 0; i < fibril_count; i++)
+		fibril_semaphore_down(&shared.done);
+
+	bench_run_stop(run);
+
+	free(fibrils);
+	return true;
+}
+
+benchmark_t benchmark_fibril_yield = {
+	.name = "fibril_yield",
+	.desc = "Speed of fibril switches, several fibrils keep yielding "
+	    "(-p fibrils=N sets their count, -p runners=N runs them in N threads)",
+	.entry = &runner,
+	.setup = NULL,
+	.teardown = NULL
+};
+
+/** @}
+ */
@@ -33,10 +33,29 @@
  * @file
  */
 
+#include <fibril.h>
+#include <fibril_synch.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <str.h>
+#include <str_error.h>
+#include <thread.h>
 #include "hbench.h"
 
+#define WORKER_ERROR_BUFFER_SIZE 256
+
+/** State of one extra thread of bench_run_parallel(). */
+typedef struct {
+	bench_worker_t worker;
+	uint64_t size;
+	fibril_semaphore_t *start;
+	fibril_semaphore_t *done;
+	bench_run_t run;
+	char error_buffer[WORKER_ERROR_BUFFER_SIZE];
+	bool ok;
+} worker_thread_t;
+
 /** Initialize bench run structure.
  *
  * @param run Structure to intialize.
@@ -75,5 +94,143 @@ bool bench_run_fail(bench_run_t *run, const char *fmt, ...)
 	return false;
 }
 
+static void worker_thread_fn(void *arg)
+{
+	worker_thread_t *thread = arg;
+
+	fibril_semaphore_down(thread->start);
+	thread->ok = thread->worker(&thread->run, thread->size);
+	fibril_semaphore_up(thread->done);
+}
+
+/** Measure a workload executed by several threads at once.
+ *
+ * The number of threads is taken from the "threads" parameter
+ * (defaults to 1). Every thread executes the whole workload,
+ * the measured time is the time until the last of them finishes.
+ * The calling fibril serves as one of the threads.
+ *
+ * @param env Benchmark environment.
+ * @param run Current benchmark run.
+ * @param size Workload size for each of the threads.
+ * @param worker Workload to execute (must not start or stop @p run).
+ * @return Whether all the threads succeeded.
+ */
+bool bench_run_parallel(bench_env_t *env, bench_run_t *run, uint64_t size,
+    bench_worker_t worker)
+{
+	const char *threads_str = bench_env_param_get(env, "threads", "1");
+	uint64_t thread_count;
+	errno_t rc = str_uint64_t(threads_str, NULL, 10, true, &thread_count);
+	if ((rc != EOK) || (thread_count == 0)) {
+		return bench_run_fail(run, "invalid thread count '%s'",
+		    threads_str);
+	}
+
+	size_t extra_count = thread_count - 1;
+	worker_thread_t *threads = NULL;
+	if (extra_count > 0) {
+		threads = calloc(extra_count, sizeof(worker_thread_t));
+		if (threads == NULL) {
+			return bench_run_fail(run, "failed to allocate %zu threads",
+			    extra_count);
+		}
+	}
+
+	fibril_semaphore_t start;
+	fibril_semaphore_t done;
+	fibril_semaphore_initialize(&start, 0);
+	fibril_semaphore_initialize(&done, 0);
+
+	size_t started = 0;
+	for (; started < extra_count; started++) {
+		worker_thread_t *thread = &threads[started];
+		thread->worker = worker;
+		thread->size = size;
+		thread->start = &start;
+		thread->done = &done;
+		bench_run_init(&thread->run, thread->error_buffer,
+		    WORKER_ERROR_BUFFER_SIZE);
+
+		thread_id_t tid;
+		rc = thread_create(worker_thread_fn, thread, "hbench worker",
+		    &tid);
+		if (rc != EOK)
+			break;
+
+		thread_detach(tid);
+	}
+
+	bool ok = true;
+
+	if (started < extra_count) {
+		ok = bench_run_fail(run, "failed to create thread %zu: %s",
+		    started + 1, str_error(rc));
+	}
+
+	/* Thread creation is not part of the measurement. */
+	bench_run_start(run);
+
+	for (size_t i = 0; i < started; i++)
+		fibril_semaphore_up(&start);
+
+	if (ok)
+		ok = worker(run, size);
+
+	for (size_t i = 0; i < started; i++)
+		fibril_semaphore_down(&done);
+
+	bench_run_stop(run);
+
+	for (size_t i = 0; ok && (i < started); i++) {
+		if (!threads[i].ok) {
+			ok = bench_run_fail(run, "thread %zu: %s", i + 1,
+			    threads[i].error_buffer);
+		}
+	}
+
+	free(threads);
+	return ok;
+}
+
+/** Make fibrils of the benchmark run in the requested number of runners.
+ *
+ * The number of runners (threads executing fibrils, including the calling
+ * one) is taken from the "runners" parameter and defaults to 1. Runners
+ * cannot be stopped, so once spawned, they stay for the rest of the task.
+ *
+ * @param env Benchmark environment.
+ * @param run Current benchmark run.
+ * @return Whether there are enough runners.
+ */
+bool bench_run_runners(bench_env_t *env, bench_run_t *run)
+{
+	/* The calling thread runs fibrils too. */
+	static uint64_t runner_count = 1;
+
+	const char *runners_str = bench_env_param_get(env, "runners", "1");
+	uint64_t wanted;
+	errno_t rc = str_uint64_t(runners_str, NULL, 10, true, &wanted);
+	if ((rc != EOK) || (wanted == 0)) {
+		return bench_run_fail(run, "invalid runner count '%s'",
+		    runners_str);
+	}
+
+	if (wanted < runner_count) {
+		return bench_run_fail(run, "%" PRIu64 " runners already running",
+		    runner_count);
+	}
+
+	int missing = wanted - runner_count;
+	runner_count += fibril_test_spawn_runners(missing);
+
+	if (runner_count < wanted) {
+		return bench_run_fail(run, "failed to spawn %" PRIu64 " runners",
+		    wanted - runner_count);
+	}
+
+	return true;
+}
+
 /** @}
  */
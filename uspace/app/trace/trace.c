@@ -342,6 +342,30 @@ static void sc_ipc_wait(sysarg_t *sc_args, cap_call_handle_t sc_rc)
 		ipcp_call_in(&call, sc_rc);
 }
 
+static void sc_ipc_wait_batch(sysarg_t *sc_args, errno_t sc_rc)
+{
+	ipc_call_t call;
+	size_t received;
+	errno_t rc;
+
+	if (sc_rc != EOK)
+		return;
+
+	rc = udebug_mem_read(sess, &received, sc_args[2], sizeof(received));
+	if (rc != EOK)
+		return;
+
+	for (size_t i = 0; i < received; i++) {
+		memset(&call, 0, sizeof(call));
+		rc = udebug_mem_read(sess, &call, sc_args[0] + i * sizeof(call),
+		    sizeof(call));
+		if (rc != EOK)
+			return;
+
+		ipcp_call_in(&call, call.cap_handle);
+	}
+}
+
 static void event_syscall_b(unsigned thread_id, uintptr_t thread_hash,
     unsigned sc_id, sysarg_t sc_rc)
 {
@@ -402,6 +426,9 @@ static void event_syscall_e(unsigned thread_id, uintptr_t thread_hash,
 	case SYS_IPC_WAIT:
 		sc_ipc_wait(sc_args, (cap_call_handle_t) sc_rc);
 		break;
+	case SYS_IPC_WAIT_BATCH:
+		sc_ipc_wait_batch(sc_args, (errno_t) sc_rc);
+		break;
 	default:
 		break;
 	}
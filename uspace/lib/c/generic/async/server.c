@@ -123,6 +123,9 @@
 
 #define DPRINTF(...)  ((void) 0)
 
+/** Number of calls the manager takes to dispatch at once. */
+#define MANAGER_BATCH  8
+
 /* Client connection data */
 typedef struct {
 	ht_link_t link;
@@ -980,13 +983,18 @@ static void handle_call(ipc_call_t *call)
  */
 static errno_t async_manager_worker(void)
 {
-	ipc_call_t call;
+	ipc_call_t calls[MANAGER_BATCH];
+	size_t received;
 	errno_t rc;
 
 	while (true) {
-		rc = fibril_ipc_wait(&call, NULL);
-		if (rc == EOK)
-			handle_call(&call);
+		rc = fibril_ipc_wait_batch(calls, MANAGER_BATCH, &received,
+		    NULL);
+		if (rc != EOK)
+			continue;
+
+		for (size_t i = 0; i < received; i++)
+			handle_call(&calls[i]);
 	}
 
 	return 0;
@@ -176,6 +176,27 @@ errno_t ipc_wait(ipc_call_t *call, sysarg_t usec, unsigned int flags)
 	return __SYSCALL3(SYS_IPC_WAIT, (sysarg_t) call, usec, flags);
 }
 
+/** Wait for IPC calls and receive all that are pending, up to a limit.
+ *
+ * The timeout and flags apply to waiting for the first call, the others
+ * are only received if they are already pending.
+ *
+ * @param calls     Array of @a count calls to fill in.
+ * @param count     Maximal number of calls to receive.
+ * @param received  Place to store the number of received calls.
+ * @param usec      Timeout in microseconds.
+ * @param flags     Flags passed to SYS_IPC_WAIT_BATCH.
+ *
+ * @return  EOK if at least one call was received or an error code.
+ *
+ */
+errno_t ipc_wait_batch(ipc_call_t *calls, size_t count, size_t *received,
+    sysarg_t usec, unsigned int flags)
+{
+	return (errno_t) __SYSCALL5(SYS_IPC_WAIT_BATCH, (sysarg_t) calls,
+	    (sysarg_t) count, (sysarg_t) received, usec, flags);
+}
+
 /** Hang up a phone.
  *
  * @param phandle  Handle of the phone to be hung up.
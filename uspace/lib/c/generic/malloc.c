@@ -45,6 +45,8 @@
 #include <mem.h>
 #include <stdlib.h>
 #include <adt/gcdlcm.h>
+#include <adt/list.h>
+#include <adt/odict.h>
 
 #include "private/malloc.h"
 #include "private/fibril.h"
@@ -98,6 +100,41 @@
  */
 #define NET_SIZE(size)  ((size) - STRUCT_OVERHEAD)
 
+/** Number of small bins
+ *
+ * Small bin i holds free blocks with (i + 1) * BASE_ALIGN
+ * bytes of net size. Larger free blocks are kept in a tree
+ * ordered by size.
+ *
+ */
+#define SMALL_BIN_COUNT  64
+
+/** Largest net size of a free block kept in a small bin */
+#define SMALL_BIN_MAX  (SMALL_BIN_COUNT * BASE_ALIGN)
+
+/** Number of block caches in front of the heap
+ *
+ * Each cache is used by one thread at a time, so this
+ * bounds the number of threads that can allocate small
+ * blocks without contention. Must be a power of two.
+ *
+ */
+#define CACHE_COUNT  8
+
+/** Number of size classes in a block cache
+ *
+ * Size class i holds blocks with at least
+ * (i + 1) * BASE_ALIGN bytes of net size.
+ *
+ */
+#define CACHE_CLASSES  32
+
+/** Amount of memory moved between a block cache and the heap at once. */
+#define CACHE_BATCH_BYTES  1024
+
+/** Maximal number of blocks moved between a block cache and the heap at once. */
+#define CACHE_BATCH_MAX  16
+
 /** Get first block in heap area.
  *
  */
@@ -166,6 +203,9 @@ typedef struct {
 	/* Indication of a free block */
 	bool free;
 
+	/* Indication of a used block parked in a block cache */
+	bool cached;
+
 	/** Heap area this block belongs to */
 	heap_area_t *area;
 
@@ -184,18 +224,96 @@ typedef struct {
 	uint32_t magic;
 } heap_block_foot_t;
 
+/** Link of a free heap block
+ *
+ * Stored in the (otherwise unused) data of the block.
+ * Free blocks with less than BASE_ALIGN bytes of net
+ * size have no link. They are not kept in any bin and
+ * wait to be merged with a neighbouring block.
+ *
+ */
+typedef union {
+	/** Link in a small bin */
+	link_t link;
+
+	/** Link in the tree of large free blocks */
+	odlink_t odlink;
+} heap_free_link_t;
+
+static_assert(sizeof(link_t) <= BASE_ALIGN, "");
+static_assert(sizeof(odlink_t) <= SMALL_BIN_MAX, "");
+
+/** Get the link of a free heap block. */
+#define BLOCK_FREE_LINK(head) \
+	((heap_free_link_t *) (((uintptr_t) (head)) + sizeof(heap_block_head_t)))
+
+/** Get the heap block of a free block link. */
+#define FREE_LINK_BLOCK(link) \
+	((heap_block_head_t *) (((uintptr_t) (link)) - sizeof(heap_block_head_t)))
+
 /** First heap area */
 static heap_area_t *first_heap_area = NULL;
 
 /** Last heap area */
 static heap_area_t *last_heap_area = NULL;
 
-/** Next heap block to examine (next fit algorithm) */
-static heap_block_head_t *next_fit = NULL;
+/** Small free blocks, one list for each size */
+static list_t small_bins[SMALL_BIN_COUNT];
+
+/** Bitmap of non-empty small bins */
+static uint64_t small_bin_map = 0;
+
+/** Large free blocks ordered by size */
+static odict_t large_tree;
 
 /** Futex for thread-safe heap manipulation */
 static fibril_rmutex_t malloc_mutex;
 
+/** Block parked in a block cache
+ *
+ * The link is stored in the (otherwise unused) data
+ * of the block.
+ *
+ */
+typedef struct cache_block {
+	struct cache_block *next;
+} cache_block_t;
+
+/** Block cache
+ *
+ * Small blocks released by free() are not returned to the heap
+ * immediately. They are kept in a block cache, sorted by size class,
+ * and handed out again by malloc() without taking the heap lock or
+ * searching the heap. The heap is only visited to move a whole batch
+ * of blocks at once.
+ *
+ * The blocks in a cache are still marked as used in the heap.
+ *
+ */
+typedef struct {
+	/** Serializes access to the cache */
+	fibril_rmutex_t lock;
+
+	/** Lists of cached blocks, one for each size class */
+	cache_block_t *bins[CACHE_CLASSES];
+
+	/** Number of blocks in each list */
+	size_t counts[CACHE_CLASSES];
+} malloc_cache_t;
+
+/** Block caches in front of the heap */
+static malloc_cache_t malloc_caches[CACHE_COUNT];
+
+/** Index of the block cache the current fibril used last
+ *
+ * Fibrils stick to a block cache as long as they find it
+ * unlocked. A cache is only locked for the duration of a single
+ * operation and a fibril cannot be switched while it holds it,
+ * so concurrently running threads spread over the caches.
+ *
+ */
+static fibril_local unsigned int malloc_cache_hint = 0;
+
 #define malloc_assert(expr) safe_assert(expr)
 
 /** Serializes access to the heap from multiple threads. */
@@ -228,6 +346,7 @@ static void block_init(void *addr, size_t size, bool free, heap_area_t *area)
 
 	head->size = size;
 	head->free = free;
+	head->cached = false;
 	head->area = area;
 	head->magic = HEAP_BLOCK_HEAD_MAGIC;
 
@@ -237,17 +356,41 @@ static void block_init(void *addr, size_t size, bool free, heap_area_t *area)
 	foot->magic = HEAP_BLOCK_FOOT_MAGIC;
 }
 
+/** Resize a heap block
+ *
+ * Unlike block_init(), only the size of the block is updated.
+ * The block may be a used one, possibly parked in a block cache,
+ * whose other header fields are owned by somebody else.
+ * Should be called only inside the critical section.
+ *
+ * @param head Header of the block.
+ * @param size New size of the block including the header and the footer.
+ *
+ */
+static void block_resize(heap_block_head_t *head, size_t size)
+{
+	head->size = size;
+
+	heap_block_foot_t *foot = BLOCK_FOOT(head);
+
+	foot->size = size;
+	foot->magic = HEAP_BLOCK_FOOT_MAGIC;
+}
+
 /** Check a heap block
  *
  * Verifies that the structures related to a heap block still contain
  * the magic constants. This helps detect heap corruption early on.
+ * The check is only done with CONFIG_DEBUG_MALLOC, heap_check() can
+ * be used to check the whole heap at any time.
  * Should be called only inside the critical section.
  *
  * @param addr Address of the block.
  *
  */
-static void block_check(void *addr)
+static inline void block_check(void *addr)
 {
+#ifdef CONFIG_DEBUG_MALLOC
 	heap_block_head_t *head = (heap_block_head_t *) addr;
 
 	malloc_assert(head->magic == HEAP_BLOCK_HEAD_MAGIC);
@@ -256,17 +399,40 @@ static void block_check(void *addr)
 
 	malloc_assert(foot->magic == HEAP_BLOCK_FOOT_MAGIC);
 	malloc_assert(head->size == foot->size);
+#else
+	(void) addr;
+#endif
+}
+
+/** Check the header of a used heap block
+ *
+ * Unlike block_check(), this can be called outside the critical
+ * section by the owner of the block. The heap may enlarge a used
+ * block at any time, so its footer cannot be relied upon.
+ *
+ * @param head Header of the block.
+ *
+ */
+static inline void block_check_head(heap_block_head_t *head)
+{
+#ifdef CONFIG_DEBUG_MALLOC
+	malloc_assert(head->magic == HEAP_BLOCK_HEAD_MAGIC);
+#else
+	(void) head;
+#endif
 }
 
 /** Check a heap area structure
  *
+ * The check is only done with CONFIG_DEBUG_MALLOC.
  * Should be called only inside the critical section.
  *
  * @param addr Address of the heap area.
  *
  */
-static void area_check(void *addr)
+static inline void area_check(void *addr)
 {
+#ifdef CONFIG_DEBUG_MALLOC
 	heap_area_t *area = (heap_area_t *) addr;
 
 	malloc_assert(area->magic == HEAP_AREA_MAGIC);
@@ -274,6 +440,148 @@ static void area_check(void *addr)
 	malloc_assert(area->start < area->end);
 	malloc_assert(((uintptr_t) area->start % PAGE_SIZE) == 0);
 	malloc_assert(((uintptr_t) area->end % PAGE_SIZE) == 0);
+#else
+	(void) addr;
+#endif
+}
+
+/** Get the key of a large free block
+ *
+ * Large free blocks are ordered by their size.
+ *
+ */
+static void *large_tree_getkey(odlink_t *odlink)
+{
+	return &FREE_LINK_BLOCK(odlink)->size;
+}
+
+/** Compare the keys of two large free blocks. */
+static int large_tree_cmp(void *a, void *b)
+{
+	size_t size_a = *(size_t *) a;
+	size_t size_b = *(size_t *) b;
+
+	if (size_a < size_b)
+		return -1;
+
+	if (size_a > size_b)
+		return 1;
+
+	return 0;
+}
+
+/** Get the small bin of a free block
+ *
+ * @param size Net size of the block.
+ *
+ */
+static inline size_t small_bin(size_t size)
+{
+	malloc_assert(size >= BASE_ALIGN);
+	malloc_assert(size <= SMALL_BIN_MAX);
+
+	return size / BASE_ALIGN - 1;
+}
+
+/** Make a free heap block available for allocation
+ *
+ * Should be called only inside the critical section.
+ *
+ * @param head Header of the free block.
+ *
+ */
+static void free_insert(heap_block_head_t *head)
+{
+	malloc_assert(head->free);
+
+	size_t size = NET_SIZE(head->size);
+
+	/* Too small to be linked anywhere. */
+	if (size < BASE_ALIGN)
+		return;
+
+	heap_free_link_t *link = BLOCK_FREE_LINK(head);
+
+	if (size <= SMALL_BIN_MAX) {
+		size_t bin = small_bin(size);
+
+		list_prepend(&link->link, &small_bins[bin]);
+		small_bin_map |= UINT64_C(1) << bin;
+	} else {
+		odlink_initialize(&link->odlink);
+		odict_insert(&link->odlink, &large_tree, NULL);
+	}
+}
+
+/** Withdraw a free heap block from allocation
+ *
+ * Should be called only inside the critical section
+ * before the block is either used or resized.
+ *
+ * @param head Header of the free block.
+ *
+ */
+static void free_remove(heap_block_head_t *head)
+{
+	malloc_assert(head->free);
+
+	size_t size = NET_SIZE(head->size);
+
+	if (size < BASE_ALIGN)
+		return;
+
+	heap_free_link_t *link = BLOCK_FREE_LINK(head);
+
+	if (size <= SMALL_BIN_MAX) {
+		size_t bin = small_bin(size);
+
+		list_remove(&link->link);
+		if (list_empty(&small_bins[bin]))
+			small_bin_map &= ~(UINT64_C(1) << bin);
+	} else {
+		odict_remove(&link->odlink);
+	}
+}
+
+/** Find the smallest free heap block of at least the given size
+ *
+ * Should be called only inside the critical section.
+ *
+ * @param size Gross size of the block.
+ *
+ * @return Header of the free block or NULL if there is none.
+ *
+ */
+static heap_block_head_t *free_find(size_t size)
+{
+	size_t net_size = NET_SIZE(size);
+
+	if (net_size <= SMALL_BIN_MAX) {
+		/* Every block in the first bin considered is large enough. */
+		size_t bin = (net_size > BASE_ALIGN) ?
+		    small_bin(ALIGN_UP(net_size, BASE_ALIGN)) : 0;
+		uint64_t map = small_bin_map & ~((UINT64_C(1) << bin) - 1);
+
+		if (map != 0) {
+			bin = fnzb64(map & -map);
+
+			heap_block_head_t *head =
+			    FREE_LINK_BLOCK(list_first(&small_bins[bin]));
+			block_check(head);
+			malloc_assert(head->free);
+			malloc_assert(head->size >= size);
+			return head;
+		}
+	}
+
+	odlink_t *odlink = odict_find_geq(&large_tree, &size, NULL);
+	if (odlink == NULL)
+		return NULL;
+
+	heap_block_head_t *head = FREE_LINK_BLOCK(odlink);
+	block_check(head);
+	malloc_assert(head->free);
+	return head;
 }
 
 /** Create new heap area
@@ -304,6 +612,7 @@ static bool area_create(size_t size)
 	size_t bsize = (size_t) (area->end - block);
 
 	block_init(block, bsize, true, area);
+	free_insert(block);
 
 	if (last_heap_area == NULL) {
 		first_heap_area = area;
@@ -355,12 +664,16 @@ static bool area_grow(heap_area_t *area, size_t size)
 		/* Add the new space to the last block. */
 		size_t net_size = (size_t) (end - area->end) + last_head->size;
 		malloc_assert(net_size > 0);
+		free_remove(last_head);
 		block_init(last_head, net_size, true, area);
+		free_insert(last_head);
 	} else {
 		/* Add new free block */
 		size_t net_size = (size_t) (end - area->end);
-		if (net_size > 0)
+		if (net_size > 0) {
 			block_init(area->end, net_size, true, area);
+			free_insert(area->end);
+		}
 	}
 
 	/* Update heap area parameters */
@@ -372,7 +685,6 @@ static bool area_grow(heap_area_t *area, size_t size)
 /** Try to shrink heap
  *
  * Should be called only inside the critical section.
- * In all cases the next pointer is reset.
  *
  * @param area Last modified heap area.
  *
@@ -425,6 +737,7 @@ static void heap_shrink(heap_area_t *area)
 			} else
 				last_heap_area = prev;
 
+			free_remove(last_head);
 			as_area_destroy(area->start);
 		} else if (shrink_size >= SHRINK_GRANULARITY) {
 			/*
@@ -436,6 +749,12 @@ static void heap_shrink(heap_area_t *area)
 			size_t asize = (size_t) (area->end - area->start) - shrink_size;
 			void *end = (void *) ((uintptr_t) area->start + asize);
 
+			/*
+			 * The block header and its free list links may be
+			 * in the part that is about to be unmapped.
+			 */
+			free_remove(last_head);
+
 			/* Resize the address space area */
 			errno_t ret = as_area_resize(area->start, asize, 0);
 			if (ret != EOK)
@@ -453,6 +772,7 @@ static void heap_shrink(heap_area_t *area)
 					 * create a new free block.
 					 */
 					block_init((void *) last_head, excess, true, area);
+					free_insert(last_head);
 				} else {
 					/*
 					 * The excess is small. Therefore just enlarge
@@ -464,14 +784,11 @@ static void heap_shrink(heap_area_t *area)
 
 					block_check((void *) prev_head);
 
-					block_init(prev_head, prev_head->size + excess,
-					    prev_head->free, area);
+					block_resize(prev_head, prev_head->size + excess);
 				}
 			}
 		}
 	}
-
-	next_fit = NULL;
 }
 
 /** Initialize the heap allocator
@@ -486,12 +803,25 @@ void __malloc_init(void)
 	if (fibril_rmutex_initialize(&malloc_mutex) != EOK)
 		abort();
 
+	for (unsigned int i = 0; i < CACHE_COUNT; i++) {
+		if (fibril_rmutex_initialize(&malloc_caches[i].lock) != EOK)
+			abort();
+	}
+
+	for (unsigned int i = 0; i < SMALL_BIN_COUNT; i++)
+		list_initialize(&small_bins[i]);
+
+	odict_initialize(&large_tree, large_tree_getkey, large_tree_cmp);
+
 	if (!area_create(PAGE_SIZE))
 		abort();
 }
 
 void __malloc_fini(void)
 {
+	for (unsigned int i = 0; i < CACHE_COUNT; i++)
+		fibril_rmutex_destroy(&malloc_caches[i].lock);
+
 	fibril_rmutex_destroy(&malloc_mutex);
 }
 
@@ -499,7 +829,8 @@ void __malloc_fini(void)
  *
  * Should be called only inside the critical section.
  *
- * @param cur  Heap block to split.
+ * @param cur  Heap block to split, already withdrawn
+ *             from allocation.
  * @param size Number of bytes to split and mark from the beginning
  *             of the block.
  *
@@ -512,150 +843,136 @@ static void split_mark(heap_block_head_t *cur, const size_t size)
 	size_t split_limit = GROSS_SIZE(size);
 
 	if (cur->size > split_limit) {
-		/* Block big enough -> split. */
+		/*
+		 * Block big enough -> split. The next block
+		 * is used, otherwise the blocks would be merged.
+		 */
 		void *next = ((void *) cur) + size;
 		block_init(next, cur->size - size, true, cur->area);
 		block_init(cur, size, false, cur->area);
+		free_insert(next);
 	} else {
 		/* Block too small -> use as is. */
 		cur->free = false;
 	}
 }
 
-/** Allocate memory from heap area starting from given block
+/** Allocate memory from a free heap block
  *
  * Should be called only inside the critical section.
- * As a side effect this function also sets the current
- * pointer on successful allocation.
  *
- * @param area        Heap area where to allocate from.
- * @param first_block Starting heap block.
- * @param final_block Heap block where to finish the search
- *                    (may be NULL).
- * @param real_size   Gross number of bytes to allocate.
- * @param falign      Physical alignment of the block.
+ * @param cur       Free heap block, already withdrawn from allocation.
+ *                  It has to be large enough to fit the data at any
+ *                  alignment, i.e. real_size + falign + STRUCT_OVERHEAD
+ *                  unless falign is BASE_ALIGN.
+ * @param real_size Gross number of bytes to allocate.
+ * @param falign    Physical alignment of the block.
  *
- * @return Address of the allocated block or NULL on not enough memory.
+ * @return Address of the allocated block.
  *
  */
-static void *malloc_area(heap_area_t *area, heap_block_head_t *first_block,
-    heap_block_head_t *final_block, size_t real_size, size_t falign)
+static void *block_alloc(heap_block_head_t *cur, size_t real_size,
+    size_t falign)
 {
+	heap_area_t *area = cur->area;
+
 	area_check((void *) area);
-	malloc_assert((void *) first_block >= (void *) AREA_FIRST_BLOCK_HEAD(area));
-	malloc_assert((void *) first_block < area->end);
+	block_check(cur);
+	malloc_assert(cur->free);
+	malloc_assert(cur->size >= real_size);
+
+	void *addr = (void *)
+	    ((uintptr_t) cur + sizeof(heap_block_head_t));
+	void *aligned = (void *)
+	    ALIGN_UP((uintptr_t) addr, falign);
+
+	if (addr == aligned) {
+		/* Exact block start including alignment. */
+		split_mark(cur, real_size);
+		return addr;
+	}
 
-	for (heap_block_head_t *cur = first_block; (void *) cur < area->end;
-	    cur = (heap_block_head_t *) (((void *) cur) + cur->size)) {
-		block_check(cur);
+	/* Block start has to be aligned */
+	size_t excess = (size_t) (aligned - addr);
 
-		/* Finish searching on the final block */
-		if ((final_block != NULL) && (cur == final_block))
-			break;
+	if ((void *) cur > (void *) AREA_FIRST_BLOCK_HEAD(area)) {
+		malloc_assert(cur->size >= real_size + excess);
+
+		/*
+		 * There is a block before the current block.
+		 * This previous block can be enlarged to
+		 * compensate for the alignment excess.
+		 */
+		heap_block_foot_t *prev_foot = (heap_block_foot_t *)
+		    ((void *) cur - sizeof(heap_block_foot_t));
+
+		heap_block_head_t *prev_head = (heap_block_head_t *)
+		    ((void *) cur - prev_foot->size);
+
+		block_check(prev_head);
 
-		/* Try to find a block that is free and large enough. */
-		if ((cur->free) && (cur->size >= real_size)) {
+		size_t reduced_size = cur->size - excess;
+		heap_block_head_t *next_head = ((void *) cur) + excess;
+
+		if ((!prev_head->free) &&
+		    (excess >= STRUCT_OVERHEAD)) {
+			/*
+			 * The previous block is not free and there
+			 * is enough free space left to fill in
+			 * a new free block between the previous
+			 * and current block.
+			 */
+			block_init(cur, excess, true, area);
+			free_insert(cur);
+		} else if (prev_head->free) {
 			/*
-			 * We have found a suitable block.
-			 * Check for alignment properties.
+			 * The previous block is free, thus there
+			 * is no need to induce additional
+			 * fragmentation to the heap.
 			 */
-			void *addr = (void *)
-			    ((uintptr_t) cur + sizeof(heap_block_head_t));
-			void *aligned = (void *)
-			    ALIGN_UP((uintptr_t) addr, falign);
+			free_remove(prev_head);
+			block_init(prev_head, prev_head->size + excess, true,
+			    area);
+			free_insert(prev_head);
+		} else {
+			/*
+			 * The excess is small. Therefore just enlarge
+			 * the previous block.
+			 */
+			block_resize(prev_head, prev_head->size + excess);
+		}
 
-			if (addr == aligned) {
-				/* Exact block start including alignment. */
-				split_mark(cur, real_size);
+		block_init(next_head, reduced_size, true, area);
+		split_mark(next_head, real_size);
 
-				next_fit = cur;
-				return addr;
-			} else {
-				/* Block start has to be aligned */
-				size_t excess = (size_t) (aligned - addr);
+		return aligned;
+	}
 
-				if (cur->size >= real_size + excess) {
-					/*
-					 * The current block is large enough to fit
-					 * data in (including alignment).
-					 */
-					if ((void *) cur > (void *) AREA_FIRST_BLOCK_HEAD(area)) {
-						/*
-						 * There is a block before the current block.
-						 * This previous block can be enlarged to
-						 * compensate for the alignment excess.
-						 */
-						heap_block_foot_t *prev_foot = (heap_block_foot_t *)
-						    ((void *) cur - sizeof(heap_block_foot_t));
-
-						heap_block_head_t *prev_head = (heap_block_head_t *)
-						    ((void *) cur - prev_foot->size);
-
-						block_check(prev_head);
-
-						size_t reduced_size = cur->size - excess;
-						heap_block_head_t *next_head = ((void *) cur) + excess;
-
-						if ((!prev_head->free) &&
-						    (excess >= STRUCT_OVERHEAD)) {
-							/*
-							 * The previous block is not free and there
-							 * is enough free space left to fill in
-							 * a new free block between the previous
-							 * and current block.
-							 */
-							block_init(cur, excess, true, area);
-						} else {
-							/*
-							 * The previous block is free (thus there
-							 * is no need to induce additional
-							 * fragmentation to the heap) or the
-							 * excess is small. Therefore just enlarge
-							 * the previous block.
-							 */
-							block_init(prev_head, prev_head->size + excess,
-							    prev_head->free, area);
-						}
-
-						block_init(next_head, reduced_size, true, area);
-						split_mark(next_head, real_size);
-
-						next_fit = next_head;
-						return aligned;
-					} else {
-						/*
-						 * The current block is the first block
-						 * in the heap area. We have to make sure
-						 * that the alignment excess is large enough
-						 * to fit a new free block just before the
-						 * current block.
-						 */
-						while (excess < STRUCT_OVERHEAD) {
-							aligned += falign;
-							excess += falign;
-						}
-
-						/* Check for current block size again */
-						if (cur->size >= real_size + excess) {
-							size_t reduced_size = cur->size - excess;
-							cur = (heap_block_head_t *)
-							    (AREA_FIRST_BLOCK_HEAD(area) + excess);
-
-							block_init((void *) AREA_FIRST_BLOCK_HEAD(area),
-							    excess, true, area);
-							block_init(cur, reduced_size, true, area);
-							split_mark(cur, real_size);
-
-							next_fit = cur;
-							return aligned;
-						}
-					}
-				}
-			}
-		}
+	/*
+	 * The current block is the first block
+	 * in the heap area. We have to make sure
+	 * that the alignment excess is large enough
+	 * to fit a new free block just before the
+	 * current block.
+	 */
+	while (excess < STRUCT_OVERHEAD) {
+		aligned += falign;
+		excess += falign;
 	}
 
-	return NULL;
+	malloc_assert(cur->size >= real_size + excess);
+
+	size_t reduced_size = cur->size - excess;
+	cur = (heap_block_head_t *)
+	    (AREA_FIRST_BLOCK_HEAD(area) + excess);
+
+	block_init((void *) AREA_FIRST_BLOCK_HEAD(area),
+	    excess, true, area);
+	free_insert((void *) AREA_FIRST_BLOCK_HEAD(area));
+	block_init(cur, reduced_size, true, area);
+	split_mark(cur, real_size);
+
+	return aligned;
 }
 
 /** Try to enlarge any of the heap areas.
@@ -663,14 +980,15 @@ static void *malloc_area(heap_area_t *area, heap_block_head_t *first_block,
  * If successful, allocate block of the given size in the area.
  * Should be called only inside the critical section.
  *
- * @param size  Gross size of item to allocate (bytes).
- * @param align Memory address alignment.
+ * @param size      Gross size of the free block needed (bytes).
+ * @param real_size Gross size of item to allocate (bytes).
+ * @param align     Memory address alignment.
  *
  * @return Allocated block.
  * @return NULL on failure.
  *
  */
-static void *heap_grow_and_alloc(size_t size, size_t align)
+static void *heap_grow_and_alloc(size_t size, size_t real_size, size_t align)
 {
 	if (size == 0)
 		return NULL;
@@ -679,26 +997,22 @@ static void *heap_grow_and_alloc(size_t size, size_t align)
 	for (heap_area_t *area = first_heap_area; area != NULL;
 	    area = area->next) {
 
-		if (area_grow(area, size + align)) {
-			heap_block_head_t *first =
+		if (area_grow(area, size)) {
+			heap_block_head_t *last =
 			    (heap_block_head_t *) AREA_LAST_BLOCK_HEAD(area);
 
-			void *addr =
-			    malloc_area(area, first, NULL, size, align);
-			malloc_assert(addr != NULL);
-			return addr;
+			free_remove(last);
+			return block_alloc(last, real_size, align);
 		}
 	}
 
 	/* Eventually try to create a new area */
-	if (area_create(AREA_OVERHEAD(size + align))) {
+	if (area_create(AREA_OVERHEAD(size))) {
 		heap_block_head_t *first =
 		    (heap_block_head_t *) AREA_FIRST_BLOCK_HEAD(last_heap_area);
 
-		void *addr =
-		    malloc_area(last_heap_area, first, NULL, size, align);
-		malloc_assert(addr != NULL);
-		return addr;
+		free_remove(first);
+		return block_alloc(first, real_size, align);
 	}
 
 	return NULL;
@@ -716,8 +1030,6 @@ static void *heap_grow_and_alloc(size_t size, size_t align)
  */
 static void *malloc_internal(const size_t size, const size_t align)
 {
-	malloc_assert(first_heap_area != NULL);
-
 	if (align == 0)
 		return NULL;
 
@@ -727,6 +1039,9 @@ static void *malloc_internal(const size_t size, const size_t align)
 	if (falign < align)
 		return NULL;
 
+	if (size > SIZE_MAX - falign - 2 * STRUCT_OVERHEAD - BASE_ALIGN)
+		return NULL;
+
 	/*
 	 * The size of the allocated block needs to be naturally
 	 * aligned, because the footer structure also needs to reside
@@ -735,32 +1050,287 @@ static void *malloc_internal(const size_t size, const size_t align)
 	 */
 	size_t gross_size = GROSS_SIZE(ALIGN_UP(size, BASE_ALIGN));
 
-	/* Try the next fit approach */
-	heap_block_head_t *split = next_fit;
+	/*
+	 * Rather than looking for a block which fits the data at the
+	 * right address, look for one that fits it at any address.
+	 */
+	size_t search_size = gross_size;
+	if (falign > BASE_ALIGN)
+		search_size += falign + STRUCT_OVERHEAD;
+
+	heap_block_head_t *cur = free_find(search_size);
+	if (cur != NULL) {
+		free_remove(cur);
+		return block_alloc(cur, gross_size, falign);
+	}
+
+	/* Finally, try to grow heap space and allocate in the new area. */
+	return heap_grow_and_alloc(search_size, gross_size, falign);
+}
+
+/** Return a memory block to the heap
+ *
+ * Should be called only inside the critical section.
+ *
+ * @param head Header of the block.
+ *
+ */
+static void free_internal(heap_block_head_t *head)
+{
+	block_check(head);
+	malloc_assert(!head->free);
+
+	heap_area_t *area = head->area;
+
+	area_check(area);
+	malloc_assert((void *) head >= (void *) AREA_FIRST_BLOCK_HEAD(area));
+	malloc_assert((void *) head < area->end);
+
+	/* Mark the block itself as free. */
+	head->free = true;
+	head->cached = false;
 
-	if (split != NULL) {
-		void *addr = malloc_area(split->area, split, NULL, gross_size,
-		    falign);
+	/* Look at the next block. If it is free, merge the two. */
+	heap_block_head_t *next_head =
+	    (heap_block_head_t *) (((void *) head) + head->size);
 
-		if (addr != NULL)
-			return addr;
+	if ((void *) next_head < area->end) {
+		block_check(next_head);
+		if (next_head->free) {
+			free_remove(next_head);
+			block_init(head, head->size + next_head->size, true, area);
+		}
 	}
 
-	/* Search the entire heap */
-	for (heap_area_t *area = first_heap_area; area != NULL;
-	    area = area->next) {
-		heap_block_head_t *first = (heap_block_head_t *)
-		    AREA_FIRST_BLOCK_HEAD(area);
+	/* Look at the previous block. If it is free, merge the two. */
+	if ((void *) head > (void *) AREA_FIRST_BLOCK_HEAD(area)) {
+		heap_block_foot_t *prev_foot =
+		    (heap_block_foot_t *) (((void *) head) - sizeof(heap_block_foot_t));
+
+		heap_block_head_t *prev_head =
+		    (heap_block_head_t *) (((void *) head) - prev_foot->size);
 
-		void *addr = malloc_area(area, first, split, gross_size,
-		    falign);
+		block_check(prev_head);
 
-		if (addr != NULL)
-			return addr;
+		if (prev_head->free) {
+			free_remove(prev_head);
+			block_init(prev_head, prev_head->size + head->size, true,
+			    area);
+			head = prev_head;
+		}
 	}
 
-	/* Finally, try to grow heap space and allocate in the new area. */
-	return heap_grow_and_alloc(gross_size, falign);
+	free_insert(head);
+	heap_shrink(area);
+}
+
+/** Get the size class of a cached allocation
+ *
+ * @param size Number of bytes requested.
+ *
+ * @return Size class or CACHE_CLASSES if the allocation
+ *         should bypass the block caches.
+ *
+ */
+static inline size_t cache_bin(size_t size)
+{
+	if (size > CACHE_CLASSES * BASE_ALIGN)
+		return CACHE_CLASSES;
+
+	/* Make room for the cache link even for empty allocations. */
+	size_t net_size = max(ALIGN_UP(size, BASE_ALIGN), BASE_ALIGN);
+	return net_size / BASE_ALIGN - 1;
+}
+
+/** Get the size class a used heap block can be cached in
+ *
+ * The heap may hand out blocks which are a bit larger than
+ * requested, therefore the size class is rounded down.
+ *
+ * @param head Header of the block.
+ *
+ * @return Size class or CACHE_CLASSES if the block
+ *         should bypass the block caches.
+ *
+ */
+static inline size_t cache_block_bin(heap_block_head_t *head)
+{
+	size_t net_size = NET_SIZE(head->size);
+
+	if ((net_size < BASE_ALIGN) || (net_size > CACHE_CLASSES * BASE_ALIGN))
+		return CACHE_CLASSES;
+
+	return net_size / BASE_ALIGN - 1;
+}
+
+/** Get the number of blocks moved to or from the heap at once
+ *
+ * @param bin Size class.
+ *
+ */
+static inline size_t cache_batch(size_t bin)
+{
+	size_t batch = CACHE_BATCH_BYTES / ((bin + 1) * BASE_ALIGN);
+	return max(min(batch, (size_t) CACHE_BATCH_MAX), (size_t) 1);
+}
+
+/** Lock a block cache for the current fibril
+ *
+ * Prefer the cache used last, but rather than waiting
+ * for it, take any other cache which is unlocked.
+ *
+ * @return Locked block cache.
+ *
+ */
+static malloc_cache_t *cache_lock(void)
+{
+	unsigned int hint = malloc_cache_hint;
+
+	for (unsigned int i = 0; i < CACHE_COUNT; i++) {
+		unsigned int idx = (hint + i) & (CACHE_COUNT - 1);
+
+		if (fibril_rmutex_trylock(&malloc_caches[idx].lock)) {
+			malloc_cache_hint = idx;
+			return &malloc_caches[idx];
+		}
+	}
+
+	/* All caches are busy, wait for ours. */
+	fibril_rmutex_lock(&malloc_caches[hint].lock);
+	return &malloc_caches[hint];
+}
+
+/** Unlock a block cache
+ *
+ * @param cache Block cache locked by cache_lock().
+ *
+ */
+static inline void cache_unlock(malloc_cache_t *cache)
+{
+	fibril_rmutex_unlock(&cache->lock);
+}
+
+/** Park a used block in a block cache
+ *
+ * Should be called only with the cache locked.
+ *
+ * @param cache Block cache.
+ * @param bin   Size class of the block.
+ * @param head  Header of the block.
+ *
+ */
+static inline void cache_push(malloc_cache_t *cache, size_t bin,
+    heap_block_head_t *head)
+{
+	cache_block_t *block =
+	    (cache_block_t *) (((void *) head) + sizeof(heap_block_head_t));
+
+	head->cached = true;
+	block->next = cache->bins[bin];
+	cache->bins[bin] = block;
+	cache->counts[bin]++;
+}
+
+/** Take a block out of a block cache
+ *
+ * Should be called only with the cache locked.
+ *
+ * @param cache Block cache.
+ * @param bin   Size class.
+ *
+ * @return Address of the block or NULL if the size class is empty.
+ *
+ */
+static inline void *cache_pop(malloc_cache_t *cache, size_t bin)
+{
+	cache_block_t *block = cache->bins[bin];
+	if (block == NULL)
+		return NULL;
+
+	heap_block_head_t *head =
+	    (heap_block_head_t *) (((void *) block) - sizeof(heap_block_head_t));
+
+	block_check_head(head);
+	malloc_assert(head->cached);
+
+	head->cached = false;
+	cache->bins[bin] = block->next;
+	cache->counts[bin]--;
+
+	return block;
+}
+
+/** Refill a size class of a block cache from the heap
+ *
+ * Allocate a whole batch of blocks under a single heap lock,
+ * park all but one of them in the cache.
+ *
+ * Should be called only with the cache locked.
+ *
+ * @param cache Block cache.
+ * @param bin   Size class.
+ *
+ * @return Address of the remaining block or NULL on not enough memory.
+ *
+ */
+static void *cache_refill(malloc_cache_t *cache, size_t bin)
+{
+	size_t size = (bin + 1) * BASE_ALIGN;
+	size_t batch = cache_batch(bin);
+
+	heap_lock();
+
+	void *addr = malloc_internal(size, BASE_ALIGN);
+
+	for (size_t i = 1; (addr != NULL) && (i < batch); i++) {
+		void *extra = malloc_internal(size, BASE_ALIGN);
+		if (extra == NULL)
+			break;
+
+		cache_push(cache, bin,
+		    (heap_block_head_t *) (extra - sizeof(heap_block_head_t)));
+	}
+
+	heap_unlock();
+
+	return addr;
+}
+
+/** Return the excess blocks of a size class of a block cache to the heap
+ *
+ * Keep the most recently released blocks, return the
+ * rest under a single heap lock.
+ *
+ * Should be called only with the cache locked.
+ *
+ * @param cache Block cache.
+ * @param bin   Size class.
+ *
+ */
+static void cache_flush(malloc_cache_t *cache, size_t bin)
+{
+	size_t batch = cache_batch(bin);
+	if (cache->counts[bin] <= batch)
+		return;
+
+	cache_block_t *last = cache->bins[bin];
+	for (size_t i = 1; i < batch; i++)
+		last = last->next;
+
+	cache_block_t *block = last->next;
+	last->next = NULL;
+	cache->counts[bin] = batch;
+
+	heap_lock();
+
+	while (block != NULL) {
+		cache_block_t *next = block->next;
+		free_internal((heap_block_head_t *)
+		    (((void *) block) - sizeof(heap_block_head_t)));
+		block = next;
+	}
+
+	heap_unlock();
 }
 
 /** Allocate memory by number of elements
@@ -792,6 +1362,18 @@ void *calloc(const size_t nmemb, const size_t size)
  */
 void *malloc(const size_t size)
 {
+	size_t bin = cache_bin(size);
+	if (bin < CACHE_CLASSES) {
+		malloc_cache_t *cache = cache_lock();
+
+		void *block = cache_pop(cache, bin);
+		if (block == NULL)
+			block = cache_refill(cache, bin);
+
+		cache_unlock(cache);
+		return block;
+	}
+
 	heap_lock();
 	void *block = malloc_internal(size, BASE_ALIGN);
 	heap_unlock();
@@ -815,6 +1397,10 @@ void *memalign(const size_t align, const size_t size)
 	size_t palign =
 	    1 << (fnzb(max(sizeof(void *), align) - 1) + 1);
 
+	/* Every block is aligned at least this way. */
+	if (palign <= BASE_ALIGN)
+		return malloc(size);
+
 	heap_lock();
 	void *block = malloc_internal(size, palign);
 	heap_unlock();
@@ -848,6 +1434,7 @@ void *realloc(void *const addr, const size_t size)
 
 	block_check(head);
 	malloc_assert(!head->free);
+	malloc_assert(!head->cached);
 
 	heap_area_t *area = head->area;
 
@@ -865,11 +1452,25 @@ void *realloc(void *const addr, const size_t size)
 		if (orig_size - real_size >= STRUCT_OVERHEAD) {
 			/*
 			 * Split the original block to a full block
-			 * and a trailing free block.
+			 * and a trailing free block. Merge the trailing
+			 * block with the next block if that is free.
 			 */
+			heap_block_head_t *next_head =
+			    (heap_block_head_t *) (((void *) head) + orig_size);
+			size_t free_size = orig_size - real_size;
+
+			if ((void *) next_head < area->end) {
+				block_check(next_head);
+				if (next_head->free) {
+					free_remove(next_head);
+					free_size += next_head->size;
+				}
+			}
+
 			block_init((void *) head, real_size, false, area);
-			block_init((void *) head + real_size,
-			    orig_size - real_size, true, area);
+			block_init((void *) head + real_size, free_size, true,
+			    area);
+			free_insert((void *) head + real_size);
 			heap_shrink(area);
 		}
 
@@ -887,7 +1488,7 @@ void *realloc(void *const addr, const size_t size)
 			 * as a safe upper bound.
 			 */
 
-			bool have_next_next;
+			bool have_next_next = false;
 
 			if (have_next) {
 				have_next_next = (((void *) next_head) +
@@ -902,6 +1503,7 @@ void *realloc(void *const addr, const size_t size)
 				 * two free blocks would be merged.
 				 */
 				(void) area_grow(area, real_size);
+				have_next = ((void *) next_head < area->end);
 			}
 		}
 
@@ -915,12 +1517,12 @@ void *realloc(void *const addr, const size_t size)
 		if (have_next && (head->size + next_head->size >= real_size) &&
 		    next_head->free) {
 			block_check(next_head);
+			free_remove(next_head);
 			block_init(head, head->size + next_head->size, false,
 			    area);
 			split_mark(head, real_size);
 
 			ptr = ((void *) head) + sizeof(heap_block_head_t);
-			next_fit = NULL;
 		} else {
 			reloc = true;
 		}
@@ -949,56 +1551,134 @@ void free(void *const addr)
 	if (addr == NULL)
 		return;
 
-	heap_lock();
-
 	/* Calculate the position of the header. */
 	heap_block_head_t *head =
 	    (heap_block_head_t *) (addr - sizeof(heap_block_head_t));
 
-	block_check(head);
+	/*
+	 * Without the heap lock, only the header can be checked. The heap
+	 * may enlarge a used block at any time, but the size read here
+	 * is valid either way.
+	 */
+	block_check_head(head);
 	malloc_assert(!head->free);
+	malloc_assert(!head->cached);
 
-	heap_area_t *area = head->area;
+	size_t bin = cache_block_bin(head);
+	if (bin < CACHE_CLASSES) {
+		malloc_cache_t *cache = cache_lock();
+		cache_push(cache, bin, head);
 
-	area_check(area);
-	malloc_assert((void *) head >= (void *) AREA_FIRST_BLOCK_HEAD(area));
-	malloc_assert((void *) head < area->end);
+		if (cache->counts[bin] > 2 * cache_batch(bin))
+			cache_flush(cache, bin);
 
-	/* Mark the block itself as free. */
-	head->free = true;
+		cache_unlock(cache);
+		return;
+	}
 
-	/* Look at the next block. If it is free, merge the two. */
-	heap_block_head_t *next_head =
-	    (heap_block_head_t *) (((void *) head) + head->size);
+	heap_lock();
+	free_internal(head);
+	heap_unlock();
+}
 
-	if ((void *) next_head < area->end) {
-		block_check(next_head);
-		if (next_head->free)
-			block_init(head, head->size + next_head->size, true, area);
+/** Check the blocks parked in a block cache
+ *
+ * @param cache Block cache.
+ * @param stats Statistics to update or NULL.
+ *
+ * @return NULL if the cache is consistent.
+ * @return Address of a corrupted structure otherwise.
+ *
+ */
+static void *cache_check(malloc_cache_t *cache, heap_stats_t *stats)
+{
+	fibril_rmutex_lock(&cache->lock);
+
+	for (size_t bin = 0; bin < CACHE_CLASSES; bin++) {
+		for (cache_block_t *block = cache->bins[bin]; block != NULL;
+		    block = block->next) {
+			heap_block_head_t *head = (heap_block_head_t *)
+			    (((void *) block) - sizeof(heap_block_head_t));
+
+			if ((head->magic != HEAP_BLOCK_HEAD_MAGIC) ||
+			    (head->free) || (!head->cached)) {
+				fibril_rmutex_unlock(&cache->lock);
+				return (void *) head;
+			}
+
+			if (stats != NULL) {
+				stats->cached_blocks++;
+				stats->cached_bytes += NET_SIZE(head->size);
+			}
+		}
 	}
 
-	/* Look at the previous block. If it is free, merge the two. */
-	if ((void *) head > (void *) AREA_FIRST_BLOCK_HEAD(area)) {
-		heap_block_foot_t *prev_foot =
-		    (heap_block_foot_t *) (((void *) head) - sizeof(heap_block_foot_t));
+	fibril_rmutex_unlock(&cache->lock);
+	return NULL;
+}
 
-		heap_block_head_t *prev_head =
-		    (heap_block_head_t *) (((void *) head) - prev_foot->size);
+/** Count the free blocks available for allocation
+ *
+ * Should be called only inside the critical section.
+ *
+ * @return Number of blocks in the small bins and the tree
+ *         of large free blocks.
+ *
+ */
+static size_t free_count(void)
+{
+	size_t count = odict_count(&large_tree);
 
-		block_check(prev_head);
+	for (unsigned int i = 0; i < SMALL_BIN_COUNT; i++) {
+		size_t bin_count = list_count(&small_bins[i]);
+		count += bin_count;
 
-		if (prev_head->free)
-			block_init(prev_head, prev_head->size + head->size, true,
-			    area);
+		/* Make the mismatch visible in the total count. */
+		if ((bin_count > 0) !=
+		    ((small_bin_map & (UINT64_C(1) << i)) != 0))
+			count++;
 	}
 
-	heap_shrink(area);
-
-	heap_unlock();
+	return count;
 }
 
+/** Check the heap consistency
+ *
+ * @return NULL if the heap is consistent.
+ * @return Address of a corrupted structure otherwise,
+ *         (void *) -1 if there is no heap at all.
+ *
+ */
 void *heap_check(void)
 {
+	return heap_check_stats(NULL);
+}
+
+/** Check the heap consistency and gather heap statistics
+ *
+ * Fragmentation of the heap can be judged by comparing
+ * the total size of the free blocks and the size of the
+ * largest one.
+ *
+ * @param stats Statistics to fill in or NULL.
+ *
+ * @return NULL if the heap is consistent.
+ * @return Address of a corrupted structure otherwise,
+ *         (void *) -1 if there is no heap at all.
+ *
+ */
+void *heap_check_stats(heap_stats_t *stats)
+{
+	if (stats != NULL)
+		memset(stats, 0, sizeof(heap_stats_t));
+
+	/* The caches have to be locked before the heap. */
+	for (unsigned int i = 0; i < CACHE_COUNT; i++) {
+		void *bad = cache_check(&malloc_caches[i], stats);
+		if (bad != NULL)
+			return bad;
+	}
+
 	heap_lock();
 
 	if (first_heap_area == NULL) {
@@ -1006,6 +1686,9 @@ void *heap_check(void)
 		return (void *) -1;
 	}
 
+	/* Number of free blocks that should be available for allocation */
+	size_t linked = 0;
+
 	/* Walk all heap areas */
 	for (heap_area_t *area = first_heap_area; area != NULL;
 	    area = area->next) {
@@ -1020,6 +1703,13 @@ void *heap_check(void)
 			return (void *) area;
 		}
 
+		if (stats != NULL) {
+			stats->areas++;
+			stats->area_bytes += (size_t) (area->end - area->start);
+		}
+
+		bool prev_free = false;
+
 		/* Walk all heap blocks */
 		for (heap_block_head_t *head = (heap_block_head_t *)
 		    AREA_FIRST_BLOCK_HEAD(area); (void *) head < area->end;
@@ -1038,9 +1728,39 @@ void *heap_check(void)
 				heap_unlock();
 				return (void *) foot;
 			}
+
+			/* Neighbouring free blocks should have been merged */
+			if (head->free && prev_free) {
+				heap_unlock();
+				return (void *) head;
+			}
+
+			prev_free = head->free;
+
+			if ((head->free) && (NET_SIZE(head->size) >= BASE_ALIGN))
+				linked++;
+
+			if (stats == NULL)
+				continue;
+
+			if (head->free) {
+				stats->free_blocks++;
+				stats->free_bytes += NET_SIZE(head->size);
+				stats->largest_free = max(stats->largest_free,
+				    NET_SIZE(head->size));
+			} else {
+				stats->used_blocks++;
+				stats->used_bytes += NET_SIZE(head->size);
+			}
 		}
 	}
 
+	/* Check that the bins hold exactly the free blocks */
+	if (free_count() != linked) {
+		heap_unlock();
+		return (void *) small_bins;
+	}
+
 	heap_unlock();
 
 	return NULL;
@@ -44,6 +44,8 @@ typedef struct {
 
 #define FIBRIL_EVENT_INIT ((fibril_event_t) {0})
 
+struct fibril_runner;
+
 struct fibril {
 	// XXX: The first two fields must not move (for taskdump).
 	link_t all_link;
@@ -58,14 +60,20 @@ struct fibril {
 	tcb_t *tcb;
 
 	fibril_t *clean_after_me;
+	/* Yielded fibril to be made ready again once we switched from it. */
+	fibril_t *ready_after_me;
 	errno_t retval;
 
 	fibril_t *thread_ctx;
+	/* Ready queue of the thread running the fibril. */
+	struct fibril_runner *runner;
 
 	bool is_running : 1;
 	bool is_writer : 1;
 	/* In some places, we use fibril structs that can't be freed. */
 	bool is_freeable : 1;
+	/* fibril_futex was handed over by a fibril going to sleep. */
+	bool has_fibril_futex : 1;
 
 	/* Debugging stuff. */
 	int rmutex_locks;
@@ -80,12 +88,16 @@ extern fibril_t *fibril_self(void);
 
 extern void __fibrils_init(void);
 extern void __fibrils_fini(void);
+extern void fibril_set_multithreaded(void);
+extern void fibril_runner_release(void);
 
 extern void fibril_wait_for(fibril_event_t *);
 extern errno_t fibril_wait_timeout(fibril_event_t *, const struct timespec *);
 extern void fibril_notify(fibril_event_t *);
 
 extern errno_t fibril_ipc_wait(ipc_call_t *, const struct timespec *);
+extern errno_t fibril_ipc_wait_batch(ipc_call_t *, size_t, size_t *,
+    const struct timespec *);
 extern void fibril_ipc_poke(void);
 
 /**
@@ -42,10 +42,12 @@
 #include <as.h>
 #include <context.h>
 #include <assert.h>
+#include <bitops.h>
 
 #include <mem.h>
 #include <str.h>
 #include <ipc/ipc.h>
+#include <sysinfo.h>
 #include <libarch/faddr.h>
 
 #include "../private/thread.h"
@@ -56,10 +58,11 @@
 #define DPRINTF(...) ((void)0)
 #undef READY_DEBUG
 
-/** Member of timeout_list. */
+/** Member of a timeout_wheel slot. */
 typedef struct {
 	link_t link;
-	struct timespec expires;
+	/* Uptime in microseconds. */
+	usec_t expires;
 	fibril_event_t *event;
 } _timeout_t;
 
@@ -87,12 +90,10 @@ static bool multithreaded = false;
 
 /* This futex serializes access to global data. */
 static futex_t fibril_futex;
-static futex_t ready_semaphore;
-static long ready_st_count;
+static futex_t ipc_buffer_semaphore;
+static long ipc_buffer_st_count;
 
-static LIST_INITIALIZE(ready_list);
 static LIST_INITIALIZE(fibril_list);
-static LIST_INITIALIZE(timeout_list);
 
 static futex_t ipc_lists_futex;
 static LIST_INITIALIZE(ipc_waiter_list);
@@ -106,37 +107,105 @@ static fibril_t _fibril_event_timed_out;
 #define _EVENT_TRIGGERED (&_fibril_event_triggered)
 #define _EVENT_TIMED_OUT (&_fibril_event_timed_out)
 
-static inline void _ready_debug_check(void)
+/*
+ * Pending timeouts are kept in a hierarchical timing wheel, so that
+ * arming and cancelling a timeout takes constant time no matter how many
+ * of them are pending.
+ *
+ * The wheel turns in ticks of 2^TIMEOUT_TICK_SHIFT microseconds. Each slot
+ * on level l covers TIMEOUT_WHEEL_SLOTS^l ticks. A timeout is kept on the
+ * lowest level that reaches its expiration and moves down as the wheel
+ * turns. The exact expiration time is kept too, so no timeout fires early.
+ */
+#define TIMEOUT_TICK_SHIFT    10
+#define TIMEOUT_WHEEL_BITS    6
+#define TIMEOUT_WHEEL_SLOTS   (1 << TIMEOUT_WHEEL_BITS)
+#define TIMEOUT_WHEEL_MASK    (TIMEOUT_WHEEL_SLOTS - 1)
+#define TIMEOUT_WHEEL_LEVELS  4
+
+/* Protected by fibril_futex. */
+static struct {
+	/* Current tick. Level 0 slots of earlier ticks are empty. */
+	uint64_t tick;
+	/* Bit for every slot that may be nonempty, cleared lazily. */
+	uint64_t map[TIMEOUT_WHEEL_LEVELS];
+	list_t slot[TIMEOUT_WHEEL_LEVELS][TIMEOUT_WHEEL_SLOTS];
+} timeout_wheel;
+
+/** Maximal number of ready queues. More runners have to share them. */
+#define RUNNER_MAX  64
+
+/** How long to wait for a free IPC buffer before looking for fibrils again. */
+#define IPC_BUFFER_RETRY_MSEC  10
+
+/** Maximal number of IPC calls received in one syscall. */
+#define IPC_BATCH_MAX  8
+
+/**
+ * Ready queue of a runner thread.
+ *
+ * Fibrils made ready by a thread are put to the queue of that thread and
+ * run from there. A runner that finds its own queue empty steals from
+ * the queues of others before going idle.
+ */
+typedef struct fibril_runner {
+	futex_t futex;
+	list_t ready;
+	/* Length of the ready list, also read without the futex as a hint. */
+	atomic_int ready_count;
+	/* Number of threads using the queue, protected by runner_futex. */
+	int users;
+} _runner_t;
+
+/* This futex serializes assignment of ready queues to threads. */
+static futex_t runner_futex;
+static _runner_t runners[RUNNER_MAX];
+static atomic_int runner_slots;
+
+/* Runners looking for fibrils to steal, they don't need to be woken up. */
+static atomic_int runners_searching;
+/* Runners going to sleep or sleeping in SYS_IPC_WAIT. */
+static atomic_int threads_in_ipc_wait;
+
+static inline void _ipc_buffer_debug_check(void)
 {
 #ifdef READY_DEBUG
 	assert(!multithreaded);
-	long count = (long) list_count(&ready_list) +
-	    (long) list_count(&ipc_buffer_free_list);
-	assert(ready_st_count == count);
+	long count = (long) list_count(&ipc_buffer_free_list);
+	assert(ipc_buffer_st_count == count);
 #endif
 }
 
-static inline void _ready_up(void)
+static inline void _ipc_buffer_up(void)
 {
 	if (multithreaded) {
-		futex_up(&ready_semaphore);
+		futex_up(&ipc_buffer_semaphore);
 	} else {
-		ready_st_count++;
-		_ready_debug_check();
+		ipc_buffer_st_count++;
+		_ipc_buffer_debug_check();
 	}
 }
 
-static inline errno_t _ready_down(const struct timespec *expires)
+static inline errno_t _ipc_buffer_down(const struct timespec *expires)
 {
 	if (multithreaded)
-		return futex_down_timeout(&ready_semaphore, expires);
+		return futex_down_timeout(&ipc_buffer_semaphore, expires);
+
+	_ipc_buffer_debug_check();
+	if (ipc_buffer_st_count == 0)
+		return ETIMEOUT;
 
-	_ready_debug_check();
-	ready_st_count--;
+	ipc_buffer_st_count--;
 	return EOK;
 }
 
-static atomic_int threads_in_ipc_wait;
+static inline bool _ipc_buffer_trydown(void)
+{
+	struct timespec tv = { .tv_sec = 0, .tv_nsec = 0 };
+	return _ipc_buffer_down(&tv) == EOK;
+}
+
+static void _fibril_switch_done(void);
 
 /** Function that spans the whole life-cycle of a fibril.
  *
@@ -147,8 +216,7 @@ static atomic_int threads_in_ipc_wait;
  */
 static void _fibril_main(void)
 {
-	/* fibril_futex is locked when a fibril is started. */
-	futex_unlock(&fibril_futex);
+	_fibril_switch_done();
 
 	fibril_t *fibril = fibril_self();
 
@@ -237,88 +305,233 @@ static fibril_t *_fibril_trigger_internal(fibril_event_t *event, fibril_t *reaso
 	return f;
 }
 
-static errno_t _ipc_wait(ipc_call_t *call, const struct timespec *expires)
+static errno_t _ipc_wait(ipc_call_t *calls, size_t count, size_t *received,
+    const struct timespec *expires)
 {
-	if (!expires)
-		return ipc_wait(call, SYNCH_NO_TIMEOUT, SYNCH_FLAGS_NONE);
+	if (!expires) {
+		return ipc_wait_batch(calls, count, received, SYNCH_NO_TIMEOUT,
+		    SYNCH_FLAGS_NONE);
+	}
 
-	if (expires->tv_sec == 0)
-		return ipc_wait(call, SYNCH_NO_TIMEOUT, SYNCH_FLAGS_NON_BLOCKING);
+	if (expires->tv_sec == 0) {
+		return ipc_wait_batch(calls, count, received, SYNCH_NO_TIMEOUT,
+		    SYNCH_FLAGS_NON_BLOCKING);
+	}
 
 	struct timespec now;
 	getuptime(&now);
 
-	if (ts_gteq(&now, expires))
-		return ipc_wait(call, SYNCH_NO_TIMEOUT, SYNCH_FLAGS_NON_BLOCKING);
+	if (ts_gteq(&now, expires)) {
+		return ipc_wait_batch(calls, count, received, SYNCH_NO_TIMEOUT,
+		    SYNCH_FLAGS_NON_BLOCKING);
+	}
 
-	return ipc_wait(call, NSEC2USEC(ts_sub_diff(expires, &now)),
-	    SYNCH_FLAGS_NONE);
+	return ipc_wait_batch(calls, count, received,
+	    NSEC2USEC(ts_sub_diff(expires, &now)), SYNCH_FLAGS_NONE);
 }
 
-/*
- * Waits until a ready fibril is added to the list, or an IPC message arrives.
- * Returns NULL on timeout and may also return NULL if returning from IPC
- * wait after new ready fibrils are added.
- */
-static fibril_t *_ready_list_pop(const struct timespec *expires, bool locked)
+/** Assign a ready queue to the current thread. */
+static _runner_t *_runner_register(void)
 {
-	if (locked) {
-		futex_assert_is_locked(&fibril_futex);
-		assert(expires);
-		/* Must be nonblocking. */
-		assert(expires->tv_sec == 0);
-	} else {
-		futex_assert_is_not_locked(&fibril_futex);
+	futex_lock(&runner_futex);
+
+	int slots = atomic_load_explicit(&runner_slots, memory_order_relaxed);
+	_runner_t *r = NULL;
+
+	/* Reuse a queue left by an exited thread, if any. */
+	for (int i = 0; i < slots; i++) {
+		if (runners[i].users == 0) {
+			r = &runners[i];
+			break;
+		}
 	}
 
-	errno_t rc = _ready_down(expires);
-	if (rc != EOK)
+	if (!r && slots < RUNNER_MAX) {
+		r = &runners[slots];
+		if (futex_initialize(&r->futex, 1) != EOK)
+			abort();
+		list_initialize(&r->ready);
+		atomic_store_explicit(&runner_slots, slots + 1,
+		    memory_order_release);
+	}
+
+	if (!r) {
+		/* Share the least used queue. */
+		r = &runners[0];
+		for (int i = 1; i < slots; i++) {
+			if (runners[i].users < r->users)
+				r = &runners[i];
+		}
+	}
+
+	r->users++;
+
+	futex_unlock(&runner_futex);
+	return r;
+}
+
+/** @return the ready queue of the current thread. */
+static _runner_t *_runner_self(void)
+{
+	fibril_t *f = fibril_self();
+	if (!f->runner)
+		f->runner = _runner_register();
+	return f->runner;
+}
+
+static void _runner_push(_runner_t *r, fibril_t *f)
+{
+	futex_lock(&r->futex);
+	list_append(&f->link, &r->ready);
+	atomic_fetch_add_explicit(&r->ready_count, 1, memory_order_relaxed);
+	futex_unlock(&r->futex);
+}
+
+static fibril_t *_runner_pop(_runner_t *r)
+{
+	if (atomic_load_explicit(&r->ready_count, memory_order_relaxed) == 0)
 		return NULL;
 
-	/*
-	 * Once we acquire a token from ready_semaphore, there are two options.
-	 * Either there is a ready fibril in the list, or it's our turn to
-	 * call `ipc_wait_cycle()`. There is one extra token on the semaphore
-	 * for each entry of the call buffer.
-	 */
+	futex_lock(&r->futex);
+	fibril_t *f = list_pop(&r->ready, fibril_t, link);
+	if (f)
+		atomic_fetch_sub_explicit(&r->ready_count, 1, memory_order_relaxed);
+	futex_unlock(&r->futex);
+	return f;
+}
 
-	if (!locked)
-		futex_lock(&fibril_futex);
-	fibril_t *f = list_pop(&ready_list, fibril_t, link);
-	if (!f)
-		atomic_fetch_add_explicit(&threads_in_ipc_wait, 1,
+/**
+ * Steal ready fibrils from another runner.
+ *
+ * Half of the first nonempty queue is taken, so that a runner which makes
+ * many fibrils ready at once is not robbed one fibril at a time. One of them
+ * is returned, the rest goes to the queue of the current thread.
+ */
+static fibril_t *_runner_steal(_runner_t *self)
+{
+	int slots = atomic_load_explicit(&runner_slots, memory_order_acquire);
+	int start = self - runners;
+
+	for (int i = 1; i < slots; i++) {
+		_runner_t *victim = &runners[(start + i) % slots];
+		if (atomic_load_explicit(&victim->ready_count,
+		    memory_order_relaxed) == 0)
+			continue;
+
+		list_t stolen;
+		list_initialize(&stolen);
+
+		futex_lock(&victim->futex);
+
+		int take = (atomic_load_explicit(&victim->ready_count,
+		    memory_order_relaxed) + 1) / 2;
+		fibril_t *f = list_pop(&victim->ready, fibril_t, link);
+		if (!f) {
+			futex_unlock(&victim->futex);
+			continue;
+		}
+
+		for (int j = 1; j < take; j++) {
+			link_t *link = list_first(&victim->ready);
+			list_remove(link);
+			list_append(link, &stolen);
+		}
+
+		atomic_fetch_sub_explicit(&victim->ready_count, take,
 		    memory_order_relaxed);
-	if (!locked)
-		futex_unlock(&fibril_futex);
+		futex_unlock(&victim->futex);
+
+		if (take > 1) {
+			futex_lock(&self->futex);
+			list_concat(&self->ready, &stolen);
+			atomic_fetch_add_explicit(&self->ready_count, take - 1,
+			    memory_order_relaxed);
+			futex_unlock(&self->futex);
+		}
 
-	if (f)
 		return f;
+	}
 
+	return NULL;
+}
+
+/**
+ * Wake up an idle runner to take over newly ready fibrils, unless there is
+ * one already looking for them.
+ */
+static void _ready_wakeup(void)
+{
+	/* Pairs with the fence in _ready_list_pop(). */
+	atomic_thread_fence(memory_order_seq_cst);
+
+	if (atomic_load_explicit(&threads_in_ipc_wait, memory_order_relaxed) &&
+	    !atomic_load_explicit(&runners_searching, memory_order_relaxed)) {
+		DPRINTF("Poking.\n");
+		/* Wakeup one thread sleeping in SYS_IPC_WAIT. */
+		ipc_poke();
+	}
+}
+
+static void _ready_list_push(fibril_t *f)
+{
+	if (!f)
+		return;
+
+	_runner_push(_runner_self(), f);
+	_ready_wakeup();
+}
+
+/*
+ * Waits for IPC calls and hands each over to a fibril waiting for it,
+ * if there is one. The caller must hold an IPC buffer token, which is
+ * used up if the call is stored in a buffer instead. Additional tokens
+ * are taken if available, so that more pending calls can be received
+ * in the same syscall.
+ * Returns the first woken up fibril, if any. The others are made ready.
+ */
+static fibril_t *_ready_ipc_wait(const struct timespec *expires, bool locked)
+{
 	if (!multithreaded)
 		assert(list_empty(&ipc_buffer_list));
 
-	/* No fibril is ready, IPC wait it is. */
-	ipc_call_t call = { 0 };
-	rc = _ipc_wait(&call, expires);
+	size_t tokens = 1;
+	while (tokens < IPC_BATCH_MAX && _ipc_buffer_trydown())
+		tokens++;
 
-	atomic_fetch_sub_explicit(&threads_in_ipc_wait, 1,
-	    memory_order_relaxed);
-
-	if (rc != EOK && rc != ENOENT) {
-		/* Return token. */
-		_ready_up();
-		return NULL;
-	}
+	ipc_call_t calls[IPC_BATCH_MAX];
+	size_t received = 0;
+	errno_t rc = _ipc_wait(calls, tokens, &received, expires);
 
 	/*
-	 * We might get ENOENT due to a poke.
-	 * In that case, we propagate the null call out of fibril_ipc_wait(),
-	 * because poke must result in that call returning.
+	 * Calls counted in received are ours even if the kernel failed
+	 * afterwards, so only give up if there are none. The failure does
+	 * not concern the calls themselves, which are passed on with EOK.
 	 */
+	if (received > 0) {
+		rc = EOK;
+	} else {
+		if (rc != ENOENT) {
+			/* Return tokens. */
+			for (; tokens > 0; tokens--)
+				_ipc_buffer_up();
+			return NULL;
+		}
+
+		/*
+		 * We might get ENOENT due to a poke.
+		 * In that case, we propagate the null call out of
+		 * fibril_ipc_wait(), because poke must result in that call
+		 * returning.
+		 */
+		calls[0] = (ipc_call_t) { 0 };
+		received = 1;
+	}
+
+	assert(received > 0 && received <= tokens);
 
 	/*
 	 * If a fibril is already waiting for IPC, we wake up the fibril,
-	 * and return the token to ready_semaphore.
+	 * and return the token to ipc_buffer_semaphore.
 	 * If there is no fibril waiting, we pop a buffer bucket and
 	 * put our call there. The token then returns when the bucket is
 	 * returned.
@@ -329,52 +542,136 @@ static fibril_t *_ready_list_pop(const struct timespec *expires, bool locked)
 
 	futex_lock(&ipc_lists_futex);
 
-	_ipc_waiter_t *w = list_pop(&ipc_waiter_list, _ipc_waiter_t, link);
-	if (w) {
-		*w->call = call;
-		w->rc = rc;
-		/* We switch to the woken up fibril immediately if possible. */
-		f = _fibril_trigger_internal(&w->event, _EVENT_TRIGGERED);
-
-		/* Return token. */
-		_ready_up();
-	} else {
-		_ipc_buffer_t *buf = list_pop(&ipc_buffer_free_list, _ipc_buffer_t, link);
-		assert(buf);
-		*buf = (_ipc_buffer_t) { .call = call, .rc = rc };
-		list_append(&buf->link, &ipc_buffer_list);
+	fibril_t *woken[IPC_BATCH_MAX];
+	size_t woken_count = 0;
+
+	for (size_t i = 0; i < received; i++) {
+		_ipc_waiter_t *w = list_pop(&ipc_waiter_list, _ipc_waiter_t,
+		    link);
+		if (w) {
+			*w->call = calls[i];
+			w->rc = rc;
+			woken[woken_count++] = _fibril_trigger_internal(&w->event,
+			    _EVENT_TRIGGERED);
+
+			/* Return token. */
+			_ipc_buffer_up();
+		} else {
+			_ipc_buffer_t *buf = list_pop(&ipc_buffer_free_list,
+			    _ipc_buffer_t, link);
+			assert(buf);
+			*buf = (_ipc_buffer_t) { .call = calls[i], .rc = rc };
+			list_append(&buf->link, &ipc_buffer_list);
+		}
 	}
 
 	futex_unlock(&ipc_lists_futex);
 
+	/* We switch to the first woken up fibril immediately if possible. */
+	fibril_t *f = NULL;
+	for (size_t i = 0; i < woken_count; i++) {
+		if (!f)
+			f = woken[i];
+		else
+			_ready_list_push(woken[i]);
+	}
+
 	if (!locked)
 		futex_unlock(&fibril_futex);
 
+	/* Return tokens of calls that did not come. */
+	for (; tokens > received; tokens--)
+		_ipc_buffer_up();
+
 	return f;
 }
 
-static fibril_t *_ready_list_pop_nonblocking(bool locked)
+/*
+ * Waits until a ready fibril is available, or an IPC message arrives.
+ * Returns NULL on timeout and may also return NULL if returning from IPC
+ * wait after new ready fibrils are added.
+ */
+static fibril_t *_ready_list_pop(const struct timespec *expires)
 {
-	struct timespec tv = { .tv_sec = 0, .tv_nsec = 0 };
-	return _ready_list_pop(&tv, locked);
+	futex_assert_is_not_locked(&fibril_futex);
+
+	_runner_t *r = _runner_self();
+	fibril_t *f = _runner_pop(r);
+	if (f)
+		return f;
+
+	atomic_fetch_add_explicit(&runners_searching, 1, memory_order_seq_cst);
+	f = _runner_steal(r);
+	if (atomic_fetch_sub_explicit(&runners_searching, 1,
+	    memory_order_seq_cst) == 1 && f) {
+		/*
+		 * Fibrils made ready while we were searching did not wake
+		 * anyone up, so someone else has to look for them now.
+		 */
+		_ready_wakeup();
+	}
+
+	if (f)
+		return f;
+
+	/*
+	 * Once we acquire a token from ipc_buffer_semaphore, it's our turn
+	 * to call `ipc_wait_cycle()`. There is one token for each entry of
+	 * the call buffer. If all of them are taken, we wait for one only
+	 * briefly, since fibrils becoming ready cannot wake us up there.
+	 */
+	if (!_ipc_buffer_trydown()) {
+		struct timespec retry;
+		getuptime(&retry);
+		ts_add_diff(&retry, MSEC2NSEC(IPC_BUFFER_RETRY_MSEC));
+		if (expires && ts_gt(&retry, expires))
+			retry = *expires;
+
+		if (_ipc_buffer_down(&retry) != EOK)
+			return NULL;
+	}
+
+	atomic_fetch_add_explicit(&threads_in_ipc_wait, 1, memory_order_relaxed);
+
+	/*
+	 * A fibril made ready before this point may not have woken anyone up.
+	 * Pairs with the fence in _ready_wakeup().
+	 */
+	atomic_thread_fence(memory_order_seq_cst);
+
+	f = _runner_pop(r);
+	if (!f)
+		f = _runner_steal(r);
+
+	if (f) {
+		/* Return token. */
+		_ipc_buffer_up();
+	} else {
+		/* No fibril is ready, IPC wait it is. */
+		f = _ready_ipc_wait(expires, false);
+	}
+
+	atomic_fetch_sub_explicit(&threads_in_ipc_wait, 1, memory_order_relaxed);
+	return f;
 }
 
-static void _ready_list_push(fibril_t *f)
+static fibril_t *_ready_list_pop_nonblocking(bool locked)
 {
-	if (!f)
-		return;
+	if (locked)
+		futex_assert_is_locked(&fibril_futex);
+	else
+		futex_assert_is_not_locked(&fibril_futex);
 
-	futex_assert_is_locked(&fibril_futex);
+	_runner_t *r = _runner_self();
+	fibril_t *f = _runner_pop(r);
+	if (!f)
+		f = _runner_steal(r);
 
-	/* Enqueue in ready_list. */
-	list_append(&f->link, &ready_list);
-	_ready_up();
+	if (f || !_ipc_buffer_trydown())
+		return f;
 
-	if (atomic_load_explicit(&threads_in_ipc_wait, memory_order_relaxed)) {
-		DPRINTF("Poking.\n");
-		/* Wakeup one thread sleeping in SYS_IPC_WAIT. */
-		ipc_poke();
-	}
+	struct timespec tv = { .tv_sec = 0, .tv_nsec = 0 };
+	return _ready_ipc_wait(&tv, locked);
 }
 
 /* Blocks the current fibril until an IPC call arrives. */
@@ -391,7 +688,7 @@ static errno_t _wait_ipc(ipc_call_t *call, const struct timespec *expires)
 		/* Return to freelist. */
 		list_append(&buf->link, &ipc_buffer_free_list);
 		/* Return IPC wait token. */
-		_ready_up();
+		_ipc_buffer_up();
 
 		futex_unlock(&ipc_lists_futex);
 		return rc;
@@ -414,6 +711,198 @@ static errno_t _wait_ipc(ipc_call_t *call, const struct timespec *expires)
 	return rc;
 }
 
+static usec_t _timeout_usec(const struct timespec *ts)
+{
+	/* Round up, so that the timeout does not fire early. */
+	return SEC2USEC((usec_t) ts->tv_sec) + NSEC2USEC(ts->tv_nsec + 999);
+}
+
+/**
+ * Find the first slot of a wheel level that is due.
+ *
+ * @param level  Wheel level to search.
+ * @param tick   Tick at which the slot is due. For levels above zero,
+ *               this is when the slot is moved down to lower levels.
+ * @return True if the level has any timeouts.
+ */
+static bool _timeout_wheel_slot_next(int level, uint64_t *tick)
+{
+	unsigned shift = level * TIMEOUT_WHEEL_BITS;
+
+	/*
+	 * On level zero, the slot of the current tick is still due.
+	 * Above it, the current slot was already moved down, and anything
+	 * in it is a full revolution ahead.
+	 */
+	uint64_t first = (timeout_wheel.tick >> shift) + (level == 0 ? 0 : 1);
+	unsigned rot = first & TIMEOUT_WHEEL_MASK;
+
+	while (timeout_wheel.map[level] != 0) {
+		uint64_t map = timeout_wheel.map[level];
+		if (rot != 0)
+			map = (map >> rot) | (map << (TIMEOUT_WHEEL_SLOTS - rot));
+
+		unsigned dist = fnzb64(map & -map);
+		unsigned idx = (rot + dist) & TIMEOUT_WHEEL_MASK;
+
+		if (list_empty(&timeout_wheel.slot[level][idx])) {
+			timeout_wheel.map[level] &= ~((uint64_t) 1 << idx);
+			continue;
+		}
+
+		*tick = (first + dist) << shift;
+		return true;
+	}
+
+	return false;
+}
+
+static void _timeout_wheel_insert(_timeout_t *timeout)
+{
+	futex_assert_is_locked(&fibril_futex);
+	assert(timeout);
+
+	uint64_t tick = (uint64_t) timeout->expires >> TIMEOUT_TICK_SHIFT;
+	if (tick < timeout_wheel.tick)
+		tick = timeout_wheel.tick;
+
+	uint64_t delta = tick - timeout_wheel.tick;
+	int level = 0;
+	while (level < TIMEOUT_WHEEL_LEVELS - 1 &&
+	    (delta >> ((level + 1) * TIMEOUT_WHEEL_BITS)) != 0)
+		level++;
+
+	/*
+	 * Timeouts beyond the reach of the wheel wait in the last slot of
+	 * the top level and are placed again once it comes around.
+	 */
+	if ((delta >> (TIMEOUT_WHEEL_LEVELS * TIMEOUT_WHEEL_BITS)) != 0)
+		tick = timeout_wheel.tick;
+
+	unsigned idx = (tick >> (level * TIMEOUT_WHEEL_BITS)) &
+	    TIMEOUT_WHEEL_MASK;
+
+	list_append(&timeout->link, &timeout_wheel.slot[level][idx]);
+	timeout_wheel.map[level] |= (uint64_t) 1 << idx;
+}
+
+/** Move the wheel to uptime @a now, firing all timeouts expired by then. */
+static void _timeout_wheel_advance(usec_t now)
+{
+	futex_assert_is_locked(&fibril_futex);
+
+	uint64_t target = (uint64_t) now >> TIMEOUT_TICK_SHIFT;
+
+	if (target - timeout_wheel.tick >=
+	    ((uint64_t) 1 << (TIMEOUT_WHEEL_LEVELS * TIMEOUT_WHEEL_BITS))) {
+		/*
+		 * The wheel has not turned for a whole revolution. Rather than
+		 * turning it slot by slot, place all timeouts anew.
+		 */
+		list_t all;
+		list_initialize(&all);
+
+		for (int level = 0; level < TIMEOUT_WHEEL_LEVELS; level++) {
+			for (int i = 0; i < TIMEOUT_WHEEL_SLOTS; i++)
+				list_concat(&all, &timeout_wheel.slot[level][i]);
+			timeout_wheel.map[level] = 0;
+		}
+
+		timeout_wheel.tick = target;
+
+		list_foreach_safe(all, cur, next) {
+			list_remove(cur);
+			_timeout_wheel_insert(list_get_instance(cur,
+			    _timeout_t, link));
+		}
+	}
+
+	while (true) {
+		list_t *slot = &timeout_wheel.slot[0][timeout_wheel.tick &
+		    TIMEOUT_WHEEL_MASK];
+
+		list_foreach_safe(*slot, cur, next) {
+			_timeout_t *to = list_get_instance(cur, _timeout_t, link);
+			if (to->expires > now)
+				continue;
+
+			list_remove(&to->link);
+			_ready_list_push(_fibril_trigger_internal(
+			    to->event, _EVENT_TIMED_OUT));
+		}
+
+		if (timeout_wheel.tick >= target)
+			break;
+
+		/* Skip over empty slots to the next tick when anything is due. */
+		uint64_t tick = target;
+		for (int level = 0; level < TIMEOUT_WHEEL_LEVELS; level++) {
+			uint64_t due;
+			if (_timeout_wheel_slot_next(level, &due) &&
+			    due > timeout_wheel.tick && due < tick)
+				tick = due;
+		}
+
+		timeout_wheel.tick = tick;
+
+		/* Move timeouts down from higher levels, top level first. */
+		for (int level = TIMEOUT_WHEEL_LEVELS - 1; level > 0; level--) {
+			unsigned shift = level * TIMEOUT_WHEEL_BITS;
+			if ((tick & (((uint64_t) 1 << shift) - 1)) != 0)
+				continue;
+
+			unsigned idx = (tick >> shift) & TIMEOUT_WHEEL_MASK;
+			list_t *slot = &timeout_wheel.slot[level][idx];
+
+			list_t moved;
+			list_initialize(&moved);
+			list_concat(&moved, slot);
+			timeout_wheel.map[level] &= ~((uint64_t) 1 << idx);
+
+			list_foreach_safe(moved, cur, next) {
+				list_remove(cur);
+				_timeout_wheel_insert(list_get_instance(cur,
+				    _timeout_t, link));
+			}
+		}
+	}
+}
+
+/** Find the uptime at which the wheel has to be advanced next. */
+static bool _timeout_wheel_next(usec_t *next)
+{
+	futex_assert_is_locked(&fibril_futex);
+
+	bool found = false;
+
+	for (int level = 0; level < TIMEOUT_WHEEL_LEVELS; level++) {
+		uint64_t tick;
+		if (!_timeout_wheel_slot_next(level, &tick))
+			continue;
+
+		usec_t usec = (usec_t) (tick << TIMEOUT_TICK_SHIFT);
+
+		if (level == 0) {
+			list_t *slot = &timeout_wheel.slot[0][tick &
+			    TIMEOUT_WHEEL_MASK];
+
+			usec = list_get_instance(list_first(slot),
+			    _timeout_t, link)->expires;
+
+			list_foreach(*slot, link, _timeout_t, to) {
+				if (to->expires < usec)
+					usec = to->expires;
+			}
+		}
+
+		if (!found || usec < *next)
+			*next = usec;
+		found = true;
+	}
+
+	return found;
+}
+
 /** Fire all timeouts that expired. */
 static struct timespec *_handle_expired_timeouts(struct timespec *next_timeout)
 {
@@ -422,29 +911,25 @@ static struct timespec *_handle_expired_timeouts(struct timespec *next_timeout)
 
 	futex_lock(&fibril_futex);
 
-	while (!list_empty(&timeout_list)) {
-		link_t *cur = list_first(&timeout_list);
-		_timeout_t *to = list_get_instance(cur, _timeout_t, link);
+	_timeout_wheel_advance(SEC2USEC((usec_t) ts.tv_sec) +
+	    NSEC2USEC(ts.tv_nsec));
 
-		if (ts_gt(&to->expires, &ts)) {
-			*next_timeout = to->expires;
-			futex_unlock(&fibril_futex);
-			return next_timeout;
-		}
+	usec_t next = 0;
+	bool found = _timeout_wheel_next(&next);
 
-		list_remove(&to->link);
+	futex_unlock(&fibril_futex);
 
-		_ready_list_push(_fibril_trigger_internal(
-		    to->event, _EVENT_TIMED_OUT));
-	}
+	if (!found)
+		return NULL;
 
-	futex_unlock(&fibril_futex);
-	return NULL;
+	next_timeout->tv_sec = USEC2SEC(next);
+	next_timeout->tv_nsec = USEC2NSEC(next % SEC2USEC(1));
+	return next_timeout;
 }
 
 /**
  * Clean up after a dead fibril from which we restored context, if any.
- * Called after a switch is made and fibril_futex is unlocked.
+ * Called after a switch is made.
  */
 static void _fibril_cleanup_dead(void)
 {
@@ -459,15 +944,44 @@ static void _fibril_cleanup_dead(void)
 	srcf->clean_after_me = NULL;
 }
 
-/** Switch to a fibril. */
+/**
+ * Finish a switch to the current fibril.
+ *
+ * Until the context of the previous fibril is saved, no other thread may
+ * get to it. So it is made ready only here, and if it went to sleep,
+ * fibril_futex is held until here.
+ */
+static void _fibril_switch_done(void)
+{
+	fibril_t *f = fibril_self();
+
+	if (f->has_fibril_futex) {
+		f->has_fibril_futex = false;
+		futex_unlock(&fibril_futex);
+	}
+
+	if (f->ready_after_me) {
+		_runner_push(_runner_self(), f->ready_after_me);
+		f->ready_after_me = NULL;
+	}
+
+	_fibril_cleanup_dead();
+}
+
+/**
+ * Switch to a fibril.
+ *
+ * @param locked  fibril_futex is held because the source fibril goes to
+ *                sleep. It is handed over to the destination fibril.
+ */
 static void _fibril_switch_to(_switch_type_t type, fibril_t *dstf, bool locked)
 {
 	assert(fibril_self()->rmutex_locks == 0);
 
-	if (!locked)
-		futex_lock(&fibril_futex);
-	else
+	if (locked)
 		futex_assert_is_locked(&fibril_futex);
+	else
+		futex_assert_is_not_locked(&fibril_futex);
 
 	fibril_t *srcf = fibril_self();
 	assert(srcf);
@@ -475,7 +989,7 @@ static void _fibril_switch_to(_switch_type_t type, fibril_t *dstf, bool locked)
 
 	switch (type) {
 	case SWITCH_FROM_YIELD:
-		_ready_list_push(srcf);
+		dstf->ready_after_me = srcf;
 		break;
 	case SWITCH_FROM_DEAD:
 		dstf->clean_after_me = srcf;
@@ -487,9 +1001,13 @@ static void _fibril_switch_to(_switch_type_t type, fibril_t *dstf, bool locked)
 
 	dstf->thread_ctx = srcf->thread_ctx;
 	srcf->thread_ctx = NULL;
+	dstf->runner = srcf->runner;
 
-	/* Just some bookkeeping to allow better debugging of futex locks. */
-	futex_give_to(&fibril_futex, dstf);
+	if (locked) {
+		dstf->has_fibril_futex = true;
+		/* Just some bookkeeping to allow better debugging of futex locks. */
+		futex_give_to(&fibril_futex, dstf);
+	}
 
 	/* Swap to the next fibril. */
 	context_swap(&srcf->ctx, &dstf->ctx);
@@ -497,11 +1015,8 @@ static void _fibril_switch_to(_switch_type_t type, fibril_t *dstf, bool locked)
 	assert(srcf == fibril_self());
 	assert(srcf->thread_ctx);
 
-	if (!locked) {
-		/* Must be after context_swap()! */
-		futex_unlock(&fibril_futex);
-		_fibril_cleanup_dead();
-	}
+	/* Must be after context_swap()! */
+	_fibril_switch_done();
 }
 
 /**
@@ -523,7 +1038,7 @@ static errno_t _helper_fibril_fn(void *arg)
 	struct timespec next_timeout;
 	while (true) {
 		struct timespec *to = _handle_expired_timeouts(&next_timeout);
-		fibril_t *f = _ready_list_pop(to, false);
+		fibril_t *f = _ready_list_pop(to);
 		if (f) {
 			_fibril_switch_to(SWITCH_FROM_HELPER, f, false);
 		}
@@ -595,24 +1110,6 @@ void fibril_destroy(fid_t fid)
 	fibril_teardown(fibril);
 }
 
-static void _insert_timeout(_timeout_t *timeout)
-{
-	futex_assert_is_locked(&fibril_futex);
-	assert(timeout);
-
-	link_t *tmp = timeout_list.head.next;
-	while (tmp != &timeout_list.head) {
-		_timeout_t *cur = list_get_instance(tmp, _timeout_t, link);
-
-		if (ts_gteq(&cur->expires, &timeout->expires))
-			break;
-
-		tmp = tmp->next;
-	}
-
-	list_insert_before(&timeout->link, tmp);
-}
-
 /**
  * Same as `fibril_wait_for()`, except with a timeout.
  *
@@ -679,9 +1176,9 @@ errno_t fibril_wait_timeout(fibril_event_t *event,
 
 	_timeout_t timeout = { 0 };
 	if (expires) {
-		timeout.expires = *expires;
+		timeout.expires = _timeout_usec(expires);
 		timeout.event = event;
-		_insert_timeout(&timeout);
+		_timeout_wheel_insert(&timeout);
 	}
 
 	assert(srcf);
@@ -693,16 +1190,18 @@ errno_t fibril_wait_timeout(fibril_event_t *event,
 
 	_fibril_switch_to(SWITCH_FROM_BLOCKED, dstf, true);
 
+	futex_lock(&fibril_futex);
+
 	assert(event->fibril != srcf);
 	assert(event->fibril != _EVENT_INITIAL);
 	assert(event->fibril == _EVENT_TIMED_OUT || event->fibril == _EVENT_TRIGGERED);
 
+	/* Cancel the timeout, its wheel slot is cleaned up lazily. */
 	list_remove(&timeout.link);
 	errno_t rc = (event->fibril == _EVENT_TIMED_OUT) ? ETIMEOUT : EOK;
 	event->fibril = _EVENT_INITIAL;
 
 	futex_unlock(&fibril_futex);
-	_fibril_cleanup_dead();
 	return rc;
 }
 
@@ -722,8 +1221,10 @@ void fibril_wait_for(fibril_event_t *event)
 void fibril_notify(fibril_event_t *event)
 {
 	futex_lock(&fibril_futex);
-	_ready_list_push(_fibril_trigger_internal(event, _EVENT_TRIGGERED));
+	fibril_t *f = _fibril_trigger_internal(event, _EVENT_TRIGGERED);
 	futex_unlock(&fibril_futex);
+
+	_ready_list_push(f);
 }
 
 /** Start a fibril that has not been running yet. */
@@ -736,9 +1237,9 @@ void fibril_start(fibril_t *fibril)
 	if (!link_in_use(&fibril->all_link))
 		list_append(&fibril->all_link, &fibril_list);
 
-	_ready_list_push(fibril);
-
 	futex_unlock(&fibril_futex);
+
+	_ready_list_push(fibril);
 }
 
 /** Start a fibril that has not been running yet. (obsolete) */
@@ -785,6 +1286,74 @@ static void _runner_fn(void *arg)
 	_helper_fibril_fn(arg);
 }
 
+/**
+ * Switch the fibril machinery to multithreaded operation.
+ *
+ * This has to happen before any thread other than the main one
+ * gets to touch the fibril state, which is why thread_create()
+ * calls it. Until then only one thread runs, so no locking
+ * is needed here.
+ */
+void fibril_set_multithreaded(void)
+{
+	if (multithreaded)
+		return;
+
+	_ipc_buffer_debug_check();
+	if (futex_initialize(&ipc_buffer_semaphore, ipc_buffer_st_count) != EOK)
+		abort();
+	multithreaded = true;
+}
+
+/**
+ * Give up the ready queue of the current thread, which is about to exit.
+ *
+ * Fibrils left in the queue are taken over by the other runners.
+ */
+void fibril_runner_release(void)
+{
+	fibril_t *f = fibril_self();
+	_runner_t *r = f->runner;
+	if (!r)
+		return;
+
+	f->runner = NULL;
+
+	futex_lock(&runner_futex);
+	assert(r->users > 0);
+	r->users--;
+	futex_unlock(&runner_futex);
+
+	if (atomic_load_explicit(&r->ready_count, memory_order_relaxed))
+		_ready_wakeup();
+}
+
+/** Get the number of runners fibril_enable_multithreaded() aims for.
+ *
+ * That is one runner per active processor, or 4 if the processor
+ * statistics are not available.
+ */
+static int _runner_count(void)
+{
+	/*
+	 * Same as stats_get_cpus(), but <stats.h> cannot be
+	 * mixed with the low-level IPC interface.
+	 */
+	size_t size = 0;
+	stats_cpu_t *cpus = sysinfo_get_data("system.cpus", &size);
+	if (!cpus)
+		return 4;
+
+	int active = 0;
+	for (size_t i = 0; i < size / sizeof(stats_cpu_t); i++) {
+		if (cpus[i].active)
+			active++;
+	}
+
+	free(cpus);
+	return active > 0 ? active : 1;
+}
+
 /**
  * Spawn a given number of runners (i.e. OS threads) immediately, and
  * unconditionally. This is meant to be used for tests and debugging.
@@ -797,12 +1366,7 @@ int fibril_test_spawn_runners(int n)
 {
 	assert(fibril_self()->rmutex_locks == 0);
 
-	if (!multithreaded) {
-		_ready_debug_check();
-		if (futex_initialize(&ready_semaphore, ready_st_count) != EOK)
-			abort();
-		multithreaded = true;
-	}
+	fibril_set_multithreaded();
 
 	errno_t rc;
 
@@ -821,17 +1385,17 @@ int fibril_test_spawn_runners(int n)
  * Opt-in to have more than one runner thread.
  *
  * Currently, a task only ever runs in one thread because multithreading
- * might break some existing code.
+ * might break some existing code. Once enabled, fibrils are run by one
+ * runner thread per active processor.
  *
  * Eventually, the number of runner threads for a given task should become
  * configurable in the environment and this function becomes no-op.
  */
 void fibril_enable_multithreaded(void)
 {
-	// TODO: Implement better.
-	//       For now, 4 total runners is a sensible default.
+	/* The calling thread is a runner too. */
 	if (!multithreaded) {
-		fibril_test_spawn_runners(3);
+		fibril_test_spawn_runners(_runner_count() - 1);
 	}
 }
 
@@ -869,6 +1433,13 @@ void __fibrils_init(void)
 		abort();
 	if (futex_initialize(&ipc_lists_futex, 1) != EOK)
 		abort();
+	if (futex_initialize(&runner_futex, 1) != EOK)
+		abort();
+
+	for (int level = 0; level < TIMEOUT_WHEEL_LEVELS; level++) {
+		for (int i = 0; i < TIMEOUT_WHEEL_SLOTS; i++)
+			list_initialize(&timeout_wheel.slot[level][i]);
+	}
 
 	/*
 	 * We allow a fixed, small amount of parallelism for IPC reads, but
@@ -881,7 +1452,7 @@ void __fibrils_init(void)
 
 	for (int i = 0; i < IPC_BUFFER_COUNT; i++) {
 		list_append(&buffers[i].link, &ipc_buffer_free_list);
-		_ready_up();
+		_ipc_buffer_up();
 	}
 }
 
@@ -889,6 +1460,7 @@ void __fibrils_fini(void)
 {
 	futex_destroy(&fibril_futex);
 	futex_destroy(&ipc_lists_futex);
+	futex_destroy(&runner_futex);
 }
 
 void fibril_usleep(usec_t timeout)
@@ -923,5 +1495,48 @@ errno_t fibril_ipc_wait(ipc_call_t *call, const struct timespec *expires)
 	return _wait_ipc(call, expires);
 }
 
+/**
+ * Same as `fibril_ipc_wait()`, but after the first call, also takes the
+ * calls that are already received and waiting in buffers, up to @a count
+ * in total.
+ */
+errno_t fibril_ipc_wait_batch(ipc_call_t *calls, size_t count,
+    size_t *received, const struct timespec *expires)
+{
+	assert(count > 0);
+
+	*received = 0;
+
+	errno_t rc = _wait_ipc(&calls[0], expires);
+	if (rc != EOK)
+		return rc;
+
+	size_t n = 1;
+
+	futex_lock(&ipc_lists_futex);
+
+	while (n < count && !list_empty(&ipc_buffer_list)) {
+		_ipc_buffer_t *buf = list_get_instance(
+		    list_first(&ipc_buffer_list), _ipc_buffer_t, link);
+
+		/* Leave poke results for fibril_ipc_wait() to return alone. */
+		if (buf->rc != EOK)
+			break;
+
+		list_remove(&buf->link);
+		calls[n++] = buf->call;
+
+		/* Return to freelist. */
+		list_append(&buf->link, &ipc_buffer_free_list);
+		/* Return IPC wait token. */
+		_ipc_buffer_up();
+	}
+
+	futex_unlock(&ipc_lists_futex);
+
+	*received = n;
+	return EOK;
+}
+
 /** @}
  */
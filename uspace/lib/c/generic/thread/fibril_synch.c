@@ -190,6 +190,75 @@ void fibril_mutex_lock(fibril_mutex_t *fm)
 	fibril_wait_for(&wdata.event);
 }
 
+/** Compute the deadline of a relative timeout.
+ *
+ * @return @a ts, or NULL if @a timeout is zero, i.e. never expires.
+ */
+static struct timespec *_timeout_expires(struct timespec *ts, usec_t timeout)
+{
+	if (!timeout)
+		return NULL;
+
+	getuptime(ts);
+	ts_add_diff(ts, USEC2NSEC(timeout));
+	return ts;
+}
+
+/** Lock a mutex, giving up once the timeout expires.
+ *
+ * A negative timeout only tries to lock the mutex once, while a zero
+ * timeout never expires, same as in fibril_condvar_wait_timeout().
+ *
+ * Timed waiters are not considered by the deadlock detection,
+ * since they can always get out of the deadlock by timing out.
+ *
+ * @return EOK if the mutex was locked, ETIMEOUT otherwise.
+ */
+errno_t fibril_mutex_lock_timeout(fibril_mutex_t *fm, usec_t timeout)
+{
+	fibril_t *f = (fibril_t *) fibril_get_id();
+
+	futex_lock(&fibril_synch_futex);
+
+	if (fm->counter > 0) {
+		fm->counter--;
+		fm->oi.owned_by = f;
+		futex_unlock(&fibril_synch_futex);
+		return EOK;
+	}
+
+	if (timeout < 0) {
+		futex_unlock(&fibril_synch_futex);
+		return ETIMEOUT;
+	}
+
+	fm->counter--;
+
+	awaiter_t wdata = AWAITER_INIT;
+	list_append(&wdata.link, &fm->waiters);
+
+	futex_unlock(&fibril_synch_futex);
+
+	struct timespec ts;
+	errno_t rc = fibril_wait_timeout(&wdata.event,
+	    _timeout_expires(&ts, timeout));
+	if (rc == EOK)
+		return EOK;
+
+	futex_lock(&fibril_synch_futex);
+	if (!link_in_use(&wdata.link)) {
+		/* The mutex was handed over to us before we gave up. */
+		futex_unlock(&fibril_synch_futex);
+		return EOK;
+	}
+
+	list_remove(&wdata.link);
+	fm->counter++;
+	futex_unlock(&fibril_synch_futex);
+
+	return rc;
+}
+
 bool fibril_mutex_trylock(fibril_mutex_t *fm)
 {
 	bool locked = false;
@@ -297,6 +366,103 @@ void fibril_rwlock_write_lock(fibril_rwlock_t *frw)
 	fibril_wait_for(&wdata.event);
 }
 
+/** Common part of the timed read and write locking.
+ *
+ * Same timeout semantics as fibril_mutex_lock_timeout().
+ */
+static errno_t _fibril_rwlock_lock_timeout(fibril_rwlock_t *frw, bool writer,
+    usec_t timeout)
+{
+	fibril_t *f = (fibril_t *) fibril_get_id();
+
+	futex_lock(&fibril_synch_futex);
+
+	if (writer && !frw->writers && !frw->readers) {
+		frw->oi.owned_by = f;
+		frw->writers++;
+		futex_unlock(&fibril_synch_futex);
+		return EOK;
+	}
+
+	if (!writer && !frw->writers) {
+		/* Consider the first reader the owner. */
+		if (frw->readers++ == 0)
+			frw->oi.owned_by = f;
+		futex_unlock(&fibril_synch_futex);
+		return EOK;
+	}
+
+	if (timeout < 0) {
+		futex_unlock(&fibril_synch_futex);
+		return ETIMEOUT;
+	}
+
+	f->is_writer = writer;
+
+	awaiter_t wdata = AWAITER_INIT;
+	list_append(&wdata.link, &frw->waiters);
+
+	futex_unlock(&fibril_synch_futex);
+
+	struct timespec ts;
+	errno_t rc = fibril_wait_timeout(&wdata.event,
+	    _timeout_expires(&ts, timeout));
+	if (rc == EOK)
+		return EOK;
+
+	futex_lock(&fibril_synch_futex);
+	if (!link_in_use(&wdata.link)) {
+		/* The lock was handed over to us before we gave up. */
+		futex_unlock(&fibril_synch_futex);
+		return EOK;
+	}
+
+	list_remove(&wdata.link);
+
+	/*
+	 * Readers queued behind a writer that gave up can
+	 * join the readers that currently hold the lock.
+	 */
+	while (!frw->writers && !list_empty(&frw->waiters)) {
+		awaiter_t *wdp = list_get_instance(list_first(&frw->waiters),
+		    awaiter_t, link);
+		fibril_t *w = (fibril_t *) wdp->fid;
+
+		if (w->is_writer)
+			break;
+
+		frw->readers++;
+		w->waits_for = NULL;
+		list_remove(&wdp->link);
+		frw->oi.owned_by = w;
+		fibril_notify(&wdp->event);
+	}
+
+	futex_unlock(&fibril_synch_futex);
+
+	return rc;
+}
+
+errno_t fibril_rwlock_read_lock_timeout(fibril_rwlock_t *frw, usec_t timeout)
+{
+	return _fibril_rwlock_lock_timeout(frw, false, timeout);
+}
+
+errno_t fibril_rwlock_write_lock_timeout(fibril_rwlock_t *frw, usec_t timeout)
+{
+	return _fibril_rwlock_lock_timeout(frw, true, timeout);
+}
+
+bool fibril_rwlock_read_trylock(fibril_rwlock_t *frw)
+{
+	return _fibril_rwlock_lock_timeout(frw, false, -1) == EOK;
+}
+
+bool fibril_rwlock_write_trylock(fibril_rwlock_t *frw)
+{
+	return _fibril_rwlock_lock_timeout(frw, true, -1) == EOK;
+}
+
 static void _fibril_rwlock_common_unlock(fibril_rwlock_t *frw)
 {
 	if (frw->readers) {
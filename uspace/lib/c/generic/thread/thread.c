@@ -73,6 +73,7 @@ void __thread_main(uspace_arg_t *uarg)
 	 * free(uarg);
 	 */
 
+	fibril_runner_release();
 	fibril_teardown(fibril);
 	thread_exit(0);
 }
@@ -120,6 +121,9 @@ errno_t thread_create(void (*function)(void *), void *arg, const char *name,
 	uarg->uspace_thread_arg = fibril;
 	uarg->uspace_uarg = uarg;
 
+	/* The new thread shares the fibril state with us. */
+	fibril_set_multithreaded();
+
 	errno_t rc = (errno_t) __SYSCALL4(SYS_THREAD_CREATE, (sysarg_t) uarg,
 	    (sysarg_t) name, (sysarg_t) str_size(name), (sysarg_t) tid);
 
@@ -148,12 +148,17 @@ extern void __fibril_synch_fini(void);
 extern void fibril_mutex_initialize(fibril_mutex_t *);
 extern void fibril_mutex_lock(fibril_mutex_t *);
 extern bool fibril_mutex_trylock(fibril_mutex_t *);
+extern errno_t fibril_mutex_lock_timeout(fibril_mutex_t *, usec_t);
 extern void fibril_mutex_unlock(fibril_mutex_t *);
 extern bool fibril_mutex_is_locked(fibril_mutex_t *);
 
 extern void fibril_rwlock_initialize(fibril_rwlock_t *);
 extern void fibril_rwlock_read_lock(fibril_rwlock_t *);
 extern void fibril_rwlock_write_lock(fibril_rwlock_t *);
+extern bool fibril_rwlock_read_trylock(fibril_rwlock_t *);
+extern bool fibril_rwlock_write_trylock(fibril_rwlock_t *);
+extern errno_t fibril_rwlock_read_lock_timeout(fibril_rwlock_t *, usec_t);
+extern errno_t fibril_rwlock_write_lock_timeout(fibril_rwlock_t *, usec_t);
 extern void fibril_rwlock_read_unlock(fibril_rwlock_t *);
 extern void fibril_rwlock_write_unlock(fibril_rwlock_t *);
 extern bool fibril_rwlock_is_read_locked(fibril_rwlock_t *);
@@ -37,6 +37,28 @@
 
 #include <stddef.h>
 
+/** Heap statistics gathered by heap_check_stats() */
+typedef struct {
+	/** Number of heap areas */
+	size_t areas;
+	/** Total size of the heap areas (bytes) */
+	size_t area_bytes;
+	/** Number of used blocks (including the cached ones) */
+	size_t used_blocks;
+	/** Net size of the used blocks (bytes) */
+	size_t used_bytes;
+	/** Number of used blocks kept in the per-thread caches */
+	size_t cached_blocks;
+	/** Net size of the cached blocks (bytes) */
+	size_t cached_bytes;
+	/** Number of free blocks */
+	size_t free_blocks;
+	/** Net size of the free blocks (bytes) */
+	size_t free_bytes;
+	/** Net size of the largest free block (bytes) */
+	size_t largest_free;
+} heap_stats_t;
+
 extern void *malloc(size_t size)
     __attribute__((malloc));
 extern void *calloc(size_t nmemb, size_t size)
@@ -47,6 +69,7 @@ extern void *realloc(void *addr, size_t size)
     __attribute__((warn_unused_result));
 extern void free(void *addr);
 extern void *heap_check(void);
+extern void *heap_check_stats(heap_stats_t *);
 
 #endif
 
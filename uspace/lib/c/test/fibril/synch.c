@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2017 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <errno.h>
+#include <fibril.h>
+#include <fibril_synch.h>
+#include <pcut/pcut.h>
+#include <stdbool.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(fibril_synch);
+
+/** Long enough to never expire in the tests that expect a handover. */
+#define LONG_TIMEOUT  (10 * 1000 * 1000)
+#define SHORT_TIMEOUT (10 * 1000)
+
+typedef struct {
+	fibril_mutex_t *mutex;
+	fibril_rwlock_t *rwlock;
+	usec_t timeout;
+	errno_t rc;
+	bool done;
+	/** Do not unlock until this becomes true. */
+	volatile bool *release;
+} test_locker_t;
+
+static void wait_done(volatile bool *done)
+{
+	while (!*done)
+		fibril_usleep(1000);
+}
+
+static errno_t mutex_locker_fn(void *arg)
+{
+	test_locker_t *locker = arg;
+
+	locker->rc = fibril_mutex_lock_timeout(locker->mutex, locker->timeout);
+	if (locker->rc == EOK)
+		fibril_mutex_unlock(locker->mutex);
+
+	locker->done = true;
+	return EOK;
+}
+
+static errno_t reader_fn(void *arg)
+{
+	test_locker_t *locker = arg;
+
+	locker->rc = fibril_rwlock_read_lock_timeout(locker->rwlock,
+	    locker->timeout);
+	if (locker->rc == EOK) {
+		if (locker->release)
+			wait_done(locker->release);
+		fibril_rwlock_read_unlock(locker->rwlock);
+	}
+
+	locker->done = true;
+	return EOK;
+}
+
+static errno_t writer_fn(void *arg)
+{
+	test_locker_t *locker = arg;
+
+	locker->rc = fibril_rwlock_write_lock_timeout(locker->rwlock,
+	    locker->timeout);
+	if (locker->rc == EOK)
+		fibril_rwlock_write_unlock(locker->rwlock);
+
+	locker->done = true;
+	return EOK;
+}
+
+static void start_locker(errno_t (*fn)(void *), test_locker_t *locker)
+{
+	fid_t fid = fibril_create(fn, locker);
+	PCUT_ASSERT_NOT_NULL(fid);
+	fibril_add_ready(fid);
+}
+
+PCUT_TEST(mutex_lock_timeout_unlocked)
+{
+	fibril_mutex_t mutex;
+
+	fibril_mutex_initialize(&mutex);
+	PCUT_ASSERT_ERRNO_VAL(EOK, fibril_mutex_lock_timeout(&mutex, SHORT_TIMEOUT));
+	PCUT_ASSERT_TRUE(fibril_mutex_is_locked(&mutex));
+	fibril_mutex_unlock(&mutex);
+}
+
+PCUT_TEST(mutex_lock_timeout_expires)
+{
+	fibril_mutex_t mutex;
+
+	fibril_mutex_initialize(&mutex);
+	fibril_mutex_lock(&mutex);
+
+	/* Negative timeout only tries once. */
+	PCUT_ASSERT_ERRNO_VAL(ETIMEOUT, fibril_mutex_lock_timeout(&mutex, -1));
+
+	test_locker_t locker = { .mutex = &mutex, .timeout = SHORT_TIMEOUT };
+	start_locker(mutex_locker_fn, &locker);
+	wait_done(&locker.done);
+	PCUT_ASSERT_ERRNO_VAL(ETIMEOUT, locker.rc);
+
+	/* The timed out waiter must not be handed the mutex. */
+	fibril_mutex_unlock(&mutex);
+	PCUT_ASSERT_TRUE(fibril_mutex_trylock(&mutex));
+	fibril_mutex_unlock(&mutex);
+}
+
+PCUT_TEST(mutex_lock_timeout_handover)
+{
+	fibril_mutex_t mutex;
+
+	fibril_mutex_initialize(&mutex);
+	fibril_mutex_lock(&mutex);
+
+	test_locker_t locker = { .mutex = &mutex, .timeout = LONG_TIMEOUT };
+	start_locker(mutex_locker_fn, &locker);
+	fibril_usleep(1000);
+	PCUT_ASSERT_FALSE(locker.done);
+
+	fibril_mutex_unlock(&mutex);
+	wait_done(&locker.done);
+	PCUT_ASSERT_ERRNO_VAL(EOK, locker.rc);
+}
+
+PCUT_TEST(rwlock_trylock)
+{
+	fibril_rwlock_t rwlock;
+
+	fibril_rwlock_initialize(&rwlock);
+
+	PCUT_ASSERT_TRUE(fibril_rwlock_read_trylock(&rwlock));
+	PCUT_ASSERT_TRUE(fibril_rwlock_read_trylock(&rwlock));
+	PCUT_ASSERT_FALSE(fibril_rwlock_write_trylock(&rwlock));
+	fibril_rwlock_read_unlock(&rwlock);
+	fibril_rwlock_read_unlock(&rwlock);
+
+	PCUT_ASSERT_TRUE(fibril_rwlock_write_trylock(&rwlock));
+	PCUT_ASSERT_FALSE(fibril_rwlock_read_trylock(&rwlock));
+	PCUT_ASSERT_FALSE(fibril_rwlock_write_trylock(&rwlock));
+	fibril_rwlock_write_unlock(&rwlock);
+
+	PCUT_ASSERT_FALSE(fibril_rwlock_is_locked(&rwlock));
+}
+
+PCUT_TEST(rwlock_lock_timeout_expires)
+{
+	fibril_rwlock_t rwlock;
+
+	fibril_rwlock_initialize(&rwlock);
+	fibril_rwlock_write_lock(&rwlock);
+
+	test_locker_t reader = { .rwlock = &rwlock, .timeout = SHORT_TIMEOUT };
+	test_locker_t writer = { .rwlock = &rwlock, .timeout = SHORT_TIMEOUT };
+	start_locker(reader_fn, &reader);
+	start_locker(writer_fn, &writer);
+	wait_done(&reader.done);
+	wait_done(&writer.done);
+	PCUT_ASSERT_ERRNO_VAL(ETIMEOUT, reader.rc);
+	PCUT_ASSERT_ERRNO_VAL(ETIMEOUT, writer.rc);
+
+	fibril_rwlock_write_unlock(&rwlock);
+	PCUT_ASSERT_FALSE(fibril_rwlock_is_locked(&rwlock));
+}
+
+/*
+ * A writer waiting with a timeout blocks the readers queued behind it
+ * only until it gives up, then they join the readers holding the lock.
+ */
+PCUT_TEST(rwlock_readers_pass_timed_out_writer)
+{
+	fibril_rwlock_t rwlock;
+	volatile bool release = false;
+
+	fibril_rwlock_initialize(&rwlock);
+	fibril_rwlock_write_lock(&rwlock);
+
+	test_locker_t first = {
+		.rwlock = &rwlock, .timeout = LONG_TIMEOUT, .release = &release
+	};
+	test_locker_t writer = { .rwlock = &rwlock, .timeout = SHORT_TIMEOUT };
+	test_locker_t second = { .rwlock = &rwlock, .timeout = LONG_TIMEOUT };
+
+	start_locker(reader_fn, &first);
+	fibril_usleep(1000);
+	start_locker(writer_fn, &writer);
+	fibril_usleep(1000);
+	start_locker(reader_fn, &second);
+	fibril_usleep(1000);
+
+	/* Wakes up the first reader, the writer keeps waiting. */
+	fibril_rwlock_write_unlock(&rwlock);
+
+	wait_done(&writer.done);
+	PCUT_ASSERT_ERRNO_VAL(ETIMEOUT, writer.rc);
+
+	wait_done(&second.done);
+	PCUT_ASSERT_ERRNO_VAL(EOK, second.rc);
+
+	release = true;
+	wait_done(&first.done);
+	PCUT_ASSERT_ERRNO_VAL(EOK, first.rc);
+	PCUT_ASSERT_FALSE(fibril_rwlock_is_locked(&rwlock));
+}
+
+PCUT_EXPORT(fibril_synch);
@@ -138,4 +138,42 @@ PCUT_TEST(fire)
 	fibril_timer_destroy(t);
 }
 
+static int fire_order[5];
+static int fire_count;
+
+static void test_order_fn(void *arg)
+{
+	fire_order[fire_count++] = (int) (intptr_t) arg;
+}
+
+PCUT_TEST(fire_order)
+{
+	/* Some delays are long enough to have to move down the timer wheel. */
+	usec_t delays[5] = { 150000, 1000, 70000, 20000, 5000 };
+	int expected[5] = { 1, 4, 3, 2, 0 };
+	fibril_timer_t *t[5];
+	int i;
+
+	fire_count = 0;
+
+	for (i = 0; i < 5; i++) {
+		t[i] = fibril_timer_create(NULL);
+		PCUT_ASSERT_NOT_NULL(t[i]);
+	}
+
+	for (i = 0; i < 5; i++) {
+		fibril_timer_set(t[i], delays[i], test_order_fn,
+		    (void *) (intptr_t) i);
+	}
+
+	fibril_usleep(300000);
+
+	PCUT_ASSERT_INT_EQUALS(5, fire_count);
+	for (i = 0; i < 5; i++) {
+		PCUT_ASSERT_INT_EQUALS(expected[i], fire_order[i]);
+		PCUT_ASSERT_INT_EQUALS(fts_fired, fibril_timer_clear(t[i]));
+		fibril_timer_destroy(t[i]);
+	}
+}
+
 PCUT_EXPORT(fibril_timer);
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2018 Jiri Svoboda
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <as.h>
+#include <fibril_synch.h>
+#include <malloc.h>
+#include <mem.h>
+#include <pcut/pcut.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <thread.h>
+
+PCUT_INIT;
+
+PCUT_TEST_SUITE(malloc);
+
+#define BLOCK_COUNT  256
+#define ROUND_COUNT  64
+#define THREAD_COUNT  4
+
+/** Fill a block with a pattern specific to its index and size. */
+static void block_fill(uint8_t *block, size_t idx, size_t size)
+{
+	memset(block, (uint8_t) (idx + size), size);
+}
+
+/** Check the pattern written by block_fill(). */
+static bool block_verify(uint8_t *block, size_t idx, size_t size)
+{
+	for (size_t i = 0; i < size; i++) {
+		if (block[i] != (uint8_t) (idx + size))
+			return false;
+	}
+
+	return true;
+}
+
+/** Allocate and free blocks of various sizes in an interleaved fashion.
+ *
+ * @param seed Seed that makes the pattern differ between threads.
+ * @return Whether all blocks kept their contents.
+ */
+static bool churn(size_t seed)
+{
+	uint8_t *blocks[BLOCK_COUNT] = { NULL };
+	size_t sizes[BLOCK_COUNT];
+	bool ok = true;
+
+	for (size_t round = 0; round < ROUND_COUNT; round++) {
+		for (size_t i = round % 2; i < BLOCK_COUNT; i += 2) {
+			if (blocks[i] != NULL) {
+				if (!block_verify(blocks[i], i, sizes[i]))
+					ok = false;
+				free(blocks[i]);
+			}
+
+			sizes[i] = (i * 37 + round * 11 + seed) % 700;
+			blocks[i] = malloc(sizes[i]);
+			if (blocks[i] == NULL)
+				return false;
+
+			block_fill(blocks[i], i, sizes[i]);
+		}
+	}
+
+	for (size_t i = 0; i < BLOCK_COUNT; i++) {
+		if (blocks[i] != NULL) {
+			if (!block_verify(blocks[i], i, sizes[i]))
+				ok = false;
+			free(blocks[i]);
+		}
+	}
+
+	return ok;
+}
+
+/** Freed small blocks are handed out again */
+PCUT_TEST(reuse)
+{
+	void *p = malloc(24);
+	PCUT_ASSERT_NOT_NULL(p);
+	free(p);
+
+	void *q = malloc(24);
+	PCUT_ASSERT_NOT_NULL(q);
+	PCUT_ASSERT_EQUALS(p, q);
+	free(q);
+
+	PCUT_ASSERT_NULL(heap_check());
+}
+
+/** Allocations of all sizes keep their contents */
+PCUT_TEST(sizes)
+{
+	PCUT_ASSERT_TRUE(churn(0));
+	PCUT_ASSERT_NULL(heap_check());
+}
+
+/** Zero-sized allocations are usable */
+PCUT_TEST(zero)
+{
+	void *p = malloc(0);
+	PCUT_ASSERT_NOT_NULL(p);
+	free(p);
+
+	PCUT_ASSERT_NULL(heap_check());
+}
+
+/** Aligned allocations are aligned */
+PCUT_TEST(memalign)
+{
+	for (size_t align = 1; align <= 4096; align *= 2) {
+		void *p = memalign(align, 40);
+		PCUT_ASSERT_NOT_NULL(p);
+		PCUT_ASSERT_INT_EQUALS(0, (uintptr_t) p % align);
+		free(p);
+	}
+
+	PCUT_ASSERT_NULL(heap_check());
+}
+
+/** Blocks can be resized both ways */
+PCUT_TEST(realloc)
+{
+	uint8_t *p = malloc(16);
+	PCUT_ASSERT_NOT_NULL(p);
+	block_fill(p, 0, 16);
+
+	/* Previously cached blocks must be resizable too. */
+	free(malloc(16));
+
+	p = realloc(p, 4000);
+	PCUT_ASSERT_NOT_NULL(p);
+	PCUT_ASSERT_TRUE(block_verify(p, 0, 16));
+	block_fill(p, 0, 4000);
+
+	p = realloc(p, 32);
+	PCUT_ASSERT_NOT_NULL(p);
+	/* The pattern of the first 32 bytes stays the same. */
+	PCUT_ASSERT_TRUE(block_verify(p, 4000 - 32, 32));
+	free(p);
+
+	PCUT_ASSERT_NULL(heap_check());
+}
+
+/** Heap statistics account for allocated and freed memory */
+PCUT_TEST(stats)
+{
+	heap_stats_t before;
+	heap_stats_t during;
+	heap_stats_t after;
+
+	PCUT_ASSERT_NULL(heap_check_stats(&before));
+	PCUT_ASSERT_TRUE(before.areas > 0);
+	PCUT_ASSERT_TRUE(before.largest_free <= before.free_bytes);
+
+	void *p = malloc(100000);
+	PCUT_ASSERT_NOT_NULL(p);
+
+	PCUT_ASSERT_NULL(heap_check_stats(&during));
+	PCUT_ASSERT_TRUE(during.used_bytes >= before.used_bytes + 100000);
+	PCUT_ASSERT_TRUE(during.used_blocks + during.free_blocks > 0);
+	PCUT_ASSERT_TRUE(during.used_bytes + during.free_bytes <=
+	    during.area_bytes);
+
+	free(p);
+
+	PCUT_ASSERT_NULL(heap_check_stats(&after));
+	PCUT_ASSERT_TRUE(after.used_bytes < during.used_bytes);
+	PCUT_ASSERT_TRUE(after.cached_bytes <= after.used_bytes);
+}
+
+/** Freed blocks are found again after heavy fragmentation */
+PCUT_TEST(fragmentation)
+{
+	void *blocks[BLOCK_COUNT];
+
+	for (size_t i = 0; i < BLOCK_COUNT; i++) {
+		blocks[i] = malloc(1000 + (i % 7) * 300);
+		PCUT_ASSERT_NOT_NULL(blocks[i]);
+	}
+
+	/* Leave holes of various sizes. */
+	for (size_t i = 0; i < BLOCK_COUNT; i += 2) {
+		free(blocks[i]);
+		blocks[i] = NULL;
+	}
+
+	heap_stats_t stats;
+	PCUT_ASSERT_NULL(heap_check_stats(&stats));
+
+	/* The holes are reused rather than extending the heap. */
+	for (size_t i = 0; i < BLOCK_COUNT; i += 2) {
+		blocks[i] = malloc(1000);
+		PCUT_ASSERT_NOT_NULL(blocks[i]);
+	}
+
+	heap_stats_t refilled;
+	PCUT_ASSERT_NULL(heap_check_stats(&refilled));
+	PCUT_ASSERT_TRUE(refilled.area_bytes <= stats.area_bytes);
+
+	for (size_t i = 0; i < BLOCK_COUNT; i++)
+		free(blocks[i]);
+
+	PCUT_ASSERT_NULL(heap_check());
+}
+
+/** Heap is trimmed when its free tail block is a whole number of pages */
+PCUT_TEST(shrink_whole_pages)
+{
+	/*
+	 * Move the large block through all offsets within a page, so that
+	 * at some point the free block at the end of the heap starts on
+	 * a page boundary once the large block is released.
+	 */
+	for (size_t pad = 0; pad < PAGE_SIZE; pad += 16) {
+		void *a = malloc(1024 + pad);
+		PCUT_ASSERT_NOT_NULL(a);
+		void *b = malloc(256 * PAGE_SIZE);
+		PCUT_ASSERT_NOT_NULL(b);
+
+		free(b);
+		PCUT_ASSERT_NULL(heap_check());
+		free(a);
+	}
+
+	PCUT_ASSERT_NULL(heap_check());
+}
+
+typedef struct {
+	size_t seed;
+	fibril_semaphore_t *done;
+	bool ok;
+} churn_thread_t;
+
+static void churn_thread_fn(void *arg)
+{
+	churn_thread_t *thread = arg;
+
+	thread->ok = churn(thread->seed);
+	fibril_semaphore_up(thread->done);
+}
+
+/** Several threads allocate and free at the same time */
+PCUT_TEST(threads)
+{
+	fibril_semaphore_t done;
+	fibril_semaphore_initialize(&done, 0);
+
+	churn_thread_t threads[THREAD_COUNT];
+	size_t started = 0;
+
+	for (; started < THREAD_COUNT; started++) {
+		threads[started].seed = started + 1;
+		threads[started].done = &done;
+		threads[started].ok = false;
+
+		thread_id_t tid;
+		if (thread_create(churn_thread_fn, &threads[started],
+		    "malloc test", &tid) != EOK)
+			break;
+
+		thread_detach(tid);
+	}
+
+	bool ok = churn(0);
+
+	for (size_t i = 0; i < started; i++)
+		fibril_semaphore_down(&done);
+
+	PCUT_ASSERT_TRUE(ok);
+	for (size_t i = 0; i < started; i++)
+		PCUT_ASSERT_TRUE(threads[i].ok);
+
+	PCUT_ASSERT_NULL(heap_check());
+}
+
+PCUT_EXPORT(malloc);
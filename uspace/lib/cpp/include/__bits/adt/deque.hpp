@@ -31,6 +31,7 @@
 
 #include <__bits/insert_iterator.hpp>
 #include <algorithm>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
@@ -366,7 +367,7 @@ namespace std
                 init_();
 
                 for (size_type i = 0; i < size_; ++i)
-                    allocator_.construct(&(*this)[i]);
+                    allocator_traits<allocator_type>::construct(allocator_, &(*this)[i]);
                 back_bucket_idx_ = size_ % bucket_size_;
             }
 
@@ -379,7 +380,7 @@ namespace std
                 init_();
 
                 for (size_type i = 0; i < size_; ++i)
-                    (*this)[i] = value;
+                    allocator_traits<allocator_type>::construct(allocator_, &(*this)[i], value);
                 back_bucket_idx_ = size_ % bucket_size_;
             }
 
@@ -485,9 +486,8 @@ namespace std
                 init_();
                 size_ = n;
 
-                auto it = begin();
                 for (size_type i = size_type{}; i < n; ++i)
-                    *it++ = value;
+                    allocator_traits<allocator_type>::construct(allocator_, &(*this)[i], value);
             }
 
             void assign(initializer_list<T> init)
@@ -720,38 +720,22 @@ namespace std
 
             void push_front(const value_type& value)
             {
-                if (front_bucket_idx_ == 0)
-                    add_new_bucket_front_();
-
-                data_[front_bucket_][--front_bucket_idx_] = value;
-                ++size_;
+                emplace_front(value);
             }
 
             void push_front(value_type&& value)
             {
-                if (front_bucket_idx_ == 0)
-                    add_new_bucket_front_();
-
-                data_[front_bucket_][--front_bucket_idx_] = forward<value_type>(value);
-                ++size_;
+                emplace_front(forward<value_type>(value));
             }
 
             void push_back(const value_type& value)
             {
-                data_[back_bucket_][back_bucket_idx_++] = value;
-                ++size_;
-
-                if (back_bucket_idx_ >= bucket_size_)
-                    add_new_bucket_back_();
+                emplace_back(value);
             }
 
             void push_back(value_type&& value)
             {
-                data_[back_bucket_][back_bucket_idx_++] = forward<value_type>(value);
-                ++size_;
-
-                if (back_bucket_idx_ >= bucket_size_)
-                    add_new_bucket_back_();
+                emplace_back(forward<value_type>(value));
             }
 
             iterator insert(const_iterator position, const value_type& value)
@@ -836,6 +820,7 @@ namespace std
                         allocator_.deallocate(data_[back_bucket_], bucket_size_);
 
                     --back_bucket_;
+                    --bucket_count_;
                     back_bucket_idx_ = bucket_size_ - 1;
                 }
                 else
@@ -856,6 +841,7 @@ namespace std
                         allocator_.deallocate(data_[front_bucket_], bucket_size_);
 
                     ++front_bucket_;
+                    --bucket_count_;
                     front_bucket_idx_ = 1;
 
                     allocator_.destroy(&data_[front_bucket_][0]);
@@ -914,7 +900,8 @@ namespace std
             void swap(deque& other)
                 noexcept(allocator_traits<allocator_type>::is_always_equal::value)
             {
-                std::swap(allocator_, other.allocator_);
+                if constexpr (allocator_traits<allocator_type>::propagate_on_container_swap::value)
+                    std::swap(allocator_, other.allocator_);
                 std::swap(front_bucket_idx_, other.front_bucket_idx_);
                 std::swap(back_bucket_idx_, other.back_bucket_idx_);
                 std::swap(front_bucket_, other.front_bucket_);
@@ -954,7 +941,22 @@ namespace std
             size_type front_bucket_;
             size_type back_bucket_;
 
-            static constexpr size_type bucket_size_{16};
+            /**
+             * Note: Buckets are sized in bytes rather than in elements,
+             *       so that small elements do not need an allocation
+             *       every 16 of them while large ones do not make
+             *       every bucket (and thus every deque) huge.
+             */
+            static constexpr size_type bucket_bytes_{1024};
+            static constexpr size_type min_bucket_size_{4};
+            static constexpr size_type bucket_size_{
+                bucket_bytes_ / sizeof(value_type) > min_bucket_size_ ?
+                bucket_bytes_ / sizeof(value_type) : min_bucket_size_
+            };
+
+            static constexpr bool trivially_relocatable_ =
+                aux::is_trivially_relocatable_v<value_type, allocator_type>;
+
             static constexpr size_type default_bucket_count_{2};
             static constexpr size_type default_bucket_capacity_{4};
             static constexpr size_type default_front_{1};
@@ -991,13 +993,43 @@ namespace std
             template<class Iterator>
             void copy_from_range_(Iterator first, Iterator last)
             {
-                size_ = distance(first, last);
-                prepare_for_size_(size_);
+                auto size = static_cast<size_type>(distance(first, last));
+                prepare_for_size_(size);
                 init_();
+                size_ = size;
 
-                auto it = begin();
-                while (first != last)
-                    *it++ = *first++;
+                /**
+                 * Fill the buckets one at a time instead of going
+                 * through our iterators, which need to find the
+                 * bucket of every element.
+                 */
+                size_type idx{};
+                while (idx < size_)
+                {
+                    auto bucket = data_[get_bucket_index_(idx)];
+                    auto offset = get_element_index_(idx);
+                    auto count = min(bucket_size_ - offset, size_ - idx);
+
+                    if constexpr (trivially_relocatable_ &&
+                                  is_pointer<Iterator>::value &&
+                                  is_same<remove_cv_t<remove_pointer_t<Iterator>>,
+                                          value_type>::value)
+                    {
+                        memcpy(bucket + offset, first, count * sizeof(value_type));
+                        first += count;
+                    }
+                    else
+                    {
+                        for (size_type i = 0; i < count; ++i, ++first)
+                        {
+                            allocator_traits<allocator_type>::construct(
+                                allocator_, bucket + offset + i, *first
+                            );
+                        }
+                    }
+
+                    idx += count;
+                }
             }
 
             void ensure_space_front_(size_type idx, size_type count)
@@ -1063,6 +1095,12 @@ namespace std
 
             void fini_()
             {
+                if constexpr (!is_trivially_destructible<value_type>::value)
+                {
+                    for (size_type i = 0; i < size_; ++i)
+                        allocator_traits<allocator_type>::destroy(allocator_, &(*this)[i]);
+                }
+
                 for (size_type i = front_bucket_; i <= back_bucket_; ++i)
                     allocator_.deallocate(data_[i], bucket_size_);
 
@@ -1104,15 +1142,17 @@ namespace std
 
             void expand_()
             {
-                bucket_capacity_ *= 2;
-                value_type** new_data = new value_type*[bucket_capacity_];
-
                 /**
-                 * Note: This currently expands both sides whenever one reaches
-                 *       its limit. Might be better to expand only one (or both when
-                 *       the other is near its limit)?
+                 * Note: When the deque is used as a queue, buckets are
+                 *       freed at one end and added at the other, so
+                 *       unless the buckets take more than half of the
+                 *       bucket array we only move them to its middle.
                  */
-                size_type new_front = bucket_capacity_ / 4;
+                if (bucket_count_ * 2 > bucket_capacity_)
+                    bucket_capacity_ *= 2;
+                value_type** new_data = new value_type*[bucket_capacity_];
+
+                size_type new_front = (bucket_capacity_ - bucket_count_) / 2;
                 size_type new_back = new_front + bucket_count_ - 1;
 
                 for (size_type i = new_front, j = front_bucket_; i <= new_back; ++i, ++j)
@@ -1215,4 +1255,13 @@ namespace std
     }
 }
 
+namespace std::pmr
+{
+    template<class T>
+    class polymorphic_allocator;
+
+    template<class T>
+    using deque = std::deque<T, polymorphic_allocator<T>>;
+}
+
 #endif
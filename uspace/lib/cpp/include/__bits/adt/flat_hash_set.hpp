@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_ADT_FLAT_HASH_SET
+#define LIBCPP_BITS_ADT_FLAT_HASH_SET
+
+#include <__bits/adt/flat_hash_table.hpp>
+#include <__bits/adt/key_extractors.hpp>
+#include <initializer_list>
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace std::ext
+{
+    /**
+     * Extension: unordered_set stored in an open addressing
+     * table, see flat_hash_map for the differences from
+     * the standard unordered containers.
+     */
+
+    template<
+        class Key,
+        class Hash = hash<Key>,
+        class Pred = equal_to<Key>,
+        class Alloc = allocator<Key>
+    >
+    class flat_hash_set
+    {
+        public:
+            using key_type        = Key;
+            using value_type      = Key;
+            using hasher          = Hash;
+            using key_equal       = Pred;
+            using allocator_type  = Alloc;
+            using pointer         = typename allocator_traits<allocator_type>::pointer;
+            using const_pointer   = typename allocator_traits<allocator_type>::const_pointer;
+            using reference       = value_type&;
+            using const_reference = const value_type&;
+            using size_type       = size_t;
+            using difference_type = ptrdiff_t;
+
+            /**
+             * Note: Elements of a set cannot be modified,
+             *       so both iterators are constant.
+             */
+            using iterator       = aux::flat_hash_table_iterator<
+                value_type, const_reference, const_pointer
+            >;
+            using const_iterator = iterator;
+
+            flat_hash_set()
+                : flat_hash_set(size_type{})
+            { /* DUMMY BODY */ }
+
+            explicit flat_hash_set(size_type bucket_count,
+                                   const hasher& hf = hasher{},
+                                   const key_equal& eql = key_equal{},
+                                   const allocator_type& alloc = allocator_type{})
+                : table_{bucket_count, hf, eql, alloc}
+            { /* DUMMY BODY */ }
+
+            template<class InputIterator>
+            flat_hash_set(InputIterator first, InputIterator last,
+                          size_type bucket_count = size_type{},
+                          const hasher& hf = hasher{},
+                          const key_equal& eql = key_equal{},
+                          const allocator_type& alloc = allocator_type{})
+                : flat_hash_set(bucket_count, hf, eql, alloc)
+            {
+                insert(first, last);
+            }
+
+            flat_hash_set(const flat_hash_set& other)
+                : flat_hash_set{other, other.get_allocator()}
+            { /* DUMMY BODY */ }
+
+            flat_hash_set(flat_hash_set&& other)
+                : table_{move(other.table_)}
+            { /* DUMMY BODY */ }
+
+            explicit flat_hash_set(const allocator_type& alloc)
+                : flat_hash_set(size_type{}, hasher{}, key_equal{}, alloc)
+            { /* DUMMY BODY */ }
+
+            flat_hash_set(const flat_hash_set& other, const allocator_type& alloc)
+                : table_{other.table_, alloc}
+            { /* DUMMY BODY */ }
+
+            flat_hash_set(initializer_list<value_type> init,
+                          size_type bucket_count = size_type{},
+                          const hasher& hf = hasher{},
+                          const key_equal& eql = key_equal{},
+                          const allocator_type& alloc = allocator_type{})
+                : flat_hash_set(bucket_count, hf, eql, alloc)
+            {
+                insert(init.begin(), init.end());
+            }
+
+            flat_hash_set& operator=(const flat_hash_set& other)
+            {
+                table_ = other.table_;
+
+                return *this;
+            }
+
+            flat_hash_set& operator=(flat_hash_set&& other)
+            {
+                table_ = move(other.table_);
+
+                return *this;
+            }
+
+            flat_hash_set& operator=(initializer_list<value_type> init)
+            {
+                table_.clear();
+                insert(init.begin(), init.end());
+
+                return *this;
+            }
+
+            allocator_type get_allocator() const noexcept
+            {
+                return table_.get_allocator();
+            }
+
+            bool empty() const noexcept
+            {
+                return table_.empty();
+            }
+
+            size_type size() const noexcept
+            {
+                return table_.size();
+            }
+
+            size_type max_size() const noexcept
+            {
+                return table_.max_size();
+            }
+
+            iterator begin() const noexcept
+            {
+                return table_.begin();
+            }
+
+            iterator end() const noexcept
+            {
+                return table_.end();
+            }
+
+            const_iterator cbegin() const noexcept
+            {
+                return table_.begin();
+            }
+
+            const_iterator cend() const noexcept
+            {
+                return table_.end();
+            }
+
+            template<class... Args>
+            pair<iterator, bool> emplace(Args&&... args)
+            {
+                auto res = table_.emplace(forward<Args>(args)...);
+
+                return make_pair(iterator{res.first}, res.second);
+            }
+
+            template<class... Args>
+            iterator emplace_hint(const_iterator, Args&&... args)
+            {
+                return emplace(forward<Args>(args)...).first;
+            }
+
+            pair<iterator, bool> insert(const value_type& val)
+            {
+                auto res = table_.emplace_key(val, val);
+
+                return make_pair(iterator{res.first}, res.second);
+            }
+
+            pair<iterator, bool> insert(value_type&& val)
+            {
+                auto res = table_.emplace_key(val, move(val));
+
+                return make_pair(iterator{res.first}, res.second);
+            }
+
+            iterator insert(const_iterator, const value_type& val)
+            {
+                return insert(val).first;
+            }
+
+            iterator insert(const_iterator, value_type&& val)
+            {
+                return insert(move(val)).first;
+            }
+
+            template<class InputIterator>
+            void insert(InputIterator first, InputIterator last)
+            {
+                while (first != last)
+                    insert(*first++);
+            }
+
+            void insert(initializer_list<value_type> init)
+            {
+                insert(init.begin(), init.end());
+            }
+
+            iterator erase(const_iterator position)
+            {
+                return table_.erase(position);
+            }
+
+            size_type erase(const key_type& key)
+            {
+                return table_.erase(key);
+            }
+
+            iterator erase(const_iterator first, const_iterator last)
+            {
+                while (first != last)
+                    first = erase(first);
+
+                return first;
+            }
+
+            void clear() noexcept
+            {
+                table_.clear();
+            }
+
+            void swap(flat_hash_set& other)
+            {
+                table_.swap(other.table_);
+            }
+
+            hasher hash_function() const
+            {
+                return table_.hash_function();
+            }
+
+            key_equal key_eq() const
+            {
+                return table_.key_eq();
+            }
+
+            iterator find(const key_type& key) const
+            {
+                return table_.find(key);
+            }
+
+            size_type count(const key_type& key) const
+            {
+                return table_.count(key);
+            }
+
+            pair<iterator, iterator> equal_range(const key_type& key) const
+            {
+                auto it = find(key);
+                if (it == end())
+                    return make_pair(it, it);
+
+                return make_pair(it, next(it));
+            }
+
+            /**
+             * Note: There are no buckets, the number
+             *       of slots is reported instead.
+             */
+            size_type bucket_count() const noexcept
+            {
+                return table_.capacity();
+            }
+
+            float load_factor() const noexcept
+            {
+                return table_.load_factor();
+            }
+
+            float max_load_factor() const noexcept
+            {
+                return table_.max_load_factor();
+            }
+
+            void max_load_factor(float)
+            {
+                // Fixed for this table, the standard allows us to ignore this.
+            }
+
+            void rehash(size_type bucket_count)
+            {
+                table_.rehash(bucket_count);
+            }
+
+            void reserve(size_type count)
+            {
+                table_.reserve(count);
+            }
+
+        private:
+            using table_type = aux::flat_hash_table<
+                value_type, key_type, aux::key_no_value_key_extractor<key_type>,
+                hasher, key_equal, allocator_type
+            >;
+
+            table_type table_;
+    };
+
+    template<class Key, class Hash, class Pred, class Alloc>
+    void swap(flat_hash_set<Key, Hash, Pred, Alloc>& lhs,
+              flat_hash_set<Key, Hash, Pred, Alloc>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+    template<class Key, class Hash, class Pred, class Alloc>
+    bool operator==(const flat_hash_set<Key, Hash, Pred, Alloc>& lhs,
+                    const flat_hash_set<Key, Hash, Pred, Alloc>& rhs)
+    {
+        if (lhs.size() != rhs.size())
+            return false;
+
+        for (const auto& key: lhs)
+        {
+            if (rhs.count(key) == 0)
+                return false;
+        }
+
+        return true;
+    }
+
+    template<class Key, class Hash, class Pred, class Alloc>
+    bool operator!=(const flat_hash_set<Key, Hash, Pred, Alloc>& lhs,
+                    const flat_hash_set<Key, Hash, Pred, Alloc>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
@@ -0,0 +1,844 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_ADT_FLAT_HASH_TABLE
+#define LIBCPP_BITS_ADT_FLAT_HASH_TABLE
+
+#include <__bits/iterator_helpers.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace std::aux
+{
+    /**
+     * Open addressing hash table in the style of Swiss tables.
+     *
+     * Elements are stored directly in an array of slots, next
+     * to which we keep an array of control bytes, one per slot.
+     * A control byte is either empty, deleted (a tombstone) or
+     * contains the lowest 7 bits of the hash of the element in the
+     * slot (h2), the rest of the hash (h1) selects where probing
+     * starts. Probing works on groups of consecutive control
+     * bytes: a single comparison against h2 yields a bitmask of
+     * candidate slots in the group and only those have their keys
+     * compared. The first group_width control bytes are cloned
+     * after the end of the array, so that a group can be loaded
+     * at any position without wrapping.
+     */
+
+    using flat_ctrl_t = signed char;
+
+    inline constexpr flat_ctrl_t flat_ctrl_empty{-128};
+    inline constexpr flat_ctrl_t flat_ctrl_deleted{-2};
+
+    inline constexpr bool flat_ctrl_full(flat_ctrl_t ctrl) noexcept
+    {
+        return ctrl >= 0;
+    }
+
+    /**
+     * Set of slot offsets within a group, each represented
+     * by 1 << shift bits of the mask.
+     */
+    template<class Mask, int Shift>
+    class flat_bitmask
+    {
+        public:
+            explicit flat_bitmask(Mask mask)
+                : mask_{mask}
+            { /* DUMMY BODY */ }
+
+            explicit operator bool() const noexcept
+            {
+                return mask_ != 0;
+            }
+
+            size_t lowest() const noexcept
+            {
+                if constexpr (sizeof(Mask) <= sizeof(unsigned int))
+                    return static_cast<size_t>(__builtin_ctz(mask_)) >> Shift;
+                else
+                    return static_cast<size_t>(__builtin_ctzll(mask_)) >> Shift;
+            }
+
+            void clear_lowest() noexcept
+            {
+                mask_ &= mask_ - 1;
+            }
+
+        private:
+            Mask mask_;
+    };
+
+#if defined(__SSE2__)
+    /**
+     * Groups of 16 control bytes compared with SSE2
+     * (through the GCC vector extensions so that we
+     * do not depend on the intrinsics headers).
+     */
+    class flat_group
+    {
+        public:
+            static constexpr size_t width{16};
+
+            using bitmask = flat_bitmask<uint32_t, 0>;
+
+            explicit flat_group(const flat_ctrl_t* pos) noexcept
+            {
+                memcpy(&ctrl_, pos, sizeof(ctrl_));
+            }
+
+            bitmask match(flat_ctrl_t h2) const noexcept
+            {
+                return mask_(ctrl_ == splat_(h2));
+            }
+
+            bitmask match_empty() const noexcept
+            {
+                return mask_(ctrl_ == splat_(flat_ctrl_empty));
+            }
+
+            bitmask match_empty_or_deleted() const noexcept
+            {
+                return mask_(ctrl_ < splat_(-1));
+            }
+
+        private:
+            typedef signed char vector_type __attribute__((vector_size(16)));
+            typedef char movemask_type __attribute__((vector_size(16)));
+
+            vector_type ctrl_;
+
+            static vector_type splat_(flat_ctrl_t value) noexcept
+            {
+                return vector_type{} + value;
+            }
+
+            static bitmask mask_(vector_type cmp) noexcept
+            {
+                return bitmask{static_cast<uint32_t>(
+                    __builtin_ia32_pmovmskb128((movemask_type)cmp)
+                )};
+            }
+    };
+#else
+    /**
+     * Portable groups of 8 control bytes compared
+     * as a single 64-bit word, the top bit of each
+     * byte of a mask represents one slot.
+     */
+    class flat_group
+    {
+        public:
+            static constexpr size_t width{8};
+
+            using bitmask = flat_bitmask<uint64_t, 3>;
+
+            explicit flat_group(const flat_ctrl_t* pos) noexcept
+            {
+                memcpy(&ctrl_, pos, sizeof(ctrl_));
+#ifdef __BE__
+                ctrl_ = __builtin_bswap64(ctrl_);
+#endif
+            }
+
+            bitmask match(flat_ctrl_t h2) const noexcept
+            {
+                /**
+                 * Note: This can report a false positive for a byte
+                 *       following a real match, which is fine as
+                 *       every candidate has its key compared anyway.
+                 */
+                auto x = ctrl_ ^ (lsbs_ * static_cast<uint8_t>(h2));
+
+                return bitmask{(x - lsbs_) & ~x & msbs_};
+            }
+
+            bitmask match_empty() const noexcept
+            {
+                return bitmask{(ctrl_ & (~ctrl_ << 6)) & msbs_};
+            }
+
+            bitmask match_empty_or_deleted() const noexcept
+            {
+                return bitmask{(ctrl_ & ~(ctrl_ << 7)) & msbs_};
+            }
+
+        private:
+            uint64_t ctrl_;
+
+            static constexpr uint64_t lsbs_{0x0101010101010101ULL};
+            static constexpr uint64_t msbs_{0x8080808080808080ULL};
+    };
+#endif
+
+    /**
+     * Triangular probing over groups, which visits every
+     * group exactly once when the capacity is a power of two.
+     */
+    class flat_probe_seq
+    {
+        public:
+            flat_probe_seq(size_t hash, size_t mask) noexcept
+                : mask_{mask}, offset_{hash & mask}, index_{}
+            { /* DUMMY BODY */ }
+
+            size_t offset() const noexcept
+            {
+                return offset_;
+            }
+
+            size_t offset(size_t i) const noexcept
+            {
+                return (offset_ + i) & mask_;
+            }
+
+            void next() noexcept
+            {
+                index_ += flat_group::width;
+                offset_ = (offset_ + index_) & mask_;
+            }
+
+        private:
+            size_t mask_;
+            size_t offset_;
+            size_t index_;
+    };
+
+    template<class Value, class Reference, class Pointer>
+    class flat_hash_table_iterator
+    {
+        public:
+            using value_type      = Value;
+            using reference       = Reference;
+            using pointer         = Pointer;
+            using difference_type = ptrdiff_t;
+
+            using iterator_category = forward_iterator_tag;
+
+            flat_hash_table_iterator(const flat_ctrl_t* ctrl = nullptr,
+                                     const flat_ctrl_t* end = nullptr,
+                                     pointer slot = nullptr)
+                : ctrl_{ctrl}, end_{end}, slot_{slot}
+            { /* DUMMY BODY */ }
+
+            template<class R, class P>
+            flat_hash_table_iterator(const flat_hash_table_iterator<Value, R, P>& other)
+                : ctrl_{other.ctrl()}, end_{other.end()}, slot_{other.slot()}
+            { /* DUMMY BODY */ }
+
+            reference operator*() const
+            {
+                return *slot_;
+            }
+
+            pointer operator->() const
+            {
+                return slot_;
+            }
+
+            flat_hash_table_iterator& operator++()
+            {
+                ++ctrl_;
+                ++slot_;
+                skip_free_();
+
+                return *this;
+            }
+
+            flat_hash_table_iterator operator++(int)
+            {
+                auto tmp = *this;
+                ++(*this);
+
+                return tmp;
+            }
+
+            const flat_ctrl_t* ctrl() const noexcept
+            {
+                return ctrl_;
+            }
+
+            const flat_ctrl_t* end() const noexcept
+            {
+                return end_;
+            }
+
+            pointer slot() const noexcept
+            {
+                return slot_;
+            }
+
+            void skip_free_() noexcept
+            {
+                while (ctrl_ != end_ && !flat_ctrl_full(*ctrl_))
+                {
+                    ++ctrl_;
+                    ++slot_;
+                }
+            }
+
+        private:
+            const flat_ctrl_t* ctrl_;
+            const flat_ctrl_t* end_;
+            pointer slot_;
+    };
+
+    template<class Value, class R1, class P1, class R2, class P2>
+    bool operator==(const flat_hash_table_iterator<Value, R1, P1>& lhs,
+                    const flat_hash_table_iterator<Value, R2, P2>& rhs)
+    {
+        return lhs.ctrl() == rhs.ctrl();
+    }
+
+    template<class Value, class R1, class P1, class R2, class P2>
+    bool operator!=(const flat_hash_table_iterator<Value, R1, P1>& lhs,
+                    const flat_hash_table_iterator<Value, R2, P2>& rhs)
+    {
+        return lhs.ctrl() != rhs.ctrl();
+    }
+
+    template<
+        class Value, class Key, class KeyExtractor,
+        class Hasher, class KeyEq, class Alloc
+    >
+    class flat_hash_table
+    {
+        public:
+            using value_type     = Value;
+            using key_type       = Key;
+            using size_type      = size_t;
+            using allocator_type = Alloc;
+            using key_equal      = KeyEq;
+            using hasher         = Hasher;
+            using key_extract    = KeyExtractor;
+
+            using iterator       = flat_hash_table_iterator<
+                value_type, value_type&, value_type*
+            >;
+            using const_iterator = flat_hash_table_iterator<
+                value_type, const value_type&, const value_type*
+            >;
+
+            flat_hash_table(size_type count, const hasher& hf,
+                            const key_equal& eql, const allocator_type& alloc)
+                : ctrl_{}, slots_{}, capacity_{}, size_{}, growth_left_{},
+                  hasher_{hf}, key_eq_{eql}, key_extractor_{},
+                  slot_allocator_{alloc}, ctrl_allocator_{alloc}
+            {
+                if (count > 0)
+                    rehash(count);
+            }
+
+            flat_hash_table(const flat_hash_table& other, const allocator_type& alloc)
+                : flat_hash_table{other.size_, other.hasher_, other.key_eq_, alloc}
+            {
+                for (const auto& val: other)
+                    insert_unique_(val);
+            }
+
+            flat_hash_table(flat_hash_table&& other)
+                : ctrl_{other.ctrl_}, slots_{other.slots_},
+                  capacity_{other.capacity_}, size_{other.size_},
+                  growth_left_{other.growth_left_}, hasher_{move(other.hasher_)},
+                  key_eq_{move(other.key_eq_)}, key_extractor_{},
+                  slot_allocator_{move(other.slot_allocator_)},
+                  ctrl_allocator_{move(other.ctrl_allocator_)}
+            {
+                other.ctrl_ = nullptr;
+                other.slots_ = nullptr;
+                other.capacity_ = size_type{};
+                other.size_ = size_type{};
+                other.growth_left_ = size_type{};
+            }
+
+            flat_hash_table& operator=(const flat_hash_table& other)
+            {
+                if (this != &other)
+                {
+                    flat_hash_table tmp{other, other.get_allocator()};
+                    swap(tmp);
+                }
+
+                return *this;
+            }
+
+            flat_hash_table& operator=(flat_hash_table&& other)
+            {
+                swap(other);
+
+                return *this;
+            }
+
+            ~flat_hash_table()
+            {
+                destroy_slots_();
+                deallocate_(ctrl_, slots_, capacity_);
+            }
+
+            allocator_type get_allocator() const noexcept
+            {
+                return allocator_type{slot_allocator_};
+            }
+
+            bool empty() const noexcept
+            {
+                return size_ == 0;
+            }
+
+            size_type size() const noexcept
+            {
+                return size_;
+            }
+
+            size_type max_size() const noexcept
+            {
+                return allocator_traits<slot_allocator_type>::max_size(slot_allocator_);
+            }
+
+            iterator begin() noexcept
+            {
+                iterator it{ctrl_, ctrl_ + capacity_, slots_};
+                it.skip_free_();
+
+                return it;
+            }
+
+            const_iterator begin() const noexcept
+            {
+                const_iterator it{ctrl_, ctrl_ + capacity_, slots_};
+                it.skip_free_();
+
+                return it;
+            }
+
+            iterator end() noexcept
+            {
+                return iterator{ctrl_ + capacity_, ctrl_ + capacity_, slots_ + capacity_};
+            }
+
+            const_iterator end() const noexcept
+            {
+                return const_iterator{ctrl_ + capacity_, ctrl_ + capacity_, slots_ + capacity_};
+            }
+
+            /**
+             * Returns the element with the given key if there is one,
+             * otherwise claims a slot for it and returns that. In the
+             * latter case, the caller has to construct the element in
+             * the slot (using construct) before using the table again.
+             */
+            template<class K>
+            pair<iterator, bool> find_or_prepare_insert(const K& key)
+            {
+                auto hash = hasher_(key);
+                auto idx = find_(key, hash);
+                if (idx != npos_)
+                    return make_pair(iterator_at_(idx), false);
+
+                return make_pair(iterator_at_(prepare_insert_(hash)), true);
+            }
+
+            template<class... Args>
+            void construct(iterator pos, Args&&... args)
+            {
+                allocator_traits<slot_allocator_type>::construct(
+                    slot_allocator_, pos.slot(), forward<Args>(args)...
+                );
+            }
+
+            /**
+             * Constructs the element in place if no element with
+             * the given key exists, the arguments are only used
+             * in that case.
+             */
+            template<class K, class... Args>
+            pair<iterator, bool> emplace_key(const K& key, Args&&... args)
+            {
+                auto res = find_or_prepare_insert(key);
+                if (res.second)
+                    construct(res.first, forward<Args>(args)...);
+
+                return res;
+            }
+
+            template<class... Args>
+            pair<iterator, bool> emplace(Args&&... args)
+            {
+                /**
+                 * Note: We need the key before we know where
+                 *       (and if) to put the element, so it has
+                 *       to be constructed first.
+                 */
+                value_type val(forward<Args>(args)...);
+
+                return emplace_key(key_extractor_(val), move(val));
+            }
+
+            iterator erase(const_iterator pos)
+            {
+                auto idx = static_cast<size_type>(pos.slot() - slots_);
+                erase_at_(idx);
+
+                auto it = iterator_at_(idx);
+                ++it;
+
+                return it;
+            }
+
+            size_type erase(const key_type& key)
+            {
+                auto idx = find_(key, hasher_(key));
+                if (idx == npos_)
+                    return 0;
+
+                erase_at_(idx);
+
+                return 1;
+            }
+
+            void clear() noexcept
+            {
+                if (capacity_ == 0)
+                    return;
+
+                destroy_slots_();
+                memset(ctrl_, flat_ctrl_empty, capacity_ + flat_group::width);
+                size_ = 0;
+                growth_left_ = capacity_to_growth_(capacity_);
+            }
+
+            void swap(flat_hash_table& other)
+            {
+                std::swap(ctrl_, other.ctrl_);
+                std::swap(slots_, other.slots_);
+                std::swap(capacity_, other.capacity_);
+                std::swap(size_, other.size_);
+                std::swap(growth_left_, other.growth_left_);
+                std::swap(hasher_, other.hasher_);
+                std::swap(key_eq_, other.key_eq_);
+                std::swap(slot_allocator_, other.slot_allocator_);
+                std::swap(ctrl_allocator_, other.ctrl_allocator_);
+            }
+
+            hasher hash_function() const
+            {
+                return hasher_;
+            }
+
+            key_equal key_eq() const
+            {
+                return key_eq_;
+            }
+
+            iterator find(const key_type& key)
+            {
+                auto idx = find_(key, hasher_(key));
+                if (idx == npos_)
+                    return end();
+
+                return iterator_at_(idx);
+            }
+
+            const_iterator find(const key_type& key) const
+            {
+                auto idx = find_(key, hasher_(key));
+                if (idx == npos_)
+                    return end();
+
+                return const_iterator{ctrl_ + idx, ctrl_ + capacity_, slots_ + idx};
+            }
+
+            size_type count(const key_type& key) const
+            {
+                return find_(key, hasher_(key)) != npos_ ? 1 : 0;
+            }
+
+            size_type capacity() const noexcept
+            {
+                return capacity_;
+            }
+
+            float load_factor() const noexcept
+            {
+                if (capacity_ == 0)
+                    return 0.f;
+
+                return size_ / static_cast<float>(capacity_);
+            }
+
+            float max_load_factor() const noexcept
+            {
+                return max_load_factor_;
+            }
+
+            void rehash(size_type count)
+            {
+                /**
+                 * The new capacity has to be a power of two,
+                 * at least one group wide and able to hold
+                 * all current elements.
+                 */
+                auto min_capacity = max(count, growth_to_capacity_(size_));
+                size_type new_capacity{flat_group::width};
+                while (new_capacity < min_capacity)
+                    new_capacity *= 2;
+
+                if (new_capacity != capacity_ || growth_left_ + size_ < capacity_to_growth_(capacity_))
+                    resize_(new_capacity);
+            }
+
+            void reserve(size_type count)
+            {
+                if (count > size_ + growth_left_)
+                    rehash(growth_to_capacity_(count));
+            }
+
+        private:
+            using slot_allocator_type = typename allocator_traits<
+                allocator_type
+            >::template rebind_alloc<value_type>;
+            using ctrl_allocator_type = typename allocator_traits<
+                allocator_type
+            >::template rebind_alloc<flat_ctrl_t>;
+
+            flat_ctrl_t* ctrl_;
+            value_type* slots_;
+            size_type capacity_;
+            size_type size_;
+            size_type growth_left_;
+            hasher hasher_;
+            key_equal key_eq_;
+            key_extract key_extractor_;
+            slot_allocator_type slot_allocator_;
+            ctrl_allocator_type ctrl_allocator_;
+
+            static constexpr size_type npos_{static_cast<size_type>(-1)};
+            static constexpr float max_load_factor_{0.875f};
+
+            static size_type h1_(size_type hash) noexcept
+            {
+                return hash >> 7;
+            }
+
+            static flat_ctrl_t h2_(size_type hash) noexcept
+            {
+                return static_cast<flat_ctrl_t>(hash & 0x7F);
+            }
+
+            static size_type capacity_to_growth_(size_type capacity) noexcept
+            {
+                return capacity - capacity / 8;
+            }
+
+            static size_type growth_to_capacity_(size_type growth) noexcept
+            {
+                return growth + (growth + 6) / 7;
+            }
+
+            iterator iterator_at_(size_type idx) noexcept
+            {
+                return iterator{ctrl_ + idx, ctrl_ + capacity_, slots_ + idx};
+            }
+
+            template<class K>
+            size_type find_(const K& key, size_type hash) const
+            {
+                if (capacity_ == 0)
+                    return npos_;
+
+                auto h2 = h2_(hash);
+                flat_probe_seq seq{h1_(hash), capacity_ - 1};
+                while (true)
+                {
+                    flat_group group{ctrl_ + seq.offset()};
+                    for (auto bits = group.match(h2); bits; bits.clear_lowest())
+                    {
+                        auto idx = seq.offset(bits.lowest());
+                        if (key_eq_(key_extractor_(slots_[idx]), key))
+                            return idx;
+                    }
+
+                    /**
+                     * The insertion would have put the element
+                     * into this group if it had a free slot.
+                     */
+                    if (group.match_empty())
+                        return npos_;
+
+                    seq.next();
+                }
+            }
+
+            size_type find_first_non_full_(size_type hash) const noexcept
+            {
+                flat_probe_seq seq{h1_(hash), capacity_ - 1};
+                while (true)
+                {
+                    flat_group group{ctrl_ + seq.offset()};
+                    auto bits = group.match_empty_or_deleted();
+                    if (bits)
+                        return seq.offset(bits.lowest());
+
+                    seq.next();
+                }
+            }
+
+            void set_ctrl_(size_type idx, flat_ctrl_t ctrl) noexcept
+            {
+                ctrl_[idx] = ctrl;
+                if (idx < flat_group::width)
+                    ctrl_[capacity_ + idx] = ctrl;
+            }
+
+            /**
+             * Claims a slot for a new element with the given
+             * hash (growing the table if needed) and returns
+             * its index, the slot is left unconstructed.
+             */
+            size_type prepare_insert_(size_type hash)
+            {
+                auto idx = capacity_ > 0 ? find_first_non_full_(hash) : npos_;
+                if (growth_left_ == 0 && (idx == npos_ || ctrl_[idx] != flat_ctrl_deleted))
+                {
+                    grow_();
+                    idx = find_first_non_full_(hash);
+                }
+
+                if (ctrl_[idx] == flat_ctrl_empty)
+                    --growth_left_;
+                set_ctrl_(idx, h2_(hash));
+                ++size_;
+
+                return idx;
+            }
+
+            void insert_unique_(const value_type& val)
+            {
+                auto idx = prepare_insert_(hasher_(key_extractor_(val)));
+                allocator_traits<slot_allocator_type>::construct(
+                    slot_allocator_, slots_ + idx, val
+                );
+            }
+
+            void erase_at_(size_type idx)
+            {
+                /**
+                 * Note: The slot becomes a tombstone rather than
+                 *       empty, otherwise lookups of elements that
+                 *       probed past it would stop here. Tombstones
+                 *       are reused by insertions and dropped when
+                 *       the table is rehashed.
+                 */
+                allocator_traits<slot_allocator_type>::destroy(slot_allocator_, slots_ + idx);
+                set_ctrl_(idx, flat_ctrl_deleted);
+                --size_;
+            }
+
+            void grow_()
+            {
+                /**
+                 * If at least half of the used up growth are
+                 * tombstones, rehashing at the same capacity
+                 * is enough to make room.
+                 */
+                if (capacity_ > 0 && size_ <= capacity_to_growth_(capacity_) / 2)
+                    resize_(capacity_);
+                else
+                    resize_(capacity_ > 0 ? capacity_ * 2 : flat_group::width);
+            }
+
+            void resize_(size_type new_capacity)
+            {
+                auto old_ctrl = ctrl_;
+                auto old_slots = slots_;
+                auto old_capacity = capacity_;
+
+                ctrl_ = allocator_traits<ctrl_allocator_type>::allocate(
+                    ctrl_allocator_, new_capacity + flat_group::width
+                );
+                slots_ = allocator_traits<slot_allocator_type>::allocate(
+                    slot_allocator_, new_capacity
+                );
+                capacity_ = new_capacity;
+                growth_left_ = capacity_to_growth_(new_capacity) - size_;
+                memset(ctrl_, flat_ctrl_empty, new_capacity + flat_group::width);
+
+                for (size_type i = 0; i < old_capacity; ++i)
+                {
+                    if (!flat_ctrl_full(old_ctrl[i]))
+                        continue;
+
+                    auto hash = hasher_(key_extractor_(old_slots[i]));
+                    auto idx = find_first_non_full_(hash);
+                    set_ctrl_(idx, h2_(hash));
+
+                    allocator_traits<slot_allocator_type>::construct(
+                        slot_allocator_, slots_ + idx, move(old_slots[i])
+                    );
+                    allocator_traits<slot_allocator_type>::destroy(
+                        slot_allocator_, old_slots + i
+                    );
+                }
+
+                deallocate_(old_ctrl, old_slots, old_capacity);
+            }
+
+            void destroy_slots_() noexcept
+            {
+                for (size_type i = 0; i < capacity_; ++i)
+                {
+                    if (flat_ctrl_full(ctrl_[i]))
+                    {
+                        allocator_traits<slot_allocator_type>::destroy(
+                            slot_allocator_, slots_ + i
+                        );
+                    }
+                }
+            }
+
+            void deallocate_(flat_ctrl_t* ctrl, value_type* slots, size_type capacity)
+            {
+                if (capacity == 0)
+                    return;
+
+                allocator_traits<ctrl_allocator_type>::deallocate(
+                    ctrl_allocator_, ctrl, capacity + flat_group::width
+                );
+                allocator_traits<slot_allocator_type>::deallocate(
+                    slot_allocator_, slots, capacity
+                );
+            }
+    };
+}
+
+#endif
@@ -33,6 +33,7 @@
 #include <__bits/adt/key_extractors.hpp>
 #include <__bits/adt/hash_table_iterators.hpp>
 #include <__bits/adt/hash_table_policies.hpp>
+#include <__bits/adt/node_allocator.hpp>
 #include <cstdlib>
 #include <iterator>
 #include <limits>
@@ -86,22 +87,27 @@ namespace std::aux
                 list_node<value_type>*, size_type
             >;
 
-            hash_table(size_type buckets, float max_load_factor = 1.f)
-                : table_{new hash_table_bucket<value_type, size_type>[buckets]()},
-                  bucket_count_{buckets}, size_{}, hasher_{}, key_eq_{},
-                  key_extractor_{}, max_load_factor_{max_load_factor}
-            { /* DUMMY BODY */ }
-
             hash_table(size_type buckets, const hasher& hf, const key_equal& eql,
+                       const allocator_type& alloc = allocator_type{},
                        float max_load_factor = 1.f)
                 : table_{new hash_table_bucket<value_type, size_type>[buckets]()},
                   bucket_count_{buckets}, size_{}, hasher_{hf}, key_eq_{eql},
-                  key_extractor_{}, max_load_factor_{max_load_factor}
+                  key_extractor_{}, max_load_factor_{max_load_factor},
+                  node_allocator_{alloc}
             { /* DUMMY BODY */ }
 
             hash_table(const hash_table& other)
+                : hash_table{
+                    other,
+                    allocator_traits<allocator_type>::select_on_container_copy_construction(
+                        other.get_allocator()
+                    )
+                  }
+            { /* DUMMY BODY */ }
+
+            hash_table(const hash_table& other, const allocator_type& alloc)
                 : hash_table{other.bucket_count_, other.hasher_, other.key_eq_,
-                             other.max_load_factor_}
+                             alloc, other.max_load_factor_}
             {
                 for (const auto& x: other)
                     insert(x);
@@ -111,7 +117,8 @@ namespace std::aux
                 : table_{other.table_}, bucket_count_{other.bucket_count_},
                   size_{other.size_}, hasher_{move(other.hasher_)},
                   key_eq_{move(other.key_eq_)}, key_extractor_{move(other.key_extractor_)},
-                  max_load_factor_{other.max_load_factor_}
+                  max_load_factor_{other.max_load_factor_},
+                  node_allocator_{other.node_allocator_}
             {
                 other.table_ = nullptr;
                 other.bucket_count_ = size_type{};
@@ -119,22 +126,64 @@ namespace std::aux
                 other.max_load_factor_ = 1.f;
             }
 
+            hash_table(hash_table&& other, const allocator_type& alloc)
+                : hash_table{other.bucket_count_, other.hasher_, other.key_eq_,
+                             alloc, other.max_load_factor_}
+            {
+                if (node_allocator_ == other.node_allocator_)
+                {
+                    std::swap(table_, other.table_);
+                    std::swap(size_, other.size_);
+                }
+                else
+                {
+                    /**
+                     * Nodes cannot change their allocator,
+                     * so we have to move element by element.
+                     */
+                    for (auto& x: other)
+                        insert(move(x));
+                    other.clear();
+                }
+            }
+
             hash_table& operator=(const hash_table& other)
             {
-                hash_table tmp{other};
-                tmp.swap(*this);
+                using propagate = typename allocator_traits<
+                    allocator_type
+                >::propagate_on_container_copy_assignment;
+
+                hash_table tmp{other, propagate::value ? other.get_allocator() : get_allocator()};
+                tmp.swap_(*this, propagate{});
 
                 return *this;
             }
 
             hash_table& operator=(hash_table&& other)
             {
-                hash_table tmp{move(other)};
-                tmp.swap(*this);
+                using propagate = typename allocator_traits<
+                    allocator_type
+                >::propagate_on_container_move_assignment;
+
+                if constexpr (propagate::value)
+                {
+                    hash_table tmp{move(other)};
+                    tmp.swap_(*this, propagate{});
+                }
+                else
+                {
+                    hash_table tmp{move(other), get_allocator()};
+                    tmp.swap_(*this, propagate{});
+                }
 
                 return *this;
             }
 
+            allocator_type get_allocator() const
+            {
+                return node_allocator_.get_allocator();
+            }
+
             bool empty() const noexcept
             {
                 return size_ == 0;
@@ -145,9 +194,9 @@ namespace std::aux
                 return size_;
             }
 
-            size_type max_size(allocator_type& alloc)
+            size_type max_size() const noexcept
             {
-                return allocator_traits<allocator_type>::max_size(alloc);
+                return node_allocator_.max_size();
             }
 
             iterator begin() noexcept
@@ -234,7 +283,7 @@ namespace std::aux
                 --size_;
 
                 node->unlink();
-                delete node;
+                destroy_node(node);
 
                 if (empty())
                     return end();
@@ -244,22 +293,23 @@ namespace std::aux
 
             void clear() noexcept
             {
+                auto destroy = [this](node_type* node) {
+                    destroy_node(node);
+                };
+
                 for (size_type i = 0; i < bucket_count_; ++i)
-                    table_[i].clear();
+                    table_[i].clear(destroy);
                 size_ = size_type{};
             }
 
             void swap(hash_table& other)
                 noexcept(allocator_traits<allocator_type>::is_always_equal::value &&
-                         noexcept(swap(declval<Hasher&>(), declval<Hasher&>())) &&
-                         noexcept(swap(declval<KeyEq&>(), declval<KeyEq&>())))
+                         noexcept(std::swap(declval<Hasher&>(), declval<Hasher&>())) &&
+                         noexcept(std::swap(declval<KeyEq&>(), declval<KeyEq&>())))
             {
-                std::swap(table_, other.table_);
-                std::swap(bucket_count_, other.bucket_count_);
-                std::swap(size_, other.size_);
-                std::swap(hasher_, other.hasher_);
-                std::swap(key_eq_, other.key_eq_);
-                std::swap(max_load_factor_, other.max_load_factor_);
+                swap_(other, typename allocator_traits<
+                    allocator_type
+                >::propagate_on_container_swap{});
             }
 
             hasher hash_function() const
@@ -408,7 +458,10 @@ namespace std::aux
                  *       be thrown and no changes to this have been
                  *       made, we're ok.
                  */
-                hash_table new_table{count, max_load_factor_};
+                hash_table new_table{
+                    count, hasher_, key_eq_,
+                    get_allocator(), max_load_factor_
+                };
 
                 for (std::size_t i = 0; i < bucket_count_; ++i)
                 {
@@ -496,9 +549,11 @@ namespace std::aux
 
             ~hash_table()
             {
-                // Lists are deleted in ~hash_table_bucket.
                 if (table_)
+                {
+                    clear();
                     delete[] table_;
+                }
             }
 
             place_type find_insertion_spot(const key_type& key) const
@@ -557,6 +612,17 @@ namespace std::aux
                 --size_;
             }
 
+            template<class... Args>
+            node_type* create_node(Args&&... args)
+            {
+                return node_allocator_.create(forward<Args>(args)...);
+            }
+
+            void destroy_node(node_type* node)
+            {
+                node_allocator_.destroy(node);
+            }
+
         private:
             hash_table_bucket<value_type, size_type>* table_;
             size_type bucket_count_;
@@ -565,6 +631,19 @@ namespace std::aux
             key_equal key_eq_;
             key_extract key_extractor_;
             float max_load_factor_;
+            node_allocator<node_type, allocator_type> node_allocator_;
+
+            template<class Propagate>
+            void swap_(hash_table& other, Propagate propagate)
+            {
+                std::swap(table_, other.table_);
+                std::swap(bucket_count_, other.bucket_count_);
+                std::swap(size_, other.size_);
+                std::swap(hasher_, other.hasher_);
+                std::swap(key_eq_, other.key_eq_);
+                std::swap(max_load_factor_, other.max_load_factor_);
+                node_allocator_.swap(other.node_allocator_, propagate);
+            }
 
             static constexpr float bucket_count_growth_factor_{1.25};
 
@@ -79,7 +79,14 @@ namespace std::aux
                 head->prepend(node);
         }
 
-        void clear()
+        /**
+         * Note: Buckets do not own their nodes, those are
+         *       allocated and freed by the hash table using
+         *       its allocator, so the bucket only passes
+         *       them to the given callback.
+         */
+        template<class Destroy>
+        void clear(Destroy destroy)
         {
             if (!head)
                 return;
@@ -89,17 +96,12 @@ namespace std::aux
             {
                 auto tmp = current;
                 current = current->next;
-                delete tmp;
+                destroy(tmp);
             }
             while (current && current != head);
 
             head = nullptr;
         }
-
-        ~hash_table_bucket()
-        {
-            clear();
-        }
     };
 }
 
@@ -30,6 +30,7 @@
 #define LIBCPP_BITS_ADT_LIST
 
 #include <__bits/adt/list_node.hpp>
+#include <__bits/adt/node_allocator.hpp>
 #include <__bits/insert_iterator.hpp>
 #include <cassert>
 #include <cstdlib>
@@ -369,21 +370,21 @@ namespace std
             { /* DUMMY BODY */ }
 
             explicit list(const allocator_type& alloc)
-                : allocator_{alloc}, head_{nullptr}, size_{}
+                : node_allocator_{alloc}, head_{nullptr}, size_{}
             { /* DUMMY BODY */ }
 
             explicit list(size_type n, const allocator_type& alloc = allocator_type{})
-                : allocator_{alloc}, head_{nullptr}, size_{}
+                : node_allocator_{alloc}, head_{nullptr}, size_{}
             {
                 init_(
                     aux::insert_iterator<value_type>{size_type{}, value_type{}},
-                    aux::insert_iterator<value_type>{size_, value_type{}}
+                    aux::insert_iterator<value_type>{n, value_type{}}
                 );
             }
 
             list(size_type n, const value_type& val,
                  const allocator_type& alloc = allocator_type{})
-                : allocator_{alloc}, head_{nullptr}, size_{}
+                : node_allocator_{alloc}, head_{nullptr}, size_{}
             {
                 init_(
                     aux::insert_iterator<value_type>{size_type{}, val},
@@ -394,17 +395,22 @@ namespace std
             template<class InputIterator>
             list(InputIterator first, InputIterator last,
                  const allocator_type& alloc = allocator_type{})
-                : allocator_{alloc}, head_{nullptr}, size_{}
+                : node_allocator_{alloc}, head_{nullptr}, size_{}
             {
                 init_(first, last);
             }
 
             list(const list& other)
-                : list{other, other.allocator_}
+                : list{
+                    other,
+                    allocator_traits<allocator_type>::select_on_container_copy_construction(
+                        other.get_allocator()
+                    )
+                  }
             { /* DUMMY BODY */ }
 
             list(list&& other)
-                : allocator_{move(other.allocator_)},
+                : node_allocator_{other.node_allocator_},
                   head_{move(other.head_)},
                   size_{move(other.size_)}
             {
@@ -413,22 +419,33 @@ namespace std
             }
 
             list(const list& other, const allocator_type alloc)
-                : allocator_{alloc}, head_{nullptr}, size_{}
+                : node_allocator_{alloc}, head_{nullptr}, size_{}
             { // Size is set in init_.
                 init_(other.begin(), other.end());
             }
 
             list(list&& other, const allocator_type& alloc)
-                : allocator_{alloc},
-                  head_{move(other.head_)},
-                  size_{move(other.size_)}
+                : node_allocator_{alloc}, head_{nullptr}, size_{}
             {
-                other.head_ = nullptr;
-                other.size_ = size_type{};
+                if (node_allocator_ == other.node_allocator_)
+                {
+                    std::swap(head_, other.head_);
+                    std::swap(size_, other.size_);
+                }
+                else
+                {
+                    /**
+                     * Nodes cannot change their allocator,
+                     * so we have to move element by element.
+                     */
+                    for (auto& x: other)
+                        append_new_(move(x));
+                    other.clear();
+                }
             }
 
             list(initializer_list<value_type> init, const allocator_type& alloc = allocator_type{})
-                : allocator_{alloc}, head_{nullptr}, size_{}
+                : node_allocator_{alloc}, head_{nullptr}, size_{}
             {
                 init_(init.begin(), init.end());
             }
@@ -440,9 +457,12 @@ namespace std
 
             list& operator=(const list& other)
             {
+                using traits = allocator_traits<allocator_type>;
+
                 fini_();
 
-                allocator_ = other.allocator_;
+                if constexpr (traits::propagate_on_container_copy_assignment::value)
+                    node_allocator_ = other.node_allocator_;
 
                 init_(other.begin(), other.end());
 
@@ -452,11 +472,23 @@ namespace std
             list& operator=(list&& other)
                 noexcept(allocator_traits<allocator_type>::is_always_equal::value)
             {
+                using traits = allocator_traits<allocator_type>;
+
                 fini_();
 
+                if constexpr (traits::propagate_on_container_move_assignment::value)
+                    node_allocator_ = other.node_allocator_;
+                else if (node_allocator_ != other.node_allocator_)
+                {
+                    for (auto& x: other)
+                        append_new_(move(x));
+                    other.clear();
+
+                    return *this;
+                }
+
                 head_ = move(other.head_);
                 size_ = move(other.size_);
-                allocator_ = move(other.allocator_);
 
                 other.head_ = nullptr;
                 other.size_ = size_type{};
@@ -500,7 +532,7 @@ namespace std
 
             allocator_type get_allocator() const noexcept
             {
-                return allocator_;
+                return node_allocator_.get_allocator();
             }
 
             iterator begin() noexcept
@@ -574,7 +606,7 @@ namespace std
 
             size_type max_size() const noexcept
             {
-                return allocator_traits<allocator_type>::max_size(allocator_);
+                return node_allocator_.max_size();
             }
 
             void resize(size_type sz)
@@ -636,7 +668,7 @@ namespace std
 
                     if (head_->next == head_)
                     {
-                        delete head_;
+                        node_allocator_.destroy(head_);
                         head_ = nullptr;
                     }
                     else
@@ -646,7 +678,7 @@ namespace std
                         head_->next->prev = head_->prev;
                         head_ = head_->next;
 
-                        delete tmp;
+                        node_allocator_.destroy(tmp);
                     }
                 }
             }
@@ -684,9 +716,9 @@ namespace std
                     --size_;
                     auto target = head_->prev;
 
-                    if (!target)
+                    if (target == head_)
                     {
-                        delete head_;
+                        node_allocator_.destroy(head_);
                         head_ = nullptr;
                     }
                     else
@@ -696,7 +728,7 @@ namespace std
                         target->next->prev = target->prev;
                         target = target->next;
 
-                        delete tmp;
+                        node_allocator_.destroy(tmp);
                     }
                 }
             }
@@ -705,7 +737,7 @@ namespace std
             iterator emplace(const_iterator position, Args&&... args)
             {
                 auto node = position.node();
-                node->prepend(new aux::list_node<value_type>{forward<Args>(args)...});
+                node->prepend(node_allocator_.create(forward<Args>(args)...));
                 ++size_;
 
                 if (node == head_)
@@ -740,7 +772,7 @@ namespace std
 
                 while (first != last)
                 {
-                    node->append(new aux::list_node<value_type>{*first++});
+                    node->append(node_allocator_.create(*first++));
                     node = node->next;
                     ++size_;
                 }
@@ -761,7 +793,7 @@ namespace std
                 {
                     if (size_ == 1)
                     {
-                        delete head_;
+                        node_allocator_.destroy(head_);
                         head_ = nullptr;
                         size_ = 0;
 
@@ -776,7 +808,7 @@ namespace std
                 --size_;
 
                 node->unlink();
-                delete node;
+                node_allocator_.destroy(node);
 
                 return iterator{next, head_, size_ == 0U};
             }
@@ -808,7 +840,7 @@ namespace std
                     first_node = first_node->next;
                     --size_;
 
-                    delete tmp;
+                    node_allocator_.destroy(tmp);
                 }
 
                 return iterator{next, head_, size_ == 0U};
@@ -817,7 +849,10 @@ namespace std
             void swap(list& other)
                 noexcept(allocator_traits<allocator_type>::is_always_equal::value)
             {
-                std::swap(allocator_, other.allocator_);
+                node_allocator_.swap(
+                    other.node_allocator_,
+                    typename allocator_traits<allocator_type>::propagate_on_container_swap{}
+                );
                 std::swap(head_, other.head_);
                 std::swap(size_, other.size_);
             }
@@ -1085,7 +1120,7 @@ namespace std
             }
 
         private:
-            allocator_type allocator_;
+            aux::node_allocator<aux::list_node<value_type>, allocator_type> node_allocator_;
             aux::list_node<value_type>* head_;
             size_type size_;
 
@@ -1093,10 +1128,7 @@ namespace std
             void init_(InputIterator first, InputIterator last)
             {
                 while (first != last)
-                {
-                    auto node = append_new_();
-                    allocator_.construct(&node->value, *first++);
-                }
+                    append_new_(*first++);
             }
 
             void fini_()
@@ -1110,7 +1142,7 @@ namespace std
                     auto tmp = head_;
                     head_ = head_->next;
 
-                    delete tmp;
+                    node_allocator_.destroy(tmp);
                 }
 
                 head_ = nullptr;
@@ -1120,7 +1152,7 @@ namespace std
             template<class... Args>
             aux::list_node<value_type>* append_new_(Args&&... args)
             {
-                auto node = new aux::list_node<value_type>{forward<Args>(args)...};
+                auto node = node_allocator_.create(forward<Args>(args)...);
                 auto last = get_last_();
 
                 if (!last)
@@ -1136,7 +1168,7 @@ namespace std
             template<class... Args>
             aux::list_node<value_type>* prepend_new_(Args&&... args)
             {
-                auto node = new aux::list_node<value_type>{forward<Args>(args)...};
+                auto node = node_allocator_.create(forward<Args>(args)...);
 
                 if (!head_)
                     head_ = node;
@@ -1171,7 +1203,7 @@ namespace std
 
                 while (first != last)
                 {
-                    where->append(new aux::list_node<value_type>{*first++});
+                    where->append(node_allocator_.create(*first++));
                     where = where->next;
                 }
             }
@@ -1200,4 +1232,13 @@ namespace std
     }
 }
 
+namespace std::pmr
+{
+    template<class T>
+    class polymorphic_allocator;
+
+    template<class T>
+    using list = std::list<T, polymorphic_allocator<T>>;
+}
+
 #endif
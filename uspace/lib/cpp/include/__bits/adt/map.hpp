@@ -106,7 +106,7 @@ namespace std
 
             explicit map(const key_compare& comp,
                          const allocator_type& alloc = allocator_type{})
-                : tree_{comp}, allocator_{alloc}
+                : tree_{comp, alloc}
             { /* DUMMY BODY */ }
 
             template<class InputIterator>
@@ -119,23 +119,23 @@ namespace std
             }
 
             map(const map& other)
-                : map{other, other.allocator_}
+                : tree_{other.tree_}
             { /* DUMMY BODY */ }
 
             map(map&& other)
-                : tree_{move(other.tree_)}, allocator_{move(other.allocator_)}
+                : tree_{move(other.tree_)}
             { /* DUMMY BODY */ }
 
             explicit map(const allocator_type& alloc)
-                : tree_{}, allocator_{alloc}
+                : tree_{key_compare{}, alloc}
             { /* DUMMY BODY */ }
 
             map(const map& other, const allocator_type& alloc)
-                : tree_{other.tree_}, allocator_{alloc}
+                : tree_{other.tree_, alloc}
             { /* DUMMY BODY */ }
 
             map(map&& other, const allocator_type& alloc)
-                : tree_{move(other.tree_)}, allocator_{alloc}
+                : tree_{move(other.tree_), alloc}
             { /* DUMMY BODY */ }
 
             map(initializer_list<value_type> init,
@@ -163,7 +163,6 @@ namespace std
             map& operator=(const map& other)
             {
                 tree_ = other.tree_;
-                allocator_ = other.allocator_;
 
                 return *this;
             }
@@ -173,7 +172,6 @@ namespace std
                          is_nothrow_move_assignable<key_compare>::value)
             {
                 tree_ = move(other.tree_);
-                allocator_ = move(other.allocator_);
 
                 return *this;
             }
@@ -189,7 +187,7 @@ namespace std
 
             allocator_type get_allocator() const noexcept
             {
-                return allocator_;
+                return tree_.get_allocator();
             }
 
             iterator begin() noexcept
@@ -264,7 +262,7 @@ namespace std
 
             size_type max_size() const noexcept
             {
-                return tree_.max_size(allocator_);
+                return tree_.max_size();
             }
 
             /**
@@ -277,7 +275,7 @@ namespace std
                 if (parent && tree_.keys_equal(tree_.get_key(parent->value), key))
                     return parent->value.second;
 
-                auto node = new node_type{value_type{key, mapped_type{}}};
+                auto node = tree_.create_node(value_type{key, mapped_type{}});
                 tree_.insert_node(node, parent);
 
                 return node->value.second;
@@ -289,7 +287,7 @@ namespace std
                 if (parent && tree_.keys_equal(tree_.get_key(parent->value), key))
                     return parent->value.second;
 
-                auto node = new node_type{value_type{move(key), mapped_type{}}};
+                auto node = tree_.create_node(value_type{move(key), mapped_type{}});
                 tree_.insert_node(node, parent);
 
                 return node->value.second;
@@ -386,7 +384,7 @@ namespace std
                     return make_pair(iterator{parent, false}, false);
                 else
                 {
-                    auto node = new node_type{value_type{key, forward<Args>(args)...}};
+                    auto node = tree_.create_node(value_type{key, forward<Args>(args)...});
                     tree_.insert_node(node, parent);
 
                     return make_pair(iterator{node, false}, true);
@@ -401,7 +399,7 @@ namespace std
                     return make_pair(iterator{parent, false}, false);
                 else
                 {
-                    auto node = new node_type{value_type{move(key), forward<Args>(args)...}};
+                    auto node = tree_.create_node(value_type{move(key), forward<Args>(args)...});
                     tree_.insert_node(node, parent);
 
                     return make_pair(iterator{node, false}, true);
@@ -432,7 +430,7 @@ namespace std
                 }
                 else
                 {
-                    auto node = new node_type{value_type{key, forward<T>(val)}};
+                    auto node = tree_.create_node(value_type{key, forward<T>(val)});
                     tree_.insert_node(node, parent);
 
                     return make_pair(iterator{node, false}, true);
@@ -451,7 +449,7 @@ namespace std
                 }
                 else
                 {
-                    auto node = new node_type{value_type{move(key), forward<T>(val)}};
+                    auto node = tree_.create_node(value_type{move(key), forward<T>(val)});
                     tree_.insert_node(node, parent);
 
                     return make_pair(iterator{node, false}, true);
@@ -495,7 +493,6 @@ namespace std
                          noexcept(std::swap(declval<key_compare>(), declval<key_compare>())))
             {
                 tree_.swap(other.tree_);
-                std::swap(allocator_, other.allocator_);
             }
 
             void clear() noexcept
@@ -648,7 +645,6 @@ namespace std
             >;
 
             tree_type tree_;
-            allocator_type allocator_;
 
             template<class K, class C, class A>
             friend bool operator==(const map<K, C, A>&,
@@ -765,7 +761,7 @@ namespace std
 
             explicit multimap(const key_compare& comp,
                               const allocator_type& alloc = allocator_type{})
-                : tree_{comp}, allocator_{alloc}
+                : tree_{comp, alloc}
             { /* DUMMY BODY */ }
 
             template<class InputIterator>
@@ -778,23 +774,23 @@ namespace std
             }
 
             multimap(const multimap& other)
-                : multimap{other, other.allocator_}
+                : tree_{other.tree_}
             { /* DUMMY BODY */ }
 
             multimap(multimap&& other)
-                : tree_{move(other.tree_)}, allocator_{move(other.allocator_)}
+                : tree_{move(other.tree_)}
             { /* DUMMY BODY */ }
 
             explicit multimap(const allocator_type& alloc)
-                : tree_{}, allocator_{alloc}
+                : tree_{key_compare{}, alloc}
             { /* DUMMY BODY */ }
 
             multimap(const multimap& other, const allocator_type& alloc)
-                : tree_{other.tree_}, allocator_{alloc}
+                : tree_{other.tree_, alloc}
             { /* DUMMY BODY */ }
 
             multimap(multimap&& other, const allocator_type& alloc)
-                : tree_{move(other.tree_)}, allocator_{alloc}
+                : tree_{move(other.tree_), alloc}
             { /* DUMMY BODY */ }
 
             multimap(initializer_list<value_type> init,
@@ -822,7 +818,6 @@ namespace std
             multimap& operator=(const multimap& other)
             {
                 tree_ = other.tree_;
-                allocator_ = other.allocator_;
 
                 return *this;
             }
@@ -832,7 +827,6 @@ namespace std
                          is_nothrow_move_assignable<key_compare>::value)
             {
                 tree_ = move(other.tree_);
-                allocator_ = move(other.allocator_);
 
                 return *this;
             }
@@ -848,7 +842,7 @@ namespace std
 
             allocator_type get_allocator() const noexcept
             {
-                return allocator_;
+                return tree_.get_allocator();
             }
 
             iterator begin() noexcept
@@ -923,7 +917,7 @@ namespace std
 
             size_type max_size() const noexcept
             {
-                return tree_.max_size(allocator_);
+                return tree_.max_size();
             }
 
             template<class... Args>
@@ -1014,7 +1008,6 @@ namespace std
                          noexcept(std::swap(declval<key_compare>(), declval<key_compare>())))
             {
                 tree_.swap(other.tree_);
-                std::swap(allocator_, other.allocator_);
             }
 
             void clear() noexcept
@@ -1167,7 +1160,6 @@ namespace std
             >;
 
             tree_type tree_;
-            allocator_type allocator_;
 
             template<class K, class C, class A>
             friend bool operator==(const multimap<K, C, A>&,
@@ -1221,4 +1213,20 @@ namespace std
     }
 }
 
+namespace std::pmr
+{
+    template<class T>
+    class polymorphic_allocator;
+
+    template<class Key, class T, class Compare = less<Key>>
+    using map = std::map<
+        Key, T, Compare, polymorphic_allocator<pair<const Key, T>>
+    >;
+
+    template<class Key, class T, class Compare = less<Key>>
+    using multimap = std::multimap<
+        Key, T, Compare, polymorphic_allocator<pair<const Key, T>>
+    >;
+}
+
 #endif
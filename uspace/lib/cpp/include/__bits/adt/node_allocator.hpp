@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_ADT_NODE_ALLOCATOR
+#define LIBCPP_BITS_ADT_NODE_ALLOCATOR
+
+#include <__bits/memory/allocator_traits.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace std::aux
+{
+    /**
+     * Node based containers (list, the rbtree behind map and set,
+     * the hash table behind unordered_map and unordered_set) never
+     * allocate value_type alone, they allocate whole nodes. This
+     * wrapper rebinds the container's allocator to the node type
+     * and is the only place the containers get node memory from.
+     * Note: The node is constructed with placement new rather than
+     *       through allocator_traits::construct, the allocator only
+     *       ever sees raw storage for a single node.
+     */
+    template<class Node, class Alloc>
+    class node_allocator
+    {
+        public:
+            using allocator_type      = Alloc;
+            using node_allocator_type = typename allocator_traits<
+                allocator_type
+            >::template rebind_alloc<Node>;
+            using node_traits         = allocator_traits<node_allocator_type>;
+            using size_type           = typename node_traits::size_type;
+            using propagate_on_swap   = typename node_traits::propagate_on_container_swap;
+
+            explicit node_allocator(const allocator_type& alloc = allocator_type{})
+                : alloc_{alloc}
+            { /* DUMMY BODY */ }
+
+            template<class... Args>
+            Node* create(Args&&... args)
+            {
+                auto ptr = node_traits::allocate(alloc_, 1);
+
+                return ::new(static_cast<void*>(ptr)) Node{forward<Args>(args)...};
+            }
+
+            void destroy(Node* node)
+            {
+                if (!node)
+                    return;
+
+                node->~Node();
+                node_traits::deallocate(alloc_, node, 1);
+            }
+
+            allocator_type get_allocator() const
+            {
+                return allocator_type{alloc_};
+            }
+
+            size_type max_size() const noexcept
+            {
+                return node_traits::max_size(alloc_);
+            }
+
+            bool operator==(const node_allocator& other) const
+            {
+                return alloc_ == other.alloc_;
+            }
+
+            bool operator!=(const node_allocator& other) const
+            {
+                return !(*this == other);
+            }
+
+            /**
+             * Containers exchange allocators on swap only if
+             * propagate_on_container_swap is set, otherwise the
+             * allocators are required to be equal and stay put.
+             */
+            void swap(node_allocator& other, true_type)
+            {
+                std::swap(alloc_, other.alloc_);
+            }
+
+            void swap(node_allocator&, false_type)
+            { /* DUMMY BODY */ }
+
+        private:
+            node_allocator_type alloc_;
+    };
+}
+
+#endif
@@ -30,6 +30,7 @@
 #define LIBCPP_BITS_ADT_RBTREE
 
 #include <__bits/adt/key_extractors.hpp>
+#include <__bits/adt/node_allocator.hpp>
 #include <__bits/adt/rbtree_iterators.hpp>
 #include <__bits/adt/rbtree_node.hpp>
 #include <__bits/adt/rbtree_policies.hpp>
@@ -60,13 +61,23 @@ namespace std::aux
 
             using node_type = Node;
 
-            rbtree(const key_compare& kcmp = key_compare{})
-                : root_{nullptr}, size_{}, key_compare_{},
-                  key_extractor_{}
+            rbtree(const key_compare& kcmp = key_compare{},
+                   const allocator_type& alloc = allocator_type{})
+                : root_{nullptr}, size_{}, key_compare_{kcmp},
+                  key_extractor_{}, node_allocator_{alloc}
             { /* DUMMY BODY */ }
 
             rbtree(const rbtree& other)
-                : rbtree{other.key_compare_}
+                : rbtree{
+                    other,
+                    allocator_traits<allocator_type>::select_on_container_copy_construction(
+                        other.get_allocator()
+                    )
+                  }
+            { /* DUMMY BODY */ }
+
+            rbtree(const rbtree& other, const allocator_type& alloc)
+                : rbtree{other.key_compare_, alloc}
             {
                 for (const auto& x: other)
                     insert(x);
@@ -75,28 +86,75 @@ namespace std::aux
             rbtree(rbtree&& other)
                 : root_{other.root_}, size_{other.size_},
                   key_compare_{move(other.key_compare_)},
-                  key_extractor_{move(other.key_extractor_)}
+                  key_extractor_{move(other.key_extractor_)},
+                  node_allocator_{other.node_allocator_}
             {
                 other.root_ = nullptr;
                 other.size_ = size_type{};
             }
 
+            rbtree(rbtree&& other, const allocator_type& alloc)
+                : rbtree{other.key_compare_, alloc}
+            {
+                if (node_allocator_ == other.node_allocator_)
+                {
+                    std::swap(root_, other.root_);
+                    std::swap(size_, other.size_);
+                }
+                else
+                {
+                    /**
+                     * Nodes cannot change their allocator,
+                     * so we have to move element by element.
+                     */
+                    for (auto& x: other)
+                        insert(move(x));
+                    other.clear();
+                }
+            }
+
             rbtree& operator=(const rbtree& other)
             {
-                auto tmp{other};
-                tmp.swap(*this);
+                using propagate = typename allocator_traits<
+                    allocator_type
+                >::propagate_on_container_copy_assignment;
+
+                rbtree tmp{other, propagate::value ? other.get_allocator() : get_allocator()};
+                tmp.swap_(*this, propagate{});
 
                 return *this;
             }
 
             rbtree& operator=(rbtree&& other)
             {
-                rbtree tmp{move(other)};
-                tmp.swap(*this);
+                using propagate = typename allocator_traits<
+                    allocator_type
+                >::propagate_on_container_move_assignment;
+
+                if constexpr (propagate::value)
+                {
+                    rbtree tmp{move(other)};
+                    tmp.swap_(*this, propagate{});
+                }
+                else
+                {
+                    rbtree tmp{move(other), get_allocator()};
+                    tmp.swap_(*this, propagate{});
+                }
 
                 return *this;
             }
 
+            ~rbtree()
+            {
+                clear();
+            }
+
+            allocator_type get_allocator() const
+            {
+                return node_allocator_.get_allocator();
+            }
+
             bool empty() const noexcept
             {
                 return size_ == 0U;
@@ -107,9 +165,9 @@ namespace std::aux
                 return size_;
             }
 
-            size_type max_size(allocator_type& alloc)
+            size_type max_size() const noexcept
             {
-                return allocator_traits<allocator_type>::max_size(alloc);
+                return node_allocator_.max_size();
             }
 
             iterator begin()
@@ -224,7 +282,7 @@ namespace std::aux
             {
                 if (root_)
                 {
-                    delete root_;
+                    destroy_subtree_(root_);
                     root_ = nullptr;
                     size_ = size_type{};
                 }
@@ -232,12 +290,11 @@ namespace std::aux
 
             void swap(rbtree& other)
                 noexcept(allocator_traits<allocator_type>::is_always_equal::value &&
-                         noexcept(swap(declval<KeyComp&>(), declval<KeyComp&>())))
+                         noexcept(std::swap(declval<KeyComp&>(), declval<KeyComp&>())))
             {
-                std::swap(root_, other.root_);
-                std::swap(size_, other.size_);
-                std::swap(key_compare_, other.key_compare_);
-                std::swap(key_extractor_, other.key_extractor_);
+                swap_(other, typename allocator_traits<
+                    allocator_type
+                >::propagate_on_container_swap{});
             }
 
             key_compare key_comp() const
@@ -365,15 +422,15 @@ namespace std::aux
                      * and return the successor which was the next
                      * in the list.
                      */
-                    delete tmp;
+                    destroy_node(tmp);
 
                     update_root_(succ); // Incase the first in list was root.
                     return succ;
                 }
-                else if (node == root_)
-                { // Only executed if root_ is unique.
+                else if (node == root_ && !node->left() && !node->right())
+                { // Only executed if root_ is unique and has no children.
                     root_ = nullptr;
-                    delete node;
+                    destroy_node(node);
 
                     return nullptr;
                 }
@@ -388,7 +445,13 @@ namespace std::aux
                     // Also: If succ was nullptr, the swap
                     //       didn't do anything and we can
                     //       safely delete node.
-                    return delete_node(node);
+                    // Note: The recursive call decrements
+                    //       the size again and would return
+                    //       the successor of succ.
+                    ++size_;
+                    delete_node(node);
+
+                    return succ;
                 }
 
                 auto child = node->right() ? node->right() : node->left();
@@ -397,7 +460,7 @@ namespace std::aux
                     // Simply remove the node.
                     // TODO: repair here too?
                     node->unlink();
-                    delete node;
+                    destroy_node(node);
                 }
                 else
                 {
@@ -415,7 +478,7 @@ namespace std::aux
                     repair_after_erase_(node, child);
                     update_root_(child);
 
-                    delete node;
+                    destroy_node(node);
                 }
 
                 return succ;
@@ -426,11 +489,73 @@ namespace std::aux
                 Policy::insert(*this, node, parent);
             }
 
+            template<class... Args>
+            node_type* create_node(Args&&... args)
+            {
+                return node_allocator_.create(forward<Args>(args)...);
+            }
+
+            void destroy_node(node_type* node)
+            {
+                node_allocator_.destroy(node);
+            }
+
         private:
             node_type* root_;
             size_type size_;
             key_compare key_compare_;
             key_extract key_extractor_;
+            node_allocator<node_type, allocator_type> node_allocator_;
+
+            template<class Propagate>
+            void swap_(rbtree& other, Propagate propagate)
+            {
+                std::swap(root_, other.root_);
+                std::swap(size_, other.size_);
+                std::swap(key_compare_, other.key_compare_);
+                std::swap(key_extractor_, other.key_extractor_);
+                node_allocator_.swap(other.node_allocator_, propagate);
+            }
+
+            void destroy_subtree_(node_type* node)
+            {
+                /**
+                 * Note: The tree is not rebalanced yet, so its
+                 *       height can be linear in size and we cannot
+                 *       afford recursion here. Instead, we descend
+                 *       to a leaf, detach it from its parent and
+                 *       continue from the parent.
+                 */
+                while (node)
+                {
+                    if (node->left())
+                        node = node->left();
+                    else if (node->right())
+                        node = node->right();
+                    else
+                    {
+                        auto parent = node->parent();
+                        if (parent && parent->left() == node)
+                            parent->left(nullptr);
+                        else if (parent)
+                            parent->right(nullptr);
+
+                        /**
+                         * Nodes with equivalent keys in multi
+                         * containers form a list that starts
+                         * with the node linked in the tree.
+                         */
+                        while (node)
+                        {
+                            auto next = node->list_next();
+                            destroy_node(node);
+                            node = next;
+                        }
+
+                        node = parent;
+                    }
+                }
+            }
 
             node_type* find_(const key_type& key) const
             {
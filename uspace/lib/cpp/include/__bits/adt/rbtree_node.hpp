@@ -222,6 +222,25 @@ namespace std::aux
             auto right2 = node2->right();
             auto is_right2 = is_right_child(node2);
 
+            /**
+             * If one of the nodes is a child of the other,
+             * the links between them have to be reversed,
+             * otherwise a node would end up linked to itself.
+             */
+            if (parent2 == node1)
+                parent2 = node2;
+            if (left2 == node1)
+                left2 = node2;
+            if (right2 == node1)
+                right2 = node2;
+
+            if (parent1 == node2)
+                parent1 = node1;
+            if (left1 == node2)
+                left1 = node1;
+            if (right1 == node2)
+                right1 = node1;
+
             assimilate(node1, parent2, left2, right2, is_right2);
             assimilate(node2, parent1, left1, right1, is_right1);
         }
@@ -410,13 +429,9 @@ namespace std::aux
                 return this;
             }
 
-            ~rbtree_single_node()
+            rbtree_single_node* list_next() const
             {
-                parent_ = nullptr;
-                if (left_)
-                    delete left_;
-                if (right_)
-                    delete right_;
+                return nullptr;
             }
 
         private:
@@ -646,8 +661,8 @@ namespace std::aux
                     }
 
                     /**
-                     * Otherwise destructor could
-                     * destroy them.
+                     * Detach this node completely, it
+                     * no longer belongs to the tree.
                      */
                     parent_ = nullptr;
                     left_ = nullptr;
@@ -704,15 +719,9 @@ namespace std::aux
                 }
             }
 
-            ~rbtree_multi_node()
+            rbtree_multi_node* list_next() const
             {
-                parent_ = nullptr;
-                if (left_)
-                    delete left_;
-                if (right_)
-                    delete right_;
-
-                // TODO: delete the list
+                return next_;
             }
 
         private:
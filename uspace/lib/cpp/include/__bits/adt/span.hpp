@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_ADT_SPAN
+#define LIBCPP_BITS_ADT_SPAN
+
+#include <__bits/adt/array.hpp>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace std
+{
+    /**
+     * Note: std::span is a C++20 addition, it is provided
+     *       because it allows functions to take contiguous
+     *       ranges of elements (C arrays, std::array, vector,
+     *       memory mapped buffers...) without copying them and
+     *       without templating on the container type.
+     *       The byte views (as_bytes, as_writable_bytes) are
+     *       missing as we do not have std::byte.
+     */
+
+    inline constexpr size_t dynamic_extent = size_t(-1);
+
+    template<class T, size_t Extent = dynamic_extent>
+    class span;
+
+    namespace aux
+    {
+        /**
+         * Spans with static extent do not need to store
+         * their size.
+         */
+        template<size_t Extent>
+        struct span_extent
+        {
+            constexpr span_extent(size_t) noexcept
+            { /* DUMMY BODY */ }
+
+            constexpr size_t size() const noexcept
+            {
+                return Extent;
+            }
+        };
+
+        template<>
+        struct span_extent<dynamic_extent>
+        {
+            constexpr span_extent(size_t size) noexcept
+                : size_{size}
+            { /* DUMMY BODY */ }
+
+            constexpr size_t size() const noexcept
+            {
+                return size_;
+            }
+
+            size_t size_;
+        };
+
+        /**
+         * Note: Our is_convertible accepts any pointer
+         *       conversion, so we only allow adding const
+         *       to the element type explicitly.
+         */
+        template<class From, class To>
+        inline constexpr bool span_compatible_v =
+            is_same_v<From, To> || is_same_v<const From, To>;
+
+        template<class T>
+        struct is_span: false_type
+        { /* DUMMY BODY */ };
+
+        template<class T, size_t Extent>
+        struct is_span<span<T, Extent>>: true_type
+        { /* DUMMY BODY */ };
+
+        template<class T>
+        struct is_std_array: false_type
+        { /* DUMMY BODY */ };
+
+        template<class T, size_t N>
+        struct is_std_array<array<T, N>>: true_type
+        { /* DUMMY BODY */ };
+
+        template<class Container, class T, class = void>
+        struct is_span_container: false_type
+        { /* DUMMY BODY */ };
+
+        template<class Container, class T>
+        struct is_span_container<
+            Container, T,
+            void_t<
+                decltype(declval<Container&>().data()),
+                decltype(declval<Container&>().size())
+            >
+        >: integral_constant<
+            bool,
+            !is_span<remove_cv_t<Container>>::value &&
+            !is_std_array<remove_cv_t<Container>>::value &&
+            !is_array_v<Container> &&
+            span_compatible_v<
+                remove_pointer_t<decltype(declval<Container&>().data())>, T
+            >
+        >
+        { /* DUMMY BODY */ };
+    }
+
+    template<class T, size_t Extent>
+    class span: private aux::span_extent<Extent>
+    {
+        using extent_type_ = aux::span_extent<Extent>;
+
+        public:
+            using element_type           = T;
+            using value_type             = remove_cv_t<T>;
+            using size_type              = size_t;
+            using difference_type        = ptrdiff_t;
+            using pointer                = T*;
+            using const_pointer          = const T*;
+            using reference              = T&;
+            using const_reference        = const T&;
+            using iterator               = pointer;
+            using reverse_iterator       = std::reverse_iterator<iterator>;
+
+            static constexpr size_type extent = Extent;
+
+            template<
+                size_t E = Extent,
+                class = enable_if_t<E == 0 || E == dynamic_extent>
+            >
+            constexpr span() noexcept
+                : extent_type_{0}, data_{nullptr}
+            { /* DUMMY BODY */ }
+
+            constexpr span(pointer ptr, size_type count)
+                : extent_type_{count}, data_{ptr}
+            { /* DUMMY BODY */ }
+
+            constexpr span(pointer first, pointer last)
+                : extent_type_{static_cast<size_type>(last - first)}, data_{first}
+            { /* DUMMY BODY */ }
+
+            template<
+                size_t N,
+                class = enable_if_t<Extent == dynamic_extent || Extent == N>
+            >
+            constexpr span(element_type (&arr)[N]) noexcept
+                : extent_type_{N}, data_{arr}
+            { /* DUMMY BODY */ }
+
+            template<
+                class U, size_t N,
+                class = enable_if_t<
+                    (Extent == dynamic_extent || Extent == N) &&
+                    aux::span_compatible_v<U, T>
+                >
+            >
+            constexpr span(array<U, N>& arr) noexcept
+                : extent_type_{N}, data_{arr.data()}
+            { /* DUMMY BODY */ }
+
+            template<
+                class U, size_t N,
+                class = enable_if_t<
+                    (Extent == dynamic_extent || Extent == N) &&
+                    aux::span_compatible_v<const U, T>
+                >
+            >
+            constexpr span(const array<U, N>& arr) noexcept
+                : extent_type_{N}, data_{arr.data()}
+            { /* DUMMY BODY */ }
+
+            template<
+                class Container,
+                class = enable_if_t<
+                    Extent == dynamic_extent &&
+                    aux::is_span_container<Container, T>::value
+                >
+            >
+            constexpr span(Container& cont)
+                : extent_type_{static_cast<size_type>(cont.size())}, data_{cont.data()}
+            { /* DUMMY BODY */ }
+
+            template<
+                class Container,
+                class = enable_if_t<
+                    Extent == dynamic_extent &&
+                    aux::is_span_container<const Container, T>::value
+                >
+            >
+            constexpr span(const Container& cont)
+                : extent_type_{static_cast<size_type>(cont.size())}, data_{cont.data()}
+            { /* DUMMY BODY */ }
+
+            template<
+                class U, size_t N,
+                class = enable_if_t<
+                    (Extent == dynamic_extent || Extent == N) &&
+                    aux::span_compatible_v<U, T>
+                >
+            >
+            constexpr span(const span<U, N>& other) noexcept
+                : extent_type_{other.size()}, data_{other.data()}
+            { /* DUMMY BODY */ }
+
+            constexpr span(const span&) noexcept = default;
+
+            constexpr span& operator=(const span&) noexcept = default;
+
+            /**
+             * Subviews:
+             */
+
+            template<size_t Count>
+            constexpr span<element_type, Count> first() const
+            {
+                return span<element_type, Count>{data_, Count};
+            }
+
+            template<size_t Count>
+            constexpr span<element_type, Count> last() const
+            {
+                return span<element_type, Count>{data_ + size() - Count, Count};
+            }
+
+            template<size_t Offset, size_t Count = dynamic_extent>
+            constexpr auto subspan() const
+            {
+                if constexpr (Count != dynamic_extent)
+                    return span<element_type, Count>{data_ + Offset, Count};
+                else if constexpr (Extent != dynamic_extent)
+                    return span<element_type, Extent - Offset>{data_ + Offset, Extent - Offset};
+                else
+                    return span<element_type>{data_ + Offset, size() - Offset};
+            }
+
+            constexpr span<element_type> first(size_type count) const
+            {
+                return span<element_type>{data_, count};
+            }
+
+            constexpr span<element_type> last(size_type count) const
+            {
+                return span<element_type>{data_ + size() - count, count};
+            }
+
+            constexpr span<element_type> subspan(size_type offset,
+                                                 size_type count = dynamic_extent) const
+            {
+                if (count == dynamic_extent)
+                    count = size() - offset;
+
+                return span<element_type>{data_ + offset, count};
+            }
+
+            /**
+             * Observers:
+             */
+
+            constexpr size_type size() const noexcept
+            {
+                return extent_type_::size();
+            }
+
+            constexpr size_type size_bytes() const noexcept
+            {
+                return size() * sizeof(element_type);
+            }
+
+            constexpr bool empty() const noexcept
+            {
+                return size() == 0;
+            }
+
+            /**
+             * Element access:
+             */
+
+            constexpr reference operator[](size_type idx) const
+            {
+                return data_[idx];
+            }
+
+            constexpr reference front() const
+            {
+                return data_[0];
+            }
+
+            constexpr reference back() const
+            {
+                return data_[size() - 1];
+            }
+
+            constexpr pointer data() const noexcept
+            {
+                return data_;
+            }
+
+            /**
+             * Iterator support:
+             */
+
+            constexpr iterator begin() const noexcept
+            {
+                return data_;
+            }
+
+            constexpr iterator end() const noexcept
+            {
+                return data_ + size();
+            }
+
+            reverse_iterator rbegin() const noexcept
+            {
+                return reverse_iterator{end()};
+            }
+
+            reverse_iterator rend() const noexcept
+            {
+                return reverse_iterator{begin()};
+            }
+
+        private:
+            pointer data_;
+    };
+}
+
+#endif
@@ -85,7 +85,7 @@ namespace std
                                    const hasher& hf = hasher{},
                                    const key_equal& eql = key_equal{},
                                    const allocator_type& alloc = allocator_type{})
-                : table_{bucket_count, hf, eql}, allocator_{alloc}
+                : table_{bucket_count, hf, eql, alloc}
             { /* DUMMY BODY */ }
 
             template<class InputIterator>
@@ -100,23 +100,23 @@ namespace std
             }
 
             unordered_map(const unordered_map& other)
-                : unordered_map{other, other.allocator_}
+                : table_{other.table_}
             { /* DUMMY BODY */ }
 
             unordered_map(unordered_map&& other)
-                : table_{move(other.table_)}, allocator_{move(other.allocator_)}
+                : table_{move(other.table_)}
             { /* DUMMY BODY */ }
 
             explicit unordered_map(const allocator_type& alloc)
-                : table_{default_bucket_count_}, allocator_{alloc}
+                : table_{default_bucket_count_, hasher{}, key_equal{}, alloc}
             { /* DUMMY BODY */ }
 
             unordered_map(const unordered_map& other, const allocator_type& alloc)
-                : table_{other.table_}, allocator_{alloc}
+                : table_{other.table_, alloc}
             { /* DUMMY BODY */ }
 
             unordered_map(unordered_map&& other, const allocator_type& alloc)
-                : table_{move(other.table_)}, allocator_{alloc}
+                : table_{move(other.table_), alloc}
             { /* DUMMY BODY */ }
 
             unordered_map(initializer_list<value_type> init,
@@ -165,7 +165,6 @@ namespace std
             unordered_map& operator=(const unordered_map& other)
             {
                 table_ = other.table_;
-                allocator_ = other.allocator_;
 
                 return *this;
             }
@@ -176,7 +175,6 @@ namespace std
                          is_nothrow_move_assignable<key_equal>::value)
             {
                 table_ = move(other.table_);
-                allocator_ = move(other.allocator_);
 
                 return *this;
             }
@@ -193,7 +191,7 @@ namespace std
 
             allocator_type get_allocator() const noexcept
             {
-                return allocator_;
+                return table_.get_allocator();
             }
 
             bool empty() const noexcept
@@ -208,7 +206,7 @@ namespace std
 
             size_type max_size() const noexcept
             {
-                return table_.max_size(allocator_);
+                return table_.max_size();
             }
 
             iterator begin() noexcept
@@ -335,7 +333,7 @@ namespace std
                 }
                 else
                 {
-                    auto node = new node_type{key, forward<Args>(args)...};
+                    auto node = table_.create_node(key, forward<Args>(args)...);
                     bucket->append(node);
 
                     return make_pair(iterator{
@@ -370,7 +368,7 @@ namespace std
                 }
                 else
                 {
-                    auto node = new node_type{move(key), forward<Args>(args)...};
+                    auto node = table_.create_node(move(key), forward<Args>(args)...);
                     bucket->append(node);
 
                     return make_pair(iterator{
@@ -418,7 +416,7 @@ namespace std
                 }
                 else
                 {
-                    auto node = new node_type{key, forward<T>(val)};
+                    auto node = table_.create_node(key, forward<T>(val));
                     bucket->append(node);
 
                     return make_pair(iterator{
@@ -454,7 +452,7 @@ namespace std
                 }
                 else
                 {
-                    auto node = new node_type{move(key), forward<T>(val)};
+                    auto node = table_.create_node(move(key), forward<T>(val));
                     bucket->append(node);
 
                     return make_pair(iterator{
@@ -509,7 +507,6 @@ namespace std
                          noexcept(std::swap(declval<key_equal>(), declval<key_equal>())))
             {
                 table_.swap(other.table_);
-                std::swap(allocator_, other.allocator_);
             }
 
             hasher hash_function() const
@@ -567,7 +564,7 @@ namespace std
                     while (current != head);
                 }
 
-                auto node = new node_type{key, mapped_type{}};
+                auto node = table_.create_node(key, mapped_type{});
                 bucket->append(node);
 
                 table_.increment_size();
@@ -595,7 +592,7 @@ namespace std
                     while (current != head);
                 }
 
-                auto node = new node_type{move(key), mapped_type{}};
+                auto node = table_.create_node(move(key), mapped_type{});
                 bucket->append(node);
 
                 table_.increment_size();
@@ -704,7 +701,6 @@ namespace std
             using node_type = typename table_type::node_type;
 
             table_type table_;
-            allocator_type allocator_;
 
             static constexpr size_type default_bucket_count_{16};
 
@@ -760,7 +756,7 @@ namespace std
                                         const hasher& hf = hasher{},
                                         const key_equal& eql = key_equal{},
                                         const allocator_type& alloc = allocator_type{})
-                : table_{bucket_count, hf, eql}, allocator_{alloc}
+                : table_{bucket_count, hf, eql, alloc}
             { /* DUMMY BODY */ }
 
             template<class InputIterator>
@@ -775,23 +771,23 @@ namespace std
             }
 
             unordered_multimap(const unordered_multimap& other)
-                : unordered_multimap{other, other.allocator_}
+                : table_{other.table_}
             { /* DUMMY BODY */ }
 
             unordered_multimap(unordered_multimap&& other)
-                : table_{move(other.table_)}, allocator_{move(other.allocator_)}
+                : table_{move(other.table_)}
             { /* DUMMY BODY */ }
 
             explicit unordered_multimap(const allocator_type& alloc)
-                : table_{default_bucket_count_}, allocator_{alloc}
+                : table_{default_bucket_count_, hasher{}, key_equal{}, alloc}
             { /* DUMMY BODY */ }
 
             unordered_multimap(const unordered_multimap& other, const allocator_type& alloc)
-                : table_{other.table_}, allocator_{alloc}
+                : table_{other.table_, alloc}
             { /* DUMMY BODY */ }
 
             unordered_multimap(unordered_multimap&& other, const allocator_type& alloc)
-                : table_{move(other.table_)}, allocator_{alloc}
+                : table_{move(other.table_), alloc}
             { /* DUMMY BODY */ }
 
             unordered_multimap(initializer_list<value_type> init,
@@ -842,7 +838,6 @@ namespace std
             unordered_multimap& operator=(const unordered_multimap& other)
             {
                 table_ = other.table_;
-                allocator_ = other.allocator_;
 
                 return *this;
             }
@@ -853,7 +848,6 @@ namespace std
                          is_nothrow_move_assignable<key_equal>::value)
             {
                 table_ = move(other.table_);
-                allocator_ = move(other.allocator_);
 
                 return *this;
             }
@@ -870,7 +864,7 @@ namespace std
 
             allocator_type get_allocator() const noexcept
             {
-                return allocator_;
+                return table_.get_allocator();
             }
 
             bool empty() const noexcept
@@ -885,7 +879,7 @@ namespace std
 
             size_type max_size() const noexcept
             {
-                return table_.max_size(allocator_);
+                return table_.max_size();
             }
 
             iterator begin() noexcept
@@ -1013,7 +1007,6 @@ namespace std
                          noexcept(std::swap(declval<key_equal>(), declval<key_equal>())))
             {
                 table_.swap(other.table_);
-                std::swap(allocator_, other.allocator_);
             }
 
             hasher hash_function() const
@@ -1135,7 +1128,6 @@ namespace std
             >;
 
             table_type table_;
-            allocator_type allocator_;
 
             static constexpr size_type default_bucket_count_{16};
 
@@ -1190,4 +1182,28 @@ namespace std
     }
 }
 
+namespace std::pmr
+{
+    template<class T>
+    class polymorphic_allocator;
+
+    template<
+        class Key, class T,
+        class Hash = hash<Key>,
+        class Pred = equal_to<Key>
+    >
+    using unordered_map = std::unordered_map<
+        Key, T, Hash, Pred, polymorphic_allocator<pair<const Key, T>>
+    >;
+
+    template<
+        class Key, class T,
+        class Hash = hash<Key>,
+        class Pred = equal_to<Key>
+    >
+    using unordered_multimap = std::unordered_multimap<
+        Key, T, Hash, Pred, polymorphic_allocator<pair<const Key, T>>
+    >;
+}
+
 #endif
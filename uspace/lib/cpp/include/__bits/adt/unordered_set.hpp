@@ -90,7 +90,7 @@ namespace std
                                    const hasher& hf = hasher{},
                                    const key_equal& eql = key_equal{},
                                    const allocator_type& alloc = allocator_type{})
-                : table_{bucket_count, hf, eql}, allocator_{alloc}
+                : table_{bucket_count, hf, eql, alloc}
             { /* DUMMY BODY */ }
 
             template<class InputIterator>
@@ -105,23 +105,23 @@ namespace std
             }
 
             unordered_set(const unordered_set& other)
-                : unordered_set{other, other.allocator_}
+                : table_{other.table_}
             { /* DUMMY BODY */ }
 
             unordered_set(unordered_set&& other)
-                : table_{move(other.table_)}, allocator_{move(other.allocator_)}
+                : table_{move(other.table_)}
             { /* DUMMY BODY */ }
 
             explicit unordered_set(const allocator_type& alloc)
-                : table_{default_bucket_count_}, allocator_{alloc}
+                : table_{default_bucket_count_, hasher{}, key_equal{}, alloc}
             { /* DUMMY BODY */ }
 
             unordered_set(const unordered_set& other, const allocator_type& alloc)
-                : table_{other.table_}, allocator_{alloc}
+                : table_{other.table_, alloc}
             { /* DUMMY BODY */ }
 
             unordered_set(unordered_set&& other, const allocator_type& alloc)
-                : table_{move(other.table_)}, allocator_{alloc}
+                : table_{move(other.table_), alloc}
             { /* DUMMY BODY */ }
 
             unordered_set(initializer_list<value_type> init,
@@ -170,7 +170,6 @@ namespace std
             unordered_set& operator=(const unordered_set& other)
             {
                 table_ = other.table_;
-                allocator_ = other.allocator_;
 
                 return *this;
             }
@@ -181,7 +180,6 @@ namespace std
                          is_nothrow_move_assignable<key_equal>::value)
             {
                 table_ = move(other.table_);
-                allocator_ = move(other.allocator_);
 
                 return *this;
             }
@@ -198,7 +196,7 @@ namespace std
 
             allocator_type get_allocator() const noexcept
             {
-                return allocator_;
+                return table_.get_allocator();
             }
 
             bool empty() const noexcept
@@ -213,7 +211,7 @@ namespace std
 
             size_type max_size() const noexcept
             {
-                return table_.max_size(allocator_);
+                return table_.max_size();
             }
 
             iterator begin() noexcept
@@ -322,7 +320,6 @@ namespace std
                          noexcept(std::swap(declval<key_equal>(), declval<key_equal>())))
             {
                 table_.swap(other.table_);
-                std::swap(allocator_, other.allocator_);
             }
 
             hasher hash_function() const
@@ -444,7 +441,6 @@ namespace std
             >;
 
             table_type table_;
-            allocator_type allocator_;
 
             static constexpr size_type default_bucket_count_{16};
 
@@ -506,7 +502,7 @@ namespace std
                                         const hasher& hf = hasher{},
                                         const key_equal& eql = key_equal{},
                                         const allocator_type& alloc = allocator_type{})
-                : table_{bucket_count, hf, eql}, allocator_{alloc}
+                : table_{bucket_count, hf, eql, alloc}
             { /* DUMMY BODY */ }
 
             template<class InputIterator>
@@ -521,23 +517,23 @@ namespace std
             }
 
             unordered_multiset(const unordered_multiset& other)
-                : unordered_multiset{other, other.allocator_}
+                : table_{other.table_}
             { /* DUMMY BODY */ }
 
             unordered_multiset(unordered_multiset&& other)
-                : table_{move(other.table_)}, allocator_{move(other.allocator_)}
+                : table_{move(other.table_)}
             { /* DUMMY BODY */ }
 
             explicit unordered_multiset(const allocator_type& alloc)
-                : table_{default_bucket_count_}, allocator_{alloc}
+                : table_{default_bucket_count_, hasher{}, key_equal{}, alloc}
             { /* DUMMY BODY */ }
 
             unordered_multiset(const unordered_multiset& other, const allocator_type& alloc)
-                : table_{other.table_}, allocator_{alloc}
+                : table_{other.table_, alloc}
             { /* DUMMY BODY */ }
 
             unordered_multiset(unordered_multiset&& other, const allocator_type& alloc)
-                : table_{move(other.table_)}, allocator_{alloc}
+                : table_{move(other.table_), alloc}
             { /* DUMMY BODY */ }
 
             unordered_multiset(initializer_list<value_type> init,
@@ -586,7 +582,6 @@ namespace std
             unordered_multiset& operator=(const unordered_multiset& other)
             {
                 table_ = other.table_;
-                allocator_ = other.allocator_;
 
                 return *this;
             }
@@ -597,7 +592,6 @@ namespace std
                          is_nothrow_move_assignable<key_equal>::value)
             {
                 table_ = move(other.table_);
-                allocator_ = move(other.allocator_);
 
                 return *this;
             }
@@ -614,7 +608,7 @@ namespace std
 
             allocator_type get_allocator() const noexcept
             {
-                return allocator_;
+                return table_.get_allocator();
             }
 
             bool empty() const noexcept
@@ -629,7 +623,7 @@ namespace std
 
             size_type max_size() const noexcept
             {
-                return table_.max_size(allocator_);
+                return table_.max_size();
             }
 
             iterator begin() noexcept
@@ -738,7 +732,6 @@ namespace std
                          noexcept(std::swap(declval<key_equal>(), declval<key_equal>())))
             {
                 table_.swap(other.table_);
-                std::swap(allocator_, other.allocator_);
             }
 
             hasher hash_function() const
@@ -860,7 +853,6 @@ namespace std
             >;
 
             table_type table_;
-            allocator_type allocator_;
 
             static constexpr size_type default_bucket_count_{16};
 
@@ -914,4 +906,28 @@ namespace std
     }
 }
 
+namespace std::pmr
+{
+    template<class T>
+    class polymorphic_allocator;
+
+    template<
+        class Key,
+        class Hash = hash<Key>,
+        class Pred = equal_to<Key>
+    >
+    using unordered_set = std::unordered_set<
+        Key, Hash, Pred, polymorphic_allocator<Key>
+    >;
+
+    template<
+        class Key,
+        class Hash = hash<Key>,
+        class Pred = equal_to<Key>
+    >
+    using unordered_multiset = std::unordered_multiset<
+        Key, Hash, Pred, polymorphic_allocator<Key>
+    >;
+}
+
 #endif
@@ -29,6 +29,1309 @@
 #ifndef LIBCPP_BITS_ADT_VALARRAY
 #define LIBCPP_BITS_ADT_VALARRAY
 
-#error "<valarray> is not implemented"
+#include <__bits/adt/valarray_expr.hpp>
+#include <__bits/functional/arithmetic_operations.hpp>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace std
+{
+    template<class T>
+    class slice_array;
+
+    class gslice;
+
+    template<class T>
+    class gslice_array;
+
+    template<class T>
+    class mask_array;
+
+    template<class T>
+    class indirect_array;
+
+    /**
+     * 26.6.4, class slice:
+     */
+
+    class slice
+    {
+        public:
+            slice()
+                : start_{}, size_{}, stride_{}
+            { /* DUMMY BODY */ }
+
+            slice(size_t start, size_t size, size_t stride)
+                : start_{start}, size_{size}, stride_{stride}
+            { /* DUMMY BODY */ }
+
+            slice(const slice&) = default;
+
+            slice& operator=(const slice&) = default;
+
+            size_t start() const
+            {
+                return start_;
+            }
+
+            size_t size() const
+            {
+                return size_;
+            }
+
+            size_t stride() const
+            {
+                return stride_;
+            }
+
+        private:
+            size_t start_;
+            size_t size_;
+            size_t stride_;
+    };
+
+    namespace aux
+    {
+        template<class T, class Indexer>
+        class valarray_view;
+    }
+
+    /**
+     * 26.6.2, class template valarray:
+     */
+
+    template<class T>
+    class valarray
+    {
+        public:
+            using value_type = T;
+
+            /**
+             * 26.6.2.2, construct/destroy:
+             */
+
+            valarray()
+                : data_{nullptr}, size_{}
+            { /* DUMMY BODY */ }
+
+            explicit valarray(size_t n)
+                : data_{nullptr}, size_{}
+            {
+                allocate_(n);
+                for (size_t i = 0; i < size_; ++i)
+                    allocator_traits<allocator<T>>::construct(allocator_, data_ + i);
+            }
+
+            valarray(const value_type& val, size_t n)
+                : data_{nullptr}, size_{}
+            {
+                init_(aux::valarray_scalar<T>{val}, n);
+            }
+
+            valarray(const value_type* ptr, size_t n)
+                : data_{nullptr}, size_{}
+            {
+                init_(aux::valarray_ref<T>{ptr, n}, n);
+            }
+
+            valarray(const valarray& other)
+                : data_{nullptr}, size_{}
+            {
+                init_(aux::valarray_node<T>(other), other.size_);
+            }
+
+            valarray(valarray&& other) noexcept
+                : data_{other.data_}, size_{other.size_}
+            {
+                other.data_ = nullptr;
+                other.size_ = 0;
+            }
+
+            valarray(const slice_array<value_type>& arr)
+                : data_{nullptr}, size_{}
+            {
+                init_(arr, arr.size_());
+            }
+
+            valarray(const gslice_array<value_type>& arr)
+                : data_{nullptr}, size_{}
+            {
+                init_(arr, arr.size_());
+            }
+
+            valarray(const mask_array<value_type>& arr)
+                : data_{nullptr}, size_{}
+            {
+                init_(arr, arr.size_());
+            }
+
+            valarray(const indirect_array<value_type>& arr)
+                : data_{nullptr}, size_{}
+            {
+                init_(arr, arr.size_());
+            }
+
+            valarray(initializer_list<value_type> init)
+                : data_{nullptr}, size_{}
+            {
+                init_(aux::valarray_ref<T>{init.begin(), init.size()}, init.size());
+            }
+
+            /**
+             * Evaluates an expression, this is where the
+             * elementwise operations are computed.
+             */
+            template<class Expr, class = enable_if_t<is_same_v<typename Expr::value_type, T>>>
+            valarray(const aux::valarray_expr<Expr>& expr)
+                : data_{nullptr}, size_{}
+            {
+                init_(expr.expr(), expr.size());
+            }
+
+            ~valarray()
+            {
+                destroy_();
+            }
+
+            /**
+             * 26.6.2.3, assignment:
+             */
+
+            valarray& operator=(const valarray& other)
+            {
+                if (this != &other)
+                    assign_(aux::valarray_node<T>(other), other.size_);
+
+                return *this;
+            }
+
+            valarray& operator=(valarray&& other) noexcept
+            {
+                swap(other);
+
+                return *this;
+            }
+
+            valarray& operator=(initializer_list<value_type> init)
+            {
+                assign_(aux::valarray_ref<T>{init.begin(), init.size()}, init.size());
+
+                return *this;
+            }
+
+            valarray& operator=(const value_type& val)
+            {
+                assign_(aux::valarray_scalar<T>{val}, size_);
+
+                return *this;
+            }
+
+            valarray& operator=(const slice_array<value_type>& arr)
+            {
+                assign_(arr, arr.size_());
+
+                return *this;
+            }
+
+            valarray& operator=(const gslice_array<value_type>& arr)
+            {
+                assign_(arr, arr.size_());
+
+                return *this;
+            }
+
+            valarray& operator=(const mask_array<value_type>& arr)
+            {
+                assign_(arr, arr.size_());
+
+                return *this;
+            }
+
+            valarray& operator=(const indirect_array<value_type>& arr)
+            {
+                assign_(arr, arr.size_());
+
+                return *this;
+            }
+
+            template<class Expr, class = enable_if_t<is_same_v<typename Expr::value_type, T>>>
+            valarray& operator=(const aux::valarray_expr<Expr>& expr)
+            {
+                assign_(expr.expr(), expr.size());
+
+                return *this;
+            }
+
+            /**
+             * 26.6.2.4, element access:
+             */
+
+            const value_type& operator[](size_t idx) const
+            {
+                return data_[idx];
+            }
+
+            value_type& operator[](size_t idx)
+            {
+                return data_[idx];
+            }
+
+            /**
+             * 26.6.2.5, subset operations:
+             */
+
+            valarray operator[](slice s) const
+            {
+                return valarray(slice_array<T>{data_, s});
+            }
+
+            slice_array<value_type> operator[](slice s)
+            {
+                return slice_array<T>{data_, s};
+            }
+
+            valarray operator[](const gslice& s) const
+            {
+                return valarray(gslice_array<T>{data_, s});
+            }
+
+            gslice_array<value_type> operator[](const gslice& s)
+            {
+                return gslice_array<T>{data_, s};
+            }
+
+            valarray operator[](const valarray<bool>& mask) const
+            {
+                return valarray(mask_array<T>{data_, mask});
+            }
+
+            mask_array<value_type> operator[](const valarray<bool>& mask)
+            {
+                return mask_array<T>{data_, mask};
+            }
+
+            valarray operator[](const valarray<size_t>& indices) const
+            {
+                return valarray(indirect_array<T>{data_, indices});
+            }
+
+            indirect_array<value_type> operator[](const valarray<size_t>& indices)
+            {
+                return indirect_array<T>{data_, indices};
+            }
+
+            /**
+             * 26.6.2.6, unary operators:
+             * Note: Like the binary operators, these return
+             *       an expression that is evaluated when it
+             *       is assigned to a valarray.
+             */
+
+            auto operator+() const
+            {
+                return aux::valarray_unary<T, aux::valarray_unary_plus>(*this);
+            }
+
+            auto operator-() const
+            {
+                return aux::valarray_unary<T, negate<>>(*this);
+            }
+
+            auto operator~() const
+            {
+                return aux::valarray_unary<T, bit_not<>>(*this);
+            }
+
+            auto operator!() const
+            {
+                return aux::valarray_unary<bool, logical_not<>>(*this);
+            }
+
+            /**
+             * 26.6.2.7, compound assignment:
+             */
+
+            valarray& operator*=(const value_type& val)
+            {
+                return compute_(aux::valarray_scalar<T>{val}, multiplies<>{});
+            }
+
+            valarray& operator/=(const value_type& val)
+            {
+                return compute_(aux::valarray_scalar<T>{val}, divides<>{});
+            }
+
+            valarray& operator%=(const value_type& val)
+            {
+                return compute_(aux::valarray_scalar<T>{val}, modulus<>{});
+            }
+
+            valarray& operator+=(const value_type& val)
+            {
+                return compute_(aux::valarray_scalar<T>{val}, plus<>{});
+            }
+
+            valarray& operator-=(const value_type& val)
+            {
+                return compute_(aux::valarray_scalar<T>{val}, minus<>{});
+            }
+
+            valarray& operator^=(const value_type& val)
+            {
+                return compute_(aux::valarray_scalar<T>{val}, bit_xor<>{});
+            }
+
+            valarray& operator&=(const value_type& val)
+            {
+                return compute_(aux::valarray_scalar<T>{val}, bit_and<>{});
+            }
+
+            valarray& operator|=(const value_type& val)
+            {
+                return compute_(aux::valarray_scalar<T>{val}, bit_or<>{});
+            }
+
+            valarray& operator<<=(const value_type& val)
+            {
+                return compute_(aux::valarray_scalar<T>{val}, aux::valarray_shift_left{});
+            }
+
+            valarray& operator>>=(const value_type& val)
+            {
+                return compute_(aux::valarray_scalar<T>{val}, aux::valarray_shift_right{});
+            }
+
+            template<class Arr>
+            enable_if_t<aux::is_valarray_operand_v<Arr>, valarray&>
+            operator*=(const Arr& arr)
+            {
+                return compute_(aux::valarray_node<T>(arr), multiplies<>{});
+            }
+
+            template<class Arr>
+            enable_if_t<aux::is_valarray_operand_v<Arr>, valarray&>
+            operator/=(const Arr& arr)
+            {
+                return compute_(aux::valarray_node<T>(arr), divides<>{});
+            }
+
+            template<class Arr>
+            enable_if_t<aux::is_valarray_operand_v<Arr>, valarray&>
+            operator%=(const Arr& arr)
+            {
+                return compute_(aux::valarray_node<T>(arr), modulus<>{});
+            }
+
+            template<class Arr>
+            enable_if_t<aux::is_valarray_operand_v<Arr>, valarray&>
+            operator+=(const Arr& arr)
+            {
+                return compute_(aux::valarray_node<T>(arr), plus<>{});
+            }
+
+            template<class Arr>
+            enable_if_t<aux::is_valarray_operand_v<Arr>, valarray&>
+            operator-=(const Arr& arr)
+            {
+                return compute_(aux::valarray_node<T>(arr), minus<>{});
+            }
+
+            template<class Arr>
+            enable_if_t<aux::is_valarray_operand_v<Arr>, valarray&>
+            operator^=(const Arr& arr)
+            {
+                return compute_(aux::valarray_node<T>(arr), bit_xor<>{});
+            }
+
+            template<class Arr>
+            enable_if_t<aux::is_valarray_operand_v<Arr>, valarray&>
+            operator&=(const Arr& arr)
+            {
+                return compute_(aux::valarray_node<T>(arr), bit_and<>{});
+            }
+
+            template<class Arr>
+            enable_if_t<aux::is_valarray_operand_v<Arr>, valarray&>
+            operator|=(const Arr& arr)
+            {
+                return compute_(aux::valarray_node<T>(arr), bit_or<>{});
+            }
+
+            template<class Arr>
+            enable_if_t<aux::is_valarray_operand_v<Arr>, valarray&>
+            operator<<=(const Arr& arr)
+            {
+                return compute_(aux::valarray_node<T>(arr), aux::valarray_shift_left{});
+            }
+
+            template<class Arr>
+            enable_if_t<aux::is_valarray_operand_v<Arr>, valarray&>
+            operator>>=(const Arr& arr)
+            {
+                return compute_(aux::valarray_node<T>(arr), aux::valarray_shift_right{});
+            }
+
+            /**
+             * 26.6.2.8, member functions:
+             */
+
+            void swap(valarray& other) noexcept
+            {
+                std::swap(data_, other.data_);
+                std::swap(size_, other.size_);
+            }
+
+            size_t size() const
+            {
+                return size_;
+            }
+
+            value_type sum() const
+            {
+                return aux::valarray_sum<T>(aux::valarray_ref<T>{data_, size_}, size_);
+            }
+
+            value_type min() const
+            {
+                return aux::valarray_extreme<T>(
+                    aux::valarray_ref<T>{data_, size_}, size_, less<>{}
+                );
+            }
+
+            value_type max() const
+            {
+                return aux::valarray_extreme<T>(
+                    aux::valarray_ref<T>{data_, size_}, size_, greater<>{}
+                );
+            }
+
+            valarray shift(int n) const
+            {
+                valarray res(size_);
+
+                auto sz = static_cast<ptrdiff_t>(size_);
+                for (ptrdiff_t i = 0; i < sz; ++i)
+                {
+                    auto src = i + n;
+                    if (0 <= src && src < sz)
+                        res.data_[i] = data_[src];
+                }
+
+                return res;
+            }
+
+            valarray cshift(int n) const
+            {
+                valarray res(size_);
+                if (size_ == 0)
+                    return res;
+
+                auto sz = static_cast<ptrdiff_t>(size_);
+                auto offset = n % sz;
+                if (offset < 0)
+                    offset += sz;
+
+                for (ptrdiff_t i = 0; i < sz; ++i)
+                    res.data_[i] = data_[(i + offset) % sz];
+
+                return res;
+            }
+
+            valarray apply(value_type func(value_type)) const
+            {
+                valarray res(size_);
+                for (size_t i = 0; i < size_; ++i)
+                    res.data_[i] = func(data_[i]);
+
+                return res;
+            }
+
+            valarray apply(value_type func(const value_type&)) const
+            {
+                valarray res(size_);
+                for (size_t i = 0; i < size_; ++i)
+                    res.data_[i] = func(data_[i]);
+
+                return res;
+            }
+
+            void resize(size_t n, value_type val = value_type())
+            {
+                destroy_();
+                init_(aux::valarray_scalar<T>{val}, n);
+            }
+
+        private:
+            value_type* data_;
+            size_t size_;
+            allocator<value_type> allocator_;
+
+            void allocate_(size_t n)
+            {
+                data_ = n ? allocator_.allocate(n) : nullptr;
+                size_ = n;
+            }
+
+            void destroy_()
+            {
+                if (!data_)
+                    return;
+
+                for (size_t i = 0; i < size_; ++i)
+                    allocator_traits<allocator<T>>::destroy(allocator_, data_ + i);
+                allocator_.deallocate(data_, size_);
+
+                data_ = nullptr;
+                size_ = 0;
+            }
+
+            template<class Src>
+            void init_(const Src& src, size_t n)
+            {
+                allocate_(n);
+                for (size_t i = 0; i < n; ++i)
+                    allocator_traits<allocator<T>>::construct(allocator_, data_ + i, src[i]);
+            }
+
+            /**
+             * Note: The source may refer to our own elements,
+             *       which is fine as long as it is evaluated
+             *       in place, when the size changes it is
+             *       evaluated into new storage first.
+             */
+            template<class Src>
+            void assign_(const Src& src, size_t n)
+            {
+                if (n != size_)
+                {
+                    valarray tmp{};
+                    tmp.init_(src, n);
+                    swap(tmp);
+
+                    return;
+                }
+
+                auto data = data_;
+                for (size_t i = 0; i < n; ++i)
+                    data[i] = src[i];
+            }
+
+            template<class Src, class Op>
+            valarray& compute_(const Src& src, Op op)
+            {
+                auto data = data_;
+                for (size_t i = 0; i < size_; ++i)
+                    data[i] = static_cast<value_type>(op(data[i], src[i]));
+
+                return *this;
+            }
+
+            template<class, class>
+            friend class aux::valarray_view;
+    };
+
+    /**
+     * 26.6.6, class gslice:
+     */
+
+    class gslice
+    {
+        public:
+            gslice()
+                : start_{}, sizes_{}, strides_{}
+            { /* DUMMY BODY */ }
+
+            gslice(size_t start, const valarray<size_t>& sizes,
+                   const valarray<size_t>& strides)
+                : start_{start}, sizes_{sizes}, strides_{strides}
+            { /* DUMMY BODY */ }
+
+            gslice(const gslice&) = default;
+
+            gslice& operator=(const gslice&) = default;
+
+            size_t start() const
+            {
+                return start_;
+            }
+
+            valarray<size_t> size() const
+            {
+                return sizes_;
+            }
+
+            valarray<size_t> stride() const
+            {
+                return strides_;
+            }
+
+        private:
+            size_t start_;
+            valarray<size_t> sizes_;
+            valarray<size_t> strides_;
+    };
+
+    namespace aux
+    {
+        struct slice_indexer
+        {
+            size_t start;
+            size_t count;
+            size_t stride;
+
+            size_t size() const noexcept
+            {
+                return count;
+            }
+
+            size_t operator()(size_t idx) const noexcept
+            {
+                return start + idx * stride;
+            }
+        };
+
+        struct index_indexer
+        {
+            valarray<size_t> indices;
+
+            size_t size() const noexcept
+            {
+                return indices.size();
+            }
+
+            size_t operator()(size_t idx) const noexcept
+            {
+                return indices[idx];
+            }
+        };
+
+        /**
+         * Expands a generalized slice into the list of the
+         * indices it refers to, the last dimension is the
+         * one that changes the fastest.
+         */
+        inline valarray<size_t> gslice_indices(const gslice& s)
+        {
+            auto sizes = s.size();
+            auto strides = s.stride();
+            auto dims = sizes.size();
+
+            size_t count{dims ? 1U : 0U};
+            for (size_t i = 0; i < dims; ++i)
+                count *= sizes[i];
+
+            valarray<size_t> res(count);
+            valarray<size_t> counters(dims);
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t idx{s.start()};
+                for (size_t j = 0; j < dims; ++j)
+                    idx += counters[j] * strides[j];
+                res[i] = idx;
+
+                for (size_t j = dims; j-- > 0;)
+                {
+                    if (++counters[j] < sizes[j])
+                        break;
+                    counters[j] = 0;
+                }
+            }
+
+            return res;
+        }
+
+        inline valarray<size_t> mask_indices(const valarray<bool>& mask)
+        {
+            size_t count{};
+            for (size_t i = 0; i < mask.size(); ++i)
+            {
+                if (mask[i])
+                    ++count;
+            }
+
+            valarray<size_t> res(count);
+            for (size_t i = 0, j = 0; i < mask.size(); ++i)
+            {
+                if (mask[i])
+                    res[j++] = i;
+            }
+
+            return res;
+        }
+
+        /**
+         * Common base of the helper arrays returned by the
+         * non-const subset operations, they refer to the
+         * selected elements of a valarray and the indexer
+         * maps their positions to the valarray's.
+         */
+        template<class T, class Indexer>
+        class valarray_view
+        {
+            public:
+                using value_type = T;
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), [](const T&, const T& src){
+                        return src;
+                    });
+                }
+
+                /**
+                 * Note: The helper arrays assign elements, the
+                 *       derived classes provide the copy
+                 *       assignment and this one only keeps
+                 *       the implicit one out of the overload
+                 *       sets.
+                 */
+                valarray_view& operator=(const valarray_view&) const = delete;
+
+                void operator=(const value_type& val) const
+                {
+                    compute_(valarray_scalar<T>{val}, [](const T&, const T& src){
+                        return src;
+                    });
+                }
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator*=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), multiplies<>{});
+                }
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator/=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), divides<>{});
+                }
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator%=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), modulus<>{});
+                }
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator+=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), plus<>{});
+                }
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator-=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), minus<>{});
+                }
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator^=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), bit_xor<>{});
+                }
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator&=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), bit_and<>{});
+                }
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator|=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), bit_or<>{});
+                }
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator<<=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), valarray_shift_left{});
+                }
+
+                template<class Arr>
+                enable_if_t<is_valarray_operand_v<Arr>>
+                operator>>=(const Arr& arr) const
+                {
+                    compute_(valarray_node<T>(arr), valarray_shift_right{});
+                }
+
+            protected:
+                valarray_view(T* data, const Indexer& indexer)
+                    : data_{data}, indexer_{indexer}
+                { /* DUMMY BODY */ }
+
+                valarray_view(const valarray_view&) = default;
+
+                void copy_(const valarray_view& other) const
+                {
+                    for (size_t i = 0; i < indexer_.size(); ++i)
+                        data_[indexer_(i)] = other[i];
+                }
+
+            private:
+                T* data_;
+                Indexer indexer_;
+
+                size_t size_() const noexcept
+                {
+                    return indexer_.size();
+                }
+
+                const T& operator[](size_t idx) const noexcept
+                {
+                    return data_[indexer_(idx)];
+                }
+
+                template<class Src, class Op>
+                void compute_(const Src& src, Op op) const
+                {
+                    for (size_t i = 0; i < indexer_.size(); ++i)
+                    {
+                        auto& elem = data_[indexer_(i)];
+                        elem = static_cast<T>(op(elem, src[i]));
+                    }
+                }
+
+                friend class valarray<T>;
+        };
+    }
+
+    /**
+     * 26.6.5, class template slice_array:
+     */
+
+    template<class T>
+    class slice_array: public aux::valarray_view<T, aux::slice_indexer>
+    {
+        public:
+            using value_type = T;
+
+            using aux::valarray_view<T, aux::slice_indexer>::operator=;
+
+            slice_array(const slice_array&) = default;
+
+            ~slice_array() = default;
+
+            const slice_array& operator=(const slice_array& other) const
+            {
+                this->copy_(other);
+
+                return *this;
+            }
+
+            slice_array() = delete;
+
+        private:
+            slice_array(T* data, const slice& s)
+                : aux::valarray_view<T, aux::slice_indexer>{
+                    data, aux::slice_indexer{s.start(), s.size(), s.stride()}
+                  }
+            { /* DUMMY BODY */ }
+
+            friend class valarray<T>;
+    };
+
+    /**
+     * 26.6.7, class template gslice_array:
+     */
+
+    template<class T>
+    class gslice_array: public aux::valarray_view<T, aux::index_indexer>
+    {
+        public:
+            using value_type = T;
+
+            using aux::valarray_view<T, aux::index_indexer>::operator=;
+
+            gslice_array(const gslice_array&) = default;
+
+            ~gslice_array() = default;
+
+            const gslice_array& operator=(const gslice_array& other) const
+            {
+                this->copy_(other);
+
+                return *this;
+            }
+
+            gslice_array() = delete;
+
+        private:
+            gslice_array(T* data, const gslice& s)
+                : aux::valarray_view<T, aux::index_indexer>{
+                    data, aux::index_indexer{aux::gslice_indices(s)}
+                  }
+            { /* DUMMY BODY */ }
+
+            friend class valarray<T>;
+    };
+
+    /**
+     * 26.6.8, class template mask_array:
+     */
+
+    template<class T>
+    class mask_array: public aux::valarray_view<T, aux::index_indexer>
+    {
+        public:
+            using value_type = T;
+
+            using aux::valarray_view<T, aux::index_indexer>::operator=;
+
+            mask_array(const mask_array&) = default;
+
+            ~mask_array() = default;
+
+            const mask_array& operator=(const mask_array& other) const
+            {
+                this->copy_(other);
+
+                return *this;
+            }
+
+            mask_array() = delete;
+
+        private:
+            mask_array(T* data, const valarray<bool>& mask)
+                : aux::valarray_view<T, aux::index_indexer>{
+                    data, aux::index_indexer{aux::mask_indices(mask)}
+                  }
+            { /* DUMMY BODY */ }
+
+            friend class valarray<T>;
+    };
+
+    /**
+     * 26.6.9, class template indirect_array:
+     */
+
+    template<class T>
+    class indirect_array: public aux::valarray_view<T, aux::index_indexer>
+    {
+        public:
+            using value_type = T;
+
+            using aux::valarray_view<T, aux::index_indexer>::operator=;
+
+            indirect_array(const indirect_array&) = default;
+
+            ~indirect_array() = default;
+
+            const indirect_array& operator=(const indirect_array& other) const
+            {
+                this->copy_(other);
+
+                return *this;
+            }
+
+            indirect_array() = delete;
+
+        private:
+            indirect_array(T* data, const valarray<size_t>& indices)
+                : aux::valarray_view<T, aux::index_indexer>{
+                    data, aux::index_indexer{indices}
+                  }
+            { /* DUMMY BODY */ }
+
+            friend class valarray<T>;
+    };
+
+    /**
+     * 26.6.2.9, specialized algorithms:
+     */
+
+    template<class T>
+    void swap(valarray<T>& lhs, valarray<T>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    /**
+     * 26.6.3.1, valarray binary operators:
+     * Note: Operands can be valarrays, expressions built
+     *       from them or values of their value type, the
+     *       result is an expression.
+     */
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator*(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, multiplies<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator/(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, divides<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator%(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, modulus<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator+(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, plus<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator-(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, minus<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator^(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, bit_xor<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator&(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, bit_and<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator|(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, bit_or<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator<<(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, aux::valarray_shift_left>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator>>(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, aux::valarray_shift_right>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator&&(const Lhs& lhs, const Rhs& rhs)
+    {
+        return aux::valarray_binary<bool, logical_and<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator||(const Lhs& lhs, const Rhs& rhs)
+    {
+        return aux::valarray_binary<bool, logical_or<>>(lhs, rhs);
+    }
+
+    /**
+     * 26.6.3.2, valarray comparison operators:
+     */
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator==(const Lhs& lhs, const Rhs& rhs)
+    {
+        return aux::valarray_binary<bool, equal_to<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator!=(const Lhs& lhs, const Rhs& rhs)
+    {
+        return aux::valarray_binary<bool, not_equal_to<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator<(const Lhs& lhs, const Rhs& rhs)
+    {
+        return aux::valarray_binary<bool, less<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator>(const Lhs& lhs, const Rhs& rhs)
+    {
+        return aux::valarray_binary<bool, greater<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator<=(const Lhs& lhs, const Rhs& rhs)
+    {
+        return aux::valarray_binary<bool, less_equal<>>(lhs, rhs);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto operator>=(const Lhs& lhs, const Rhs& rhs)
+    {
+        return aux::valarray_binary<bool, greater_equal<>>(lhs, rhs);
+    }
+
+    /**
+     * 26.6.3.3, valarray transcendentals:
+     * Note: Except for abs these call the libc math
+     *       functions, which live in libmath.
+     */
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto abs(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_abs>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto acos(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_acos>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto asin(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_asin>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto atan(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_atan>(arr);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto atan2(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, aux::valarray_atan2>(lhs, rhs);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto cos(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_cos>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto cosh(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_cosh>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto exp(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_exp>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto log(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_log>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto log10(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_log10>(arr);
+    }
+
+    template<class Lhs, class Rhs, class = aux::enable_if_valarray_operands_t<Lhs, Rhs>>
+    auto pow(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = aux::valarray_operands_value_t<Lhs, Rhs>;
+
+        return aux::valarray_binary<value_type, aux::valarray_pow>(lhs, rhs);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto sin(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_sin>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto sinh(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_sinh>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto sqrt(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_sqrt>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto tan(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_tan>(arr);
+    }
+
+    template<class Arr, class = enable_if_t<aux::is_valarray_operand_v<Arr>>>
+    auto tanh(const Arr& arr)
+    {
+        return aux::valarray_unary<typename Arr::value_type, aux::valarray_tanh>(arr);
+    }
+
+    /**
+     * 26.6.10, valarray range access:
+     */
+
+    template<class T>
+    T* begin(valarray<T>& arr)
+    {
+        return arr.size() ? &arr[0] : nullptr;
+    }
+
+    template<class T>
+    const T* begin(const valarray<T>& arr)
+    {
+        return arr.size() ? &arr[0] : nullptr;
+    }
+
+    template<class T>
+    T* end(valarray<T>& arr)
+    {
+        return begin(arr) + arr.size();
+    }
+
+    template<class T>
+    const T* end(const valarray<T>& arr)
+    {
+        return begin(arr) + arr.size();
+    }
+}
 
 #endif
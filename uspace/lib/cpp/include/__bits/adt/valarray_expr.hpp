@@ -0,0 +1,674 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_ADT_VALARRAY_EXPR
+#define LIBCPP_BITS_ADT_VALARRAY_EXPR
+
+#include <__bits/functional/arithmetic_operations.hpp>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace std::hel
+{
+    extern "C" {
+        #include <math.h>
+    }
+}
+
+namespace std
+{
+    template<class T>
+    class valarray;
+}
+
+namespace std::aux
+{
+    /**
+     * Elementwise operations on valarrays build expression
+     * trees instead of temporary arrays, the tree is evaluated
+     * by a single loop when it is assigned to a valarray. The
+     * nodes are small and copied by value and their subscript
+     * operators are trivially inlinable, so the loop reduces
+     * to plain arithmetic over the operands' buffers, which
+     * the compiler can vectorize.
+     * Note: The nodes refer to the valarrays they were built
+     *       from, so an expression must not outlive them.
+     */
+
+    template<class T>
+    class valarray_ref
+    {
+        public:
+            using value_type = T;
+
+            valarray_ref(const T* data, size_t size)
+                : data_{data}, size_{size}
+            { /* DUMMY BODY */ }
+
+            size_t size() const noexcept
+            {
+                return size_;
+            }
+
+            const T& operator[](size_t idx) const noexcept
+            {
+                return data_[idx];
+            }
+
+        private:
+            const T* data_;
+            size_t size_;
+    };
+
+    /**
+     * Scalar operand of a binary operation, it has
+     * no size of its own and takes the one of the
+     * other operand.
+     */
+    template<class T>
+    class valarray_scalar
+    {
+        public:
+            using value_type = T;
+
+            valarray_scalar(const T& value)
+                : value_{value}
+            { /* DUMMY BODY */ }
+
+            const T& operator[](size_t) const noexcept
+            {
+                return value_;
+            }
+
+        private:
+            T value_;
+    };
+
+    template<class T>
+    struct is_valarray_scalar: false_type
+    { /* DUMMY BODY */ };
+
+    template<class T>
+    struct is_valarray_scalar<valarray_scalar<T>>: true_type
+    { /* DUMMY BODY */ };
+
+    template<class Result, class Op, class Arg>
+    class valarray_unary_expr
+    {
+        public:
+            using value_type = Result;
+
+            valarray_unary_expr(const Arg& arg)
+                : arg_{arg}
+            { /* DUMMY BODY */ }
+
+            size_t size() const noexcept
+            {
+                return arg_.size();
+            }
+
+            value_type operator[](size_t idx) const
+            {
+                return static_cast<value_type>(Op{}(arg_[idx]));
+            }
+
+        private:
+            Arg arg_;
+    };
+
+    template<class Result, class Op, class Lhs, class Rhs>
+    class valarray_binary_expr
+    {
+        public:
+            using value_type = Result;
+
+            valarray_binary_expr(const Lhs& lhs, const Rhs& rhs)
+                : lhs_{lhs}, rhs_{rhs}
+            { /* DUMMY BODY */ }
+
+            size_t size() const noexcept
+            {
+                if constexpr (is_valarray_scalar<Lhs>::value)
+                    return rhs_.size();
+                else
+                    return lhs_.size();
+            }
+
+            value_type operator[](size_t idx) const
+            {
+                return static_cast<value_type>(Op{}(lhs_[idx], rhs_[idx]));
+            }
+
+        private:
+            Lhs lhs_;
+            Rhs rhs_;
+    };
+
+    template<class Expr>
+    class valarray_expr;
+
+    template<class T>
+    struct is_valarray_operand: false_type
+    { /* DUMMY BODY */ };
+
+    template<class T>
+    struct is_valarray_operand<valarray<T>>: true_type
+    { /* DUMMY BODY */ };
+
+    template<class Expr>
+    struct is_valarray_operand<valarray_expr<Expr>>: true_type
+    { /* DUMMY BODY */ };
+
+    template<class T>
+    inline constexpr bool is_valarray_operand_v = is_valarray_operand<T>::value;
+
+    /**
+     * Decides whether a binary operator applies to the given
+     * operand types, at least one of them has to be a valarray
+     * (or an expression) and the other one either a valarray
+     * of the same value type or a value convertible to it.
+     */
+    template<class Lhs, class Rhs, class = void>
+    struct valarray_operands
+    {
+        static constexpr bool value = false;
+    };
+
+    template<class Lhs, class Rhs>
+    struct valarray_operands<
+        Lhs, Rhs, enable_if_t<is_valarray_operand_v<Lhs> && is_valarray_operand_v<Rhs>>
+    >
+    {
+        using value_type = typename Lhs::value_type;
+
+        static constexpr bool value = is_same_v<
+            typename Lhs::value_type, typename Rhs::value_type
+        >;
+    };
+
+    template<class Lhs, class Rhs>
+    struct valarray_operands<
+        Lhs, Rhs, enable_if_t<is_valarray_operand_v<Lhs> && !is_valarray_operand_v<Rhs>>
+    >
+    {
+        using value_type = typename Lhs::value_type;
+
+        static constexpr bool value = is_convertible_v<Rhs, value_type>;
+    };
+
+    template<class Lhs, class Rhs>
+    struct valarray_operands<
+        Lhs, Rhs, enable_if_t<!is_valarray_operand_v<Lhs> && is_valarray_operand_v<Rhs>>
+    >
+    {
+        using value_type = typename Rhs::value_type;
+
+        static constexpr bool value = is_convertible_v<Lhs, value_type>;
+    };
+
+    template<class Lhs, class Rhs>
+    using enable_if_valarray_operands_t = enable_if_t<valarray_operands<Lhs, Rhs>::value>;
+
+    template<class Lhs, class Rhs>
+    using valarray_operands_value_t = typename valarray_operands<Lhs, Rhs>::value_type;
+
+    /**
+     * Turns an operand into an expression node.
+     */
+    template<class Value, class T>
+    valarray_ref<T> valarray_node(const valarray<T>& arr)
+    {
+        return valarray_ref<T>{arr.size() ? &arr[0] : nullptr, arr.size()};
+    }
+
+    template<class Value, class Expr>
+    const Expr& valarray_node(const valarray_expr<Expr>& expr)
+    {
+        return expr.expr();
+    }
+
+    template<class Value, class T>
+    enable_if_t<!is_valarray_operand_v<T>, valarray_scalar<Value>>
+    valarray_node(const T& value)
+    {
+        return valarray_scalar<Value>{static_cast<Value>(value)};
+    }
+
+    template<class Result, class Op, class Arg>
+    auto valarray_unary(const Arg& arg)
+    {
+        using value_type = typename Arg::value_type;
+        using node = decltype(valarray_node<value_type>(arg));
+        using expr = valarray_unary_expr<Result, Op, node>;
+
+        return valarray_expr<expr>{expr{valarray_node<value_type>(arg)}};
+    }
+
+    template<class Result, class Op, class Lhs, class Rhs>
+    auto valarray_binary(const Lhs& lhs, const Rhs& rhs)
+    {
+        using value_type = valarray_operands_value_t<Lhs, Rhs>;
+        using lhs_node = decltype(valarray_node<value_type>(lhs));
+        using rhs_node = decltype(valarray_node<value_type>(rhs));
+        using expr = valarray_binary_expr<Result, Op, lhs_node, rhs_node>;
+
+        return valarray_expr<expr>{expr{
+            valarray_node<value_type>(lhs), valarray_node<value_type>(rhs)
+        }};
+    }
+
+    /**
+     * Operations that have no function object
+     * in <functional>.
+     */
+
+    struct valarray_shift_left
+    {
+        template<class T>
+        constexpr T operator()(const T& lhs, const T& rhs) const
+        {
+            return lhs << rhs;
+        }
+    };
+
+    struct valarray_shift_right
+    {
+        template<class T>
+        constexpr T operator()(const T& lhs, const T& rhs) const
+        {
+            return lhs >> rhs;
+        }
+    };
+
+    struct valarray_unary_plus
+    {
+        template<class T>
+        constexpr T operator()(const T& arg) const
+        {
+            return +arg;
+        }
+    };
+
+    struct valarray_abs
+    {
+        template<class T>
+        constexpr T operator()(const T& arg) const
+        {
+            return arg < T{} ? -arg : arg;
+        }
+    };
+
+    /**
+     * Reductions shared by valarray and the expressions,
+     * the latter are reduced in the same pass in which
+     * they are evaluated.
+     */
+
+    template<class T, class Src>
+    T valarray_sum(const Src& src, size_t n)
+    {
+        if (n == 0)
+            return T{};
+
+        if constexpr (is_arithmetic_v<T>)
+        {
+            /**
+             * Independent partial sums do not wait for
+             * each other and can be kept in a vector
+             * register.
+             */
+            T partial[4]{};
+            auto blocks = n / 4;
+            for (size_t i = 0; i < blocks; ++i)
+            {
+                partial[0] += src[4 * i];
+                partial[1] += src[4 * i + 1];
+                partial[2] += src[4 * i + 2];
+                partial[3] += src[4 * i + 3];
+            }
+
+            for (size_t i = 4 * blocks; i < n; ++i)
+                partial[0] += src[i];
+
+            return (partial[0] + partial[1]) + (partial[2] + partial[3]);
+        }
+        else
+        {
+            T res{src[0]};
+            for (size_t i = 1; i < n; ++i)
+                res += src[i];
+
+            return res;
+        }
+    }
+
+    template<class T, class Src, class Compare>
+    T valarray_extreme(const Src& src, size_t n, Compare comp)
+    {
+        if (n == 0)
+            return T{};
+
+        T res{src[0]};
+        for (size_t i = 1; i < n; ++i)
+        {
+            T elem{src[i]};
+            if (comp(elem, res))
+                res = elem;
+        }
+
+        return res;
+    }
+
+    /**
+     * The type returned by the elementwise operations, it
+     * can be used wherever a valarray is expected in an
+     * expression and converts to one implicitly.
+     */
+    template<class Expr>
+    class valarray_expr
+    {
+        public:
+            using value_type = typename Expr::value_type;
+
+            explicit valarray_expr(const Expr& expr)
+                : expr_{expr}
+            { /* DUMMY BODY */ }
+
+            size_t size() const noexcept
+            {
+                return expr_.size();
+            }
+
+            value_type operator[](size_t idx) const
+            {
+                return expr_[idx];
+            }
+
+            const Expr& expr() const noexcept
+            {
+                return expr_;
+            }
+
+            auto operator+() const
+            {
+                return valarray_unary<value_type, valarray_unary_plus>(*this);
+            }
+
+            auto operator-() const
+            {
+                return valarray_unary<value_type, negate<>>(*this);
+            }
+
+            auto operator~() const
+            {
+                return valarray_unary<value_type, bit_not<>>(*this);
+            }
+
+            auto operator!() const
+            {
+                return valarray_unary<bool, logical_not<>>(*this);
+            }
+
+            value_type sum() const
+            {
+                return valarray_sum<value_type>(expr_, expr_.size());
+            }
+
+            value_type min() const
+            {
+                return valarray_extreme<value_type>(expr_, expr_.size(), less<>{});
+            }
+
+            value_type max() const
+            {
+                return valarray_extreme<value_type>(expr_, expr_.size(), greater<>{});
+            }
+
+        private:
+            Expr expr_;
+    };
+
+    /**
+     * The transcendental functions call the libc function
+     * matching the precision of the value type, other types
+     * are computed in double precision.
+     */
+
+    struct valarray_acos
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::acosf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::acosl(arg);
+            else
+                return static_cast<T>(hel::acos(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_asin
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::asinf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::asinl(arg);
+            else
+                return static_cast<T>(hel::asin(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_atan
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::atanf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::atanl(arg);
+            else
+                return static_cast<T>(hel::atan(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_atan2
+    {
+        template<class T>
+        T operator()(const T& lhs, const T& rhs) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::atan2f(lhs, rhs);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::atan2l(lhs, rhs);
+            else
+                return static_cast<T>(hel::atan2(static_cast<double>(lhs), static_cast<double>(rhs)));
+        }
+    };
+
+    struct valarray_cos
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::cosf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::cosl(arg);
+            else
+                return static_cast<T>(hel::cos(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_cosh
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::coshf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::coshl(arg);
+            else
+                return static_cast<T>(hel::cosh(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_exp
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::expf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::expl(arg);
+            else
+                return static_cast<T>(hel::exp(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_log
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::logf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::logl(arg);
+            else
+                return static_cast<T>(hel::log(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_log10
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::log10f(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::log10l(arg);
+            else
+                return static_cast<T>(hel::log10(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_pow
+    {
+        template<class T>
+        T operator()(const T& lhs, const T& rhs) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::powf(lhs, rhs);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::powl(lhs, rhs);
+            else
+                return static_cast<T>(hel::pow(static_cast<double>(lhs), static_cast<double>(rhs)));
+        }
+    };
+
+    struct valarray_sin
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::sinf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::sinl(arg);
+            else
+                return static_cast<T>(hel::sin(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_sinh
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::sinhf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::sinhl(arg);
+            else
+                return static_cast<T>(hel::sinh(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_sqrt
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::sqrtf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::sqrtl(arg);
+            else
+                return static_cast<T>(hel::sqrt(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_tan
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::tanf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::tanl(arg);
+            else
+                return static_cast<T>(hel::tan(static_cast<double>(arg)));
+        }
+    };
+
+    struct valarray_tanh
+    {
+        template<class T>
+        T operator()(const T& arg) const
+        {
+            if constexpr (is_same_v<T, float>)
+                return hel::tanhf(arg);
+            else if constexpr (is_same_v<T, long double>)
+                return hel::tanhl(arg);
+            else
+                return static_cast<T>(hel::tanh(static_cast<double>(arg)));
+        }
+    };
+}
+
+#endif
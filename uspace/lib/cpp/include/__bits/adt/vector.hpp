@@ -30,6 +30,7 @@
 #define LIBCPP_BITS_ADT_VECTOR
 
 #include <algorithm>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
@@ -82,25 +83,35 @@ namespace std
                 data_ = allocator_.allocate(capacity_);
 
                 for (size_type i = 0; i < size_; ++i)
-                    data_[i] = val;
+                    allocator_traits<Allocator>::construct(allocator_, data_ + i, val);
             }
 
             template<class InputIterator>
             vector(InputIterator first, InputIterator last,
                    const Allocator& alloc = Allocator{})
+                : data_{nullptr}, size_{}, capacity_{}, allocator_{alloc}
             {
-                // TODO: research constraints and provide multiple
-                //       implementations via enable_if
+                if constexpr (is_integral<InputIterator>::value)
+                {
+                    auto n = static_cast<size_type>(first);
+                    reserve(n);
+                    for (size_type i = 0; i < n; ++i)
+                        emplace_back(static_cast<value_type>(last));
+                }
+                else
+                    init_(first, last);
             }
 
             vector(const vector& other)
-                : data_{nullptr}, size_{other.size_}, capacity_{other.capacity_},
-                  allocator_{other.allocator_}
+                : data_{nullptr}, size_{other.size_}, capacity_{other.size_},
+                  allocator_{
+                      allocator_traits<Allocator>::select_on_container_copy_construction(
+                          other.allocator_
+                      )
+                  }
             {
                 data_ = allocator_.allocate(capacity_);
-
-                for (size_type i = 0; i < size_; ++i)
-                    data_[i] = other.data_[i];
+                construct_range_(data_, other.data_, other.data_ + size_);
             }
 
             vector(vector&& other) noexcept
@@ -113,37 +124,40 @@ namespace std
             }
 
             vector(const vector& other, const Allocator& alloc)
-                : data_{nullptr}, size_{other.size_}, capacity_{other.capacity_},
+                : data_{nullptr}, size_{other.size_}, capacity_{other.size_},
                   allocator_{alloc}
             {
                 data_ = allocator_.allocate(capacity_);
-
-                for (size_type i = 0; i < size_; ++i)
-                    data_[i] = other.data_[i];
+                construct_range_(data_, other.data_, other.data_ + size_);
             }
 
             vector(initializer_list<T> init, const Allocator& alloc = Allocator{})
-                : data_{nullptr}, size_{init.size()}, capacity_{init.size()},
+                : data_{nullptr}, size_{}, capacity_{},
                   allocator_{alloc}
             {
-                data_ = allocator_.allocate(capacity_);
-
-                auto it = init.begin();
-                for (size_type i = 0; it != init.end(); ++i, ++it)
-                {
-                    data_[i] = *it;
-                }
+                init_(init.begin(), init.end());
             }
 
             ~vector()
             {
-                allocator_.deallocate(data_, capacity_);
+                clear();
+
+                if (data_)
+                    allocator_.deallocate(data_, capacity_);
             }
 
             vector& operator=(const vector& other)
             {
-                vector tmp{other};
-                swap(tmp);
+                using propagate = typename allocator_traits<
+                    allocator_type
+                >::propagate_on_container_copy_assignment;
+
+                // Parentheses required to avoid initializer list
+                // construction.
+                vector tmp(other, propagate::value ? other.allocator_ : allocator_);
+                swap_storage_(tmp);
+                if constexpr (propagate::value)
+                    std::swap(allocator_, tmp.allocator_);
 
                 return *this;
             }
@@ -152,6 +166,26 @@ namespace std
                 noexcept(allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
                          allocator_traits<Allocator>::is_always_equal::value)
             {
+                using propagate = typename allocator_traits<
+                    allocator_type
+                >::propagate_on_container_move_assignment;
+
+                if constexpr (!propagate::value)
+                {
+                    /**
+                     * We cannot take over memory that was
+                     * allocated by a different allocator.
+                     */
+                    if (allocator_ != other.allocator_)
+                    {
+                        vector tmp(other, allocator_);
+                        swap_storage_(tmp);
+
+                        return *this;
+                    }
+                }
+
+                clear();
                 if (data_)
                     allocator_.deallocate(data_, capacity_);
 
@@ -159,19 +193,19 @@ namespace std
                 data_ = other.data_;
                 size_ = other.size_;
                 capacity_ = other.capacity_;
-                allocator_ = move(other.allocator_);
+                if constexpr (propagate::value)
+                    allocator_ = move(other.allocator_);
 
                 other.data_ = nullptr;
                 other.size_ = size_type{};
                 other.capacity_ = size_type{};
-                other.allocator_ = allocator_type{};
                 return *this;
             }
 
             vector& operator=(initializer_list<T> init)
             {
-                vector tmp{init, allocator_};
-                swap(tmp);
+                vector tmp(init, allocator_);
+                swap_storage_(tmp);
 
                 return *this;
             }
@@ -179,22 +213,41 @@ namespace std
             template<class InputIterator>
             void assign(InputIterator first, InputIterator last)
             {
-                vector tmp{first, last};
-                swap(tmp);
+                if constexpr (!is_integral<InputIterator>::value)
+                {
+                    using category = typename iterator_traits<InputIterator>::iterator_category;
+
+                    if constexpr (is_base_of<forward_iterator_tag, category>::value)
+                    {
+                        // Reuse our storage if the range fits.
+                        auto count = static_cast<size_type>(distance(first, last));
+                        if (count <= capacity_)
+                        {
+                            clear();
+                            construct_range_(data_, first, last);
+                            size_ = count;
+
+                            return;
+                        }
+                    }
+                }
+
+                vector tmp(first, last, allocator_);
+                swap_storage_(tmp);
             }
 
             void assign(size_type size, const T& val)
             {
                 // Parenthesies required to avoid initializer list
                 // construction.
-                vector tmp(size, val);
-                swap(tmp);
+                vector tmp(size, val, allocator_);
+                swap_storage_(tmp);
             }
 
             void assign(initializer_list<T> init)
             {
-                vector tmp{init};
-                swap(tmp);
+                vector tmp(init, allocator_);
+                swap_storage_(tmp);
             }
 
             allocator_type get_allocator() const noexcept
@@ -274,16 +327,34 @@ namespace std
 
             void resize(size_type sz)
             {
-                resize_with_copy_(size_, capacity_);
+                if (sz <= size_)
+                {
+                    destroy_from_end_until_(begin() + sz);
+                    size_ = sz;
+
+                    return;
+                }
+
+                reserve(sz);
+                while (size_ < sz)
+                    emplace_back();
             }
 
             void resize(size_type sz, const value_type& val)
             {
-                auto old_size = size_;
-                resize_with_copy_(sz, capacity_);
+                if (sz <= size_)
+                {
+                    destroy_from_end_until_(begin() + sz);
+                    size_ = sz;
+
+                    return;
+                }
 
-                for (size_type i = old_size - 1; i < size_; ++i)
-                    data_[i] = val;
+                // The value may be one of our elements.
+                value_type tmp{val};
+                reserve(sz);
+                while (size_ < sz)
+                    emplace_back(tmp);
             }
 
             size_type capacity() const noexcept
@@ -302,12 +373,13 @@ namespace std
                 //       length_error (this function shall have no
                 //       effect in such case)
                 if (new_capacity > capacity_)
-                    resize_with_copy_(size_, new_capacity);
+                    reallocate_(new_capacity);
             }
 
             void shrink_to_fit()
             {
-                resize_with_copy_(size_, size_);
+                if (size_ < capacity_)
+                    reallocate_(size_);
             }
 
             reference operator[](size_type idx)
@@ -356,7 +428,7 @@ namespace std
 
             const_reference back() const
             {
-                return at(size - 1);
+                return at(size_ - 1);
             }
 
             T* data() noexcept
@@ -373,26 +445,40 @@ namespace std
             reference emplace_back(Args&&... args)
             {
                 if (size_ >= capacity_)
-                    resize_with_copy_(size_, next_capacity_());
+                {
+                    /**
+                     * The arguments may refer to our elements,
+                     * so the new one is constructed before the
+                     * old ones are moved away.
+                     */
+                    auto new_capacity = next_capacity_();
+                    auto new_data = allocator_.allocate(new_capacity);
+                    allocator_traits<Allocator>::construct(
+                        allocator_, new_data + size_, forward<Args>(args)...
+                    );
+
+                    relocate_(new_data, new_capacity);
+                }
+                else
+                {
+                    allocator_traits<Allocator>::construct(
+                        allocator_, data_ + size_, forward<Args>(args)...
+                    );
+                }
 
-                allocator_traits<Allocator>::construct(allocator_,
-                                                       begin() + size_, forward<Args>(args)...);
+                ++size_;
 
                 return back();
             }
 
             void push_back(const T& x)
             {
-                if (size_ >= capacity_)
-                    resize_with_copy_(size_, next_capacity_());
-                data_[size_++] = x;
+                emplace_back(x);
             }
 
             void push_back(T&& x)
             {
-                if (size_ >= capacity_)
-                    resize_with_copy_(size_, next_capacity_());
-                data_[size_++] = forward<T>(x);
+                emplace_back(forward<T>(x));
             }
 
             void pop_back()
@@ -404,42 +490,33 @@ namespace std
             template<class... Args>
             iterator emplace(const_iterator position, Args&&... args)
             {
-                auto pos = const_cast<iterator>(position);
+                // The arguments may refer to our elements.
+                value_type tmp(forward<Args>(args)...);
 
-                pos = shift_(pos, 1);
-                allocator_.construct(pos, forward<Args>(args)...);
+                auto pos = shift_(const_cast<iterator>(position), 1);
+                allocator_traits<Allocator>::construct(allocator_, pos, move(tmp));
 
                 return pos;
             }
 
             iterator insert(const_iterator position, const value_type& x)
             {
-                auto pos = const_cast<iterator>(position);
-
-                pos = shift_(pos, 1);
-                *pos = x;
-
-                return pos;
+                return emplace(position, x);
             }
 
             iterator insert(const_iterator position, value_type&& x)
             {
-                auto pos = const_cast<iterator>(position);
-
-                pos = shift_(pos, 1);
-                *pos = forward<value_type>(x);
-
-                return pos;
+                return emplace(position, forward<value_type>(x));
             }
 
             iterator insert(const_iterator position, size_type count, const value_type& x)
             {
-                auto pos = const_cast<iterator>(position);
+                // The value may be one of our elements.
+                value_type tmp{x};
 
-                pos = shift_(pos, count);
-                auto copy_target = pos;
+                auto pos = shift_(const_cast<iterator>(position), count);
                 for (size_type i = 0; i < count; ++i)
-                    *copy_target++ = x;
+                    allocator_traits<Allocator>::construct(allocator_, pos + i, tmp);
 
                 return pos;
             }
@@ -448,38 +525,72 @@ namespace std
             iterator insert(const_iterator position, InputIterator first,
                             InputIterator last)
             {
-                auto pos = const_cast<iterator>(position);
-                auto count = static_cast<size_type>(last - first);
-
-                pos = shift_(pos, count);
-                copy(first, last, pos);
-
-                return pos;
+                if constexpr (is_integral<InputIterator>::value)
+                {
+                    return insert(
+                        position, static_cast<size_type>(first),
+                        static_cast<value_type>(last)
+                    );
+                }
+                else
+                {
+                    using category = typename iterator_traits<InputIterator>::iterator_category;
+
+                    if constexpr (is_base_of<forward_iterator_tag, category>::value)
+                    {
+                        /**
+                         * The number of elements is known, so we make
+                         * room for all of them at once.
+                         */
+                        auto count = static_cast<size_type>(distance(first, last));
+
+                        auto pos = shift_(const_cast<iterator>(position), count);
+                        construct_range_(pos, first, last);
+
+                        return pos;
+                    }
+                    else
+                    {
+                        /**
+                         * Input iterators can be traversed only once, so
+                         * we read the range first to learn its size.
+                         */
+                        vector tmp(first, last, allocator_);
+
+                        return insert(
+                            position, make_move_iterator(tmp.begin()),
+                            make_move_iterator(tmp.end())
+                        );
+                    }
+                }
             }
 
             iterator insert(const_iterator position, initializer_list<T> init)
             {
-                auto pos = const_cast<iterator>(position);
-
-                pos = shift_(pos, init.size());
-                copy(init.begin(), init.end(), pos);
-
-                return pos;
+                return insert(position, init.begin(), init.end());
             }
 
             iterator erase(const_iterator position)
             {
-                iterator pos = const_cast<iterator>(position);
-                copy(position + 1, cend(), pos);
-                --size_;
-
-                return pos;
+                return erase(position, position + 1);
             }
 
             iterator erase(const_iterator first, const_iterator last)
             {
                 iterator pos = const_cast<iterator>(first);
-                copy(last, cend(), pos);
+                if (first == last)
+                    return pos;
+
+                if constexpr (trivially_relocatable_)
+                {
+                    auto count = static_cast<size_type>(end() - last);
+                    memmove(pos, last, count * sizeof(value_type));
+                }
+                else
+                {
+                    auto new_end = move(const_cast<iterator>(last), end(), pos);
+                    destroy_from_end_until_(new_end);
+                }
                 size_ -= static_cast<size_type>(last - first);
 
                 return pos;
@@ -489,9 +600,9 @@ namespace std
                 noexcept(allocator_traits<Allocator>::propagate_on_container_swap::value ||
                          allocator_traits<Allocator>::is_always_equal::value)
             {
-                std::swap(data_, other.data_);
-                std::swap(size_, other.size_);
-                std::swap(capacity_, other.capacity_);
+                swap_storage_(other);
+                if constexpr (allocator_traits<Allocator>::propagate_on_container_swap::value)
+                    std::swap(allocator_, other.allocator_);
             }
 
             void clear() noexcept
@@ -507,36 +618,99 @@ namespace std
             size_type capacity_;
             allocator_type allocator_;
 
-            void resize_without_copy_(size_type capacity)
-            {
-                if (data_)
-                    allocator_.deallocate(data_, capacity_);
+            static constexpr bool trivially_relocatable_ =
+                aux::is_trivially_relocatable_v<value_type, allocator_type>;
 
-                data_ = allocator_.allocate(capacity);
-                size_ = 0;
-                capacity_ = capacity;
-            }
+            /**
+             * Note: The first allocation holds at least this many
+             *       bytes, so that small vectors of small elements
+             *       do not reallocate several times while growing.
+             */
+            static constexpr size_type min_alloc_bytes_{64};
 
-            void resize_with_copy_(size_type size, size_type capacity)
+            template<class InputIterator>
+            void init_(InputIterator first, InputIterator last)
             {
-                if (size < size_)
-                    destroy_from_end_until_(begin() + size);
+                using category = typename iterator_traits<InputIterator>::iterator_category;
+
+                if constexpr (is_base_of<forward_iterator_tag, category>::value)
+                {
+                    auto count = static_cast<size_type>(distance(first, last));
+                    reserve(count);
 
-                if(capacity_ == 0 || capacity_ < capacity)
+                    construct_range_(data_, first, last);
+                    size_ = count;
+                }
+                else
                 {
-                    auto new_data = allocator_.allocate(capacity);
+                    while (first != last)
+                        emplace_back(*first++);
+                }
+            }
 
-                    auto to_copy = min(size, size_);
-                    for (size_type i = 0; i < to_copy; ++i)
-                        new_data[i] = move(data_[i]);
+            /**
+             * Constructs copies of the range in uninitialized memory,
+             * ranges of our value type are copied with memcpy when
+             * the elements can be relocated with it.
+             */
+            template<class ForwardIterator>
+            void construct_range_(value_type* dest, ForwardIterator first,
+                                  ForwardIterator last)
+            {
+                if constexpr (trivially_relocatable_ &&
+                              is_pointer<ForwardIterator>::value &&
+                              is_same<remove_cv_t<remove_pointer_t<ForwardIterator>>,
+                                      value_type>::value)
+                {
+                    if (first != last)
+                        memcpy(dest, first, static_cast<size_type>(last - first) * sizeof(value_type));
+                }
+                else
+                {
+                    for (; first != last; ++first, ++dest)
+                        allocator_traits<Allocator>::construct(allocator_, dest, *first);
+                }
+            }
 
-                    std::swap(data_, new_data);
+            void reallocate_(size_type capacity)
+            {
+                relocate_(allocator_.allocate(capacity), capacity);
+            }
 
-                    allocator_.deallocate(new_data, capacity_);
+            /**
+             * Moves the elements to new storage and frees
+             * the old one, the size does not change.
+             */
+            void relocate_(value_type* new_data, size_type new_capacity)
+            {
+                if constexpr (trivially_relocatable_)
+                {
+                    if (size_ > 0)
+                        memcpy(new_data, data_, size_ * sizeof(value_type));
                 }
+                else
+                {
+                    for (size_type i = 0; i < size_; ++i)
+                    {
+                        allocator_traits<Allocator>::construct(
+                            allocator_, new_data + i, move(data_[i])
+                        );
+                        allocator_traits<Allocator>::destroy(allocator_, data_ + i);
+                    }
+                }
+
+                if (data_)
+                    allocator_.deallocate(data_, capacity_);
 
-                capacity_ = capacity;
-                size_ = size;
+                data_ = new_data;
+                capacity_ = new_capacity;
+            }
+
+            void swap_storage_(vector& other) noexcept
+            {
+                std::swap(data_, other.data_);
+                std::swap(size_, other.size_);
+                std::swap(capacity_, other.capacity_);
             }
 
             void destroy_from_end_until_(iterator target)
@@ -549,45 +723,96 @@ namespace std
                 }
             }
 
+            /**
+             * Returns the capacity to grow to when we need room for
+             * (at least) hint elements. The capacity doubles, but
+             * bulk insertions that need more than that get exactly
+             * what they need.
+             */
             size_type next_capacity_(size_type hint = 0) const noexcept
             {
-                if (hint != 0)
-                    return max(capacity_ * 2, hint);
-                else
-                    return max(capacity_ * 2, size_type{2u});
+                constexpr size_type min_capacity = max(
+                    min_alloc_bytes_ / sizeof(value_type), size_type{1}
+                );
+
+                return max(max(capacity_ * 2, hint), min_capacity);
             }
 
+            /**
+             * Makes room for count elements at the position, the
+             * returned range is uninitialized memory and has to be
+             * constructed into by the caller.
+             */
             iterator shift_(iterator position, size_type count)
             {
-                if (size_ + count < capacity_)
-                {
-                    copy_backward(position, end(), end() + count);
-                    size_ += count;
+                auto idx = static_cast<size_type>(position - begin());
 
-                    return position;
+                /**
+                 * Moving elements onto themselves below would
+                 * destroy them.
+                 */
+                if (count == 0)
+                    return begin() + idx;
+
+                if (size_ + count > capacity_)
+                {
+                    auto new_capacity = next_capacity_(size_ + count);
+                    auto new_data = allocator_.allocate(new_capacity);
+
+                    if constexpr (trivially_relocatable_)
+                    {
+                        if (idx > 0)
+                            memcpy(new_data, data_, idx * sizeof(value_type));
+                        if (size_ > idx)
+                        {
+                            memcpy(
+                                new_data + idx + count, data_ + idx,
+                                (size_ - idx) * sizeof(value_type)
+                            );
+                        }
+                    }
+                    else
+                    {
+                        for (size_type i = 0; i < size_; ++i)
+                        {
+                            auto target = (i < idx) ? i : i + count;
+                            allocator_traits<Allocator>::construct(
+                                allocator_, new_data + target, move(data_[i])
+                            );
+                            allocator_traits<Allocator>::destroy(allocator_, data_ + i);
+                        }
+                    }
+
+                    if (data_)
+                        allocator_.deallocate(data_, capacity_);
+
+                    data_ = new_data;
+                    capacity_ = new_capacity;
+                }
+                else if constexpr (trivially_relocatable_)
+                {
+                    if (size_ > idx)
+                    {
+                        memmove(
+                            data_ + idx + count, data_ + idx,
+                            (size_ - idx) * sizeof(value_type)
+                        );
+                    }
                 }
                 else
                 {
-                    auto start_idx = static_cast<size_type>(position - begin());
-                    auto end_idx = start_idx + count;
-                    auto new_size = size_ + count;
-
-                    // Auxiliary vector for easier swap.
-                    vector tmp{};
-                    tmp.resize_without_copy_(max(new_size, capacity_));
-                    tmp.size_ = new_size;
-
-                    // Copy before insertion index.
-                    copy(begin(), begin() + start_idx, tmp.begin());
-
-                    // Copy after insertion index.
-                    copy(begin() + start_idx, end(), tmp.begin() + end_idx);
+                    for (size_type i = size_; i > idx; --i)
+                    {
+                        allocator_traits<Allocator>::construct(
+                            allocator_, data_ + i - 1 + count, move(data_[i - 1])
+                        );
+                        allocator_traits<Allocator>::destroy(allocator_, data_ + i - 1);
+                    }
+                }
 
-                    swap(tmp);
+                size_ += count;
 
-                    // Position was invalidated!
-                    return begin() + start_idx;
-                }
+                return begin() + idx;
             }
     };
 
@@ -663,4 +888,13 @@ namespace std
     // TODO: implement
 }
 
+namespace std::pmr
+{
+    template<class T>
+    class polymorphic_allocator;
+
+    template<class T>
+    using vector = std::vector<T, polymorphic_allocator<T>>;
+}
+
 #endif
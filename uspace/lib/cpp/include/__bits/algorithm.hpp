@@ -30,6 +30,7 @@
 #define LIBCPP_BITS_ALGORITHM
 
 #include <iterator>
+#include <new>
 #include <utility>
 
 namespace std
@@ -37,6 +38,34 @@ namespace std
     template<class T>
     struct less;
 
+    namespace aux
+    {
+        /**
+         * Transparent comparator used by the algorithms
+         * that compare elements of two different ranges
+         * or elements with a value of a different type.
+         * Note: We cannot use less<void> here, because it
+         *       is not complete at this point.
+         */
+        struct less_op
+        {
+            template<class T, class U>
+            constexpr bool operator()(const T& lhs, const U& rhs) const
+            {
+                return lhs < rhs;
+            }
+        };
+
+        struct equal_op
+        {
+            template<class T, class U>
+            constexpr bool operator()(const T& lhs, const U& rhs) const
+            {
+                return lhs == rhs;
+            }
+        };
+    }
+
     /**
      * 25.2, non-modyfing sequence operations:
      */
@@ -408,9 +437,10 @@ namespace std
     BidirectionalIterator2 move_backward(BidirectionalIterator1 first, BidirectionalIterator1 last,
                                          BidirectionalIterator2 result)
     {
-        // Note: We're copying [first, last) so we need to skip the initial value of last.
-        while (last-- != first)
-            *result-- = move(*last);
+        while (first != last)
+            *--result = move(*--last);
+
+        return result;
     }
 
     /**
@@ -622,7 +652,56 @@ namespace std
      * 25.3.9, unique:
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class BinaryPredicate>
+    ForwardIterator unique(ForwardIterator first, ForwardIterator last,
+                           BinaryPredicate pred)
+    {
+        if (first == last)
+            return last;
+
+        auto res = first;
+        while (++first != last)
+        {
+            if (!pred(*res, *first) && ++res != first)
+                *res = move(*first);
+        }
+
+        return ++res;
+    }
+
+    template<class ForwardIterator>
+    ForwardIterator unique(ForwardIterator first, ForwardIterator last)
+    {
+        return unique(first, last, aux::equal_op{});
+    }
+
+    template<class InputIterator, class OutputIterator, class BinaryPredicate>
+    OutputIterator unique_copy(InputIterator first, InputIterator last,
+                               OutputIterator result, BinaryPredicate pred)
+    {
+        if (first == last)
+            return result;
+
+        auto prev = *first;
+        *result++ = prev;
+        while (++first != last)
+        {
+            if (!pred(prev, *first))
+            {
+                prev = *first;
+                *result++ = prev;
+            }
+        }
+
+        return result;
+    }
+
+    template<class InputIterator, class OutputIterator>
+    OutputIterator unique_copy(InputIterator first, InputIterator last,
+                               OutputIterator result)
+    {
+        return unique_copy(first, last, result, aux::equal_op{});
+    }
 
     /**
      * 25.3.10, reverse:
@@ -653,7 +732,49 @@ namespace std
      * 25.3.11, rotate:
      */
 
-    // TODO: implement
+    template<class ForwardIterator>
+    ForwardIterator rotate(ForwardIterator first, ForwardIterator middle,
+                           ForwardIterator last)
+    {
+        if (first == middle)
+            return last;
+        if (middle == last)
+            return first;
+
+        /**
+         * Swap the blocks [first, middle) and [middle, last)
+         * element by element, every time one of them runs out
+         * we continue with the remainder of the other one.
+         */
+        auto next = middle;
+        do
+        {
+            iter_swap(first++, next++);
+            if (first == middle)
+                middle = next;
+        } while (next != last);
+
+        auto res = first;
+
+        next = middle;
+        while (next != last)
+        {
+            iter_swap(first++, next++);
+            if (first == middle)
+                middle = next;
+            else if (next == last)
+                next = middle;
+        }
+
+        return res;
+    }
+
+    template<class ForwardIterator, class OutputIterator>
+    OutputIterator rotate_copy(ForwardIterator first, ForwardIterator middle,
+                               ForwardIterator last, OutputIterator result)
+    {
+        return copy(first, middle, copy(middle, last, result));
+    }
 
     /**
      * 25.3.12, shuffle:
@@ -687,6 +808,148 @@ namespace std
     void sort_heap(RandomAccessIterator, RandomAccessIterator,
                    Compare);
 
+    namespace aux
+    {
+        /**
+         * Ranges shorter than this are left to insertion sort,
+         * which has much lower overhead than partitioning or
+         * merging when there are only a few elements.
+         */
+        inline constexpr ptrdiff_t sort_threshold{16};
+
+        template<class RandomAccessIterator, class Compare>
+        void insertion_sort(RandomAccessIterator first,
+                            RandomAccessIterator last,
+                            Compare comp)
+        {
+            if (first == last)
+                return;
+
+            for (auto it = first + 1; it != last; ++it)
+            {
+                auto val = move(*it);
+                auto hole = it;
+
+                if (comp(val, *first))
+                {
+                    // Smaller than everything, no need to compare.
+                    while (hole != first)
+                    {
+                        *hole = move(*(hole - 1));
+                        --hole;
+                    }
+                }
+                else
+                {
+                    // *first acts as a sentinel here.
+                    while (comp(val, *(hole - 1)))
+                    {
+                        *hole = move(*(hole - 1));
+                        --hole;
+                    }
+                }
+
+                *hole = move(val);
+            }
+        }
+
+        template<class Iterator, class Compare>
+        void move_median_to_first(Iterator res, Iterator a, Iterator b,
+                                  Iterator c, Compare comp)
+        {
+            if (comp(*a, *b))
+            {
+                if (comp(*b, *c))
+                    iter_swap(res, b);
+                else if (comp(*a, *c))
+                    iter_swap(res, c);
+                else
+                    iter_swap(res, a);
+            }
+            else if (comp(*a, *c))
+                iter_swap(res, a);
+            else if (comp(*b, *c))
+                iter_swap(res, c);
+            else
+                iter_swap(res, b);
+        }
+
+        /**
+         * Partitions [first, last) around the median of its first,
+         * middle and last elements, returns the start of the upper
+         * partition. The median is placed at *first, which ensures
+         * neither of the scans can run out of the range.
+         */
+        template<class RandomAccessIterator, class Compare>
+        RandomAccessIterator partition_pivot(RandomAccessIterator first,
+                                             RandomAccessIterator last,
+                                             Compare comp)
+        {
+            auto mid = first + (last - first) / 2;
+            move_median_to_first(first, first + 1, mid, last - 1, comp);
+
+            auto left = first + 1;
+            auto right = last;
+            while (true)
+            {
+                while (comp(*left, *first))
+                    ++left;
+
+                --right;
+                while (comp(*first, *right))
+                    --right;
+
+                if (!(left < right))
+                    return left;
+
+                iter_swap(left, right);
+                ++left;
+            }
+        }
+
+        template<class Size>
+        Size sort_depth_limit(Size count)
+        {
+            Size res{};
+            while (count > 1)
+            {
+                count >>= 1;
+                ++res;
+            }
+
+            return 2 * res;
+        }
+
+        template<class RandomAccessIterator, class Size, class Compare>
+        void introsort_loop(RandomAccessIterator first,
+                            RandomAccessIterator last,
+                            Size depth_limit, Compare comp)
+        {
+            while (last - first > sort_threshold)
+            {
+                if (depth_limit == 0)
+                {
+                    /**
+                     * The partitioning is degenerating (e.g. for
+                     * median-of-3 killer inputs), switch to heapsort
+                     * to keep the O(n log n) worst case.
+                     */
+                    make_heap(first, last, comp);
+                    sort_heap(first, last, comp);
+
+                    return;
+                }
+                --depth_limit;
+
+                auto cut = partition_pivot(first, last, comp);
+
+                // Recurse into the upper part, loop on the lower one.
+                introsort_loop(cut, last, depth_limit, comp);
+                last = cut;
+            }
+        }
+    }
+
     template<class RandomAccessIterator>
     void sort(RandomAccessIterator first, RandomAccessIterator last)
     {
@@ -700,23 +963,236 @@ namespace std
               Compare comp)
     {
         /**
-         * Note: This isn't the most effective approach,
-         *       but since we already have these two functions
-         *       and they satisfy asymptotic limitations
-         *       imposed by the standard, we're using them at
-         *       the moment. Might be good to change it to qsort
-         *       or merge sort later.
+         * Introspective sort: quicksort that leaves small
+         * partitions unsorted and switches to heapsort when
+         * the recursion gets too deep. The final pass of
+         * insertion sort only moves elements within these
+         * small partitions, so it is linear.
          */
+        auto count = last - first;
+        if (count < 2)
+            return;
 
-        make_heap(first, last, comp);
-        sort_heap(first, last, comp);
+        aux::introsort_loop(first, last, aux::sort_depth_limit(count), comp);
+        aux::insertion_sort(first, last, comp);
     }
 
     /**
      * 25.4.1.2, stable_sort:
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator lower_bound(ForwardIterator, ForwardIterator,
+                                const T&, Compare);
+
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator upper_bound(ForwardIterator, ForwardIterator,
+                                const T&, Compare);
+
+    namespace aux
+    {
+        /**
+         * Uninitialized storage used by the merging algorithms,
+         * elements are constructed in it only during a merge.
+         */
+        template<class T>
+        class merge_buffer
+        {
+            public:
+                merge_buffer(ptrdiff_t size)
+                    : data_{}, size_{}
+                {
+                    if (size > 0)
+                    {
+                        data_ = static_cast<T*>(
+                            ::operator new(size * sizeof(T), nothrow)
+                        );
+                    }
+
+                    if (data_)
+                        size_ = size;
+                }
+
+                ~merge_buffer()
+                {
+                    ::operator delete(data_);
+                }
+
+                merge_buffer(const merge_buffer&) = delete;
+                merge_buffer& operator=(const merge_buffer&) = delete;
+
+                T* data() const noexcept
+                {
+                    return data_;
+                }
+
+                ptrdiff_t size() const noexcept
+                {
+                    return size_;
+                }
+
+            private:
+                T* data_;
+                ptrdiff_t size_;
+        };
+
+        /**
+         * Merges the sorted ranges [first, middle) and [middle, last)
+         * using a buffer that can hold at least the first of them.
+         */
+        template<class BidirectionalIterator, class T, class Compare>
+        void merge_with_buffer(BidirectionalIterator first,
+                               BidirectionalIterator middle,
+                               BidirectionalIterator last,
+                               T* buffer, Compare comp)
+        {
+            T* buf_first = buffer;
+            T* buf_last = buffer;
+            for (auto it = first; it != middle; ++it, ++buf_last)
+                ::new(static_cast<void*>(buf_last)) T(move(*it));
+
+            auto out = first;
+            auto in = middle;
+            auto buf = buf_first;
+            while (buf != buf_last && in != last)
+            {
+                // Prefer the left element on ties to keep stability.
+                if (comp(*in, *buf))
+                    *out++ = move(*in++);
+                else
+                    *out++ = move(*buf++);
+            }
+
+            // Whatever is left of [middle, last) is already in place.
+            while (buf != buf_last)
+                *out++ = move(*buf++);
+
+            for (auto it = buf_first; it != buf_last; ++it)
+                it->~T();
+        }
+
+        /**
+         * Fallback used if we fail to allocate the buffer,
+         * O(n log n) merge based on rotations.
+         */
+        template<class BidirectionalIterator, class Distance, class Compare>
+        void merge_without_buffer(BidirectionalIterator first,
+                                  BidirectionalIterator middle,
+                                  BidirectionalIterator last,
+                                  Distance len1, Distance len2,
+                                  Compare comp)
+        {
+            if (len1 == 0 || len2 == 0)
+                return;
+
+            if (len1 + len2 == 2)
+            {
+                if (comp(*middle, *first))
+                    iter_swap(first, middle);
+
+                return;
+            }
+
+            auto first_cut = first;
+            auto second_cut = middle;
+            Distance len11{};
+            Distance len22{};
+
+            if (len1 > len2)
+            {
+                len11 = len1 / 2;
+                advance(first_cut, len11);
+                second_cut = lower_bound(middle, last, *first_cut, comp);
+                len22 = distance(middle, second_cut);
+            }
+            else
+            {
+                len22 = len2 / 2;
+                advance(second_cut, len22);
+                first_cut = upper_bound(first, middle, *second_cut, comp);
+                len11 = distance(first, first_cut);
+            }
+
+            auto new_middle = rotate(first_cut, middle, second_cut);
+            merge_without_buffer(first, first_cut, new_middle,
+                                 len11, len22, comp);
+            merge_without_buffer(new_middle, second_cut, last,
+                                 len1 - len11, len2 - len22, comp);
+        }
+
+        template<class BidirectionalIterator, class Distance, class T, class Compare>
+        void merge_adaptive(BidirectionalIterator first,
+                            BidirectionalIterator middle,
+                            BidirectionalIterator last,
+                            Distance len1, Distance len2,
+                            const merge_buffer<T>& buffer,
+                            Compare comp)
+        {
+            if (len1 <= buffer.size())
+                merge_with_buffer(first, middle, last, buffer.data(), comp);
+            else
+                merge_without_buffer(first, middle, last, len1, len2, comp);
+        }
+
+        template<class RandomAccessIterator, class T, class Compare>
+        void merge_sort(RandomAccessIterator first,
+                        RandomAccessIterator last,
+                        const merge_buffer<T>& buffer,
+                        Compare comp)
+        {
+            auto count = last - first;
+            if (count <= sort_threshold)
+            {
+                insertion_sort(first, last, comp);
+
+                return;
+            }
+
+            auto middle = first + count / 2;
+            merge_sort(first, middle, buffer, comp);
+            merge_sort(middle, last, buffer, comp);
+
+            // Already in order, common for partially sorted inputs.
+            if (!comp(*middle, *(middle - 1)))
+                return;
+
+            merge_adaptive(first, middle, last, middle - first,
+                           last - middle, buffer, comp);
+        }
+    }
+
+    template<class RandomAccessIterator>
+    void stable_sort(RandomAccessIterator first, RandomAccessIterator last)
+    {
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
+
+        stable_sort(first, last, less<value_type>{});
+    }
+
+    template<class RandomAccessIterator, class Compare>
+    void stable_sort(RandomAccessIterator first, RandomAccessIterator last,
+                     Compare comp)
+    {
+        using value_type = typename iterator_traits<RandomAccessIterator>::value_type;
+
+        auto count = last - first;
+        if (count < 2)
+            return;
+
+        if (count <= aux::sort_threshold)
+        {
+            aux::insertion_sort(first, last, comp);
+
+            return;
+        }
+
+        /**
+         * Only the left half of a merged range is moved
+         * to the buffer, so half of the size is enough.
+         */
+        aux::merge_buffer<value_type> buffer{(count + 1) / 2};
+        aux::merge_sort(first, last, buffer, comp);
+    }
 
     /**
      * 25.4.1.3, partial_sort:
@@ -734,6 +1210,12 @@ namespace std
      * 25.4.1.5, is_sorted:
      */
 
+    template<class ForwardIterator>
+    ForwardIterator is_sorted_until(ForwardIterator, ForwardIterator);
+
+    template<class ForwardIterator, class Comp>
+    ForwardIterator is_sorted_until(ForwardIterator, ForwardIterator, Comp);
+
     template<class ForwardIterator>
     bool is_sorted(ForwardIterator first, ForwardIterator last)
     {
@@ -750,29 +1232,22 @@ namespace std
     template<class ForwardIterator>
     ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last)
     {
-        if (distance(first, last) < 2)
-            return last;
-
-        while (first != last)
-        {
-            if (*first > *(++first))
-                return first;
-        }
-
-        return last;
+        return is_sorted_until(first, last, aux::less_op{});
     }
 
     template<class ForwardIterator, class Comp>
     ForwardIterator is_sorted_until(ForwardIterator first, ForwardIterator last,
                                     Comp comp)
     {
-        if (distance(first, last) < 2)
+        if (first == last)
             return last;
 
-        while (first != last)
+        auto prev = first;
+        while (++first != last)
         {
-            if (!comp(*first, *(++first)))
+            if (comp(*first, *prev))
                 return first;
+            prev = first;
         }
 
         return last;
@@ -792,13 +1267,69 @@ namespace std
      * 25.4.3.1, lower_bound
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class T>
+    ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value)
+    {
+        return lower_bound(first, last, value, aux::less_op{});
+    }
+
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator lower_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value, Compare comp)
+    {
+        auto count = distance(first, last);
+        while (count > 0)
+        {
+            auto step = count / 2;
+            auto it = first;
+            advance(it, step);
+
+            if (comp(*it, value))
+            {
+                first = ++it;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+
+        return first;
+    }
 
     /**
      * 25.4.3.2, upper_bound
      */
 
-    // TODO: implement
+    template<class ForwardIterator, class T>
+    ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value)
+    {
+        return upper_bound(first, last, value, aux::less_op{});
+    }
+
+    template<class ForwardIterator, class T, class Compare>
+    ForwardIterator upper_bound(ForwardIterator first, ForwardIterator last,
+                                const T& value, Compare comp)
+    {
+        auto count = distance(first, last);
+        while (count > 0)
+        {
+            auto step = count / 2;
+            auto it = first;
+            advance(it, step);
+
+            if (!comp(value, *it))
+            {
+                first = ++it;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+
+        return first;
+    }
 
     /**
      * 25.4.3.3, equal_range:
@@ -816,7 +1347,52 @@ namespace std
      * 25.4.4, merge:
      */
 
-    // TODO: implement
+    template<class InputIterator1, class InputIterator2,
+             class OutputIterator, class Compare>
+    OutputIterator merge(InputIterator1 first1, InputIterator1 last1,
+                         InputIterator2 first2, InputIterator2 last2,
+                         OutputIterator result, Compare comp)
+    {
+        while (first1 != last1 && first2 != last2)
+        {
+            if (comp(*first2, *first1))
+                *result++ = *first2++;
+            else
+                *result++ = *first1++;
+        }
+
+        return copy(first2, last2, copy(first1, last1, result));
+    }
+
+    template<class InputIterator1, class InputIterator2, class OutputIterator>
+    OutputIterator merge(InputIterator1 first1, InputIterator1 last1,
+                         InputIterator2 first2, InputIterator2 last2,
+                         OutputIterator result)
+    {
+        return merge(first1, last1, first2, last2, result, aux::less_op{});
+    }
+
+    template<class BidirectionalIterator, class Compare>
+    void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
+                       BidirectionalIterator last, Compare comp)
+    {
+        using value_type = typename iterator_traits<BidirectionalIterator>::value_type;
+
+        auto len1 = distance(first, middle);
+        auto len2 = distance(middle, last);
+        if (len1 == 0 || len2 == 0)
+            return;
+
+        aux::merge_buffer<value_type> buffer{len1};
+        aux::merge_adaptive(first, middle, last, len1, len2, buffer, comp);
+    }
+
+    template<class BidirectionalIterator>
+    void inplace_merge(BidirectionalIterator first, BidirectionalIterator middle,
+                       BidirectionalIterator last)
+    {
+        inplace_merge(first, middle, last, aux::less_op{});
+    }
 
     /**
      * 25.4.5, set operations on sorted structures:
@@ -881,35 +1457,27 @@ namespace std
                               Size idx, Size count, Compare comp)
         {
             using aux::heap_left_child;
-            using aux::heap_right_child;
 
-            auto left = heap_left_child(idx);
-            auto right = heap_right_child(idx);
-
-            bool left_incorrect{comp(first[idx], first[left])};
-            bool right_incorrect{comp(first[idx], first[right])};
-            while ((left < count && left_incorrect) ||
-                   (right < count && right_incorrect))
+            /**
+             * Sift the element down by moving the bigger child
+             * into the hole until the element fits.
+             */
+            auto val = move(first[idx]);
+            auto child = heap_left_child(idx);
+            while (child < count)
             {
-                if (right >= count || (left_incorrect && comp(first[right], first[left])))
-                {
-                    swap(first[idx], first[left]);
-
-                    idx = left;
-                }
-                else if (right < count && right_incorrect)
-                {
-                    swap(first[idx], first[right]);
+                if (child + 1 < count && comp(first[child], first[child + 1]))
+                    ++child;
 
-                    idx = right;
-                } // Else should not happen because of the while condition.
+                if (!comp(val, first[child]))
+                    break;
 
-                left = heap_left_child(idx);
-                right = heap_right_child(idx);
-
-                left_incorrect = comp(first[idx], first[left]);
-                right_incorrect = comp(first[idx], first[right]);
+                first[idx] = move(first[child]);
+                idx = child;
+                child = heap_left_child(idx);
             }
+
+            first[idx] = move(val);
         }
     }
 
@@ -971,7 +1539,7 @@ namespace std
             return;
 
         swap(first[0], first[count - 1]);
-        aux::correct_children(first, decltype(count){}, count - 2, comp);
+        aux::correct_children(first, decltype(count){}, count - 1, comp);
     }
 
     /**
@@ -996,7 +1564,7 @@ namespace std
         if (count <= 1)
             return;
 
-        for (auto i = count; i > 0; --i)
+        for (auto i = count / 2; i > 0; --i)
         {
             auto idx = i - 1;
 
@@ -1115,7 +1683,7 @@ namespace std
          */
         return lexicographical_compare(
             first1, last1, first2, last2,
-            less<void>{}
+            aux::less_op{}
         );
     }
 
@@ -29,6 +29,896 @@
 #ifndef LIBCPP_BITS_ATOMIC
 #define LIBCPP_BITS_ATOMIC
 
-#error "<atomic> is not implemented"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Note: All operations are implemented using the __atomic_*
+ *       builtins, which are available in both g++ and clang++.
+ *       Since we do not have libatomic, types whose size does not
+ *       allow lock-free access on the target architecture are
+ *       guarded by a small per-object spinlock instead of relying
+ *       on the compiler to emit library calls.
+ */
+
+/**
+ * 29.4, lock-free property:
+ */
+
+#define LIBCPP_ATOMIC_LOCK_FREE(val) ((val) == 2 ? 2 : 0)
+
+#define ATOMIC_BOOL_LOCK_FREE     LIBCPP_ATOMIC_LOCK_FREE(__GCC_ATOMIC_BOOL_LOCK_FREE)
+#define ATOMIC_CHAR_LOCK_FREE     LIBCPP_ATOMIC_LOCK_FREE(__GCC_ATOMIC_CHAR_LOCK_FREE)
+#define ATOMIC_CHAR16_T_LOCK_FREE LIBCPP_ATOMIC_LOCK_FREE(__GCC_ATOMIC_CHAR16_T_LOCK_FREE)
+#define ATOMIC_CHAR32_T_LOCK_FREE LIBCPP_ATOMIC_LOCK_FREE(__GCC_ATOMIC_CHAR32_T_LOCK_FREE)
+#define ATOMIC_WCHAR_T_LOCK_FREE  LIBCPP_ATOMIC_LOCK_FREE(__GCC_ATOMIC_WCHAR_T_LOCK_FREE)
+#define ATOMIC_SHORT_LOCK_FREE    LIBCPP_ATOMIC_LOCK_FREE(__GCC_ATOMIC_SHORT_LOCK_FREE)
+#define ATOMIC_INT_LOCK_FREE      LIBCPP_ATOMIC_LOCK_FREE(__GCC_ATOMIC_INT_LOCK_FREE)
+#define ATOMIC_LONG_LOCK_FREE     LIBCPP_ATOMIC_LOCK_FREE(__GCC_ATOMIC_LONG_LOCK_FREE)
+#define ATOMIC_LLONG_LOCK_FREE    LIBCPP_ATOMIC_LOCK_FREE(__GCC_ATOMIC_LLONG_LOCK_FREE)
+#define ATOMIC_POINTER_LOCK_FREE  LIBCPP_ATOMIC_LOCK_FREE(__GCC_ATOMIC_POINTER_LOCK_FREE)
+
+/**
+ * 29.6.5, requirements for operations on atomic types:
+ */
+
+#define ATOMIC_VAR_INIT(value) {value}
+
+/**
+ * 29.7, flag type and operations:
+ */
+
+#define ATOMIC_FLAG_INIT {false}
+
+namespace std
+{
+    /**
+     * 29.3, order and consistency:
+     */
+
+    enum memory_order
+    {
+        memory_order_relaxed = __ATOMIC_RELAXED,
+        memory_order_consume = __ATOMIC_CONSUME,
+        memory_order_acquire = __ATOMIC_ACQUIRE,
+        memory_order_release = __ATOMIC_RELEASE,
+        memory_order_acq_rel = __ATOMIC_ACQ_REL,
+        memory_order_seq_cst = __ATOMIC_SEQ_CST
+    };
+
+    template<class T>
+    T kill_dependency(T y) noexcept
+    {
+        return y;
+    }
+
+    namespace aux
+    {
+        /**
+         * The failure ordering of a compare and exchange
+         * operation cannot contain a release part, so when
+         * the user supplies a single ordering, we strip it.
+         */
+        constexpr memory_order cas_failure_order(memory_order order) noexcept
+        {
+            if (order == memory_order_acq_rel)
+                return memory_order_acquire;
+            else if (order == memory_order_release)
+                return memory_order_relaxed;
+            else
+                return order;
+        }
+
+        template<class T>
+        constexpr size_t atomic_alignment() noexcept
+        {
+            /**
+             * Lock-free access requires natural alignment
+             * of the accessed object, which might be bigger
+             * than the alignment of the type itself (e.g.
+             * structs of two uint32_t on 64bit architectures).
+             */
+            constexpr size_t size = sizeof(T);
+            if (size <= 16 && (size & (size - 1)) == 0 && size > alignof(T))
+                return size;
+            else
+                return alignof(T);
+        }
+
+        template<class T>
+        inline constexpr bool atomic_always_lock_free =
+            __atomic_always_lock_free(sizeof(T), 0);
+
+        /**
+         * Used for types that cannot be accessed atomically
+         * on a given architecture. The critical sections are
+         * just a couple of instructions long and never block
+         * or yield, so spinning is cheaper than involving
+         * the fibril synchronization primitives.
+         */
+        class atomic_spinlock
+        {
+            public:
+                void lock() const volatile noexcept
+                {
+                    while (__atomic_test_and_set(&flag_, __ATOMIC_ACQUIRE))
+                    {
+                        while (__atomic_load_n(&flag_, __ATOMIC_RELAXED))
+                        { /* DUMMY BODY */ }
+                    }
+                }
+
+                void unlock() const volatile noexcept
+                {
+                    __atomic_clear(&flag_, __ATOMIC_RELEASE);
+                }
+
+            private:
+                mutable bool flag_{false};
+        };
+
+        template<class T, bool = atomic_always_lock_free<T>>
+        class atomic_storage
+        {
+            public:
+                static constexpr bool is_always_lock_free = true;
+
+                atomic_storage() noexcept = default;
+
+                constexpr atomic_storage(T val) noexcept
+                    : value_{val}
+                { /* DUMMY BODY */ }
+
+                T load(memory_order order) const volatile noexcept
+                {
+                    T res;
+                    __atomic_load(&value_, &res, order);
+
+                    return res;
+                }
+
+                void store(T val, memory_order order) volatile noexcept
+                {
+                    __atomic_store(&value_, &val, order);
+                }
+
+                T exchange(T val, memory_order order) volatile noexcept
+                {
+                    T res;
+                    __atomic_exchange(&value_, &val, &res, order);
+
+                    return res;
+                }
+
+                bool compare_exchange(T& expected, T desired, bool weak,
+                                      memory_order success,
+                                      memory_order failure) volatile noexcept
+                {
+                    return __atomic_compare_exchange(
+                        &value_, &expected, &desired,
+                        weak, success, failure
+                    );
+                }
+
+                template<class F>
+                T fetch_modify(F f, memory_order order) volatile noexcept
+                {
+                    T old = load(memory_order_relaxed);
+                    while (!compare_exchange(old, f(old), true, order,
+                                             memory_order_relaxed))
+                    { /* DUMMY BODY */ }
+
+                    return old;
+                }
+
+            protected:
+                alignas(atomic_alignment<T>()) T value_;
+        };
+
+        template<class T>
+        class atomic_storage<T, false>
+        {
+            public:
+                static constexpr bool is_always_lock_free = false;
+
+                atomic_storage() noexcept = default;
+
+                constexpr atomic_storage(T val) noexcept
+                    : value_{val}, lock_{}
+                { /* DUMMY BODY */ }
+
+                T load(memory_order) const volatile noexcept
+                {
+                    lock_.lock();
+                    T res = const_cast<const T&>(value_);
+                    lock_.unlock();
+
+                    return res;
+                }
+
+                void store(T val, memory_order) volatile noexcept
+                {
+                    lock_.lock();
+                    const_cast<T&>(value_) = val;
+                    lock_.unlock();
+                }
+
+                T exchange(T val, memory_order) volatile noexcept
+                {
+                    lock_.lock();
+                    T res = const_cast<T&>(value_);
+                    const_cast<T&>(value_) = val;
+                    lock_.unlock();
+
+                    return res;
+                }
+
+                bool compare_exchange(T& expected, T desired, bool,
+                                      memory_order,
+                                      memory_order) volatile noexcept
+                {
+                    bool res{};
+                    T& value = const_cast<T&>(value_);
+
+                    lock_.lock();
+                    if (__builtin_memcmp(&value, &expected, sizeof(T)) == 0)
+                    {
+                        value = desired;
+                        res = true;
+                    }
+                    else
+                        expected = value;
+                    lock_.unlock();
+
+                    return res;
+                }
+
+                template<class F>
+                T fetch_modify(F f, memory_order) volatile noexcept
+                {
+                    T& value = const_cast<T&>(value_);
+
+                    lock_.lock();
+                    T old = value;
+                    value = f(old);
+                    lock_.unlock();
+
+                    return old;
+                }
+
+            protected:
+                T value_;
+                atomic_spinlock lock_;
+        };
+
+        /**
+         * Operations common to all atomic types.
+         * Note: The standard requires both volatile and non-volatile
+         *       overloads of all member functions, but since calling
+         *       a volatile member function on a non-volatile object
+         *       is well formed, we provide only the volatile ones
+         *       (with the exception of the assignment operator, where
+         *       it would be ambiguous with the deleted copy assignment).
+         */
+        template<class T>
+        class atomic_common: public atomic_storage<T>
+        {
+            using base = atomic_storage<T>;
+
+            public:
+                using base::is_always_lock_free;
+
+                atomic_common() noexcept = default;
+
+                constexpr atomic_common(T val) noexcept
+                    : base{val}
+                { /* DUMMY BODY */ }
+
+                atomic_common(const atomic_common&) = delete;
+                atomic_common& operator=(const atomic_common&) = delete;
+                atomic_common& operator=(const atomic_common&) volatile = delete;
+
+                bool is_lock_free() const volatile noexcept
+                {
+                    return is_always_lock_free;
+                }
+
+                void store(T val, memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    base::store(val, order);
+                }
+
+                T load(memory_order order = memory_order_seq_cst) const volatile noexcept
+                {
+                    return base::load(order);
+                }
+
+                operator T() const volatile noexcept
+                {
+                    return load();
+                }
+
+                T exchange(T val, memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    return base::exchange(val, order);
+                }
+
+                bool compare_exchange_weak(T& expected, T desired,
+                                           memory_order success,
+                                           memory_order failure) volatile noexcept
+                {
+                    return base::compare_exchange(
+                        expected, desired, true, success, failure
+                    );
+                }
+
+                bool compare_exchange_strong(T& expected, T desired,
+                                             memory_order success,
+                                             memory_order failure) volatile noexcept
+                {
+                    return base::compare_exchange(
+                        expected, desired, false, success, failure
+                    );
+                }
+
+                bool compare_exchange_weak(T& expected, T desired,
+                                           memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    return base::compare_exchange(
+                        expected, desired, true,
+                        order, cas_failure_order(order)
+                    );
+                }
+
+                bool compare_exchange_strong(T& expected, T desired,
+                                             memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    return base::compare_exchange(
+                        expected, desired, false,
+                        order, cas_failure_order(order)
+                    );
+                }
+
+            protected:
+                ~atomic_common() = default;
+        };
+
+        template<class T>
+        class atomic_integral: public atomic_common<T>
+        {
+            using base = atomic_common<T>;
+
+            public:
+                atomic_integral() noexcept = default;
+
+                constexpr atomic_integral(T val) noexcept
+                    : base{val}
+                { /* DUMMY BODY */ }
+
+                T fetch_add(T arg, memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    if constexpr (base::is_always_lock_free)
+                        return __atomic_fetch_add(&this->value_, arg, order);
+                    else
+                        return this->fetch_modify([arg](T v){ return v + arg; }, order);
+                }
+
+                T fetch_sub(T arg, memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    if constexpr (base::is_always_lock_free)
+                        return __atomic_fetch_sub(&this->value_, arg, order);
+                    else
+                        return this->fetch_modify([arg](T v){ return v - arg; }, order);
+                }
+
+                T fetch_and(T arg, memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    if constexpr (base::is_always_lock_free)
+                        return __atomic_fetch_and(&this->value_, arg, order);
+                    else
+                        return this->fetch_modify([arg](T v){ return v & arg; }, order);
+                }
+
+                T fetch_or(T arg, memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    if constexpr (base::is_always_lock_free)
+                        return __atomic_fetch_or(&this->value_, arg, order);
+                    else
+                        return this->fetch_modify([arg](T v){ return v | arg; }, order);
+                }
+
+                T fetch_xor(T arg, memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    if constexpr (base::is_always_lock_free)
+                        return __atomic_fetch_xor(&this->value_, arg, order);
+                    else
+                        return this->fetch_modify([arg](T v){ return v ^ arg; }, order);
+                }
+
+                T operator++(int) volatile noexcept
+                {
+                    return fetch_add(1);
+                }
+
+                T operator--(int) volatile noexcept
+                {
+                    return fetch_sub(1);
+                }
+
+                T operator++() volatile noexcept
+                {
+                    return fetch_add(1) + 1;
+                }
+
+                T operator--() volatile noexcept
+                {
+                    return fetch_sub(1) - 1;
+                }
+
+                T operator+=(T arg) volatile noexcept
+                {
+                    return fetch_add(arg) + arg;
+                }
+
+                T operator-=(T arg) volatile noexcept
+                {
+                    return fetch_sub(arg) - arg;
+                }
+
+                T operator&=(T arg) volatile noexcept
+                {
+                    return fetch_and(arg) & arg;
+                }
+
+                T operator|=(T arg) volatile noexcept
+                {
+                    return fetch_or(arg) | arg;
+                }
+
+                T operator^=(T arg) volatile noexcept
+                {
+                    return fetch_xor(arg) ^ arg;
+                }
+
+            protected:
+                ~atomic_integral() = default;
+        };
+
+        template<class T>
+        class atomic_pointer: public atomic_common<T*>
+        {
+            using base = atomic_common<T*>;
+
+            public:
+                atomic_pointer() noexcept = default;
+
+                constexpr atomic_pointer(T* val) noexcept
+                    : base{val}
+                { /* DUMMY BODY */ }
+
+                T* fetch_add(ptrdiff_t arg, memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    /**
+                     * The builtins do not perform pointer arithmetic,
+                     * so we need to scale the argument ourselves.
+                     */
+                    if constexpr (base::is_always_lock_free)
+                        return __atomic_fetch_add(&this->value_, arg * sizeof(T), order);
+                    else
+                        return this->fetch_modify([arg](T* v){ return v + arg; }, order);
+                }
+
+                T* fetch_sub(ptrdiff_t arg, memory_order order = memory_order_seq_cst) volatile noexcept
+                {
+                    if constexpr (base::is_always_lock_free)
+                        return __atomic_fetch_sub(&this->value_, arg * sizeof(T), order);
+                    else
+                        return this->fetch_modify([arg](T* v){ return v - arg; }, order);
+                }
+
+                T* operator++(int) volatile noexcept
+                {
+                    return fetch_add(1);
+                }
+
+                T* operator--(int) volatile noexcept
+                {
+                    return fetch_sub(1);
+                }
+
+                T* operator++() volatile noexcept
+                {
+                    return fetch_add(1) + 1;
+                }
+
+                T* operator--() volatile noexcept
+                {
+                    return fetch_sub(1) - 1;
+                }
+
+                T* operator+=(ptrdiff_t arg) volatile noexcept
+                {
+                    return fetch_add(arg) + arg;
+                }
+
+                T* operator-=(ptrdiff_t arg) volatile noexcept
+                {
+                    return fetch_sub(arg) - arg;
+                }
+
+            protected:
+                ~atomic_pointer() = default;
+        };
+
+        template<class T>
+        using atomic_base_t = conditional_t<
+            is_integral_v<T> && !is_same_v<remove_cv_t<T>, bool>,
+            atomic_integral<T>,
+            atomic_common<T>
+        >;
+    }
+
+    /**
+     * 29.5, atomic types:
+     */
+
+    template<class T>
+    struct atomic: aux::atomic_base_t<T>
+    {
+        static_assert(is_trivially_copyable_v<T>,
+                      "atomic<T> requires a trivially copyable type");
+
+        using base = aux::atomic_base_t<T>;
+
+        atomic() noexcept = default;
+
+        constexpr atomic(T val) noexcept
+            : base{val}
+        { /* DUMMY BODY */ }
+
+        atomic(const atomic&) = delete;
+        atomic& operator=(const atomic&) = delete;
+        atomic& operator=(const atomic&) volatile = delete;
+
+        T operator=(T val) volatile noexcept
+        {
+            this->store(val);
+
+            return val;
+        }
+
+        T operator=(T val) noexcept
+        {
+            this->store(val);
+
+            return val;
+        }
+    };
+
+    template<class T>
+    struct atomic<T*>: aux::atomic_pointer<T>
+    {
+        using base = aux::atomic_pointer<T>;
+
+        atomic() noexcept = default;
+
+        constexpr atomic(T* val) noexcept
+            : base{val}
+        { /* DUMMY BODY */ }
+
+        atomic(const atomic&) = delete;
+        atomic& operator=(const atomic&) = delete;
+        atomic& operator=(const atomic&) volatile = delete;
+
+        T* operator=(T* val) volatile noexcept
+        {
+            this->store(val);
+
+            return val;
+        }
+
+        T* operator=(T* val) noexcept
+        {
+            this->store(val);
+
+            return val;
+        }
+    };
+
+    /**
+     * 29.5, named atomic types:
+     */
+
+    using atomic_bool   = atomic<bool>;
+    using atomic_char   = atomic<char>;
+    using atomic_schar  = atomic<signed char>;
+    using atomic_uchar  = atomic<unsigned char>;
+    using atomic_short  = atomic<short>;
+    using atomic_ushort = atomic<unsigned short>;
+    using atomic_int    = atomic<int>;
+    using atomic_uint   = atomic<unsigned int>;
+    using atomic_long   = atomic<long>;
+    using atomic_ulong  = atomic<unsigned long>;
+    using atomic_llong  = atomic<long long>;
+    using atomic_ullong = atomic<unsigned long long>;
+
+    using atomic_char16_t = atomic<char16_t>;
+    using atomic_char32_t = atomic<char32_t>;
+    using atomic_wchar_t  = atomic<wchar_t>;
+
+    using atomic_int8_t   = atomic<int8_t>;
+    using atomic_uint8_t  = atomic<uint8_t>;
+    using atomic_int16_t  = atomic<int16_t>;
+    using atomic_uint16_t = atomic<uint16_t>;
+    using atomic_int32_t  = atomic<int32_t>;
+    using atomic_uint32_t = atomic<uint32_t>;
+    using atomic_int64_t  = atomic<int64_t>;
+    using atomic_uint64_t = atomic<uint64_t>;
+
+    using atomic_int_least8_t   = atomic<int_least8_t>;
+    using atomic_uint_least8_t  = atomic<uint_least8_t>;
+    using atomic_int_least16_t  = atomic<int_least16_t>;
+    using atomic_uint_least16_t = atomic<uint_least16_t>;
+    using atomic_int_least32_t  = atomic<int_least32_t>;
+    using atomic_uint_least32_t = atomic<uint_least32_t>;
+    using atomic_int_least64_t  = atomic<int_least64_t>;
+    using atomic_uint_least64_t = atomic<uint_least64_t>;
+
+    using atomic_int_fast8_t   = atomic<int_fast8_t>;
+    using atomic_uint_fast8_t  = atomic<uint_fast8_t>;
+    using atomic_int_fast16_t  = atomic<int_fast16_t>;
+    using atomic_uint_fast16_t = atomic<uint_fast16_t>;
+    using atomic_int_fast32_t  = atomic<int_fast32_t>;
+    using atomic_uint_fast32_t = atomic<uint_fast32_t>;
+    using atomic_int_fast64_t  = atomic<int_fast64_t>;
+    using atomic_uint_fast64_t = atomic<uint_fast64_t>;
+
+    using atomic_intptr_t  = atomic<intptr_t>;
+    using atomic_uintptr_t = atomic<uintptr_t>;
+    using atomic_size_t    = atomic<size_t>;
+    using atomic_ptrdiff_t = atomic<ptrdiff_t>;
+    using atomic_intmax_t  = atomic<intmax_t>;
+    using atomic_uintmax_t = atomic<uintmax_t>;
+
+    /**
+     * 29.6, operations on atomic types:
+     */
+
+    template<class T>
+    bool atomic_is_lock_free(const volatile atomic<T>* obj) noexcept
+    {
+        return obj->is_lock_free();
+    }
+
+    template<class T>
+    void atomic_init(volatile atomic<T>* obj, T val) noexcept
+    {
+        obj->store(val, memory_order_relaxed);
+    }
+
+    template<class T>
+    void atomic_store(volatile atomic<T>* obj, T val) noexcept
+    {
+        obj->store(val);
+    }
+
+    template<class T>
+    void atomic_store_explicit(volatile atomic<T>* obj, T val,
+                               memory_order order) noexcept
+    {
+        obj->store(val, order);
+    }
+
+    template<class T>
+    T atomic_load(const volatile atomic<T>* obj) noexcept
+    {
+        return obj->load();
+    }
+
+    template<class T>
+    T atomic_load_explicit(const volatile atomic<T>* obj,
+                           memory_order order) noexcept
+    {
+        return obj->load(order);
+    }
+
+    template<class T>
+    T atomic_exchange(volatile atomic<T>* obj, T val) noexcept
+    {
+        return obj->exchange(val);
+    }
+
+    template<class T>
+    T atomic_exchange_explicit(volatile atomic<T>* obj, T val,
+                               memory_order order) noexcept
+    {
+        return obj->exchange(val, order);
+    }
+
+    template<class T>
+    bool atomic_compare_exchange_weak(volatile atomic<T>* obj,
+                                      T* expected, T desired) noexcept
+    {
+        return obj->compare_exchange_weak(*expected, desired);
+    }
+
+    template<class T>
+    bool atomic_compare_exchange_strong(volatile atomic<T>* obj,
+                                        T* expected, T desired) noexcept
+    {
+        return obj->compare_exchange_strong(*expected, desired);
+    }
+
+    template<class T>
+    bool atomic_compare_exchange_weak_explicit(volatile atomic<T>* obj,
+                                               T* expected, T desired,
+                                               memory_order success,
+                                               memory_order failure) noexcept
+    {
+        return obj->compare_exchange_weak(*expected, desired, success, failure);
+    }
+
+    template<class T>
+    bool atomic_compare_exchange_strong_explicit(volatile atomic<T>* obj,
+                                                 T* expected, T desired,
+                                                 memory_order success,
+                                                 memory_order failure) noexcept
+    {
+        return obj->compare_exchange_strong(*expected, desired, success, failure);
+    }
+
+    /**
+     * Note: The following templates accept both the integral
+     *       and the pointer specializations, the argument type
+     *       is deduced from the member function itself.
+     */
+
+    template<class A, class U>
+    auto atomic_fetch_add(volatile A* obj, U arg) noexcept
+        -> decltype(obj->fetch_add(arg))
+    {
+        return obj->fetch_add(arg);
+    }
+
+    template<class A, class U>
+    auto atomic_fetch_add_explicit(volatile A* obj, U arg,
+                                   memory_order order) noexcept
+        -> decltype(obj->fetch_add(arg, order))
+    {
+        return obj->fetch_add(arg, order);
+    }
+
+    template<class A, class U>
+    auto atomic_fetch_sub(volatile A* obj, U arg) noexcept
+        -> decltype(obj->fetch_sub(arg))
+    {
+        return obj->fetch_sub(arg);
+    }
+
+    template<class A, class U>
+    auto atomic_fetch_sub_explicit(volatile A* obj, U arg,
+                                   memory_order order) noexcept
+        -> decltype(obj->fetch_sub(arg, order))
+    {
+        return obj->fetch_sub(arg, order);
+    }
+
+    template<class A, class U>
+    auto atomic_fetch_and(volatile A* obj, U arg) noexcept
+        -> decltype(obj->fetch_and(arg))
+    {
+        return obj->fetch_and(arg);
+    }
+
+    template<class A, class U>
+    auto atomic_fetch_and_explicit(volatile A* obj, U arg,
+                                   memory_order order) noexcept
+        -> decltype(obj->fetch_and(arg, order))
+    {
+        return obj->fetch_and(arg, order);
+    }
+
+    template<class A, class U>
+    auto atomic_fetch_or(volatile A* obj, U arg) noexcept
+        -> decltype(obj->fetch_or(arg))
+    {
+        return obj->fetch_or(arg);
+    }
+
+    template<class A, class U>
+    auto atomic_fetch_or_explicit(volatile A* obj, U arg,
+                                  memory_order order) noexcept
+        -> decltype(obj->fetch_or(arg, order))
+    {
+        return obj->fetch_or(arg, order);
+    }
+
+    template<class A, class U>
+    auto atomic_fetch_xor(volatile A* obj, U arg) noexcept
+        -> decltype(obj->fetch_xor(arg))
+    {
+        return obj->fetch_xor(arg);
+    }
+
+    template<class A, class U>
+    auto atomic_fetch_xor_explicit(volatile A* obj, U arg,
+                                   memory_order order) noexcept
+        -> decltype(obj->fetch_xor(arg, order))
+    {
+        return obj->fetch_xor(arg, order);
+    }
+
+    /**
+     * 29.7, flag type and operations:
+     */
+
+    struct atomic_flag
+    {
+        atomic_flag() noexcept = default;
+
+        /**
+         * Note: This is not required by the standard,
+         *       but it allows ATOMIC_FLAG_INIT to be
+         *       a simple braced initializer.
+         */
+        constexpr atomic_flag(bool val) noexcept
+            : flag_{val}
+        { /* DUMMY BODY */ }
+
+        atomic_flag(const atomic_flag&) = delete;
+        atomic_flag& operator=(const atomic_flag&) = delete;
+        atomic_flag& operator=(const atomic_flag&) volatile = delete;
+
+        bool test_and_set(memory_order order = memory_order_seq_cst) volatile noexcept
+        {
+            return __atomic_test_and_set(&flag_, order);
+        }
+
+        void clear(memory_order order = memory_order_seq_cst) volatile noexcept
+        {
+            __atomic_clear(&flag_, order);
+        }
+
+        private:
+            bool flag_;
+    };
+
+    inline bool atomic_flag_test_and_set(volatile atomic_flag* flag) noexcept
+    {
+        return flag->test_and_set();
+    }
+
+    inline bool atomic_flag_test_and_set_explicit(volatile atomic_flag* flag,
+                                                  memory_order order) noexcept
+    {
+        return flag->test_and_set(order);
+    }
+
+    inline void atomic_flag_clear(volatile atomic_flag* flag) noexcept
+    {
+        flag->clear();
+    }
+
+    inline void atomic_flag_clear_explicit(volatile atomic_flag* flag,
+                                           memory_order order) noexcept
+    {
+        flag->clear(order);
+    }
+
+    /**
+     * 29.8, fences:
+     */
+
+    inline void atomic_thread_fence(memory_order order) noexcept
+    {
+        __atomic_thread_fence(order);
+    }
+
+    inline void atomic_signal_fence(memory_order order) noexcept
+    {
+        __atomic_signal_fence(order);
+    }
+}
 
 #endif
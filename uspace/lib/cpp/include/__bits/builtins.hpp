@@ -71,6 +71,30 @@ namespace std::aux
         );
     }
 
+    template<class T>
+    constexpr double exp(T val)
+    {
+        return __builtin_exp(static_cast<double>(val));
+    }
+
+    template<class T>
+    constexpr double log(T val)
+    {
+        return __builtin_log(static_cast<double>(val));
+    }
+
+    template<class T>
+    constexpr double log1p(T val)
+    {
+        return __builtin_log1p(static_cast<double>(val));
+    }
+
+    template<class T>
+    constexpr double sqrt(T val)
+    {
+        return __builtin_sqrt(static_cast<double>(val));
+    }
+
     template<class T>
     constexpr size_t ceil(T val)
     {
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#ifndef LIBCPP_BITS_CHARCONV
+#define LIBCPP_BITS_CHARCONV
+
+#include <__bits/limits.hpp>
+#include <__bits/system_error.hpp>
+#include <type_traits>
+
+namespace std
+{
+    /**
+     * 23.20, primitive numeric conversions:
+     */
+
+    enum class chars_format
+    {
+        scientific = 0x1,
+        fixed      = 0x2,
+        hex        = 0x4,
+        general    = fixed | scientific
+    };
+
+    struct to_chars_result
+    {
+        char* ptr;
+        errc ec;
+    };
+
+    struct from_chars_result
+    {
+        const char* ptr;
+        errc ec;
+    };
+
+    namespace aux
+    {
+        /**
+         * Type erased implementations (in charconv.cpp)
+         * of the integral conversions below.
+         */
+        to_chars_result to_chars_unsigned(char*, char*, unsigned long long, int);
+        to_chars_result to_chars_signed(char*, char*, long long, int);
+
+        from_chars_result from_chars_unsigned(const char*, const char*,
+                                              unsigned long long&,
+                                              unsigned long long, int);
+        from_chars_result from_chars_signed(const char*, const char*,
+                                            long long&, long long,
+                                            long long, int);
+
+        /**
+         * Formats value the way printf's %f, %e and %g (for fixed,
+         * scientific and general, respectively) would with the given
+         * precision. Negative precision requests the shortest
+         * representation that converts back to the same value
+         * of the argument's type.
+         */
+        to_chars_result to_chars_double(char*, char*, double, chars_format,
+                                        int, bool uppercase = false);
+        to_chars_result to_chars_float(char*, char*, float, chars_format,
+                                       int, bool uppercase = false);
+
+        template<class T>
+        inline constexpr bool is_charconv_integral_v =
+            is_integral_v<T> && !is_same_v<remove_cv_t<T>, bool>;
+    }
+
+    template<class T>
+    enable_if_t<aux::is_charconv_integral_v<T>, to_chars_result>
+    to_chars(char* first, char* last, T value, int base = 10)
+    {
+        if constexpr (is_signed_v<T>)
+            return aux::to_chars_signed(first, last, value, base);
+        else
+            return aux::to_chars_unsigned(first, last, value, base);
+    }
+
+    to_chars_result to_chars(char*, char*, bool, int = 10) = delete;
+
+    to_chars_result to_chars(char*, char*, float);
+    to_chars_result to_chars(char*, char*, double);
+    to_chars_result to_chars(char*, char*, long double);
+
+    to_chars_result to_chars(char*, char*, float, chars_format);
+    to_chars_result to_chars(char*, char*, double, chars_format);
+    to_chars_result to_chars(char*, char*, long double, chars_format);
+
+    to_chars_result to_chars(char*, char*, float, chars_format, int);
+    to_chars_result to_chars(char*, char*, double, chars_format, int);
+    to_chars_result to_chars(char*, char*, long double, chars_format, int);
+
+    template<class T>
+    enable_if_t<aux::is_charconv_integral_v<T>, from_chars_result>
+    from_chars(const char* first, const char* last, T& value, int base = 10)
+    {
+        from_chars_result res{};
+        if constexpr (is_signed_v<T>)
+        {
+            long long tmp{};
+            res = aux::from_chars_signed(
+                first, last, tmp, numeric_limits<T>::min(),
+                numeric_limits<T>::max(), base
+            );
+
+            if (res.ec == errc{})
+                value = static_cast<T>(tmp);
+        }
+        else
+        {
+            unsigned long long tmp{};
+            res = aux::from_chars_unsigned(
+                first, last, tmp, numeric_limits<T>::max(), base
+            );
+
+            if (res.ec == errc{})
+                value = static_cast<T>(tmp);
+        }
+
+        return res;
+    }
+
+    from_chars_result from_chars(const char*, const char*, float&,
+                                 chars_format = chars_format::general);
+    from_chars_result from_chars(const char*, const char*, double&,
+                                 chars_format = chars_format::general);
+    from_chars_result from_chars(const char*, const char*, long double&,
+                                 chars_format = chars_format::general);
+}
+
+#endif
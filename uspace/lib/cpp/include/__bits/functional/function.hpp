@@ -30,6 +30,7 @@
 #define LIBCPP_BITS_FUNCTIONAL_FUNCTION
 
 #include <__bits/functional/conditional_function_typedefs.hpp>
+#include <__bits/functional/invoke.hpp>
 #include <__bits/functional/reference_wrapper.hpp>
 #include <__bits/memory/allocator_arg.hpp>
 #include <__bits/memory/allocator_traits.hpp>
@@ -43,6 +44,12 @@ namespace std
      * 20.9.12, polymorphic function adaptors:
      */
 
+    // TODO: implement
+    class bad_function_call;
+
+    template<class>
+    class function; // undefined
+
     namespace aux
     {
         // TODO: fix this
@@ -61,39 +68,138 @@ namespace std
         /* struct is_callable: is_callable_impl<void_t<>, T> */
         /* { /1* DUMMY BODY *1/ }; */
 
-        template<class Callable, class R, class... Args>
-        R invoke_callable(Callable* clbl, Args&&... args)
+        /**
+         * Storage of the target of a std::function. Small targets
+         * (function pointers, member function pointers and lambdas
+         * capturing a couple of references or scalars) are constructed
+         * directly in the buffer, larger ones are allocated on the heap
+         * and only the pointer is kept here.
+         */
+        union function_storage
+        {
+            void* ptr;
+            alignas(void*) alignas(double) uint8_t buffer[3 * sizeof(void*)];
+        };
+
+        enum class function_op
+        {
+            clone, move, destroy, type
+        };
+
+        /**
+         * Note: Targets whose move constructor can throw are always
+         *       allocated so that moving and swapping function objects
+         *       can only exchange pointers.
+         */
+        template<class F>
+        struct function_is_local
+            : integral_constant<
+                bool,
+                sizeof(F) <= sizeof(function_storage) &&
+                alignof(function_storage) % alignof(F) == 0 &&
+                noexcept(F(declval<F&&>()))
+            >
+        { /* DUMMY BODY */ };
+
+        template<class F, bool = function_is_local<F>::value>
+        struct function_manager
+        {
+            static F* get(const function_storage& storage)
+            {
+                return (F*)const_cast<uint8_t*>(storage.buffer);
+            }
+
+            static void create(function_storage& storage, F&& f)
+            {
+                new(storage.buffer) F(move(f));
+            }
+
+            static const type_info* manage(function_op op, function_storage& to,
+                                           const function_storage& from)
+            {
+                switch (op)
+                {
+                    case function_op::clone:
+                        new(to.buffer) F(*get(from));
+                        break;
+                    case function_op::move:
+                        new(to.buffer) F(move(*get(from)));
+                        get(from)->~F();
+                        break;
+                    case function_op::destroy:
+                        get(to)->~F();
+                        break;
+                    case function_op::type:
+                        return &typeid(F);
+                }
+
+                return nullptr;
+            }
+        };
+
+        template<class F>
+        struct function_manager<F, false>
         {
-            return (*clbl)(forward<Args>(args)...);
+            static F* get(const function_storage& storage)
+            {
+                return static_cast<F*>(storage.ptr);
+            }
+
+            static void create(function_storage& storage, F&& f)
+            {
+                storage.ptr = new F(move(f));
+            }
+
+            static const type_info* manage(function_op op, function_storage& to,
+                                           const function_storage& from)
+            {
+                switch (op)
+                {
+                    case function_op::clone:
+                        to.ptr = new F(*get(from));
+                        break;
+                    case function_op::move:
+                        to.ptr = from.ptr;
+                        break;
+                    case function_op::destroy:
+                        delete get(to);
+                        break;
+                    case function_op::type:
+                        return &typeid(F);
+                }
+
+                return nullptr;
+            }
+        };
+
+        template<class F, class R, class... Args>
+        R invoke_callable(const function_storage& storage, Args&&... args)
+        {
+            return aux::INVOKE(*function_manager<F>::get(storage), forward<Args>(args)...);
         }
 
-        template<class Callable>
-        void copy_callable(Callable* to, Callable* from)
+        template<class F>
+        bool function_is_null(const F& f)
         {
-            new(to) Callable{*from};
+            if constexpr (is_pointer_v<F> || is_member_pointer_v<F>)
+                return f == nullptr;
+            else
+                return false;
         }
 
-        template<class Callable>
-        void destroy_callable(Callable* clbl)
+        template<class Sig>
+        bool function_is_null(const function<Sig>& f)
         {
-            if (clbl)
-                clbl->~Callable();
+            return !f;
         }
     }
 
-    // TODO: implement
-    class bad_function_call;
-
-    template<class>
-    class function; // undefined
-
     /**
-     * Note: Ideally, this implementation wouldn't
-     *       copy the target if it was a pointer to
-     *       a function, but for the simplicity of the
-     *       implementation, we do copy even in that
-     *       case for now. It would be a nice optimization
-     *       if this was changed in the future.
+     * Note: The target is kept in aux::function_storage, so
+     *       function pointers and small lambdas never touch
+     *       the heap, neither on construction nor on copy.
+     *       The only per-type state besides the target is
+     *       the pair of function pointers call_ and manage_.
      */
     template<class R, class... Args>
     class function<R(Args...)>
@@ -107,8 +213,7 @@ namespace std
              */
 
             function() noexcept
-                : callable_{}, callable_size_{}, call_{},
-                  copy_{}, dest_{}
+                : storage_{}, call_{}, manage_{}
             { /* DUMMY BODY */ }
 
             function(nullptr_t) noexcept
@@ -116,34 +221,36 @@ namespace std
             { /* DUMMY BODY */ }
 
             function(const function& other)
-                : callable_{}, callable_size_{other.callable_size_},
-                  call_{other.call_}, copy_{other.copy_}, dest_{other.dest_}
+                : storage_{}, call_{other.call_}, manage_{other.manage_}
             {
-                callable_ = new uint8_t[callable_size_];
-                (*copy_)(callable_, other.callable_);
+                if (manage_)
+                    (*manage_)(aux::function_op::clone, storage_, other.storage_);
             }
 
-            function(function&& other)
-                : callable_{other.callable_}, callable_size_{other.callable_size_},
-                  call_{other.call_}, copy_{other.copy_}, dest_{other.dest_}
+            function(function&& other) noexcept
+                : storage_{}, call_{other.call_}, manage_{other.manage_}
             {
-                other.callable_ = nullptr;
-                other.callable_size_ = size_t{};
+                if (manage_)
+                    (*manage_)(aux::function_op::move, storage_, other.storage_);
+
                 other.call_ = nullptr;
-                other.copy_ = nullptr;
-                other.dest_ = nullptr;
+                other.manage_ = nullptr;
             }
 
             // TODO: shall not participate in overloading unless aux::is_callable<F>
-            template<class F>
+            template<
+                class F,
+                class = enable_if_t<!is_same_v<F, function>>
+            >
             function(F f)
-                : callable_{}, callable_size_{sizeof(F)},
-                  call_{(call_t)aux::invoke_callable<F, R, Args...>},
-                  copy_{(copy_t)aux::copy_callable<F>},
-                  dest_{(dest_t)aux::destroy_callable<F>}
+                : function{}
             {
-                callable_ = new uint8_t[callable_size_];
-                (*copy_)(callable_, (uint8_t*)&f);
+                if (aux::function_is_null(f))
+                    return;
+
+                aux::function_manager<F>::create(storage_, move(f));
+                call_ = aux::invoke_callable<F, R, Args...>;
+                manage_ = aux::function_manager<F>::manage;
             }
 
             /**
@@ -174,7 +281,7 @@ namespace std
             // TODO: shall not participate in overloading unless aux::is_callable<F>
             template<class F, class A>
             function(allocator_arg_t, const A& a, F f)
-                : function{f}
+                : function(move(f))
             { /* DUMMY BODY */ }
 
             function& operator=(const function& rhs)
@@ -184,26 +291,20 @@ namespace std
                 return *this;
             }
 
-            /**
-             * Note: We have to copy call_, copy_
-             *       and dest_ because they can be templated
-             *       by a type F we don't know.
-             */
-            function& operator=(function&& rhs)
+            function& operator=(function&& rhs) noexcept
             {
-                clear_();
+                if (this != &rhs)
+                {
+                    clear_();
 
-                callable_ = rhs.callable_;
-                callable_size_ = rhs.callable_size_;
-                call_ = rhs.call_;
-                copy_ = rhs.copy_;
-                dest_ = rhs.dest_;
+                    if (rhs.manage_)
+                        (*rhs.manage_)(aux::function_op::move, storage_, rhs.storage_);
+                    call_ = rhs.call_;
+                    manage_ = rhs.manage_;
 
-                rhs.callable_ = nullptr;
-                rhs.callable_size_ = size_t{};
-                rhs.call_ = nullptr;
-                rhs.copy_ = nullptr;
-                rhs.dest_ = nullptr;
+                    rhs.call_ = nullptr;
+                    rhs.manage_ = nullptr;
+                }
 
                 return *this;
             }
@@ -216,31 +317,28 @@ namespace std
             }
 
             // TODO: shall not participate in overloading unless aux::is_callable<F>
-            template<class F>
+            template<
+                class F,
+                class = enable_if_t<!is_same_v<decay_t<F>, function>>
+            >
             function& operator=(F&& f)
             {
-                callable_size_ = sizeof(F);
-                callable_ = new uint8_t[callable_size_];
-                call_ = aux::invoke_callable<F, R, Args...>;
-                copy_ = aux::copy_callable<F>;
-                dest_ = aux::destroy_callable<F>;
+                function(forward<F>(f)).swap(*this);
 
-                (*copy_)(callable_, (uint8_t*)&f);
+                return *this;
             }
 
             template<class F>
             function& operator=(reference_wrapper<F> ref) noexcept
             {
-                return (*this) = ref.get();
+                function(ref).swap(*this);
+
+                return *this;
             }
 
             ~function()
             {
-                if (callable_)
-                {
-                    (*dest_)(callable_);
-                    delete[] callable_;
-                }
+                clear_();
             }
 
             /**
@@ -249,11 +347,9 @@ namespace std
 
             void swap(function& other) noexcept
             {
-                std::swap(callable_, other.callable_);
-                std::swap(callable_size_, other.callable_size_);
-                std::swap(call_, other.call_);
-                std::swap(copy_, other.copy_);
-                std::swap(dest_, other.dest_);
+                function tmp{move(other)};
+                other = move(*this);
+                *this = move(tmp);
             }
 
             template<class F, class A>
@@ -268,7 +364,7 @@ namespace std
 
             explicit operator bool() const noexcept
             {
-                return callable_ != nullptr;
+                return call_ != nullptr;
             }
 
             /**
@@ -277,11 +373,11 @@ namespace std
 
             result_type operator()(Args... args) const
             {
-                // TODO: throw bad_function_call if !callable_ || !call_
+                // TODO: throw bad_function_call if !call_
                 if constexpr (is_same_v<R, void>)
-                    (*call_)(callable_, forward<Args>(args)...);
+                    (*call_)(storage_, forward<Args>(args)...);
                 else
-                    return (*call_)(callable_, forward<Args>(args)...);
+                    return (*call_)(storage_, forward<Args>(args)...);
             }
 
             /**
@@ -290,14 +386,21 @@ namespace std
 
             const type_info& target_type() const noexcept
             {
-                return typeid(*callable_);
+                if (manage_)
+                {
+                    auto& storage = const_cast<aux::function_storage&>(storage_);
+
+                    return *(*manage_)(aux::function_op::type, storage, storage_);
+                }
+                else
+                    return typeid(void);
             }
 
             template<class T>
             T* target() noexcept
             {
-                if (target_type() == typeid(T))
-                    return (T*)callable_;
+                if (manage_ && target_type() == typeid(T))
+                    return aux::function_manager<T>::get(storage_);
                 else
                     return nullptr;
             }
@@ -305,30 +408,30 @@ namespace std
             template<class T>
             const T* target() const noexcept
             {
-                if (target_type() == typeid(T))
-                    return (T*)callable_;
+                if (manage_ && target_type() == typeid(T))
+                    return aux::function_manager<T>::get(storage_);
                 else
                     return nullptr;
             }
 
         private:
-            using call_t = R(*)(uint8_t*, Args&&...);
-            using copy_t = void (*)(uint8_t*, uint8_t*);
-            using dest_t = void (*)(uint8_t*);
+            using call_t = R(*)(const aux::function_storage&, Args&&...);
+            using manage_t = const type_info* (*)(
+                aux::function_op, aux::function_storage&,
+                const aux::function_storage&
+            );
 
-            uint8_t* callable_;
-            size_t callable_size_;
+            aux::function_storage storage_;
             call_t call_;
-            copy_t copy_;
-            dest_t dest_;
+            manage_t manage_;
 
             void clear_()
             {
-                if (callable_)
+                if (manage_)
                 {
-                    (*dest_)(callable_);
-                    delete[] callable_;
-                    callable_ = nullptr;
+                    (*manage_)(aux::function_op::destroy, storage_, storage_);
+                    call_ = nullptr;
+                    manage_ = nullptr;
                 }
             }
     };
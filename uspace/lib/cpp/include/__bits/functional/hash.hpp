@@ -31,6 +31,7 @@
 
 #include <cstdlib>
 #include <cstdint>
+#include <cstring>
 
 namespace std
 {
@@ -53,20 +54,85 @@ namespace std
             uint64_t converted;
         };
 
-        template<class T>
-        T hash_(uint64_t x) noexcept
+        inline constexpr uint64_t hash_prime1_{0x9E3779B185EBCA87ULL};
+        inline constexpr uint64_t hash_prime2_{0xC2B2AE3D27D4EB4FULL};
+        inline constexpr uint64_t hash_prime3_{0x9FB21C651E98DF25ULL};
+
+        inline constexpr uint64_t hash_rotl_(uint64_t x, int r) noexcept
+        {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        /**
+         * Note: std::hash is used for indexing in unordered
+         *       containers, not for cryptography, but the bucket
+         *       index is taken from the low bits of the hash, so
+         *       keys like pointers or multiples of the alignment
+         *       would all end up in a handful of buckets. Every
+         *       hash is therefore finished with the rrmxmx
+         *       finalizer used by xxh3, which makes each output
+         *       bit depend on every input bit.
+         */
+        inline constexpr uint64_t hash_mix(uint64_t x, uint64_t len = 0) noexcept
+        {
+            x ^= hash_rotl_(x, 49) ^ hash_rotl_(x, 24);
+            x *= hash_prime3_;
+            x ^= (x >> 35) + len;
+            x *= hash_prime3_;
+
+            return x ^ (x >> 28);
+        }
+
+        inline uint64_t hash_round_(uint64_t acc, uint64_t word) noexcept
+        {
+            acc += word * hash_prime2_;
+            acc = hash_rotl_(acc, 31);
+
+            return acc * hash_prime1_;
+        }
+
+        inline uint64_t hash_load_(const unsigned char* ptr, size_t len = 8) noexcept
         {
-            /**
-             * Note: std::hash is used for indexing in
-             *       unordered containers, not for cryptography.
-             *       Because of this, we decided to simply convert
-             *       the value to uin64_t, which will help us
-             *       with testing (since in order to create
-             *       a collision in a multiset or multimap
-             *       we simply need 2 values that congruent
-             *       by the size of the table.
-             */
-            return static_cast<T>(x);
+            uint64_t res{};
+            memcpy(&res, ptr, len);
+
+            return res;
+        }
+
+        /**
+         * Hashes a byte sequence a word at a time, with two
+         * independent accumulators for the bulk of the data
+         * so that consecutive rounds do not wait for each other.
+         */
+        inline size_t hash_bytes(const void* data, size_t len) noexcept
+        {
+            auto ptr = static_cast<const unsigned char*>(data);
+            auto rest = len;
+
+            uint64_t acc1{hash_prime1_ + hash_prime2_};
+            uint64_t acc2{hash_prime2_};
+            while (rest >= 16)
+            {
+                acc1 = hash_round_(acc1, hash_load_(ptr));
+                acc2 = hash_round_(acc2, hash_load_(ptr + 8));
+
+                ptr += 16;
+                rest -= 16;
+            }
+
+            auto acc = acc1 ^ hash_rotl_(acc2, 27);
+            if (rest >= 8)
+            {
+                acc = hash_round_(acc, hash_load_(ptr));
+
+                ptr += 8;
+                rest -= 8;
+            }
+
+            if (rest > 0)
+                acc = hash_round_(acc, hash_load_(ptr, rest));
+
+            return static_cast<size_t>(hash_mix(acc, len));
         }
 
         template<class T>
@@ -76,10 +142,30 @@ namespace std
                           "invalid type passed to aux::hash");
 
             converter<T> conv;
+            conv.converted = 0;
             conv.value = x;
 
-            return hash_<size_t>(conv.converted);
+            return static_cast<size_t>(hash_mix(conv.converted, sizeof(T)));
         }
+
+        /**
+         * Hash policy that returns the key unchanged. It is
+         * not used by std::hash, but tests can pass it to
+         * unordered containers to create collisions on purpose
+         * (all that is needed are two keys congruent modulo
+         * the bucket count).
+         */
+        template<class T>
+        struct identity_hash
+        {
+            size_t operator()(const T& x) const noexcept
+            {
+                return static_cast<size_t>(x);
+            }
+
+            using argument_type = T;
+            using result_type   = size_t;
+        };
     }
 
     template<class T>
@@ -271,7 +357,8 @@ namespace std
     {
         size_t operator()(float x) const noexcept
         {
-            return aux::hash(x);
+            // Both zeros compare equal, so they must hash equal.
+            return aux::hash(x == 0.f ? 0.f : x);
         }
 
         using argument_type = float;
@@ -283,7 +370,8 @@ namespace std
     {
         size_t operator()(double x) const noexcept
         {
-            return aux::hash(x);
+            // Both zeros compare equal, so they must hash equal.
+            return aux::hash(x == 0. ? 0. : x);
         }
 
         using argument_type = double;
@@ -295,7 +383,8 @@ namespace std
     {
         size_t operator()(long double x) const noexcept
         {
-            return aux::hash(x);
+            // Both zeros compare equal, so they must hash equal.
+            return aux::hash(x == 0.L ? 0.L : x);
         }
 
         using argument_type = long double;
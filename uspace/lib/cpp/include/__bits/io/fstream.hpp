@@ -33,7 +33,9 @@
 #include <cstdio>
 #include <ios>
 #include <iosfwd>
+#include <istream>
 #include <locale>
+#include <ostream>
 #include <streambuf>
 #include <string>
 
@@ -58,26 +60,23 @@ namespace std
 
             basic_filebuf()
                 : basic_streambuf<char_type, traits_type>{},
-                  obuf_{nullptr}, ibuf_{nullptr}, mode_{}, file_{nullptr}
+                  obuf_{nullptr}, ibuf_{nullptr}, mode_{}, file_{nullptr},
+                  buf_size_{default_buf_size_}, owns_buffers_{true}, ch_{}
             { /* DUMMY BODY */ }
 
             basic_filebuf(const basic_filebuf&) = delete;
 
             basic_filebuf(basic_filebuf&& other)
-                : mode_{other.mode_}
+                : basic_filebuf{}
             {
-                close();
-                std::swap(obuf_, other.obuf_);
-                std::swap(ibuf_, other.ibuf_);
-                std::swap(file_, other.file_);
-
-                basic_streambuf<char_type, traits_type>::swap(other);
+                swap(other);
             }
 
             virtual ~basic_filebuf()
             {
                 // TODO: exception here caught and not rethrown
                 close();
+                release_buffers_();
             }
 
             /**
@@ -99,6 +98,10 @@ namespace std
                 std::swap(mode_, rhs.mode_);
                 std::swap(obuf_, rhs.obuf_);
                 std::swap(ibuf_, rhs.ibuf_);
+                std::swap(file_, rhs.file_);
+                std::swap(buf_size_, rhs.buf_size_);
+                std::swap(owns_buffers_, rhs.owns_buffers_);
+                std::swap(ch_, rhs.ch_);
 
                 basic_streambuf<char_type, traits_type>::swap(rhs);
             }
@@ -137,10 +140,7 @@ namespace std
                     }
                 }
 
-                if (!ibuf_ && mode_is_in_(mode_))
-                    ibuf_ = new char_type[buf_size_];
-                if (!obuf_ && mode_is_out_(mode_))
-                    obuf_ = new char_type[buf_size_];
+                allocate_buffers_();
                 init_();
 
                 return this;
@@ -156,15 +156,16 @@ namespace std
                 // TODO: caught exceptions are to be rethrown after closing the file
                 if (!file_)
                     return nullptr;
-                // TODO: deallocate buffers?
 
-                if (this->output_next_ != this->output_begin_)
-                    overflow(traits_type::eof());
+                sync();
                 // TODO: unshift? (p. 1084 at the top)
 
                 fclose(file_);
                 file_ = nullptr;
 
+                this->setg(nullptr, nullptr, nullptr);
+                this->setp(nullptr, nullptr);
+
                 return this;
             }
 
@@ -176,47 +177,69 @@ namespace std
             int_type underflow() override
             {
                 // TODO: use codecvt
-                if (!mode_is_in_(mode_))
+                if (!file_ || !mode_is_in_(mode_))
+                    return traits_type::eof();
+
+                if (this->read_avail_())
+                    return traits_type::to_int_type(*this->input_next_);
+
+                if (!write_buffer_())
                     return traits_type::eof();
 
-                if (!ibuf_)
+                // Writing continues in overflow.
+                if (mode_is_out_(mode_))
+                    this->setp(nullptr, nullptr);
+
+                /**
+                 * Unlike stdin, files are not interactive, so we
+                 * can always ask for the whole buffer at once.
+                 */
+                size_t count{};
+                if (ibuf_)
                 {
-                    ibuf_ = new char_type[buf_size_];
-                    this->input_begin_ = this->input_next_ = this->input_end_ = ibuf_;
+                    count = fread(ibuf_, sizeof(char_type), buf_size_, file_);
+                    this->setg(ibuf_, ibuf_, ibuf_ + count);
                 }
-
-                off_type i{};
-                if (this->input_next_ < this->input_end_)
+                else
                 {
-                    auto idx = static_cast<off_type>(this->input_next_ - this->input_begin_);
-                    auto count = static_cast<off_type>(buf_size_) - idx;
-
-                    for (; i < count; ++i, ++idx)
-                        ibuf_[i] = ibuf_[idx];
+                    count = fread(&ch_, sizeof(char_type), 1, file_);
+                    this->setg(&ch_, &ch_, &ch_ + count);
                 }
 
-                for (; i < static_cast<off_type>(buf_size_); ++i)
-                {
-                    auto c = fgetc(file_);
-                    if (c == traits_type::eof())
-                        break;
+                if (count == 0)
+                    return traits_type::eof();
 
-                    ibuf_[i] = static_cast<char_type>(c);
+                return traits_type::to_int_type(*this->input_next_);
+            }
 
-                    if (ibuf_[i] == '\n')
-                    {
-                        ++i;
-                        break;
-                    }
+            streamsize xsgetn(char_type* s, streamsize n) override
+            {
+                if (!s || n <= 0)
+                    return 0;
+
+                streamsize count{};
+                if (this->read_avail_())
+                {
+                    count = this->input_end_ - this->input_next_;
+                    if (count > n)
+                        count = n;
+
+                    traits_type::copy(s, this->input_next_, count);
+                    this->input_next_ += count;
                 }
 
-                this->input_next_ = this->input_begin_;
-                this->input_end_ = this->input_begin_ + i;
+                if (count < n && file_ && mode_is_in_(mode_) &&
+                    static_cast<size_t>(n - count) >= buf_size_)
+                {
+                    if (!write_buffer_())
+                        return count;
 
-                if (i == 0)
-                    return traits_type::eof();
+                    return count + fread(s + count, sizeof(char_type), n - count, file_);
+                }
 
-                return traits_type::to_int_type(*this->input_next_);
+                return count + basic_streambuf<char_type, traits_type>::xsgetn(
+                    s + count, n - count
+                );
             }
 
             int_type pbackfail(int_type c = traits_type::eof()) override
@@ -251,24 +274,106 @@ namespace std
             int_type overflow(int_type c = traits_type::eof()) override
             {
                 // TODO: use codecvt
-                if (!mode_is_out_(mode_))
+                if (!file_ || !mode_is_out_(mode_))
+                    return traits_type::eof();
+
+                if (!discard_input_() || !write_buffer_())
                     return traits_type::eof();
 
-                auto count = static_cast<size_t>(this->output_next_ - this->output_begin_);
-                fwrite(obuf_, sizeof(char_type), count, file_);
-                fflush(file_);
+                if (obuf_)
+                    this->setp(obuf_, obuf_ + buf_size_);
 
-                this->output_next_ = this->output_begin_;
+                if (!traits_type::eq_int_type(c, traits_type::eof()))
+                {
+                    auto cc = traits_type::to_char_type(c);
+                    if (obuf_)
+                        *this->output_next_++ = cc;
+                    else if (fwrite(&cc, sizeof(char_type), 1, file_) != 1)
+                        return traits_type::eof();
+                }
 
                 return traits_type::not_eof(c);
             }
 
+            streamsize xsputn(const char_type* s, streamsize n) override
+            {
+                if (!s || n <= 0)
+                    return 0;
+
+                if (n <= this->epptr() - this->pptr())
+                {
+                    traits_type::copy(this->pptr(), s, n);
+                    this->pbump(static_cast<int>(n));
+
+                    return n;
+                }
+
+                if (!file_ || !mode_is_out_(mode_))
+                    return 0;
+
+                if (!discard_input_() || !write_buffer_())
+                    return 0;
+
+                if (static_cast<size_t>(n) >= buf_size_ || !obuf_)
+                    return fwrite(s, sizeof(char_type), n, file_);
+
+                this->setp(obuf_, obuf_ + buf_size_);
+                traits_type::copy(this->pptr(), s, n);
+                this->pbump(static_cast<int>(n));
+
+                return n;
+            }
+
+            /**
+             * Note: A null buffer with non-zero size sets the size
+             *       of the buffers we allocate, a null buffer with
+             *       zero size makes this filebuf unbuffered. A buffer
+             *       provided by the user is split between input
+             *       and output if we might need both.
+             */
             basic_streambuf<char_type, traits_type>*
             setbuf(char_type* s, streamsize n) override
             {
-                // TODO: implement
-                __unimplemented();
-                return nullptr;
+                if (sync() != 0)
+                    return nullptr;
+
+                release_buffers_();
+                this->setg(nullptr, nullptr, nullptr);
+                this->setp(nullptr, nullptr);
+
+                if (n <= 0 || (s && n < 2))
+                    buf_size_ = 0;
+                else if (!s)
+                    buf_size_ = static_cast<size_t>(n);
+                else
+                {
+                    owns_buffers_ = false;
+
+                    bool in = !file_ || mode_is_in_(mode_);
+                    bool out = !file_ || mode_is_out_(mode_);
+                    if (in && out)
+                    {
+                        buf_size_ = static_cast<size_t>(n / 2);
+                        ibuf_ = s;
+                        obuf_ = s + buf_size_;
+                    }
+                    else
+                    {
+                        buf_size_ = static_cast<size_t>(n);
+                        if (in)
+                            ibuf_ = s;
+                        else
+                            obuf_ = s;
+                    }
+                }
+
+                if (file_)
+                {
+                    allocate_buffers_();
+                    init_();
+                }
+
+                return this;
             }
 
             pos_type seekoff(off_type off, ios_base::seekdir dir,
@@ -289,10 +394,16 @@ namespace std
 
             int sync() override
             {
-                if (mode_is_out_(mode_))
-                    overflow();
+                if (!file_)
+                    return 0;
+
+                if (!discard_input_() || !write_buffer_())
+                    return -1;
+
+                if (mode_is_out_(mode_) && fflush(file_) != 0)
+                    return -1;
 
-                return 0; // TODO: what is the correct return value?
+                return 0;
             }
 
             void imbue(const locale& loc) override
@@ -309,7 +420,17 @@ namespace std
 
             FILE* file_;
 
-            static constexpr size_t buf_size_{128};
+            size_t buf_size_;
+            bool owns_buffers_;
+
+            /**
+             * Get area of an unbuffered filebuf.
+             */
+            char_type ch_;
+
+            static constexpr size_t default_buf_size_{
+                aux::default_stream_buffer_size / sizeof(char_type)
+            };
 
             const char* get_mode_str_(ios_base::openmode mode)
             {
@@ -365,14 +486,68 @@ namespace std
 
             void init_()
             {
-                if (ibuf_)
-                    this->input_begin_ = this->input_next_ = this->input_end_ = ibuf_;
+                this->setg(ibuf_, ibuf_, ibuf_);
 
-                if (obuf_)
+                /**
+                 * If we can read too, the put area is only set
+                 * in overflow, when the input read ahead has been
+                 * discarded and we know where the output goes.
+                 */
+                if (obuf_ && !mode_is_in_(mode_))
+                    this->setp(obuf_, obuf_ + buf_size_);
+                else
+                    this->setp(nullptr, nullptr);
+            }
+
+            void allocate_buffers_()
+            {
+                if (buf_size_ == 0 || !owns_buffers_)
+                    return;
+
+                if (!ibuf_ && mode_is_in_(mode_))
+                    ibuf_ = new char_type[buf_size_];
+                if (!obuf_ && mode_is_out_(mode_))
+                    obuf_ = new char_type[buf_size_];
+            }
+
+            void release_buffers_()
+            {
+                if (owns_buffers_)
                 {
-                    this->output_begin_ = this->output_next_ = obuf_;
-                    this->output_end_ = obuf_ + buf_size_;
+                    delete[] ibuf_;
+                    delete[] obuf_;
                 }
+
+                ibuf_ = nullptr;
+                obuf_ = nullptr;
+                owns_buffers_ = true;
+            }
+
+            bool write_buffer_()
+            {
+                auto count = static_cast<size_t>(this->pptr() - this->pbase());
+                if (count == 0)
+                    return true;
+
+                auto res = fwrite(this->pbase(), sizeof(char_type), count, file_);
+                this->setp(this->pbase(), this->epptr());
+
+                return res == count;
+            }
+
+            /**
+             * Before writing after a read, the file position has
+             * to be moved back over the input we read ahead.
+             */
+            bool discard_input_()
+            {
+                auto count = static_cast<long>(this->egptr() - this->gptr());
+                this->setg(this->eback(), this->egptr(), this->egptr());
+
+                if (count == 0)
+                    return true;
+
+                return fseek(file_, -count * static_cast<long>(sizeof(char_type)), SEEK_CUR) == 0;
             }
     };
 
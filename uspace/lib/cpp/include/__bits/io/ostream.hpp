@@ -420,15 +420,8 @@ namespace std
 
                 if (sen)
                 {
-                    for (streamsize i = 0; i < n; ++i)
-                    {
-                        auto ret = this->rdbuf()->sputc(s[i]);
-                        if (traits_type::eq_int_type(ret, traits_type::eof()))
-                        {
-                            this->setstate(ios_base::badbit);
-                            break;
-                        }
-                    }
+                    if (this->rdbuf()->sputn(s, n) != n)
+                        this->setstate(ios_base::badbit);
                 }
 
                 return *this;
@@ -675,6 +668,12 @@ namespace std
         basic_ostream<Char, Traits>& insert(basic_ostream<Char, Traits>& os,
                                             const Char* str, size_t len)
         {
+            auto put_str = [&os, str, len](){
+                auto n = static_cast<streamsize>(len);
+                if (os.rdbuf()->sputn(str, n) != n)
+                    os.setstate(ios_base::badbit);
+            };
+
             if (os.width() > 0 && static_cast<size_t>(os.width()) > len)
             {
                 size_t to_pad = (static_cast<size_t>(os.width()) - len);
@@ -683,22 +682,17 @@ namespace std
                 {
                     for (size_t i = 0; i < to_pad; ++i)
                         os.put(os.fill());
-                    for (size_t i = 0; i < len; ++i)
-                        os.put(os.widen(str[i]));
+                    put_str();
                 }
                 else
                 {
-                    for (size_t i = 0; i < len; ++i)
-                        os.put(os.widen(str[i]));
+                    put_str();
                     for (size_t i = 0; i < to_pad; ++i)
                         os.put(os.fill());
                 }
             }
             else
-            {
-                for (size_t i = 0; i < len; ++i)
-                    os.put(os.widen(str[i]));
-            }
+                put_str();
 
             os.width(0);
             return os;
@@ -72,9 +72,13 @@ namespace std
             basic_stringbuf(const basic_stringbuf&) = delete;
 
             basic_stringbuf(basic_stringbuf&& other)
-                : mode_{move(other.mode_)}, str_{move(other.str_)}
+                : mode_{move(other.mode_)}, str_{}
             {
+                auto old_base = other.str_.data();
+                str_ = move(other.str_);
+
                 basic_streambuf<char_type, traits_type>::swap(other);
+                rebase_(old_base);
             }
 
             /**
@@ -86,14 +90,21 @@ namespace std
             basic_stringbuf& operator=(basic_stringbuf&& other)
             {
                 swap(other);
+
+                return *this;
             }
 
             void swap(basic_stringbuf& rhs)
             {
+                auto old_base = str_.data();
+                auto old_rhs_base = rhs.str_.data();
+
                 std::swap(mode_, rhs.mode_);
-                std::swap(str_, rhs.str_);
+                str_.swap(rhs.str_);
 
                 basic_streambuf<char_type, traits_type>::swap(rhs);
+                rebase_(old_rhs_base);
+                rhs.rebase_(old_base);
             }
 
             /**
@@ -104,7 +115,7 @@ namespace std
             {
                 if (mode_ & ios_base::out)
                     return basic_string<char_type, traits_type, allocator_type>{
-                        this->output_begin_, this->output_next_ - 1, str_.get_allocator()
+                        this->output_begin_, this->output_next_, str_.get_allocator()
                     };
                 else if (mode_ == ios_base::in)
                     return basic_string<char_type, traits_type, allocator_type>{
@@ -127,6 +138,13 @@ namespace std
 
             int_type underflow() override
             {
+                /**
+                 * Characters written directly to the put area
+                 * are not part of the get area until now.
+                 */
+                if ((mode_ & ios_base::in) != 0 && this->input_end_ < this->output_next_)
+                    this->input_end_ = this->output_next_;
+
                 if (this->read_avail_())
                     return traits_type::to_int_type(*this->gptr());
                 else
@@ -172,11 +190,15 @@ namespace std
                         return c;
 
                     auto size = static_cast<size_t>(this->output_next_ - this->output_begin_);
+                    auto input_off = this->input_next_ - this->input_begin_;
                     str_.size_ = size;
 
                     str_.push_back(traits_type::to_char_type(c));
                     init_();
 
+                    if ((mode_ & ios_base::in) != 0)
+                        this->input_next_ += input_off;
+
                     return c;
                 }
                 else if (traits_type::eq_int_type(c, traits_type::eof()))
@@ -253,11 +275,35 @@ namespace std
             bool ensure_free_space_(size_t n = 1)
             {
                 str_.ensure_free_space_(n);
-                this->output_end_ = str_.begin() + str_.capacity();
+                this->output_end_ = str_.begin() + str_.capacity() + 1;
 
                 return true;
             }
 
+            /**
+             * Short strings keep their characters inline, so moving
+             * str_ can relocate the buffer the get and put areas
+             * point to.
+             */
+            void rebase_(const char_type* old_base)
+            {
+                auto base = str_.begin();
+                if (base == old_base)
+                    return;
+
+                auto fix = [&](char_type*& ptr){
+                    if (ptr)
+                        ptr = base + (ptr - old_base);
+                };
+
+                fix(this->input_begin_);
+                fix(this->input_next_);
+                fix(this->input_end_);
+                fix(this->output_begin_);
+                fix(this->output_next_);
+                fix(this->output_end_);
+            }
+
             pos_type seekoff_(off_type off, char_type* begin, char_type*& next, char_type* end,
                           ios_base::seekdir dir)
             {
@@ -33,6 +33,16 @@
 #include <iosfwd>
 #include <locale>
 
+namespace std::aux
+{
+    /**
+     * Default size of the buffers used by the file and
+     * standard stream buffers. Transfers of at least this
+     * size bypass the buffers and go directly to stdio.
+     */
+    inline constexpr size_t default_stream_buffer_size{64 * 1024};
+}
+
 namespace std
 {
 
@@ -214,15 +224,15 @@ namespace std
 
             void swap(basic_streambuf& rhs)
             {
-                swap(input_begin_, rhs.input_begin_);
-                swap(input_next_, rhs.input_next_);
-                swap(input_end_, rhs.input_end_);
+                std::swap(input_begin_, rhs.input_begin_);
+                std::swap(input_next_, rhs.input_next_);
+                std::swap(input_end_, rhs.input_end_);
 
-                swap(output_begin_, rhs.output_begin_);
-                swap(output_next_, rhs.output_next_);
-                swap(output_end_, rhs.output_end_);
+                std::swap(output_begin_, rhs.output_begin_);
+                std::swap(output_next_, rhs.output_next_);
+                std::swap(output_end_, rhs.output_end_);
 
-                swap(locale_, rhs.locale_);
+                std::swap(locale_, rhs.locale_);
             }
 
             /**
@@ -332,17 +342,30 @@ namespace std
 
             virtual streamsize xsgetn(char_type* s, streamsize n)
             {
-                if (!s || n == 0)
+                if (!s || n <= 0)
                     return 0;
 
                 streamsize i{0};
-                auto eof = traits_type::eof();
-                for (; i <= n; ++i)
+                while (i < n)
                 {
-                    if (!read_avail_() && traits_type::eq_int_type(uflow(), eof))
-                        break;
-
-                    *s++ = *input_next_++;
+                    if (read_avail_())
+                    {
+                        auto count = static_cast<streamsize>(input_end_ - input_next_);
+                        if (count > n - i)
+                            count = n - i;
+                        traits_type::copy(s + i, input_next_, count);
+
+                        input_next_ += count;
+                        i += count;
+                    }
+                    else
+                    {
+                        auto c = uflow();
+                        if (traits_type::eq_int_type(c, traits_type::eof()))
+                            break;
+
+                        s[i++] = traits_type::to_char_type(c);
+                    }
                 }
 
                 return i;
@@ -377,16 +400,30 @@ namespace std
 
             virtual streamsize xsputn(const char_type* s, streamsize n)
             {
-                if (!s || n == 0)
+                if (!s || n <= 0)
                     return 0;
 
                 streamsize i{0};
-                for (; i <= n; ++i)
+                while (i < n)
                 {
-                    if (!write_avail_() && traits_type::eq_int_type(overflow(), traits_type::eof()))
-                        break;
-
-                    *output_next_++ = *s++;
+                    if (write_avail_())
+                    {
+                        auto count = static_cast<streamsize>(output_end_ - output_next_);
+                        if (count > n - i)
+                            count = n - i;
+                        traits_type::copy(output_next_, s + i, count);
+
+                        output_next_ += count;
+                        i += count;
+                    }
+                    else
+                    {
+                        auto c = traits_type::to_int_type(s[i]);
+                        if (traits_type::eq_int_type(overflow(c), traits_type::eof()))
+                            break;
+
+                        ++i;
+                    }
                 }
 
                 return i;
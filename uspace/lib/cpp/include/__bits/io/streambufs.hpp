@@ -35,18 +35,25 @@
 
 namespace std::aux
 {
+    /**
+     * Note: Since stdin is usually interactive, the get area
+     *       is refilled only up to the end of the current line
+     *       (we have no way of reading just what is available).
+     *       Bulk reads through sgetn that do not fit into
+     *       the buffer go directly to fread though.
+     */
     template<class Char, class Traits = char_traits<Char>>
     class stdin_streambuf : public basic_streambuf<Char, Traits>
     {
         public:
             stdin_streambuf()
-                : basic_streambuf<Char, Traits>{}, buffer_{nullptr}
+                : basic_streambuf<Char, Traits>{}, buffer_{nullptr},
+                  buf_size_{default_buf_size_}, owns_buffer_{true}
             { /* DUMMY BODY */ }
 
             virtual ~stdin_streambuf()
             {
-                if (buffer_)
-                    delete[] buffer_;
+                release_buffer_();
             }
 
         protected:
@@ -61,26 +68,16 @@ namespace std::aux
 
             int_type underflow() override
             {
-                if (!this->gptr())
-                {
+                if (this->read_avail_())
+                    return traits_type::to_int_type(*input_next_);
+
+                if (!buffer_)
                     buffer_ = new char_type[buf_size_];
-                    input_begin_ = input_next_ = input_end_ = buffer_;
-                }
 
                 off_type i{};
-                if (input_next_ < input_end_)
-                {
-                    auto idx = static_cast<off_type>(input_next_ - input_begin_);
-                    auto count = buf_size_ - idx;
-
-                    for (; i < count; ++i, ++idx)
-                        buffer_[i] = buffer_[idx];
-                }
-
                 for (; i < buf_size_; ++i)
                 {
                     auto c = fgetc(in_);
-                    putchar(c); // TODO: Temporary source of feedback.
                     if (c == traits_type::eof())
                         break;
 
@@ -93,8 +90,7 @@ namespace std::aux
                     }
                 }
 
-                input_next_ = input_begin_;
-                input_end_ = input_begin_ + i;
+                this->setg(buffer_, buffer_, buffer_ + i);
 
                 if (i == 0)
                     return traits_type::eof();
@@ -105,11 +101,54 @@ namespace std::aux
             int_type uflow() override
             {
                 auto res = underflow();
-                ++input_next_;
+                if (!traits_type::eq_int_type(res, traits_type::eof()))
+                    ++input_next_;
 
                 return res;
             }
 
+            streamsize xsgetn(char_type* s, streamsize n) override
+            {
+                if (!s || n <= 0)
+                    return 0;
+
+                streamsize count{};
+                if (this->read_avail_())
+                {
+                    count = input_end_ - input_next_;
+                    if (count > n)
+                        count = n;
+
+                    traits_type::copy(s, input_next_, count);
+                    input_next_ += count;
+                }
+
+                if (count < n && n - count >= buf_size_)
+                {
+                    count += fread(s + count, sizeof(char_type), n - count, in_);
+
+                    return count;
+                }
+
+                return count + basic_streambuf<Char, Traits>::xsgetn(s + count, n - count);
+            }
+
+            basic_streambuf<Char, Traits>* setbuf(char_type* s, streamsize n) override
+            {
+                // Note: We do not move characters that were already read.
+                if (this->read_avail_() || n <= 0)
+                    return nullptr;
+
+                release_buffer_();
+                this->setg(nullptr, nullptr, nullptr);
+
+                buf_size_ = static_cast<off_type>(n);
+                buffer_ = s;
+                owns_buffer_ = !s;
+
+                return this;
+            }
+
             void imbue(const locale& loc)
             {
                 this->locale_ = loc;
@@ -119,20 +158,44 @@ namespace std::aux
             FILE* in_{stdin};
 
             char_type* buffer_;
+            off_type buf_size_;
+            bool owns_buffer_;
 
-            static constexpr off_type buf_size_{128};
+            static constexpr off_type default_buf_size_{
+                default_stream_buffer_size / sizeof(char_type)
+            };
+
+            void release_buffer_()
+            {
+                if (buffer_ && owns_buffer_)
+                    delete[] buffer_;
+                buffer_ = nullptr;
+            }
     };
 
+    /**
+     * Note: By default (i.e. when the standard streams are
+     *       synchronized with stdio) the output is not buffered
+     *       and goes directly to the (already buffered) stdout
+     *       FILE. A buffer set with pubsetbuf (which is what
+     *       sync_with_stdio(false) does) collects the output
+     *       and writes it out with a single fwrite when full
+     *       or on flush.
+     */
     template<class Char, class Traits = char_traits<Char>>
     class stdout_streambuf: public basic_streambuf<Char, Traits>
     {
         public:
             stdout_streambuf()
-                : basic_streambuf<Char, Traits>{}
+                : basic_streambuf<Char, Traits>{},
+                  buffer_{nullptr}, owns_buffer_{false}
             { /* DUMMY BODY */ }
 
             virtual ~stdout_streambuf()
-            { /* DUMMY BODY */ }
+            {
+                write_buffer_();
+                release_buffer_();
+            }
 
         protected:
             using traits_type = Traits;
@@ -142,10 +205,16 @@ namespace std::aux
 
             int_type overflow(int_type c = traits_type::eof()) override
             {
+                if (!write_buffer_())
+                    return traits_type::eof();
+
                 if (!traits_type::eq_int_type(c, traits_type::eof()))
                 {
                     auto cc = traits_type::to_char_type(c);
-                    fwrite(&cc, sizeof(char_type), 1, out_);
+                    if (buffer_)
+                        *this->output_next_++ = cc;
+                    else if (fwrite(&cc, sizeof(char_type), 1, out_) != 1)
+                        return traits_type::eof();
                 }
 
                 return traits_type::not_eof(c);
@@ -153,18 +222,79 @@ namespace std::aux
 
             streamsize xsputn(const char_type* s, streamsize n) override
             {
-                return fwrite(s, sizeof(char_type), n, out_);
+                if (!s || n <= 0)
+                    return 0;
+
+                if (n <= this->epptr() - this->pptr())
+                {
+                    traits_type::copy(this->pptr(), s, n);
+                    this->pbump(static_cast<int>(n));
+
+                    return n;
+                }
+
+                if (!write_buffer_())
+                    return 0;
+
+                if (n >= this->epptr() - this->pbase())
+                    return fwrite(s, sizeof(char_type), n, out_);
+
+                traits_type::copy(this->pptr(), s, n);
+                this->pbump(static_cast<int>(n));
+
+                return n;
+            }
+
+            basic_streambuf<Char, Traits>* setbuf(char_type* s, streamsize n) override
+            {
+                if (!write_buffer_())
+                    return nullptr;
+                release_buffer_();
+
+                if (n > 0)
+                {
+                    buffer_ = s ? s : new char_type[n];
+                    owns_buffer_ = !s;
+                    this->setp(buffer_, buffer_ + n);
+                }
+                else
+                    this->setp(nullptr, nullptr);
+
+                return this;
             }
 
             int sync() override
             {
-                if (fflush(out_))
+                if (!write_buffer_() || fflush(out_))
                     return -1;
                 return 0;
             }
 
         private:
             FILE* out_{stdout};
+
+            char_type* buffer_;
+            bool owns_buffer_;
+
+            bool write_buffer_()
+            {
+                auto count = static_cast<size_t>(this->pptr() - this->pbase());
+                if (count == 0)
+                    return true;
+
+                auto res = fwrite(this->pbase(), sizeof(char_type), count, out_);
+                this->setp(this->pbase(), this->epptr());
+
+                return res == count;
+            }
+
+            void release_buffer_()
+            {
+                if (buffer_ && owns_buffer_)
+                    delete[] buffer_;
+                buffer_ = nullptr;
+                owns_buffer_ = false;
+            }
     };
 }
 
@@ -224,20 +224,17 @@ namespace std
 
             static constexpr float infinity() noexcept
             {
-                // TODO: implement
-                return 0.f;
+                return __builtin_inff();
             }
 
             static constexpr float quiet_NaN() noexcept
             {
-                // TODO: implement
-                return 0.f;
+                return __builtin_nanf("");
             }
 
             static constexpr float signaling_NaN() noexcept
             {
-                // TODO: implement
-                return 0.f;
+                return __builtin_nansf("");
             }
 
             static constexpr float denorm_min() noexcept
@@ -609,18 +606,173 @@ namespace std
     };
 
     template<>
-    class numeric_limits<double>: public aux::numeric_limits<double>
+    class numeric_limits<double>
     {
         public:
-        // TODO: implement
-            static constexpr int digits = sizeof(short) * 8 - 1;
+            static constexpr bool is_specialized = true;
+
+            static constexpr double min() noexcept
+            {
+                return 2.2250738585072014e-308;
+            }
+
+            static constexpr double max() noexcept
+            {
+                return 1.7976931348623157e+308;
+            }
+
+            static constexpr double lowest() noexcept
+            {
+                return -1.7976931348623157e+308;
+            }
+
+            static constexpr int digits       = 53;
+            static constexpr int digits10     = 15;
+            static constexpr int max_digits10 = 17;
+
+            static constexpr bool is_signed  = true;
+            static constexpr bool is_integer = false;
+            static constexpr bool is_exact   = false;
+
+            static constexpr int radix = 2;
+
+            static constexpr double epsilon() noexcept
+            {
+                return 2.2204460492503131e-16;
+            }
+
+            static constexpr double round_error() noexcept
+            {
+                return 0.5;
+            }
+
+            static constexpr int min_exponent   = -1021;
+            static constexpr int min_exponent10 = -307;
+            static constexpr int max_exponent   = 1024;
+            static constexpr int max_exponent10 = 308;
+
+            static constexpr bool has_infinity      = true;
+            static constexpr bool has_quiet_NaN     = true;
+            static constexpr bool has_signaling_NaN = true;
+
+            static constexpr float_denorm_style has_denorm = denorm_present;
+            static constexpr bool has_denorm_loss          = false;
+
+            static constexpr double infinity() noexcept
+            {
+                return __builtin_inf();
+            }
+
+            static constexpr double quiet_NaN() noexcept
+            {
+                return __builtin_nan("");
+            }
+
+            static constexpr double signaling_NaN() noexcept
+            {
+                return __builtin_nans("");
+            }
+
+            static constexpr double denorm_min() noexcept
+            {
+                return 4.9406564584124654e-324;
+            }
+
+            static constexpr bool is_iec559  = true;
+            static constexpr bool is_bounded = true;
+            static constexpr bool is_modulo  = false;
+
+            static constexpr bool traps           = false;
+            static constexpr bool tinyness_before = false;
+
+            static constexpr float_round_style round_style = round_to_nearest;
     };
 
+    /**
+     * Note: The format of long double differs between
+     *       architectures, so we ask the compiler.
+     */
     template<>
-    class numeric_limits<long double>: public aux::numeric_limits<long double>
+    class numeric_limits<long double>
     {
         public:
-        // TODO: implement
+            static constexpr bool is_specialized = true;
+
+            static constexpr long double min() noexcept
+            {
+                return __LDBL_MIN__;
+            }
+
+            static constexpr long double max() noexcept
+            {
+                return __LDBL_MAX__;
+            }
+
+            static constexpr long double lowest() noexcept
+            {
+                return -__LDBL_MAX__;
+            }
+
+            static constexpr int digits       = __LDBL_MANT_DIG__;
+            static constexpr int digits10     = __LDBL_DIG__;
+            static constexpr int max_digits10 = __LDBL_DECIMAL_DIG__;
+
+            static constexpr bool is_signed  = true;
+            static constexpr bool is_integer = false;
+            static constexpr bool is_exact   = false;
+
+            static constexpr int radix = 2;
+
+            static constexpr long double epsilon() noexcept
+            {
+                return __LDBL_EPSILON__;
+            }
+
+            static constexpr long double round_error() noexcept
+            {
+                return 0.5L;
+            }
+
+            static constexpr int min_exponent   = __LDBL_MIN_EXP__;
+            static constexpr int min_exponent10 = __LDBL_MIN_10_EXP__;
+            static constexpr int max_exponent   = __LDBL_MAX_EXP__;
+            static constexpr int max_exponent10 = __LDBL_MAX_10_EXP__;
+
+            static constexpr bool has_infinity      = true;
+            static constexpr bool has_quiet_NaN     = true;
+            static constexpr bool has_signaling_NaN = true;
+
+            static constexpr float_denorm_style has_denorm = denorm_present;
+            static constexpr bool has_denorm_loss          = false;
+
+            static constexpr long double infinity() noexcept
+            {
+                return __builtin_infl();
+            }
+
+            static constexpr long double quiet_NaN() noexcept
+            {
+                return __builtin_nanl("");
+            }
+
+            static constexpr long double signaling_NaN() noexcept
+            {
+                return __builtin_nansl("");
+            }
+
+            static constexpr long double denorm_min() noexcept
+            {
+                return __LDBL_DENORM_MIN__;
+            }
+
+            static constexpr bool is_iec559  = true;
+            static constexpr bool is_bounded = true;
+            static constexpr bool is_modulo  = false;
+
+            static constexpr bool traps           = false;
+            static constexpr bool tinyness_before = false;
+
+            static constexpr float_round_style round_style = round_to_nearest;
     };
 }
 
@@ -29,9 +29,9 @@
 #ifndef LIBCPP_BITS_LOCALE_NUM_GET
 #define LIBCPP_BITS_LOCALE_NUM_GET
 
+#include <__bits/charconv.hpp>
 #include <__bits/locale/locale.hpp>
 #include <__bits/locale/numpunct.hpp>
-#include <cerrno>
 #include <cstring>
 #include <ios>
 #include <iterator>
@@ -258,22 +258,19 @@ namespace std
             iter_type do_get(iter_type in, iter_type end, ios_base& base,
                              ios_base::iostate& err, float& v) const
             {
-                // TODO: implement
-                return in;
+                return get_floating_(in, end, base, err, v);
             }
 
             iter_type do_get(iter_type in, iter_type end, ios_base& base,
                              ios_base::iostate& err, double& v) const
             {
-                // TODO: implement
-                return in;
+                return get_floating_(in, end, base, err, v);
             }
 
             iter_type do_get(iter_type in, iter_type end, ios_base& base,
                              ios_base::iostate& err, long double& v) const
             {
-                // TODO: implement
-                return in;
+                return get_floating_(in, end, base, err, v);
             }
 
             iter_type do_get(iter_type in, iter_type end, ios_base& base,
@@ -288,8 +285,7 @@ namespace std
             iter_type get_integral_(iter_type in, iter_type end, ios_base& base,
                                     ios_base::iostate& err, T& v) const
             {
-                BaseType res{};
-                unsigned int num_base{10};
+                int num_base{10};
 
                 auto basefield = (base.flags() & ios_base::basefield);
                 if (basefield == ios_base::oct)
@@ -298,33 +294,51 @@ namespace std
                     num_base = 16;
 
                 auto size = fill_buffer_integral_(in, end, base);
-                if (size > 0)
+                auto first = base.buffer_;
+                auto last = base.buffer_ + size;
+
+                // Note: from_chars does not accept the plus sign.
+                if (first != last && *first == '+')
+                    ++first;
+
+                bool neg = (first != last && *first == '-');
+
+                from_chars_result res{};
+                if constexpr (is_signed<BaseType>::value)
                 {
-                    int ret{};
-                    if constexpr (is_signed<BaseType>::value)
-                        ret = std::hel::str_int64_t(base.buffer_, nullptr, num_base, false, &res);
-                    else
-                        ret = std::hel::str_uint64_t(base.buffer_, nullptr, num_base, false, &res);
+                    long long tmp{};
+                    res = aux::from_chars_signed(
+                        first, last, tmp, numeric_limits<T>::min(),
+                        numeric_limits<T>::max(), num_base
+                    );
+
+                    if (res.ec == errc{})
+                        v = static_cast<T>(tmp);
+                }
+                else
+                {
+                    /**
+                     * Like strtoull, negative values are
+                     * accepted and negated for unsigned types.
+                     */
+                    unsigned long long tmp{};
+                    res = aux::from_chars_unsigned(
+                        first + neg, last, tmp, numeric_limits<T>::max(), num_base
+                    );
 
-                    if (ret != EOK)
-                    {
-                        err |= ios_base::failbit;
-                        v = 0;
-                    }
-                    else if (res > static_cast<BaseType>(numeric_limits<T>::max()))
-                    {
-                        err |= ios_base::failbit;
-                        v = numeric_limits<T>::max();
-                    }
-                    else if (res < static_cast<BaseType>(numeric_limits<T>::min()))
-                    {
-                        err |= ios_base::failbit;
+                    if (res.ec == errc{})
+                        v = static_cast<T>(neg ? 0ULL - tmp : tmp);
+                }
+
+                if (res.ec == errc::result_out_of_range)
+                {
+                    err |= ios_base::failbit;
+                    if (neg && is_signed<BaseType>::value)
                         v = numeric_limits<T>::min();
-                    }
                     else
-                        v = static_cast<T>(res);
+                        v = numeric_limits<T>::max();
                 }
-                else
+                else if (res.ec != errc{} || res.ptr != last)
                 {
                     err |= ios_base::failbit;
                     v = 0;
@@ -333,6 +347,33 @@ namespace std
                 return in;
             }
 
+            template<class T>
+            iter_type get_floating_(iter_type in, iter_type end, ios_base& base,
+                                    ios_base::iostate& err, T& v) const
+            {
+                auto size = fill_buffer_floating_(in, end, base);
+                auto first = base.buffer_;
+                auto last = base.buffer_ + size;
+
+                if (first != last && *first == '+')
+                    ++first;
+
+                auto res = from_chars(first, last, v);
+                if (res.ec == errc::result_out_of_range)
+                {
+                    err |= ios_base::failbit;
+                    v = (first != last && *first == '-') ? -numeric_limits<T>::max()
+                                                         : numeric_limits<T>::max();
+                }
+                else if (res.ec != errc{} || res.ptr != last)
+                {
+                    err |= ios_base::failbit;
+                    v = T{};
+                }
+
+                return in;
+            }
+
             size_t fill_buffer_integral_(iter_type& in, iter_type end, ios_base& base) const
             {
                 if (in == end)
@@ -363,6 +404,48 @@ namespace std
 
                 return i;
             }
+
+            size_t fill_buffer_floating_(iter_type& in, iter_type end, ios_base& base) const
+            {
+                if (in == end)
+                    return 0;
+
+                auto loc = base.getloc();
+                const auto& ct = use_facet<ctype<char_type>>(loc);
+                const auto& punct = use_facet<numpunct<char_type>>(loc);
+
+                size_t i{};
+                auto max = ios_base::buffer_size_ - 1;
+                auto append_digits = [&](){
+                    while (in != end && i < max && ct.is(ctype_base::digit, *in))
+                        base.buffer_[i++] = ct.narrow(*in++, '0');
+                };
+
+                if (*in == ct.widen('+') || *in == ct.widen('-'))
+                    base.buffer_[i++] = ct.narrow(*in++, '+');
+
+                append_digits();
+
+                if (in != end && i < max && *in == punct.decimal_point())
+                {
+                    ++in;
+                    base.buffer_[i++] = '.';
+                    append_digits();
+                }
+
+                if (in != end && i < max && (*in == ct.widen('e') || *in == ct.widen('E')))
+                {
+                    base.buffer_[i++] = ct.narrow(*in++, 'e');
+
+                    if (in != end && i < max && (*in == ct.widen('+') || *in == ct.widen('-')))
+                        base.buffer_[i++] = ct.narrow(*in++, '+');
+
+                    append_digits();
+                }
+                base.buffer_[i] = char{};
+
+                return i;
+            }
     };
 }
 
@@ -29,6 +29,7 @@
 #ifndef LIBCPP_BITS_LOCALE_NUM_PUT
 #define LIBCPP_BITS_LOCALE_NUM_PUT
 
+#include <__bits/charconv.hpp>
 #include <__bits/locale/locale.hpp>
 #include <__bits/locale/numpunct.hpp>
 #include <ios>
@@ -113,141 +114,142 @@ namespace std
 
             iter_type do_put(iter_type it, ios_base& base, char_type fill, long v) const
             {
-                auto basefield = (base.flags() & ios_base::basefield);
-                auto uppercase = (base.flags() & ios_base::uppercase);
-
-                int ret{};
-                if (basefield == ios_base::oct)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lo", v);
-                else if ((basefield == ios_base::hex) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lx", v);
-                else if (basefield == ios_base::hex)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lX", v);
-                else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%ld", v);
-
-                return put_adjusted_buffer_(it, base, fill, ret);
+                return put_integral_(it, base, fill, v);
             }
 
             iter_type do_put(iter_type it, ios_base& base, char_type fill, long long v) const
             {
-                auto basefield = (base.flags() & ios_base::basefield);
-                auto uppercase = (base.flags() & ios_base::uppercase);
+                return put_integral_(it, base, fill, v);
+            }
 
-                int ret{};
-                if (basefield == ios_base::oct)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llo", v);
-                else if ((basefield == ios_base::hex) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llx", v);
-                else if (basefield == ios_base::hex)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llX", v);
-                else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lld", v);
+            iter_type do_put(iter_type it, ios_base& base, char_type fill, unsigned long v) const
+            {
+                return put_integral_(it, base, fill, v);
+            }
 
-                return put_adjusted_buffer_(it, base, fill, ret);
+            iter_type do_put(iter_type it, ios_base& base, char_type fill, unsigned long long v) const
+            {
+                return put_integral_(it, base, fill, v);
             }
 
-            iter_type do_put(iter_type it, ios_base& base, char_type fill, unsigned long v) const
+            iter_type do_put(iter_type it, ios_base& base, char_type fill, double v) const
             {
-                auto basefield = (base.flags() & ios_base::basefield);
-                auto uppercase = (base.flags() & ios_base::uppercase);
+                return put_floating_(it, base, fill, v);
+            }
 
-                int ret{};
-                if (basefield == ios_base::oct)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lo", v);
-                else if ((basefield == ios_base::hex) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lx", v);
-                else if (basefield == ios_base::hex)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lX", v);
-                else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%lu", v);
+            iter_type do_put(iter_type it, ios_base& base, char_type fill, long double v) const
+            {
+                /**
+                 * Note: Long double is not supported at the moment by
+                 *       snprintf nor to_chars, so we format it as double.
+                 */
+                return put_floating_(it, base, fill, static_cast<double>(v));
+            }
+
+            iter_type do_put(iter_type it, ios_base& base, char_type fill, const void* v) const
+            {
+                int ret = snprintf(base.buffer_, ios_base::buffer_size_, "%p", v);
 
                 return put_adjusted_buffer_(it, base, fill, ret);
             }
 
-            iter_type do_put(iter_type it, ios_base& base, char_type fill, unsigned long long v) const
+        private:
+            template<class Int>
+            iter_type put_integral_(iter_type it, ios_base& base, char_type fill, Int v) const
             {
                 auto basefield = (base.flags() & ios_base::basefield);
                 auto uppercase = (base.flags() & ios_base::uppercase);
 
                 // TODO: showbase
-                int ret{};
+                /**
+                 * Note: Like printf's %o and %x, octal and hexadecimal
+                 *       output prints the unsigned representation.
+                 */
+                auto first = base.buffer_;
+                auto last = base.buffer_ + ios_base::buffer_size_;
+                to_chars_result res{};
                 if (basefield == ios_base::oct)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llo", v);
-                else if ((basefield == ios_base::hex) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llx", v);
+                    res = to_chars(first, last, static_cast<make_unsigned_t<Int>>(v), 8);
                 else if (basefield == ios_base::hex)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llX", v);
+                {
+                    res = to_chars(first, last, static_cast<make_unsigned_t<Int>>(v), 16);
+
+                    if (uppercase)
+                    {
+                        for (auto ptr = first; ptr != res.ptr; ++ptr)
+                        {
+                            if ('a' <= *ptr && *ptr <= 'f')
+                                *ptr -= 'a' - 'A';
+                        }
+                    }
+                }
                 else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%llu", v);
+                    res = to_chars(first, last, v);
 
-                return put_adjusted_buffer_(it, base, fill, ret);
+                return put_adjusted_buffer_(it, base, fill, res.ptr - first);
             }
 
-            iter_type do_put(iter_type it, ios_base& base, char_type fill, double v) const
+            iter_type put_floating_(iter_type it, ios_base& base, char_type fill, double v) const
             {
                 auto floatfield = (base.flags() & ios_base::floatfield);
-                auto uppercase = (base.flags() & ios_base::uppercase);
+                auto uppercase = (base.flags() & ios_base::uppercase) != 0;
 
                 // TODO: showbase
-                // TODO: precision
                 int ret{};
+                if (floatfield == (ios_base::fixed | ios_base::scientific))
+                {
+                    // Note: Hexfloats are rare enough to leave them to snprintf.
+                    if (!uppercase)
+                        ret = snprintf(base.buffer_, ios_base::buffer_size_, "%a", v);
+                    else
+                        ret = snprintf(base.buffer_, ios_base::buffer_size_, "%A", v);
+
+                    return put_adjusted_buffer_(it, base, fill, ret);
+                }
+
+                auto fmt = chars_format::general;
                 if (floatfield == ios_base::fixed)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%f", v);
-                else if (floatfield == ios_base::scientific && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%e", v);
+                    fmt = chars_format::fixed;
                 else if (floatfield == ios_base::scientific)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%E", v);
-                else if (floatfield == (ios_base::fixed | ios_base::scientific) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%a", v);
-                else if (floatfield == (ios_base::fixed | ios_base::scientific))
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%A", v);
-                else if (!uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%g", v);
-                else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%G", v);
+                    fmt = chars_format::scientific;
 
-                return put_adjusted_buffer_(it, base, fill, ret);
-            }
+                auto precision = static_cast<int>(base.precision());
+                if (precision < 0)
+                    precision = 6;
 
-            iter_type do_put(iter_type it, ios_base& base, char_type fill, long double v) const
-            {
-                /**
-                 * Note: Long double is not support at the moment in snprintf.
-                 */
-                auto floatfield = (base.flags() & ios_base::floatfield);
-                auto uppercase = (base.flags() & ios_base::uppercase);
+                auto res = aux::to_chars_double(
+                    base.buffer_, base.buffer_ + ios_base::buffer_size_,
+                    v, fmt, precision, uppercase
+                );
 
-                // TODO: showbase
-                // TODO: precision
-                int ret{};
-                if (floatfield == ios_base::fixed)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%Lf", v);
-                else if (floatfield == ios_base::scientific && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%Le", v);
-                else if (floatfield == ios_base::scientific)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%LE", v);
-                else if (floatfield == (ios_base::fixed | ios_base::scientific) && !uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%La", v);
-                else if (floatfield == (ios_base::fixed | ios_base::scientific))
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%LA", v);
-                else if (!uppercase)
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%Lg", v);
-                else
-                    ret = snprintf(base.buffer_, ios_base::buffer_size_, "%LG", v);
+                if (res.ec == errc::value_too_large)
+                {
+                    /**
+                     * Large values in fixed notation (or large precisions)
+                     * do not fit our buffer, this is enough for the up to
+                     * 309 integral digits plus sign, point and exponent.
+                     */
+                    auto size = static_cast<size_t>(precision) + 320;
+                    auto buf = new char[size];
 
-                return put_adjusted_buffer_(it, base, fill, ret);
-            }
+                    res = aux::to_chars_double(buf, buf + size, v, fmt, precision, uppercase);
+                    it = put_adjusted_buffer_(it, base, fill, buf, res.ptr - buf);
 
-            iter_type do_put(iter_type it, ios_base& base, char_type fill, const void* v) const
-            {
-                int ret = snprintf(base.buffer_, ios_base::buffer_size_, "%p", v);
+                    delete[] buf;
 
-                return put_adjusted_buffer_(it, base, fill, ret);
+                    return it;
+                }
+
+                return put_adjusted_buffer_(it, base, fill, res.ptr - base.buffer_);
             }
 
-        private:
             iter_type put_adjusted_buffer_(iter_type it, ios_base& base, char_type fill, size_t size) const
+            {
+                return put_adjusted_buffer_(it, base, fill, base.buffer_, size);
+            }
+
+            iter_type put_adjusted_buffer_(iter_type it, ios_base& base, char_type fill,
+                                           const char* buf, size_t size) const
             {
                 auto adjustfield = (base.flags() & ios_base::adjustfield);
 
@@ -261,7 +263,7 @@ namespace std
                 {
                     if (adjustfield == ios_base::left)
                     {
-                        it = put_buffer_(it, base, fill, 0, size);
+                        it = put_buffer_(it, base, buf, 0, size);
                         for (size_t i = 0; i < to_fill; ++i)
                             *it++ = fill;
                     }
@@ -269,7 +271,7 @@ namespace std
                     {
                         for (size_t i = 0; i < to_fill; ++i)
                             *it++ = fill;
-                        it = put_buffer_(it, base, fill, 0, size);
+                        it = put_buffer_(it, base, buf, 0, size);
                     }
                     else if (adjustfield == ios_base::internal)
                     {
@@ -279,17 +281,17 @@ namespace std
                     {
                         for (size_t i = 0; i < to_fill; ++i)
                             *it++ = fill;
-                        it = put_buffer_(it, base, fill, 0, size);
+                        it = put_buffer_(it, base, buf, 0, size);
                     }
                 }
                 else
-                    it = put_buffer_(it, base, fill, 0, size);
+                    it = put_buffer_(it, base, buf, 0, size);
                 base.width(0);
 
                 return it;
             }
 
-            iter_type put_buffer_(iter_type it, ios_base& base, char_type fill, size_t start, size_t size) const
+            iter_type put_buffer_(iter_type it, ios_base& base, const char* buf, size_t start, size_t size) const
             {
                 const auto& loc = base.getloc();
                 const auto& ct = use_facet<ctype<char_type>>(loc);
@@ -297,10 +299,10 @@ namespace std
 
                 for (size_t i = start; i < size; ++i)
                 {
-                    if (base.buffer_[i] == '.')
+                    if (buf[i] == '.')
                         *it++ = punct.decimal_point();
                     else
-                        *it++ = ct.widen(base.buffer_[i]);
+                        *it++ = ct.widen(buf[i]);
                     // TODO: Should do grouping & thousands_sep, but that's a low
                     //       priority for now.
                 }
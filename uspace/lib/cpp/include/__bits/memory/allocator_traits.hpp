@@ -53,17 +53,31 @@ namespace std
         struct has_allocator_type<T, void_t<typename T::allocator_type>>
             : true_type
         { /* DUMMY BODY */ };
+
+        /**
+         * Note: The allocator_type must not be named
+         *       for types that do not have one.
+         */
+        template<class T, class Alloc, bool = has_allocator_type<T>::value>
+        struct uses_allocator_impl: false_type
+        { /* DUMMY BODY */ };
+
+        template<class T, class Alloc>
+        struct uses_allocator_impl<T, Alloc, true>
+            : aux::value_is<
+            bool, is_convertible_v<Alloc, typename T::allocator_type>
+        >
+        { /* DUMMY BODY */ };
     }
 
     template<class T, class Alloc>
     struct uses_allocator
-        : aux::value_is<
-        bool, aux::has_allocator_type<T>::value && is_convertible_v<
-            Alloc, typename T::allocator_type
-        >
-    >
+        : aux::uses_allocator_impl<T, Alloc>
     { /* DUMMY BODY */ };
 
+    template<class T, class Alloc>
+    inline constexpr bool uses_allocator_v = uses_allocator<T, Alloc>::value;
+
     /**
      * 20.7.8, allocator traits:
      */
@@ -87,7 +101,7 @@ namespace std
         using is_always_equal                        = typename aux::alloc_get_always_equal<Alloc>::type;
 
         template<class T>
-        using rebind_alloc = typename aux::alloc_get_rebind_alloc<Alloc, T>;
+        using rebind_alloc = typename aux::alloc_get_rebind_alloc<Alloc, T>::type;
 
         template<class T>
         using rebind_traits = allocator_traits<rebind_alloc<T>>;
@@ -218,7 +232,7 @@ namespace std
 
             void deallocate(pointer ptr, size_type n)
             {
-                ::operator delete(ptr, n);
+                ::operator delete(ptr, n * sizeof(value_type));
             }
 
             size_type max_size() const noexcept
@@ -250,6 +264,35 @@ namespace std
     {
         return false;
     }
+
+    namespace aux
+    {
+        /**
+         * Containers can move elements around with memcpy
+         * and memmove if the type is trivially copyable and
+         * destructible and the allocator does not customize
+         * construction or destruction (std::allocator does,
+         * but it only forwards to placement new and the
+         * destructor).
+         */
+        template<class T, class Alloc>
+        struct is_trivially_relocatable
+            : value_is<
+                bool,
+                is_trivially_copyable_v<T> &&
+                is_trivially_destructible_v<T> && (
+                    is_same_v<Alloc, allocator<T>> || (
+                        !alloc_has_construct<Alloc, T, T&&>::value &&
+                        !alloc_has_destroy<Alloc, T*>::value
+                    )
+                )
+            >
+        { /* DUMMY BODY */ };
+
+        template<class T, class Alloc>
+        inline constexpr bool is_trivially_relocatable_v =
+            is_trivially_relocatable<T, Alloc>::value;
+    }
 }
 
 #endif
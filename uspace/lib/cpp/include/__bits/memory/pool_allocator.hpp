@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_MEMORY_POOL_ALLOCATOR
+#define LIBCPP_BITS_MEMORY_POOL_ALLOCATOR
+
+#include <__bits/memory/allocator_traits.hpp>
+#include <cstdlib>
+#include <type_traits>
+
+namespace std::aux
+{
+    /**
+     * Arena of fixed size node slabs shared by all copies of
+     * a pool_allocator. Requests are rounded up to a multiple
+     * of the default new alignment and every such size class
+     * has its own free list, which is refilled a whole slab at
+     * a time. Freed nodes go back to their free list and the
+     * slabs themselves are only released with the pool.
+     * Note: The pool is not synchronized, containers that share
+     *       a pool must not be modified concurrently.
+     */
+    class node_pool
+    {
+        public:
+            static constexpr size_t granularity = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+            static constexpr size_t class_count = 16;
+            static constexpr size_t max_node_size = granularity * class_count;
+            static constexpr size_t default_slab_size = 4096;
+
+            explicit node_pool(size_t slab_size = default_slab_size);
+
+            node_pool(const node_pool&) = delete;
+            node_pool& operator=(const node_pool&) = delete;
+
+            ~node_pool();
+
+            static constexpr bool fits(size_t size, size_t align) noexcept
+            {
+                return size <= max_node_size && align <= granularity;
+            }
+
+            void* allocate(size_t size);
+
+            void deallocate(void* ptr, size_t size) noexcept;
+
+            size_t slab_count() const noexcept
+            {
+                return slab_count_;
+            }
+
+            void acquire() noexcept
+            {
+                ++refcount_;
+            }
+
+            /**
+             * Returns true if this was the last reference
+             * and the pool should be deleted.
+             */
+            bool release() noexcept
+            {
+                return --refcount_ == 0;
+            }
+
+        private:
+            struct free_node
+            {
+                free_node* next;
+            };
+
+            struct slab
+            {
+                slab* next;
+            };
+
+            free_node* free_lists_[class_count];
+            slab* slabs_;
+            size_t slab_count_;
+            size_t slab_size_;
+            size_t refcount_;
+
+            static size_t class_idx_(size_t size) noexcept
+            {
+                return (size + granularity - 1) / granularity - 1;
+            }
+
+            void refill_(size_t idx);
+    };
+}
+
+namespace std::ext
+{
+    /**
+     * Allocator for node based containers (list, map, set,
+     * unordered_map, ...), which allocate one node at a time.
+     * Single node requests are served from a node_pool, which
+     * is shared by all copies and rebound copies of the allocator,
+     * anything else goes directly to operator new.
+     * A default constructed allocator creates a new pool, so
+     * each container gets its own arena unless it is given a copy
+     * of an existing allocator.
+     */
+    template<class T>
+    class pool_allocator
+    {
+        public:
+            using size_type       = size_t;
+            using difference_type = ptrdiff_t;
+            using pointer         = T*;
+            using const_pointer   = const T*;
+            using reference       = T&;
+            using const_reference = const T&;
+            using value_type      = T;
+
+            template<class U>
+            struct rebind
+            {
+                using other = pool_allocator<U>;
+            };
+
+            using propagate_on_container_copy_assignment = true_type;
+            using propagate_on_container_move_assignment = true_type;
+            using propagate_on_container_swap            = true_type;
+            using is_always_equal                        = false_type;
+
+            pool_allocator()
+                : pool_{new aux::node_pool{}}
+            { /* DUMMY BODY */ }
+
+            explicit pool_allocator(size_t slab_size)
+                : pool_{new aux::node_pool{slab_size}}
+            { /* DUMMY BODY */ }
+
+            pool_allocator(const pool_allocator& other) noexcept
+                : pool_{other.pool_}
+            {
+                pool_->acquire();
+            }
+
+            template<class U>
+            pool_allocator(const pool_allocator<U>& other) noexcept
+                : pool_{other.pool()}
+            {
+                pool_->acquire();
+            }
+
+            pool_allocator& operator=(const pool_allocator& other) noexcept
+            {
+                other.pool_->acquire();
+                release_();
+                pool_ = other.pool_;
+
+                return *this;
+            }
+
+            ~pool_allocator()
+            {
+                release_();
+            }
+
+            pointer allocate(size_type n)
+            {
+                if (n == 1 && aux::node_pool::fits(sizeof(T), alignof(T)))
+                    return static_cast<pointer>(pool_->allocate(sizeof(T)));
+                else
+                    return static_cast<pointer>(::operator new(n * sizeof(T)));
+            }
+
+            void deallocate(pointer ptr, size_type n) noexcept
+            {
+                if (n == 1 && aux::node_pool::fits(sizeof(T), alignof(T)))
+                    pool_->deallocate(ptr, sizeof(T));
+                else
+                    ::operator delete(ptr, n * sizeof(T));
+            }
+
+            aux::node_pool* pool() const noexcept
+            {
+                return pool_;
+            }
+
+        private:
+            aux::node_pool* pool_;
+
+            void release_() noexcept
+            {
+                if (pool_->release())
+                    delete pool_;
+            }
+    };
+
+    template<class T1, class T2>
+    bool operator==(const pool_allocator<T1>& lhs, const pool_allocator<T2>& rhs) noexcept
+    {
+        return lhs.pool() == rhs.pool();
+    }
+
+    template<class T1, class T2>
+    bool operator!=(const pool_allocator<T1>& lhs, const pool_allocator<T2>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
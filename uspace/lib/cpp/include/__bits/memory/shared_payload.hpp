@@ -25,27 +25,23 @@
  * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
  * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
-
 #ifndef LIBCPP_BITS_MEMORY_SHARED_PAYLOAD
 #define LIBCPP_BITS_MEMORY_SHARED_PAYLOAD
 
+#include <__bits/atomic.hpp>
+#include <__bits/memory/allocator_traits.hpp>
 #include <cinttypes>
+#include <typeinfo>
 #include <utility>
 
 namespace std
 {
     template<class>
     struct default_delete;
-
-    struct allocator_arg_t;
 }
 
 namespace std::aux
 {
-    /**
-     * At the moment we do not have atomics, change this
-     * to std::atomic<long> once we do.
-     */
     using refcount_t = long;
 
     /**
@@ -57,166 +53,275 @@ namespace std::aux
 
     inline constexpr payload_tag_t payload_tag{};
 
-    template<class D, class T>
-    void use_payload_deleter(D* deleter, T* data)
-    {
-        if (deleter)
-            (*deleter)(data);
-    }
-
-    template<class T>
+    /**
+     * Control block shared by all shared_ptrs and weak_ptrs
+     * that own the same object. The reference counting is
+     * non-virtual and lock-free, so copying and destroying
+     * shared_ptrs (from any fibril on any kernel thread) only
+     * touches the counters; the virtual functions are called
+     * only when the object or the block itself is released.
+     *
+     * Note: The element pointer is stored in the shared_ptr
+     *       itself (which also allows aliasing and conversions
+     *       between shared_ptrs of different types), so the
+     *       block is not a template and does not need get().
+     */
     class shared_payload_base
     {
         public:
-            virtual void destroy() = 0;
-            virtual T* get() const noexcept = 0;
+            shared_payload_base() noexcept
+                : refcount_{1}, weak_refcount_{1}
+            { /* DUMMY BODY */ }
 
-            virtual uint8_t* deleter() const noexcept = 0;
+            shared_payload_base(const shared_payload_base&) = delete;
+            shared_payload_base& operator=(const shared_payload_base&) = delete;
 
-            virtual void increment() noexcept = 0;
-            virtual void increment_weak() noexcept = 0;
-            virtual bool decrement() noexcept = 0;
-            virtual bool decrement_weak() noexcept = 0;
-            virtual refcount_t refs() const noexcept = 0;
-            virtual refcount_t weak_refs() const noexcept = 0;
-            virtual bool expired() const noexcept = 0;
-            virtual shared_payload_base* lock() noexcept = 0;
+            void increment() noexcept
+            {
+                /**
+                 * New references are only ever created from
+                 * an existing one, so no ordering is needed.
+                 */
+                refcount_.fetch_add(1, memory_order_relaxed);
+            }
 
-            virtual ~shared_payload_base() = default;
-    };
+            void increment_weak() noexcept
+            {
+                weak_refcount_.fetch_add(1, memory_order_relaxed);
+            }
 
-    template<class T, class D = default_delete<T>>
-    class shared_payload: public shared_payload_base<T>
-    {
-        public:
-            shared_payload(T* ptr, D deleter = D{})
-                : data_{ptr}, deleter_{deleter},
-                  refcount_{1}, weak_refcount_{1}
-            { /* DUMMY BODY */ }
+            void decrement() noexcept
+            {
+                if (refcount_.fetch_sub(1, memory_order_acq_rel) == 1)
+                {
+                    destroy_object();
 
-            template<class... Args>
-            shared_payload(Args&&... args)
-                : data_{new T{forward<Args>(args)...}},
-                  deleter_{}, refcount_{1}, weak_refcount_{1}
-            { /* DUMMY BODY */ }
+                    /**
+                     * All shared_ptrs together hold one weak
+                     * reference, which keeps the block alive
+                     * while the object is being destroyed.
+                     */
+                    decrement_weak();
+                }
+            }
+
+            void decrement_weak() noexcept
+            {
+                if (weak_refcount_.fetch_sub(1, memory_order_acq_rel) == 1)
+                    deallocate();
+            }
 
-            template<class Alloc, class... Args>
-            shared_payload(allocator_arg_t, Alloc alloc, Args&&... args)
-                : data_{alloc.allocate(1)},
-                  deleter_{}, refcount_{1}, weak_refcount_{1}
+            refcount_t refs() const noexcept
             {
-                alloc.construct(data_, forward<Args>(args)...);
+                return refcount_.load(memory_order_relaxed);
             }
 
-            template<class Alloc, class... Args>
-            shared_payload(D deleter, Alloc alloc, Args&&... args)
-                : data_{alloc.allocate(1)},
-                  deleter_{deleter}, refcount_{1}, weak_refcount_{1}
+            bool expired() const noexcept
             {
-                alloc.construct(data_, forward<Args>(args)...);
+                return refs() == 0;
             }
 
-            void destroy() override
+            /**
+             * Tries to acquire a strong reference, which
+             * fails once the object has been destroyed.
+             */
+            bool lock() noexcept
             {
-                if (refs() == 0)
+                refcount_t rfs = refcount_.load(memory_order_relaxed);
+                while (rfs != 0)
                 {
-                    if (data_)
+                    if (refcount_.compare_exchange_weak(rfs, rfs + 1,
+                                                        memory_order_acq_rel,
+                                                        memory_order_relaxed))
                     {
-                        deleter_(data_);
-                        data_ = nullptr;
+                        return true;
                     }
-
-                    if (weak_refs() == 0)
-                        delete this;
                 }
+
+                return false;
             }
 
-            T* get() const noexcept override
+            virtual void* deleter(const type_info&) const noexcept
             {
-                return data_;
+                return nullptr;
             }
 
-            uint8_t* deleter() const noexcept override
+        protected:
+            virtual void destroy_object() noexcept = 0;
+            virtual void deallocate() noexcept = 0;
+
+            virtual ~shared_payload_base() = default;
+
+        private:
+            /**
+             * We're using a trick where refcount_ > 0
+             * means weak_refcount_ has 1 added to it,
+             * this makes it easier for weak_ptrs that
+             * can't decrement the weak_refcount_ to
+             * zero with shared_ptrs using this object.
+             */
+            atomic<refcount_t> refcount_;
+            atomic<refcount_t> weak_refcount_;
+    };
+
+    /**
+     * Releases a block allocated through (a rebound copy of)
+     * the allocator it stores.
+     */
+    template<class Payload, class Alloc>
+    void deallocate_payload(Payload* payload, Alloc& alloc)
+    {
+        using alloc_t = typename allocator_traits<Alloc>::template rebind_alloc<Payload>;
+        using traits_t = allocator_traits<alloc_t>;
+
+        alloc_t palloc{alloc};
+        payload->~Payload();
+        traits_t::deallocate(palloc, payload, 1);
+    }
+
+    /**
+     * Block used for objects created outside of the
+     * shared_ptr, i.e. shared_ptr{ptr, [deleter, [alloc]]}.
+     */
+    template<class T, class D = default_delete<T>, class Alloc = void>
+    class shared_payload: public shared_payload_base
+    {
+        public:
+            shared_payload(T* ptr, D deleter, Alloc alloc)
+                : data_{ptr}, deleter_{move(deleter)}, alloc_{move(alloc)}
+            { /* DUMMY BODY */ }
+
+            void* deleter(const type_info& type) const noexcept override
             {
-                return (uint8_t*)&deleter_;
+                if (type == typeid(D))
+                    return const_cast<D*>(&deleter_);
+                else
+                    return nullptr;
             }
 
-            void increment() noexcept override
+        protected:
+            void destroy_object() noexcept override
             {
-                __atomic_add_fetch(&refcount_, 1, __ATOMIC_ACQ_REL);
+                deleter_(data_);
             }
 
-            void increment_weak() noexcept override
+            void deallocate() noexcept override
             {
-                __atomic_add_fetch(&weak_refcount_, 1, __ATOMIC_ACQ_REL);
+                deallocate_payload(this, alloc_);
             }
 
-            bool decrement() noexcept override
-            {
-                if (__atomic_sub_fetch(&refcount_, 1, __ATOMIC_ACQ_REL) == 0)
-                {
-                    /**
-                     * First call to destroy() will delete the held object,
-                     * so it doesn't matter what the weak_refcount_ is,
-                     * but we added one and we need to remove it now.
-                     */
-                    decrement_weak();
+        private:
+            T* data_;
+            D deleter_;
+            Alloc alloc_;
+    };
 
-                    return true;
-                }
+    template<class T, class D>
+    class shared_payload<T, D, void>: public shared_payload_base
+    {
+        public:
+            shared_payload(T* ptr, D deleter = D{})
+                : data_{ptr}, deleter_{move(deleter)}
+            { /* DUMMY BODY */ }
+
+            void* deleter(const type_info& type) const noexcept override
+            {
+                if (type == typeid(D))
+                    return const_cast<D*>(&deleter_);
                 else
-                    return false;
+                    return nullptr;
             }
 
-            bool decrement_weak() noexcept override
+        protected:
+            void destroy_object() noexcept override
             {
-                return __atomic_sub_fetch(&weak_refcount_, 1, __ATOMIC_ACQ_REL) == 0 && refs() == 0;
+                deleter_(data_);
             }
 
-            refcount_t refs() const noexcept override
+            void deallocate() noexcept override
             {
-                return __atomic_load_n(&refcount_, __ATOMIC_RELAXED);
+                delete this;
             }
 
-            refcount_t weak_refs() const noexcept override
+        private:
+            T* data_;
+            D deleter_;
+    };
+
+    /**
+     * Block used by make_shared and allocate_shared, which
+     * embeds the object itself so that both the object
+     * and the counters are created in a single allocation.
+     * With Alloc = void the block is allocated with new.
+     */
+    template<class T, class Alloc = void>
+    class shared_inplace_payload: public shared_payload_base
+    {
+        public:
+            template<class... Args>
+            shared_inplace_payload(Alloc alloc, Args&&... args)
+                : alloc_{move(alloc)}
             {
-                return __atomic_load_n(&weak_refcount_, __ATOMIC_RELAXED);
+                using alloc_t = typename allocator_traits<Alloc>::template rebind_alloc<T>;
+
+                alloc_t talloc{alloc_};
+                allocator_traits<alloc_t>::construct(
+                    talloc, get(), forward<Args>(args)...
+                );
             }
 
-            bool expired() const noexcept override
+            T* get() noexcept
             {
-                return refs() == 0;
+                return reinterpret_cast<T*>(&storage_);
             }
 
-            shared_payload_base<T>* lock() noexcept override
+        protected:
+            void destroy_object() noexcept override
             {
-                refcount_t rfs = refs();
-                while (rfs != 0L)
-                {
-                    if (__atomic_compare_exchange_n(&refcount_, &rfs, rfs + 1,
-                                                    true, __ATOMIC_RELAXED,
-                                                    __ATOMIC_RELAXED))
-                    {
-                        return this;
-                    }
-                }
+                using alloc_t = typename allocator_traits<Alloc>::template rebind_alloc<T>;
 
-                return nullptr;
+                alloc_t talloc{alloc_};
+                allocator_traits<alloc_t>::destroy(talloc, get());
+            }
+
+            void deallocate() noexcept override
+            {
+                deallocate_payload(this, alloc_);
             }
 
         private:
-            T* data_;
-            D deleter_;
+            aligned_storage_t<sizeof(T), alignof(T)> storage_;
+            Alloc alloc_;
+    };
 
-            /**
-             * We're using a trick where refcount_ > 0
-             * means weak_refcount_ has 1 added to it,
-             * this makes it easier for weak_ptrs that
-             * can't decrement the weak_refcount_ to
-             * zero with shared_ptrs using this object.
-             */
-            refcount_t refcount_;
-            refcount_t weak_refcount_;
+    template<class T>
+    class shared_inplace_payload<T, void>: public shared_payload_base
+    {
+        public:
+            template<class... Args>
+            shared_inplace_payload(Args&&... args)
+            {
+                ::new(static_cast<void*>(get())) T(forward<Args>(args)...);
+            }
+
+            T* get() noexcept
+            {
+                return reinterpret_cast<T*>(&storage_);
+            }
+
+        protected:
+            void destroy_object() noexcept override
+            {
+                get()->~T();
+            }
+
+            void deallocate() noexcept override
+            {
+                delete this;
+            }
+
+        private:
+            aligned_storage_t<sizeof(T), alignof(T)> storage_;
     };
 }
 
@@ -32,11 +32,13 @@
 #include <__bits/functional/arithmetic_operations.hpp>
 #include <__bits/functional/hash.hpp>
 #include <__bits/memory/allocator_arg.hpp>
+#include <__bits/memory/allocator_traits.hpp>
 #include <__bits/memory/shared_payload.hpp>
 #include <__bits/memory/unique_ptr.hpp>
 #include <__bits/trycatch.hpp>
 #include <exception>
 #include <type_traits>
+#include <typeinfo>
 
 namespace std
 {
@@ -85,7 +87,7 @@ namespace std
             {
                 try
                 {
-                    payload_ = new aux::shared_payload<T>{ptr};
+                    payload_ = new aux::shared_payload<U>{ptr};
                 }
                 catch (const bad_alloc&)
                 {
@@ -100,11 +102,11 @@ namespace std
                 U* ptr, D deleter,
                 enable_if_t<is_convertible_v<U*, element_type*>>* = nullptr
             )
-                : shared_ptr{}
+                : payload_{}, data_{ptr}
             {
                 try
                 {
-                    payload_ = new aux::shared_payload<T, D>{ptr, deleter};
+                    payload_ = new aux::shared_payload<U, D>{ptr, deleter};
                 }
                 catch (const bad_alloc&)
                 {
@@ -116,14 +118,21 @@ namespace std
 
             template<class U, class D, class A>
             shared_ptr(
-                U* ptr, D deleter, A,
+                U* ptr, D deleter, A alloc,
                 enable_if_t<is_convertible_v<U*, element_type*>>* = nullptr
             )
-                : shared_ptr{}
+                : payload_{}, data_{ptr}
             {
+                using payload_t = aux::shared_payload<U, D, A>;
+                using alloc_t = typename allocator_traits<A>::template rebind_alloc<payload_t>;
+
                 try
                 {
-                    payload_ = new aux::shared_payload<T, D>{ptr, deleter};
+                    alloc_t palloc{alloc};
+                    auto payload = allocator_traits<alloc_t>::allocate(palloc, 1);
+                    payload_ = ::new(static_cast<void*>(payload)) payload_t{
+                        ptr, deleter, alloc
+                    };
                 }
                 catch (const bad_alloc&)
                 {
@@ -197,14 +206,11 @@ namespace std
             )
                 : payload_{}, data_{}
             {
-                if (other.expired())
+                if (!other.payload_ || !other.payload_->lock())
                     throw bad_weak_ptr{};
 
-                if (other.payload_)
-                {
-                    payload_ = other.payload_->lock();
-                    data_ = payload_->get();
-                }
+                payload_ = other.payload_;
+                data_ = other.data_;
             }
 
             template<class U, class D>
@@ -371,26 +377,27 @@ namespace std
             }
 
         private:
-            aux::shared_payload_base<element_type>* payload_;
+            aux::shared_payload_base* payload_;
             element_type* data_;
 
-            shared_ptr(aux::payload_tag_t, aux::shared_payload_base<element_type>* payload)
-                : payload_{payload}, data_{payload->get()}
+            /**
+             * Adopts a reference that has already been
+             * acquired (or created) by the caller.
+             */
+            shared_ptr(aux::payload_tag_t, aux::shared_payload_base* payload,
+                       element_type* data)
+                : payload_{payload}, data_{data}
             { /* DUMMY BODY */ }
 
             void remove_payload_()
             {
                 if (payload_)
                 {
-                    auto res = payload_->decrement();
-                    if (res)
-                        payload_->destroy();
-
+                    payload_->decrement();
                     payload_ = nullptr;
                 }
 
-                if (data_)
-                    data_ = nullptr;
+                data_ = nullptr;
             }
 
             template<class U, class... Args>
@@ -400,7 +407,10 @@ namespace std
             friend shared_ptr<U> allocate_shared(const A&, Args&&...);
 
             template<class D, class U>
-            D* get_deleter(const shared_ptr<U>&) noexcept;
+            friend D* get_deleter(const shared_ptr<U>&) noexcept;
+
+            template<class U>
+            friend class shared_ptr;
 
             template<class U>
             friend class weak_ptr;
@@ -408,29 +418,32 @@ namespace std
 
     /**
      * 20.8.2.2.6, shared_ptr creation:
-     * Note: According to the standard, these two functions
-     *       should perform at most one memory allocation
-     *       (should, don't have to :P). It might be better
-     *       to create payloads that embed the type T to
-     *       perform this optimization.
+     * Note: The object is embedded in its control block,
+     *       so these perform a single memory allocation.
      */
 
     template<class T, class... Args>
     shared_ptr<T> make_shared(Args&&... args)
     {
-        return shared_ptr<T>{
-            aux::payload_tag,
-            new aux::shared_payload<T>{forward<Args>(args)...}
+        auto payload = new aux::shared_inplace_payload<T>{
+            forward<Args>(args)...
         };
+
+        return shared_ptr<T>{aux::payload_tag, payload, payload->get()};
     }
 
     template<class T, class A, class... Args>
     shared_ptr<T> allocate_shared(const A& alloc, Args&&... args)
     {
-        return shared_ptr<T>{
-            aux::payload_tag,
-            new aux::shared_payload<T>{allocator_arg, A{alloc}, forward<Args>(args)...}
-        };
+        using payload_t = aux::shared_inplace_payload<T, A>;
+        using alloc_t = typename allocator_traits<A>::template rebind_alloc<payload_t>;
+
+        alloc_t palloc{alloc};
+        auto payload = ::new(static_cast<void*>(
+            allocator_traits<alloc_t>::allocate(palloc, 1)
+        )) payload_t{alloc, forward<Args>(args)...};
+
+        return shared_ptr<T>{aux::payload_tag, payload, payload->get()};
     }
 
     /**
@@ -598,7 +611,7 @@ namespace std
     D* get_deleter(const shared_ptr<T>& ptr) noexcept
     {
         if (ptr.payload_)
-            return static_cast<D*>(ptr.payload_->deleter());
+            return static_cast<D*>(ptr.payload_->deleter(typeid(D)));
         else
             return nullptr;
     }
@@ -190,8 +190,17 @@ namespace std::aux
         : aux::type_is<typename T::is_always_equal>
     { /* DUMMY BODY */ };
 
+    template<class Alloc, class T>
+    struct alloc_rebind_first_arg
+    { /* DUMMY BODY */ };
+
+    template<template <class, class...> class Alloc, class U, class... Args, class T>
+    struct alloc_rebind_first_arg<Alloc<U, Args...>, T>
+        : aux::type_is<Alloc<T, Args...>>
+    { /* DUMMY BODY */ };
+
     template<class Alloc, class T, class = void>
-    struct alloc_get_rebind_alloc
+    struct alloc_get_rebind_alloc: alloc_rebind_first_arg<Alloc, T>
     { /* DUMMY BODY */ };
 
     template<class Alloc, class T>
@@ -199,11 +208,6 @@ namespace std::aux
         : aux::type_is<typename Alloc::template rebind<T>::other>
     { /* DUMMY BODY */ };
 
-    template<template <class, class...> class Alloc, class U, class... Args, class T>
-    struct alloc_get_rebind_alloc<Alloc<U, Args...>, T>
-        : aux::type_is<Alloc<T, Args...>>
-    { /* DUMMY BODY */ };
-
     /**
      * These metafunctions are used to check whether an expression
      * is well-formed for the static functions of allocator_traits:
@@ -216,7 +220,7 @@ namespace std::aux
     template<class Alloc, class Size, class ConstVoidPointer>
     struct alloc_has_hint_allocate<
         Alloc, Size, ConstVoidPointer, void_t<
-            decltype(declval<Alloc>().alloc(declval<Size>(), declval<ConstVoidPointer>()))
+            decltype(declval<Alloc>().allocate(declval<Size>(), declval<ConstVoidPointer>()))
         >
     >: true_type
     { /* DUMMY BODY */ };
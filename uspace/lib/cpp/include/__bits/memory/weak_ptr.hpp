@@ -53,7 +53,7 @@ namespace std
              */
 
             constexpr weak_ptr() noexcept
-                : payload_{}
+                : payload_{}, data_{}
             { /* DUMMY BODY */ }
 
             template<class U>
@@ -61,14 +61,14 @@ namespace std
                 const shared_ptr<U>& other,
                 enable_if_t<is_convertible_v<U*, element_type*>>* = nullptr
             ) noexcept
-                : payload_{other.payload_}
+                : payload_{other.payload_}, data_{other.data_}
             {
                 if (payload_)
                     payload_->increment_weak();
             }
 
             weak_ptr(const weak_ptr& other) noexcept
-                : payload_{other.payload_}
+                : payload_{other.payload_}, data_{other.data_}
             {
                 if (payload_)
                     payload_->increment_weak();
@@ -79,16 +79,17 @@ namespace std
                 const weak_ptr<U>& other,
                 enable_if_t<is_convertible_v<U*, element_type*>>* = nullptr
             ) noexcept
-                : payload_{other.payload_}
+                : payload_{other.payload_}, data_{other.data_}
             {
                 if (payload_)
                     payload_->increment_weak();
             }
 
             weak_ptr(weak_ptr&& other) noexcept
-                : payload_{other.payload_}
+                : payload_{other.payload_}, data_{other.data_}
             {
                 other.payload_ = nullptr;
+                other.data_ = nullptr;
             }
 
             template<class U>
@@ -96,9 +97,10 @@ namespace std
                 weak_ptr<U>&& other,
                 enable_if_t<is_convertible_v<U*, element_type*>>* = nullptr
             ) noexcept
-                : payload_{other.payload_}
+                : payload_{other.payload_}, data_{other.data_}
             {
                 other.payload_ = nullptr;
+                other.data_ = nullptr;
             }
 
             /**
@@ -116,11 +118,13 @@ namespace std
 
             weak_ptr& operator=(const weak_ptr& rhs) noexcept
             {
+                if (rhs.payload_)
+                    rhs.payload_->increment_weak();
+
                 remove_payload_();
 
                 payload_ = rhs.payload_;
-                if (payload_)
-                    payload_->increment_weak();
+                data_ = rhs.data_;
 
                 return *this;
             }
@@ -165,6 +169,7 @@ namespace std
             void swap(weak_ptr& other) noexcept
             {
                 std::swap(payload_, other.payload_);
+                std::swap(data_, other.data_);
             }
 
             void reset() noexcept
@@ -191,7 +196,10 @@ namespace std
 
             shared_ptr<T> lock() const noexcept
             {
-                return shared_ptr{aux::payload_tag, payload_->lock()};
+                if (payload_ && payload_->lock())
+                    return shared_ptr<T>{aux::payload_tag, payload_, data_};
+                else
+                    return shared_ptr<T>{};
             }
 
             template<class U>
@@ -207,17 +215,28 @@ namespace std
             }
 
         private:
-            aux::shared_payload_base<T>* payload_;
+            aux::shared_payload_base* payload_;
+
+            /**
+             * Kept for lock(), the payload does not know
+             * the (possibly converted) element pointer.
+             */
+            element_type* data_;
 
             void remove_payload_()
             {
-                if (payload_ && payload_->decrement_weak())
-                    payload_->destroy();
+                if (payload_)
+                    payload_->decrement_weak();
+
                 payload_ = nullptr;
+                data_ = nullptr;
             }
 
             template<class U>
             friend class shared_ptr;
+
+            template<class U>
+            friend class weak_ptr;
     };
 
     /**
@@ -30,12 +30,18 @@
 #define LIBCPP_BITS_RANDOM
 
 #include <__bits/builtins.hpp>
+#include <__bits/random/sampling.hpp>
 #include <cstdint>
 #include <cstdlib>
 #include <ctime>
 #include <initializer_list>
+#include <ios>
+#include <iosfwd>
+#include <iterator>
 #include <limits>
+#include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 /**
@@ -229,16 +235,10 @@ namespace std
     >
     class mersenne_twister_engine
     {
-        // TODO: fix these
-        /* static_assert(0 < m && m <= n); */
-        /* static_assert(2 * u < w); */
-        /* static_assert(r <= w && u <= w && s <= w && t <= w && l <= w); */
-        /* /1* static_assert(w <= numeric_limits<UIntType>::digits); *1/ */
-        /* static_assert(a <= (1U << w) - 1U); */
-        /* static_assert(b <= (1U << w) - 1U); */
-        /* static_assert(c <= (1U << w) - 1U); */
-        /* static_assert(d <= (1U << w) - 1U); */
-        /* static_assert(f <= (1U << w) - 1U); */
+        static_assert(0 < m && m <= n);
+        static_assert(2 * u < w);
+        static_assert(r <= w && u <= w && s <= w && t <= w && l <= w);
+        static_assert(w <= numeric_limits<UIntType>::digits);
 
         public:
             using result_type = UIntType;
@@ -266,7 +266,7 @@ namespace std
 
             static constexpr result_type max()
             {
-                return static_cast<result_type>(aux::pow2(w)) - 1U;
+                return word_mask_;
             }
 
             static constexpr result_type default_seed = 5489U;
@@ -288,13 +288,15 @@ namespace std
 
             void seed(result_type value = default_seed)
             {
-                state_[idx_(-n)] = value % aux::pow2u(w);;
+                state_[0] = value & word_mask_;
 
-                for (long long i = 1 - n; i <= -1; ++i)
+                for (size_t i = 1; i < n; ++i)
                 {
-                    state_[idx_(i)] = (f * (state_[idx_(i - 1)] ^
-                                      (state_[idx_(i - 1)] >> (w - 2))) + 1 % n) % aux::pow2u(w);
+                    auto prev = state_[i - 1];
+                    state_[i] = (f * (prev ^ (prev >> (w - 2))) + i) & word_mask_;
                 }
+
+                i_ = n;
             }
 
             template<class Seq>
@@ -302,30 +304,96 @@ namespace std
                 enable_if_t<aux::is_seed_sequence_v<Seq, result_type>, Seq&> q
             )
             {
-                auto k = static_cast<size_t>(w / 32);
-                auto arr = new result_type[n * k];
+                constexpr size_t k = (w + 31) / 32;
+                uint_least32_t arr[n * k];
                 q.generate(arr, arr + n * k);
 
-                for (long long i = -n; i <= -1; ++i)
+                bool zero{true};
+                for (size_t i = 0; i < n; ++i)
                 {
-                    state_[idx_(i)] = result_type{};
-                    for (long long j = 0; j < k; ++j)
-                        state_[idx_(i)] += arr[k * (i + n) + j] * aux::pow2(32 * j);
-                    state_[idx_(i)] %= aux::pow2(w);
+                    result_type val{};
+                    for (size_t j = k; j > 0; --j)
+                    {
+                        if constexpr (w > 32)
+                            val <<= 32;
+                        val |= static_cast<result_type>(arr[k * i + j - 1] & 0xFFFFFFFFU);
+                    }
+                    state_[i] = val & word_mask_;
+
+                    if (i == 0)
+                        zero = (state_[0] & upper_mask_) == 0;
+                    else if (state_[i] != 0)
+                        zero = false;
                 }
 
-                delete[] arr;
+                if (zero)
+                    state_[0] = result_type{1} << (w - 1);
+
+                i_ = n;
             }
 
             result_type operator()()
             {
-                return generate_();
+                if (i_ >= n)
+                    twist_();
+
+                return temper_(state_[i_++]);
+            }
+
+            /**
+             * Fills the range with the following outputs of
+             * the engine, the state is regenerated n words at
+             * a time and the loop over them is free of the
+             * per call bookkeeping of operator().
+             * Note: This is an extension, the result is the
+             *       same as that of n calls of operator().
+             */
+            template<class OutputIterator>
+            void generate(OutputIterator first, OutputIterator last)
+            {
+                while (first != last)
+                {
+                    if (i_ >= n)
+                        twist_();
+
+                    auto idx = i_;
+                    if constexpr (is_base_of_v<
+                        random_access_iterator_tag,
+                        typename iterator_traits<OutputIterator>::iterator_category
+                    >)
+                    {
+                        auto count = static_cast<size_t>(last - first);
+                        if (count > n - idx)
+                            count = n - idx;
+
+                        for (size_t k = 0; k < count; ++k)
+                            first[k] = temper_(state_[idx + k]);
+                        first += count;
+                        idx += count;
+                    }
+                    else
+                    {
+                        while (idx < n && first != last)
+                            *first++ = temper_(state_[idx++]);
+                    }
+                    i_ = idx;
+                }
             }
 
             void discard(unsigned long long z)
             {
-                for (unsigned long long i = 0ULL; i < z; ++i)
-                    transition_();
+                while (z > 0)
+                {
+                    if (i_ >= n)
+                        twist_();
+
+                    auto step = static_cast<unsigned long long>(n - i_);
+                    if (step > z)
+                        step = z;
+
+                    i_ += static_cast<size_t>(step);
+                    z -= step;
+                }
             }
 
             bool operator==(const mersenne_twister_engine& rhs) const
@@ -347,39 +415,42 @@ namespace std
                 return !(*this == rhs);
             }
 
+            /**
+             * Note: The state is written as the current block
+             *       of words followed by the position in it,
+             *       the words that the standard representation
+             *       needs are no longer kept by the batched
+             *       regeneration.
+             */
             template<class Char, class Traits>
             basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os) const
             {
                 auto flags = os.flags();
                 os.flags(ios_base::dec | ios_base::left);
 
-                for (size_t j = n + 1; j > 1; --j)
-                {
-                    os << state_[idx_(i_ - j - 1)];
-
-                    if (j > 2)
-                        os << os.widen(' ');
-                }
+                for (size_t i = 0; i < n; ++i)
+                    os << state_[i] << os.widen(' ');
+                os << i_;
 
                 os.flags(flags);
                 return os;
             }
 
             template<class Char, class Traits>
-            basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is) const
+            basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is)
             {
                 auto flags = is.flags();
                 is.flags(ios_base::dec);
 
-                for (size_t j = n + 1; j > 1; --j)
+                for (size_t i = 0; i < n; ++i)
                 {
-                    if (!(is >> state_[idx_(i_ - j - 1)]))
-                    {
-                        is.setstate(ios::failbit);
+                    if (!(is >> state_[i]))
                         break;
-                    }
                 }
 
+                if (!is || !(is >> i_) || i_ > n)
+                    is.setstate(ios::failbit);
+
                 is.flags(flags);
                 return is;
             }
@@ -388,36 +459,46 @@ namespace std
             result_type state_[n];
             size_t i_;
 
-            void transition_()
+            static constexpr result_type word_mask_ =
+                (w == numeric_limits<result_type>::digits) ?
+                ~result_type{} : ((result_type{1} << (w % numeric_limits<result_type>::digits)) - 1);
+            static constexpr result_type lower_mask_ =
+                (r == 0) ? result_type{} : (word_mask_ >> (w - r));
+            static constexpr result_type upper_mask_ = word_mask_ & ~lower_mask_;
+
+            /**
+             * Computes the next n words of the state at once,
+             * which splits the transition into loops without
+             * the wrap around of the indices.
+             */
+            void twist_()
             {
-                auto mask = (result_type{1} << r) - 1;
-                auto y = (state_[idx_(i_ - n)] & ~mask) | (state_[idx_(i_ + 1 - n)] & mask);
-                auto alpha = a * (y & 1);
-                state_[i_] = state_[idx_(i_ + m - n)] ^ (y >> 1) ^ alpha;
+                auto next = [](result_type lo, result_type hi, result_type shifted){
+                    auto y = (lo & upper_mask_) | (hi & lower_mask_);
 
-                i_ = (i_ + 1) % n;
-            }
+                    return shifted ^ (y >> 1) ^ ((result_type{} - (y & 1)) & a);
+                };
 
-            result_type generate_()
-            {
-                auto z1 = state_[i_] ^ ((state_[i_] >> u) & d);
-                auto z2 = z1 ^ (lshift_(z1, s) & b);
-                auto z3 = z2 ^ (lshift_(z2, t) & c);
-                auto z4 = z3 ^ (z3 >> l);
+                size_t k{};
+                for (; k < n - m; ++k)
+                    state_[k] = next(state_[k], state_[k + 1], state_[k + m]);
 
-                transition_();
+                for (; k < n - 1; ++k)
+                    state_[k] = next(state_[k], state_[k + 1], state_[k + m - n]);
 
-                return z4;
-            }
+                state_[n - 1] = next(state_[n - 1], state_[0], state_[m - 1]);
 
-            size_t idx_(size_t idx) const
-            {
-                return idx % n;
+                i_ = 0;
             }
 
-            result_type lshift_(result_type val, size_t count)
+            static result_type temper_(result_type x)
             {
-                return (val << count) % aux::pow2u(w);
+                x ^= (x >> u) & d;
+                x ^= (x << s) & b;
+                x ^= (x << t) & c;
+                x ^= x >> l;
+
+                return x & word_mask_;
             }
     };
 
@@ -1188,17 +1269,13 @@ namespace std
             template<class URNG>
             result_type operator()(URNG& g)
             {
-                auto range = b_ - a_ + 1;
-
-                return g() % range + a_;
+                return generate_(g, a_, b_);
             }
 
             template<class URNG>
             result_type operator()(URNG& g, const param_type& p)
             {
-                auto range = p.second - p.first + 1;
-
-                return g() % range + p.first;
+                return generate_(g, p.first, p.second);
             }
 
             result_type a() const
@@ -1270,6 +1347,30 @@ namespace std
         private:
             result_type a_;
             result_type b_;
+
+            /**
+             * Rejects the few lowest values that would make
+             * some results more likely than the others and
+             * maps the rest with a single division.
+             */
+            template<class URNG>
+            static result_type generate_(URNG& g, result_type a, result_type b)
+            {
+                using work_type = conditional_t<
+                    sizeof(result_type) <= sizeof(uint32_t), uint32_t, uint64_t
+                >;
+
+                work_type range = static_cast<work_type>(b) - static_cast<work_type>(a) + 1;
+                if (range == 0)
+                    return static_cast<result_type>(aux::random_bits<work_type>(g));
+
+                auto threshold = static_cast<work_type>(-range) % range;
+                auto bits = aux::random_bits<work_type>(g);
+                while (bits < threshold)
+                    bits = aux::random_bits<work_type>(g);
+
+                return static_cast<result_type>(static_cast<work_type>(a) + bits % range);
+            }
     };
 
     /**
@@ -1298,21 +1399,13 @@ namespace std
             template<class URNG>
             result_type operator()(URNG& g)
             {
-                auto range = b_ - a_ + 1;
-
-                return generate_canonical<
-                    result_type, numeric_limits<result_type>::digits
-                >(g) * range + a_;
+                return aux::random_canonical<result_type>(g) * (b_ - a_) + a_;
             }
 
             template<class URNG>
             result_type operator()(URNG& g, const param_type& p)
             {
-                auto range = p.second - p.first + 1;
-
-                return generate_canonical<
-                    result_type, numeric_limits<result_type>::digits
-                >(g) * range + p.first;
+                return aux::random_canonical<result_type>(g) * (p.second - p.first) + p.first;
             }
 
             result_type a() const
@@ -1411,17 +1504,13 @@ namespace std
             template<class URNG>
             result_type operator()(URNG& g)
             {
-                uniform_real_distribution<float> dist{};
-
-                return dist(g) < prob_;
+                return aux::random_canonical<float>(g) < prob_;
             }
 
             template<class URNG>
-            result_type operator()(const param_type& p)
+            result_type operator()(URNG& g, const param_type& p)
             {
-                uniform_real_distribution<float> dist{};
-
-                return dist(p) < prob_;
+                return aux::random_canonical<float>(g) < p;
             }
 
             double p() const
@@ -1458,126 +1547,2765 @@ namespace std
             float prob_;
     };
 
-    // TODO: complete the rest of the distributions
+    namespace aux
+    {
+        /**
+         * The distributions below are written as their parameters
+         * separated by spaces, reals with enough digits to be read
+         * back exactly and vectors prefixed with their size.
+         */
+        template<class Char, class Traits, class T>
+        void write_distribution_param(basic_ostream<Char, Traits>& os, const T& val)
+        {
+            // Note: Unqualified numeric_limits would be aux::numeric_limits.
+            if constexpr (is_floating_point_v<T>)
+                os.precision(std::numeric_limits<T>::max_digits10 - 1);
 
-    /**
-     * 26.5.8.3.2, class template binomial_distribution:
-     */
+            os << val;
+        }
 
-    template<class IntType = int>
-    class binomial_distribution;
+        template<class Char, class Traits, class T>
+        void write_distribution_param(basic_ostream<Char, Traits>& os, const vector<T>& vec)
+        {
+            os << vec.size();
+            for (const auto& val: vec)
+            {
+                os << os.widen(' ');
+                write_distribution_param(os, val);
+            }
+        }
 
-    /**
-     * 26.5.8.3.3, class template geometric_distribution:
-     */
+        template<class Char, class Traits, class T, class... Ts>
+        basic_ostream<Char, Traits>& write_distribution(basic_ostream<Char, Traits>& os,
+                                                        const T& param, const Ts&... params)
+        {
+            auto flags = os.flags();
+            auto precision = os.precision();
+            auto fill = os.fill();
+            os.flags(ios_base::dec | ios_base::left | ios_base::scientific);
+            os.fill(os.widen(' '));
+
+            write_distribution_param(os, param);
+            ((os << os.widen(' '), write_distribution_param(os, params)), ...);
+
+            os.flags(flags);
+            os.precision(precision);
+            os.fill(fill);
+            return os;
+        }
 
-    template<class IntType = int>
-    class geometric_distribution;
+        template<class Char, class Traits, class T>
+        void read_distribution_param(basic_istream<Char, Traits>& is, T& val)
+        {
+            is >> val;
+        }
+
+        template<class Char, class Traits, class T>
+        void read_distribution_param(basic_istream<Char, Traits>& is, vector<T>& vec)
+        {
+            size_t size{};
+            is >> size;
+
+            vec.clear();
+            for (size_t i = 0; i < size && is; ++i)
+            {
+                T val{};
+                if (is >> val)
+                    vec.push_back(val);
+            }
+        }
+
+        template<class Char, class Traits, class... Ts>
+        basic_istream<Char, Traits>& read_distribution(basic_istream<Char, Traits>& is,
+                                                       Ts&... params)
+        {
+            auto flags = is.flags();
+            is.flags(ios_base::dec | ios_base::skipws);
+
+            (read_distribution_param(is, params), ...);
+
+            is.flags(flags);
+            return is;
+        }
+    }
 
     /**
-     * 26.5.8.3.4, class template negative_binomial_distribution:
+     * Note: The distributions below sample with algorithms
+     *       that avoid transcendental functions on their
+     *       common paths, see <__bits/random/sampling.hpp>.
      */
 
-    template<class IntType = int>
-    class negative_binomial_distribution;
-
     /**
-     * 26.5.8.4.1, class template poisson_distribution:
+     * 26.5.8.3.2, class template binomial_distribution:
      */
 
     template<class IntType = int>
-    class poisson_distribution;
+    class binomial_distribution
+    {
+        public:
+            using result_type = IntType;
 
-    /**
-     * 26.5.8.4.2, class template exponential_distribution:
-     */
+            class param_type
+            {
+                public:
+                    using distribution_type = binomial_distribution;
 
-    template<class RealType = double>
-    class exponential_distribution;
+                    explicit param_type(result_type t = 1, double p = 0.5)
+                        : t_{t}, p_{p}, small_p_{p <= 0.5 ? p : 1 - p},
+                          btrs_{t * small_p_ >= 10}, a_{}, b_{}, c_{},
+                          alpha_{}, vr_{}, m_{}, lpq_{}, h_{}, r_{}, s_{}
+                    {
+                        auto q = 1 - small_p_;
+
+                        if (btrs_)
+                        {
+                            auto spq = aux::sqrt(t * small_p_ * q);
+                            b_ = 1.15 + 2.53 * spq;
+                            a_ = -0.0873 + 0.0248 * b_ + 0.01 * small_p_;
+                            c_ = t * small_p_ + 0.5;
+                            alpha_ = (2.83 + 5.1 / b_) * spq;
+                            vr_ = 0.92 - 4.2 / b_;
+                            m_ = aux::floor((t + 1) * small_p_);
+                            lpq_ = aux::log(small_p_ / q);
+                            h_ = aux::log_factorial(m_) + aux::log_factorial(t - m_);
+                        }
+                        else if (small_p_ > 0)
+                        {
+                            r_ = aux::pow(q, static_cast<double>(t));
+                            s_ = small_p_ / q;
+                        }
+                    }
 
-    /**
-     * 26.5.8.4.3, class template gamma_distribution:
-     */
+                    result_type t() const
+                    {
+                        return t_;
+                    }
 
-    template<class RealType = double>
-    class gamma_distribution;
+                    double p() const
+                    {
+                        return p_;
+                    }
 
-    /**
-     * 26.5.8.4.4, class template weibull_distribution:
-     */
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return t_ == rhs.t_ && p_ == rhs.p_;
+                    }
 
-    template<class RealType = double>
-    class weibull_distribution;
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
 
-    /**
-     * 26.5.8.4.5, class template extreme_value_distribution:
-     */
+                private:
+                    result_type t_;
+                    double p_;
+                    double small_p_;
+
+                    bool btrs_;
+                    double a_;
+                    double b_;
+                    double c_;
+                    double alpha_;
+                    double vr_;
+                    double m_;
+                    double lpq_;
+                    double h_;
+
+                    double r_;
+                    double s_;
+
+                    friend class binomial_distribution;
+            };
+
+            explicit binomial_distribution(result_type t = 1, double p = 0.5)
+                : param_{t, p}
+            { /* DUMMY BODY */ }
 
-    template<class RealType = double>
-    class extreme_value_distribution;
+            explicit binomial_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
 
-    /**
-     * 26.5.8.5.1, class template normal_distribution:
-     */
+            void reset()
+            { /* DUMMY BODY */ }
 
-    template<class RealType = double>
-    class normal_distribution;
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
 
-    /**
-     * 26.5.8.5.2, class template lognormal_distribution:
-     */
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                if (p.small_p_ <= 0)
+                    return (p.p_ <= 0.5) ? 0 : p.t_;
 
-    template<class RealType = double>
-    class lognormal_distribution;
+                auto res = p.btrs_ ? btrs_(g, p) : inversion_(g, p);
 
-    /**
-     * 26.5.8.5.3, class template chi_squared_distribution:
-     */
+                return (p.p_ <= 0.5) ? res : p.t_ - res;
+            }
 
-    template<class RealType = double>
-    class chi_squared_distribution;
+            result_type t() const
+            {
+                return param_.t();
+            }
 
-    /**
-     * 26.5.8.5.4, class template cauchy_distribution:
-     */
+            double p() const
+            {
+                return param_.p();
+            }
 
-    template<class RealType = double>
-    class cauchy_distribution;
+            param_type param() const
+            {
+                return param_;
+            }
 
-    /**
-     * 26.5.8.5.5, class template fisher_f_distribution:
-     */
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
 
-    template<class RealType = double>
-    class fisher_f_distribution;
+            result_type min() const
+            {
+                return 0;
+            }
 
-    /**
-     * 26.5.8.5.6, class template student_t_distribution:
-     */
+            result_type max() const
+            {
+                return param_.t();
+            }
 
-    template<class RealType = double>
-    class student_t_distribution;
+            bool operator==(const binomial_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const binomial_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const binomial_distribution& d)
+            {
+                return aux::write_distribution(os, d.t(), d.p());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          binomial_distribution& d)
+            {
+                result_type t{};
+                double p{};
+
+                if (aux::read_distribution(is, t, p))
+                    d.param(param_type{t, p});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+
+            /**
+             * Sequential search from zero, which takes t * p
+             * steps on average (Kachitvichyanukul and Schmeiser).
+             */
+            template<class URNG>
+            static result_type inversion_(URNG& g, const param_type& p)
+            {
+                auto a = (p.t_ + 1) * p.s_;
+
+                while (true)
+                {
+                    auto u = aux::random_canonical<double>(g);
+                    auto r = p.r_;
+
+                    result_type x{};
+                    while (u > r)
+                    {
+                        u -= r;
+                        ++x;
+                        if (x > p.t_)
+                            break;
+                        r *= a / x - p.s_;
+                    }
+
+                    if (x <= p.t_)
+                        return x;
+                }
+            }
+
+            /**
+             * Transformed rejection with squeeze, BTRS
+             * from Hormann (1993), valid for t * p >= 10.
+             */
+            template<class URNG>
+            static result_type btrs_(URNG& g, const param_type& p)
+            {
+                while (true)
+                {
+                    auto u = aux::random_canonical<double>(g) - 0.5;
+                    auto v = aux::random_canonical<double>(g);
+                    auto us = 0.5 - (u < 0 ? -u : u);
+                    auto k = aux::random_floor((2 * p.a_ / us + p.b_) * u + p.c_);
+
+                    if (k < 0 || k > p.t_)
+                        continue;
+
+                    if (us >= 0.07 && v <= p.vr_)
+                        return static_cast<result_type>(k);
+
+                    v = aux::log(v * p.alpha_ / (p.a_ / (us * us) + p.b_));
+                    if (v <= p.h_ - aux::log_factorial(k) - aux::log_factorial(p.t_ - k) +
+                             (k - p.m_) * p.lpq_)
+                        return static_cast<result_type>(k);
+                }
+            }
+    };
 
     /**
-     * 26.5.8.6.1, class template discrete_distribution:
+     * 26.5.8.3.3, class template geometric_distribution:
      */
 
     template<class IntType = int>
-    class discrete_distribution;
+    class geometric_distribution
+    {
+        public:
+            using result_type = IntType;
 
-    /**
-     * 26.5.8.6.2, class template piecewise_constant_distribution:
-     */
+            class param_type
+            {
+                public:
+                    using distribution_type = geometric_distribution;
 
-    template<class RealType = double>
-    class piecewise_constant_distribution;
+                    explicit param_type(double p = 0.5)
+                        : p_{p}, log_q_{aux::log1p(-p)}
+                    { /* DUMMY BODY */ }
 
-    /**
-     * 26.5.8.6.3, class template piecewise_linear_distribution:
-     */
+                    double p() const
+                    {
+                        return p_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return p_ == rhs.p_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    double p_;
+                    double log_q_;
+
+                    friend class geometric_distribution;
+            };
+
+            explicit geometric_distribution(double p = 0.5)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            explicit geometric_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            /**
+             * Inversion, the number of failures before the
+             * first success is floor(log(U) / log(1 - p)).
+             */
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                if (p.p_ >= 1)
+                    return 0;
+
+                auto res = aux::log(aux::random_open01(g)) / p.log_q_;
+                auto limit = static_cast<double>(numeric_limits<result_type>::max());
+
+                return (res < limit) ? static_cast<result_type>(res) : numeric_limits<result_type>::max();
+            }
+
+            double p() const
+            {
+                return param_.p();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return 0;
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const geometric_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const geometric_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const geometric_distribution& d)
+            {
+                return aux::write_distribution(os, d.p());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          geometric_distribution& d)
+            {
+                double p{};
+
+                if (aux::read_distribution(is, p))
+                    d.param(param_type{p});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    template<class IntType>
+    class poisson_distribution;
+
+    /**
+     * 26.5.8.3.4, class template negative_binomial_distribution:
+     */
+
+    template<class IntType = int>
+    class negative_binomial_distribution
+    {
+        public:
+            using result_type = IntType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = negative_binomial_distribution;
+
+                    explicit param_type(result_type k = 1, double p = 0.5)
+                        : k_{k}, p_{p}
+                    { /* DUMMY BODY */ }
+
+                    result_type k() const
+                    {
+                        return k_;
+                    }
+
+                    double p() const
+                    {
+                        return p_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return k_ == rhs.k_ && p_ == rhs.p_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type k_;
+                    double p_;
+            };
+
+            explicit negative_binomial_distribution(result_type k = 1, double p = 0.5)
+                : param_{k, p}
+            { /* DUMMY BODY */ }
+
+            explicit negative_binomial_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            /**
+             * A Poisson variable whose mean is drawn from the
+             * gamma distribution with shape k and scale
+             * (1 - p) / p.
+             */
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                if (p.p() >= 1)
+                    return 0;
+
+                auto mean = aux::gamma_unit(g, p.k()) * (1 - p.p()) / p.p();
+                poisson_distribution<result_type> poisson{mean};
+
+                return poisson(g);
+            }
+
+            result_type k() const
+            {
+                return param_.k();
+            }
+
+            double p() const
+            {
+                return param_.p();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return 0;
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const negative_binomial_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const negative_binomial_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const negative_binomial_distribution& d)
+            {
+                return aux::write_distribution(os, d.k(), d.p());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          negative_binomial_distribution& d)
+            {
+                result_type k{};
+                double p{};
+
+                if (aux::read_distribution(is, k, p))
+                    d.param(param_type{k, p});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.4.1, class template poisson_distribution:
+     */
+
+    template<class IntType = int>
+    class poisson_distribution
+    {
+        public:
+            using result_type = IntType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = poisson_distribution;
+
+                    explicit param_type(double mean = 1.0)
+                        : mean_{mean}, ptrs_{mean >= 10}, exp_neg_mean_{},
+                          a_{}, b_{}, inv_alpha_{}, vr_{}, log_mean_{}
+                    {
+                        if (ptrs_)
+                        {
+                            b_ = 0.931 + 2.53 * aux::sqrt(mean);
+                            a_ = -0.059 + 0.02483 * b_;
+                            inv_alpha_ = aux::log(1.1239 + 1.1328 / (b_ - 3.4));
+                            vr_ = 0.9277 - 3.6224 / (b_ - 2);
+                            log_mean_ = aux::log(mean);
+                        }
+                        else
+                            exp_neg_mean_ = aux::exp(-mean);
+                    }
+
+                    double mean() const
+                    {
+                        return mean_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return mean_ == rhs.mean_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    double mean_;
+
+                    bool ptrs_;
+                    double exp_neg_mean_;
+                    double a_;
+                    double b_;
+                    double inv_alpha_;
+                    double vr_;
+                    double log_mean_;
+
+                    friend class poisson_distribution;
+            };
+
+            explicit poisson_distribution(double mean = 1.0)
+                : param_{mean}
+            { /* DUMMY BODY */ }
+
+            explicit poisson_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                if (p.ptrs_)
+                    return ptrs_(g, p);
+
+                /**
+                 * Sequential search from zero for small means.
+                 */
+                auto u = aux::random_canonical<double>(g);
+                auto prob = p.exp_neg_mean_;
+
+                result_type k{};
+                while (u > prob && prob > 0)
+                {
+                    u -= prob;
+                    ++k;
+                    prob *= p.mean_ / k;
+                }
+
+                return k;
+            }
+
+            double mean() const
+            {
+                return param_.mean();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return 0;
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const poisson_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const poisson_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const poisson_distribution& d)
+            {
+                return aux::write_distribution(os, d.mean());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          poisson_distribution& d)
+            {
+                double mean{};
+
+                if (aux::read_distribution(is, mean))
+                    d.param(param_type{mean});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+
+            /**
+             * Transformed rejection with squeeze, PTRS
+             * from Hormann (1993), valid for mean >= 10.
+             * Note: inv_alpha_ holds the logarithm.
+             */
+            template<class URNG>
+            static result_type ptrs_(URNG& g, const param_type& p)
+            {
+                while (true)
+                {
+                    auto u = aux::random_canonical<double>(g) - 0.5;
+                    auto v = aux::random_open01(g);
+                    auto us = 0.5 - (u < 0 ? -u : u);
+                    auto k = aux::random_floor((2 * p.a_ / us + p.b_) * u + p.mean_ + 0.43);
+
+                    if (us >= 0.07 && v <= p.vr_)
+                        return static_cast<result_type>(k);
+
+                    if (k < 0 || (us < 0.013 && v > us))
+                        continue;
+
+                    if (aux::log(v) + p.inv_alpha_ - aux::log(p.a_ / (us * us) + p.b_) <=
+                        -p.mean_ + k * p.log_mean_ - aux::log_factorial(k))
+                        return static_cast<result_type>(k);
+                }
+            }
+    };
+
+    /**
+     * 26.5.8.4.2, class template exponential_distribution:
+     */
+
+    template<class RealType = double>
+    class exponential_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = exponential_distribution;
+
+                    explicit param_type(result_type lambda = 1.0)
+                        : lambda_{lambda}
+                    { /* DUMMY BODY */ }
+
+                    result_type lambda() const
+                    {
+                        return lambda_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return lambda_ == rhs.lambda_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type lambda_;
+            };
+
+            explicit exponential_distribution(result_type lambda = 1.0)
+                : param_{lambda}
+            { /* DUMMY BODY */ }
+
+            explicit exponential_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                return static_cast<result_type>(aux::ziggurat_exponential(g) / p.lambda());
+            }
+
+            result_type lambda() const
+            {
+                return param_.lambda();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return result_type{};
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const exponential_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const exponential_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const exponential_distribution& d)
+            {
+                return aux::write_distribution(os, d.lambda());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          exponential_distribution& d)
+            {
+                result_type lambda{};
+
+                if (aux::read_distribution(is, lambda))
+                    d.param(param_type{lambda});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.4.3, class template gamma_distribution:
+     */
+
+    template<class RealType = double>
+    class gamma_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = gamma_distribution;
+
+                    explicit param_type(result_type alpha = 1.0, result_type beta = 1.0)
+                        : alpha_{alpha}, beta_{beta}
+                    { /* DUMMY BODY */ }
+
+                    result_type alpha() const
+                    {
+                        return alpha_;
+                    }
+
+                    result_type beta() const
+                    {
+                        return beta_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return alpha_ == rhs.alpha_ && beta_ == rhs.beta_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type alpha_;
+                    result_type beta_;
+            };
+
+            explicit gamma_distribution(result_type alpha = 1.0, result_type beta = 1.0)
+                : param_{alpha, beta}
+            { /* DUMMY BODY */ }
+
+            explicit gamma_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                return static_cast<result_type>(aux::gamma_unit(g, p.alpha()) * p.beta());
+            }
+
+            result_type alpha() const
+            {
+                return param_.alpha();
+            }
+
+            result_type beta() const
+            {
+                return param_.beta();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return result_type{};
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const gamma_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const gamma_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const gamma_distribution& d)
+            {
+                return aux::write_distribution(os, d.alpha(), d.beta());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          gamma_distribution& d)
+            {
+                result_type alpha{};
+                result_type beta{};
+
+                if (aux::read_distribution(is, alpha, beta))
+                    d.param(param_type{alpha, beta});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.4.4, class template weibull_distribution:
+     */
+
+    template<class RealType = double>
+    class weibull_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = weibull_distribution;
+
+                    explicit param_type(result_type a = 1.0, result_type b = 1.0)
+                        : a_{a}, b_{b}
+                    { /* DUMMY BODY */ }
+
+                    result_type a() const
+                    {
+                        return a_;
+                    }
+
+                    result_type b() const
+                    {
+                        return b_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return a_ == rhs.a_ && b_ == rhs.b_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type a_;
+                    result_type b_;
+            };
+
+            explicit weibull_distribution(result_type a = 1.0, result_type b = 1.0)
+                : param_{a, b}
+            { /* DUMMY BODY */ }
+
+            explicit weibull_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                auto e = aux::ziggurat_exponential(g);
+
+                return static_cast<result_type>(p.b() * aux::pow(e, 1.0 / p.a()));
+            }
+
+            result_type a() const
+            {
+                return param_.a();
+            }
+
+            result_type b() const
+            {
+                return param_.b();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return result_type{};
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const weibull_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const weibull_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const weibull_distribution& d)
+            {
+                return aux::write_distribution(os, d.a(), d.b());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          weibull_distribution& d)
+            {
+                result_type a{};
+                result_type b{};
+
+                if (aux::read_distribution(is, a, b))
+                    d.param(param_type{a, b});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.4.5, class template extreme_value_distribution:
+     */
+
+    template<class RealType = double>
+    class extreme_value_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = extreme_value_distribution;
+
+                    explicit param_type(result_type a = 0.0, result_type b = 1.0)
+                        : a_{a}, b_{b}
+                    { /* DUMMY BODY */ }
+
+                    result_type a() const
+                    {
+                        return a_;
+                    }
+
+                    result_type b() const
+                    {
+                        return b_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return a_ == rhs.a_ && b_ == rhs.b_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type a_;
+                    result_type b_;
+            };
+
+            explicit extreme_value_distribution(result_type a = 0.0, result_type b = 1.0)
+                : param_{a, b}
+            { /* DUMMY BODY */ }
+
+            explicit extreme_value_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                auto e = aux::ziggurat_exponential(g);
+
+                return static_cast<result_type>(p.a() - p.b() * aux::log(e));
+            }
+
+            result_type a() const
+            {
+                return param_.a();
+            }
+
+            result_type b() const
+            {
+                return param_.b();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return numeric_limits<result_type>::lowest();
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const extreme_value_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const extreme_value_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const extreme_value_distribution& d)
+            {
+                return aux::write_distribution(os, d.a(), d.b());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          extreme_value_distribution& d)
+            {
+                result_type a{};
+                result_type b{};
+
+                if (aux::read_distribution(is, a, b))
+                    d.param(param_type{a, b});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.5.1, class template normal_distribution:
+     */
+
+    template<class RealType = double>
+    class normal_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = normal_distribution;
+
+                    explicit param_type(result_type mean = 0.0, result_type stddev = 1.0)
+                        : mean_{mean}, stddev_{stddev}
+                    { /* DUMMY BODY */ }
+
+                    result_type mean() const
+                    {
+                        return mean_;
+                    }
+
+                    result_type stddev() const
+                    {
+                        return stddev_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return mean_ == rhs.mean_ && stddev_ == rhs.stddev_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type mean_;
+                    result_type stddev_;
+            };
+
+            explicit normal_distribution(result_type mean = 0.0, result_type stddev = 1.0)
+                : param_{mean, stddev}
+            { /* DUMMY BODY */ }
+
+            explicit normal_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            /**
+             * Note: The ziggurat does not produce values in
+             *       pairs, so there is nothing to forget.
+             */
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                return static_cast<result_type>(aux::ziggurat_normal(g) * p.stddev() + p.mean());
+            }
+
+            result_type mean() const
+            {
+                return param_.mean();
+            }
+
+            result_type stddev() const
+            {
+                return param_.stddev();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return numeric_limits<result_type>::lowest();
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const normal_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const normal_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const normal_distribution& d)
+            {
+                return aux::write_distribution(os, d.mean(), d.stddev());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          normal_distribution& d)
+            {
+                result_type mean{};
+                result_type stddev{};
+
+                if (aux::read_distribution(is, mean, stddev))
+                    d.param(param_type{mean, stddev});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.5.2, class template lognormal_distribution:
+     */
+
+    template<class RealType = double>
+    class lognormal_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = lognormal_distribution;
+
+                    explicit param_type(result_type m = 0.0, result_type s = 1.0)
+                        : m_{m}, s_{s}
+                    { /* DUMMY BODY */ }
+
+                    result_type m() const
+                    {
+                        return m_;
+                    }
+
+                    result_type s() const
+                    {
+                        return s_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return m_ == rhs.m_ && s_ == rhs.s_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type m_;
+                    result_type s_;
+            };
+
+            explicit lognormal_distribution(result_type m = 0.0, result_type s = 1.0)
+                : param_{m, s}
+            { /* DUMMY BODY */ }
+
+            explicit lognormal_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                return static_cast<result_type>(
+                    aux::exp(aux::ziggurat_normal(g) * p.s() + p.m())
+                );
+            }
+
+            result_type m() const
+            {
+                return param_.m();
+            }
+
+            result_type s() const
+            {
+                return param_.s();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return result_type{};
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const lognormal_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const lognormal_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const lognormal_distribution& d)
+            {
+                return aux::write_distribution(os, d.m(), d.s());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          lognormal_distribution& d)
+            {
+                result_type m{};
+                result_type s{};
+
+                if (aux::read_distribution(is, m, s))
+                    d.param(param_type{m, s});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.5.3, class template chi_squared_distribution:
+     */
+
+    template<class RealType = double>
+    class chi_squared_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = chi_squared_distribution;
+
+                    explicit param_type(result_type n = 1)
+                        : n_{n}
+                    { /* DUMMY BODY */ }
+
+                    result_type n() const
+                    {
+                        return n_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return n_ == rhs.n_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type n_;
+            };
+
+            explicit chi_squared_distribution(result_type n = 1)
+                : param_{n}
+            { /* DUMMY BODY */ }
+
+            explicit chi_squared_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                return static_cast<result_type>(2 * aux::gamma_unit(g, p.n() / 2.0));
+            }
+
+            result_type n() const
+            {
+                return param_.n();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return result_type{};
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const chi_squared_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const chi_squared_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const chi_squared_distribution& d)
+            {
+                return aux::write_distribution(os, d.n());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          chi_squared_distribution& d)
+            {
+                result_type n{};
+
+                if (aux::read_distribution(is, n))
+                    d.param(param_type{n});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.5.4, class template cauchy_distribution:
+     */
+
+    template<class RealType = double>
+    class cauchy_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = cauchy_distribution;
+
+                    explicit param_type(result_type a = 0.0, result_type b = 1.0)
+                        : a_{a}, b_{b}
+                    { /* DUMMY BODY */ }
+
+                    result_type a() const
+                    {
+                        return a_;
+                    }
+
+                    result_type b() const
+                    {
+                        return b_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return a_ == rhs.a_ && b_ == rhs.b_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type a_;
+                    result_type b_;
+            };
+
+            explicit cauchy_distribution(result_type a = 0.0, result_type b = 1.0)
+                : param_{a, b}
+            { /* DUMMY BODY */ }
+
+            explicit cauchy_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            /**
+             * The ratio of two independent standard normal
+             * variables has the standard Cauchy distribution,
+             * which saves us the tangent.
+             */
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                auto x = aux::ziggurat_normal(g);
+                auto y = aux::ziggurat_normal(g);
+
+                return static_cast<result_type>(p.a() + p.b() * x / y);
+            }
+
+            result_type a() const
+            {
+                return param_.a();
+            }
+
+            result_type b() const
+            {
+                return param_.b();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return numeric_limits<result_type>::lowest();
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const cauchy_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const cauchy_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const cauchy_distribution& d)
+            {
+                return aux::write_distribution(os, d.a(), d.b());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          cauchy_distribution& d)
+            {
+                result_type a{};
+                result_type b{};
+
+                if (aux::read_distribution(is, a, b))
+                    d.param(param_type{a, b});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.5.5, class template fisher_f_distribution:
+     */
+
+    template<class RealType = double>
+    class fisher_f_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = fisher_f_distribution;
+
+                    explicit param_type(result_type m = 1, result_type n = 1)
+                        : m_{m}, n_{n}
+                    { /* DUMMY BODY */ }
+
+                    result_type m() const
+                    {
+                        return m_;
+                    }
+
+                    result_type n() const
+                    {
+                        return n_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return m_ == rhs.m_ && n_ == rhs.n_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type m_;
+                    result_type n_;
+            };
+
+            explicit fisher_f_distribution(result_type m = 1, result_type n = 1)
+                : param_{m, n}
+            { /* DUMMY BODY */ }
+
+            explicit fisher_f_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                auto x = aux::gamma_unit(g, p.m() / 2.0) / p.m();
+                auto y = aux::gamma_unit(g, p.n() / 2.0) / p.n();
+
+                return static_cast<result_type>(x / y);
+            }
+
+            result_type m() const
+            {
+                return param_.m();
+            }
+
+            result_type n() const
+            {
+                return param_.n();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return result_type{};
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const fisher_f_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const fisher_f_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const fisher_f_distribution& d)
+            {
+                return aux::write_distribution(os, d.m(), d.n());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          fisher_f_distribution& d)
+            {
+                result_type m{};
+                result_type n{};
+
+                if (aux::read_distribution(is, m, n))
+                    d.param(param_type{m, n});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.5.6, class template student_t_distribution:
+     */
+
+    template<class RealType = double>
+    class student_t_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = student_t_distribution;
+
+                    explicit param_type(result_type n = 1)
+                        : n_{n}
+                    { /* DUMMY BODY */ }
+
+                    result_type n() const
+                    {
+                        return n_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return n_ == rhs.n_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    result_type n_;
+            };
+
+            explicit student_t_distribution(result_type n = 1)
+                : param_{n}
+            { /* DUMMY BODY */ }
+
+            explicit student_t_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                auto x = aux::ziggurat_normal(g);
+                auto chi = 2 * aux::gamma_unit(g, p.n() / 2.0);
+
+                return static_cast<result_type>(x * aux::sqrt(p.n() / chi));
+            }
+
+            result_type n() const
+            {
+                return param_.n();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return numeric_limits<result_type>::lowest();
+            }
+
+            result_type max() const
+            {
+                return numeric_limits<result_type>::max();
+            }
+
+            bool operator==(const student_t_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const student_t_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const student_t_distribution& d)
+            {
+                return aux::write_distribution(os, d.n());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          student_t_distribution& d)
+            {
+                result_type n{};
+
+                if (aux::read_distribution(is, n))
+                    d.param(param_type{n});
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+    };
+
+    /**
+     * 26.5.8.6.1, class template discrete_distribution:
+     */
+
+    template<class IntType = int>
+    class discrete_distribution
+    {
+        public:
+            using result_type = IntType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = discrete_distribution;
+
+                    param_type()
+                        : prob_{}, table_{}
+                    {
+                        init_();
+                    }
+
+                    template<class InputIterator>
+                    param_type(InputIterator first, InputIterator last)
+                        : prob_(first, last), table_{}
+                    {
+                        init_();
+                    }
+
+                    param_type(initializer_list<double> init)
+                        : prob_(init.begin(), init.end()), table_{}
+                    {
+                        init_();
+                    }
+
+                    template<class UnaryOperation>
+                    param_type(size_t nw, double xmin, double xmax, UnaryOperation fw)
+                        : prob_{}, table_{}
+                    {
+                        if (nw == 0)
+                            nw = 1;
+
+                        auto delta = (xmax - xmin) / nw;
+                        for (size_t k = 0; k < nw; ++k)
+                            prob_.push_back(fw(xmin + k * delta + delta / 2));
+
+                        init_();
+                    }
+
+                    vector<double> probabilities() const
+                    {
+                        return prob_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return prob_ == rhs.prob_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    vector<double> prob_;
+                    aux::alias_table table_;
+
+                    void init_()
+                    {
+                        if (prob_.empty())
+                            prob_.push_back(1.0);
+
+                        double total{};
+                        for (auto p: prob_)
+                            total += p;
+
+                        for (auto& p: prob_)
+                            p /= total;
+
+                        table_ = aux::alias_table{prob_};
+                    }
+
+                    friend class discrete_distribution;
+            };
+
+            discrete_distribution()
+                : param_{}
+            { /* DUMMY BODY */ }
+
+            template<class InputIterator>
+            discrete_distribution(InputIterator first, InputIterator last)
+                : param_{first, last}
+            { /* DUMMY BODY */ }
+
+            discrete_distribution(initializer_list<double> init)
+                : param_{init}
+            { /* DUMMY BODY */ }
+
+            template<class UnaryOperation>
+            discrete_distribution(size_t nw, double xmin, double xmax, UnaryOperation fw)
+                : param_{nw, xmin, xmax, fw}
+            { /* DUMMY BODY */ }
+
+            explicit discrete_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                return static_cast<result_type>(p.table_(g));
+            }
+
+            vector<double> probabilities() const
+            {
+                return param_.probabilities();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return 0;
+            }
+
+            result_type max() const
+            {
+                return static_cast<result_type>(param_.prob_.size() - 1);
+            }
+
+            bool operator==(const discrete_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const discrete_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const discrete_distribution& d)
+            {
+                return aux::write_distribution(os, d.probabilities());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          discrete_distribution& d)
+            {
+                vector<double> probabilities{};
+
+                if (aux::read_distribution(is, probabilities))
+                    d.param(restore_param_(probabilities));
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+
+            /**
+             * The probabilities are normalized already, normalizing
+             * them again could change their last digits.
+             */
+            static param_type restore_param_(const vector<double>& prob)
+            {
+                param_type res(prob.begin(), prob.end());
+                if (!prob.empty())
+                    res.prob_ = prob;
+
+                return res;
+            }
+    };
+
+    /**
+     * 26.5.8.6.2, class template piecewise_constant_distribution:
+     */
+
+    template<class RealType = double>
+    class piecewise_constant_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = piecewise_constant_distribution;
+
+                    param_type()
+                        : bounds_{}, densities_{}, table_{}
+                    {
+                        init_({});
+                    }
+
+                    template<class InputIteratorB, class InputIteratorW>
+                    param_type(InputIteratorB firstB, InputIteratorB lastB,
+                               InputIteratorW firstW)
+                        : bounds_(firstB, lastB), densities_{}, table_{}
+                    {
+                        vector<double> weights{};
+                        for (size_t i = 1; i < bounds_.size(); ++i)
+                            weights.push_back(*firstW++);
+
+                        init_(weights);
+                    }
+
+                    template<class UnaryOperation>
+                    param_type(initializer_list<result_type> bl, UnaryOperation fw)
+                        : bounds_(bl.begin(), bl.end()), densities_{}, table_{}
+                    {
+                        vector<double> weights{};
+                        for (size_t i = 1; i < bounds_.size(); ++i)
+                            weights.push_back(fw((bounds_[i - 1] + bounds_[i]) / 2));
+
+                        init_(weights);
+                    }
+
+                    template<class UnaryOperation>
+                    param_type(size_t nw, result_type xmin, result_type xmax, UnaryOperation fw)
+                        : bounds_{}, densities_{}, table_{}
+                    {
+                        if (nw == 0)
+                            nw = 1;
+
+                        auto delta = (xmax - xmin) / nw;
+                        vector<double> weights{};
+                        for (size_t k = 0; k <= nw; ++k)
+                            bounds_.push_back(xmin + k * delta);
+                        for (size_t k = 0; k < nw; ++k)
+                            weights.push_back(fw(bounds_[k] + delta / 2));
+
+                        init_(weights);
+                    }
+
+                    vector<result_type> intervals() const
+                    {
+                        return bounds_;
+                    }
+
+                    vector<result_type> densities() const
+                    {
+                        return densities_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return bounds_ == rhs.bounds_ && densities_ == rhs.densities_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    vector<result_type> bounds_;
+                    vector<result_type> densities_;
+                    aux::alias_table table_;
+
+                    void init_(vector<double> weights)
+                    {
+                        if (bounds_.size() < 2)
+                        {
+                            bounds_ = {result_type{0}, result_type{1}};
+                            weights = {1.0};
+                        }
+
+                        double total{};
+                        for (auto w: weights)
+                            total += w;
+
+                        densities_.clear();
+                        for (size_t i = 0; i < weights.size(); ++i)
+                        {
+                            auto width = bounds_[i + 1] - bounds_[i];
+                            densities_.push_back(static_cast<result_type>(weights[i] / (total * width)));
+                        }
+
+                        table_ = aux::alias_table{weights};
+                    }
+
+                    friend class piecewise_constant_distribution;
+            };
+
+            piecewise_constant_distribution()
+                : param_{}
+            { /* DUMMY BODY */ }
+
+            template<class InputIteratorB, class InputIteratorW>
+            piecewise_constant_distribution(InputIteratorB firstB, InputIteratorB lastB,
+                                            InputIteratorW firstW)
+                : param_{firstB, lastB, firstW}
+            { /* DUMMY BODY */ }
+
+            template<class UnaryOperation>
+            piecewise_constant_distribution(initializer_list<result_type> bl, UnaryOperation fw)
+                : param_{bl, fw}
+            { /* DUMMY BODY */ }
+
+            template<class UnaryOperation>
+            piecewise_constant_distribution(size_t nw, result_type xmin, result_type xmax,
+                                            UnaryOperation fw)
+                : param_{nw, xmin, xmax, fw}
+            { /* DUMMY BODY */ }
+
+            explicit piecewise_constant_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                auto idx = p.table_(g);
+                auto lo = p.bounds_[idx];
+                auto hi = p.bounds_[idx + 1];
+
+                return lo + aux::random_canonical<result_type>(g) * (hi - lo);
+            }
+
+            vector<result_type> intervals() const
+            {
+                return param_.intervals();
+            }
+
+            vector<result_type> densities() const
+            {
+                return param_.densities();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return param_.bounds_.front();
+            }
+
+            result_type max() const
+            {
+                return param_.bounds_.back();
+            }
+
+            bool operator==(const piecewise_constant_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const piecewise_constant_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const piecewise_constant_distribution& d)
+            {
+                return aux::write_distribution(os, d.intervals(), d.densities());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          piecewise_constant_distribution& d)
+            {
+                vector<result_type> intervals{};
+                vector<result_type> densities{};
+
+                if (aux::read_distribution(is, intervals, densities))
+                {
+                    if (intervals.size() < 2 || densities.size() + 1 != intervals.size())
+                        is.setstate(ios_base::failbit);
+                    else
+                        d.param(restore_param_(intervals, densities));
+                }
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+
+            /**
+             * The densities are normalized already, normalizing
+             * them again could change their last digits.
+             */
+            static param_type restore_param_(const vector<result_type>& bounds,
+                                             const vector<result_type>& densities)
+            {
+                param_type res(bounds.begin(), bounds.end(), densities.begin());
+                res.densities_ = densities;
+
+                return res;
+            }
+    };
+
+    /**
+     * 26.5.8.6.3, class template piecewise_linear_distribution:
+     */
 
     template<class RealType = double>
-    class piecewise_linear_distribution;
+    class piecewise_linear_distribution
+    {
+        public:
+            using result_type = RealType;
+
+            class param_type
+            {
+                public:
+                    using distribution_type = piecewise_linear_distribution;
+
+                    param_type()
+                        : bounds_{}, densities_{}, table_{}
+                    {
+                        init_({});
+                    }
+
+                    template<class InputIteratorB, class InputIteratorW>
+                    param_type(InputIteratorB firstB, InputIteratorB lastB,
+                               InputIteratorW firstW)
+                        : bounds_(firstB, lastB), densities_{}, table_{}
+                    {
+                        vector<double> weights{};
+                        for (size_t i = 0; i < bounds_.size(); ++i)
+                            weights.push_back(*firstW++);
+
+                        init_(weights);
+                    }
+
+                    template<class UnaryOperation>
+                    param_type(initializer_list<result_type> bl, UnaryOperation fw)
+                        : bounds_(bl.begin(), bl.end()), densities_{}, table_{}
+                    {
+                        vector<double> weights{};
+                        for (auto b: bounds_)
+                            weights.push_back(fw(b));
+
+                        init_(weights);
+                    }
+
+                    template<class UnaryOperation>
+                    param_type(size_t nw, result_type xmin, result_type xmax, UnaryOperation fw)
+                        : bounds_{}, densities_{}, table_{}
+                    {
+                        if (nw == 0)
+                            nw = 1;
+
+                        auto delta = (xmax - xmin) / nw;
+                        vector<double> weights{};
+                        for (size_t k = 0; k <= nw; ++k)
+                        {
+                            bounds_.push_back(xmin + k * delta);
+                            weights.push_back(fw(bounds_.back()));
+                        }
+
+                        init_(weights);
+                    }
+
+                    vector<result_type> intervals() const
+                    {
+                        return bounds_;
+                    }
+
+                    vector<result_type> densities() const
+                    {
+                        return densities_;
+                    }
+
+                    bool operator==(const param_type& rhs) const
+                    {
+                        return bounds_ == rhs.bounds_ && densities_ == rhs.densities_;
+                    }
+
+                    bool operator!=(const param_type& rhs) const
+                    {
+                        return !(*this == rhs);
+                    }
+
+                private:
+                    vector<result_type> bounds_;
+                    vector<result_type> densities_;
+                    aux::alias_table table_;
+
+                    void init_(vector<double> weights)
+                    {
+                        if (bounds_.size() < 2)
+                        {
+                            bounds_ = {result_type{0}, result_type{1}};
+                            weights = {1.0, 1.0};
+                        }
+
+                        vector<double> areas{};
+                        double total{};
+                        for (size_t i = 1; i < bounds_.size(); ++i)
+                        {
+                            auto width = bounds_[i] - bounds_[i - 1];
+                            areas.push_back((weights[i - 1] + weights[i]) / 2 * width);
+                            total += areas.back();
+                        }
+
+                        densities_.clear();
+                        for (auto w: weights)
+                            densities_.push_back(static_cast<result_type>(w / total));
+
+                        table_ = aux::alias_table{areas};
+                    }
+
+                    friend class piecewise_linear_distribution;
+            };
+
+            piecewise_linear_distribution()
+                : param_{}
+            { /* DUMMY BODY */ }
+
+            template<class InputIteratorB, class InputIteratorW>
+            piecewise_linear_distribution(InputIteratorB firstB, InputIteratorB lastB,
+                                          InputIteratorW firstW)
+                : param_{firstB, lastB, firstW}
+            { /* DUMMY BODY */ }
+
+            template<class UnaryOperation>
+            piecewise_linear_distribution(initializer_list<result_type> bl, UnaryOperation fw)
+                : param_{bl, fw}
+            { /* DUMMY BODY */ }
+
+            template<class UnaryOperation>
+            piecewise_linear_distribution(size_t nw, result_type xmin, result_type xmax,
+                                          UnaryOperation fw)
+                : param_{nw, xmin, xmax, fw}
+            { /* DUMMY BODY */ }
+
+            explicit piecewise_linear_distribution(const param_type& p)
+                : param_{p}
+            { /* DUMMY BODY */ }
+
+            void reset()
+            { /* DUMMY BODY */ }
+
+            template<class URNG>
+            result_type operator()(URNG& g)
+            {
+                return (*this)(g, param_);
+            }
+
+            /**
+             * Picks an interval by its area and inverts the
+             * quadratic distribution function inside it, in
+             * a form that does not divide by the difference
+             * of the densities at its ends.
+             */
+            template<class URNG>
+            result_type operator()(URNG& g, const param_type& p)
+            {
+                auto idx = p.table_(g);
+                auto lo = p.bounds_[idx];
+                auto hi = p.bounds_[idx + 1];
+                double w0 = p.densities_[idx];
+                double w1 = p.densities_[idx + 1];
+
+                auto u = aux::random_canonical<double>(g);
+                auto den = w0 + aux::sqrt(w0 * w0 + u * (w1 * w1 - w0 * w0));
+                auto t = (den > 0) ? u * (w0 + w1) / den : u;
+
+                return static_cast<result_type>(lo + t * (hi - lo));
+            }
+
+            vector<result_type> intervals() const
+            {
+                return param_.intervals();
+            }
+
+            vector<result_type> densities() const
+            {
+                return param_.densities();
+            }
+
+            param_type param() const
+            {
+                return param_;
+            }
+
+            void param(const param_type& p)
+            {
+                param_ = p;
+            }
+
+            result_type min() const
+            {
+                return param_.bounds_.front();
+            }
+
+            result_type max() const
+            {
+                return param_.bounds_.back();
+            }
+
+            bool operator==(const piecewise_linear_distribution& rhs) const
+            {
+                return param_ == rhs.param_;
+            }
+
+            bool operator!=(const piecewise_linear_distribution& rhs) const
+            {
+                return !(*this == rhs);
+            }
+
+            template<class Char, class Traits>
+            friend basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                                          const piecewise_linear_distribution& d)
+            {
+                return aux::write_distribution(os, d.intervals(), d.densities());
+            }
+
+            template<class Char, class Traits>
+            friend basic_istream<Char, Traits>& operator>>(basic_istream<Char, Traits>& is,
+                                                          piecewise_linear_distribution& d)
+            {
+                vector<result_type> intervals{};
+                vector<result_type> densities{};
+
+                if (aux::read_distribution(is, intervals, densities))
+                {
+                    if (intervals.size() < 2 || densities.size() != intervals.size())
+                        is.setstate(ios_base::failbit);
+                    else
+                        d.param(restore_param_(intervals, densities));
+                }
+
+                return is;
+            }
+
+        private:
+            param_type param_;
+
+            /**
+             * The densities are normalized already, normalizing
+             * them again could change their last digits.
+             */
+            static param_type restore_param_(const vector<result_type>& bounds,
+                                             const vector<result_type>& densities)
+            {
+                param_type res(bounds.begin(), bounds.end(), densities.begin());
+                res.densities_ = densities;
+
+                return res;
+            }
+    };
 }
 
 #endif
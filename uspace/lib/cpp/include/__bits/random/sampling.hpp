@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_RANDOM_SAMPLING
+#define LIBCPP_BITS_RANDOM_SAMPLING
+
+#include <__bits/builtins.hpp>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Building blocks of the random number distributions.
+ * The distributions compute in double and only convert
+ * their results to the requested type.
+ */
+
+namespace std::aux
+{
+    /**
+     * Number of uniformly distributed bits that one call
+     * of a generator with the given range provides.
+     */
+    constexpr size_t random_range_bits(uint64_t range)
+    {
+        if (range == ~uint64_t{})
+            return 64;
+
+        size_t res{};
+        for (auto tmp = range + 1; tmp > 1; tmp >>= 1)
+            ++res;
+
+        return res;
+    }
+
+    /**
+     * Returns a uniformly distributed value of the unsigned
+     * type UInt, combining as many calls of the generator
+     * as are needed to fill all of its bits.
+     */
+    template<class UInt, class URNG>
+    UInt random_bits(URNG& g)
+    {
+        constexpr auto bits = random_range_bits(
+            static_cast<uint64_t>(URNG::max() - URNG::min())
+        );
+        constexpr auto digits = std::numeric_limits<UInt>::digits;
+        static_assert(bits > 0, "generator without random bits");
+
+        if constexpr (bits >= digits)
+            return static_cast<UInt>(g() - URNG::min());
+        else
+        {
+            constexpr auto mask = (UInt{1} << bits) - 1;
+
+            UInt res{};
+            for (size_t i = 0; i < digits; i += bits)
+                res = (res << bits) | (static_cast<UInt>(g() - URNG::min()) & mask);
+
+            return res;
+        }
+    }
+
+    /**
+     * Uniform real value from [0, 1) with the precision of
+     * the target type, so that it never rounds up to 1.
+     */
+    template<class Real, class URNG>
+    Real random_canonical(URNG& g)
+    {
+        constexpr size_t digits = std::numeric_limits<Real>::digits < 64 ?
+            std::numeric_limits<Real>::digits : 64;
+        constexpr Real scale = Real{1} / (
+            static_cast<Real>(uint64_t{1} << (digits - 1)) * Real{2}
+        );
+
+        return static_cast<Real>(random_bits<uint64_t>(g) >> (64 - digits)) * scale;
+    }
+
+    /**
+     * Uniform value from (0, 1), for use with logarithms.
+     */
+    template<class URNG>
+    double random_open01(URNG& g)
+    {
+        return (static_cast<double>(random_bits<uint64_t>(g) >> 11) + 0.5) * 0x1p-53;
+    }
+
+    /**
+     * Tables of the ziggurat method of Marsaglia and Tsang,
+     * which covers the density with horizontal layers of equal
+     * area. Most samples fall into the part of a layer that lies
+     * under the density and are accepted after one table lookup
+     * and one multiplication, only the rest needs exp or log.
+     * Note: The magnitudes are 53 bit, the k tables hold the
+     *       fraction of each layer that is completely under the
+     *       density scaled to that range.
+     */
+    struct ziggurat_tables
+    {
+        static constexpr size_t normal_layers{128};
+        static constexpr size_t exponential_layers{256};
+
+        static constexpr double normal_r{3.442619855899};
+        static constexpr double exponential_r{7.697117470131487};
+
+        uint64_t normal_k[normal_layers];
+        double normal_w[normal_layers];
+        double normal_f[normal_layers];
+
+        uint64_t exponential_k[exponential_layers];
+        double exponential_w[exponential_layers];
+        double exponential_f[exponential_layers];
+
+        ziggurat_tables();
+    };
+
+    const ziggurat_tables& ziggurat();
+
+    template<class URNG>
+    double ziggurat_normal(URNG& g)
+    {
+        const auto& zig = ziggurat();
+
+        while (true)
+        {
+            auto bits = random_bits<uint64_t>(g);
+            auto idx = bits & (ziggurat_tables::normal_layers - 1);
+            auto negative = (bits & ziggurat_tables::normal_layers) != 0;
+            auto mag = bits >> 11;
+
+            auto x = static_cast<double>(mag) * zig.normal_w[idx];
+            if (mag < zig.normal_k[idx])
+                return negative ? -x : x;
+
+            if (idx == 0)
+            {
+                /**
+                 * The tail beyond r is sampled with the method
+                 * of Marsaglia (1964).
+                 */
+                constexpr auto r = ziggurat_tables::normal_r;
+                double y{};
+                do
+                {
+                    x = -aux::log(random_open01(g)) / r;
+                    y = -aux::log(random_open01(g));
+                }
+                while (y + y < x * x);
+
+                return negative ? -(r + x) : r + x;
+            }
+
+            auto lo = zig.normal_f[idx];
+            auto hi = zig.normal_f[idx - 1];
+            if (lo + random_canonical<double>(g) * (hi - lo) < aux::exp(-0.5 * x * x))
+                return negative ? -x : x;
+        }
+    }
+
+    template<class URNG>
+    double ziggurat_exponential(URNG& g)
+    {
+        const auto& zig = ziggurat();
+
+        while (true)
+        {
+            auto bits = random_bits<uint64_t>(g);
+            auto idx = bits & (ziggurat_tables::exponential_layers - 1);
+            auto mag = bits >> 11;
+
+            auto x = static_cast<double>(mag) * zig.exponential_w[idx];
+            if (mag < zig.exponential_k[idx])
+                return x;
+
+            /**
+             * The exponential distribution is memoryless, so
+             * the tail is just a shifted copy of the whole.
+             */
+            if (idx == 0)
+                return ziggurat_tables::exponential_r - aux::log(random_open01(g));
+
+            auto lo = zig.exponential_f[idx];
+            auto hi = zig.exponential_f[idx - 1];
+            if (lo + random_canonical<double>(g) * (hi - lo) < aux::exp(-x))
+                return x;
+        }
+    }
+
+    inline long long random_floor(double val)
+    {
+        return static_cast<long long>(__builtin_floor(val));
+    }
+
+    /**
+     * Returns log(k!), exactly from a table for small k and
+     * from the Stirling series otherwise.
+     */
+    inline double log_factorial(double k)
+    {
+        static constexpr double table[] = {
+            0.0, 0.0, 0.693147180559945, 1.7917594692280554,
+            3.178053830347945, 4.787491742782047, 6.579251212010102,
+            8.525161361065415, 10.604602902745249, 12.801827480081467
+        };
+
+        if (k < 10)
+            return table[static_cast<size_t>(k)];
+
+        auto x = k + 1;
+        auto inv = 1 / x;
+        auto inv2 = inv * inv;
+
+        return (x - 0.5) * aux::log(x) - x + 0.91893853320467274178 +
+               inv * (1.0 / 12 - inv2 * (1.0 / 360 - inv2 / 1260));
+    }
+
+    /**
+     * Samples from the exact gamma distribution with unit
+     * scale, Marsaglia and Tsang (2000).
+     */
+    template<class URNG>
+    double gamma_unit(URNG& g, double alpha)
+    {
+        if (alpha < 1)
+        {
+            /**
+             * Boosting: if X ~ Gamma(alpha + 1), then
+             * X * U^(1 / alpha) ~ Gamma(alpha).
+             */
+            auto u = random_open01(g);
+
+            return gamma_unit(g, alpha + 1) * aux::pow(u, 1 / alpha);
+        }
+
+        auto d = alpha - 1.0 / 3;
+        auto c = 1 / aux::sqrt(9 * d);
+
+        while (true)
+        {
+            double x{};
+            double v{};
+            do
+            {
+                x = ziggurat_normal(g);
+                v = 1 + c * x;
+            }
+            while (v <= 0);
+
+            v = v * v * v;
+            auto u = random_open01(g);
+            auto x2 = x * x;
+
+            if (u < 1 - 0.0331 * x2 * x2)
+                return d * v;
+
+            if (aux::log(u) < 0.5 * x2 + d * (1 - v + aux::log(v)))
+                return d * v;
+        }
+    }
+
+    /**
+     * Walker's alias method in the form given by Vose,
+     * after an O(n) setup it samples an index with the
+     * given weights in constant time using a single
+     * uniform value.
+     */
+    class alias_table
+    {
+        public:
+            alias_table()
+                : prob_{}, alias_{}
+            { /* DUMMY BODY */ }
+
+            explicit alias_table(const vector<double>& weights)
+                : prob_(weights.size()), alias_(weights.size())
+            {
+                auto n = weights.size();
+                if (n == 0)
+                    return;
+
+                double total{};
+                for (auto w: weights)
+                    total += w;
+
+                vector<double> scaled(n);
+                vector<size_t> small{};
+                vector<size_t> large{};
+                for (size_t i = 0; i < n; ++i)
+                {
+                    scaled[i] = weights[i] * n / total;
+                    if (scaled[i] < 1)
+                        small.push_back(i);
+                    else
+                        large.push_back(i);
+                }
+
+                while (!small.empty() && !large.empty())
+                {
+                    auto s = small.back();
+                    small.pop_back();
+                    auto l = large.back();
+
+                    prob_[s] = scaled[s];
+                    alias_[s] = l;
+
+                    scaled[l] -= 1 - scaled[s];
+                    if (scaled[l] < 1)
+                    {
+                        large.pop_back();
+                        small.push_back(l);
+                    }
+                }
+
+                /**
+                 * What is left over is 1 up to rounding errors.
+                 */
+                for (auto i: large)
+                {
+                    prob_[i] = 1;
+                    alias_[i] = i;
+                }
+
+                for (auto i: small)
+                {
+                    prob_[i] = 1;
+                    alias_[i] = i;
+                }
+            }
+
+            template<class URNG>
+            size_t operator()(URNG& g) const
+            {
+                auto u = random_canonical<double>(g) * prob_.size();
+                auto idx = static_cast<size_t>(u);
+                if (idx >= prob_.size())
+                    idx = prob_.size() - 1;
+
+                return (u - idx < prob_[idx]) ? idx : alias_[idx];
+            }
+
+            size_t size() const noexcept
+            {
+                return prob_.size();
+            }
+
+        private:
+            vector<double> prob_;
+            vector<size_t> alias_;
+    };
+}
+
+#endif
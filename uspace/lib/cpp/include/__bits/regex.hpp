@@ -29,6 +29,1190 @@
 #ifndef LIBCPP_BITS_REGEX
 #define LIBCPP_BITS_REGEX
 
-#error "<regex> is not implemented"
+#include <__bits/regex/constants.hpp>
+#include <__bits/regex/engine.hpp>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace std
+{
+    /**
+     * 28.7, class template regex_traits:
+     */
+
+    /**
+     * Note: We do not have locale aware character
+     *       classification, so the traits only know
+     *       the ASCII range and the compiled engine
+     *       uses its own (equivalent) tables.
+     */
+    template<class Char>
+    struct regex_traits
+    {
+        using char_type   = Char;
+        using string_type = basic_string<Char>;
+
+        regex_traits() = default;
+
+        static size_t length(const char_type* p)
+        {
+            return char_traits<char_type>::length(p);
+        }
+
+        char_type translate(char_type c) const
+        {
+            return c;
+        }
+
+        char_type translate_nocase(char_type c) const
+        {
+            if (char_type{'A'} <= c && c <= char_type{'Z'})
+                return static_cast<char_type>(c - 'A' + 'a');
+            else
+                return c;
+        }
+
+        int value(char_type c, int radix) const
+        {
+            int res{-1};
+            if (char_type{'0'} <= c && c <= char_type{'9'})
+                res = static_cast<int>(c - '0');
+            else if (char_type{'a'} <= c && c <= char_type{'f'})
+                res = static_cast<int>(c - 'a') + 10;
+            else if (char_type{'A'} <= c && c <= char_type{'F'})
+                res = static_cast<int>(c - 'A') + 10;
+
+            return res < radix ? res : -1;
+        }
+    };
+
+    template<class BidirIt>
+    class sub_match;
+
+    template<class BidirIt, class Allocator>
+    class match_results;
+
+    namespace aux
+    {
+        struct regex_access;
+    }
+
+    /**
+     * 28.8, class template basic_regex:
+     */
+
+    /**
+     * Note: Only the ECMAScript grammar is supported, the
+     *       other grammar flags are accepted but the pattern
+     *       is always parsed as ECMAScript. The compiled
+     *       program is shared by copies of the regex.
+     */
+    template<class Char, class Traits = regex_traits<Char>>
+    class basic_regex
+    {
+        public:
+            using value_type  = Char;
+            using traits_type = Traits;
+            using string_type = typename Traits::string_type;
+            using flag_type   = regex_constants::syntax_option_type;
+
+            /**
+             * 28.8.1, basic_regex constants:
+             */
+
+            static constexpr flag_type icase      = regex_constants::icase;
+            static constexpr flag_type nosubs     = regex_constants::nosubs;
+            static constexpr flag_type optimize   = regex_constants::optimize;
+            static constexpr flag_type collate    = regex_constants::collate;
+            static constexpr flag_type ECMAScript = regex_constants::ECMAScript;
+            static constexpr flag_type basic      = regex_constants::basic;
+            static constexpr flag_type extended   = regex_constants::extended;
+            static constexpr flag_type awk        = regex_constants::awk;
+            static constexpr flag_type grep       = regex_constants::grep;
+            static constexpr flag_type egrep      = regex_constants::egrep;
+            static constexpr flag_type multiline  = regex_constants::multiline;
+
+            /**
+             * 28.8.2, construct/copy/destroy:
+             */
+
+            basic_regex()
+                : impl_{}, flags_{ECMAScript}
+            { /* DUMMY BODY */ }
+
+            explicit basic_regex(const value_type* p, flag_type f = ECMAScript)
+                : impl_{}, flags_{}
+            {
+                assign(p, f);
+            }
+
+            basic_regex(const value_type* p, size_t len, flag_type f = ECMAScript)
+                : impl_{}, flags_{}
+            {
+                assign(p, len, f);
+            }
+
+            basic_regex(const basic_regex&) = default;
+
+            basic_regex(basic_regex&&) noexcept = default;
+
+            template<class ST, class SA>
+            explicit basic_regex(const basic_string<value_type, ST, SA>& p,
+                                 flag_type f = ECMAScript)
+                : impl_{}, flags_{}
+            {
+                assign(p, f);
+            }
+
+            template<class ForwardIterator>
+            basic_regex(ForwardIterator first, ForwardIterator last,
+                        flag_type f = ECMAScript)
+                : impl_{}, flags_{}
+            {
+                assign(first, last, f);
+            }
+
+            basic_regex(initializer_list<value_type> init, flag_type f = ECMAScript)
+                : impl_{}, flags_{}
+            {
+                assign(init, f);
+            }
+
+            ~basic_regex() = default;
+
+            basic_regex& operator=(const basic_regex&) = default;
+
+            basic_regex& operator=(basic_regex&&) noexcept = default;
+
+            basic_regex& operator=(const value_type* p)
+            {
+                return assign(p);
+            }
+
+            basic_regex& operator=(initializer_list<value_type> init)
+            {
+                return assign(init);
+            }
+
+            template<class ST, class SA>
+            basic_regex& operator=(const basic_string<value_type, ST, SA>& p)
+            {
+                return assign(p);
+            }
+
+            /**
+             * 28.8.3, assign:
+             */
+
+            basic_regex& assign(const basic_regex& other)
+            {
+                return *this = other;
+            }
+
+            basic_regex& assign(basic_regex&& other) noexcept
+            {
+                return *this = move(other);
+            }
+
+            basic_regex& assign(const value_type* p, flag_type f = ECMAScript)
+            {
+                return assign(p, p + traits_type::length(p), f);
+            }
+
+            basic_regex& assign(const value_type* p, size_t len, flag_type f = ECMAScript)
+            {
+                return assign(p, p + len, f);
+            }
+
+            template<class ST, class SA>
+            basic_regex& assign(const basic_string<value_type, ST, SA>& p,
+                                flag_type f = ECMAScript)
+            {
+                return assign(p.begin(), p.end(), f);
+            }
+
+            template<class InputIterator>
+            basic_regex& assign(InputIterator first, InputIterator last,
+                                flag_type f = ECMAScript)
+            {
+                vector<uint32_t> pattern{};
+                while (first != last)
+                    pattern.push_back(aux::regex_unit(traits_.translate(*first++)));
+
+                auto impl = make_shared<aux::regex_impl>(pattern.data(), pattern.size(), f);
+                if (impl->error() != 0)
+                {
+                    // TODO: For this we need stack unwinding support.
+                    /* throw regex_error{impl->error()}; */
+                }
+
+                impl_ = move(impl);
+                flags_ = f;
+
+                return *this;
+            }
+
+            basic_regex& assign(initializer_list<value_type> init, flag_type f = ECMAScript)
+            {
+                return assign(init.begin(), init.end(), f);
+            }
+
+            /**
+             * 28.8.4, const operations:
+             */
+
+            unsigned mark_count() const
+            {
+                return impl_ ? static_cast<unsigned>(impl_->program().mark_count()) : 0U;
+            }
+
+            flag_type flags() const
+            {
+                return flags_;
+            }
+
+            /**
+             * 28.8.6, swap:
+             */
+
+            void swap(basic_regex& other)
+            {
+                std::swap(impl_, other.impl_);
+                std::swap(flags_, other.flags_);
+            }
+
+        private:
+            shared_ptr<aux::regex_impl> impl_;
+            flag_type flags_;
+            traits_type traits_;
+
+            friend struct aux::regex_access;
+    };
+
+    using regex  = basic_regex<char>;
+    using wregex = basic_regex<wchar_t>;
+
+    /**
+     * 28.8.7, basic_regex swap:
+     */
+
+    template<class Char, class Traits>
+    void swap(basic_regex<Char, Traits>& lhs, basic_regex<Char, Traits>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+    /**
+     * 28.9, class template sub_match:
+     */
+
+    template<class BidirIt>
+    class sub_match: public pair<BidirIt, BidirIt>
+    {
+        public:
+            using value_type      = typename iterator_traits<BidirIt>::value_type;
+            using difference_type = typename iterator_traits<BidirIt>::difference_type;
+            using iterator        = BidirIt;
+            using string_type     = basic_string<value_type>;
+
+            bool matched;
+
+            constexpr sub_match()
+                : pair<BidirIt, BidirIt>{}, matched{false}
+            { /* DUMMY BODY */ }
+
+            sub_match(BidirIt first, BidirIt second, bool m)
+                : pair<BidirIt, BidirIt>{first, second}, matched{m}
+            { /* DUMMY BODY */ }
+
+            difference_type length() const
+            {
+                return matched ? distance(this->first, this->second) : difference_type{};
+            }
+
+            operator string_type() const
+            {
+                return str();
+            }
+
+            string_type str() const
+            {
+                return matched ? string_type(this->first, this->second) : string_type{};
+            }
+
+            int compare(const sub_match& other) const
+            {
+                return str().compare(other.str());
+            }
+
+            int compare(const string_type& str) const
+            {
+                return this->str().compare(str);
+            }
+
+            int compare(const value_type* str) const
+            {
+                return this->str().compare(str);
+            }
+    };
+
+    using csub_match  = sub_match<const char*>;
+    using wcsub_match = sub_match<const wchar_t*>;
+    using ssub_match  = sub_match<string::const_iterator>;
+    using wssub_match = sub_match<wstring::const_iterator>;
+
+    /**
+     * 28.9.2, sub_match non-member operators:
+     */
+
+    template<class BidirIt>
+    bool operator==(const sub_match<BidirIt>& lhs, const sub_match<BidirIt>& rhs)
+    {
+        return lhs.compare(rhs) == 0;
+    }
+
+    template<class BidirIt>
+    bool operator!=(const sub_match<BidirIt>& lhs, const sub_match<BidirIt>& rhs)
+    {
+        return lhs.compare(rhs) != 0;
+    }
+
+    template<class BidirIt>
+    bool operator<(const sub_match<BidirIt>& lhs, const sub_match<BidirIt>& rhs)
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<class BidirIt>
+    bool operator<=(const sub_match<BidirIt>& lhs, const sub_match<BidirIt>& rhs)
+    {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<class BidirIt>
+    bool operator>(const sub_match<BidirIt>& lhs, const sub_match<BidirIt>& rhs)
+    {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<class BidirIt>
+    bool operator>=(const sub_match<BidirIt>& lhs, const sub_match<BidirIt>& rhs)
+    {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<class BidirIt, class ST, class SA>
+    bool operator==(
+        const basic_string<typename iterator_traits<BidirIt>::value_type, ST, SA>& lhs,
+        const sub_match<BidirIt>& rhs
+    )
+    {
+        return rhs.compare(lhs.c_str()) == 0;
+    }
+
+    template<class BidirIt, class ST, class SA>
+    bool operator!=(
+        const basic_string<typename iterator_traits<BidirIt>::value_type, ST, SA>& lhs,
+        const sub_match<BidirIt>& rhs
+    )
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class BidirIt, class ST, class SA>
+    bool operator==(
+        const sub_match<BidirIt>& lhs,
+        const basic_string<typename iterator_traits<BidirIt>::value_type, ST, SA>& rhs
+    )
+    {
+        return lhs.compare(rhs.c_str()) == 0;
+    }
+
+    template<class BidirIt, class ST, class SA>
+    bool operator!=(
+        const sub_match<BidirIt>& lhs,
+        const basic_string<typename iterator_traits<BidirIt>::value_type, ST, SA>& rhs
+    )
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class BidirIt>
+    bool operator==(const typename iterator_traits<BidirIt>::value_type* lhs,
+                    const sub_match<BidirIt>& rhs)
+    {
+        return rhs.compare(lhs) == 0;
+    }
+
+    template<class BidirIt>
+    bool operator!=(const typename iterator_traits<BidirIt>::value_type* lhs,
+                    const sub_match<BidirIt>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class BidirIt>
+    bool operator==(const sub_match<BidirIt>& lhs,
+                    const typename iterator_traits<BidirIt>::value_type* rhs)
+    {
+        return lhs.compare(rhs) == 0;
+    }
+
+    template<class BidirIt>
+    bool operator!=(const sub_match<BidirIt>& lhs,
+                    const typename iterator_traits<BidirIt>::value_type* rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    /**
+     * 28.10, class template match_results:
+     */
+
+    template<class BidirIt, class Allocator = allocator<sub_match<BidirIt>>>
+    class match_results
+    {
+        public:
+            using value_type      = sub_match<BidirIt>;
+            using const_reference = const value_type&;
+            using reference       = value_type&;
+            using const_iterator  = typename vector<value_type, Allocator>::const_iterator;
+            using iterator        = const_iterator;
+            using difference_type = typename iterator_traits<BidirIt>::difference_type;
+            using size_type       = typename allocator_traits<Allocator>::size_type;
+            using allocator_type  = Allocator;
+            using char_type       = typename iterator_traits<BidirIt>::value_type;
+            using string_type     = basic_string<char_type>;
+
+            /**
+             * 28.10.1, construct/copy/destroy:
+             */
+
+            explicit match_results(const Allocator& alloc = Allocator{})
+                : subs_{alloc}, prefix_{}, suffix_{}, null_{}, base_{}, ready_{false}
+            { /* DUMMY BODY */ }
+
+            match_results(const match_results&) = default;
+
+            match_results(match_results&&) noexcept = default;
+
+            match_results& operator=(const match_results&) = default;
+
+            match_results& operator=(match_results&&) = default;
+
+            ~match_results() = default;
+
+            /**
+             * 28.10.2, state:
+             */
+
+            bool ready() const
+            {
+                return ready_;
+            }
+
+            /**
+             * 28.10.3, size:
+             */
+
+            size_type size() const
+            {
+                return subs_.size();
+            }
+
+            size_type max_size() const
+            {
+                return subs_.max_size();
+            }
+
+            bool empty() const
+            {
+                return subs_.empty();
+            }
+
+            /**
+             * 28.10.4, element access:
+             */
+
+            difference_type length(size_type sub = 0) const
+            {
+                return (*this)[sub].length();
+            }
+
+            difference_type position(size_type sub = 0) const
+            {
+                return distance(base_, (*this)[sub].first);
+            }
+
+            string_type str(size_type sub = 0) const
+            {
+                return (*this)[sub].str();
+            }
+
+            const_reference operator[](size_type n) const
+            {
+                return n < subs_.size() ? subs_[n] : null_;
+            }
+
+            const_reference prefix() const
+            {
+                return prefix_;
+            }
+
+            const_reference suffix() const
+            {
+                return suffix_;
+            }
+
+            const_iterator begin() const
+            {
+                return subs_.begin();
+            }
+
+            const_iterator end() const
+            {
+                return subs_.end();
+            }
+
+            const_iterator cbegin() const
+            {
+                return subs_.cbegin();
+            }
+
+            const_iterator cend() const
+            {
+                return subs_.cend();
+            }
+
+            /**
+             * 28.10.5, format:
+             */
+
+            template<class OutputIterator>
+            OutputIterator format(
+                OutputIterator out, const char_type* fmt_first, const char_type* fmt_last,
+                regex_constants::match_flag_type flags = regex_constants::format_default
+            ) const
+            {
+                auto copy_sub = [&out](const value_type& sub){
+                    if (sub.matched)
+                        out = copy(sub.first, sub.second, out);
+                };
+                auto is_digit = [](char_type c){
+                    return char_type{'0'} <= c && c <= char_type{'9'};
+                };
+
+                for (auto it = fmt_first; it != fmt_last; ++it)
+                {
+                    auto next = it + 1;
+                    if (flags & regex_constants::format_sed)
+                    {
+                        if (*it == char_type{'&'})
+                            copy_sub((*this)[0]);
+                        else if (*it == char_type{'\\'} && next != fmt_last)
+                        {
+                            if (is_digit(*next))
+                                copy_sub((*this)[static_cast<size_type>(*next - '0')]);
+                            else
+                                *out++ = *next;
+                            ++it;
+                        }
+                        else
+                            *out++ = *it;
+                    }
+                    else if (*it == char_type{'$'} && next != fmt_last)
+                    {
+                        if (*next == char_type{'$'})
+                            *out++ = *next;
+                        else if (*next == char_type{'&'})
+                            copy_sub((*this)[0]);
+                        else if (*next == char_type{'`'})
+                            copy_sub(prefix_);
+                        else if (*next == char_type{'\''})
+                            copy_sub(suffix_);
+                        else if (is_digit(*next))
+                        {
+                            // Two digit references only if such group exists.
+                            auto n = static_cast<size_type>(*next - '0');
+                            if (next + 1 != fmt_last && is_digit(*(next + 1)))
+                            {
+                                auto n2 = n * 10 + static_cast<size_type>(*(next + 1) - '0');
+                                if (n2 < size())
+                                {
+                                    n = n2;
+                                    ++next;
+                                }
+                            }
+                            copy_sub((*this)[n]);
+                            it = next - 1;
+                        }
+                        else
+                        {
+                            *out++ = *it;
+                            continue;
+                        }
+                        ++it;
+                    }
+                    else
+                        *out++ = *it;
+                }
+
+                return out;
+            }
+
+            template<class OutputIterator, class ST, class SA>
+            OutputIterator format(
+                OutputIterator out, const basic_string<char_type, ST, SA>& fmt,
+                regex_constants::match_flag_type flags = regex_constants::format_default
+            ) const
+            {
+                return format(out, fmt.data(), fmt.data() + fmt.size(), flags);
+            }
+
+            template<class ST, class SA>
+            basic_string<char_type, ST, SA> format(
+                const basic_string<char_type, ST, SA>& fmt,
+                regex_constants::match_flag_type flags = regex_constants::format_default
+            ) const
+            {
+                basic_string<char_type, ST, SA> res{};
+                format(back_inserter(res), fmt, flags);
+
+                return res;
+            }
+
+            string_type format(
+                const char_type* fmt,
+                regex_constants::match_flag_type flags = regex_constants::format_default
+            ) const
+            {
+                string_type res{};
+                format(back_inserter(res), fmt, fmt + char_traits<char_type>::length(fmt), flags);
+
+                return res;
+            }
+
+            /**
+             * 28.10.6, allocator:
+             */
+
+            allocator_type get_allocator() const
+            {
+                return subs_.get_allocator();
+            }
+
+            /**
+             * 28.10.7, swap:
+             */
+
+            void swap(match_results& other)
+            {
+                std::swap(subs_, other.subs_);
+                std::swap(prefix_, other.prefix_);
+                std::swap(suffix_, other.suffix_);
+                std::swap(null_, other.null_);
+                std::swap(base_, other.base_);
+                std::swap(ready_, other.ready_);
+            }
+
+        private:
+            vector<value_type, Allocator> subs_;
+            value_type prefix_;
+            value_type suffix_;
+            value_type null_;
+            BidirIt base_;
+            bool ready_;
+
+            friend struct aux::regex_access;
+    };
+
+    using cmatch  = match_results<const char*>;
+    using wcmatch = match_results<const wchar_t*>;
+    using smatch  = match_results<string::const_iterator>;
+    using wsmatch = match_results<wstring::const_iterator>;
+
+    /**
+     * 28.10.8, match_results comparisons:
+     */
+
+    template<class BidirIt, class Allocator>
+    bool operator==(const match_results<BidirIt, Allocator>& lhs,
+                    const match_results<BidirIt, Allocator>& rhs)
+    {
+        if (!lhs.ready() && !rhs.ready())
+            return true;
+        if (lhs.empty() && rhs.empty())
+            return true;
+        if (lhs.empty() != rhs.empty())
+            return false;
+
+        return lhs.prefix() == rhs.prefix() && lhs.size() == rhs.size() &&
+               equal(lhs.begin(), lhs.end(), rhs.begin()) &&
+               lhs.suffix() == rhs.suffix();
+    }
+
+    template<class BidirIt, class Allocator>
+    bool operator!=(const match_results<BidirIt, Allocator>& lhs,
+                    const match_results<BidirIt, Allocator>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    /**
+     * 28.10.9, match_results swap:
+     */
+
+    template<class BidirIt, class Allocator>
+    void swap(match_results<BidirIt, Allocator>& lhs,
+              match_results<BidirIt, Allocator>& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+    namespace aux
+    {
+        /**
+         * Glue between the public classes and the engine,
+         * runs the compiled program and translates the
+         * capture slots into sub matches.
+         */
+        struct regex_access
+        {
+            template<class BidirIt, class Allocator, class Char, class Traits>
+            static bool execute(BidirIt first, BidirIt last,
+                                match_results<BidirIt, Allocator>* m,
+                                const basic_regex<Char, Traits>& re,
+                                regex_constants::match_flag_type flags,
+                                bool search)
+            {
+                if (!re.impl_)
+                {
+                    if (m)
+                        reset(*m, first, last);
+
+                    return false;
+                }
+
+                if (!m)
+                {
+                    // Without results the DFA alone can decide.
+                    return regex_execute<BidirIt>(
+                        *re.impl_, first, last, nullptr, flags, search
+                    );
+                }
+
+                vector<regex_slot<BidirIt>> slots{};
+                bool res = regex_execute(*re.impl_, first, last, &slots, flags, search);
+
+                reset(*m, first, last);
+                if (!res)
+                    return false;
+
+                using sub_type = sub_match<BidirIt>;
+                auto count = re.impl_->program().slot_count() / 2;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const auto& begin = slots[2 * i];
+                    const auto& end = slots[2 * i + 1];
+
+                    if (begin.set && end.set)
+                        m->subs_.push_back(sub_type{begin.it, end.it, true});
+                    else
+                        m->subs_.push_back(sub_type{last, last, false});
+                }
+
+                const auto& whole = m->subs_[0];
+                m->prefix_ = sub_type{first, whole.first, first != whole.first};
+                m->suffix_ = sub_type{whole.second, last, whole.second != last};
+
+                return true;
+            }
+
+            template<class BidirIt, class Allocator>
+            static void reset(match_results<BidirIt, Allocator>& m,
+                              BidirIt first, BidirIt last)
+            {
+                m.subs_.clear();
+                m.prefix_ = sub_match<BidirIt>{first, first, false};
+                m.suffix_ = sub_match<BidirIt>{last, last, false};
+                m.null_ = sub_match<BidirIt>{last, last, false};
+                m.base_ = first;
+                m.ready_ = true;
+            }
+
+            /**
+             * Used by regex_iterator, which searches from the end
+             * of the previous match but reports positions and
+             * prefixes relative to the whole sequence.
+             */
+            template<class BidirIt, class Allocator>
+            static void rebase(match_results<BidirIt, Allocator>& m,
+                               BidirIt prefix_first, BidirIt base)
+            {
+                m.prefix_.first = prefix_first;
+                m.prefix_.matched = m.prefix_.first != m.prefix_.second;
+                m.base_ = base;
+            }
+        };
+    }
+
+    /**
+     * 28.11.2, function template regex_match:
+     */
+
+    template<class BidirIt, class Allocator, class Char, class Traits>
+    bool regex_match(BidirIt first, BidirIt last, match_results<BidirIt, Allocator>& m,
+                     const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return aux::regex_access::execute(first, last, &m, re, flags, false);
+    }
+
+    template<class BidirIt, class Char, class Traits>
+    bool regex_match(BidirIt first, BidirIt last, const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return aux::regex_access::execute<BidirIt, allocator<sub_match<BidirIt>>>(
+            first, last, nullptr, re, flags, false
+        );
+    }
+
+    template<class Char, class Allocator, class Traits>
+    bool regex_match(const Char* str, match_results<const Char*, Allocator>& m,
+                     const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_match(str, str + Traits::length(str), m, re, flags);
+    }
+
+    template<class ST, class SA, class Allocator, class Char, class Traits>
+    bool regex_match(const basic_string<Char, ST, SA>& str,
+                     match_results<typename basic_string<Char, ST, SA>::const_iterator,
+                                   Allocator>& m,
+                     const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_match(str.begin(), str.end(), m, re, flags);
+    }
+
+    template<class ST, class SA, class Allocator, class Char, class Traits>
+    bool regex_match(const basic_string<Char, ST, SA>&&,
+                     match_results<typename basic_string<Char, ST, SA>::const_iterator,
+                                   Allocator>&,
+                     const basic_regex<Char, Traits>&,
+                     regex_constants::match_flag_type = regex_constants::match_default) = delete;
+
+    template<class Char, class Traits>
+    bool regex_match(const Char* str, const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_match(str, str + Traits::length(str), re, flags);
+    }
+
+    template<class ST, class SA, class Char, class Traits>
+    bool regex_match(const basic_string<Char, ST, SA>& str,
+                     const basic_regex<Char, Traits>& re,
+                     regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_match(str.begin(), str.end(), re, flags);
+    }
+
+    /**
+     * 28.11.3, function template regex_search:
+     */
+
+    template<class BidirIt, class Allocator, class Char, class Traits>
+    bool regex_search(BidirIt first, BidirIt last, match_results<BidirIt, Allocator>& m,
+                      const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return aux::regex_access::execute(first, last, &m, re, flags, true);
+    }
+
+    template<class BidirIt, class Char, class Traits>
+    bool regex_search(BidirIt first, BidirIt last, const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return aux::regex_access::execute<BidirIt, allocator<sub_match<BidirIt>>>(
+            first, last, nullptr, re, flags, true
+        );
+    }
+
+    template<class Char, class Allocator, class Traits>
+    bool regex_search(const Char* str, match_results<const Char*, Allocator>& m,
+                      const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_search(str, str + Traits::length(str), m, re, flags);
+    }
+
+    template<class Char, class Traits>
+    bool regex_search(const Char* str, const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_search(str, str + Traits::length(str), re, flags);
+    }
+
+    template<class ST, class SA, class Char, class Traits>
+    bool regex_search(const basic_string<Char, ST, SA>& str,
+                      const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_search(str.begin(), str.end(), re, flags);
+    }
+
+    template<class ST, class SA, class Allocator, class Char, class Traits>
+    bool regex_search(const basic_string<Char, ST, SA>& str,
+                      match_results<typename basic_string<Char, ST, SA>::const_iterator,
+                                    Allocator>& m,
+                      const basic_regex<Char, Traits>& re,
+                      regex_constants::match_flag_type flags = regex_constants::match_default)
+    {
+        return regex_search(str.begin(), str.end(), m, re, flags);
+    }
+
+    template<class ST, class SA, class Allocator, class Char, class Traits>
+    bool regex_search(const basic_string<Char, ST, SA>&&,
+                      match_results<typename basic_string<Char, ST, SA>::const_iterator,
+                                    Allocator>&,
+                      const basic_regex<Char, Traits>&,
+                      regex_constants::match_flag_type = regex_constants::match_default) = delete;
+
+    /**
+     * 28.12.1, class template regex_iterator:
+     */
+
+    template<class BidirIt,
+             class Char = typename iterator_traits<BidirIt>::value_type,
+             class Traits = regex_traits<Char>>
+    class regex_iterator
+    {
+        public:
+            using regex_type        = basic_regex<Char, Traits>;
+            using value_type        = match_results<BidirIt>;
+            using difference_type   = ptrdiff_t;
+            using pointer           = const value_type*;
+            using reference         = const value_type&;
+            using iterator_category = forward_iterator_tag;
+
+            regex_iterator()
+                : begin_{}, end_{}, re_{nullptr}, flags_{}, match_{}
+            { /* DUMMY BODY */ }
+
+            regex_iterator(BidirIt first, BidirIt last, const regex_type& re,
+                           regex_constants::match_flag_type flags = regex_constants::match_default)
+                : begin_{first}, end_{last}, re_{&re}, flags_{flags}, match_{}
+            {
+                if (!regex_search(begin_, end_, match_, *re_, flags_))
+                    re_ = nullptr;
+            }
+
+            regex_iterator(BidirIt, BidirIt, const regex_type&&,
+                           regex_constants::match_flag_type = regex_constants::match_default) = delete;
+
+            regex_iterator(const regex_iterator&) = default;
+
+            regex_iterator& operator=(const regex_iterator&) = default;
+
+            bool operator==(const regex_iterator& other) const
+            {
+                if (!re_ || !other.re_)
+                    return re_ == other.re_;
+
+                return begin_ == other.begin_ && end_ == other.end_ &&
+                       re_ == other.re_ && flags_ == other.flags_ &&
+                       match_[0] == other.match_[0];
+            }
+
+            bool operator!=(const regex_iterator& other) const
+            {
+                return !(*this == other);
+            }
+
+            reference operator*() const
+            {
+                return match_;
+            }
+
+            pointer operator->() const
+            {
+                return &match_;
+            }
+
+            regex_iterator& operator++()
+            {
+                auto start = match_[0].second;
+                auto prefix_first = start;
+
+                if (match_[0].first == match_[0].second)
+                {
+                    if (start == end_)
+                    {
+                        re_ = nullptr;
+
+                        return *this;
+                    }
+
+                    /**
+                     * After an empty match we first try to find
+                     * a non empty one at the same position and
+                     * only then move on, otherwise we would
+                     * find the same empty match forever.
+                     */
+                    auto flags = flags_ | regex_constants::match_not_null |
+                                 regex_constants::match_continuous;
+                    if (start != begin_)
+                        flags |= regex_constants::match_prev_avail;
+
+                    if (regex_search(start, end_, match_, *re_, flags))
+                    {
+                        aux::regex_access::rebase(match_, prefix_first, begin_);
+
+                        return *this;
+                    }
+
+                    ++start;
+                }
+
+                auto flags = flags_ | regex_constants::match_prev_avail;
+                if (regex_search(start, end_, match_, *re_, flags))
+                    aux::regex_access::rebase(match_, prefix_first, begin_);
+                else
+                    re_ = nullptr;
+
+                return *this;
+            }
+
+            regex_iterator operator++(int)
+            {
+                auto tmp = *this;
+                ++(*this);
+
+                return tmp;
+            }
+
+        private:
+            BidirIt begin_;
+            BidirIt end_;
+            const regex_type* re_;
+            regex_constants::match_flag_type flags_;
+            value_type match_;
+    };
+
+    using cregex_iterator  = regex_iterator<const char*>;
+    using wcregex_iterator = regex_iterator<const wchar_t*>;
+    using sregex_iterator  = regex_iterator<string::const_iterator>;
+    using wsregex_iterator = regex_iterator<wstring::const_iterator>;
+
+    // TODO: 28.12.2, class template regex_token_iterator
+
+    /**
+     * 28.11.4, function template regex_replace:
+     */
+
+    template<class OutputIterator, class BidirIt, class Traits, class Char>
+    OutputIterator regex_replace(
+        OutputIterator out, BidirIt first, BidirIt last,
+        const basic_regex<Char, Traits>& re, const Char* fmt,
+        regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        regex_iterator<BidirIt, Char, Traits> it{first, last, re, flags};
+        regex_iterator<BidirIt, Char, Traits> end{};
+        bool copy_rest = !(flags & regex_constants::format_no_copy);
+        auto fmt_last = fmt + Traits::length(fmt);
+
+        if (it == end)
+        {
+            if (copy_rest)
+                out = copy(first, last, out);
+
+            return out;
+        }
+
+        sub_match<BidirIt> suffix{};
+        for (; it != end; ++it)
+        {
+            if (copy_rest)
+                out = copy(it->prefix().first, it->prefix().second, out);
+            out = it->format(out, fmt, fmt_last, flags);
+            suffix = it->suffix();
+
+            if (flags & regex_constants::format_first_only)
+                break;
+        }
+
+        if (copy_rest)
+            out = copy(suffix.first, suffix.second, out);
+
+        return out;
+    }
+
+    template<class OutputIterator, class BidirIt, class Traits, class Char, class ST, class SA>
+    OutputIterator regex_replace(
+        OutputIterator out, BidirIt first, BidirIt last,
+        const basic_regex<Char, Traits>& re, const basic_string<Char, ST, SA>& fmt,
+        regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        return regex_replace(out, first, last, re, fmt.c_str(), flags);
+    }
+
+    template<class Traits, class Char, class ST, class SA, class FST, class FSA>
+    basic_string<Char, ST, SA> regex_replace(
+        const basic_string<Char, ST, SA>& str,
+        const basic_regex<Char, Traits>& re, const basic_string<Char, FST, FSA>& fmt,
+        regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        basic_string<Char, ST, SA> res{};
+        regex_replace(back_inserter(res), str.begin(), str.end(), re, fmt.c_str(), flags);
+
+        return res;
+    }
+
+    template<class Traits, class Char, class ST, class SA>
+    basic_string<Char, ST, SA> regex_replace(
+        const basic_string<Char, ST, SA>& str,
+        const basic_regex<Char, Traits>& re, const Char* fmt,
+        regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        basic_string<Char, ST, SA> res{};
+        regex_replace(back_inserter(res), str.begin(), str.end(), re, fmt, flags);
+
+        return res;
+    }
+
+    template<class Traits, class Char, class ST, class SA>
+    basic_string<Char> regex_replace(
+        const Char* str, const basic_regex<Char, Traits>& re,
+        const basic_string<Char, ST, SA>& fmt,
+        regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        basic_string<Char> res{};
+        regex_replace(back_inserter(res), str, str + Traits::length(str),
+                      re, fmt.c_str(), flags);
+
+        return res;
+    }
+
+    template<class Traits, class Char>
+    basic_string<Char> regex_replace(
+        const Char* str, const basic_regex<Char, Traits>& re, const Char* fmt,
+        regex_constants::match_flag_type flags = regex_constants::match_default
+    )
+    {
+        basic_string<Char> res{};
+        regex_replace(back_inserter(res), str, str + Traits::length(str), re, fmt, flags);
+
+        return res;
+    }
+}
 
 #endif
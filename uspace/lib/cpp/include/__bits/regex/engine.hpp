@@ -0,0 +1,1041 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_REGEX_ENGINE
+#define LIBCPP_BITS_REGEX_ENGINE
+
+#include <__bits/regex/constants.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Note: Patterns are compiled into a program for a
+ *       Thompson-style NFA, which is executed by one of
+ *       three engines:
+ *         1) A lazily built DFA, which decides whether
+ *            there is a match (and where the first one
+ *            ends) in a single pass over the input without
+ *            backtracking. Its states are subsets of the
+ *            NFA states and are only created when the input
+ *            needs them, so the DFA never gets exponential.
+ *         2) A Pike VM, which simulates the NFA threads in
+ *            lockstep in their priority order and thus finds
+ *            the ECMAScript (leftmost-first) match including
+ *            its submatches, still in linear time.
+ *         3) A backtracking matcher, which is only used for
+ *            patterns with backreferences, as those cannot be
+ *            matched by an automaton.
+ *       The DFA is used as a filter, the Pike VM only runs
+ *       on the part of the input that contains the match
+ *       and only if the caller needs its bounds.
+ */
+
+namespace std::aux
+{
+    /**
+     * Instructions of the compiled program, the consuming
+     * ones (unit, dot, any, cls) advance the input by one
+     * code unit, the rest only move between instructions.
+     * Operands (x, y) are described next to the opcodes.
+     */
+    enum class regex_op: uint8_t
+    {
+        unit,              // x: code unit
+        dot,               // anything but line terminators
+        any,               // anything
+        cls,               // x: index of the character class
+        split,             // x: preferred branch, y: alternative
+        jump,              // x: target
+        save,              // x: capture slot
+        mark,              // x: counter, records the position
+        check,             // x: counter, fails if no input was consumed since mark
+        bol,
+        eol,
+        word_boundary,
+        not_word_boundary,
+        backref,           // x: group
+        match
+    };
+
+    struct regex_inst
+    {
+        regex_op op;
+        uint32_t x;
+        uint32_t y;
+    };
+
+    struct regex_class
+    {
+        /**
+         * Membership of the code units below 256 is
+         * precomputed (including negation and case folding),
+         * wider code units are looked up in the ranges.
+         */
+        uint64_t bits[4];
+        vector<pair<uint32_t, uint32_t>> ranges;
+        bool negated;
+
+        bool contains(uint32_t c) const noexcept
+        {
+            if (c < 256)
+                return (bits[c >> 6] >> (c & 63)) & 1;
+
+            bool res{false};
+            for (const auto& range: ranges)
+            {
+                if (range.first <= c && c <= range.second)
+                {
+                    res = true;
+                    break;
+                }
+            }
+
+            return res != negated;
+        }
+    };
+
+    /**
+     * State of the input around a position, which
+     * decides whether zero width assertions hold.
+     */
+    struct regex_context
+    {
+        bool bol;
+        bool eol;
+        bool boundary;
+    };
+
+    class regex_program
+    {
+        public:
+            /**
+             * Note: Only the ECMAScript grammar is supported,
+             *       patterns with other grammar flags are parsed
+             *       as ECMAScript as well. Case insensitivity only
+             *       folds the ASCII letters.
+             */
+            regex_constants::error_type compile(const uint32_t* pattern, size_t len,
+                                                regex_constants::syntax_option_type flags);
+
+            const regex_inst& operator[](size_t pc) const noexcept
+            {
+                return insts_[pc];
+            }
+
+            size_t size() const noexcept
+            {
+                return insts_.size();
+            }
+
+            bool empty() const noexcept
+            {
+                return insts_.empty();
+            }
+
+            size_t anchored_start() const noexcept
+            {
+                return 0U;
+            }
+
+            size_t unanchored_start() const noexcept
+            {
+                return unanchored_start_;
+            }
+
+            size_t mark_count() const noexcept
+            {
+                return mark_count_;
+            }
+
+            size_t slot_count() const noexcept
+            {
+                return 2 * (mark_count_ + 1);
+            }
+
+            size_t counter_count() const noexcept
+            {
+                return counter_count_;
+            }
+
+            size_t class_count() const noexcept
+            {
+                return classes_.size();
+            }
+
+            const regex_class& get_class(size_t idx) const noexcept
+            {
+                return classes_[idx];
+            }
+
+            bool has_backrefs() const noexcept
+            {
+                return has_backrefs_;
+            }
+
+            bool has_word_assertions() const noexcept
+            {
+                return has_word_assertions_;
+            }
+
+            bool multiline() const noexcept
+            {
+                return multiline_;
+            }
+
+            bool icase() const noexcept
+            {
+                return icase_;
+            }
+
+            static bool consumes(const regex_inst& inst) noexcept
+            {
+                return inst.op <= regex_op::cls;
+            }
+
+            bool matches(const regex_inst& inst, uint32_t c) const noexcept
+            {
+                switch (inst.op)
+                {
+                    case regex_op::unit:
+                        return c == inst.x;
+                    case regex_op::dot:
+                        return !is_line_terminator(c);
+                    case regex_op::any:
+                        return true;
+                    case regex_op::cls:
+                        return classes_[inst.x].contains(c);
+                    default:
+                        return false;
+                }
+            }
+
+            static bool holds(const regex_inst& inst, const regex_context& ctx) noexcept
+            {
+                switch (inst.op)
+                {
+                    case regex_op::bol:
+                        return ctx.bol;
+                    case regex_op::eol:
+                        return ctx.eol;
+                    case regex_op::word_boundary:
+                        return ctx.boundary;
+                    case regex_op::not_word_boundary:
+                        return !ctx.boundary;
+                    default:
+                        return false;
+                }
+            }
+
+            /**
+             * Computes the context of a position, prev and
+             * next are only valid if has_prev and !at_end.
+             */
+            regex_context context(bool at_first, bool has_prev, uint32_t prev,
+                                  bool at_end, uint32_t next,
+                                  regex_constants::match_flag_type flags) const noexcept
+            {
+                regex_context res{};
+
+                if (has_prev)
+                    res.bol = multiline_ && is_line_terminator(prev);
+                else
+                    res.bol = !(flags & regex_constants::match_not_bol);
+
+                if (at_end)
+                    res.eol = !(flags & regex_constants::match_not_eol);
+                else
+                    res.eol = multiline_ && is_line_terminator(next);
+
+                bool prev_word = has_prev && is_word(prev);
+                bool next_word = !at_end && is_word(next);
+                res.boundary = prev_word != next_word;
+
+                if (at_first && (flags & regex_constants::match_not_bow))
+                    res.boundary = false;
+                if (at_end && (flags & regex_constants::match_not_eow))
+                    res.boundary = false;
+
+                return res;
+            }
+
+            static bool is_word(uint32_t c) noexcept
+            {
+                return ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') ||
+                       ('0' <= c && c <= '9') || c == '_';
+            }
+
+            static bool is_line_terminator(uint32_t c) noexcept
+            {
+                return c == '\n' || c == '\r' || c == 0x2028U || c == 0x2029U;
+            }
+
+            static uint32_t fold(uint32_t c) noexcept
+            {
+                if ('A' <= c && c <= 'Z')
+                    return c - 'A' + 'a';
+                else
+                    return c;
+            }
+
+        private:
+            vector<regex_inst> insts_{};
+            vector<regex_class> classes_{};
+            size_t unanchored_start_{};
+            size_t mark_count_{};
+            size_t counter_count_{};
+            bool has_backrefs_{};
+            bool has_word_assertions_{};
+            bool multiline_{};
+            bool icase_{};
+
+            friend class regex_compiler;
+    };
+
+    template<class Char>
+    uint32_t regex_unit(Char c) noexcept
+    {
+        return static_cast<uint32_t>(static_cast<make_unsigned_t<Char>>(c));
+    }
+
+    /**
+     * Lazily built DFA over code units below 256, those are
+     * grouped into classes of units that no instruction of
+     * the program can tell apart, which keeps the transition
+     * tables small. Its states remember the NFA states that
+     * are yet to be expanded at the next position together
+     * with the part of the context that is known at that
+     * time (whether ^ holds and if the previous unit was
+     * a word character).
+     */
+    class regex_dfa
+    {
+        public:
+            static constexpr int dead{0};
+
+            explicit regex_dfa(const regex_program& prog);
+
+            size_t unit_class(uint32_t c) const noexcept
+            {
+                return unit_classes_[c];
+            }
+
+            size_t end_class() const noexcept
+            {
+                return class_count_;
+            }
+
+            int start(bool anchored, bool bol, bool prev_word);
+
+            /**
+             * Transition on the given class, accept is set if
+             * the program matches right before the unit (i.e.
+             * a match ends at the current position).
+             */
+            int step(int state, size_t cls, bool& accept)
+            {
+                auto idx = static_cast<size_t>(state) * stride_ + cls;
+                if (next_[idx] >= 0)
+                {
+                    accept = accept_[idx];
+
+                    return next_[idx];
+                }
+
+                return compute_(state, cls, accept);
+            }
+
+            /**
+             * A state is idle if no match attempt started
+             * before the current position is still running.
+             */
+            bool idle(int state) const noexcept
+            {
+                return idle_[state];
+            }
+
+        private:
+            struct key_hash
+            {
+                size_t operator()(const vector<uint32_t>& key) const noexcept
+                {
+                    size_t res{2166136261U};
+                    for (auto pc: key)
+                    {
+                        res ^= pc;
+                        res *= 16777619U;
+                    }
+
+                    return res;
+                }
+            };
+
+            const regex_program& prog_;
+
+            uint8_t unit_classes_[256];
+            uint8_t representatives_[256];
+            size_t class_count_;
+            size_t stride_;
+            size_t max_states_;
+
+            /**
+             * Keys are the sorted NFA states followed by
+             * the context flags of the state.
+             */
+            vector<vector<uint32_t>> keys_;
+            unordered_map<vector<uint32_t>, int, key_hash> states_;
+            vector<int> next_;
+            vector<uint8_t> accept_;
+            vector<uint8_t> idle_;
+
+            vector<uint32_t> stack_;
+            vector<uint32_t> visited_;
+            uint32_t generation_;
+
+            static constexpr uint32_t bol_flag{0b01};
+            static constexpr uint32_t word_flag{0b10};
+            static constexpr size_t memory_budget{1U << 20};
+
+            int compute_(int state, size_t cls, bool& accept);
+
+            int insert_(const vector<uint32_t>& key);
+
+            void flush_();
+    };
+
+    /**
+     * Runs the DFA over the input, returns true if there is
+     * a match. In the full mode, the whole input has to match,
+     * otherwise the scan stops at the end of the first match
+     * and restart is set to a position at which no earlier
+     * match attempt is in progress, so that the Pike VM
+     * does not need to go over the whole prefix.
+     */
+    template<class BidirIt>
+    bool regex_dfa_scan(regex_dfa& dfa, BidirIt first, BidirIt last, bool anchored,
+                        bool full, bool bol, bool prev_word, BidirIt& restart)
+    {
+        auto state = dfa.start(anchored, bol, prev_word);
+        bool accept{};
+
+        restart = first;
+        for (auto it = first; it != last; ++it)
+        {
+            if (!full && dfa.idle(state))
+                restart = it;
+
+            state = dfa.step(state, dfa.unit_class(regex_unit(*it)), accept);
+            if (accept && !full)
+                return true;
+
+            if (state == regex_dfa::dead)
+                return false;
+        }
+
+        dfa.step(state, dfa.end_class(), accept);
+
+        return accept;
+    }
+
+    template<class BidirIt>
+    struct regex_slot
+    {
+        BidirIt it;
+        bool set;
+    };
+
+    /**
+     * Input positions shared by the Pike VM and the
+     * backtracker, which know where the matched range
+     * starts and what (if anything) precedes it.
+     */
+    template<class BidirIt>
+    struct regex_input
+    {
+        BidirIt first;
+        BidirIt last;
+        bool has_prev;
+        uint32_t prev;
+        regex_constants::match_flag_type flags;
+
+        regex_context context(const regex_program& prog, BidirIt pos) const
+        {
+            bool at_first = pos == first;
+            bool at_end = pos == last;
+            bool prev_avail = at_first ? has_prev : true;
+            uint32_t prev_unit = at_first ? prev : regex_unit(*std::prev(pos));
+            uint32_t next_unit = at_end ? 0U : regex_unit(*pos);
+
+            return prog.context(at_first, prev_avail, prev_unit, at_end, next_unit, flags);
+        }
+    };
+
+    template<class BidirIt>
+    class regex_pike
+    {
+        public:
+            using slot_type = regex_slot<BidirIt>;
+
+            regex_pike(const regex_program& prog)
+                : prog_{prog}, nslots_{prog.slot_count()},
+                  clist_{prog.size(), nslots_}, nlist_{prog.size(), nslots_},
+                  tmp_(nslots_), stack_{}
+            { /* DUMMY BODY */ }
+
+            bool run(const regex_input<BidirIt>& in, bool anchored,
+                     bool full, vector<slot_type>& result)
+            {
+                bool matched{false};
+                auto pos = in.first;
+                auto entry = anchored ? prog_.anchored_start() : prog_.unanchored_start();
+
+                for (auto& slot: tmp_)
+                    slot = slot_type{in.last, false};
+                add_(clist_, entry, tmp_.data(), pos, in.context(prog_, pos));
+
+                while (clist_.size > 0)
+                {
+                    bool at_end = pos == in.last;
+                    uint32_t c = at_end ? 0U : regex_unit(*pos);
+                    auto next = pos;
+                    if (!at_end)
+                        ++next;
+
+                    bool ctx_ready{false};
+                    regex_context ctx{};
+
+                    nlist_.clear();
+                    for (size_t i = 0; i < clist_.size; ++i)
+                    {
+                        auto pc = clist_.dense[i];
+                        const auto& inst = prog_[pc];
+
+                        if (inst.op == regex_op::match)
+                        {
+                            if (full && !at_end)
+                                continue;
+
+                            auto slots = clist_.slots_of(pc);
+                            if ((in.flags & regex_constants::match_not_null) &&
+                                slots[0].it == pos)
+                                continue;
+
+                            result.assign(slots, slots + nslots_);
+                            matched = true;
+
+                            /**
+                             * Threads after this one have lower
+                             * priority, so they are cut off.
+                             */
+                            break;
+                        }
+                        else if (!at_end && regex_program::consumes(inst) &&
+                                 prog_.matches(inst, c))
+                        {
+                            if (!ctx_ready)
+                            {
+                                ctx = in.context(prog_, next);
+                                ctx_ready = true;
+                            }
+
+                            add_(nlist_, pc + 1, clist_.slots_of(pc), next, ctx);
+                        }
+                    }
+
+                    if (at_end)
+                        break;
+
+                    swap(clist_, nlist_);
+                    pos = next;
+                }
+
+                clist_.clear();
+
+                return matched;
+            }
+
+        private:
+            struct thread_list
+            {
+                vector<uint32_t> dense;
+                vector<uint32_t> sparse;
+                vector<slot_type> slots;
+                size_t size;
+                size_t nslots;
+
+                thread_list(size_t count, size_t nslots)
+                    : dense(count), sparse(count), slots(count * nslots),
+                      size{}, nslots{nslots}
+                { /* DUMMY BODY */ }
+
+                bool contains(uint32_t pc) const noexcept
+                {
+                    auto idx = sparse[pc];
+
+                    return idx < size && dense[idx] == pc;
+                }
+
+                void insert(uint32_t pc) noexcept
+                {
+                    sparse[pc] = size;
+                    dense[size++] = pc;
+                }
+
+                slot_type* slots_of(uint32_t pc) noexcept
+                {
+                    return slots.data() + pc * nslots;
+                }
+
+                void clear() noexcept
+                {
+                    size = 0;
+                }
+            };
+
+            struct frame
+            {
+                uint32_t pc;
+                uint32_t slot;
+                slot_type old;
+                bool restore;
+            };
+
+            const regex_program& prog_;
+            size_t nslots_;
+            thread_list clist_;
+            thread_list nlist_;
+            vector<slot_type> tmp_;
+            vector<frame> stack_;
+
+            /**
+             * Follows the non-consuming instructions from pc
+             * and adds the reached threads to the list in
+             * the priority order. An explicit stack is used,
+             * as fibrils have small stacks.
+             */
+            void add_(thread_list& list, size_t start, const slot_type* slots,
+                      BidirIt pos, const regex_context& ctx)
+            {
+                if (slots != tmp_.data())
+                    tmp_.assign(slots, slots + nslots_);
+
+                stack_.push_back(frame{static_cast<uint32_t>(start), 0U, slot_type{pos, false}, false});
+                while (!stack_.empty())
+                {
+                    auto f = stack_.back();
+                    stack_.pop_back();
+
+                    if (f.restore)
+                    {
+                        tmp_[f.slot] = f.old;
+                        continue;
+                    }
+
+                    auto pc = f.pc;
+                    if (list.contains(pc))
+                        continue;
+                    list.insert(pc);
+
+                    const auto& inst = prog_[pc];
+                    switch (inst.op)
+                    {
+                        case regex_op::jump:
+                            push_(inst.x);
+                            break;
+                        case regex_op::split:
+                            push_(inst.y);
+                            push_(inst.x);
+                            break;
+                        case regex_op::save:
+                            stack_.push_back(frame{0U, inst.x, tmp_[inst.x], true});
+                            tmp_[inst.x] = slot_type{pos, true};
+                            push_(pc + 1);
+                            break;
+                        case regex_op::mark:
+                        case regex_op::check:
+                            push_(pc + 1);
+                            break;
+                        case regex_op::bol:
+                        case regex_op::eol:
+                        case regex_op::word_boundary:
+                        case regex_op::not_word_boundary:
+                            if (regex_program::holds(inst, ctx))
+                                push_(pc + 1);
+                            break;
+                        default:
+                            copy(tmp_.begin(), tmp_.end(), list.slots_of(pc));
+                            break;
+                    }
+                }
+            }
+
+            void push_(size_t pc)
+            {
+                stack_.push_back(frame{static_cast<uint32_t>(pc), 0U, slot_type{}, false});
+            }
+    };
+
+    /**
+     * Backtracking matcher for programs with backreferences,
+     * the choice points and the values overwritten since
+     * them are kept on an explicit stack.
+     */
+    template<class BidirIt>
+    class regex_backtracker
+    {
+        public:
+            using slot_type = regex_slot<BidirIt>;
+
+            regex_backtracker(const regex_program& prog)
+                : prog_{prog}, slots_(prog.slot_count()),
+                  counters_(prog.counter_count()), stack_{}
+            { /* DUMMY BODY */ }
+
+            bool run(const regex_input<BidirIt>& in, bool anchored,
+                     bool full, vector<slot_type>& result)
+            {
+                for (auto& slot: slots_)
+                    slot = slot_type{in.last, false};
+                for (auto& counter: counters_)
+                    counter = slot_type{in.last, false};
+                stack_.clear();
+
+                size_t pc = anchored ? prog_.anchored_start() : prog_.unanchored_start();
+                auto pos = in.first;
+
+                while (true)
+                {
+                    bool at_match = prog_[pc].op == regex_op::match;
+                    if (step_(in, pc, pos, full))
+                    {
+                        if (at_match)
+                        {
+                            result = slots_;
+
+                            return true;
+                        }
+
+                        continue;
+                    }
+
+                    /**
+                     * Failure, undo the changes made since
+                     * the last choice point and take it.
+                     */
+                    bool resumed{false};
+                    while (!stack_.empty())
+                    {
+                        auto e = stack_.back();
+                        stack_.pop_back();
+
+                        if (e.kind == entry_kind::branch)
+                        {
+                            pc = e.idx;
+                            pos = e.old.it;
+                            resumed = true;
+                            break;
+                        }
+                        else if (e.kind == entry_kind::slot)
+                            slots_[e.idx] = e.old;
+                        else
+                            counters_[e.idx] = e.old;
+                    }
+
+                    if (!resumed)
+                        return false;
+                }
+            }
+
+        private:
+            enum class entry_kind
+            {
+                branch, slot, counter
+            };
+
+            struct entry
+            {
+                entry_kind kind;
+                size_t idx;
+                slot_type old;
+            };
+
+            const regex_program& prog_;
+            vector<slot_type> slots_;
+            vector<slot_type> counters_;
+            vector<entry> stack_;
+
+            /**
+             * Executes the instruction at pc, returns false
+             * if it fails and true if the execution can go on
+             * (pc and pos are updated) or the program matched
+             * (pc stays at the match instruction).
+             */
+            bool step_(const regex_input<BidirIt>& in, size_t& pc,
+                       BidirIt& pos, bool full)
+            {
+                const auto& inst = prog_[pc];
+
+                switch (inst.op)
+                {
+                    case regex_op::unit:
+                    case regex_op::dot:
+                    case regex_op::any:
+                    case regex_op::cls:
+                        if (pos == in.last || !prog_.matches(inst, regex_unit(*pos)))
+                            return false;
+                        ++pos;
+                        ++pc;
+                        return true;
+                    case regex_op::split:
+                        stack_.push_back(entry{entry_kind::branch, inst.y, slot_type{pos, true}});
+                        pc = inst.x;
+                        return true;
+                    case regex_op::jump:
+                        pc = inst.x;
+                        return true;
+                    case regex_op::save:
+                        stack_.push_back(entry{entry_kind::slot, inst.x, slots_[inst.x]});
+                        slots_[inst.x] = slot_type{pos, true};
+                        ++pc;
+                        return true;
+                    case regex_op::mark:
+                        stack_.push_back(entry{entry_kind::counter, inst.x, counters_[inst.x]});
+                        counters_[inst.x] = slot_type{pos, true};
+                        ++pc;
+                        return true;
+                    case regex_op::check:
+                        if (counters_[inst.x].set && counters_[inst.x].it == pos)
+                            return false;
+                        ++pc;
+                        return true;
+                    case regex_op::bol:
+                    case regex_op::eol:
+                    case regex_op::word_boundary:
+                    case regex_op::not_word_boundary:
+                        if (!regex_program::holds(inst, in.context(prog_, pos)))
+                            return false;
+                        ++pc;
+                        return true;
+                    case regex_op::backref:
+                        return backref_(in, inst.x, pc, pos);
+                    case regex_op::match:
+                        if (full && pos != in.last)
+                            return false;
+                        if ((in.flags & regex_constants::match_not_null) &&
+                            slots_[0].it == pos)
+                            return false;
+                        return true;
+                }
+
+                return false;
+            }
+
+            /**
+             * Note: As in ECMAScript, references to groups
+             *       that did not participate in the match
+             *       match the empty string.
+             */
+            bool backref_(const regex_input<BidirIt>& in, size_t group,
+                          size_t& pc, BidirIt& pos)
+            {
+                const auto& begin = slots_[2 * group];
+                const auto& end = slots_[2 * group + 1];
+
+                if (begin.set && end.set)
+                {
+                    auto it = pos;
+                    for (auto ref = begin.it; ref != end.it; ++ref, ++it)
+                    {
+                        if (it == in.last)
+                            return false;
+
+                        auto c1 = regex_unit(*ref);
+                        auto c2 = regex_unit(*it);
+                        if (prog_.icase())
+                        {
+                            c1 = regex_program::fold(c1);
+                            c2 = regex_program::fold(c2);
+                        }
+
+                        if (c1 != c2)
+                            return false;
+                    }
+
+                    pos = it;
+                }
+
+                ++pc;
+
+                return true;
+            }
+    };
+
+    /**
+     * Compiled regex shared by the copies of a basic_regex,
+     * along with its DFA cache. The cache is used by one
+     * matcher at a time, concurrent matchers build private
+     * DFAs instead of waiting for it.
+     */
+    class regex_impl
+    {
+        public:
+            regex_impl(const uint32_t* pattern, size_t len,
+                       regex_constants::syntax_option_type flags)
+                : prog_{}, error_{prog_.compile(pattern, len, flags)},
+                  dfa_{prog_}, dfa_busy_{false}
+            { /* DUMMY BODY */ }
+
+            const regex_program& program() const noexcept
+            {
+                return prog_;
+            }
+
+            regex_constants::error_type error() const noexcept
+            {
+                return error_;
+            }
+
+            template<class BidirIt>
+            bool scan(BidirIt first, BidirIt last, bool anchored, bool full,
+                      bool bol, bool prev_word, BidirIt& restart)
+            {
+                if (!dfa_busy_.exchange(true, memory_order_acquire))
+                {
+                    auto res = regex_dfa_scan(
+                        dfa_, first, last, anchored, full, bol, prev_word, restart
+                    );
+                    dfa_busy_.store(false, memory_order_release);
+
+                    return res;
+                }
+                else
+                {
+                    regex_dfa dfa{prog_};
+
+                    return regex_dfa_scan(
+                        dfa, first, last, anchored, full, bol, prev_word, restart
+                    );
+                }
+            }
+
+        private:
+            regex_program prog_;
+            regex_constants::error_type error_;
+            regex_dfa dfa_;
+            atomic<bool> dfa_busy_;
+    };
+
+    /**
+     * Finds a match in [first, last), fills the capture slots
+     * if slots is not null. If search is false, the whole
+     * input has to match.
+     */
+    template<class BidirIt>
+    bool regex_execute(regex_impl& impl, BidirIt first, BidirIt last,
+                       vector<regex_slot<BidirIt>>* slots,
+                       regex_constants::match_flag_type flags, bool search)
+    {
+        using char_type = typename iterator_traits<BidirIt>::value_type;
+
+        const auto& prog = impl.program();
+        if (prog.empty())
+            return false;
+
+        bool anchored = !search || (flags & regex_constants::match_continuous);
+        bool full = !search;
+
+        regex_input<BidirIt> in{first, last, false, 0U, flags};
+        if (flags & regex_constants::match_prev_avail)
+        {
+            in.has_prev = true;
+            in.prev = regex_unit(*std::prev(first));
+        }
+
+        if (prog.has_backrefs())
+        {
+            vector<regex_slot<BidirIt>> tmp{};
+            regex_backtracker<BidirIt> bt{prog};
+
+            return bt.run(in, anchored, full, slots ? *slots : tmp);
+        }
+
+        /**
+         * The DFA does not track the flags that are rarely
+         * used, in that case we go straight to the Pike VM.
+         */
+        constexpr auto pike_only_flags =
+            regex_constants::match_not_bol | regex_constants::match_not_eol |
+            regex_constants::match_not_bow | regex_constants::match_not_eow |
+            regex_constants::match_not_null;
+
+        if constexpr (sizeof(char_type) == 1)
+        {
+            if (!(flags & pike_only_flags))
+            {
+                bool bol = !in.has_prev || (prog.multiline() &&
+                           regex_program::is_line_terminator(in.prev));
+                bool prev_word = in.has_prev && regex_program::is_word(in.prev);
+
+                BidirIt restart{first};
+                if (!impl.scan(first, last, anchored, full, bol, prev_word, restart))
+                    return false;
+
+                if (!slots)
+                    return true;
+
+                if (full && prog.mark_count() == 0)
+                {
+                    slots->assign(prog.slot_count(), regex_slot<BidirIt>{last, false});
+                    (*slots)[0] = regex_slot<BidirIt>{first, true};
+                    (*slots)[1] = regex_slot<BidirIt>{last, true};
+
+                    return true;
+                }
+
+                if (restart != first)
+                {
+                    in.first = restart;
+                    in.has_prev = true;
+                    in.prev = regex_unit(*std::prev(restart));
+                }
+            }
+        }
+
+        vector<regex_slot<BidirIt>> tmp{};
+        regex_pike<BidirIt> pike{prog};
+
+        return pike.run(in, anchored, full, slots ? *slots : tmp);
+    }
+}
+
+#endif
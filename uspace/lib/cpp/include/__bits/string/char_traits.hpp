@@ -0,0 +1,437 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_STRING_CHAR_TRAITS
+#define LIBCPP_BITS_STRING_CHAR_TRAITS
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <iosfwd>
+
+namespace std
+{
+    /**
+     * 21.2, char_traits:
+     */
+
+    template<class Char>
+    struct char_traits;
+
+    /**
+     * 21.2.3, char_traits specializations:
+     */
+
+    template<>
+    struct char_traits<char>
+    {
+        using char_type  = char;
+        using int_type   = int;
+        using off_type   = streamoff;
+        using pos_type   = streampos;
+        /* using state_type = mbstate_t; */
+
+        static void assign(char_type& c1, const char_type& c2) noexcept
+        {
+            c1 = c2;
+        }
+
+        static constexpr bool eq(char_type c1, char_type c2) noexcept
+        {
+            return c1 == c2;
+        }
+
+        static constexpr bool lt(char_type c1, char_type c2) noexcept
+        {
+            return static_cast<unsigned char>(c1) < static_cast<unsigned char>(c2);
+        }
+
+        /**
+         * Note: Strings and views can contain null characters
+         *       and n is the number of code units, not the number
+         *       of (UTF-8) characters, so we cannot use str_lcmp.
+         */
+        static int compare(const char_type* s1, const char_type* s2, size_t n)
+        {
+            if (n == 0)
+                return 0;
+
+            return hel::memcmp(s1, s2, n);
+        }
+
+        static size_t length(const char_type* s)
+        {
+            return hel::str_size(s);
+        }
+
+        static const char_type* find(const char_type* s, size_t n, const char_type& c)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (eq(s[i], c))
+                    return s + i;
+            }
+
+            return nullptr;
+        }
+
+        static char_type* move(char_type* s1, const char_type* s2, size_t n)
+        {
+            return static_cast<char_type*>(memmove(s1, s2, n));
+        }
+
+        static char_type* copy(char_type* s1, const char_type* s2, size_t n)
+        {
+            return static_cast<char_type*>(memcpy(s1, s2, n));
+        }
+
+        static char_type* assign(char_type* s, size_t n, char_type c)
+        {
+            /**
+             * Note: Even though memset accepts int as its second argument,
+             *       the actual implementation assigns that int to a dereferenced
+             *       char pointer.
+             */
+            return static_cast<char_type*>(memset(s, static_cast<int>(c), n));
+        }
+
+        static constexpr int_type not_eof(int_type c) noexcept
+        {
+            if (!eq_int_type(c, eof()))
+                return c;
+            else
+                return to_int_type('a'); // We just need something that is not eof.
+        }
+
+        static constexpr char_type to_char_type(int_type c) noexcept
+        {
+            return static_cast<char_type>(c);
+        }
+
+        static constexpr int_type to_int_type(char_type c) noexcept
+        {
+            return static_cast<int_type>(c);
+        }
+
+        static constexpr bool eq_int_type(int_type c1, int_type c2) noexcept
+        {
+            return c1 == c2;
+        }
+
+        static constexpr int_type eof() noexcept
+        {
+            return static_cast<int_type>(EOF);
+        }
+    };
+
+    template<>
+    struct char_traits<char16_t>
+    {
+        // TODO: implement
+        using char_type  = char16_t;
+        using int_type   = int16_t;
+        using off_type   = streamoff;
+        using pos_type   = streampos;
+        /* using state_type = mbstate_t; */
+
+        static void assign(char_type& c1, const char_type& c2) noexcept
+        {
+            c1 = c2;
+        }
+
+        static constexpr bool eq(char_type c1, char_type c2) noexcept
+        {
+            return c1 == c2;
+        }
+
+        static constexpr bool lt(char_type c1, char_type c2) noexcept
+        {
+            return c1 < c2;
+        }
+
+        static int compare(const char_type* s1, const char_type* s2, size_t n)
+        {
+            // TODO: implement
+            __unimplemented();
+            return 0;
+        }
+
+        static size_t length(const char_type* s)
+        {
+            // TODO: implement
+            __unimplemented();
+            return 0;
+        }
+
+        static const char_type* find(const char_type* s, size_t n, const char_type& c)
+        {
+            // TODO: implement
+            __unimplemented();
+            return nullptr;
+        }
+
+        static char_type* move(char_type* s1, const char_type* s2, size_t n)
+        {
+            // TODO: implement
+            __unimplemented();
+            return nullptr;
+        }
+
+        static char_type* copy(char_type* s1, const char_type* s2, size_t n)
+        {
+            // TODO: implement
+            __unimplemented();
+            return nullptr;
+        }
+
+        static char_type* assign(char_type* s, size_t n, char_type c)
+        {
+            // TODO: implement
+            __unimplemented();
+            return nullptr;
+        }
+
+        static constexpr int_type not_eof(int_type c) noexcept
+        {
+            // TODO: implement
+            return int_type{};
+        }
+
+        static constexpr char_type to_char_type(int_type c) noexcept
+        {
+            return static_cast<char_type>(c);
+        }
+
+        static constexpr int_type to_int_type(char_type c) noexcept
+        {
+            return static_cast<int_type>(c);
+        }
+
+        static constexpr bool eq_int_type(int_type c1, int_type c2) noexcept
+        {
+            return c1 == c2;
+        }
+
+        static constexpr int_type eof() noexcept
+        {
+            return static_cast<int_type>(EOF);
+        }
+    };
+
+    template<>
+    struct char_traits<char32_t>
+    {
+        // TODO: implement
+        using char_type  = char32_t;
+        using int_type   = int32_t;
+        using off_type   = streamoff;
+        using pos_type   = streampos;
+        /* using state_type = mbstate_t; */
+
+        static void assign(char_type& c1, const char_type& c2) noexcept
+        {
+            c1 = c2;
+        }
+
+        static constexpr bool eq(char_type c1, char_type c2) noexcept
+        {
+            return c1 == c2;
+        }
+
+        static constexpr bool lt(char_type c1, char_type c2) noexcept
+        {
+            return c1 < c2;
+        }
+
+        static int compare(const char_type* s1, const char_type* s2, size_t n)
+        {
+            // TODO: implement
+            __unimplemented();
+            return 0;
+        }
+
+        static size_t length(const char_type* s)
+        {
+            // TODO: implement
+            __unimplemented();
+            return 0;
+        }
+
+        static const char_type* find(const char_type* s, size_t n, const char_type& c)
+        {
+            // TODO: implement
+            __unimplemented();
+            return nullptr;
+        }
+
+        static char_type* move(char_type* s1, const char_type* s2, size_t n)
+        {
+            // TODO: implement
+            __unimplemented();
+            return nullptr;
+        }
+
+        static char_type* copy(char_type* s1, const char_type* s2, size_t n)
+        {
+            // TODO: implement
+            __unimplemented();
+            return nullptr;
+        }
+
+        static char_type* assign(char_type* s, size_t n, char_type c)
+        {
+            // TODO: implement
+            __unimplemented();
+            return nullptr;
+        }
+
+        static constexpr int_type not_eof(int_type c) noexcept
+        {
+            // TODO: implement
+            return int_type{};
+        }
+
+        static constexpr char_type to_char_type(int_type c) noexcept
+        {
+            return static_cast<char_type>(c);
+        }
+
+        static constexpr int_type to_int_type(char_type c) noexcept
+        {
+            return static_cast<int_type>(c);
+        }
+
+        static constexpr bool eq_int_type(int_type c1, int_type c2) noexcept
+        {
+            return c1 == c2;
+        }
+
+        static constexpr int_type eof() noexcept
+        {
+            return static_cast<int_type>(EOF);
+        }
+    };
+
+    template<>
+    struct char_traits<wchar_t>
+    {
+        using char_type  = wchar_t;
+        using int_type   = wint_t;
+        using off_type   = streamoff;
+        using pos_type   = wstreampos;
+        /* using state_type = mbstate_t; */
+
+        static void assign(char_type& c1, const char_type& c2) noexcept
+        {
+            c1 = c2;
+        }
+
+        static constexpr bool eq(char_type c1, char_type c2) noexcept
+        {
+            return c1 == c2;
+        }
+
+        static constexpr bool lt(char_type c1, char_type c2) noexcept
+        {
+            return c1 < c2;
+        }
+
+        static int compare(const char_type* s1, const char_type* s2, size_t n)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (s1[i] != s2[i])
+                    return s1[i] < s2[i] ? -1 : 1;
+            }
+
+            return 0;
+        }
+
+        static size_t length(const char_type* s)
+        {
+            return hel::wstr_length(s);
+        }
+
+        static const char_type* find(const char_type* s, size_t n, const char_type& c)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (eq(s[i], c))
+                    return s + i;
+            }
+
+            return nullptr;
+        }
+
+        static char_type* move(char_type* s1, const char_type* s2, size_t n)
+        {
+            return static_cast<char_type*>(memmove(s1, s2, n * sizeof(wchar_t)));
+        }
+
+        static char_type* copy(char_type* s1, const char_type* s2, size_t n)
+        {
+            return static_cast<char_type*>(memcpy(s1, s2, n * sizeof(wchar_t)));
+        }
+
+        static char_type* assign(char_type* s, size_t n, char_type c)
+        {
+            return static_cast<char_type*>(memset(s, static_cast<int>(c), n * sizeof(wchar_t)));
+        }
+
+        static constexpr int_type not_eof(int_type c) noexcept
+        {
+            if (!eq_int_type(c, eof()))
+                return c;
+            else
+                return to_int_type(L'a'); // We just need something that is not eof.
+        }
+
+        static constexpr char_type to_char_type(int_type c) noexcept
+        {
+            return static_cast<char_type>(c);
+        }
+
+        static constexpr int_type to_int_type(char_type c) noexcept
+        {
+            return static_cast<int_type>(c);
+        }
+
+        static constexpr bool eq_int_type(int_type c1, int_type c2) noexcept
+        {
+            return c1 == c2;
+        }
+
+        static constexpr int_type eof() noexcept
+        {
+            return static_cast<int_type>(EOF);
+        }
+    };
+}
+
+#endif
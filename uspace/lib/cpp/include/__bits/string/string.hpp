@@ -29,6 +29,9 @@
 #ifndef LIBCPP_BITS_STRING
 #define LIBCPP_BITS_STRING
 
+#include <__bits/functional/hash.hpp>
+#include <__bits/string/char_traits.hpp>
+#include <__bits/string/string_view.hpp>
 #include <__bits/string/stringfwd.hpp>
 #include <algorithm>
 #include <cassert>
@@ -44,393 +47,6 @@
 
 namespace std
 {
-    /**
-     * 21.2, char_traits:
-     */
-
-    template<class Char>
-    struct char_traits;
-
-    /**
-     * 21.2.3, char_traits specializations:
-     */
-
-    template<>
-    struct char_traits<char>
-    {
-        using char_type  = char;
-        using int_type   = int;
-        using off_type   = streamoff;
-        using pos_type   = streampos;
-        /* using state_type = mbstate_t; */
-
-        static void assign(char_type& c1, const char_type& c2) noexcept
-        {
-            c1 = c2;
-        }
-
-        static constexpr bool eq(char_type c1, char_type c2) noexcept
-        {
-            return c1 == c2;
-        }
-
-        static constexpr bool lt(char_type c1, char_type c2) noexcept
-        {
-            return c1 < c2;
-        }
-
-        static int compare(const char_type* s1, const char_type* s2, size_t n)
-        {
-            return hel::str_lcmp(s1, s2, n);
-        }
-
-        static size_t length(const char_type* s)
-        {
-            return hel::str_size(s);
-        }
-
-        static const char_type* find(const char_type* s, size_t n, const char_type& c)
-        {
-            size_t i{};
-            while (i++ < n)
-            {
-                if (s[i] == c)
-                    return s + i;
-            }
-
-            return nullptr;
-        }
-
-        static char_type* move(char_type* s1, const char_type* s2, size_t n)
-        {
-            return static_cast<char_type*>(memmove(s1, s2, n));
-        }
-
-        static char_type* copy(char_type* s1, const char_type* s2, size_t n)
-        {
-            return static_cast<char_type*>(memcpy(s1, s2, n));
-        }
-
-        static char_type* assign(char_type* s, size_t n, char_type c)
-        {
-            /**
-             * Note: Even though memset accepts int as its second argument,
-             *       the actual implementation assigns that int to a dereferenced
-             *       char pointer.
-             */
-            return static_cast<char_type*>(memset(s, static_cast<int>(c), n));
-        }
-
-        static constexpr int_type not_eof(int_type c) noexcept
-        {
-            if (!eq_int_type(c, eof()))
-                return c;
-            else
-                return to_int_type('a'); // We just need something that is not eof.
-        }
-
-        static constexpr char_type to_char_type(int_type c) noexcept
-        {
-            return static_cast<char_type>(c);
-        }
-
-        static constexpr int_type to_int_type(char_type c) noexcept
-        {
-            return static_cast<int_type>(c);
-        }
-
-        static constexpr bool eq_int_type(int_type c1, int_type c2) noexcept
-        {
-            return c1 == c2;
-        }
-
-        static constexpr int_type eof() noexcept
-        {
-            return static_cast<int_type>(EOF);
-        }
-    };
-
-    template<>
-    struct char_traits<char16_t>
-    {
-        // TODO: implement
-        using char_type  = char16_t;
-        using int_type   = int16_t;
-        using off_type   = streamoff;
-        using pos_type   = streampos;
-        /* using state_type = mbstate_t; */
-
-        static void assign(char_type& c1, const char_type& c2) noexcept
-        {
-            c1 = c2;
-        }
-
-        static constexpr bool eq(char_type c1, char_type c2) noexcept
-        {
-            return c1 == c2;
-        }
-
-        static constexpr bool lt(char_type c1, char_type c2) noexcept
-        {
-            return c1 < c2;
-        }
-
-        static int compare(const char_type* s1, const char_type* s2, size_t n)
-        {
-            // TODO: implement
-            __unimplemented();
-            return 0;
-        }
-
-        static size_t length(const char_type* s)
-        {
-            // TODO: implement
-            __unimplemented();
-            return 0;
-        }
-
-        static const char_type* find(const char_type* s, size_t n, const char_type& c)
-        {
-            // TODO: implement
-            __unimplemented();
-            return nullptr;
-        }
-
-        static char_type* move(char_type* s1, const char_type* s2, size_t n)
-        {
-            // TODO: implement
-            __unimplemented();
-            return nullptr;
-        }
-
-        static char_type* copy(char_type* s1, const char_type* s2, size_t n)
-        {
-            // TODO: implement
-            __unimplemented();
-            return nullptr;
-        }
-
-        static char_type* assign(char_type* s, size_t n, char_type c)
-        {
-            // TODO: implement
-            __unimplemented();
-            return nullptr;
-        }
-
-        static constexpr int_type not_eof(int_type c) noexcept
-        {
-            // TODO: implement
-            return int_type{};
-        }
-
-        static constexpr char_type to_char_type(int_type c) noexcept
-        {
-            return static_cast<char_type>(c);
-        }
-
-        static constexpr int_type to_int_type(char_type c) noexcept
-        {
-            return static_cast<int_type>(c);
-        }
-
-        static constexpr bool eq_int_type(int_type c1, int_type c2) noexcept
-        {
-            return c1 == c2;
-        }
-
-        static constexpr int_type eof() noexcept
-        {
-            return static_cast<int_type>(EOF);
-        }
-    };
-
-    template<>
-    struct char_traits<char32_t>
-    {
-        // TODO: implement
-        using char_type  = char32_t;
-        using int_type   = int32_t;
-        using off_type   = streamoff;
-        using pos_type   = streampos;
-        /* using state_type = mbstate_t; */
-
-        static void assign(char_type& c1, const char_type& c2) noexcept
-        {
-            c1 = c2;
-        }
-
-        static constexpr bool eq(char_type c1, char_type c2) noexcept
-        {
-            return c1 == c2;
-        }
-
-        static constexpr bool lt(char_type c1, char_type c2) noexcept
-        {
-            return c1 < c2;
-        }
-
-        static int compare(const char_type* s1, const char_type* s2, size_t n)
-        {
-            // TODO: implement
-            __unimplemented();
-            return 0;
-        }
-
-        static size_t length(const char_type* s)
-        {
-            // TODO: implement
-            __unimplemented();
-            return 0;
-        }
-
-        static const char_type* find(const char_type* s, size_t n, const char_type& c)
-        {
-            // TODO: implement
-            __unimplemented();
-            return nullptr;
-        }
-
-        static char_type* move(char_type* s1, const char_type* s2, size_t n)
-        {
-            // TODO: implement
-            __unimplemented();
-            return nullptr;
-        }
-
-        static char_type* copy(char_type* s1, const char_type* s2, size_t n)
-        {
-            // TODO: implement
-            __unimplemented();
-            return nullptr;
-        }
-
-        static char_type* assign(char_type* s, size_t n, char_type c)
-        {
-            // TODO: implement
-            __unimplemented();
-            return nullptr;
-        }
-
-        static constexpr int_type not_eof(int_type c) noexcept
-        {
-            // TODO: implement
-            return int_type{};
-        }
-
-        static constexpr char_type to_char_type(int_type c) noexcept
-        {
-            return static_cast<char_type>(c);
-        }
-
-        static constexpr int_type to_int_type(char_type c) noexcept
-        {
-            return static_cast<int_type>(c);
-        }
-
-        static constexpr bool eq_int_type(int_type c1, int_type c2) noexcept
-        {
-            return c1 == c2;
-        }
-
-        static constexpr int_type eof() noexcept
-        {
-            return static_cast<int_type>(EOF);
-        }
-    };
-
-    template<>
-    struct char_traits<wchar_t>
-    {
-        using char_type  = wchar_t;
-        using int_type   = wint_t;
-        using off_type   = streamoff;
-        using pos_type   = wstreampos;
-        /* using state_type = mbstate_t; */
-
-        static void assign(char_type& c1, const char_type& c2) noexcept
-        {
-            c1 = c2;
-        }
-
-        static constexpr bool eq(char_type c1, char_type c2) noexcept
-        {
-            return c1 == c2;
-        }
-
-        static constexpr bool lt(char_type c1, char_type c2) noexcept
-        {
-            return c1 < c2;
-        }
-
-        static int compare(const char_type* s1, const char_type* s2, size_t n)
-        {
-            // TODO: This function does not exits...
-            __unimplemented();
-            //return hel::wstr_lcmp(s1, s2, n);
-            return 0;
-        }
-
-        static size_t length(const char_type* s)
-        {
-            return hel::wstr_size(s);
-        }
-
-        static const char_type* find(const char_type* s, size_t n, const char_type& c)
-        {
-            size_t i{};
-            while (i++ < n)
-            {
-                if (s[i] == c)
-                    return s + i;
-            }
-
-            return nullptr;
-        }
-
-        static char_type* move(char_type* s1, const char_type* s2, size_t n)
-        {
-            return static_cast<char_type*>(memmove(s1, s2, n * sizeof(wchar_t)));
-        }
-
-        static char_type* copy(char_type* s1, const char_type* s2, size_t n)
-        {
-            return static_cast<char_type*>(memcpy(s1, s2, n * sizeof(wchar_t)));
-        }
-
-        static char_type* assign(char_type* s, size_t n, char_type c)
-        {
-            return static_cast<char_type*>(memset(s, static_cast<int>(c), n * sizeof(wchar_t)));
-        }
-
-        static constexpr int_type not_eof(int_type c) noexcept
-        {
-            if (!eq_int_type(c, eof()))
-                return c;
-            else
-                return to_int_type(L'a'); // We just need something that is not eof.
-        }
-
-        static constexpr char_type to_char_type(int_type c) noexcept
-        {
-            return static_cast<char_type>(c);
-        }
-
-        static constexpr int_type to_int_type(char_type c) noexcept
-        {
-            return static_cast<int_type>(c);
-        }
-
-        static constexpr bool eq_int_type(int_type c1, int_type c2) noexcept
-        {
-            return c1 == c2;
-        }
-
-        static constexpr int_type eof() noexcept
-        {
-            return static_cast<int_type>(EOF);
-        }
-    };
-
     /**
      * 21.4, class template basic_string:
      */
@@ -457,6 +73,23 @@ namespace std
 
             static constexpr size_type npos = -1;
 
+        private:
+            using view_type_ = basic_string_view<value_type, traits_type>;
+
+            /**
+             * Note: Overloads that take a view and a position would
+             *       be ambiguous with their basic_string counterparts
+             *       when called with a string literal, so they are
+             *       templates that only accept types convertible to
+             *       a view but not to a pointer (21.4.2).
+             */
+            template<class T>
+            using enable_if_view_ = enable_if_t<
+                is_convertible_v<const T&, view_type_> &&
+                !is_convertible_v<const T&, const value_type*>
+            >;
+
+        public:
             /**
              * 21.4.2, construct/copy/destroy:
              * TODO: tagged constructor that moves the char*
@@ -468,37 +101,36 @@ namespace std
             { /* DUMMY BODY */ }
 
             explicit basic_string(const allocator_type& alloc)
-                : data_{}, size_{}, capacity_{}, allocator_{alloc}
+                : data_{sso_}, size_{}, capacity_{sso_capacity_}, allocator_{alloc}
             {
                 /**
                  * Postconditions:
                  *  data() = non-null copyable value that can have 0 added to it.
                  *  size() = 0
                  *  capacity() = unspecified
+                 * Note: Empty strings live in the inline buffer
+                 *       and thus never allocate.
                  */
-                data_ = allocator_.allocate(default_capacity_);
-                capacity_ = default_capacity_;
+                ensure_null_terminator_();
             }
 
             basic_string(const basic_string& other)
-                : data_{}, size_{other.size_}, capacity_{other.capacity_},
+                : data_{sso_}, size_{}, capacity_{sso_capacity_},
                   allocator_{other.allocator_}
             {
-                init_(other.data(), size_);
+                init_(other.data(), other.size_);
             }
 
             basic_string(basic_string&& other)
-                : data_{other.data_}, size_{other.size_},
-                  capacity_{other.capacity_}, allocator_{move(other.allocator_)}
+                : data_{sso_}, size_{}, capacity_{sso_capacity_},
+                  allocator_{move(other.allocator_)}
             {
-                other.data_ = nullptr;
-                other.size_ = 0;
-                other.capacity_ = 0;
+                steal_(other);
             }
 
             basic_string(const basic_string& other, size_type pos, size_type n = npos,
                          const allocator_type& alloc = allocator_type{})
-                : data_{}, size_{}, capacity_{}, allocator_{alloc}
+                : data_{sso_}, size_{}, capacity_{sso_capacity_}, allocator_{alloc}
             {
                 // TODO: if pos < other.size() throw out_of_range.
                 auto len = min(n, other.size() - pos);
@@ -506,21 +138,22 @@ namespace std
             }
 
             basic_string(const value_type* str, size_type n, const allocator_type& alloc = allocator_type{})
-                : data_{}, size_{n}, capacity_{n}, allocator_{alloc}
+                : data_{sso_}, size_{}, capacity_{sso_capacity_}, allocator_{alloc}
             {
-                init_(str, size_);
+                init_(str, n);
             }
 
             basic_string(const value_type* str, const allocator_type& alloc = allocator_type{})
-                : data_{}, size_{}, capacity_{}, allocator_{alloc}
+                : data_{sso_}, size_{}, capacity_{sso_capacity_}, allocator_{alloc}
             {
                 init_(str, traits_type::length(str));
             }
 
             basic_string(size_type n, value_type c, const allocator_type& alloc = allocator_type{})
-                : data_{}, size_{n}, capacity_{n}, allocator_{alloc}
+                : data_{sso_}, size_{}, capacity_{sso_capacity_}, allocator_{alloc}
             {
-                data_ = allocator_.allocate(capacity_);
+                allocate_(n);
+                size_ = n;
                 for (size_type i = 0; i < size_; ++i)
                     traits_type::assign(data_[i], c);
                 ensure_null_terminator_();
@@ -529,13 +162,12 @@ namespace std
             template<class InputIterator>
             basic_string(InputIterator first, InputIterator last,
                          const allocator_type& alloc = allocator_type{})
-                : data_{}, size_{}, capacity_{}, allocator_{alloc}
+                : data_{sso_}, size_{}, capacity_{sso_capacity_}, allocator_{alloc}
             {
                 if constexpr (is_integral<InputIterator>::value)
                 { // Required by the standard.
+                    allocate_(static_cast<size_type>(first));
                     size_ = static_cast<size_type>(first);
-                    capacity_ = size_;
-                    data_ = allocator_.allocate(capacity_);
 
                     for (size_type i = 0; i < size_; ++i)
                         traits_type::assign(data_[i], static_cast<value_type>(last));
@@ -548,27 +180,29 @@ namespace std
                 }
             }
 
+            explicit basic_string(view_type_ str, const allocator_type& alloc = allocator_type{})
+                : basic_string{str.data(), str.size(), alloc}
+            { /* DUMMY BODY */ }
+
             basic_string(initializer_list<value_type> init, const allocator_type& alloc = allocator_type{})
                 : basic_string{init.begin(), init.size(), alloc}
             { /* DUMMY BODY */ }
 
             basic_string(const basic_string& other, const allocator_type& alloc)
-                : data_{}, size_{other.size_}, capacity_{other.capacity_}, allocator_{alloc}
+                : data_{sso_}, size_{}, capacity_{sso_capacity_}, allocator_{alloc}
             {
-                init_(other.data(), size_);
+                init_(other.data(), other.size_);
             }
 
             basic_string(basic_string&& other, const allocator_type& alloc)
-                : data_{other.data_}, size_{other.size_}, capacity_{other.capacity_}, allocator_{alloc}
+                : data_{sso_}, size_{}, capacity_{sso_capacity_}, allocator_{alloc}
             {
-                other.data_ = nullptr;
-                other.size_ = 0;
-                other.capacity_ = 0;
+                steal_(other);
             }
 
             ~basic_string()
             {
-                allocator_.deallocate(data_, capacity_);
+                deallocate_();
             }
 
             basic_string& operator=(const basic_string& other)
@@ -599,6 +233,11 @@ namespace std
                 return *this;
             }
 
+            basic_string& operator=(view_type_ str)
+            {
+                return assign(str.data(), str.size());
+            }
+
             basic_string& operator=(value_type c)
             {
                 *this = basic_string{1, c};
@@ -702,9 +341,9 @@ namespace std
                 // TODO: if new_size > max_size() throw length_error.
                 if (new_size > size_)
                 {
-                    ensure_free_space_(new_size - size_ + 1);
+                    ensure_free_space_(new_size - size_);
                     for (size_type i = size_; i < new_size; ++i)
-                        traits_type::assign(data_[i], i);
+                        traits_type::assign(data_[i], c);
                 }
 
                 size_ = new_size;
@@ -734,13 +373,14 @@ namespace std
 
             void shrink_to_fit()
             {
-                if (size_ != capacity_)
-                    resize_with_copy_(size_, capacity_);
+                if (size_ < capacity_)
+                    resize_with_copy_(size_, size_);
             }
 
             void clear() noexcept
             {
                 size_ = 0;
+                ensure_null_terminator_();
             }
 
             bool empty() const noexcept
@@ -808,6 +448,11 @@ namespace std
                 return append(str);
             }
 
+            basic_string& operator+=(view_type_ str)
+            {
+                return append(str.data(), str.size());
+            }
+
             basic_string& operator+=(value_type c)
             {
                 push_back(c);
@@ -836,6 +481,18 @@ namespace std
                 // TODO: Else throw out_of_range.
             }
 
+            basic_string& append(view_type_ str)
+            {
+                return append(str.data(), str.size());
+            }
+
+            template<class T, class = enable_if_view_<T>>
+            basic_string& append(const T& t, size_type pos, size_type n = npos)
+            {
+                // TODO: throw out_of_range if pos > str.size()
+                return append(view_type_{t}.substr(pos, n));
+            }
+
             basic_string& append(const value_type* str, size_type n)
             {
                 // TODO: if (size_ + n > max_size()) throw length_error
@@ -902,11 +559,23 @@ namespace std
                 return *this;
             }
 
+            basic_string& assign(view_type_ str)
+            {
+                return assign(str.data(), str.size());
+            }
+
+            template<class T, class = enable_if_view_<T>>
+            basic_string& assign(const T& t, size_type pos, size_type n = npos)
+            {
+                // TODO: throw out_of_range if pos > str.size()
+                return assign(view_type_{t}.substr(pos, n));
+            }
+
             basic_string& assign(const value_type* str, size_type n)
             {
                 // TODO: if (n > max_size()) throw length_error.
                 resize_without_copy_(n);
-                traits_type::copy(begin(), str, n);
+                traits_type::move(begin(), str, n);
                 size_ = n;
                 ensure_null_terminator_();
 
@@ -950,6 +619,19 @@ namespace std
                 return insert(pos1, str.data() + pos2, len);
             }
 
+            basic_string& insert(size_type pos, view_type_ str)
+            {
+                return insert(pos, str.data(), str.size());
+            }
+
+            template<class T, class = enable_if_view_<T>>
+            basic_string& insert(size_type pos1, const T& t,
+                                 size_type pos2, size_type n = npos)
+            {
+                // TODO: throw out_of_range if pos2 > str.size()
+                return insert(pos1, view_type_{t}.substr(pos2, n));
+            }
+
             basic_string& insert(size_type pos, const value_type* str, size_type n)
             {
                 // TODO: throw out_of_range if pos > size()
@@ -1073,6 +755,24 @@ namespace std
                 return replace(pos1, n1, str.data() + pos2, len);
             }
 
+            basic_string& replace(size_type pos, size_type n, view_type_ str)
+            {
+                return replace(pos, n, str.data(), str.size());
+            }
+
+            template<class T, class = enable_if_view_<T>>
+            basic_string& replace(size_type pos1, size_type n1, const T& t,
+                                  size_type pos2, size_type n2 = npos)
+            {
+                // TODO: throw out_of_range if pos2 > str.size()
+                return replace(pos1, n1, view_type_{t}.substr(pos2, n2));
+            }
+
+            basic_string& replace(const_iterator i1, const_iterator i2, view_type_ str)
+            {
+                return replace(i1 - begin(), i2 - i1, str.data(), str.size());
+            }
+
             basic_string& replace(size_type pos, size_type n1, const value_type* str,
                                   size_type n2)
             {
@@ -1093,6 +793,7 @@ namespace std
                 copy_(begin() + pos + len, end(), tmp.begin() + pos + n2);
 
                 tmp.size_ = size_ - len + n2;
+                tmp.ensure_null_terminator_();
                 swap(tmp);
                 return *this;
             }
@@ -1158,9 +859,21 @@ namespace std
                 noexcept(allocator_traits<allocator_type>::propagate_on_container_swap::value ||
                          allocator_traits<allocator_type>::is_always_equal::value)
             {
-                std::swap(data_, other.data_);
-                std::swap(size_, other.size_);
-                std::swap(capacity_, other.capacity_);
+                if (this == &other)
+                    return;
+
+                if (!is_sso_() && !other.is_sso_())
+                {
+                    std::swap(data_, other.data_);
+                    std::swap(size_, other.size_);
+                    std::swap(capacity_, other.capacity_);
+                }
+                else
+                { // Inline buffers cannot be exchanged by pointers.
+                    basic_string tmp{move(other)};
+                    other.steal_(*this);
+                    steal_(tmp);
+                }
             }
 
             /**
@@ -1182,6 +895,11 @@ namespace std
                 return allocator_type{allocator_};
             }
 
+            operator basic_string_view<value_type, traits_type>() const noexcept
+            {
+                return view_type_{data_, size_};
+            }
+
             /**
              * Note: The following find functions have 4 versions each:
              *       (1) takes basic_string
@@ -1205,6 +923,11 @@ namespace std
                 return find(str.c_str(), pos, str.size());
             }
 
+            size_type find(view_type_ str, size_type pos = 0) const noexcept
+            {
+                return find(str.data(), pos, str.size());
+            }
+
             size_type find(const value_type* str, size_type pos, size_type len) const noexcept
             {
                 if (empty() || len == 0 || len + pos > size())
@@ -1246,6 +969,11 @@ namespace std
                 return rfind(str.c_str(), pos, str.size());
             }
 
+            size_type rfind(view_type_ str, size_type pos = npos) const noexcept
+            {
+                return rfind(str.data(), pos, str.size());
+            }
+
             size_type rfind(const value_type* str, size_type pos, size_type len) const noexcept
             {
                 if (empty() || len == 0 || len + pos > size())
@@ -1287,6 +1015,11 @@ namespace std
                 return find_first_of(str.c_str(), pos, str.size());
             }
 
+            size_type find_first_of(view_type_ str, size_type pos = 0) const noexcept
+            {
+                return find_first_of(str.data(), pos, str.size());
+            }
+
             size_type find_first_of(const value_type* str, size_type pos, size_type len) const noexcept
             {
                 if (empty() || len == 0 || pos >= size())
@@ -1319,6 +1052,11 @@ namespace std
                 return find_last_of(str.c_str(), pos, str.size());
             }
 
+            size_type find_last_of(view_type_ str, size_type pos = npos) const noexcept
+            {
+                return find_last_of(str.data(), pos, str.size());
+            }
+
             size_type find_last_of(const value_type* str, size_type pos, size_type len) const noexcept
             {
                 if (empty() || len == 0)
@@ -1348,6 +1086,11 @@ namespace std
                 return find_first_not_of(str.c_str(), pos, str.size());
             }
 
+            size_type find_first_not_of(view_type_ str, size_type pos = 0) const noexcept
+            {
+                return find_first_not_of(str.data(), pos, str.size());
+            }
+
             size_type find_first_not_of(const value_type* str, size_type pos, size_type len) const noexcept
             {
                 if (empty() || pos >= size())
@@ -1389,6 +1132,11 @@ namespace std
                 return find_last_not_of(str.c_str(), pos, str.size());
             }
 
+            size_type find_last_not_of(view_type_ str, size_type pos = npos) const noexcept
+            {
+                return find_last_not_of(str.data(), pos, str.size());
+            }
+
             size_type find_last_not_of(const value_type* str, size_type pos, size_type len) const noexcept
             {
                 if (empty())
@@ -1446,59 +1194,137 @@ namespace std
                     return -1;
             }
 
+            /**
+             * Note: The remaining overloads compare views
+             *       so that they do not allocate temporary
+             *       strings for the substrings.
+             */
+
             int compare(size_type pos, size_type n, const basic_string& other) const
             {
-                return basic_string{*this, pos, n}.compare(other);
+                return view_type_{*this}.compare(pos, n, view_type_{other});
             }
 
             int compare(size_type pos1, size_type n1, const basic_string& other,
                         size_type pos2, size_type n2 = npos) const
             {
-                return basic_string{*this, pos1, n1}.compare(basic_string{other, pos2, n2});
+                return view_type_{*this}.compare(pos1, n1, view_type_{other}, pos2, n2);
+            }
+
+            int compare(view_type_ other) const noexcept
+            {
+                return view_type_{*this}.compare(other);
+            }
+
+            int compare(size_type pos, size_type n, view_type_ other) const
+            {
+                return view_type_{*this}.compare(pos, n, other);
+            }
+
+            template<class T, class = enable_if_view_<T>>
+            int compare(size_type pos1, size_type n1, const T& t,
+                        size_type pos2, size_type n2 = npos) const
+            {
+                return view_type_{*this}.compare(pos1, n1, view_type_{t}, pos2, n2);
             }
 
             int compare(const value_type* other) const
             {
-                return compare(basic_string(other));
+                return compare(view_type_{other});
             }
 
             int compare(size_type pos, size_type n, const value_type* other) const
             {
-                return basic_string{*this, pos, n}.compare(basic_string{other});
+                return view_type_{*this}.compare(pos, n, other);
             }
 
             int compare(size_type pos, size_type n1,
                         const value_type* other, size_type n2) const
             {
-                return basic_string{*this, pos, n1}.compare(basic_string{other, n2});
+                return view_type_{*this}.compare(pos, n1, other, n2);
             }
 
         private:
+            /**
+             * Short strings are stored in the inline
+             * buffer sso_ (in which case data_ points to it),
+             * longer ones in memory obtained from the allocator.
+             * The capacity never includes the null terminator,
+             * which always has a slot reserved after it.
+             */
+            static constexpr size_type sso_size_{
+                16 / sizeof(value_type) > 2 ? 16 / sizeof(value_type) : 2
+            };
+            static constexpr size_type sso_capacity_{sso_size_ - 1};
+
             value_type* data_;
             size_type size_;
             size_type capacity_;
             allocator_type allocator_;
+            value_type sso_[sso_size_];
 
             template<class C, class T, class A>
             friend class basic_stringbuf;
 
+            bool is_sso_() const noexcept
+            {
+                return data_ == sso_;
+            }
+
             /**
-             * Arbitrary value, standard just requires
-             * data() to have some capacity.
-             * (Well, we could've done data_ = &data_ and
-             * set capacity to 0, but that would be too cryptic.)
+             * Sets up storage for at least capacity characters,
+             * expects the current storage to be released.
              */
-            static constexpr size_type default_capacity_{4};
+            void allocate_(size_type capacity)
+            {
+                if (capacity <= sso_capacity_)
+                {
+                    data_ = sso_;
+                    capacity_ = sso_capacity_;
+                }
+                else
+                {
+                    data_ = allocator_.allocate(capacity + 1);
+                    capacity_ = capacity;
+                }
+            }
+
+            void deallocate_()
+            {
+                if (!is_sso_())
+                    allocator_.deallocate(data_, capacity_ + 1);
+
+                data_ = sso_;
+                capacity_ = sso_capacity_;
+            }
+
+            /**
+             * Takes over the contents of other, which is left
+             * empty, expects the current storage to be released.
+             */
+            void steal_(basic_string& other) noexcept
+            {
+                if (other.is_sso_())
+                    traits_type::copy(sso_, other.sso_, other.size_ + 1);
+                else
+                {
+                    data_ = other.data_;
+                    capacity_ = other.capacity_;
+                }
+                size_ = other.size_;
+
+                other.data_ = other.sso_;
+                other.size_ = 0;
+                other.capacity_ = sso_capacity_;
+                other.ensure_null_terminator_();
+            }
 
             void init_(const value_type* str, size_type size)
             {
-                if (data_)
-                    allocator_.deallocate(data_, capacity_);
+                deallocate_();
+                allocate_(size);
 
                 size_ = size;
-                capacity_ = size + 1;
-
-                data_ = allocator_.allocate(capacity_);
                 traits_type::copy(data_, str, size);
                 ensure_null_terminator_();
             }
@@ -1518,36 +1344,41 @@ namespace std
                  *       did in vector, because in string
                  *       reserve can cause shrinking.
                  */
-                if (size_ + 1 + n > capacity_)
-                    resize_with_copy_(size_, max(size_ + 1 + n, next_capacity_()));
+                if (size_ + n > capacity_)
+                    resize_with_copy_(size_, max(size_ + n, next_capacity_()));
             }
 
+            /**
+             * Note: Keeps the current buffer if it is large
+             *       enough, so that the caller can move data
+             *       from within the string itself into it.
+             */
             void resize_without_copy_(size_type capacity)
             {
-                if (data_)
-                    allocator_.deallocate(data_, capacity_);
+                if (capacity > capacity_)
+                {
+                    deallocate_();
+                    allocate_(capacity);
+                }
 
-                data_ = allocator_.allocate(capacity);
                 size_ = 0;
-                capacity_ = capacity;
-                ensure_null_terminator_();
             }
 
             void resize_with_copy_(size_type size, size_type capacity)
             {
-                if(capacity_ == 0 || capacity_ < capacity)
+                if (capacity != capacity_ && !(is_sso_() && capacity <= sso_capacity_))
                 {
-                    auto new_data = allocator_.allocate(capacity);
-
-                    auto to_copy = min(size, size_);
-                    traits_type::move(new_data, data_, to_copy);
+                    auto old_data = data_;
+                    auto old_capacity = capacity_;
+                    auto was_sso = is_sso_();
 
-                    std::swap(data_, new_data);
+                    allocate_(max(capacity, size));
+                    traits_type::move(data_, old_data, min(size, size_));
 
-                    allocator_.deallocate(new_data, capacity_);
+                    if (!was_sso)
+                        allocator_.deallocate(old_data, old_capacity + 1);
                 }
 
-                capacity_ = capacity;
                 size_ = size;
                 ensure_null_terminator_();
             }
@@ -1929,20 +1760,34 @@ namespace std
     {
         size_t operator()(const string& str) const noexcept
         {
-            size_t res{};
+            return aux::hash_bytes(str.data(), str.size() * sizeof(string::value_type));
+        }
 
-            /**
-             * Note: No need for fancy algorithms here,
-             *       std::hash is used for indexing, not
-             *       cryptography.
-             */
-            for (const auto& c: str)
-                res = res * 5 + (res >> 3) + static_cast<size_t>(c);
+        using argument_type = string;
+        using result_type   = size_t;
+    };
 
-            return res;
+    template<>
+    struct hash<u16string>
+    {
+        size_t operator()(const u16string& str) const noexcept
+        {
+            return aux::hash_bytes(str.data(), str.size() * sizeof(u16string::value_type));
         }
 
-        using argument_type = string;
+        using argument_type = u16string;
+        using result_type   = size_t;
+    };
+
+    template<>
+    struct hash<u32string>
+    {
+        size_t operator()(const u32string& str) const noexcept
+        {
+            return aux::hash_bytes(str.data(), str.size() * sizeof(u32string::value_type));
+        }
+
+        using argument_type = u32string;
         using result_type   = size_t;
     };
 
@@ -1951,17 +1796,13 @@ namespace std
     {
         size_t operator()(const wstring& str) const noexcept
         {
-            // TODO: implement
-            __unimplemented();
-            return size_t{};
+            return aux::hash_bytes(str.data(), str.size() * sizeof(wstring::value_type));
         }
 
         using argument_type = wstring;
         using result_type   = size_t;
     };
 
-    // TODO: add those other 2 string types
-
     /**
      * 21.7, suffix for basic_string literals:
      */
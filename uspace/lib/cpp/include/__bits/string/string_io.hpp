@@ -80,9 +80,9 @@ namespace std
         return is;
     }
 
-    template<class Char, class Traits, class Allocator>
+    template<class Char, class Traits>
     basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
-                                            const basic_string<Char, Traits, Allocator>& str)
+                                            basic_string_view<Char, Traits> str)
     {
         // TODO: determine padding as described in 27.7.3.6.1
         using sentry = typename basic_ostream<Char, Traits>::sentry;
@@ -94,7 +94,7 @@ namespace std
             auto size = str.size();
 
             size_t to_pad{};
-            if (width > 0)
+            if (width > 0 && static_cast<size_t>(width) > size)
                 to_pad = (static_cast<size_t>(width) - size);
 
             if (to_pad > 0)
@@ -122,6 +122,13 @@ namespace std
         return os;
     }
 
+    template<class Char, class Traits, class Allocator>
+    basic_ostream<Char, Traits>& operator<<(basic_ostream<Char, Traits>& os,
+                                            const basic_string<Char, Traits, Allocator>& str)
+    {
+        return os << basic_string_view<Char, Traits>{str};
+    }
+
     template<class Char, class Traits, class Allocator>
     basic_istream<Char, Traits>& getline(basic_istream<Char, Traits>& is,
                                          basic_string<Char, Traits, Allocator>& str,
@@ -0,0 +1,749 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_STRING_STRING_VIEW
+#define LIBCPP_BITS_STRING_STRING_VIEW
+
+#include <__bits/functional/hash.hpp>
+#include <__bits/string/char_traits.hpp>
+#include <__bits/iterator.hpp>
+#include <cassert>
+#include <cstddef>
+
+namespace std
+{
+    namespace aux
+    {
+        /**
+         * Keeps its argument out of template argument deduction,
+         * used for the "sufficient additional overloads" that
+         * allow comparing string views with anything convertible
+         * to them (24.4.3).
+         */
+        template<class T>
+        struct no_deduce
+        {
+            using type = T;
+        };
+
+        template<class T>
+        using no_deduce_t = typename no_deduce<T>::type;
+    }
+
+    /**
+     * 24.4.2, class template basic_string_view:
+     */
+
+    template<class Char, class Traits = char_traits<Char>>
+    class basic_string_view
+    {
+        public:
+            using traits_type            = Traits;
+            using value_type             = Char;
+            using pointer                = Char*;
+            using const_pointer          = const Char*;
+            using reference              = Char&;
+            using const_reference        = const Char&;
+            using const_iterator         = const Char*;
+            using iterator               = const_iterator;
+            using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+            using reverse_iterator       = const_reverse_iterator;
+            using size_type              = size_t;
+            using difference_type        = ptrdiff_t;
+
+            static constexpr size_type npos = size_type(-1);
+
+            /**
+             * 24.4.2.1, construction and assignment:
+             */
+
+            constexpr basic_string_view() noexcept
+                : data_{nullptr}, size_{}
+            { /* DUMMY BODY */ }
+
+            constexpr basic_string_view(const basic_string_view&) noexcept = default;
+
+            basic_string_view& operator=(const basic_string_view&) noexcept = default;
+
+            constexpr basic_string_view(const Char* str)
+                : data_{str}, size_{traits_type::length(str)}
+            { /* DUMMY BODY */ }
+
+            constexpr basic_string_view(const Char* str, size_type len)
+                : data_{str}, size_{len}
+            { /* DUMMY BODY */ }
+
+            /**
+             * 24.4.2.2, iterator support:
+             */
+
+            constexpr const_iterator begin() const noexcept
+            {
+                return data_;
+            }
+
+            constexpr const_iterator end() const noexcept
+            {
+                return data_ + size_;
+            }
+
+            constexpr const_iterator cbegin() const noexcept
+            {
+                return begin();
+            }
+
+            constexpr const_iterator cend() const noexcept
+            {
+                return end();
+            }
+
+            const_reverse_iterator rbegin() const noexcept
+            {
+                return make_reverse_iterator(end());
+            }
+
+            const_reverse_iterator rend() const noexcept
+            {
+                return make_reverse_iterator(begin());
+            }
+
+            const_reverse_iterator crbegin() const noexcept
+            {
+                return rbegin();
+            }
+
+            const_reverse_iterator crend() const noexcept
+            {
+                return rend();
+            }
+
+            /**
+             * 24.4.2.3, capacity:
+             */
+
+            constexpr size_type size() const noexcept
+            {
+                return size_;
+            }
+
+            constexpr size_type length() const noexcept
+            {
+                return size_;
+            }
+
+            constexpr size_type max_size() const noexcept
+            {
+                return npos / sizeof(Char);
+            }
+
+            constexpr bool empty() const noexcept
+            {
+                return size_ == 0;
+            }
+
+            /**
+             * 24.4.2.4, element access:
+             */
+
+            constexpr const_reference operator[](size_type idx) const
+            {
+                return data_[idx];
+            }
+
+            constexpr const_reference at(size_type idx) const
+            {
+                // TODO: bounds checking
+                return data_[idx];
+            }
+
+            constexpr const_reference front() const
+            {
+                return data_[0];
+            }
+
+            constexpr const_reference back() const
+            {
+                return data_[size_ - 1];
+            }
+
+            constexpr const_pointer data() const noexcept
+            {
+                return data_;
+            }
+
+            /**
+             * 24.4.2.5, modifiers:
+             */
+
+            constexpr void remove_prefix(size_type n)
+            {
+                data_ += n;
+                size_ -= n;
+            }
+
+            constexpr void remove_suffix(size_type n)
+            {
+                size_ -= n;
+            }
+
+            constexpr void swap(basic_string_view& other) noexcept
+            {
+                auto data = data_;
+                data_ = other.data_;
+                other.data_ = data;
+
+                auto size = size_;
+                size_ = other.size_;
+                other.size_ = size;
+            }
+
+            /**
+             * 24.4.2.6, string operations:
+             */
+
+            size_type copy(Char* str, size_type n, size_type pos = 0) const
+            {
+                // TODO: throw out_of_range if pos > size()
+                auto len = min_(n, size_ - pos);
+                traits_type::copy(str, data_ + pos, len);
+
+                return len;
+            }
+
+            constexpr basic_string_view substr(size_type pos = 0, size_type n = npos) const
+            {
+                // TODO: throw out_of_range if pos > size()
+                return basic_string_view{data_ + pos, min_(n, size_ - pos)};
+            }
+
+            constexpr int compare(basic_string_view other) const noexcept
+            {
+                auto comp = traits_type::compare(data_, other.data_, min_(size_, other.size_));
+
+                if (comp != 0)
+                    return comp;
+                else if (size_ == other.size_)
+                    return 0;
+                else if (size_ > other.size_)
+                    return 1;
+                else
+                    return -1;
+            }
+
+            constexpr int compare(size_type pos, size_type n, basic_string_view other) const
+            {
+                return substr(pos, n).compare(other);
+            }
+
+            constexpr int compare(size_type pos1, size_type n1, basic_string_view other,
+                                  size_type pos2, size_type n2) const
+            {
+                return substr(pos1, n1).compare(other.substr(pos2, n2));
+            }
+
+            constexpr int compare(const Char* other) const
+            {
+                return compare(basic_string_view{other});
+            }
+
+            constexpr int compare(size_type pos, size_type n, const Char* other) const
+            {
+                return substr(pos, n).compare(basic_string_view{other});
+            }
+
+            constexpr int compare(size_type pos, size_type n1,
+                                  const Char* other, size_type n2) const
+            {
+                return substr(pos, n1).compare(basic_string_view{other, n2});
+            }
+
+            /**
+             * Note: The prefix and suffix checks come from
+             *       C++20, but they are too useful for parsing
+             *       to leave them out.
+             */
+
+            constexpr bool starts_with(basic_string_view prefix) const noexcept
+            {
+                return size_ >= prefix.size_ &&
+                       traits_type::compare(data_, prefix.data_, prefix.size_) == 0;
+            }
+
+            constexpr bool starts_with(Char c) const noexcept
+            {
+                return !empty() && traits_type::eq(front(), c);
+            }
+
+            constexpr bool starts_with(const Char* prefix) const
+            {
+                return starts_with(basic_string_view{prefix});
+            }
+
+            constexpr bool ends_with(basic_string_view suffix) const noexcept
+            {
+                return size_ >= suffix.size_ &&
+                       traits_type::compare(
+                           data_ + size_ - suffix.size_, suffix.data_, suffix.size_
+                       ) == 0;
+            }
+
+            constexpr bool ends_with(Char c) const noexcept
+            {
+                return !empty() && traits_type::eq(back(), c);
+            }
+
+            constexpr bool ends_with(const Char* suffix) const
+            {
+                return ends_with(basic_string_view{suffix});
+            }
+
+            /**
+             * 24.4.2.7, searching:
+             */
+
+            constexpr size_type find(basic_string_view str, size_type pos = 0) const noexcept
+            {
+                return find(str.data_, pos, str.size_);
+            }
+
+            constexpr size_type find(Char c, size_type pos = 0) const noexcept
+            {
+                if (pos >= size_)
+                    return npos;
+
+                auto res = traits_type::find(data_ + pos, size_ - pos, c);
+
+                return res ? static_cast<size_type>(res - data_) : npos;
+            }
+
+            constexpr size_type find(const Char* str, size_type pos, size_type n) const
+            {
+                if (n == 0)
+                    return pos <= size_ ? pos : npos;
+                if (pos >= size_ || n > size_ - pos)
+                    return npos;
+
+                /**
+                 * Look for the first character of str using
+                 * traits_type::find, which is usually much faster than
+                 * comparing at every position, and only compare
+                 * the rest where it matches.
+                 */
+                auto first = data_ + pos;
+                auto last = data_ + size_ - n + 1;
+                while (first < last)
+                {
+                    first = traits_type::find(first, static_cast<size_type>(last - first), str[0]);
+                    if (!first)
+                        return npos;
+
+                    if (traits_type::compare(first + 1, str + 1, n - 1) == 0)
+                        return static_cast<size_type>(first - data_);
+                    ++first;
+                }
+
+                return npos;
+            }
+
+            constexpr size_type find(const Char* str, size_type pos = 0) const
+            {
+                return find(str, pos, traits_type::length(str));
+            }
+
+            constexpr size_type rfind(basic_string_view str, size_type pos = npos) const noexcept
+            {
+                return rfind(str.data_, pos, str.size_);
+            }
+
+            constexpr size_type rfind(Char c, size_type pos = npos) const noexcept
+            {
+                return rfind(&c, pos, 1);
+            }
+
+            constexpr size_type rfind(const Char* str, size_type pos, size_type n) const
+            {
+                if (n > size_)
+                    return npos;
+
+                for (auto idx = min_(pos, size_ - n) + 1; idx > 0; --idx)
+                {
+                    if (traits_type::compare(data_ + idx - 1, str, n) == 0)
+                        return idx - 1;
+                }
+
+                return npos;
+            }
+
+            constexpr size_type rfind(const Char* str, size_type pos = npos) const
+            {
+                return rfind(str, pos, traits_type::length(str));
+            }
+
+            constexpr size_type find_first_of(basic_string_view str, size_type pos = 0) const noexcept
+            {
+                return find_first_of(str.data_, pos, str.size_);
+            }
+
+            constexpr size_type find_first_of(Char c, size_type pos = 0) const noexcept
+            {
+                return find(c, pos);
+            }
+
+            constexpr size_type find_first_of(const Char* str, size_type pos, size_type n) const
+            {
+                for (auto idx = pos; idx < size_; ++idx)
+                {
+                    if (traits_type::find(str, n, data_[idx]))
+                        return idx;
+                }
+
+                return npos;
+            }
+
+            constexpr size_type find_first_of(const Char* str, size_type pos = 0) const
+            {
+                return find_first_of(str, pos, traits_type::length(str));
+            }
+
+            constexpr size_type find_last_of(basic_string_view str, size_type pos = npos) const noexcept
+            {
+                return find_last_of(str.data_, pos, str.size_);
+            }
+
+            constexpr size_type find_last_of(Char c, size_type pos = npos) const noexcept
+            {
+                return rfind(c, pos);
+            }
+
+            constexpr size_type find_last_of(const Char* str, size_type pos, size_type n) const
+            {
+                if (empty())
+                    return npos;
+
+                for (auto idx = min_(pos, size_ - 1) + 1; idx > 0; --idx)
+                {
+                    if (traits_type::find(str, n, data_[idx - 1]))
+                        return idx - 1;
+                }
+
+                return npos;
+            }
+
+            constexpr size_type find_last_of(const Char* str, size_type pos = npos) const
+            {
+                return find_last_of(str, pos, traits_type::length(str));
+            }
+
+            constexpr size_type find_first_not_of(basic_string_view str, size_type pos = 0) const noexcept
+            {
+                return find_first_not_of(str.data_, pos, str.size_);
+            }
+
+            constexpr size_type find_first_not_of(Char c, size_type pos = 0) const noexcept
+            {
+                return find_first_not_of(&c, pos, 1);
+            }
+
+            constexpr size_type find_first_not_of(const Char* str, size_type pos, size_type n) const
+            {
+                for (auto idx = pos; idx < size_; ++idx)
+                {
+                    if (!traits_type::find(str, n, data_[idx]))
+                        return idx;
+                }
+
+                return npos;
+            }
+
+            constexpr size_type find_first_not_of(const Char* str, size_type pos = 0) const
+            {
+                return find_first_not_of(str, pos, traits_type::length(str));
+            }
+
+            constexpr size_type find_last_not_of(basic_string_view str, size_type pos = npos) const noexcept
+            {
+                return find_last_not_of(str.data_, pos, str.size_);
+            }
+
+            constexpr size_type find_last_not_of(Char c, size_type pos = npos) const noexcept
+            {
+                return find_last_not_of(&c, pos, 1);
+            }
+
+            constexpr size_type find_last_not_of(const Char* str, size_type pos, size_type n) const
+            {
+                if (empty())
+                    return npos;
+
+                for (auto idx = min_(pos, size_ - 1) + 1; idx > 0; --idx)
+                {
+                    if (!traits_type::find(str, n, data_[idx - 1]))
+                        return idx - 1;
+                }
+
+                return npos;
+            }
+
+            constexpr size_type find_last_not_of(const Char* str, size_type pos = npos) const
+            {
+                return find_last_not_of(str, pos, traits_type::length(str));
+            }
+
+        private:
+            const_pointer data_;
+            size_type size_;
+
+            /**
+             * Note: <algorithm> includes <string>, so we
+             *       cannot use std::min here.
+             */
+            static constexpr size_type min_(size_type lhs, size_type rhs) noexcept
+            {
+                return lhs < rhs ? lhs : rhs;
+            }
+    };
+
+    using string_view    = basic_string_view<char>;
+    using u16string_view = basic_string_view<char16_t>;
+    using u32string_view = basic_string_view<char32_t>;
+    using wstring_view   = basic_string_view<wchar_t>;
+
+    /**
+     * 24.4.3, non-member comparison functions:
+     * Note: The overloads with one argument kept out of deduction
+     *       allow comparisons with anything convertible to a view
+     *       (e.g. basic_string or string literals).
+     */
+
+    template<class Char, class Traits>
+    constexpr bool operator==(basic_string_view<Char, Traits> lhs,
+                              basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator==(basic_string_view<Char, Traits> lhs,
+                              aux::no_deduce_t<basic_string_view<Char, Traits>> rhs) noexcept
+    {
+        return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator==(aux::no_deduce_t<basic_string_view<Char, Traits>> lhs,
+                              basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator!=(basic_string_view<Char, Traits> lhs,
+                              basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator!=(basic_string_view<Char, Traits> lhs,
+                              aux::no_deduce_t<basic_string_view<Char, Traits>> rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator!=(aux::no_deduce_t<basic_string_view<Char, Traits>> lhs,
+                              basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator<(basic_string_view<Char, Traits> lhs,
+                             basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator<(basic_string_view<Char, Traits> lhs,
+                             aux::no_deduce_t<basic_string_view<Char, Traits>> rhs) noexcept
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator<(aux::no_deduce_t<basic_string_view<Char, Traits>> lhs,
+                             basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator>(basic_string_view<Char, Traits> lhs,
+                             basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator>(basic_string_view<Char, Traits> lhs,
+                             aux::no_deduce_t<basic_string_view<Char, Traits>> rhs) noexcept
+    {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator>(aux::no_deduce_t<basic_string_view<Char, Traits>> lhs,
+                             basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return lhs.compare(rhs) > 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator<=(basic_string_view<Char, Traits> lhs,
+                              basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator<=(basic_string_view<Char, Traits> lhs,
+                              aux::no_deduce_t<basic_string_view<Char, Traits>> rhs) noexcept
+    {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator<=(aux::no_deduce_t<basic_string_view<Char, Traits>> lhs,
+                              basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator>=(basic_string_view<Char, Traits> lhs,
+                              basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator>=(basic_string_view<Char, Traits> lhs,
+                              aux::no_deduce_t<basic_string_view<Char, Traits>> rhs) noexcept
+    {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    template<class Char, class Traits>
+    constexpr bool operator>=(aux::no_deduce_t<basic_string_view<Char, Traits>> lhs,
+                              basic_string_view<Char, Traits> rhs) noexcept
+    {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    /**
+     * 24.4.5, hash support:
+     * Note: Views hash the same as strings with equal contents.
+     */
+
+    template<>
+    struct hash<string_view>
+    {
+        size_t operator()(string_view str) const noexcept
+        {
+            return aux::hash_bytes(str.data(), str.size() * sizeof(string_view::value_type));
+        }
+
+        using argument_type = string_view;
+        using result_type   = size_t;
+    };
+
+    template<>
+    struct hash<u16string_view>
+    {
+        size_t operator()(u16string_view str) const noexcept
+        {
+            return aux::hash_bytes(str.data(), str.size() * sizeof(u16string_view::value_type));
+        }
+
+        using argument_type = u16string_view;
+        using result_type   = size_t;
+    };
+
+    template<>
+    struct hash<u32string_view>
+    {
+        size_t operator()(u32string_view str) const noexcept
+        {
+            return aux::hash_bytes(str.data(), str.size() * sizeof(u32string_view::value_type));
+        }
+
+        using argument_type = u32string_view;
+        using result_type   = size_t;
+    };
+
+    template<>
+    struct hash<wstring_view>
+    {
+        size_t operator()(wstring_view str) const noexcept
+        {
+            return aux::hash_bytes(str.data(), str.size() * sizeof(wstring_view::value_type));
+        }
+
+        using argument_type = wstring_view;
+        using result_type   = size_t;
+    };
+
+    /**
+     * 24.4.6, suffix for basic_string_view literals:
+     */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wliteral-suffix"
+inline namespace literals {
+inline namespace string_view_literals
+{
+    constexpr string_view operator "" sv(const char* str, size_t len) noexcept
+    {
+        return string_view{str, len};
+    }
+
+    constexpr u16string_view operator "" sv(const char16_t* str, size_t len) noexcept
+    {
+        return u16string_view{str, len};
+    }
+
+    constexpr u32string_view operator "" sv(const char32_t* str, size_t len) noexcept
+    {
+        return u32string_view{str, len};
+    }
+}}
+#pragma GCC diagnostic pop
+}
+
+#endif
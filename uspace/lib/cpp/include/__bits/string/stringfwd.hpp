@@ -49,4 +49,18 @@ namespace std
 
 }
 
+namespace std::pmr
+{
+    template<class T>
+    class polymorphic_allocator;
+
+    template<class Char, class Traits = char_traits<Char>>
+    using basic_string = std::basic_string<
+        Char, Traits, polymorphic_allocator<Char>
+    >;
+
+    using string  = basic_string<char>;
+    using wstring = basic_string<wchar_t>;
+}
+
 #endif
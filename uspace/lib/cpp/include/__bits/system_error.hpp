@@ -32,15 +32,20 @@
 #include <__bits/aux.hpp>
 #include <__bits/string/stringfwd.hpp>
 #include <stdexcept>
+#include <type_traits>
 
 namespace std
 {
     class error_condition;
     class error_code;
 
+    /**
+     * Note: Value initialized errc (i.e. zero) denotes success
+     *       (e.g. in the results of to_chars and from_chars).
+     */
     enum class errc
     { // TODO: add matching values
-        address_family_not_supported,
+        address_family_not_supported = 1,
         address_in_use,
         address_not_available,
         already_connected,
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_TEST_BENCH
+#define LIBCPP_BITS_TEST_BENCH
+
+#include <__bits/test/test.hpp>
+#include <cstdint>
+#include <utility>
+
+namespace std::test
+{
+    /**
+     * Base for suites that measure performance rather than
+     * correctness. The tests they perform are only sanity
+     * checks of the results of the measured operations.
+     */
+    class benchmark_suite: public test_suite
+    {
+        protected:
+            template<class Func>
+            uint64_t measure(const char* bname, Func&& func)
+            {
+                auto start = now_usecs();
+                forward<Func>(func)();
+                auto elapsed = now_usecs() - start;
+
+                report_time(bname, elapsed);
+
+                return elapsed;
+            }
+
+            /**
+             * Deterministic xorshift generator, so that every
+             * run of a benchmark works with the same input.
+             */
+            uint32_t random() noexcept
+            {
+                seed_ ^= seed_ << 13;
+                seed_ ^= seed_ >> 17;
+                seed_ ^= seed_ << 5;
+
+                return seed_;
+            }
+
+            void reseed(uint32_t seed = default_seed) noexcept
+            {
+                seed_ = seed;
+            }
+
+            /**
+             * Reports a measured quantity other than time
+             * (e.g. memory usage) in the given unit.
+             */
+            void report_value(const char* bname, uint64_t value, const char* unit);
+
+        private:
+            static constexpr uint32_t default_seed{2463534242U};
+
+            uint32_t seed_{default_seed};
+
+            static uint64_t now_usecs();
+
+            void report_time(const char* bname, uint64_t usecs)
+            {
+                report_value(bname, usecs, "us");
+            }
+    };
+}
+
+#endif
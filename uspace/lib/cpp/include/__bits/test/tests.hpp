@@ -29,8 +29,12 @@
 #ifndef LIBCPP_BITS_TEST_TESTS
 #define LIBCPP_BITS_TEST_TESTS
 
+#include <__bits/test/bench.hpp>
 #include <__bits/test/test.hpp>
+#include <charconv>
+#include <chrono>
 #include <cstdio>
+#include <string>
 #include <vector>
 
 namespace std::test
@@ -105,6 +109,8 @@ namespace std::test
             void test_construction_and_assignment();
             void test_insert();
             void test_erase();
+            void test_nontrivial();
+            void test_growth();
     };
 
     class string_test: public test_suite
@@ -123,6 +129,35 @@ namespace std::test
             void test_find();
             void test_substr();
             void test_compare();
+            void test_small_strings();
+    };
+
+    class string_view_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+
+        private:
+            void test_construction();
+            void test_modifiers();
+            void test_find();
+            void test_compare();
+            void test_hash();
+            void test_string_interop();
+            void test_output();
+    };
+
+    class span_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+
+        private:
+            void test_construction();
+            void test_subviews();
+            void test_access();
     };
 
     class bitset_test: public test_suite
@@ -219,6 +254,19 @@ namespace std::test
             void test_multi();
     };
 
+    class flat_hash_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+
+        private:
+            void test_map();
+            void test_set();
+            void test_growth();
+            void test_collisions();
+    };
+
     class numeric_test: public test_suite
     {
         public:
@@ -253,9 +301,81 @@ namespace std::test
             void test_shared_ptr();
             void test_weak_ptr();
             void test_allocators();
+            void test_node_allocators();
+            void test_pool_allocator();
             void test_pointers();
     };
 
+    class memory_resource_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+
+        private:
+            void test_global_resources();
+            void test_monotonic_buffer_resource();
+            void test_pool_resources();
+            void test_polymorphic_allocator();
+            void test_containers();
+    };
+
+    class random_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+
+        private:
+            void test_engines();
+            void test_uniform();
+            void test_bernoulli_family();
+            void test_poisson_family();
+            void test_normal_family();
+            void test_sampling_distributions();
+            void test_streams();
+
+            template<class Dist>
+            void test_stream_(const char*, const Dist&);
+
+            template<class Dist, class URNG>
+            void test_moments_(const char*, Dist&, URNG&, double, double);
+    };
+
+    class regex_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+
+        private:
+            void test_literals_and_classes();
+            void test_quantifiers();
+            void test_alternation_and_groups();
+            void test_assertions();
+            void test_flags();
+            void test_backreferences();
+            void test_match_results();
+            void test_iterator_and_replace();
+            void test_errors();
+    };
+
+    class valarray_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+
+        private:
+            void test_construction();
+            void test_arithmetic();
+            void test_compound_assignment();
+            void test_comparison();
+            void test_slices();
+            void test_masks_and_indices();
+            void test_member_functions();
+    };
+
     class list_test: public test_suite
     {
         public:
@@ -283,6 +403,7 @@ namespace std::test
             void test_reference_wrapper();
             void test_function();
             void test_bind();
+            void test_hash();
     };
 
     class algorithm_test: public test_suite
@@ -293,6 +414,208 @@ namespace std::test
         private:
             void test_non_modifying();
             void test_mutating();
+            void test_sorting();
+    };
+
+    class atomic_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            void test_integral();
+            void test_pointer();
+            void test_generic();
+            void test_flag();
+            void test_concurrent();
+    };
+
+    class future_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            void test_promise();
+            void test_shared_future();
+            void test_packaged_task();
+            void test_async();
+    };
+
+    class mutex_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr std::chrono::milliseconds timeout{10};
+            static constexpr std::chrono::milliseconds long_timeout{10'000};
+
+            void test_timed_mutex();
+            void test_recursive_timed_mutex();
+            void test_shared_timed_mutex();
+    };
+
+    class sort_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t element_count{100'000};
+
+            void benchmark_input(const char*, const std::vector<unsigned int>&);
+            void benchmark_stability();
+    };
+
+    class flat_hash_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t element_count{100'000};
+
+            template<class Map>
+            void benchmark_map(const char*, const std::vector<unsigned int>&,
+                               const std::vector<unsigned int>&);
+    };
+
+    class async_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t task_count{10'000};
+            static constexpr size_t thread_count{500};
+            static constexpr size_t spin_rounds{1 << 26};
+
+            void report_latency(const char*, uint64_t, size_t);
+    };
+
+    class io_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t data_size{1024 * 1024};
+            static constexpr size_t line_size{64};
+            static constexpr size_t block_size{4096};
+            static constexpr const char* file_name{"/tmp/cpptest_io_bench"};
+
+            void report_throughput(const char*, uint64_t);
+            size_t checksum();
+    };
+
+    class charconv_test: public test_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            void test_to_chars_integral();
+            void test_from_chars_integral();
+            void test_to_chars_floating();
+            void test_from_chars_floating();
+            void test_streams();
+
+            std::string to_str(double);
+            std::string to_str(float);
+            std::string to_str(double, chars_format);
+            std::string to_str(double, chars_format, int);
+    };
+
+    class numconv_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t element_count{100'000};
+
+            size_t total_length(const std::vector<std::string>&);
+    };
+
+    class node_alloc_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t element_count{100'000};
+
+            template<class Map>
+            void benchmark_map(const char*, const std::vector<unsigned int>&);
+
+            template<class List>
+            void benchmark_list(const char*);
+    };
+
+    class pmr_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t request_count{100};
+            static constexpr size_t keys_per_request{1000};
+            static constexpr size_t arena_size{128 * 1024};
+
+            template<class Map, class List>
+            size_t handle_request(const std::vector<unsigned int>&, Map&, List&);
+    };
+
+    class random_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t value_count{16 * 1024 * 1024};
+            static constexpr size_t block_size{4096};
+            static constexpr size_t sample_count{1024 * 1024};
+    };
+
+    class regex_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t line_count{64 * 1024};
+            static constexpr size_t pathological_size{1024 * 1024};
+            static constexpr size_t backref_lines{8 * 1024};
+
+            std::string generate_log_();
+    };
+
+    class valarray_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t sample_count{1024 * 1024};
+            static constexpr size_t round_count{16};
+    };
+
+    class container_benchmark: public benchmark_suite
+    {
+        public:
+            bool run(bool) override;
+            const char* name() override;
+        private:
+            static constexpr size_t element_count{256 * 1024};
+            static constexpr size_t round_count{16};
+            static constexpr size_t shift_count{16 * 1024};
+
+            template<class T>
+            void benchmark_growth(const char*);
+
+            void benchmark_insert_erase();
+            void benchmark_deque();
     };
 }
 
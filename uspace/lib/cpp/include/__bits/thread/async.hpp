@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_THREAD_ASYNC
+#define LIBCPP_BITS_THREAD_ASYNC
+
+#include <__bits/thread/future.hpp>
+#include <__bits/thread/shared_state.hpp>
+#include <__bits/thread/thread_pool.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace std
+{
+    /**
+     * 30.6.8, function template async:
+     */
+
+    template<class F, class... Args>
+    future<result_of_t<decay_t<F>(decay_t<Args>...)>>
+    async(launch policy, F&& f, Args&&... args)
+    {
+        using result_t = result_of_t<decay_t<F>(decay_t<Args>...)>;
+        using state_t = aux::async_state<result_t, decay_t<F>, decay_t<Args>...>;
+
+        /**
+         * Note: When both policies are allowed we always
+         *       choose launch::async, the pool is bounded
+         *       so this cannot exhaust the system.
+         */
+        bool deferred = (policy & launch::async) != launch::async;
+        auto state = new state_t{deferred, forward<F>(f), forward<Args>(args)...};
+
+        if (!deferred)
+        {
+            // The pool's reference, dropped in state_t::release().
+            state->increment();
+            aux::thread_pool::default_pool().submit(state);
+        }
+
+        return future<result_t>{state};
+    }
+
+    template<
+        class F, class... Args,
+        class = enable_if_t<!is_same_v<decay_t<F>, launch>>
+    >
+    future<result_of_t<decay_t<F>(decay_t<Args>...)>>
+    async(F&& f, Args&&... args)
+    {
+        return async(
+            launch::async | launch::deferred,
+            forward<F>(f), forward<Args>(args)...
+        );
+    }
+}
+
+#endif
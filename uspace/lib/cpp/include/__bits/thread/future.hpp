@@ -29,157 +29,320 @@
 #ifndef LIBCPP_BITS_THREAD_FUTURE
 #define LIBCPP_BITS_THREAD_FUTURE
 
+#include <__bits/thread/future_common.hpp>
+#include <__bits/thread/shared_state.hpp>
+#include <__bits/thread/threading.hpp>
 #include <cassert>
+#include <chrono>
 #include <memory>
-#include <system_error>
 #include <type_traits>
 
 namespace std
 {
+    template<class R>
+    class shared_future;
+
+    namespace aux
+    {
+        /**
+         * Functionality common to all futures, the derived
+         * classes only differ in what get() returns and
+         * whether they can be copied.
+         */
+        template<class R>
+        class future_base
+        {
+            public:
+                future_base() noexcept
+                    : state_{nullptr}
+                { /* DUMMY BODY */ }
+
+                /**
+                 * Note: Adopts the reference the caller
+                 *       holds to the state.
+                 */
+                explicit future_base(shared_state<R>* state) noexcept
+                    : state_{state}
+                { /* DUMMY BODY */ }
+
+                future_base(const future_base& other) noexcept
+                    : state_{other.state_}
+                {
+                    if (state_)
+                        state_->increment();
+                }
+
+                future_base(future_base&& other) noexcept
+                    : state_{other.state_}
+                {
+                    other.state_ = nullptr;
+                }
+
+                future_base& operator=(const future_base& rhs) noexcept
+                {
+                    if (rhs.state_)
+                        rhs.state_->increment();
+                    release_();
+                    state_ = rhs.state_;
+
+                    return *this;
+                }
+
+                future_base& operator=(future_base&& rhs) noexcept
+                {
+                    if (this != &rhs)
+                    {
+                        release_();
+                        state_ = rhs.state_;
+                        rhs.state_ = nullptr;
+                    }
+
+                    return *this;
+                }
+
+                ~future_base()
+                {
+                    release_();
+                }
+
+                bool valid() const noexcept
+                {
+                    return state_ != nullptr;
+                }
+
+                void wait() const
+                {
+                    assert(state_);
+
+                    state_->wait();
+                }
+
+                template<class Rep, class Period>
+                future_status wait_for(const chrono::duration<Rep, Period>& rel_time) const
+                {
+                    assert(state_);
+
+                    return state_->wait_for(threading::time::convert(rel_time));
+                }
+
+                template<class Clock, class Duration>
+                future_status wait_until(
+                    const chrono::time_point<Clock, Duration>& abs_time
+                ) const
+                {
+                    return wait_for(abs_time - Clock::now());
+                }
+
+            protected:
+                shared_state<R>* state_;
+
+                void release_()
+                {
+                    if (state_)
+                    {
+                        state_->release_future();
+                        state_->decrement();
+                        state_ = nullptr;
+                    }
+                }
+
+                /**
+                 * Hands the reference over to the caller
+                 * without waiting for the state.
+                 */
+                shared_state<R>* steal_() noexcept
+                {
+                    auto state = state_;
+                    state_ = nullptr;
+
+                    return state;
+                }
+        };
+    }
+
     /**
-     * 30.6, futures:
+     * 30.6.6, class template future:
      */
 
-    enum class future_errc
-    { // The 5001 start is to not collide with system_error's codes.
-        broken_promise = 5001,
-        future_already_retrieved,
-        promise_already_satisfied,
-        no_state
-    };
-
-    enum class launch
+    template<class R>
+    class future: public aux::future_base<R>
     {
-        async,
-        deferred
+        public:
+            future() noexcept = default;
+
+            explicit future(aux::shared_state<R>* state) noexcept
+                : aux::future_base<R>{state}
+            { /* DUMMY BODY */ }
+
+            future(const future&) = delete;
+            future(future&&) noexcept = default;
+
+            future& operator=(const future&) = delete;
+            future& operator=(future&&) noexcept = default;
+
+            shared_future<R> share()
+            {
+                return shared_future<R>{move(*this)};
+            }
+
+            R get()
+            {
+                assert(this->state_);
+
+                R res(move(this->state_->get()));
+                this->release_();
+
+                return res;
+            }
+
+            template<class>
+            friend class shared_future;
     };
 
-    enum class future_status
+    template<class R>
+    class future<R&>: public aux::future_base<R&>
     {
-        ready,
-        timeout,
-        deferred
-    };
+        public:
+            future() noexcept = default;
 
-    /**
-     * 30.6.2, error handling:
-     */
+            explicit future(aux::shared_state<R&>* state) noexcept
+                : aux::future_base<R&>{state}
+            { /* DUMMY BODY */ }
 
-    template<>
-    struct is_error_code_enum<future_errc>: true_type
-    { /* DUMMY BODY */ };
+            future(const future&) = delete;
+            future(future&&) noexcept = default;
 
-    error_code make_error_code(future_errc) noexcept;
-    error_condition make_error_condition(future_errc) noexcept;
+            future& operator=(const future&) = delete;
+            future& operator=(future&&) noexcept = default;
 
-    const error_category& future_category() noexcept;
+            shared_future<R&> share()
+            {
+                return shared_future<R&>{move(*this)};
+            }
 
-    /**
-     * 30.6.3, class future_error:
-     */
+            R& get()
+            {
+                assert(this->state_);
+
+                auto& res = this->state_->get();
+                this->release_();
+
+                return res;
+            }
 
-    class future_error: public logic_error
+            template<class>
+            friend class shared_future;
+    };
+
+    template<>
+    class future<void>: public aux::future_base<void>
     {
         public:
-            future_error(error_code ec);
+            future() noexcept = default;
+
+            explicit future(aux::shared_state<void>* state) noexcept
+                : aux::future_base<void>{state}
+            { /* DUMMY BODY */ }
+
+            future(const future&) = delete;
+            future(future&&) noexcept = default;
+
+            future& operator=(const future&) = delete;
+            future& operator=(future&&) noexcept = default;
+
+            shared_future<void> share();
+
+            void get()
+            {
+                assert(this->state_);
 
-            const error_code& code() const noexcept;
+                this->state_->get();
+                this->release_();
+            }
 
-        private:
-            error_code code_;
+            template<class>
+            friend class shared_future;
     };
 
     /**
-     * 30.6.4, shared state:
+     * 30.6.7, class template shared_future:
      */
 
     template<class R>
-    class promise
+    class shared_future: public aux::future_base<R>
     {
-    };
+        public:
+            shared_future() noexcept = default;
 
-    template<class R>
-    class promise<R&>
-    {
-    };
+            shared_future(const shared_future&) = default;
+            shared_future(shared_future&&) noexcept = default;
 
-    template<>
-    class promise<void>
-    {
-    };
+            shared_future(future<R>&& other) noexcept
+                : aux::future_base<R>{other.steal_()}
+            { /* DUMMY BODY */ }
 
-    template<class R>
-    void swap(promise<R>& lhs, promise<R>& rhs) noexcept
-    {
-        lhs.swap(rhs);
-    }
+            shared_future& operator=(const shared_future&) = default;
+            shared_future& operator=(shared_future&&) noexcept = default;
 
-    template<class R, class Alloc>
-    struct uses_allocator<promise<R>, Alloc>: true_type
-    { /* DUMMY BODY */ };
+            const R& get() const
+            {
+                assert(this->state_);
 
-    template<class R>
-    class future
-    {
+                return this->state_->get();
+            }
     };
 
     template<class R>
-    class future<R&>
+    class shared_future<R&>: public aux::future_base<R&>
     {
-    };
+        public:
+            shared_future() noexcept = default;
 
-    template<>
-    class future<void>
-    {
-    };
+            shared_future(const shared_future&) = default;
+            shared_future(shared_future&&) noexcept = default;
 
-    template<class R>
-    class shared_future
-    {
-    };
+            shared_future(future<R&>&& other) noexcept
+                : aux::future_base<R&>{other.steal_()}
+            { /* DUMMY BODY */ }
 
-    template<class R>
-    class shared_future<R&>
-    {
+            shared_future& operator=(const shared_future&) = default;
+            shared_future& operator=(shared_future&&) noexcept = default;
+
+            R& get() const
+            {
+                assert(this->state_);
+
+                return this->state_->get();
+            }
     };
 
     template<>
-    class shared_future<void>
+    class shared_future<void>: public aux::future_base<void>
     {
-    };
+        public:
+            shared_future() noexcept = default;
 
-    template<class>
-    class packaged_task; // undefined
+            shared_future(const shared_future&) = default;
+            shared_future(shared_future&&) noexcept = default;
 
-    template<class R, class... Args>
-    class packaged_task<R(Args...)>
-    {
-    };
+            shared_future(future<void>&& other) noexcept
+                : aux::future_base<void>{other.steal_()}
+            { /* DUMMY BODY */ }
 
-    template<class R, class... Args>
-    void swap(packaged_task<R(Args...)>& lhs, packaged_task<R(Args...)>& rhs) noexcept
-    {
-        lhs.swap(rhs);
-    };
+            shared_future& operator=(const shared_future&) = default;
+            shared_future& operator=(shared_future&&) noexcept = default;
 
-    template<class R, class Alloc>
-    struct uses_allocator<packaged_task<R>, Alloc>: true_type
-    { /* DUMMY BODY */ };
+            void get() const
+            {
+                assert(this->state_);
 
-    template<class F, class... Args>
-    future<result_of_t<decay_t<F>(decay_t<Args>...)>>
-    async(F&& f, Args&&... args)
-    {
-        // TODO: implement
-        __unimplemented();
-    }
+                this->state_->get();
+            }
+    };
 
-    template<class F, class... Args>
-    future<result_of_t<decay_t<F>(decay_t<Args>...)>>
-    async(launch, F&& f, Args&&... args)
+    inline shared_future<void> future<void>::share()
     {
-        // TODO: implement
-        __unimplemented();
+        return shared_future<void>{move(*this)};
     }
 }
 
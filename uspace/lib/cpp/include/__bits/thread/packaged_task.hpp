@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_THREAD_PACKAGED_TASK
+#define LIBCPP_BITS_THREAD_PACKAGED_TASK
+
+#include <__bits/functional/function.hpp>
+#include <__bits/memory/allocator_arg.hpp>
+#include <__bits/memory/allocator_traits.hpp>
+#include <__bits/thread/future.hpp>
+#include <__bits/thread/shared_state.hpp>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+namespace std
+{
+    /**
+     * 30.6.9, class template packaged_task:
+     */
+
+    template<class>
+    class packaged_task; // undefined
+
+    template<class R, class... Args>
+    class packaged_task<R(Args...)>
+    {
+        public:
+            packaged_task() noexcept
+                : func_{}, state_{nullptr}, future_retrieved_{false}
+            { /* DUMMY BODY */ }
+
+            template<
+                class F,
+                class = enable_if_t<!is_same_v<decay_t<F>, packaged_task>>
+            >
+            explicit packaged_task(F&& f)
+                : func_{forward<F>(f)}, state_{new aux::shared_state<R>{}},
+                  future_retrieved_{false}
+            { /* DUMMY BODY */ }
+
+            /**
+             * Note: For the moment we're ignoring the allocator
+             *       for simplicity of the implementation.
+             */
+            template<class F, class Allocator>
+            explicit packaged_task(allocator_arg_t, const Allocator&, F&& f)
+                : packaged_task{forward<F>(f)}
+            { /* DUMMY BODY */ }
+
+            ~packaged_task()
+            {
+                release_();
+            }
+
+            packaged_task(const packaged_task&) = delete;
+            packaged_task& operator=(const packaged_task&) = delete;
+
+            packaged_task(packaged_task&& other) noexcept
+                : func_{move(other.func_)}, state_{other.state_},
+                  future_retrieved_{other.future_retrieved_}
+            {
+                other.state_ = nullptr;
+            }
+
+            packaged_task& operator=(packaged_task&& rhs) noexcept
+            {
+                if (this != &rhs)
+                {
+                    release_();
+
+                    func_ = move(rhs.func_);
+                    state_ = rhs.state_;
+                    future_retrieved_ = rhs.future_retrieved_;
+                    rhs.state_ = nullptr;
+                }
+
+                return *this;
+            }
+
+            void swap(packaged_task& other) noexcept
+            {
+                std::swap(func_, other.func_);
+                std::swap(state_, other.state_);
+                std::swap(future_retrieved_, other.future_retrieved_);
+            }
+
+            bool valid() const noexcept
+            {
+                return state_ != nullptr;
+            }
+
+            future<R> get_future()
+            {
+                // TODO: throw future_error(future_already_retrieved/no_state)
+                assert(state_ && !future_retrieved_);
+
+                future_retrieved_ = true;
+                state_->increment();
+
+                return future<R>{state_};
+            }
+
+            void operator()(Args... args)
+            {
+                // TODO: throw future_error(no_state/promise_already_satisfied)
+                assert(state_);
+
+                if constexpr (is_same_v<R, void>)
+                {
+                    func_(forward<Args>(args)...);
+                    state_->set_value();
+                }
+                else
+                    state_->set_value(func_(forward<Args>(args)...));
+            }
+
+            /**
+             * Note: Fibrils have no exit hooks, so the
+             *       state is made ready immediately.
+             */
+            void make_ready_at_thread_exit(Args... args)
+            {
+                (*this)(forward<Args>(args)...);
+            }
+
+            void reset()
+            {
+                // TODO: throw future_error(no_state)
+                assert(state_);
+
+                release_();
+                state_ = new aux::shared_state<R>{};
+                future_retrieved_ = false;
+            }
+
+        private:
+            function<R(Args...)> func_;
+            aux::shared_state<R>* state_;
+            bool future_retrieved_;
+
+            void release_()
+            {
+                if (state_)
+                {
+                    if (!state_->is_set())
+                        state_->abandon();
+                    state_->decrement();
+                    state_ = nullptr;
+                }
+            }
+    };
+
+    template<class R, class... Args>
+    void swap(packaged_task<R(Args...)>& lhs, packaged_task<R(Args...)>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    };
+
+    template<class R, class Alloc>
+    struct uses_allocator<packaged_task<R>, Alloc>: true_type
+    { /* DUMMY BODY */ };
+}
+
+#endif
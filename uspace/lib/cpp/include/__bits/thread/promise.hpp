@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_THREAD_PROMISE
+#define LIBCPP_BITS_THREAD_PROMISE
+
+#include <__bits/memory/allocator_arg.hpp>
+#include <__bits/memory/allocator_traits.hpp>
+#include <__bits/thread/future.hpp>
+#include <__bits/thread/shared_state.hpp>
+#include <cassert>
+#include <exception>
+#include <utility>
+
+namespace std
+{
+    /**
+     * 30.6.5, class template promise:
+     */
+
+    namespace aux
+    {
+        template<class R>
+        class promise_base
+        {
+            public:
+                promise_base()
+                    : state_{new shared_state<R>{}}, future_retrieved_{false}
+                { /* DUMMY BODY */ }
+
+                /**
+                 * Note: For the moment we're ignoring the allocator
+                 *       for simplicity of the implementation.
+                 */
+                template<class Allocator>
+                promise_base(allocator_arg_t, const Allocator&)
+                    : promise_base{}
+                { /* DUMMY BODY */ }
+
+                promise_base(promise_base&& other) noexcept
+                    : state_{other.state_}, future_retrieved_{other.future_retrieved_}
+                {
+                    other.state_ = nullptr;
+                }
+
+                promise_base(const promise_base&) = delete;
+
+                ~promise_base()
+                {
+                    release_();
+                }
+
+                promise_base& operator=(promise_base&& rhs) noexcept
+                {
+                    if (this != &rhs)
+                    {
+                        release_();
+
+                        state_ = rhs.state_;
+                        future_retrieved_ = rhs.future_retrieved_;
+                        rhs.state_ = nullptr;
+                    }
+
+                    return *this;
+                }
+
+                promise_base& operator=(const promise_base&) = delete;
+
+                void swap(promise_base& other) noexcept
+                {
+                    std::swap(state_, other.state_);
+                    std::swap(future_retrieved_, other.future_retrieved_);
+                }
+
+                future<R> get_future()
+                {
+                    // TODO: throw future_error(future_already_retrieved/no_state)
+                    assert(state_ && !future_retrieved_);
+
+                    future_retrieved_ = true;
+                    state_->increment();
+
+                    return future<R>{state_};
+                }
+
+                void set_exception(exception_ptr ptr)
+                {
+                    assert(state_);
+
+                    state_->set_exception(ptr);
+                }
+
+                /**
+                 * Note: Fibrils have no exit hooks, so the
+                 *       state is made ready immediately.
+                 */
+                void set_exception_at_thread_exit(exception_ptr ptr)
+                {
+                    set_exception(ptr);
+                }
+
+            protected:
+                shared_state<R>* state_;
+                bool future_retrieved_;
+
+                void release_()
+                {
+                    if (state_)
+                    {
+                        if (!state_->is_set())
+                            state_->abandon();
+                        state_->decrement();
+                        state_ = nullptr;
+                    }
+                }
+        };
+    }
+
+    template<class R>
+    class promise: public aux::promise_base<R>
+    {
+        public:
+            promise() = default;
+
+            template<class Allocator>
+            promise(allocator_arg_t tag, const Allocator& a)
+                : aux::promise_base<R>{tag, a}
+            { /* DUMMY BODY */ }
+
+            promise(promise&&) noexcept = default;
+            promise& operator=(promise&&) noexcept = default;
+
+            void swap(promise& other) noexcept
+            {
+                aux::promise_base<R>::swap(other);
+            }
+
+            void set_value(const R& value)
+            {
+                assert(this->state_);
+
+                this->state_->set_value(value);
+            }
+
+            void set_value(R&& value)
+            {
+                assert(this->state_);
+
+                this->state_->set_value(move(value));
+            }
+
+            void set_value_at_thread_exit(const R& value)
+            {
+                set_value(value);
+            }
+
+            void set_value_at_thread_exit(R&& value)
+            {
+                set_value(move(value));
+            }
+    };
+
+    template<class R>
+    class promise<R&>: public aux::promise_base<R&>
+    {
+        public:
+            promise() = default;
+
+            template<class Allocator>
+            promise(allocator_arg_t tag, const Allocator& a)
+                : aux::promise_base<R&>{tag, a}
+            { /* DUMMY BODY */ }
+
+            promise(promise&&) noexcept = default;
+            promise& operator=(promise&&) noexcept = default;
+
+            void swap(promise& other) noexcept
+            {
+                aux::promise_base<R&>::swap(other);
+            }
+
+            void set_value(R& value)
+            {
+                assert(this->state_);
+
+                this->state_->set_value(value);
+            }
+
+            void set_value_at_thread_exit(R& value)
+            {
+                set_value(value);
+            }
+    };
+
+    template<>
+    class promise<void>: public aux::promise_base<void>
+    {
+        public:
+            promise() = default;
+
+            template<class Allocator>
+            promise(allocator_arg_t tag, const Allocator& a)
+                : aux::promise_base<void>{tag, a}
+            { /* DUMMY BODY */ }
+
+            promise(promise&&) noexcept = default;
+            promise& operator=(promise&&) noexcept = default;
+
+            void swap(promise& other) noexcept
+            {
+                aux::promise_base<void>::swap(other);
+            }
+
+            void set_value()
+            {
+                assert(this->state_);
+
+                this->state_->set_value();
+            }
+
+            void set_value_at_thread_exit()
+            {
+                set_value();
+            }
+    };
+
+    template<class R>
+    void swap(promise<R>& lhs, promise<R>& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    template<class R, class Alloc>
+    struct uses_allocator<promise<R>, Alloc>: true_type
+    { /* DUMMY BODY */ };
+}
+
+#endif
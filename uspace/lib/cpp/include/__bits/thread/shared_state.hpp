@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_THREAD_SHARED_STATE
+#define LIBCPP_BITS_THREAD_SHARED_STATE
+
+/**
+ * 30.6.4, shared state:
+ */
+
+#include <__bits/atomic.hpp>
+#include <__bits/functional/invoke.hpp>
+#include <__bits/thread/future_common.hpp>
+#include <__bits/thread/thread_pool.hpp>
+#include <__bits/thread/threading.hpp>
+#include <cerrno>
+#include <cstdint>
+#include <exception>
+#include <tuple>
+#include <utility>
+
+namespace std::aux
+{
+    /**
+     * Reference counted state shared between providers
+     * (promise, packaged_task, async) and the futures
+     * they return. The creator owns the first reference.
+     */
+    class shared_state_base
+    {
+        public:
+            shared_state_base()
+                : mutex_{}, condvar_{}, refs_{1}, value_set_{false},
+                  exception_{}, has_exception_{false}
+            {
+                threading::mutex::init(mutex_);
+                threading::condvar::init(condvar_);
+            }
+
+            shared_state_base(const shared_state_base&) = delete;
+            shared_state_base& operator=(const shared_state_base&) = delete;
+
+            virtual ~shared_state_base() = default;
+
+            void increment() noexcept
+            {
+                refs_.fetch_add(1, memory_order_relaxed);
+            }
+
+            void decrement() noexcept
+            {
+                if (refs_.fetch_sub(1, memory_order_acq_rel) == 1)
+                    delete this;
+            }
+
+            void set_exception(exception_ptr ptr)
+            {
+                threading::mutex::lock(mutex_);
+
+                // TODO: throw future_error(promise_already_satisfied) if value_set_
+                if (!value_set_)
+                {
+                    exception_ = ptr;
+                    has_exception_ = true;
+                    mark_set_();
+                }
+
+                threading::mutex::unlock(mutex_);
+            }
+
+            /**
+             * Called by a provider that is destroyed
+             * without having satisfied the state.
+             */
+            void abandon()
+            {
+                set_exception(make_exception_ptr(
+                    future_error{make_error_code(future_errc::broken_promise)}
+                ));
+            }
+
+            bool is_set() const
+            {
+                threading::mutex::lock(mutex_);
+                auto res = value_set_;
+                threading::mutex::unlock(mutex_);
+
+                return res;
+            }
+
+            virtual void wait()
+            {
+                threading::mutex::lock(mutex_);
+                while (!value_set_)
+                    threading::condvar::wait(condvar_, mutex_);
+                threading::mutex::unlock(mutex_);
+            }
+
+            virtual future_status wait_for(time_unit_t timeout)
+            {
+                threading::mutex::lock(mutex_);
+                while (!value_set_)
+                {
+                    auto ret = threading::condvar::wait_for(
+                        condvar_, mutex_, timeout
+                    );
+
+                    if (ret != EOK)
+                        break;
+                }
+                auto res = value_set_;
+                threading::mutex::unlock(mutex_);
+
+                return res ? future_status::ready : future_status::timeout;
+            }
+
+            /**
+             * Called when a future referring to this state
+             * is destroyed.
+             */
+            virtual void release_future()
+            { /* DUMMY BODY */ }
+
+        protected:
+            mutable mutex_t mutex_;
+            condvar_t condvar_;
+
+            atomic<size_t> refs_;
+            bool value_set_;
+
+            exception_ptr exception_;
+            bool has_exception_;
+
+            /**
+             * Note: Must be called with mutex_ locked.
+             */
+            void mark_set_()
+            {
+                value_set_ = true;
+                threading::condvar::broadcast(condvar_);
+            }
+
+            void check_exception_()
+            {
+                if (has_exception_)
+                    rethrow_exception(exception_);
+            }
+    };
+
+    template<class R>
+    class shared_state: public shared_state_base
+    {
+        public:
+            shared_state()
+                : shared_state_base{}
+            { /* DUMMY BODY */ }
+
+            ~shared_state() override
+            {
+                if (value_set_ && !has_exception_)
+                    value_()->~R();
+            }
+
+            template<class... Args>
+            void set_value(Args&&... args)
+            {
+                threading::mutex::lock(mutex_);
+
+                // TODO: throw future_error(promise_already_satisfied) if value_set_
+                if (!value_set_)
+                {
+                    new(value_()) R(forward<Args>(args)...);
+                    mark_set_();
+                }
+
+                threading::mutex::unlock(mutex_);
+            }
+
+            R& get()
+            {
+                wait();
+                check_exception_();
+
+                return *value_();
+            }
+
+        private:
+            alignas(R) uint8_t value_storage_[sizeof(R)];
+
+            R* value_()
+            {
+                return reinterpret_cast<R*>(value_storage_);
+            }
+    };
+
+    template<class R>
+    class shared_state<R&>: public shared_state_base
+    {
+        public:
+            shared_state()
+                : shared_state_base{}, value_{}
+            { /* DUMMY BODY */ }
+
+            void set_value(R& value)
+            {
+                threading::mutex::lock(mutex_);
+
+                // TODO: throw future_error(promise_already_satisfied) if value_set_
+                if (!value_set_)
+                {
+                    value_ = &value;
+                    mark_set_();
+                }
+
+                threading::mutex::unlock(mutex_);
+            }
+
+            R& get()
+            {
+                wait();
+                check_exception_();
+
+                return *value_;
+            }
+
+        private:
+            R* value_;
+    };
+
+    template<>
+    class shared_state<void>: public shared_state_base
+    {
+        public:
+            shared_state()
+                : shared_state_base{}
+            { /* DUMMY BODY */ }
+
+            void set_value()
+            {
+                threading::mutex::lock(mutex_);
+
+                // TODO: throw future_error(promise_already_satisfied) if value_set_
+                if (!value_set_)
+                    mark_set_();
+
+                threading::mutex::unlock(mutex_);
+            }
+
+            void get()
+            {
+                wait();
+                check_exception_();
+            }
+    };
+
+    /**
+     * Shared state of std::async, which owns the function
+     * and its arguments. Asynchronous tasks are run by the
+     * default thread_pool, deferred ones by the first fibril
+     * that waits for them. A fibril waiting for an asynchronous
+     * task that no worker picked up yet runs it itself, which
+     * saves a context switch and prevents deadlock when all
+     * workers wait for tasks still sitting in the queues.
+     */
+    template<class R, class F, class... Args>
+    class async_state: public shared_state<R>, public pool_task
+    {
+        public:
+            template<class G, class... As>
+            async_state(bool deferred, G&& g, As&&... args)
+                : shared_state<R>{}, pool_task{},
+                  func_{forward<G>(g)}, args_{forward<As>(args)...},
+                  deferred_{deferred}, claimed_{false}
+            { /* DUMMY BODY */ }
+
+            void run() override
+            {
+                if (!claimed_.exchange(true, memory_order_acq_rel))
+                    execute_(make_index_sequence<sizeof...(Args)>{});
+            }
+
+            void release() override
+            {
+                this->decrement();
+            }
+
+            void wait() override
+            {
+                run();
+                shared_state<R>::wait();
+            }
+
+            future_status wait_for(time_unit_t timeout) override
+            {
+                if (deferred_ && !claimed_.load(memory_order_acquire))
+                    return future_status::deferred;
+                else
+                    return shared_state<R>::wait_for(timeout);
+            }
+
+            /**
+             * The future returned by std::async blocks
+             * until the task finishes on destruction.
+             */
+            void release_future() override
+            {
+                if (!deferred_)
+                    wait();
+            }
+
+        private:
+            F func_;
+            tuple<Args...> args_;
+
+            bool deferred_;
+            atomic<bool> claimed_;
+
+            template<size_t... Is>
+            void execute_(index_sequence<Is...>)
+            {
+                if constexpr (is_same_v<R, void>)
+                {
+                    aux::INVOKE(move(func_), move(get<Is>(args_))...);
+                    this->set_value();
+                }
+                else
+                    this->set_value(aux::INVOKE(move(func_), move(get<Is>(args_))...));
+            }
+    };
+}
+
+#endif
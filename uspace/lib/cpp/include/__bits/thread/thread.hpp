@@ -57,6 +57,8 @@ namespace std
                     aux::threading::condvar::init(join_cv_);
                 }
 
+                virtual ~joinable_wrapper() = default;
+
                 void join()
                 {
                     aux::threading::mutex::lock(join_mtx_);
@@ -70,9 +72,18 @@ namespace std
                     return finished_;
                 }
 
-                void detach()
+                /**
+                 * Returns true if the thread already finished,
+                 * in which case the caller has to delete the wrapper.
+                 */
+                bool detach()
                 {
+                    aux::threading::mutex::lock(join_mtx_);
                     detached_ = true;
+                    auto finished = finished_;
+                    aux::threading::mutex::unlock(join_mtx_);
+
+                    return finished;
                 }
 
                 bool detached() const
@@ -95,15 +106,25 @@ namespace std
                     : joinable_wrapper{}, callable_{forward<Callable>(clbl)}
                 { /* DUMMY BODY */ }
 
-                void operator()()
+                /**
+                 * Returns true if the thread was detached, in which
+                 * case the wrapper has to be deleted by the thread
+                 * itself. Otherwise it belongs to the std::thread
+                 * object, which can delete it as soon as the mutex
+                 * is unlocked, so the wrapper must not be touched
+                 * afterwards.
+                 */
+                bool operator()()
                 {
                     callable_();
 
                     aux::threading::mutex::lock(join_mtx_);
                     finished_ = true;
+                    auto detached = detached_;
+                    aux::threading::condvar::broadcast(join_cv_);
                     aux::threading::mutex::unlock(join_mtx_);
 
-                    aux::threading::condvar::broadcast(join_cv_);
+                    return detached;
                 }
 
             private:
@@ -194,9 +215,7 @@ namespace std
                 return 1;
 
             auto callable = static_cast<CallablePtr>(clbl);
-            (*callable)();
-
-            if (callable->detached())
+            if ((*callable)())
                 delete callable;
 
             return 0;
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef LIBCPP_BITS_THREAD_THREAD_POOL
+#define LIBCPP_BITS_THREAD_THREAD_POOL
+
+#include <__bits/atomic.hpp>
+#include <__bits/thread/threading.hpp>
+#include <cstdlib>
+
+namespace std::aux
+{
+    /**
+     * A unit of work that can be queued in a thread_pool.
+     * Tasks are linked into the queues intrusively, so that
+     * submitting a task does not allocate.
+     */
+    class pool_task
+    {
+        public:
+            pool_task()
+                : prev_{nullptr}, next_{nullptr}
+            { /* DUMMY BODY */ }
+
+            virtual ~pool_task() = default;
+
+            virtual void run() = 0;
+
+            /**
+             * Called by the pool once it is done with the task,
+             * i.e. after the task has been run.
+             */
+            virtual void release() = 0;
+
+        private:
+            pool_task* prev_;
+            pool_task* next_;
+
+            friend class thread_pool;
+    };
+
+    /**
+     * Fixed size pool of worker fibrils that run pool_tasks.
+     *
+     * Every worker has its own double ended queue. Tasks submitted
+     * from a worker are pushed to (and popped from) the back of its
+     * own queue, so that dependent tasks stay close together, while
+     * tasks submitted from the outside are distributed among the
+     * workers in a round-robin fashion. Once a worker runs out of
+     * work, it steals the oldest task from the front of another
+     * worker's queue and only if all queues are empty it goes to
+     * sleep.
+     *
+     * The workers are ordinary fibrils, which libc multiplexes
+     * over its runner threads, so the pool turns multithreaded
+     * fibril scheduling on when it is first created.
+     *
+     * Note: Worker fibrils cannot be joined, so pools are not
+     *       meant to be destroyed, their workers live until the
+     *       task ends.
+     */
+    class thread_pool
+    {
+        public:
+            /**
+             * A size of 0 means one worker per processor, which
+             * matches the number of runner threads libc spawns
+             * in fibril_enable_multithreaded().
+             */
+            explicit thread_pool(size_t size = 0);
+
+            thread_pool(const thread_pool&) = delete;
+            thread_pool& operator=(const thread_pool&) = delete;
+
+            /**
+             * Enqueues the task, the pool calls its release()
+             * after running it.
+             */
+            void submit(pool_task* task);
+
+            size_t size() const noexcept
+            {
+                return size_;
+            }
+
+            /**
+             * The pool used by std::async, created
+             * on first use.
+             */
+            static thread_pool& default_pool();
+
+        private:
+            struct worker
+            {
+                thread_pool* pool;
+                size_t idx;
+
+                mutex_t mtx;
+                pool_task* head;
+                pool_task* tail;
+            };
+
+            worker* workers_;
+            size_t size_;
+
+            /**
+             * Number of tasks sitting in the queues and number
+             * of workers that are (about to go) asleep, these
+             * let submit() skip the idle lock when every worker
+             * is busy.
+             */
+            atomic<size_t> queued_;
+            atomic<size_t> idle_;
+            atomic<size_t> next_;
+
+            mutex_t idle_mtx_;
+            condvar_t idle_cv_;
+
+            /**
+             * Worker the current fibril belongs to, if any,
+             * so that tasks spawned by tasks stay local.
+             */
+            static thread_local worker* current_worker_;
+
+            void push_(worker&, pool_task*);
+            pool_task* pop_back_(worker&);
+            pool_task* pop_front_(worker&);
+            pool_task* take_(worker&);
+            void sleep_();
+
+            static int worker_main_(void*);
+    };
+}
+
+#endif
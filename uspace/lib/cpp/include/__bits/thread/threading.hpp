@@ -32,8 +32,10 @@
 namespace std::hel
 {
     extern "C" {
+        #include <errno.h>
         #include <fibril.h>
         #include <fibril_synch.h>
+        #include <thread.h>
     }
 }
 
@@ -82,6 +84,15 @@ namespace std::aux
                 hel::fibril_yield();
             }
 
+            /**
+             * Lets libc run ready fibrils on more than
+             * one kernel thread.
+             */
+            static void enable_multithreaded()
+            {
+                hel::fibril_enable_multithreaded();
+            }
+
             /**
              * Note: join & detach are performed at the C++
              *       level at the moment, but eventually should
@@ -111,10 +122,15 @@ namespace std::aux
                 return hel::fibril_mutex_trylock(&mtx);
             }
 
+            /**
+             * Note: Timeouts of 0 never expire in libc,
+             *       while negative ones only try once.
+             */
             static bool try_lock_for(mutex_type& mtx, time_unit timeout)
             {
-                // TODO: we need fibril_mutex_trylock_for() :/
-                return try_lock(mtx);
+                return hel::fibril_mutex_lock_timeout(
+                    &mtx, timeout > 0 ? timeout : -1
+                ) == EOK;
             }
         };
 
@@ -189,35 +205,115 @@ namespace std::aux
 
             static bool try_lock(shared_mutex_type& mtx)
             {
-                // TODO: rwlocks don't have try locking capabilities
-                lock(mtx);
-
-                return true;
+                return hel::fibril_rwlock_write_trylock(&mtx);
             }
 
             static bool try_lock_shared(shared_mutex_type& mtx)
             {
-                lock(mtx);
-
-                return true;
+                return hel::fibril_rwlock_read_trylock(&mtx);
             }
 
             static bool try_lock_for(shared_mutex_type& mtx, time_unit timeout)
             {
-                return try_lock(mtx);
+                return hel::fibril_rwlock_write_lock_timeout(
+                    &mtx, timeout > 0 ? timeout : -1
+                ) == EOK;
             }
 
             static bool try_lock_shared_for(shared_mutex_type& mtx, time_unit timeout)
             {
-                return try_lock(mtx);
+                return hel::fibril_rwlock_read_lock_timeout(
+                    &mtx, timeout > 0 ? timeout : -1
+                ) == EOK;
             }
         };
     };
 
+    /**
+     * Start routine of kernel threads, thread_create() passes
+     * a single argument to the thread, so we bundle the callable
+     * with its payload.
+     */
+    template<class Callable>
+    struct kernel_thread_start
+    {
+        Callable clbl;
+        void* pld;
+
+        static void main(void* arg)
+        {
+            auto start = static_cast<kernel_thread_start*>(arg);
+            auto clbl = start->clbl;
+            auto pld = start->pld;
+            delete start;
+
+            clbl(pld);
+        }
+    };
+
+    /**
+     * Runs every thread in a kernel thread of its own, so that
+     * CPU bound work can use more than one processor instead of
+     * waiting for a runner thread to pick it up.
+     *
+     * libc lets kernel threads synchronize with each other (and with
+     * fibrils) using the fibril primitives, so everything except for
+     * the thread management is shared with the fibril policy.
+     */
     template<>
-    struct threading_policy<thread_tag>
+    struct threading_policy<thread_tag>: threading_policy<fibril_tag>
     {
-        // TODO:
+        using thread_type = hel::thread_id_t;
+
+        struct thread
+        {
+            template<class Callable, class Payload>
+            static thread_type create(Callable clbl, Payload& pld)
+            {
+                auto start = new kernel_thread_start<Callable>{clbl, (void*)&pld};
+
+                thread_type tid{};
+                auto rc = hel::thread_create(
+                    kernel_thread_start<Callable>::main,
+                    (void*)start, "cpp thread", &tid
+                );
+                if (rc != EOK)
+                {
+                    delete start;
+
+                    return thread_type{};
+                }
+
+                // Joining is done at the C++ level, as with fibrils.
+                hel::thread_detach(tid);
+
+                return tid;
+            }
+
+            /**
+             * Note: Kernel threads start running as soon as
+             *       they are created.
+             */
+            static void start(thread_type)
+            { /* DUMMY BODY */ }
+
+            static thread_type this_thread()
+            {
+                return hel::thread_get_id();
+            }
+
+            static void yield()
+            {
+                hel::fibril_yield();
+            }
+
+            /**
+             * Note: thread_create() switches libc to multithreaded
+             *       mode on its own.
+             */
+            static void enable_multithreaded()
+            { /* DUMMY BODY */ }
+        };
     };
 
     using default_tag = fibril_tag;
@@ -432,6 +432,28 @@ namespace std
             }
     };
 
+    /**
+     * Note: The generic tuple cannot be instantiated
+     *       with an empty pack, because its element-wise
+     *       constructor and operations assume at least one
+     *       element.
+     */
+    template<>
+    class tuple<>
+    {
+        public:
+            constexpr tuple() = default;
+
+            tuple(const tuple&) = default;
+            tuple(tuple&&) = default;
+
+            tuple& operator=(const tuple&) = default;
+            tuple& operator=(tuple&&) = default;
+
+            void swap(tuple&) noexcept
+            { /* DUMMY BODY */ }
+    };
+
     /**
      * 20.4.2.7, relational operators:
      */
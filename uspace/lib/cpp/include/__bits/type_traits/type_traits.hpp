@@ -107,6 +107,9 @@ namespace std
             char16_t, char32_t, wchar_t>
     { /* DUMMY BODY */ };
 
+    template<class T>
+    inline constexpr bool is_integral_v = is_integral<T>::value;
+
     template<class T>
     struct is_floating_point
         : aux::is_one_of<remove_cv_t<T>, float, double, long double>
@@ -123,6 +126,10 @@ namespace std
     struct is_array<T[]>: true_type
     { /* DUMMY BODY */ };
 
+    template<class T, size_t N>
+    struct is_array<T[N]>: true_type
+    { /* DUMMY BODY */ };
+
     template<class T>
     inline constexpr bool is_array_v = is_array<T>::value;
 
@@ -999,7 +1006,7 @@ namespace std
     using make_signed_t = typename make_signed<T>::type;
 
     template<class T>
-    using make_unsigned_t = typename make_signed<T>::type;
+    using make_unsigned_t = typename make_unsigned<T>::type;
 
     /**
      * 20.10.7.4, array modifications:
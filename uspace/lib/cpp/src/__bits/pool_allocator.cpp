@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/memory/pool_allocator.hpp>
+#include <new>
+
+namespace std::aux
+{
+    node_pool::node_pool(size_t slab_size)
+        : free_lists_{}, slabs_{nullptr}, slab_count_{},
+          slab_size_{slab_size}, refcount_{1}
+    { /* DUMMY BODY */ }
+
+    node_pool::~node_pool()
+    {
+        while (slabs_)
+        {
+            auto tmp = slabs_;
+            slabs_ = slabs_->next;
+
+            ::operator delete(tmp);
+        }
+    }
+
+    void* node_pool::allocate(size_t size)
+    {
+        auto idx = class_idx_(size);
+        if (!free_lists_[idx])
+            refill_(idx);
+
+        auto node = free_lists_[idx];
+        free_lists_[idx] = node->next;
+
+        return node;
+    }
+
+    void node_pool::deallocate(void* ptr, size_t size) noexcept
+    {
+        if (!ptr)
+            return;
+
+        auto idx = class_idx_(size);
+        auto node = static_cast<free_node*>(ptr);
+
+        node->next = free_lists_[idx];
+        free_lists_[idx] = node;
+    }
+
+    void node_pool::refill_(size_t idx)
+    {
+        /**
+         * The slab header takes one granule, so that
+         * the nodes that follow it stay aligned.
+         */
+        auto node_size = (idx + 1) * granularity;
+        auto count = (slab_size_ - granularity) / node_size;
+        if (count == 0)
+            count = 1;
+
+        auto mem = static_cast<char*>(
+            ::operator new(granularity + count * node_size)
+        );
+
+        auto s = reinterpret_cast<slab*>(mem);
+        s->next = slabs_;
+        slabs_ = s;
+        ++slab_count_;
+
+        /**
+         * Thread the nodes in address order, so that
+         * consecutive allocations are adjacent in memory.
+         */
+        auto first = mem + granularity;
+        for (size_t i = count; i > 0; --i)
+        {
+            auto node = reinterpret_cast<free_node*>(first + (i - 1) * node_size);
+            node->next = free_lists_[idx];
+            free_lists_[idx] = node;
+        }
+    }
+}
@@ -27,10 +27,10 @@
  */
 
 #include <__bits/abi.hpp>
+#include <__bits/thread/threading.hpp>
 #include <cstdlib>
 #include <cstdint>
 #include <exception>
-#include <mutex>
 
 void* __dso_handle = nullptr;
 
@@ -122,25 +122,178 @@ namespace __cxxabiv1
     }
 
     using guard_t = std::uint64_t;
-    std::mutex static_guard_mtx{};
+
+    namespace aux
+    {
+        /**
+         * The first byte of a guard is defined by the ABI and
+         * says whether the static has been initialized, compilers
+         * check it inline before calling __cxa_guard_acquire.
+         * We use the second byte to track the initialization.
+         */
+        enum guard_state: std::uint8_t
+        {
+            guard_idle    = 0,
+            guard_pending = 1,
+            guard_waiting = 2,
+            guard_done    = 3
+        };
+
+        std::uint8_t* guard_initialized(guard_t* guard)
+        {
+            return reinterpret_cast<std::uint8_t*>(guard);
+        }
+
+        std::uint8_t* guard_state(guard_t* guard)
+        {
+            return reinterpret_cast<std::uint8_t*>(guard) + 1;
+        }
+
+        /**
+         * Fibrils waiting for a static initialized by another
+         * fibril sleep on one of these, chosen by the address
+         * of the guard, so that unrelated statics rarely wake
+         * each other up.
+         */
+        struct guard_waiters
+        {
+            std::aux::mutex_t mtx;
+            std::aux::condvar_t cv;
+        };
+
+        constexpr std::size_t guard_waiters_count{16};
+        guard_waiters guard_waiters_table[guard_waiters_count];
+
+        /**
+         * Note: The table is initialized on first use rather than
+         *       by a constructor, because statics in other translation
+         *       units may need it before our constructors run.
+         */
+        int guard_waiters_table_state{0};
+
+        guard_waiters& get_guard_waiters(guard_t* guard)
+        {
+            using threading = std::aux::threading;
+
+            if (__atomic_load_n(&guard_waiters_table_state, __ATOMIC_ACQUIRE) != 2)
+            {
+                int expected{0};
+                if (__atomic_compare_exchange_n(
+                    &guard_waiters_table_state, &expected, 1, false,
+                    __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE
+                ))
+                {
+                    for (auto& waiters: guard_waiters_table)
+                    {
+                        threading::mutex::init(waiters.mtx);
+                        threading::condvar::init(waiters.cv);
+                    }
+
+                    __atomic_store_n(&guard_waiters_table_state, 2, __ATOMIC_RELEASE);
+                }
+                else
+                {
+                    while (__atomic_load_n(&guard_waiters_table_state, __ATOMIC_ACQUIRE) != 2)
+                        threading::thread::yield();
+                }
+            }
+
+            auto idx = (reinterpret_cast<std::uintptr_t>(guard) / alignof(guard_t));
+
+            return guard_waiters_table[idx % guard_waiters_count];
+        }
+
+        void wake_guard_waiters(guard_t* guard)
+        {
+            using threading = std::aux::threading;
+
+            auto& waiters = get_guard_waiters(guard);
+            threading::mutex::lock(waiters.mtx);
+            threading::condvar::broadcast(waiters.cv);
+            threading::mutex::unlock(waiters.mtx);
+        }
+    }
 
     extern "C" int __cxa_guard_acquire(guard_t* guard)
     {
-        static_guard_mtx.lock();
+        using threading = std::aux::threading;
+
+        auto initialized = aux::guard_initialized(guard);
+        auto state = aux::guard_state(guard);
+
+        // Fast path, the static has already been initialized.
+        if (__atomic_load_n(initialized, __ATOMIC_ACQUIRE))
+            return 0;
+
+        std::uint8_t expected{aux::guard_idle};
+        if (__atomic_compare_exchange_n(
+            state, &expected, aux::guard_pending, false,
+            __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE
+        ))
+        {
+            return 1;
+        }
+        else if (expected == aux::guard_done)
+            return 0;
+
+        // Another fibril is initializing the static, wait for it.
+        auto& waiters = aux::get_guard_waiters(guard);
+        threading::mutex::lock(waiters.mtx);
+        while (true)
+        {
+            expected = aux::guard_idle;
+            if (__atomic_compare_exchange_n(
+                state, &expected, aux::guard_pending, false,
+                __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE
+            ))
+            {
+                // The previous initialization was aborted, we try again.
+                threading::mutex::unlock(waiters.mtx);
+
+                return 1;
+            }
+            else if (expected == aux::guard_done)
+                break;
+            else if (expected == aux::guard_pending)
+            {
+                if (!__atomic_compare_exchange_n(
+                    state, &expected, aux::guard_waiting, false,
+                    __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE
+                ))
+                {
+                    continue;
+                }
+            }
 
-        return !*((std::uint8_t*)guard);
+            /**
+             * The releasing fibril has to lock the mutex to wake
+             * us up, so it cannot do so before we start waiting.
+             */
+            threading::condvar::wait(waiters.cv, waiters.mtx);
+        }
+        threading::mutex::unlock(waiters.mtx);
+
+        return 0;
     }
 
     extern "C" void __cxa_guard_release(guard_t* guard)
     {
-        *((std::uint8_t*)guard) = 1;
+        __atomic_store_n(aux::guard_initialized(guard), 1, __ATOMIC_RELEASE);
 
-        static_guard_mtx.unlock();
+        auto prev = __atomic_exchange_n(
+            aux::guard_state(guard), aux::guard_done, __ATOMIC_ACQ_REL
+        );
+        if (prev == aux::guard_waiting)
+            aux::wake_guard_waiters(guard);
     }
 
     extern "C" void __cxa_guard_abort(guard_t* guard)
     {
-        static_guard_mtx.unlock();
+        auto prev = __atomic_exchange_n(
+            aux::guard_state(guard), aux::guard_idle, __ATOMIC_ACQ_REL
+        );
+        if (prev == aux::guard_waiting)
+            aux::wake_guard_waiters(guard);
     }
 
     __fundamental_type_info::~__fundamental_type_info()
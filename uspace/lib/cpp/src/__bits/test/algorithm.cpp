@@ -29,8 +29,10 @@
 #include <__bits/test/tests.hpp>
 #include <algorithm>
 #include <array>
+#include <iterator>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace std::test
 {
@@ -41,6 +43,7 @@ namespace std::test
 
         test_non_modifying();
         test_mutating();
+        test_sorting();
 
         return end();
     }
@@ -292,5 +295,127 @@ namespace std::test
             data10.begin(), data10.end()
         );
         test_eq("transform pt2", res6, data10.end());
+
+        auto check8 = {1, 2, 3, 1};
+        std::array<int, 7> data11{1, 1, 2, 3, 3, 3, 1};
+
+        auto res7 = std::unique(data11.begin(), data11.end());
+        test_eq(
+            "unique pt1",
+            check8.begin(), check8.end(),
+            data11.begin(), res7
+        );
+        test_eq("unique pt2", res7, data11.begin() + 4);
+
+        auto check9 = {1, 4, 9};
+        std::array<int, 6> data12{1, 2, 4, 5, 9, 10};
+        std::vector<int> data13{};
+
+        std::unique_copy(
+            data12.begin(), data12.end(), std::back_inserter(data13),
+            [](auto x, auto y) { return x + 1 == y; }
+        );
+        test_eq(
+            "unique_copy",
+            check9.begin(), check9.end(),
+            data13.begin(), data13.end()
+        );
+    }
+    void algorithm_test::test_sorting()
+    {
+        auto check1 = {1, 2, 2, 3, 5, 7, 8, 9};
+        std::vector<int> data1{7, 2, 9, 1, 5, 2, 8, 3};
+        std::sort(data1.begin(), data1.end());
+        test_eq(
+            "sort small",
+            check1.begin(), check1.end(),
+            data1.begin(), data1.end()
+        );
+
+        std::vector<int> data2{};
+        for (int i = 0; i < 1000; ++i)
+            data2.push_back((i * 7919) % 1009);
+        std::sort(data2.begin(), data2.end());
+        test("sort large", std::is_sorted(data2.begin(), data2.end()));
+
+        std::vector<int> data3{};
+        for (int i = 0; i < 500; ++i)
+            data3.push_back(i % 3);
+        std::sort(data3.begin(), data3.end(), [](auto x, auto y){ return x > y; });
+        test(
+            "sort duplicates with comparator",
+            std::is_sorted(data3.begin(), data3.end(), [](auto x, auto y){ return x > y; })
+        );
+
+        std::vector<int> data4{};
+        for (int i = 1000; i > 0; --i)
+            data4.push_back(i);
+        std::sort(data4.begin(), data4.end());
+        test_eq("sort reversed pt1", data4.front(), 1);
+        test_eq("sort reversed pt2", data4.back(), 1000);
+
+        std::vector<std::pair<int, int>> data5{};
+        for (int i = 0; i < 300; ++i)
+            data5.emplace_back((i * 37) % 10, i);
+        std::stable_sort(
+            data5.begin(), data5.end(),
+            [](const auto& x, const auto& y){ return x.first < y.first; }
+        );
+        bool stable{true};
+        for (size_t i = 1; i < data5.size(); ++i)
+        {
+            if (data5[i - 1].first > data5[i].first ||
+                (data5[i - 1].first == data5[i].first &&
+                 data5[i - 1].second > data5[i].second))
+                stable = false;
+        }
+        test("stable_sort", stable);
+
+        auto check2 = {1, 2, 3, 4, 5, 6};
+        std::array<int, 6> data6{1, 3, 5, 2, 4, 6};
+        std::inplace_merge(data6.begin(), data6.begin() + 3, data6.end());
+        test_eq(
+            "inplace_merge",
+            check2.begin(), check2.end(),
+            data6.begin(), data6.end()
+        );
+
+        auto data7 = {1, 3, 5};
+        auto data8 = {2, 4, 6};
+        std::array<int, 6> result1{};
+        auto res1 = std::merge(
+            data7.begin(), data7.end(),
+            data8.begin(), data8.end(),
+            result1.begin()
+        );
+        test_eq(
+            "merge pt1",
+            check2.begin(), check2.end(),
+            result1.begin(), result1.end()
+        );
+        test_eq("merge pt2", res1, result1.end());
+
+        std::array<int, 6> data9{1, 2, 3, 4, 5, 6};
+        auto check3 = {3, 4, 5, 6, 1, 2};
+        auto res2 = std::rotate(data9.begin(), data9.begin() + 2, data9.end());
+        test_eq(
+            "rotate pt1",
+            check3.begin(), check3.end(),
+            data9.begin(), data9.end()
+        );
+        test_eq("rotate pt2", res2, data9.begin() + 4);
+
+        std::array<int, 6> data10{1, 2, 2, 2, 3, 4};
+        test_eq(
+            "lower_bound",
+            std::lower_bound(data10.begin(), data10.end(), 2),
+            data10.begin() + 1
+        );
+        test_eq(
+            "upper_bound",
+            std::upper_bound(data10.begin(), data10.end(), 2),
+            data10.begin() + 4
+        );
+        test_eq("is_sorted", std::is_sorted(data10.begin(), data10.end()), true);
     }
 }
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace std::test
+{
+    namespace aux
+    {
+        size_t bench_task(size_t x)
+        {
+            return x + 1;
+        }
+
+        uint64_t bench_spin(uint64_t seed, size_t rounds)
+        {
+            auto x = seed | 1;
+            for (size_t i = 0; i < rounds; ++i)
+            {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+            }
+
+            return x;
+        }
+
+        struct spin_job
+        {
+            uint64_t seed;
+            size_t rounds;
+            uint64_t result;
+
+            std::mutex* mtx;
+            std::condition_variable* cv;
+            size_t* remaining;
+        };
+
+        int spin_main(void* arg)
+        {
+            auto job = static_cast<spin_job*>(arg);
+            job->result = bench_spin(job->seed, job->rounds);
+
+            std::lock_guard<std::mutex> lock{*job->mtx};
+            if (--*job->remaining == 0)
+                job->cv->notify_all();
+
+            return 0;
+        }
+    }
+
+    bool async_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        // Make sure the pool's workers are up.
+        std::async(std::launch::async, aux::bench_task, 0).get();
+
+        size_t expected_sum{};
+        for (size_t i = 0; i < task_count; ++i)
+            expected_sum += aux::bench_task(i);
+
+        size_t sum{};
+        auto elapsed = measure("async spawn/get", [&](){
+            for (size_t i = 0; i < task_count; ++i)
+                sum += std::async(std::launch::async, aux::bench_task, i).get();
+        });
+        report_latency("async spawn/get latency", elapsed, task_count);
+        test_eq("async spawn/get", sum, expected_sum);
+
+        sum = 0;
+        std::vector<std::future<size_t>> futures(task_count);
+        elapsed = measure("async fan-out", [&](){
+            for (size_t i = 0; i < task_count; ++i)
+                futures[i] = std::async(std::launch::async, aux::bench_task, i);
+            for (auto& f: futures)
+                sum += f.get();
+        });
+        report_latency("async fan-out latency", elapsed, task_count);
+        test_eq("async fan-out", sum, expected_sum);
+
+        sum = 0;
+        elapsed = measure("deferred spawn/get", [&](){
+            for (size_t i = 0; i < task_count; ++i)
+                sum += std::async(std::launch::deferred, aux::bench_task, i).get();
+        });
+        report_latency("deferred spawn/get latency", elapsed, task_count);
+        test_eq("deferred spawn/get", sum, expected_sum);
+
+        sum = 0;
+        elapsed = measure("packaged_task call/get", [&](){
+            for (size_t i = 0; i < task_count; ++i)
+            {
+                std::packaged_task<size_t(size_t)> task{aux::bench_task};
+                auto f = task.get_future();
+                task(i);
+                sum += f.get();
+            }
+        });
+        report_latency("packaged_task call/get latency", elapsed, task_count);
+        test_eq("packaged_task call/get", sum, expected_sum);
+
+        /**
+         * For comparison, a fibril per task the way
+         * std::thread creates them.
+         */
+        sum = 0;
+        elapsed = measure("thread spawn/join", [&](){
+            for (size_t i = 0; i < thread_count; ++i)
+            {
+                size_t res{};
+                std::thread thr{[&res, i](){ res = aux::bench_task(i); }};
+                thr.join();
+                sum += res;
+            }
+        });
+        report_latency("thread spawn/join latency", elapsed, thread_count);
+
+        expected_sum = 0;
+        for (size_t i = 0; i < thread_count; ++i)
+            expected_sum += aux::bench_task(i);
+        test_eq("thread spawn/join", sum, expected_sum);
+
+        /**
+         * CPU bound work split among kernel threads, one per
+         * processor, against doing all of it in this fibril.
+         */
+        size_t cpus = std::thread::hardware_concurrency();
+        report_value("hardware concurrency", cpus, "cpus");
+        test("hardware concurrency", cpus > 0);
+        if (cpus == 0)
+            cpus = 1;
+
+        std::mutex mtx{};
+        std::condition_variable cv{};
+        size_t remaining{};
+        std::vector<aux::spin_job> jobs(cpus);
+        for (size_t i = 0; i < cpus; ++i)
+            jobs[i] = aux::spin_job{i, spin_rounds / cpus, 0, &mtx, &cv, &remaining};
+
+        uint64_t expected_spin{};
+        measure("spin in one fibril", [&](){
+            for (auto& job: jobs)
+                expected_spin ^= aux::bench_spin(job.seed, job.rounds);
+        });
+
+        using kernel_threads = std::aux::threading_policy<std::aux::thread_tag>;
+
+        remaining = cpus;
+        measure("spin in kernel threads", [&](){
+            for (auto& job: jobs)
+            {
+                auto tid = kernel_threads::thread::create(aux::spin_main, job);
+                if (tid == kernel_threads::thread_type{})
+                {
+                    // Out of threads, do the share here.
+                    aux::spin_main(&job);
+                    continue;
+                }
+
+                kernel_threads::thread::start(tid);
+            }
+
+            std::unique_lock<std::mutex> lock{mtx};
+            while (remaining > 0)
+                cv.wait(lock);
+        });
+
+        uint64_t spin{};
+        for (auto& job: jobs)
+            spin ^= job.result;
+        test_eq("spin in kernel threads", spin, expected_spin);
+
+        return end();
+    }
+
+    const char* async_benchmark::name()
+    {
+        return "async benchmark";
+    }
+
+    void async_benchmark::report_latency(const char* bname, uint64_t usecs, size_t count)
+    {
+        report_value(bname, usecs * 1000 / count, "ns");
+    }
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace std::test
+{
+    namespace aux
+    {
+        struct small_pod
+        {
+            short x;
+            short y;
+        };
+
+        struct big_pod
+        {
+            long data[8];
+        };
+    }
+
+    bool atomic_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_integral();
+        test_pointer();
+        test_generic();
+        test_flag();
+        test_concurrent();
+
+        return end();
+    }
+
+    const char* atomic_test::name()
+    {
+        return "atomic";
+    }
+
+    void atomic_test::test_integral()
+    {
+        std::atomic<int> a1{5};
+        test_eq("load", a1.load(), 5);
+        test_eq("conversion", static_cast<int>(a1), 5);
+
+        a1.store(10, std::memory_order_relaxed);
+        test_eq("store", a1.load(std::memory_order_relaxed), 10);
+
+        a1 = 11;
+        test_eq("operator=", a1.load(), 11);
+
+        test_eq("exchange pt1", a1.exchange(20), 11);
+        test_eq("exchange pt2", a1.load(), 20);
+
+        test_eq("fetch_add pt1", a1.fetch_add(5), 20);
+        test_eq("fetch_add pt2", a1.load(), 25);
+        test_eq("fetch_sub pt1", a1.fetch_sub(10), 25);
+        test_eq("fetch_sub pt2", a1.load(), 15);
+
+        test_eq("pre increment", ++a1, 16);
+        test_eq("post increment pt1", a1++, 16);
+        test_eq("post increment pt2", a1.load(), 17);
+        test_eq("pre decrement", --a1, 16);
+        test_eq("post decrement pt1", a1--, 16);
+        test_eq("post decrement pt2", a1.load(), 15);
+        test_eq("operator+=", a1 += 5, 20);
+        test_eq("operator-=", a1 -= 8, 12);
+
+        std::atomic<unsigned int> a2{0b1100U};
+        test_eq("fetch_and pt1", a2.fetch_and(0b0101U), 0b1100U);
+        test_eq("fetch_and pt2", a2.load(), 0b0100U);
+        test_eq("fetch_or pt1", a2.fetch_or(0b0011U), 0b0100U);
+        test_eq("fetch_or pt2", a2.load(), 0b0111U);
+        test_eq("fetch_xor pt1", a2.fetch_xor(0b0101U), 0b0111U);
+        test_eq("fetch_xor pt2", a2.load(), 0b0010U);
+        test_eq("operator&=", a2 &= 0b0011U, 0b0010U);
+        test_eq("operator|=", a2 |= 0b1000U, 0b1010U);
+        test_eq("operator^=", a2 ^= 0b1111U, 0b0101U);
+
+        int expected{12};
+        auto res1 = a1.compare_exchange_strong(expected, 42);
+        test_eq("compare_exchange_strong success pt1", res1, true);
+        test_eq("compare_exchange_strong success pt2", a1.load(), 42);
+
+        expected = 0;
+        auto res2 = a1.compare_exchange_strong(expected, 7);
+        test_eq("compare_exchange_strong failure pt1", res2, false);
+        test_eq("compare_exchange_strong failure pt2", expected, 42);
+        test_eq("compare_exchange_strong failure pt3", a1.load(), 42);
+
+        expected = 42;
+        while (!a1.compare_exchange_weak(expected, 43, std::memory_order_acq_rel))
+        { /* DUMMY BODY */ }
+        test_eq("compare_exchange_weak", a1.load(), 43);
+
+        std::atomic<bool> a3{false};
+        test_eq("bool exchange pt1", a3.exchange(true), false);
+        test_eq("bool exchange pt2", a3.load(), true);
+
+        std::atomic_long a4{};
+        std::atomic_init(&a4, 3L);
+        test_eq("atomic_init", std::atomic_load(&a4), 3L);
+        test_eq("atomic_fetch_add", std::atomic_fetch_add(&a4, 2L), 3L);
+        test_eq("atomic_fetch_sub_explicit", std::atomic_fetch_sub_explicit(
+            &a4, 1L, std::memory_order_release), 5L);
+        std::atomic_store(&a4, 100L);
+        test_eq("atomic_store", a4.load(), 100L);
+
+        test_eq("int lock free", a1.is_lock_free(), ATOMIC_INT_LOCK_FREE == 2);
+        test_eq("pointer lock free", std::atomic<int*>{}.is_lock_free(),
+                ATOMIC_POINTER_LOCK_FREE == 2);
+        test_eq("is_always_lock_free", std::atomic<int>::is_always_lock_free,
+                ATOMIC_INT_LOCK_FREE == 2);
+    }
+
+    void atomic_test::test_pointer()
+    {
+        long data[]{1, 2, 3, 4, 5};
+
+        std::atomic<long*> a1{&data[0]};
+        test_eq("pointer load", *a1.load(), 1L);
+        test_eq("pointer fetch_add pt1", a1.fetch_add(2), &data[0]);
+        test_eq("pointer fetch_add pt2", *a1.load(), 3L);
+        test_eq("pointer fetch_sub pt1", a1.fetch_sub(1), &data[2]);
+        test_eq("pointer fetch_sub pt2", *a1.load(), 2L);
+        test_eq("pointer pre increment", *++a1, 3L);
+        test_eq("pointer operator+=", *(a1 += 2), 5L);
+        test_eq("pointer operator-=", *(a1 -= 4), 1L);
+        test_eq("pointer atomic_fetch_add", std::atomic_fetch_add(&a1, 1), &data[0]);
+        test_eq("pointer atomic_fetch_add result", a1.load(), &data[1]);
+
+        long* expected = &data[1];
+        test_eq("pointer compare_exchange",
+                a1.compare_exchange_strong(expected, &data[4]), true);
+        test_eq("pointer compare_exchange result", a1.load(), &data[4]);
+    }
+
+    void atomic_test::test_generic()
+    {
+        std::atomic<aux::small_pod> a1{aux::small_pod{1, 2}};
+        auto val1 = a1.load();
+        test_eq("small struct load", val1.x + val1.y, 3);
+        test_eq("small struct lock free", a1.is_lock_free(),
+                __atomic_always_lock_free(sizeof(aux::small_pod), 0));
+
+        aux::small_pod expected1{1, 2};
+        test_eq("small struct compare_exchange pt1",
+                a1.compare_exchange_strong(expected1, aux::small_pod{3, 4}), true);
+        auto val2 = a1.load();
+        test_eq("small struct compare_exchange pt2", val2.x + val2.y, 7);
+
+        std::atomic<aux::big_pod> a2{aux::big_pod{{1, 2, 3, 4, 5, 6, 7, 8}}};
+        test_eq("big struct not lock free", a2.is_lock_free(), false);
+        auto val3 = a2.exchange(aux::big_pod{{8, 7, 6, 5, 4, 3, 2, 1}});
+        test_eq("big struct exchange pt1", val3.data[0], 1L);
+        test_eq("big struct exchange pt2", a2.load().data[0], 8L);
+
+        aux::big_pod expected2{{0, 0, 0, 0, 0, 0, 0, 0}};
+        test_eq("big struct compare_exchange failure pt1",
+                a2.compare_exchange_strong(expected2, aux::big_pod{}), false);
+        test_eq("big struct compare_exchange failure pt2", expected2.data[7], 1L);
+        test_eq("big struct compare_exchange success",
+                a2.compare_exchange_strong(expected2, aux::big_pod{{9}}), true);
+        test_eq("big struct compare_exchange result", a2.load().data[0], 9L);
+
+        std::atomic<double> a3{1.5};
+        test_eq("double exchange pt1", a3.exchange(2.5), 1.5);
+        test_eq("double exchange pt2", a3.load(), 2.5);
+    }
+
+    void atomic_test::test_flag()
+    {
+        std::atomic_flag flag = ATOMIC_FLAG_INIT;
+        test_eq("flag test_and_set pt1", flag.test_and_set(), false);
+        test_eq("flag test_and_set pt2", flag.test_and_set(), true);
+
+        flag.clear(std::memory_order_release);
+        test_eq("flag clear", std::atomic_flag_test_and_set(&flag), false);
+
+        std::atomic_flag_clear_explicit(&flag, std::memory_order_relaxed);
+        test_eq("flag clear explicit", flag.test_and_set(std::memory_order_acquire), false);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+
+    void atomic_test::test_concurrent()
+    {
+        constexpr int thread_count{8};
+        constexpr int increments{1000};
+
+        std::atomic<int> counter{0};
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        int guarded{};
+
+        std::vector<std::thread> threads{};
+        for (int i = 0; i < thread_count; ++i)
+        {
+            threads.emplace_back([&](){
+                for (int j = 0; j < increments; ++j)
+                {
+                    counter.fetch_add(1, std::memory_order_relaxed);
+
+                    while (lock.test_and_set(std::memory_order_acquire))
+                        std::this_thread::yield();
+                    ++guarded;
+                    lock.clear(std::memory_order_release);
+
+                    if (j % 100 == 0)
+                        std::this_thread::yield();
+                }
+            });
+        }
+
+        for (auto& thr: threads)
+            thr.join();
+
+        test_eq("concurrent fetch_add", counter.load(), thread_count * increments);
+        test_eq("concurrent flag spinlock", guarded, thread_count * increments);
+    }
+}
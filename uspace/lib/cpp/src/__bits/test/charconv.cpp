@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace std::test
+{
+    bool charconv_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_to_chars_integral();
+        test_from_chars_integral();
+        test_to_chars_floating();
+        test_from_chars_floating();
+        test_streams();
+
+        return end();
+    }
+
+    const char* charconv_test::name()
+    {
+        return "charconv";
+    }
+
+    void charconv_test::test_to_chars_integral()
+    {
+        char buf[80];
+
+        auto res = std::to_chars(buf, buf + sizeof(buf), 0);
+        test_eq("to_chars zero", std::string(buf, res.ptr), std::string{"0"});
+
+        res = std::to_chars(buf, buf + sizeof(buf), 1234567890);
+        test_eq("to_chars int", std::string(buf, res.ptr), std::string{"1234567890"});
+
+        res = std::to_chars(buf, buf + sizeof(buf), numeric_limits<int>::min());
+        test_eq("to_chars int min", std::string(buf, res.ptr), std::string{"-2147483648"});
+
+        res = std::to_chars(buf, buf + sizeof(buf), numeric_limits<unsigned long long>::max());
+        test_eq(
+            "to_chars ull max", std::string(buf, res.ptr),
+            std::string{"18446744073709551615"}
+        );
+
+        res = std::to_chars(buf, buf + sizeof(buf), numeric_limits<long long>::min());
+        test_eq(
+            "to_chars ll min", std::string(buf, res.ptr),
+            std::string{"-9223372036854775808"}
+        );
+
+        res = std::to_chars(buf, buf + sizeof(buf), 255, 16);
+        test_eq("to_chars hex", std::string(buf, res.ptr), std::string{"ff"});
+
+        res = std::to_chars(buf, buf + sizeof(buf), -5, 2);
+        test_eq("to_chars binary", std::string(buf, res.ptr), std::string{"-101"});
+
+        res = std::to_chars(buf, buf + sizeof(buf), 1295, 36);
+        test_eq("to_chars base 36", std::string(buf, res.ptr), std::string{"zz"});
+
+        res = std::to_chars(buf, buf + 3, 1234);
+        test_eq("to_chars too large pt1", res.ec, errc::value_too_large);
+        test_eq("to_chars too large pt2", res.ptr, buf + 3);
+    }
+
+    void charconv_test::test_from_chars_integral()
+    {
+        const char* str = "12345abc";
+        int i{};
+        auto res = std::from_chars(str, str + 8, i);
+        test_eq("from_chars int pt1", i, 12345);
+        test_eq("from_chars int pt2", res.ptr, str + 5);
+        test_eq("from_chars int pt3", res.ec, errc{});
+
+        str = "-128";
+        int8_t i8{};
+        res = std::from_chars(str, str + 4, i8);
+        test_eq("from_chars int8 min", i8, int8_t{-128});
+
+        str = "128";
+        i8 = 42;
+        res = std::from_chars(str, str + 3, i8);
+        test_eq("from_chars out of range pt1", res.ec, errc::result_out_of_range);
+        test_eq("from_chars out of range pt2", res.ptr, str + 3);
+        test_eq("from_chars out of range pt3", i8, int8_t{42});
+
+        str = "-1";
+        unsigned u{7};
+        res = std::from_chars(str, str + 2, u);
+        test_eq("from_chars unsigned minus pt1", res.ec, errc::invalid_argument);
+        test_eq("from_chars unsigned minus pt2", res.ptr, str);
+        test_eq("from_chars unsigned minus pt3", u, 7U);
+
+        str = "FfZ";
+        res = std::from_chars(str, str + 3, u, 16);
+        test_eq("from_chars hex pt1", u, 255U);
+        test_eq("from_chars hex pt2", res.ptr, str + 2);
+
+        str = "18446744073709551615";
+        unsigned long long ull{};
+        res = std::from_chars(str, str + 20, ull);
+        test_eq("from_chars ull max", ull, numeric_limits<unsigned long long>::max());
+    }
+
+    void charconv_test::test_to_chars_floating()
+    {
+        test_eq("to_chars double short pt1", to_str(0.1), std::string{"0.1"});
+        test_eq("to_chars double short pt2", to_str(123456.0), std::string{"123456"});
+        test_eq("to_chars double short pt3", to_str(1e21), std::string{"1e+21"});
+        test_eq("to_chars double short pt4", to_str(1.0 / 3), std::string{"0.3333333333333333"});
+        test_eq("to_chars double short pt5", to_str(5e-324), std::string{"5e-324"});
+        test_eq("to_chars double short pt6", to_str(-0.0), std::string{"-0"});
+        test_eq("to_chars double short pt7", to_str(-1.5e-7), std::string{"-1.5e-07"});
+        test_eq(
+            "to_chars double infinity", to_str(-numeric_limits<double>::infinity()),
+            std::string{"-inf"}
+        );
+        test_eq("to_chars double short pt8", to_str(1e23), std::string{"1e+23"});
+        test_eq(
+            "to_chars double short pt9", to_str(1.7976931348623157e308),
+            std::string{"1.7976931348623157e+308"}
+        );
+
+        test_eq("to_chars float short pt1", to_str(0.1f), std::string{"0.1"});
+        test_eq("to_chars float short pt2", to_str(3.4028235e38f), std::string{"3.4028235e+38"});
+        test_eq("to_chars float short pt3", to_str(1.1754944e-38f), std::string{"1.1754944e-38"});
+        test_eq("to_chars float short pt4", to_str(1e-45f), std::string{"1e-45"});
+        test_eq("to_chars float short pt5", to_str(16777216.0f), std::string{"16777216"});
+
+        test_eq(
+            "to_chars fixed", to_str(3.14159, chars_format::fixed, 2),
+            std::string{"3.14"}
+        );
+        test_eq(
+            "to_chars fixed zeros", to_str(2.5, chars_format::fixed, 4),
+            std::string{"2.5000"}
+        );
+        test_eq(
+            "to_chars fixed shortest", to_str(1e-3, chars_format::fixed),
+            std::string{"0.001"}
+        );
+        test_eq(
+            "to_chars fixed exact pt1", to_str(1e23, chars_format::fixed, 0),
+            std::string{"99999999999999991611392"}
+        );
+        test_eq(
+            "to_chars fixed exact pt2", to_str(0.1, chars_format::fixed, 20),
+            std::string{"0.10000000000000000555"}
+        );
+        test_eq(
+            "to_chars fixed half to even pt1", to_str(0.125, chars_format::fixed, 2),
+            std::string{"0.12"}
+        );
+        test_eq(
+            "to_chars fixed half to even pt2", to_str(0.5, chars_format::fixed, 0),
+            std::string{"0"}
+        );
+        test_eq(
+            "to_chars fixed round up", to_str(0.006, chars_format::fixed, 2),
+            std::string{"0.01"}
+        );
+        test_eq(
+            "to_chars scientific", to_str(2.5, chars_format::scientific, 3),
+            std::string{"2.500e+00"}
+        );
+        test_eq(
+            "to_chars scientific shortest", to_str(123.0, chars_format::scientific),
+            std::string{"1.23e+02"}
+        );
+        test_eq(
+            "to_chars scientific denormal", to_str(5e-324, chars_format::scientific, 3),
+            std::string{"4.941e-324"}
+        );
+        test_eq(
+            "to_chars general pt1", to_str(1234567.0, chars_format::general, 6),
+            std::string{"1.23457e+06"}
+        );
+        test_eq(
+            "to_chars general pt2", to_str(100.0, chars_format::general, 6),
+            std::string{"100"}
+        );
+        test_eq(
+            "to_chars general pt3", to_str(0.0001, chars_format::general, 6),
+            std::string{"0.0001"}
+        );
+        test_eq(
+            "to_chars general carry", to_str(999999.5, chars_format::general, 6),
+            std::string{"1e+06"}
+        );
+        test_eq(
+            "to_chars general shortest", to_str(1e-5, chars_format::general),
+            std::string{"1e-05"}
+        );
+
+        char buf[4];
+        auto res = std::to_chars(buf, buf + sizeof(buf), 1.2345);
+        test_eq("to_chars double too large", res.ec, errc::value_too_large);
+
+        test_eq("to_string int", std::to_string(-42), std::string{"-42"});
+        test_eq("to_string double", std::to_string(-1.5), std::string{"-1.500000"});
+    }
+
+    void charconv_test::test_from_chars_floating()
+    {
+        const char* str = "3.25xyz";
+        double d{};
+        auto res = std::from_chars(str, str + 7, d);
+        test_eq("from_chars double pt1", d, 3.25);
+        test_eq("from_chars double pt2", res.ptr, str + 4);
+
+        str = "-1.5e3";
+        res = std::from_chars(str, str + 6, d);
+        test_eq("from_chars double exponent", d, -1500.0);
+
+        str = "1e5";
+        res = std::from_chars(str, str + 3, d, chars_format::fixed);
+        test_eq("from_chars fixed pt1", d, 1.0);
+        test_eq("from_chars fixed pt2", res.ptr, str + 1);
+
+        str = "1.5";
+        res = std::from_chars(str, str + 3, d, chars_format::scientific);
+        test_eq("from_chars scientific", res.ec, errc::invalid_argument);
+
+        str = "1e400";
+        res = std::from_chars(str, str + 5, d);
+        test_eq("from_chars double out of range", res.ec, errc::result_out_of_range);
+
+        str = "1e39";
+        float f{};
+        res = std::from_chars(str, str + 4, f);
+        test_eq("from_chars float out of range", res.ec, errc::result_out_of_range);
+
+        str = "e5";
+        res = std::from_chars(str, str + 2, d);
+        test_eq("from_chars double invalid", res.ec, errc::invalid_argument);
+
+        // Shortest output must convert back to the same value.
+        double values[] = {0.1, 1.0 / 3, 2.0 / 7 * 1e100, 5e-324, 1.7976931348623157e308};
+        bool round_trip{true};
+        for (auto value: values)
+        {
+            auto str = to_str(value);
+            double tmp{};
+            std::from_chars(str.c_str(), str.c_str() + str.size(), tmp);
+
+            if (tmp != value)
+                round_trip = false;
+        }
+        test("from_chars round trip", round_trip);
+    }
+
+    void charconv_test::test_streams()
+    {
+        std::ostringstream oss{};
+        oss << 42 << ' ' << -7L << ' ' << std::hex << 255 << ' '
+            << std::uppercase << 255 << std::dec << ' ' << 2.5 << ' '
+            << 1e-7;
+        test_eq("num_put", oss.str(), std::string{"42 -7 ff FF 2.5 1E-07"});
+
+        oss.str("");
+        oss << std::nouppercase << std::hex << -255L << ' ' << -1LL << ' '
+            << std::oct << -8 << ' ' << -1LL << std::dec;
+        test_eq("num_put signed hex and oct", oss.str(),
+                std::string{"ffffffffffffff01 ffffffffffffffff 37777777770 "
+                            "1777777777777777777777"});
+
+        oss.str("");
+        oss << std::nouppercase;
+        oss.precision(3);
+        oss << std::fixed << 3.14159;
+        test_eq("num_put precision", oss.str(), std::string{"3.142"});
+
+        oss.str("");
+        oss.precision(6);
+        oss << 1e300;
+        auto str = oss.str();
+        test_eq("num_put large fixed pt1", str.size(), size_t{308});
+        test_eq(
+            "num_put large fixed pt2", str.substr(0, 20),
+            std::string{"10000000000000000525"}
+        );
+        test_eq("num_put large fixed pt3", str.substr(300), std::string{"0.000000"});
+
+        std::istringstream iss{"123 -45 2.5e2 0.125"};
+        int i{};
+        long l{};
+        double d1{}, d2{};
+        iss >> i >> l >> d1 >> d2;
+        test_eq("num_get int", i, 123);
+        test_eq("num_get long", l, -45L);
+        test_eq("num_get double pt1", d1, 250.0);
+        test_eq("num_get double pt2", d2, 0.125);
+
+        std::stringstream ss{};
+        ss << 20 << ' ' << 0.3;
+        ss >> i >> d1;
+        test_eq("stringstream read back pt1", d1, 0.3);
+
+        ss << ' ' << 42;
+        ss >> i;
+        test_eq("stringstream read back pt2", i, 42);
+    }
+
+    std::string charconv_test::to_str(double value)
+    {
+        char buf[400];
+        auto res = std::to_chars(buf, buf + sizeof(buf), value);
+
+        return std::string(buf, res.ptr);
+    }
+
+    std::string charconv_test::to_str(float value)
+    {
+        char buf[400];
+        auto res = std::to_chars(buf, buf + sizeof(buf), value);
+
+        return std::string(buf, res.ptr);
+    }
+
+    std::string charconv_test::to_str(double value, chars_format fmt)
+    {
+        char buf[400];
+        auto res = std::to_chars(buf, buf + sizeof(buf), value, fmt);
+
+        return std::string(buf, res.ptr);
+    }
+
+    std::string charconv_test::to_str(double value, chars_format fmt, int precision)
+    {
+        char buf[400];
+        auto res = std::to_chars(buf, buf + sizeof(buf), value, fmt, precision);
+
+        return std::string(buf, res.ptr);
+    }
+}
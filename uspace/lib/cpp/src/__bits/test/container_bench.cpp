@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace std::test
+{
+    namespace aux
+    {
+        /**
+         * Trivially copyable element larger than a word,
+         * which vector and deque move around with memcpy.
+         */
+        struct container_record
+        {
+            unsigned int key;
+            unsigned int payload[7];
+        };
+    }
+
+    bool container_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        benchmark_growth<unsigned int>("vector<unsigned int>");
+        benchmark_growth<aux::container_record>("vector<record>");
+        benchmark_growth<std::string>("vector<string>");
+        benchmark_insert_erase();
+        benchmark_deque();
+
+        return end();
+    }
+
+    const char* container_benchmark::name()
+    {
+        return "container benchmark";
+    }
+
+    template<class T>
+    void container_benchmark::benchmark_growth(const char* vec_name)
+    {
+        char bname[64];
+
+        std::vector<T> vec{};
+        std::snprintf(bname, sizeof(bname), "%s push_back", vec_name);
+        measure(bname, [&](){
+            for (size_t i = 0; i < element_count; ++i)
+                vec.push_back(T{});
+        });
+        test_eq(bname, vec.size(), element_count);
+
+        /**
+         * Number of reallocations that happened while the
+         * vector grew, shows the effect of the growth policy.
+         */
+        size_t reallocations{};
+        std::vector<T> counted{};
+        for (size_t i = 0; i < element_count; ++i)
+        {
+            auto capacity = counted.capacity();
+            counted.push_back(T{});
+            if (counted.capacity() != capacity)
+                ++reallocations;
+        }
+        std::snprintf(bname, sizeof(bname), "%s reallocations", vec_name);
+        report_value(bname, reallocations, "allocs");
+
+        std::vector<T> copy{};
+        std::snprintf(bname, sizeof(bname), "%s range insert", vec_name);
+        measure(bname, [&](){
+            for (size_t i = 0; i < round_count; ++i)
+                copy.insert(copy.end(), vec.begin(), vec.begin() + element_count / round_count);
+        });
+        test_eq(bname, copy.size(), (element_count / round_count) * round_count);
+
+        std::snprintf(bname, sizeof(bname), "%s copy", vec_name);
+        measure(bname, [&](){
+            for (size_t i = 0; i < round_count; ++i)
+            {
+                std::vector<T> tmp{vec};
+                copy.swap(tmp);
+            }
+        });
+        test_eq(bname, copy.size(), vec.size());
+    }
+
+    void container_benchmark::benchmark_insert_erase()
+    {
+        reseed();
+        std::vector<unsigned int> vec(element_count / 16);
+
+        /**
+         * Inserting and erasing in the middle shifts the
+         * elements after the position.
+         */
+        measure("vector<unsigned int> insert/erase middle", [&](){
+            for (size_t i = 0; i < shift_count; ++i)
+            {
+                auto pos = random() % vec.size();
+                vec.insert(vec.begin() + pos, i);
+                vec.erase(vec.begin() + (random() % vec.size()));
+            }
+        });
+        test_eq("vector<unsigned int> insert/erase middle", vec.size(), element_count / 16);
+    }
+
+    void container_benchmark::benchmark_deque()
+    {
+        std::deque<unsigned int> deq{};
+        measure("deque<unsigned int> push_back", [&](){
+            for (size_t i = 0; i < element_count; ++i)
+                deq.push_back(i);
+        });
+        test_eq("deque<unsigned int> push_back", deq.size(), element_count);
+
+        measure("deque<unsigned int> queue", [&](){
+            for (size_t i = 0; i < element_count; ++i)
+            {
+                deq.pop_front();
+                deq.push_back(i);
+            }
+        });
+        test_eq("deque<unsigned int> queue", deq.size(), element_count);
+
+        unsigned int sum{};
+        measure("deque<unsigned int> iterate", [&](){
+            for (auto x: deq)
+                sum += x;
+        });
+        test_eq("deque<unsigned int> iterate", sum, static_cast<unsigned int>(
+            element_count * (element_count - 1) / 2
+        ));
+
+        size_t size{};
+        measure("deque<unsigned int> copy", [&](){
+            for (size_t i = 0; i < round_count; ++i)
+            {
+                std::deque<unsigned int> tmp{deq};
+                size += tmp.size();
+            }
+        });
+        test_eq("deque<unsigned int> copy", size, element_count * round_count);
+
+        std::vector<aux::container_record> records(element_count);
+        measure("deque<record> range construction", [&](){
+            for (size_t i = 0; i < round_count; ++i)
+            {
+                std::deque<aux::container_record> tmp(records.begin(), records.end());
+                size += tmp.size();
+            }
+        });
+        test_eq("deque<record> range construction", size, 2 * element_count * round_count);
+    }
+}
@@ -29,7 +29,9 @@
 #include <__bits/test/tests.hpp>
 #include <deque>
 #include <initializer_list>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace std::test
 {
@@ -142,6 +144,29 @@ namespace std::test
             check3.begin(), check3.end(),
             d7.begin(), d7.end()
         );
+
+        // Spans several buckets.
+        std::vector<int> check4(3000);
+        for (size_t i = 0; i < check4.size(); ++i)
+            check4[i] = static_cast<int>(i);
+
+        std::deque<int> d8(check4.begin(), check4.end());
+        test_eq(
+            "multi bucket range construction",
+            check4.begin(), check4.end(),
+            d8.begin(), d8.end()
+        );
+
+        std::deque<int> d9{d8};
+        test_eq(
+            "multi bucket copy construction",
+            check4.begin(), check4.end(),
+            d9.begin(), d9.end()
+        );
+
+        std::deque<std::string> d10(check4.size(), std::string{"text"});
+        std::deque<std::string> d11{d10};
+        test_eq("multi bucket copy of strings", d10 == d11, true);
     }
 
     void deque_test::test_resizing()
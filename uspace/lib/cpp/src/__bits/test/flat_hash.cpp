@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <ext/flat_hash_map>
+#include <ext/flat_hash_set>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace std::test
+{
+    bool flat_hash_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_map();
+        test_set();
+        test_growth();
+        test_collisions();
+
+        return end();
+    }
+
+    const char* flat_hash_test::name()
+    {
+        return "flat_hash";
+    }
+
+    void flat_hash_test::test_map()
+    {
+        auto check1 = {1, 2, 3, 4, 5, 6, 7};
+        auto src1 = {
+            std::pair<const int, int>{3, 3},
+            std::pair<const int, int>{1, 1},
+            std::pair<const int, int>{5, 5},
+            std::pair<const int, int>{2, 2},
+            std::pair<const int, int>{7, 7},
+            std::pair<const int, int>{6, 6},
+            std::pair<const int, int>{4, 4}
+        };
+
+        std::ext::flat_hash_map<int, int> m1{src1};
+        test_contains("initializer list construction", check1.begin(), check1.end(), m1);
+        test_eq("size", m1.size(), 7U);
+
+        auto res1 = m1.insert(std::pair<const int, int>{3, 10});
+        test_eq("duplicate insert pt1", res1.second, false);
+        test_eq("duplicate insert pt2", res1.first->second, 3);
+
+        auto res2 = m1.emplace(8, 8);
+        test_eq("emplace pt1", res2.second, true);
+        test_eq("emplace pt2", res2.first->first, 8);
+
+        auto res3 = m1.insert_or_assign(8, 9);
+        test_eq("insert_or_assign existing pt1", res3.second, false);
+        test_eq("insert_or_assign existing pt2", m1[8], 9);
+
+        std::ext::flat_hash_map<int, std::string> m2{};
+        std::string str{"value"};
+        auto res4 = m2.try_emplace(1, std::move(str));
+        test_eq("try_emplace inserts", res4.second, true);
+        test_eq("try_emplace moves", str.empty(), true);
+
+        str = "value";
+        auto res5 = m2.try_emplace(1, std::move(str));
+        test_eq("try_emplace existing pt1", res5.second, false);
+        test_eq("try_emplace existing does not move", str, std::string{"value"});
+
+        m2[2] = "other";
+        test_eq("operator[] inserts", m2.at(2), std::string{"other"});
+        test_eq("count present", m2.count(2), 1U);
+        test_eq("count missing", m2.count(3), 0U);
+
+        std::ext::flat_hash_map<int, int> m3{m1};
+        test_eq("copy constructor", m3 == m1, true);
+
+        m3[1] = 42;
+        test_eq("copy is independent", m3 != m1, true);
+
+        std::ext::flat_hash_map<int, int> m4{std::move(m3)};
+        test_eq("move constructor pt1", m4[1], 42);
+        test_eq("move constructor pt2", m3.empty(), true);
+
+        test_eq("erase by key", m1.erase(5), 1U);
+        test_eq("erase missing key", m1.erase(5), 0U);
+        test_eq("find erased", m1.find(5) == m1.end(), true);
+
+        size_t visited{};
+        for (auto it = m1.begin(); it != m1.end(); ++it)
+            ++visited;
+        test_eq("iteration after erase", visited, m1.size());
+
+        m1.erase(m1.begin(), m1.end());
+        test_eq("erase range", m1.empty(), true);
+
+        m4.clear();
+        test_eq("clear", m4.empty(), true);
+        test_eq("clear keeps capacity", m4.bucket_count() > 0, true);
+    }
+
+    void flat_hash_test::test_set()
+    {
+        auto check1 = {1, 2, 3, 4, 5, 6, 7};
+        std::ext::flat_hash_set<int> s1{3, 1, 5, 2, 7, 6, 4, 4, 6};
+        test_contains("initializer list construction", check1.begin(), check1.end(), s1);
+        test_eq("duplicates ignored", s1.size(), 7U);
+
+        auto res1 = s1.insert(1);
+        test_eq("insert duplicate", res1.second, false);
+
+        auto res2 = s1.emplace(8);
+        test_eq("emplace pt1", res2.second, true);
+        test_eq("emplace pt2", *res2.first, 8);
+
+        auto it = s1.erase(s1.find(8));
+        test_eq("erase by iterator", s1.count(8), 0U);
+        test_eq("erase by iterator returns next", it == s1.end() || *it != 8, true);
+
+        std::ext::flat_hash_set<std::string> s2{};
+        s2.insert("a rather long string that is allocated on the heap");
+        s2.insert("short");
+        test_eq("string keys pt1", s2.count("short"), 1U);
+        test_eq(
+            "string keys pt2",
+            s2.count("a rather long string that is allocated on the heap"), 1U
+        );
+        test_eq("string keys pt3", s2.count("missing"), 0U);
+    }
+
+    void flat_hash_test::test_growth()
+    {
+        std::ext::flat_hash_map<int, int> map{};
+        constexpr int count{10'000};
+
+        for (int i = 0; i < count; ++i)
+            map[i] = i * 2;
+        test_eq("growth size", map.size(), static_cast<size_t>(count));
+        test("growth load factor", map.load_factor() <= map.max_load_factor());
+
+        bool all_found{true};
+        for (int i = 0; i < count; ++i)
+        {
+            auto it = map.find(i);
+            if (it == map.end() || it->second != i * 2)
+                all_found = false;
+        }
+        test("growth find all", all_found);
+
+        /**
+         * Leaves tombstones all over the table, which
+         * the following insertions have to reuse or
+         * clean up without growing indefinitely.
+         */
+        for (int round = 0; round < 10; ++round)
+        {
+            for (int i = 0; i < count; i += 2)
+                map.erase(i);
+            for (int i = 0; i < count; i += 2)
+                map[i] = i * 2;
+        }
+        test_eq("churn size", map.size(), static_cast<size_t>(count));
+        test("churn capacity", map.bucket_count() <= 4 * static_cast<size_t>(count));
+
+        all_found = true;
+        for (int i = 0; i < count; ++i)
+        {
+            if (map.count(i) != 1)
+                all_found = false;
+        }
+        test("churn find all", all_found);
+
+        std::ext::flat_hash_set<int> set{};
+        set.reserve(1000);
+        auto capacity = set.bucket_count();
+        for (int i = 0; i < 1000; ++i)
+            set.insert(i);
+        test_eq("reserve prevents rehash", set.bucket_count(), capacity);
+    }
+
+    void flat_hash_test::test_collisions()
+    {
+        /**
+         * With identity hashes, keys that differ only in bits
+         * above the capacity (after the 7 bits used for h2) all
+         * start probing at the same slot and share h2.
+         */
+        std::ext::flat_hash_set<int, std::aux::identity_hash<int>> set{};
+        set.reserve(64);
+        auto step = static_cast<int>(set.bucket_count()) << 7;
+
+        for (int i = 0; i < 32; ++i)
+            set.insert(i * step);
+        test_eq("colliding inserts", set.size(), 32U);
+
+        bool all_found{true};
+        for (int i = 0; i < 32; ++i)
+        {
+            if (set.count(i * step) != 1)
+                all_found = false;
+        }
+        test("colliding finds", all_found);
+
+        set.erase(0);
+        test_eq("colliding erase pt1", set.count(0), 0U);
+        test_eq("colliding erase pt2", set.count(31 * step), 1U);
+        test_eq("colliding miss", set.count(32 * step), 0U);
+    }
+}
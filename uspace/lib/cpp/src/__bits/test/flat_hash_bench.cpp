@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <cstdio>
+#include <ext/flat_hash_map>
+#include <unordered_map>
+#include <vector>
+
+namespace std::test
+{
+    namespace aux
+    {
+        /**
+         * Bytes used by the table itself and its elements,
+         * not counting the overhead of the allocator.
+         */
+        size_t map_footprint(const std::unordered_map<unsigned int, unsigned int>& map)
+        {
+            using value_type = std::unordered_map<unsigned int, unsigned int>::value_type;
+
+            return map.bucket_count() * sizeof(std::aux::hash_table_bucket<value_type, size_t>)
+                + map.size() * sizeof(std::aux::list_node<value_type>);
+        }
+
+        size_t map_footprint(const std::ext::flat_hash_map<unsigned int, unsigned int>& map)
+        {
+            using value_type = std::ext::flat_hash_map<unsigned int, unsigned int>::value_type;
+
+            return map.bucket_count() * (sizeof(value_type) + sizeof(std::aux::flat_ctrl_t))
+                + std::aux::flat_group::width;
+        }
+    }
+
+    bool flat_hash_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        reseed();
+        std::vector<unsigned int> keys(element_count);
+        for (auto& key: keys)
+            key = random();
+
+        /**
+         * Keys that are (almost certainly) not in the maps,
+         * for unsuccessful lookups.
+         */
+        std::vector<unsigned int> missing_keys(element_count);
+        for (auto& key: missing_keys)
+            key = random() | 1U;
+        for (auto& key: keys)
+            key &= ~1U;
+
+        benchmark_map<std::unordered_map<unsigned int, unsigned int>>(
+            "unordered_map", keys, missing_keys
+        );
+        benchmark_map<std::ext::flat_hash_map<unsigned int, unsigned int>>(
+            "flat_hash_map", keys, missing_keys
+        );
+
+        return end();
+    }
+
+    const char* flat_hash_benchmark::name()
+    {
+        return "flat_hash benchmark";
+    }
+
+    template<class Map>
+    void flat_hash_benchmark::benchmark_map(const char* map_name,
+                                            const std::vector<unsigned int>& keys,
+                                            const std::vector<unsigned int>& missing_keys)
+    {
+        char bname[64];
+        Map map{};
+
+        std::snprintf(bname, sizeof(bname), "%s insert", map_name);
+        measure(bname, [&](){
+            for (auto key: keys)
+                map[key] = key;
+        });
+
+        std::snprintf(bname, sizeof(bname), "%s memory", map_name);
+        report_value(bname, aux::map_footprint(map), "B");
+
+        size_t found{};
+        std::snprintf(bname, sizeof(bname), "%s successful find", map_name);
+        measure(bname, [&](){
+            for (auto key: keys)
+                found += map.count(key);
+        });
+        test_eq(bname, found, keys.size());
+
+        found = 0;
+        std::snprintf(bname, sizeof(bname), "%s unsuccessful find", map_name);
+        measure(bname, [&](){
+            for (auto key: missing_keys)
+                found += map.count(key);
+        });
+        test_eq(bname, found, 0U);
+
+        unsigned int sum{};
+        std::snprintf(bname, sizeof(bname), "%s iterate", map_name);
+        measure(bname, [&](){
+            for (const auto& val: map)
+                sum += val.second;
+        });
+
+        unsigned int expected_sum{};
+        for (const auto& val: map)
+            expected_sum += val.first;
+        test_eq(bname, sum, expected_sum);
+
+        std::snprintf(bname, sizeof(bname), "%s erase", map_name);
+        measure(bname, [&](){
+            for (auto key: keys)
+                map.erase(key);
+        });
+        test_eq(bname, map.empty(), true);
+    }
+}
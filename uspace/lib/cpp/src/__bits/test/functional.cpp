@@ -28,7 +28,9 @@
 
 #include <__bits/test/tests.hpp>
 #include <functional>
+#include <string>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 
 using namespace std::placeholders;
@@ -72,6 +74,7 @@ namespace std::test
         test_reference_wrapper();
         test_function();
         test_bind();
+        test_hash();
 
         return end();
     }
@@ -121,6 +124,42 @@ namespace std::test
         test("function operator bool", (bool)f2);
         f2 = nullptr;
         test("function nullptr assignment", !f2);
+
+        int (*null_ptr)(int, int){};
+        std::function<int(int, int)> f3{null_ptr};
+        test("function from null pointer", !f3);
+
+        test("function target_type", f1.target_type() == typeid(int (*)(int, int)));
+        test("function target", *f1.target<int (*)(int, int)>() == &aux::f1);
+        test("function target mismatch", f1.target<int>() == nullptr);
+
+        /**
+         * Note: The string and the captured array make the
+         *       lambda too large to be stored inline.
+         */
+        std::string str{"a string long enough to need the heap"};
+        long arr[8]{1, 2, 3, 4, 5, 6, 7, 8};
+        std::function<int(int, int)> f4{[str, arr](int a, int b){
+            return a + b + arr[7] + (int)str.size();
+        }};
+        auto f5 = f4;
+        test_eq("function large target", f4(1, 2), 48);
+        test_eq("function large target copy", f5(1, 2), 48);
+
+        f5.swap(f1);
+        test_eq("function swap pt1", f1(1, 2), 48);
+        test_eq("function swap pt2", f5(1, 2), 3);
+
+        auto f6 = std::move(f1);
+        test("function move leaves source empty", !f1);
+        test_eq("function move", f6(1, 2), 48);
+
+        f6 = &aux::f2;
+        test_eq("function callable assignment", f6(1, 2), 12);
+
+        aux::Foo foo{5};
+        std::function<int(aux::Foo&, int)> f7{&aux::Foo::add};
+        test_eq("function from member function pointer", f7(foo, 1), 6);
     }
 
     void functional_test::test_bind()
@@ -159,4 +198,47 @@ namespace std::test
 
         /* test_eq("bind to member function", res4, 19); */
     }
+
+    void functional_test::test_hash()
+    {
+        std::hash<int> int_hash{};
+        test_eq("hash deterministic", int_hash(42), int_hash(42));
+        test("hash is not identity", int_hash(42) != 42U);
+
+        std::hash<double> double_hash{};
+        test_eq("hash of both zeros", double_hash(0.0), double_hash(-0.0));
+
+        /**
+         * Pointers to aligned objects differ only in their
+         * higher bits, the mixed hash should still spread them
+         * over most of the buckets.
+         */
+        constexpr size_t bucket_count{64};
+        bool used[bucket_count]{};
+        std::hash<long long*> ptr_hash{};
+        alignas(16) static long long objects[bucket_count * 2];
+        for (size_t i = 0; i < bucket_count; ++i)
+            used[ptr_hash(&objects[i * 2]) % bucket_count] = true;
+
+        size_t used_count{};
+        for (auto u: used)
+            used_count += u ? 1 : 0;
+        test("hash spreads aligned pointers", used_count > bucket_count / 2);
+
+        std::hash<std::string> str_hash{};
+        std::string str1{"a string long enough to be hashed in bulk"};
+        std::string str2{str1};
+        test_eq("string hash equal", str_hash(str1), str_hash(str2));
+
+        str2[str2.size() - 1] = 'K';
+        test("string hash tail", str_hash(str1) != str_hash(str2));
+
+        str2 = str1;
+        str2[0] = 'A';
+        test("string hash head", str_hash(str1) != str_hash(str2));
+        test("string hash prefix", str_hash(str1) != str_hash(str1.substr(0, 8)));
+
+        std::aux::identity_hash<int> id_hash{};
+        test_eq("identity hash", id_hash(42), 42U);
+    }
 }
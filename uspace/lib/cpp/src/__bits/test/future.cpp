@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace std::test
+{
+    namespace aux
+    {
+        int square(int x)
+        {
+            return x * x;
+        }
+
+        /**
+         * Spawns more nested tasks than the pool has
+         * workers, each of them waiting for its child.
+         */
+        int nested_sum(int depth)
+        {
+            if (depth == 0)
+                return 0;
+
+            auto child = std::async(std::launch::async, nested_sum, depth - 1);
+
+            return depth + child.get();
+        }
+    }
+
+    bool future_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_promise();
+        test_shared_future();
+        test_packaged_task();
+        test_async();
+
+        return end();
+    }
+
+    const char* future_test::name()
+    {
+        return "future";
+    }
+
+    void future_test::test_promise()
+    {
+        std::promise<std::string> p1{};
+        auto f1 = p1.get_future();
+        test("promise future valid", f1.valid());
+
+        auto status = f1.wait_for(std::chrono::milliseconds{1});
+        test("future timeout", status == std::future_status::timeout);
+
+        p1.set_value("value");
+        status = f1.wait_for(std::chrono::milliseconds{1});
+        test("future ready", status == std::future_status::ready);
+        test_eq("promise set_value", f1.get(), std::string{"value"});
+        test("future invalid after get", !f1.valid());
+
+        int x{};
+        std::promise<int&> p2{};
+        auto f2 = p2.get_future();
+        p2.set_value(x);
+        f2.get() = 42;
+        test_eq("promise reference", x, 42);
+
+        std::promise<void> p3{};
+        auto f3 = p3.get_future();
+        p3.set_value();
+        f3.get();
+        test("promise void", !f3.valid());
+
+        std::promise<int> p4{};
+        auto f4 = p4.get_future();
+        auto p5 = std::move(p4);
+        p5.set_value(3);
+        test_eq("promise move", f4.get(), 3);
+    }
+
+    void future_test::test_shared_future()
+    {
+        std::promise<int> p1{};
+        auto sf1 = p1.get_future().share();
+        auto sf2 = sf1;
+        p1.set_value(7);
+
+        test_eq("shared_future get pt1", sf1.get(), 7);
+        test_eq("shared_future get pt2", sf2.get(), 7);
+        test("shared_future valid after get", sf1.valid());
+
+        std::promise<void> p2{};
+        std::shared_future<void> sf3{p2.get_future()};
+        p2.set_value();
+        sf3.wait();
+        test("shared_future void", sf3.valid());
+    }
+
+    void future_test::test_packaged_task()
+    {
+        std::packaged_task<int(int)> t1{aux::square};
+        test("packaged_task valid", t1.valid());
+
+        auto f1 = t1.get_future();
+        t1(5);
+        test_eq("packaged_task call", f1.get(), 25);
+
+        t1.reset();
+        auto f2 = t1.get_future();
+        t1(6);
+        test_eq("packaged_task reset", f2.get(), 36);
+
+        int x{};
+        std::packaged_task<void(int)> t2{[&x](int y){ x = y; }};
+        auto f3 = t2.get_future();
+        auto t3 = std::move(t2);
+        test("packaged_task move", !t2.valid() && t3.valid());
+
+        t3(4);
+        f3.get();
+        test_eq("packaged_task void", x, 4);
+    }
+
+    void future_test::test_async()
+    {
+        auto f1 = std::async(std::launch::async, aux::square, 9);
+        test_eq("async", f1.get(), 81);
+
+        bool ran{false};
+        auto f2 = std::async(std::launch::deferred, [&ran](){ ran = true; });
+        auto status = f2.wait_for(std::chrono::milliseconds{1});
+        test("async deferred status", status == std::future_status::deferred);
+        test("async deferred not run", !ran);
+        f2.get();
+        test("async deferred run", ran);
+
+        auto f3 = std::async([](std::string str){ return str + "!"; }, "hello");
+        test_eq("async default policy", f3.get(), std::string{"hello!"});
+
+        std::atomic<int> counter{0};
+        std::vector<std::future<int>> futures(100);
+        for (int i = 0; i < 100; ++i)
+        {
+            futures[i] = std::async(std::launch::async, [&counter](int i){
+                counter.fetch_add(1);
+
+                return i;
+            }, i);
+        }
+
+        int sum{};
+        for (auto& f: futures)
+            sum += f.get();
+        test_eq("async many tasks", sum, 4950);
+        test_eq("async all tasks run", counter.load(), 100);
+
+        /**
+         * Regression test: with a fixed number of workers
+         * this deadlocks unless waiting for a queued task
+         * runs it.
+         */
+        auto f4 = std::async(std::launch::async, aux::nested_sum, 32);
+        test_eq("async nested", f4.get(), 528);
+
+        {
+            auto f5 = std::async(std::launch::async, [&counter](){
+                counter = 0;
+            });
+        }
+        test_eq("async future destructor waits", counter.load(), 0);
+    }
+}
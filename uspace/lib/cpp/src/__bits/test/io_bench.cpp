@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace std::test
+{
+    bool io_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        std::vector<char> data(data_size);
+        size_t expected_sum{};
+        for (size_t i = 0; i < data_size; ++i)
+        {
+            // Printable lines of line_size characters.
+            if (i % line_size == line_size - 1)
+                data[i] = '\n';
+            else
+                data[i] = static_cast<char>('a' + random() % 26);
+            expected_sum += static_cast<unsigned char>(data[i]);
+        }
+
+        std::vector<std::string> lines(data_size / line_size);
+        for (size_t i = 0; i < lines.size(); ++i)
+            lines[i] = std::string(&data[i * line_size], line_size - 1);
+
+        auto elapsed = measure("ofstream write (blocks)", [&](){
+            std::ofstream out{file_name};
+            for (size_t i = 0; i < data_size; i += block_size)
+                out.write(&data[i], block_size);
+        });
+        report_throughput("ofstream write (blocks) throughput", elapsed);
+        test_eq("ofstream write (blocks)", checksum(), expected_sum);
+
+        elapsed = measure("ofstream write (lines)", [&](){
+            std::ofstream out{file_name};
+            for (const auto& line: lines)
+                out << line << '\n';
+        });
+        report_throughput("ofstream write (lines) throughput", elapsed);
+        test_eq("ofstream write (lines)", checksum(), expected_sum);
+
+        elapsed = measure("ofstream put", [&](){
+            std::ofstream out{file_name};
+            for (auto c: data)
+                out.put(c);
+        });
+        report_throughput("ofstream put throughput", elapsed);
+        test_eq("ofstream put", checksum(), expected_sum);
+
+        size_t sum{};
+        elapsed = measure("ifstream read (blocks)", [&](){
+            std::ifstream in{file_name};
+            std::vector<char> block(block_size);
+            while (in.read(block.data(), block_size) || in.gcount() > 0)
+            {
+                for (streamsize i = 0; i < in.gcount(); ++i)
+                    sum += static_cast<unsigned char>(block[i]);
+            }
+        });
+        report_throughput("ifstream read (blocks) throughput", elapsed);
+        test_eq("ifstream read (blocks)", sum, expected_sum);
+
+        sum = 0;
+        elapsed = measure("ifstream read (whole)", [&](){
+            std::ifstream in{file_name};
+            std::vector<char> buffer(data_size);
+            in.read(buffer.data(), data_size);
+            for (auto c: buffer)
+                sum += static_cast<unsigned char>(c);
+        });
+        report_throughput("ifstream read (whole) throughput", elapsed);
+        test_eq("ifstream read (whole)", sum, expected_sum);
+
+        sum = 0;
+        elapsed = measure("ifstream getline", [&](){
+            std::ifstream in{file_name};
+            std::string line{};
+            while (std::getline(in, line))
+            {
+                for (auto c: line)
+                    sum += static_cast<unsigned char>(c);
+                sum += static_cast<unsigned char>('\n');
+            }
+        });
+        report_throughput("ifstream getline throughput", elapsed);
+        test_eq("ifstream getline", sum, expected_sum);
+
+        sum = 0;
+        elapsed = measure("ifstream get", [&](){
+            std::ifstream in{file_name};
+            for (auto c = in.get(); c != char_traits<char>::eof(); c = in.get())
+                sum += static_cast<unsigned char>(c);
+        });
+        report_throughput("ifstream get throughput", elapsed);
+        test_eq("ifstream get", sum, expected_sum);
+
+        remove(file_name);
+
+        return end();
+    }
+
+    const char* io_benchmark::name()
+    {
+        return "io benchmark";
+    }
+
+    void io_benchmark::report_throughput(const char* bname, uint64_t usecs)
+    {
+        if (usecs == 0)
+            usecs = 1;
+
+        report_value(bname, data_size * 1'000'000ULL / 1024 / usecs, "KiB/s");
+    }
+
+    size_t io_benchmark::checksum()
+    {
+        /**
+         * Checked through stdio, so that a broken filebuf
+         * cannot verify its own output.
+         */
+        auto file = fopen(file_name, "r");
+        if (!file)
+            return 0;
+
+        size_t sum{};
+        for (auto c = fgetc(file); c != EOF; c = fgetc(file))
+            sum += static_cast<unsigned char>(c);
+        fclose(file);
+
+        return sum;
+    }
+}
@@ -28,6 +28,7 @@
 
 #include <__bits/test/tests.hpp>
 #include <initializer_list>
+#include <iterator>
 #include <list>
 #include <utility>
 
@@ -310,6 +311,12 @@ namespace std::test
             l6.begin(), l6.end()
         );
         test_eq("unique predicate size", l6.size(), 7U);
+
+        std::list<int> l7{1, 2, 3, 4};
+        auto it7 = l7.end();
+        std::advance(it7, -3);
+        test_eq("advance backwards", *it7, 2);
+        test_eq("prev", *std::prev(l7.end()), 4);
     }
 }
 
@@ -220,6 +220,17 @@ namespace std::test
         test_eq("erase root by iterator pt1", res14, map3.end());
         test_eq("erase root by iterator pt2", map3.empty(), true);
 
+        std::map<int, int> map4{{4, 4}, {2, 2}, {6, 6}, {5, 5}, {7, 7}};
+        auto res16 = map4.erase(map4.find(4));
+        test_eq("erase root with children pt1", res16->first, 5);
+        test_eq("erase root with children pt2", map4.size(), 4U);
+        test_eq("erase root with children pt3", map4.begin()->first, 2);
+
+        auto res17 = map4.erase(map4.find(6));
+        test_eq("erase inner node pt1", res17->first, 7);
+        test_eq("erase inner node pt2", map4.size(), 3U);
+        test_eq("erase inner node pt3", std::distance(map4.begin(), map4.end()), 3);
+
         map2.clear();
         test_eq("clear", map2.empty(), true);
 
@@ -28,9 +28,14 @@
 
 #include <__bits/test/mock.hpp>
 #include <__bits/test/tests.hpp>
+#include <ext/pool_allocator>
 #include <initializer_list>
+#include <list>
+#include <map>
 #include <memory>
+#include <set>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 
 namespace std::test
@@ -82,6 +87,63 @@ namespace std::test
             using propagate_on_container_swap            = std::true_type;
             using is_always_equal                        = std::true_type;
         };
+
+        inline std::size_t counting_allocations{};
+        inline std::size_t counting_deallocations{};
+
+        template<class T>
+        struct counting_allocator
+        {
+            using value_type = T;
+
+            counting_allocator() = default;
+
+            template<class U>
+            counting_allocator(const counting_allocator<U>&)
+            { /* DUMMY BODY */ }
+
+            T* allocate(std::size_t n)
+            {
+                ++counting_allocations;
+
+                return std::allocator<T>{}.allocate(n);
+            }
+
+            void deallocate(T* ptr, std::size_t n)
+            {
+                ++counting_deallocations;
+
+                std::allocator<T>{}.deallocate(ptr, n);
+            }
+        };
+
+        template<class T1, class T2>
+        bool operator==(const counting_allocator<T1>&, const counting_allocator<T2>&)
+        {
+            return true;
+        }
+
+        template<class T1, class T2>
+        bool operator!=(const counting_allocator<T1>&, const counting_allocator<T2>&)
+        {
+            return false;
+        }
+
+        struct counting_deleter
+        {
+            std::size_t* calls;
+
+            void operator()(mock* ptr)
+            {
+                ++*calls;
+                delete ptr;
+            }
+        };
+
+        struct mock_derived: mock
+        {
+            int value{42};
+        };
     }
 
     bool memory_test::run(bool report)
@@ -93,6 +155,8 @@ namespace std::test
         test_shared_ptr();
         test_weak_ptr();
         test_allocators();
+        test_node_allocators();
+        test_pool_allocator();
         test_pointers();
 
         return end();
@@ -177,6 +241,66 @@ namespace std::test
             test_eq("shared_ptr copy out of scope", mock::destructor_calls, 0U);
         }
         test_eq("shared_ptr original out of scope", mock::destructor_calls, 1U);
+
+        mock::clear();
+        aux::counting_allocations = 0U;
+        aux::counting_deallocations = 0U;
+        {
+            auto ptr1 = std::allocate_shared<mock>(aux::counting_allocator<mock>{});
+            test_eq("allocate_shared single allocation", aux::counting_allocations, 1U);
+            test_eq("allocate_shared constructs", mock::constructor_calls, 1U);
+
+            auto ptr2 = ptr1;
+            test_eq("allocate_shared copy no allocation", aux::counting_allocations, 1U);
+        }
+        test_eq("allocate_shared destroys", mock::destructor_calls, 1U);
+        test_eq("allocate_shared deallocates", aux::counting_deallocations, 1U);
+
+        mock::clear();
+        {
+            auto ptr1 = std::make_shared<aux::mock_derived>();
+            std::shared_ptr<mock> ptr2{ptr1};
+            test_eq("shared_ptr conversion shares count", ptr1.use_count(), 2L);
+            test_eq("shared_ptr conversion pointer", ptr2.get(), static_cast<mock*>(ptr1.get()));
+
+            std::shared_ptr<int> ptr3{ptr1, &ptr1->value};
+            test_eq("shared_ptr aliasing", *ptr3, 42);
+            test_eq("shared_ptr aliasing shares count", ptr1.use_count(), 3L);
+
+            ptr1.reset();
+            ptr2.reset();
+            test_eq("shared_ptr aliasing keeps object", mock::destructor_calls, 0U);
+        }
+        test_eq("shared_ptr aliasing out of scope", mock::destructor_calls, 1U);
+
+        mock::clear();
+        {
+            std::size_t calls{};
+            std::shared_ptr<mock> ptr1{new mock{}, aux::counting_deleter{&calls}};
+            test_eq("shared_ptr with deleter get", (bool)ptr1, true);
+
+            auto deleter = std::get_deleter<aux::counting_deleter>(ptr1);
+            test_eq("get_deleter", deleter != nullptr, true);
+            test_eq("get_deleter wrong type", std::get_deleter<int>(ptr1) == nullptr, true);
+
+            ptr1.reset();
+            test_eq("shared_ptr deleter called", calls, 1U);
+        }
+        test_eq("shared_ptr deleter destroys", mock::destructor_calls, 1U);
+
+        mock::clear();
+        aux::counting_allocations = 0U;
+        aux::counting_deallocations = 0U;
+        {
+            std::size_t calls{};
+            std::shared_ptr<mock> ptr1{
+                new mock{}, aux::counting_deleter{&calls},
+                aux::counting_allocator<mock>{}
+            };
+            test_eq("shared_ptr allocator used", aux::counting_allocations, 1U);
+        }
+        test_eq("shared_ptr allocator deallocates", aux::counting_deallocations, 1U);
+        test_eq("shared_ptr allocator deleter destroys", mock::destructor_calls, 1U);
     }
 
     void memory_test::test_weak_ptr()
@@ -198,6 +322,12 @@ namespace std::test
             }
             test_eq("weak_ptr expired after all shared_ptrs die", wptr1.expired(), true);
             test_eq("shared object destroyed while weak_ptr exists", mock::destructor_calls, 1U);
+
+            auto ptr = wptr1.lock();
+            test_eq("lock of expired weak_ptr", (bool)ptr, false);
+
+            std::weak_ptr<mock> wptr2{};
+            test_eq("lock of empty weak_ptr", (bool)wptr2.lock(), false);
         }
     }
 
@@ -298,6 +428,117 @@ namespace std::test
         );
     }
 
+    void memory_test::test_node_allocators()
+    {
+        aux::counting_allocations = 0U;
+        aux::counting_deallocations = 0U;
+        {
+            std::map<int, int, std::less<int>, aux::counting_allocator<std::pair<const int, int>>> m{};
+            for (int i = 0; i < 10; ++i)
+                m[i] = i;
+            m.erase(3);
+            m.emplace(20, 20);
+
+            test_eq("map allocates nodes through allocator", aux::counting_allocations, 11U);
+            test_eq("map frees erased node through allocator", aux::counting_deallocations, 1U);
+        }
+        test_eq("map frees all nodes", aux::counting_deallocations, aux::counting_allocations);
+
+        aux::counting_allocations = 0U;
+        aux::counting_deallocations = 0U;
+        {
+            std::multiset<int, std::less<int>, aux::counting_allocator<int>> s{1, 2, 2, 2, 3};
+            auto copy = s;
+
+            test_eq("multiset allocates nodes through allocator", aux::counting_allocations, 10U);
+            test_eq("multiset copy", copy.size(), 5U);
+        }
+        test_eq("multiset frees all nodes", aux::counting_deallocations, aux::counting_allocations);
+
+        aux::counting_allocations = 0U;
+        aux::counting_deallocations = 0U;
+        {
+            std::list<int, aux::counting_allocator<int>> l{1, 2, 3};
+            l.push_back(4);
+            l.push_front(0);
+            l.pop_back();
+
+            test_eq("list allocates nodes through allocator", aux::counting_allocations, 5U);
+            test_eq("list frees popped node through allocator", aux::counting_deallocations, 1U);
+            test_eq("list contents after pop_back", l.back(), 3);
+        }
+        test_eq("list frees all nodes", aux::counting_deallocations, aux::counting_allocations);
+
+        aux::counting_allocations = 0U;
+        aux::counting_deallocations = 0U;
+        {
+            std::unordered_map<
+                int, int, std::hash<int>, std::equal_to<int>,
+                aux::counting_allocator<std::pair<const int, int>>
+            > m{};
+            for (int i = 0; i < 100; ++i)
+                m.emplace(i, i);
+            m.erase(42);
+
+            test_eq("unordered_map allocates nodes through allocator", aux::counting_allocations, 100U);
+            test_eq("unordered_map frees erased node through allocator", aux::counting_deallocations, 1U);
+            test_eq("unordered_map rehash keeps elements", m.size(), 99U);
+        }
+        test_eq("unordered_map frees all nodes", aux::counting_deallocations, aux::counting_allocations);
+    }
+
+    void memory_test::test_pool_allocator()
+    {
+        using alloc_type = std::ext::pool_allocator<std::pair<const int, int>>;
+        using map_type   = std::map<int, int, std::less<int>, alloc_type>;
+
+        alloc_type alloc{};
+        auto pool = alloc.pool();
+
+        map_type m1{alloc};
+        for (int i = 0; i < 1000; ++i)
+            m1[i] = i;
+        test_eq("pool_allocator map size", m1.size(), 1000U);
+        test_eq("pool_allocator map lookup", m1[500], 500);
+
+        auto slabs = pool->slab_count();
+        test("pool_allocator uses slabs", slabs > 0U && slabs < 1000U);
+
+        m1.clear();
+        for (int i = 0; i < 1000; ++i)
+            m1[i] = -i;
+        test_eq("pool_allocator reuses freed nodes", pool->slab_count(), slabs);
+
+        map_type m2{m1};
+        test_eq("pool_allocator copy shares pool", m2.get_allocator().pool(), pool);
+        test_eq("pool_allocator copy contents", m2[999], -999);
+
+        std::set<int, std::less<int>, std::ext::pool_allocator<int>> s1{};
+        std::set<int, std::less<int>, std::ext::pool_allocator<int>> s2{};
+        test("pool_allocator default constructed pools differ",
+             s1.get_allocator() != s2.get_allocator());
+
+        s1.insert(1);
+        s2 = s1;
+        test("pool_allocator copy assignment propagates",
+             s1.get_allocator() == s2.get_allocator());
+
+        std::list<int, std::ext::pool_allocator<int>> l1{1, 2, 3};
+        std::list<int, std::ext::pool_allocator<int>> l2{4, 5};
+        l1.swap(l2);
+        test_eq("pool_allocator swap propagates", l1.size(), 2U);
+        l1.push_back(6);
+        test_eq("pool_allocator swapped list usable", l1.back(), 6);
+
+        std::ext::pool_allocator<long> rebound{alloc};
+        test_eq("pool_allocator rebind shares pool", rebound.pool(), pool);
+
+        slabs = pool->slab_count();
+        auto big = rebound.allocate(1000);
+        test_eq("pool_allocator large request bypasses pool", pool->slab_count(), slabs);
+        rebound.deallocate(big, 1000);
+    }
+
     void memory_test::test_pointers()
     {
         using dummy_traits1 = std::pointer_traits<aux::dummy_pointer1>;
@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace std::test
+{
+    namespace aux
+    {
+        /**
+         * Upstream resource that records the traffic
+         * it receives from the resource under test.
+         */
+        class counting_resource: public std::pmr::memory_resource
+        {
+            public:
+                std::size_t allocations{};
+                std::size_t deallocations{};
+                std::size_t bytes_in_use{};
+
+            protected:
+                void* do_allocate(std::size_t bytes, std::size_t alignment) override
+                {
+                    ++allocations;
+                    bytes_in_use += bytes;
+
+                    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+                }
+
+                void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+                {
+                    ++deallocations;
+                    bytes_in_use -= bytes;
+
+                    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+                }
+
+                bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+                {
+                    return this == &other;
+                }
+        };
+
+        inline bool is_aligned(void* ptr, std::size_t alignment)
+        {
+            return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+        }
+    }
+
+    bool memory_resource_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_global_resources();
+        test_monotonic_buffer_resource();
+        test_pool_resources();
+        test_polymorphic_allocator();
+        test_containers();
+
+        return end();
+    }
+
+    const char* memory_resource_test::name()
+    {
+        return "memory_resource";
+    }
+
+    void memory_resource_test::test_global_resources()
+    {
+        auto nd = std::pmr::new_delete_resource();
+        test_eq("new_delete_resource is a singleton", nd, std::pmr::new_delete_resource());
+        test_eq("default resource is new_delete", std::pmr::get_default_resource(), nd);
+
+        auto ptr = nd->allocate(100);
+        test("new_delete_resource allocate", ptr != nullptr);
+        nd->deallocate(ptr, 100);
+
+        ptr = nd->allocate(100, 256);
+        test("new_delete_resource over-aligned", aux::is_aligned(ptr, 256));
+        nd->deallocate(ptr, 100, 256);
+
+        auto null = std::pmr::null_memory_resource();
+        test_eq("null_memory_resource allocate", null->allocate(1), nullptr);
+        test("null resource differs from new_delete", *null != *nd);
+
+        aux::counting_resource res{};
+        auto old = std::pmr::set_default_resource(&res);
+        test_eq("set_default_resource returns previous", old, nd);
+        test_eq("get_default_resource after set", std::pmr::get_default_resource(),
+                static_cast<std::pmr::memory_resource*>(&res));
+
+        old = std::pmr::set_default_resource(nullptr);
+        test_eq("set_default_resource returns previous pt2", old,
+                static_cast<std::pmr::memory_resource*>(&res));
+        test_eq("set_default_resource(nullptr) restores new_delete",
+                std::pmr::get_default_resource(), nd);
+    }
+
+    void memory_resource_test::test_monotonic_buffer_resource()
+    {
+        aux::counting_resource upstream{};
+        alignas(16) char buffer[256];
+
+        {
+            std::pmr::monotonic_buffer_resource res{buffer, sizeof(buffer), &upstream};
+            test_eq("monotonic upstream_resource", res.upstream_resource(),
+                    static_cast<std::pmr::memory_resource*>(&upstream));
+
+            auto p1 = static_cast<char*>(res.allocate(10, 1));
+            auto p2 = static_cast<char*>(res.allocate(8, 8));
+            test("monotonic uses the initial buffer", p1 >= buffer && p2 < buffer + sizeof(buffer));
+            test("monotonic alignment", aux::is_aligned(p2, 8));
+            test("monotonic bumps the pointer", p2 >= p1 + 10);
+            test_eq("monotonic buffer no upstream", upstream.allocations, 0U);
+
+            res.deallocate(p1, 10, 1);
+            auto p3 = static_cast<char*>(res.allocate(10, 1));
+            test("monotonic deallocate is a no-op", p3 != p1);
+
+            res.allocate(1000);
+            test_eq("monotonic overflow goes upstream", upstream.allocations, 1U);
+
+            for (int i = 0; i < 100; ++i)
+                res.allocate(100);
+            test("monotonic chunks grow geometrically", upstream.allocations < 10U);
+
+            res.release();
+            test_eq("monotonic release", upstream.bytes_in_use, 0U);
+            test_eq("monotonic release frees all chunks", upstream.deallocations,
+                    upstream.allocations);
+
+            auto p4 = static_cast<char*>(res.allocate(10, 1));
+            test_eq("monotonic release reuses the buffer", p4, buffer);
+            res.allocate(512);
+        }
+        test_eq("monotonic destructor", upstream.bytes_in_use, 0U);
+
+        upstream.allocations = 0U;
+        {
+            std::pmr::monotonic_buffer_resource res{4096, &upstream};
+            for (int i = 0; i < 64; ++i)
+                res.allocate(32);
+            test_eq("monotonic initial_size", upstream.allocations, 1U);
+
+            auto ptr = res.allocate(64, 64);
+            test("monotonic large alignment", aux::is_aligned(ptr, 64));
+        }
+        test_eq("monotonic initial_size destructor", upstream.bytes_in_use, 0U);
+    }
+
+    void memory_resource_test::test_pool_resources()
+    {
+        aux::counting_resource upstream{};
+
+        {
+            std::pmr::unsynchronized_pool_resource res{
+                std::pmr::pool_options{64, 500}, &upstream
+            };
+            auto bookkeeping = upstream.bytes_in_use;
+
+            auto opts = res.options();
+            test_eq("pool options max_blocks_per_chunk", opts.max_blocks_per_chunk, 64U);
+            test_eq("pool options largest block rounded up",
+                    opts.largest_required_pool_block, 512U);
+
+            auto p1 = res.allocate(24);
+            auto p2 = res.allocate(24);
+            test("pool distinct blocks", p1 != p2);
+            test("pool block alignment", aux::is_aligned(p1, 8) && aux::is_aligned(p2, 8));
+
+            auto allocs = upstream.allocations;
+            res.deallocate(p1, 24);
+            auto p3 = res.allocate(20);
+            test_eq("pool reuses freed blocks", p3, p1);
+            test_eq("pool reuse no upstream", upstream.allocations, allocs);
+
+            void* ptrs[1000];
+            for (auto& ptr: ptrs)
+                ptr = res.allocate(16);
+            test("pool chunk growth", upstream.allocations - allocs < 30U);
+            for (auto& ptr: ptrs)
+                res.deallocate(ptr, 16);
+
+            allocs = upstream.allocations;
+            auto large = res.allocate(2000);
+            test_eq("pool large blocks go upstream", upstream.allocations, allocs + 1U);
+            res.deallocate(large, 2000);
+            test_eq("pool large blocks are freed", upstream.deallocations, 1U);
+
+            large = res.allocate(2000, 128);
+            test("pool over-aligned large block", aux::is_aligned(large, 128));
+            auto aligned = res.allocate(32, 64);
+            test("pool over-aligned small block", aux::is_aligned(aligned, 64));
+
+            res.release();
+            test_eq("pool release", upstream.bytes_in_use, bookkeeping);
+
+            res.allocate(8);
+        }
+        test_eq("pool destructor", upstream.bytes_in_use, 0U);
+        test_eq("pool destructor frees all", upstream.deallocations, upstream.allocations);
+
+        {
+            std::pmr::synchronized_pool_resource res{&upstream};
+            test_eq("synchronized pool default options",
+                    res.options().largest_required_pool_block > 0U, true);
+
+            auto p1 = res.allocate(100);
+            res.deallocate(p1, 100);
+            auto p2 = res.allocate(100);
+            test_eq("synchronized pool reuse", p2, p1);
+            test("synchronized pool is_equal", res == res);
+        }
+        test_eq("synchronized pool destructor", upstream.bytes_in_use, 0U);
+    }
+
+    void memory_resource_test::test_polymorphic_allocator()
+    {
+        aux::counting_resource res{};
+
+        std::pmr::polymorphic_allocator<int> a1{&res};
+        std::pmr::polymorphic_allocator<int> a2{};
+        std::pmr::polymorphic_allocator<long> a3{a1};
+        test_eq("polymorphic_allocator resource", a1.resource(),
+                static_cast<std::pmr::memory_resource*>(&res));
+        test_eq("polymorphic_allocator default resource", a2.resource(),
+                std::pmr::get_default_resource());
+        test("polymorphic_allocator rebind equality", a1 == a3);
+        test("polymorphic_allocator inequality", a1 != a2);
+
+        auto ptr = a1.allocate(10);
+        test_eq("polymorphic_allocator allocate", res.bytes_in_use, 10 * sizeof(int));
+        a1.deallocate(ptr, 10);
+        test_eq("polymorphic_allocator deallocate", res.bytes_in_use, 0U);
+
+        auto copy = a1.select_on_container_copy_construction();
+        test_eq("polymorphic_allocator select_on_container_copy_construction",
+                copy.resource(), std::pmr::get_default_resource());
+
+        /**
+         * Uses-allocator construction propagates the
+         * resource into elements that are allocator aware.
+         */
+        std::pmr::polymorphic_allocator<std::pmr::string> sa{&res};
+        auto str = sa.allocate(1);
+        sa.construct(str, "uses-allocator construction");
+        test_eq("polymorphic_allocator uses-allocator construct",
+                str->get_allocator().resource(),
+                static_cast<std::pmr::memory_resource*>(&res));
+        test_eq("polymorphic_allocator construct value",
+                *str == "uses-allocator construction", true);
+        sa.destroy(str);
+        sa.deallocate(str, 1);
+        test_eq("polymorphic_allocator destroy", res.bytes_in_use, 0U);
+    }
+
+    void memory_resource_test::test_containers()
+    {
+        aux::counting_resource upstream{};
+
+        {
+            std::pmr::monotonic_buffer_resource res{&upstream};
+
+            std::pmr::vector<int> vec{&res};
+            vec.reserve(100);
+            for (int i = 0; i < 100; ++i)
+                vec.push_back(i);
+            test_eq("pmr::vector uses the resource", upstream.allocations > 0U, true);
+            test_eq("pmr::vector values", vec[99], 99);
+
+            std::pmr::string str{"a string long enough to need memory", &res};
+            test_eq("pmr::string resource", str.get_allocator().resource(),
+                    static_cast<std::pmr::memory_resource*>(&res));
+
+            std::pmr::list<int> lst{&res};
+            for (int i = 0; i < 100; ++i)
+                lst.push_back(i);
+            test_eq("pmr::list size", lst.size(), 100U);
+        }
+        test_eq("pmr containers monotonic release", upstream.bytes_in_use, 0U);
+
+        {
+            std::pmr::unsynchronized_pool_resource res{&upstream};
+
+            std::pmr::map<int, int> m1{&res};
+            for (int i = 0; i < 100; ++i)
+                m1[i] = i;
+            test_eq("pmr::map size", m1.size(), 100U);
+            test_eq("pmr::map lookup", m1[42], 42);
+
+            auto allocs = upstream.allocations;
+            for (int i = 0; i < 100; ++i)
+                m1.erase(i);
+            for (int i = 0; i < 100; ++i)
+                m1[i] = i;
+            test_eq("pmr::map reuses pooled nodes", upstream.allocations, allocs);
+
+            std::pmr::map<int, int> m2{&res};
+            m2 = m1;
+            test_eq("pmr::map copy assignment", m2.size(), 100U);
+            test_eq("pmr::map copy assignment keeps resource",
+                    m2.get_allocator().resource(),
+                    static_cast<std::pmr::memory_resource*>(&res));
+
+            std::pmr::map<int, int> m3{std::move(m1)};
+            test_eq("pmr::map move", m3.size(), 100U);
+
+            std::pmr::unordered_map<int, int> um{&res};
+            for (int i = 0; i < 100; ++i)
+                um[i] = i;
+            test_eq("pmr::unordered_map size", um.size(), 100U);
+            test_eq("pmr::unordered_map lookup", um[7], 7);
+
+            std::pmr::unordered_map<int, int> um2{};
+            um2 = um;
+            test_eq("pmr::unordered_map copy to other resource", um2.size(), 100U);
+            test_eq("pmr::unordered_map keeps its resource",
+                    um2.get_allocator().resource(), std::pmr::get_default_resource());
+        }
+        test_eq("pmr containers pool release", upstream.bytes_in_use, 0U);
+    }
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace std::test
+{
+    namespace aux
+    {
+        /**
+         * Locks the mutex in another thread and holds it
+         * until released.
+         */
+        template<class Mutex, bool Shared = false>
+        class lock_holder
+        {
+            public:
+                lock_holder(Mutex& mtx)
+                    : locked_{false}, release_{false}, thread_{}
+                {
+                    thread_ = std::thread{[this, &mtx](){
+                        if constexpr (Shared)
+                            mtx.lock_shared();
+                        else
+                            mtx.lock();
+                        locked_ = true;
+
+                        while (!release_)
+                            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+                        if constexpr (Shared)
+                            mtx.unlock_shared();
+                        else
+                            mtx.unlock();
+                    }};
+
+                    while (!locked_)
+                        std::this_thread::yield();
+                }
+
+                ~lock_holder()
+                {
+                    release();
+                }
+
+                void release()
+                {
+                    release_ = true;
+                    if (thread_.joinable())
+                        thread_.join();
+                }
+
+            private:
+                std::atomic<bool> locked_;
+                std::atomic<bool> release_;
+                std::thread thread_;
+        };
+
+        /**
+         * Releases the holder from yet another thread after
+         * the given delay.
+         */
+        template<class Holder>
+        std::thread release_after(Holder& holder, std::chrono::milliseconds delay)
+        {
+            return std::thread{[&holder, delay](){
+                std::this_thread::sleep_for(delay);
+                holder.release();
+            }};
+        }
+    }
+
+    bool mutex_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_timed_mutex();
+        test_recursive_timed_mutex();
+        test_shared_timed_mutex();
+
+        return end();
+    }
+
+    const char* mutex_test::name()
+    {
+        return "mutex";
+    }
+
+    void mutex_test::test_timed_mutex()
+    {
+        std::timed_mutex mtx{};
+
+        test("timed_mutex try_lock_for unlocked", mtx.try_lock_for(timeout));
+        mtx.unlock();
+
+        {
+            aux::lock_holder<std::timed_mutex> holder{mtx};
+
+            test("timed_mutex try_lock locked", !mtx.try_lock());
+
+            auto start = std::chrono::steady_clock::now();
+            test("timed_mutex try_lock_for timeout", !mtx.try_lock_for(timeout));
+            test("timed_mutex try_lock_for waits", std::chrono::steady_clock::now() - start >= timeout);
+
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            test("timed_mutex try_lock_until timeout", !mtx.try_lock_until(deadline));
+            test("timed_mutex try_lock_until waits", std::chrono::steady_clock::now() >= deadline);
+
+            test("timed_mutex try_lock_for zero", !mtx.try_lock_for(std::chrono::milliseconds{0}));
+        }
+
+        {
+            aux::lock_holder<std::timed_mutex> holder{mtx};
+            auto releaser = aux::release_after(holder, timeout);
+
+            test("timed_mutex try_lock_for handover", mtx.try_lock_for(long_timeout));
+            mtx.unlock();
+            releaser.join();
+        }
+
+        std::unique_lock<std::timed_mutex> lock{mtx, timeout};
+        test("unique_lock timed", lock.owns_lock());
+    }
+
+    void mutex_test::test_recursive_timed_mutex()
+    {
+        std::recursive_timed_mutex mtx{};
+
+        test("recursive_timed_mutex try_lock_for", mtx.try_lock_for(timeout));
+        test("recursive_timed_mutex try_lock_for again", mtx.try_lock_for(timeout));
+        mtx.unlock();
+        mtx.unlock();
+
+        // Both levels have to be released for another thread to get in.
+        aux::lock_holder<std::recursive_timed_mutex> holder{mtx};
+        test("recursive_timed_mutex try_lock_for locked", !mtx.try_lock_for(timeout));
+        holder.release();
+
+        test("recursive_timed_mutex try_lock_for released", mtx.try_lock_for(timeout));
+        mtx.unlock();
+    }
+
+    void mutex_test::test_shared_timed_mutex()
+    {
+        std::shared_timed_mutex mtx{};
+
+        mtx.lock_shared();
+        test("shared_timed_mutex try_lock_shared", mtx.try_lock_shared());
+        test("shared_timed_mutex try_lock shared", !mtx.try_lock());
+        test("shared_timed_mutex try_lock_for shared", !mtx.try_lock_for(timeout));
+        mtx.unlock_shared();
+        mtx.unlock_shared();
+
+        test("shared_timed_mutex try_lock", mtx.try_lock());
+        test("shared_timed_mutex try_lock_shared locked", !mtx.try_lock_shared());
+        mtx.unlock();
+
+        {
+            aux::lock_holder<std::shared_timed_mutex> holder{mtx};
+
+            auto start = std::chrono::steady_clock::now();
+            test("shared_timed_mutex try_lock_shared_for timeout", !mtx.try_lock_shared_for(timeout));
+            test("shared_timed_mutex try_lock_shared_for waits", std::chrono::steady_clock::now() - start >= timeout);
+        }
+
+        {
+            aux::lock_holder<std::shared_timed_mutex, true> holder{mtx};
+            test("shared_timed_mutex try_lock_shared_for shared", mtx.try_lock_shared_for(timeout));
+            mtx.unlock_shared();
+
+            auto releaser = aux::release_after(holder, timeout);
+            test("shared_timed_mutex try_lock_for handover", mtx.try_lock_for(long_timeout));
+            mtx.unlock();
+            releaser.join();
+        }
+
+        std::shared_lock<std::shared_timed_mutex> lock{mtx, timeout};
+        test("shared_lock timed", lock.owns_lock());
+    }
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <cstdio>
+#include <ext/pool_allocator>
+#include <list>
+#include <map>
+#include <vector>
+
+namespace std::test
+{
+    bool node_alloc_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        reseed();
+        std::vector<unsigned int> keys(element_count);
+        for (auto& key: keys)
+            key = random();
+
+        using value_type = std::pair<const unsigned int, unsigned int>;
+        benchmark_map<std::map<unsigned int, unsigned int>>(
+            "map<allocator>", keys
+        );
+        benchmark_map<std::map<
+            unsigned int, unsigned int, std::less<unsigned int>,
+            std::ext::pool_allocator<value_type>
+        >>("map<pool_allocator>", keys);
+
+        benchmark_list<std::list<unsigned int>>("list<allocator>");
+        benchmark_list<std::list<
+            unsigned int, std::ext::pool_allocator<unsigned int>
+        >>("list<pool_allocator>");
+
+        return end();
+    }
+
+    const char* node_alloc_benchmark::name()
+    {
+        return "node allocation benchmark";
+    }
+
+    template<class Map>
+    void node_alloc_benchmark::benchmark_map(const char* map_name,
+                                             const std::vector<unsigned int>& keys)
+    {
+        char bname[64];
+        Map map{};
+
+        std::snprintf(bname, sizeof(bname), "%s insert", map_name);
+        measure(bname, [&](){
+            for (auto key: keys)
+                map[key] = key;
+        });
+
+        /**
+         * Erase and insert half of the elements, this
+         * is where freed nodes get reused.
+         */
+        std::snprintf(bname, sizeof(bname), "%s churn", map_name);
+        measure(bname, [&](){
+            for (size_t i = 0; i < keys.size(); i += 2)
+                map.erase(keys[i]);
+            for (size_t i = 0; i < keys.size(); i += 2)
+                map[keys[i]] = keys[i];
+        });
+
+        unsigned int sum{};
+        std::snprintf(bname, sizeof(bname), "%s iterate", map_name);
+        measure(bname, [&](){
+            for (const auto& val: map)
+                sum += val.second;
+        });
+
+        unsigned int expected_sum{};
+        for (const auto& val: map)
+            expected_sum += val.first;
+        test_eq(bname, sum, expected_sum);
+
+        std::snprintf(bname, sizeof(bname), "%s clear", map_name);
+        measure(bname, [&](){
+            map.clear();
+        });
+        test_eq(bname, map.empty(), true);
+    }
+
+    template<class List>
+    void node_alloc_benchmark::benchmark_list(const char* list_name)
+    {
+        char bname[64];
+        List list{};
+
+        std::snprintf(bname, sizeof(bname), "%s push_back", list_name);
+        measure(bname, [&](){
+            for (size_t i = 0; i < element_count; ++i)
+                list.push_back(i);
+        });
+
+        std::snprintf(bname, sizeof(bname), "%s queue", list_name);
+        measure(bname, [&](){
+            for (size_t i = 0; i < element_count; ++i)
+            {
+                list.pop_front();
+                list.push_back(i);
+            }
+        });
+        test_eq(bname, list.size(), element_count);
+
+        std::snprintf(bname, sizeof(bname), "%s clear", list_name);
+        measure(bname, [&](){
+            list.clear();
+        });
+        test_eq(bname, list.empty(), true);
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+namespace std::test
+{
+    bool numconv_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        reseed();
+        std::vector<long long> ints(element_count);
+        for (auto& x: ints)
+        {
+            // Mix of magnitudes, so that all digit counts are exercised.
+            auto shift = random() % 63;
+            x = static_cast<long long>(
+                ((static_cast<uint64_t>(random()) << 32) | random()) >> shift
+            );
+            if (random() % 2)
+                x = -x;
+        }
+
+        std::vector<double> doubles(element_count);
+        for (auto& x: doubles)
+        {
+            auto mantissa = static_cast<double>(random()) / 0xFFFF'FFFFU;
+            x = mantissa * static_cast<double>(random() % 100'000) - 50'000.0;
+        }
+
+        char buf[64];
+        size_t snprintf_len{};
+        measure("integer snprintf", [&](){
+            for (auto x: ints)
+                snprintf_len += snprintf(buf, sizeof(buf), "%lld", x);
+        });
+
+        size_t to_chars_len{};
+        measure("integer to_chars", [&](){
+            for (auto x: ints)
+                to_chars_len += std::to_chars(buf, buf + sizeof(buf), x).ptr - buf;
+        });
+        test_eq("integer to_chars length", to_chars_len, snprintf_len);
+
+        std::vector<std::string> int_strs(element_count);
+        for (size_t i = 0; i < element_count; ++i)
+        {
+            auto res = std::to_chars(buf, buf + sizeof(buf), ints[i]);
+            int_strs[i] = std::string(buf, res.ptr);
+        }
+
+        long long strtoll_sum{};
+        measure("integer strtoll", [&](){
+            for (const auto& str: int_strs)
+                strtoll_sum += hel::strtoll(str.c_str(), nullptr, 10);
+        });
+
+        long long from_chars_sum{};
+        measure("integer from_chars", [&](){
+            for (const auto& str: int_strs)
+            {
+                long long tmp{};
+                std::from_chars(str.c_str(), str.c_str() + str.size(), tmp);
+                from_chars_sum += tmp;
+            }
+        });
+        test_eq("integer from_chars sum", from_chars_sum, strtoll_sum);
+
+        snprintf_len = 0;
+        measure("double snprintf %g", [&](){
+            for (auto x: doubles)
+                snprintf_len += snprintf(buf, sizeof(buf), "%g", x);
+        });
+
+        to_chars_len = 0;
+        measure("double to_chars general 6", [&](){
+            for (auto x: doubles)
+            {
+                auto res = std::to_chars(buf, buf + sizeof(buf), x, chars_format::general, 6);
+                to_chars_len += res.ptr - buf;
+            }
+        });
+        test_eq("double to_chars general length", to_chars_len, snprintf_len);
+
+        snprintf_len = 0;
+        measure("double snprintf %.17g", [&](){
+            for (auto x: doubles)
+                snprintf_len += snprintf(buf, sizeof(buf), "%.17g", x);
+        });
+
+        size_t round_trips{};
+        measure("double to_chars shortest", [&](){
+            for (auto x: doubles)
+                round_trips += (std::to_chars(buf, buf + sizeof(buf), x).ptr != buf);
+        });
+
+        round_trips = 0;
+        for (auto x: doubles)
+        {
+            auto res = std::to_chars(buf, buf + sizeof(buf), x);
+            double tmp{};
+            std::from_chars(buf, res.ptr, tmp);
+            round_trips += (tmp == x);
+        }
+        test_eq("double to_chars round trip", round_trips, element_count);
+
+        size_t stream_len{};
+        measure("ostringstream integers", [&](){
+            std::ostringstream oss{};
+            for (auto x: ints)
+                oss << x << ' ';
+            stream_len = oss.str().size();
+        });
+        test_eq("ostringstream integers length", stream_len, total_length(int_strs));
+
+        long long stream_sum{};
+        measure("istringstream integers", [&](){
+            std::ostringstream oss{};
+            for (const auto& str: int_strs)
+                oss << str << ' ';
+
+            std::istringstream iss{oss.str()};
+            long long tmp{};
+            while (iss >> tmp)
+                stream_sum += tmp;
+        });
+        test_eq("istringstream integers sum", stream_sum, strtoll_sum);
+
+        return end();
+    }
+
+    const char* numconv_benchmark::name()
+    {
+        return "numeric conversion benchmark";
+    }
+
+    size_t numconv_benchmark::total_length(const std::vector<std::string>& strs)
+    {
+        size_t len{};
+        for (const auto& str: strs)
+            len += str.size() + 1;
+
+        return len;
+    }
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <cstdio>
+#include <list>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+namespace std::test
+{
+    bool pmr_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        reseed();
+        std::vector<unsigned int> keys(keys_per_request);
+        for (auto& key: keys)
+            key = random();
+
+        /**
+         * Every variant handles the same sequence of
+         * requests, each of which builds a map and a list
+         * of strings and throws them away at its end.
+         */
+        size_t expected{};
+        measure("allocator requests", [&](){
+            for (size_t i = 0; i < request_count; ++i)
+            {
+                std::map<unsigned int, unsigned int> map{};
+                std::list<std::string> list{};
+                expected += handle_request(keys, map, list);
+            }
+        });
+
+        size_t res{};
+        measure("monotonic_buffer_resource requests", [&](){
+            for (size_t i = 0; i < request_count; ++i)
+            {
+                std::pmr::monotonic_buffer_resource arena{};
+                std::pmr::map<unsigned int, unsigned int> map{&arena};
+                std::pmr::list<std::pmr::string> list{&arena};
+                res += handle_request(keys, map, list);
+            }
+        });
+        test_eq("monotonic_buffer_resource requests", res, expected);
+
+        /**
+         * A request arena that starts in a buffer which
+         * outlives the requests only goes upstream when
+         * the request outgrows it.
+         */
+        std::vector<char> buffer(arena_size);
+        res = 0;
+        measure("monotonic_buffer_resource+buffer requests", [&](){
+            for (size_t i = 0; i < request_count; ++i)
+            {
+                std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size()};
+                std::pmr::map<unsigned int, unsigned int> map{&arena};
+                std::pmr::list<std::pmr::string> list{&arena};
+                res += handle_request(keys, map, list);
+            }
+        });
+        test_eq("monotonic_buffer_resource+buffer requests", res, expected);
+
+        res = 0;
+        measure("unsynchronized_pool_resource requests", [&](){
+            std::pmr::unsynchronized_pool_resource pool{};
+            for (size_t i = 0; i < request_count; ++i)
+            {
+                std::pmr::map<unsigned int, unsigned int> map{&pool};
+                std::pmr::list<std::pmr::string> list{&pool};
+                res += handle_request(keys, map, list);
+            }
+        });
+        test_eq("unsynchronized_pool_resource requests", res, expected);
+
+        res = 0;
+        measure("synchronized_pool_resource requests", [&](){
+            std::pmr::synchronized_pool_resource pool{};
+            for (size_t i = 0; i < request_count; ++i)
+            {
+                std::pmr::map<unsigned int, unsigned int> map{&pool};
+                std::pmr::list<std::pmr::string> list{&pool};
+                res += handle_request(keys, map, list);
+            }
+        });
+        test_eq("synchronized_pool_resource requests", res, expected);
+
+        return end();
+    }
+
+    const char* pmr_benchmark::name()
+    {
+        return "pmr benchmark";
+    }
+
+    template<class Map, class List>
+    size_t pmr_benchmark::handle_request(const std::vector<unsigned int>& keys,
+                                         Map& map, List& list)
+    {
+        char buf[32];
+
+        for (auto key: keys)
+        {
+            map[key] = key;
+
+            /**
+             * Note: Node containers construct their values
+             *       directly, so the allocator has to be passed
+             *       to the strings explicitly.
+             */
+            std::snprintf(buf, sizeof(buf), "request value %u", key);
+            list.emplace_back(buf, list.get_allocator());
+        }
+
+        size_t res{map.size()};
+        for (const auto& str: list)
+            res += str.size();
+
+        return res;
+    }
+}
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <cstdint>
+#include <initializer_list>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace std::test
+{
+    bool random_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_engines();
+        test_uniform();
+        test_bernoulli_family();
+        test_poisson_family();
+        test_normal_family();
+        test_sampling_distributions();
+        test_streams();
+
+        return end();
+    }
+
+    const char* random_test::name()
+    {
+        return "random";
+    }
+
+    void random_test::test_engines()
+    {
+        /**
+         * The 10000th outputs of the default constructed
+         * engines are given by the standard.
+         */
+        std::minstd_rand0 lcg{};
+        lcg.discard(9999);
+        test_eq("minstd_rand0", lcg(), 1043618065U);
+
+        std::mt19937 mt{};
+        std::uint_fast32_t res1{};
+        for (size_t i = 0; i < 10000; ++i)
+            res1 = mt();
+        test_eq("mt19937", res1, 4123659995U);
+
+        std::mt19937_64 mt64{};
+        mt64.discard(9999);
+        test_eq("mt19937_64", mt64(), 9981545732273789042ULL);
+
+        std::mt19937 mt1{42};
+        std::mt19937 mt2{42};
+        std::vector<std::uint_fast32_t> buffer(1500);
+        mt1.generate(buffer.begin(), buffer.end());
+
+        bool same{true};
+        for (auto x: buffer)
+            same = same && x == mt2();
+        test("generate matches operator()", same);
+        test("generate keeps the state", mt1 == mt2);
+
+        mt1.generate(buffer.begin(), buffer.begin() + 3);
+        mt2.discard(3);
+        test("discard", mt1 == mt2 && mt1() == mt2());
+
+        mt1.seed(7);
+        test("seed", mt1 != mt2);
+        mt2.seed(7);
+        test_eq("reseed", mt1(), mt2());
+    }
+
+    void random_test::test_uniform()
+    {
+        std::mt19937 g{1};
+
+        std::uniform_int_distribution<int> dist1{-3, 3};
+        bool in_range{true};
+        int counts[7]{};
+        for (size_t i = 0; i < 70000; ++i)
+        {
+            auto x = dist1(g);
+            if (x < -3 || x > 3)
+                in_range = false;
+            else
+                ++counts[x + 3];
+        }
+        test("uniform_int range", in_range);
+
+        bool balanced{true};
+        for (auto c: counts)
+            balanced = balanced && 9500 < c && c < 10500;
+        test("uniform_int balance", balanced);
+
+        std::uniform_int_distribution<std::uint64_t> dist2{};
+        auto x = dist2(g);
+        auto y = dist2(g);
+        test("uniform_int full range", x != y && (x > 0xFFFFFFFFULL || y > 0xFFFFFFFFULL));
+
+        std::uniform_real_distribution<double> dist3{2.0, 4.0};
+        std::minstd_rand lcg{};
+        in_range = true;
+        double sum{};
+        for (size_t i = 0; i < 10000; ++i)
+        {
+            auto val = dist3(lcg);
+            in_range = in_range && 2.0 <= val && val < 4.0;
+            sum += val;
+        }
+        test("uniform_real range", in_range);
+        test("uniform_real mean", 2.95 < sum / 10000 && sum / 10000 < 3.05);
+
+        std::bernoulli_distribution dist4{0.25};
+        size_t hits{};
+        for (size_t i = 0; i < 10000; ++i)
+            hits += dist4(g) ? 1 : 0;
+        test("bernoulli", 2300 < hits && hits < 2700);
+    }
+
+    void random_test::test_bernoulli_family()
+    {
+        std::mt19937 g{2};
+
+        std::binomial_distribution<int> dist1{20, 0.3};
+        test_moments_("binomial inversion", dist1, g, 6.0, 4.2);
+
+        std::binomial_distribution<int> dist2{1000, 0.4};
+        test_moments_("binomial btrs", dist2, g, 400.0, 240.0);
+
+        std::binomial_distribution<int> dist3{200, 0.9};
+        test_moments_("binomial p > 0.5", dist3, g, 180.0, 18.0);
+
+        bool in_range{true};
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            auto x = dist3(g);
+            in_range = in_range && 0 <= x && x <= 200;
+        }
+        test("binomial range", in_range);
+
+        std::binomial_distribution<int> dist4{10, 1.0};
+        test_eq("binomial p = 1", dist4(g), 10);
+
+        std::geometric_distribution<int> dist5{0.2};
+        test_moments_("geometric", dist5, g, 4.0, 20.0);
+
+        std::negative_binomial_distribution<int> dist6{3, 0.5};
+        test_moments_("negative binomial", dist6, g, 3.0, 6.0);
+    }
+
+    void random_test::test_poisson_family()
+    {
+        std::mt19937 g{3};
+
+        std::poisson_distribution<int> dist1{3.5};
+        test_moments_("poisson small mean", dist1, g, 3.5, 3.5);
+
+        std::poisson_distribution<int> dist2{250.0};
+        test_moments_("poisson ptrs", dist2, g, 250.0, 250.0);
+
+        std::exponential_distribution<double> dist3{2.0};
+        test_moments_("exponential", dist3, g, 0.5, 0.25);
+
+        std::exponential_distribution<float> dist4{0.5f};
+        test_moments_("exponential float", dist4, g, 2.0, 4.0);
+
+        std::gamma_distribution<double> dist5{3.0, 2.0};
+        test_moments_("gamma", dist5, g, 6.0, 12.0);
+
+        std::gamma_distribution<double> dist6{0.5, 1.0};
+        test_moments_("gamma alpha < 1", dist6, g, 0.5, 0.5);
+
+        std::weibull_distribution<double> dist7{1.0, 3.0};
+        test_moments_("weibull", dist7, g, 3.0, 9.0);
+
+        std::extreme_value_distribution<double> dist8{1.0, 2.0};
+        test_moments_("extreme value", dist8, g, 2.1544313298, 6.5797362674);
+    }
+
+    void random_test::test_normal_family()
+    {
+        std::mt19937 g{4};
+
+        std::normal_distribution<double> dist1{};
+        test_moments_("normal", dist1, g, 0.0, 1.0);
+
+        std::normal_distribution<double> dist2{10.0, 3.0};
+        test_moments_("normal scaled", dist2, g, 10.0, 9.0);
+
+        /**
+         * The fraction of the samples beyond 3 sigma checks
+         * that the tails are sampled.
+         */
+        size_t tail{};
+        for (size_t i = 0; i < 100000; ++i)
+        {
+            auto x = dist1(g);
+            if (x > 3.0 || x < -3.0)
+                ++tail;
+        }
+        test("normal tails", 200 < tail && tail < 340);
+
+        std::lognormal_distribution<double> dist3{0.0, 0.5};
+        test_moments_("lognormal", dist3, g, 1.1331484531, 0.3646958540);
+
+        std::chi_squared_distribution<double> dist4{4.0};
+        test_moments_("chi squared", dist4, g, 4.0, 8.0);
+
+        std::student_t_distribution<double> dist5{6.0};
+        test_moments_("student t", dist5, g, 0.0, 1.5);
+
+        std::fisher_f_distribution<double> dist6{10.0, 20.0};
+        test_moments_("fisher f", dist6, g, 20.0 / 18.0, 0.4320987654);
+
+        std::cauchy_distribution<double> dist7{5.0, 1.0};
+        size_t below{};
+        size_t inside{};
+        for (size_t i = 0; i < 100000; ++i)
+        {
+            auto x = dist7(g);
+            if (x < 5.0)
+                ++below;
+            if (4.0 < x && x < 6.0)
+                ++inside;
+        }
+        test("cauchy median", 49000 < below && below < 51000);
+        test("cauchy quartiles", 49000 < inside && inside < 51000);
+    }
+
+    void random_test::test_sampling_distributions()
+    {
+        std::mt19937 g{5};
+
+        std::discrete_distribution<int> dist1{1.0, 2.0, 0.0, 5.0};
+        auto prob = dist1.probabilities();
+        auto check1 = {0.125, 0.25, 0.0, 0.625};
+        test_eq(
+            "discrete probabilities",
+            check1.begin(), check1.end(),
+            prob.begin(), prob.end()
+        );
+
+        size_t counts[4]{};
+        for (size_t i = 0; i < 80000; ++i)
+            ++counts[dist1(g)];
+        test("discrete pt1", 9500 < counts[0] && counts[0] < 10500);
+        test("discrete pt2", 19000 < counts[1] && counts[1] < 21000);
+        test_eq("discrete pt3", counts[2], 0U);
+        test("discrete pt4", 49000 < counts[3] && counts[3] < 51000);
+
+        std::discrete_distribution<int> dist2{};
+        test_eq("discrete default", dist2(g), 0);
+        test_eq("discrete max", dist1.max(), 3);
+
+        auto bounds = {0.0, 1.0, 3.0};
+        auto weights = {1.0, 3.0};
+        std::piecewise_constant_distribution<double> dist3{
+            bounds.begin(), bounds.end(), weights.begin()
+        };
+        auto dens = dist3.densities();
+        auto check2 = {0.25, 0.375};
+        test_eq(
+            "piecewise constant densities",
+            check2.begin(), check2.end(),
+            dens.begin(), dens.end()
+        );
+        test_moments_("piecewise constant", dist3, g, 1.625, 0.6927083333);
+
+        /**
+         * Triangular density on [0, 2] with the peak at 2.
+         */
+        std::piecewise_linear_distribution<double> dist4{
+            {0.0, 2.0}, [](double x){ return x; }
+        };
+        test_moments_("piecewise linear", dist4, g, 4.0 / 3, 2.0 / 9);
+    }
+
+    void random_test::test_streams()
+    {
+        test_stream_("binomial stream", std::binomial_distribution<>{20, 0.3});
+        test_stream_("geometric stream", std::geometric_distribution<>{0.1});
+        test_stream_(
+            "negative_binomial stream",
+            std::negative_binomial_distribution<>{3, 0.7}
+        );
+        test_stream_("poisson stream", std::poisson_distribution<>{4.5});
+        test_stream_("exponential stream", std::exponential_distribution<>{0.1});
+        test_stream_("gamma stream", std::gamma_distribution<>{2.5, 0.3});
+        test_stream_("weibull stream", std::weibull_distribution<>{1.5, 2.0});
+        test_stream_(
+            "extreme_value stream",
+            std::extreme_value_distribution<>{-1.0, 0.1}
+        );
+        test_stream_("normal stream", std::normal_distribution<>{1.0 / 3, 2.0});
+        test_stream_(
+            "normal float stream",
+            std::normal_distribution<float>{0.1f, 1.0f / 3}
+        );
+        test_stream_("lognormal stream", std::lognormal_distribution<>{0.2, 0.7});
+        test_stream_("chi_squared stream", std::chi_squared_distribution<>{3.3});
+        test_stream_("cauchy stream", std::cauchy_distribution<>{-0.3, 2.0});
+        test_stream_("fisher_f stream", std::fisher_f_distribution<>{3.0, 7.0});
+        test_stream_("student_t stream", std::student_t_distribution<>{5.0});
+        test_stream_("discrete stream", std::discrete_distribution<>{1, 2, 3, 7});
+
+        std::vector<double> bounds{0.0, 0.1, 1.0, 3.0};
+        std::vector<double> weights{3.0, 1.0, 7.0, 2.0};
+        test_stream_(
+            "piecewise_constant stream",
+            std::piecewise_constant_distribution<>{
+                bounds.begin(), bounds.end(), weights.begin()
+            }
+        );
+        test_stream_(
+            "piecewise_linear stream",
+            std::piecewise_linear_distribution<>{
+                bounds.begin(), bounds.end(), weights.begin()
+            }
+        );
+
+        std::stringstream ss{};
+        ss.precision(3);
+        ss << std::normal_distribution<>{0.5, 2.0} << ' ' << 1.0 / 3;
+        test_eq("stream flags restored", ss.str(), std::string{"5.0000000000000000e-01 2.0000000000000000e+00 0.333"});
+
+        std::normal_distribution<> dist{};
+        std::stringstream bad{"1.0"};
+        bad >> dist;
+        test("stream incomplete input", bad.fail() && dist == std::normal_distribution<>{});
+    }
+
+    template<class Dist>
+    void random_test::test_stream_(const char* tname, const Dist& dist)
+    {
+        std::stringstream ss{};
+        ss << dist;
+
+        Dist res{};
+        ss >> res;
+        test(tname, !ss.fail() && res == dist);
+    }
+
+    template<class Dist, class URNG>
+    void random_test::test_moments_(const char* tname, Dist& dist, URNG& g,
+                                    double mean, double variance)
+    {
+        constexpr size_t count{200000};
+
+        double sum{};
+        double sum2{};
+        bool in_range{true};
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto x = dist(g);
+            in_range = in_range && dist.min() <= x && x <= dist.max();
+
+            double val = x;
+            sum += val;
+            sum2 += val * val;
+        }
+
+        auto res_mean = sum / count;
+        auto res_var = sum2 / count - res_mean * res_mean;
+
+        /**
+         * Five standard errors of the mean and 5 % of the
+         * variance keep the deterministic runs well inside.
+         */
+        auto mean_err = 5 * __builtin_sqrt(variance / count);
+        auto ok = in_range &&
+                  mean - mean_err <= res_mean && res_mean <= mean + mean_err &&
+                  variance * 0.95 <= res_var && res_var <= variance * 1.05;
+
+        test(tname, ok);
+    }
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/builtins.hpp>
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace std::test
+{
+    bool random_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        std::mt19937 g1{};
+        std::uint64_t expected{};
+        measure("mt19937 operator()", [&](){
+            for (size_t i = 0; i < value_count; ++i)
+                expected += g1();
+        });
+
+        /**
+         * Load generators draw their randomness in blocks,
+         * which lets the engine skip its per call checks.
+         */
+        std::mt19937 g2{};
+        std::vector<std::uint_fast32_t> buffer(block_size);
+        std::uint64_t res{};
+        measure("mt19937 generate", [&](){
+            for (size_t i = 0; i < value_count / block_size; ++i)
+            {
+                g2.generate(buffer.begin(), buffer.end());
+                for (auto x: buffer)
+                    res += x;
+            }
+        });
+        test_eq("mt19937 generate", res, expected);
+
+        /**
+         * The polar method is the usual alternative to the
+         * ziggurat, it needs a logarithm and a square root
+         * for every pair of values.
+         */
+        std::uniform_real_distribution<double> uniform{-1.0, 1.0};
+        double sum1{};
+        measure("normal polar method", [&](){
+            for (size_t i = 0; i < sample_count / 2; ++i)
+            {
+                double x{};
+                double y{};
+                double s{};
+                do
+                {
+                    x = uniform(g1);
+                    y = uniform(g1);
+                    s = x * x + y * y;
+                }
+                while (s >= 1.0 || s == 0.0);
+
+                auto factor = aux::sqrt(-2.0 * aux::log(s) / s);
+                sum1 += x * factor + y * factor;
+            }
+        });
+        test("normal polar method", -0.01 < sum1 / sample_count && sum1 / sample_count < 0.01);
+
+        std::normal_distribution<double> normal{};
+        double sum2{};
+        measure("normal ziggurat", [&](){
+            for (size_t i = 0; i < sample_count; ++i)
+                sum2 += normal(g1);
+        });
+        test("normal ziggurat", -0.01 < sum2 / sample_count && sum2 / sample_count < 0.01);
+
+        double sum3{};
+        measure("exponential inversion", [&](){
+            for (size_t i = 0; i < sample_count; ++i)
+                sum3 -= aux::log(1.0 - std::generate_canonical<double, 53>(g1));
+        });
+        test("exponential inversion", 0.99 < sum3 / sample_count && sum3 / sample_count < 1.01);
+
+        std::exponential_distribution<double> exponential{};
+        double sum4{};
+        measure("exponential ziggurat", [&](){
+            for (size_t i = 0; i < sample_count; ++i)
+                sum4 += exponential(g1);
+        });
+        test("exponential ziggurat", 0.99 < sum4 / sample_count && sum4 / sample_count < 1.01);
+
+        std::gamma_distribution<double> gamma{3.0};
+        double sum5{};
+        measure("gamma", [&](){
+            for (size_t i = 0; i < sample_count; ++i)
+                sum5 += gamma(g1);
+        });
+        test("gamma", 2.97 < sum5 / sample_count && sum5 / sample_count < 3.03);
+
+        std::poisson_distribution<int> small_poisson{4.0};
+        std::uint64_t count1{};
+        measure("poisson small mean", [&](){
+            for (size_t i = 0; i < sample_count; ++i)
+                count1 += small_poisson(g1);
+        });
+        test("poisson small mean", 3.97 * sample_count < count1 && count1 < 4.03 * sample_count);
+
+        std::poisson_distribution<int> poisson{1000.0};
+        std::uint64_t count2{};
+        measure("poisson ptrs", [&](){
+            for (size_t i = 0; i < sample_count; ++i)
+                count2 += poisson(g1);
+        });
+        test("poisson ptrs", 999 * sample_count < count2 && count2 < 1001 * sample_count);
+
+        std::binomial_distribution<int> binomial{10000, 0.3};
+        std::uint64_t count3{};
+        measure("binomial btrs", [&](){
+            for (size_t i = 0; i < sample_count; ++i)
+                count3 += binomial(g1);
+        });
+        test("binomial btrs", 2999 * sample_count < count3 && count3 < 3001 * sample_count);
+
+        std::discrete_distribution<int> discrete(
+            256, 0.0, 1.0, [](double x){ return x * x; }
+        );
+        std::uint64_t count4{};
+        measure("discrete alias method", [&](){
+            for (size_t i = 0; i < sample_count; ++i)
+                count4 += discrete(g1);
+        });
+        test("discrete alias method", count4 > 0);
+
+        return end();
+    }
+
+    const char* random_benchmark::name()
+    {
+        return "random";
+    }
+}
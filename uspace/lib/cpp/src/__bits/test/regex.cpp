@@ -0,0 +1,354 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <iterator>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace std::test
+{
+    bool regex_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_literals_and_classes();
+        test_quantifiers();
+        test_alternation_and_groups();
+        test_assertions();
+        test_flags();
+        test_backreferences();
+        test_match_results();
+        test_iterator_and_replace();
+        test_errors();
+
+        return end();
+    }
+
+    const char* regex_test::name()
+    {
+        return "regex";
+    }
+
+    void regex_test::test_literals_and_classes()
+    {
+        std::regex re1{"abc"};
+        test("literal match", std::regex_match("abc", re1));
+        test("literal mismatch", !std::regex_match("abd", re1));
+        test("literal not whole", !std::regex_match("abcd", re1));
+        test("literal search", std::regex_search("xxabcxx", re1));
+        test("literal search fail", !std::regex_search("xxabxcx", re1));
+
+        std::regex re2{"a.c"};
+        test("dot", std::regex_match("a-c", re2));
+        test("dot excludes newline", !std::regex_match("a\nc", re2));
+
+        std::regex re3{"[a-c0-2_]+"};
+        test("class ranges", std::regex_match("ab2_c01", re3));
+        test("class ranges fail", !std::regex_match("abd", re3));
+
+        std::regex re4{"[^a-z]+"};
+        test("negated class", std::regex_match("AB12", re4));
+        test("negated class fail", !std::regex_match("A1b", re4));
+
+        std::regex re5{"\\d+\\s\\w+\\W"};
+        test("class escapes", std::regex_match("42 foo_bar!", re5));
+        test("class escapes fail", !std::regex_match("4x foo!", re5));
+
+        std::regex re6{"[\\d.-]+"};
+        test("escape in class", std::regex_match("1.5-2", re6));
+
+        std::regex re7{"\\x41\\u0042\\t\\."};
+        test("character escapes", std::regex_match("AB\t.", re7));
+
+        std::regex re8{"[]a]"};
+        test("empty class never matches", !std::regex_search("]a", re8));
+
+        /* Bytes above 0x7f, as in UTF-8 or Latin-1 text. */
+        std::string utf8{"caf\xc3\xa9 ok"};
+        test("non-ascii subject", std::regex_search(utf8, std::regex{"ok"}));
+        test("non-ascii subject fail", !std::regex_search(utf8, std::regex{"ko"}));
+        test("non-ascii literal", std::regex_search(utf8, std::regex{"f\xc3\xa9"}));
+        test("non-ascii dot", std::regex_match(utf8, std::regex{"caf.. ok"}));
+        test("non-ascii negated class", std::regex_match("\xff\x80", std::regex{"[^a]+"}));
+    }
+
+    void regex_test::test_quantifiers()
+    {
+        test("star empty", std::regex_match("", std::regex{"a*"}));
+        test("star", std::regex_match("aaaa", std::regex{"a*"}));
+        test("plus empty", !std::regex_match("", std::regex{"a+"}));
+        test("optional", std::regex_match("ac", std::regex{"ab?c"}));
+        test("braces exact", std::regex_match("aaa", std::regex{"a{3}"}));
+        test("braces exact fail", !std::regex_match("aaaa", std::regex{"a{3}"}));
+        test("braces range", std::regex_match("aaaa", std::regex{"a{2,4}"}));
+        test("braces range fail", !std::regex_match("aaaaa", std::regex{"a{2,4}"}));
+        test("braces open", std::regex_match("aaaaaaa", std::regex{"a{2,}"}));
+        test("literal brace", std::regex_match("a{", std::regex{"a{"}));
+        test("nullable star body", std::regex_match("abab", std::regex{"(a|b?)*"}));
+
+        std::cmatch m{};
+        std::regex greedy{"<.*>"};
+        std::regex lazy{"<.*?>"};
+        std::regex_search("<a><b>", m, greedy);
+        test_eq("greedy star", m.str(), std::string{"<a><b>"});
+        std::regex_search("<a><b>", m, lazy);
+        test_eq("lazy star", m.str(), std::string{"<a>"});
+
+        std::regex_search("aaaa", m, std::regex{"a{2,3}?"});
+        test_eq("lazy braces", m.length(), 2);
+
+        /**
+         * The classic exponential case for backtracking
+         * engines has to be linear here.
+         */
+        std::string input(64, 'a');
+        test("no exponential blowup", !std::regex_match(input, std::regex{"(a*)*b"}));
+        test("no exponential blowup search", !std::regex_search(input, std::regex{"(a|aa)+$b"}));
+    }
+
+    void regex_test::test_alternation_and_groups()
+    {
+        std::cmatch m{};
+
+        std::regex_search("abcd", m, std::regex{"ab|abcd"});
+        test_eq("alternation priority", m.str(), std::string{"ab"});
+        test("alternation whole", std::regex_match("abcd", std::regex{"ab|abcd"}));
+
+        std::regex re{"(\\w+)@(\\w+)\\.com"};
+        test("groups match", std::regex_search("mail: joe@example.com!", m, re));
+        test_eq("groups size", m.size(), 3U);
+        test_eq("group 1", m.str(1), std::string{"joe"});
+        test_eq("group 2", m.str(2), std::string{"example"});
+        test_eq("group position", m.position(2), 10);
+        test_eq("re mark_count", re.mark_count(), 2U);
+
+        std::regex_match("b", m, std::regex{"(a)?b"});
+        test("unmatched group", !m[1].matched);
+        test_eq("unmatched group length", m.length(1), 0);
+
+        std::regex_match("aba", m, std::regex{"(?:a(b))+a"});
+        test_eq("non-capturing group size", m.size(), 2U);
+        test_eq("non-capturing group", m.str(1), std::string{"b"});
+
+        std::regex_match("abab", m, std::regex{"(ab)*"});
+        test_eq("last iteration captured", m.str(1), std::string{"ab"});
+        test_eq("last iteration position", m.position(1), 2);
+
+        std::regex_match("ab", m, std::regex{"(a|ab)(c|b)?"});
+        test_eq("leftmost first alternative", m.str(1), std::string{"a"});
+        test_eq("leftmost first rest", m.str(2), std::string{"b"});
+
+        std::regex_match("abc", m, std::regex{"abc", std::regex::nosubs});
+        test_eq("nosubs", m.size(), 1U);
+    }
+
+    void regex_test::test_assertions()
+    {
+        std::regex re1{"^ab$"};
+        test("anchors", std::regex_search("ab", re1));
+        test("anchors fail", !std::regex_search("xab", re1));
+        test("anchors not multiline", !std::regex_search("x\nab", re1));
+        test("not_bol", !std::regex_search("ab", re1, std::regex_constants::match_not_bol));
+        test("not_eol", !std::regex_search("ab", re1, std::regex_constants::match_not_eol));
+
+        std::regex re2{"^ab$", std::regex::ECMAScript | std::regex::multiline};
+        test("multiline anchors", std::regex_search("x\nab\ny", re2));
+
+        std::regex re3{"\\bfoo\\b"};
+        test("word boundary", std::regex_search("a foo.", re3));
+        test("word boundary fail", !std::regex_search("afoo", re3));
+        test("not word boundary", std::regex_search("afoob", std::regex{"\\Bfoo\\B"}));
+        test("boundary at start", std::regex_search("foo", re3));
+
+        std::cmatch m{};
+        std::regex_search("one two", m, std::regex{"\\b\\w+$"});
+        test_eq("boundary search", m.str(), std::string{"two"});
+
+        test("continuous", !std::regex_search("xab", std::regex{"ab"},
+                                              std::regex_constants::match_continuous));
+        test("not_null", !std::regex_search("b", std::regex{"a*"},
+                                            std::regex_constants::match_not_null));
+    }
+
+    void regex_test::test_flags()
+    {
+        std::regex re{"hello [a-c]+", std::regex::icase};
+        test("icase literal", std::regex_match("HeLLo aBC", re));
+        test("icase fail", !std::regex_match("HeLLo aBD", re));
+        test("icase class escape", std::regex_match("A", std::regex{"[^a]", std::regex::icase}) == false);
+
+        std::regex def{};
+        test("default constructed", !std::regex_search("abc", def));
+        test_eq("default mark_count", def.mark_count(), 0U);
+
+        std::regex copy{re};
+        test("copy shares program", std::regex_match("HELLO CAB", copy));
+        test_eq("flags", copy.flags(), std::regex::icase);
+
+        copy.assign("x(y)");
+        test_eq("assign", copy.mark_count(), 1U);
+        test("original intact", std::regex_match("hello a", re));
+
+        std::wregex wre{L"\\w+ \\d"};
+        test("wide regex", std::regex_match(L"abc 1", wre));
+        test("wide regex fail", !std::regex_match(L"abc x", wre));
+
+        std::wsmatch wm{};
+        std::wstring wstr{L"key = value"};
+        std::regex_search(wstr, wm, std::wregex{L"(\\w+) = (\\w+)"});
+        test("wide captures", wm.str(2) == std::wstring{L"value"});
+    }
+
+    void regex_test::test_backreferences()
+    {
+        std::regex re{"(a+)b\\1"};
+        test("backref", std::regex_match("aabaa", re));
+        test("backref fail", !std::regex_match("aaba", re));
+
+        std::cmatch m{};
+        test("backref search", std::regex_search("xy abcabc yz", m, std::regex{"(\\w+)\\1"}));
+        test_eq("backref search result", m.str(), std::string{"abcabc"});
+        test_eq("backref search group", m.str(1), std::string{"abc"});
+
+        test("backref icase", std::regex_match("abAB", std::regex{"(ab)\\1", std::regex::icase}));
+        test("backref unmatched group", std::regex_match("b", std::regex{"(a)?b\\1"}));
+        test("backref with quantifier", std::regex_match("a-a-a-", std::regex{"(a-)\\1{2}"}));
+    }
+
+    void regex_test::test_match_results()
+    {
+        std::smatch m{};
+        test("not ready", !m.ready());
+        test("empty", m.empty());
+
+        std::string str{"date: 2018-10-03 end"};
+        std::regex re{"(\\d+)-(\\d+)-(\\d+)"};
+        test("search", std::regex_search(str, m, re));
+        test("ready", m.ready());
+        test_eq("size", m.size(), 4U);
+        test_eq("whole", m.str(0), std::string{"2018-10-03"});
+        test_eq("prefix", m.prefix().str(), std::string{"date: "});
+        test_eq("suffix", m.suffix().str(), std::string{" end"});
+        test("sub_match compare", m[2] == "10");
+        test("sub_match compare string", std::string{"03"} == m[3]);
+        test("sub_match less", m[2] < m[1]);
+        test_eq("out of range", m[10].matched, false);
+
+        std::vector<std::string> subs{};
+        for (const auto& sub: m)
+            subs.push_back(sub.str());
+        std::vector<std::string> expected{"2018-10-03", "2018", "10", "03"};
+        test_eq("iteration", subs.begin(), subs.end(), expected.begin(), expected.end());
+
+        test_eq("format", m.format("$3.$2.$1 [$&] $$"), std::string{"03.10.2018 [2018-10-03] $"});
+        test_eq("format prefix/suffix", m.format("$`|$'"), std::string{"date: | end"});
+        test_eq("format sed", m.format("\\3/\\2 &", std::regex_constants::format_sed),
+                std::string{"03/10 2018-10-03"});
+
+        test("failed search", !std::regex_search(str, m, std::regex{"xyz"}));
+        test("failed search ready", m.ready());
+        test("failed search empty", m.empty());
+
+        test("match", std::regex_match(str, m, std::regex{"date: .*"}));
+        test_eq("match prefix", m.prefix().matched, false);
+    }
+
+    void regex_test::test_iterator_and_replace()
+    {
+        std::string str{"a1 b22 c333"};
+        std::regex re{"\\d+"};
+
+        std::vector<std::string> found{};
+        std::vector<std::string> prefixes{};
+        std::sregex_iterator it{str.begin(), str.end(), re};
+        for (; it != std::sregex_iterator{}; ++it)
+        {
+            found.push_back(it->str());
+            prefixes.push_back(it->prefix().str());
+        }
+
+        std::vector<std::string> expected{"1", "22", "333"};
+        test_eq("regex_iterator", found.begin(), found.end(), expected.begin(), expected.end());
+        std::vector<std::string> expected_prefixes{"a", " b", " c"};
+        test_eq("regex_iterator prefixes", prefixes.begin(), prefixes.end(),
+                expected_prefixes.begin(), expected_prefixes.end());
+
+        std::sregex_iterator it2{str.begin(), str.end(), re};
+        ++it2;
+        test_eq("regex_iterator position", it2->position(), 4);
+
+        size_t count{};
+        std::regex empty{"x*"};
+        for (std::cregex_iterator eit{"ab", "ab" + 2, empty}, end{}; eit != end; ++eit)
+            ++count;
+        test_eq("empty matches", count, 3U);
+
+        test_eq("replace", std::regex_replace(str, re, "<$&>"),
+                std::string{"a<1> b<22> c<333>"});
+        test_eq("replace first only", std::regex_replace(str, re, "#",
+                                                        std::regex_constants::format_first_only),
+                std::string{"a# b22 c333"});
+        test_eq("replace no copy", std::regex_replace(str, re, "$&,",
+                                                     std::regex_constants::format_no_copy),
+                std::string{"1,22,333,"});
+        test_eq("replace groups", std::regex_replace("john smith", std::regex{"(\\w+) (\\w+)"},
+                                                    std::string{"$2, $1"}),
+                std::string{"smith, john"});
+        test_eq("replace no match", std::regex_replace(str, std::regex{"z"}, "y"), str);
+        test_eq("replace empty matches", std::regex_replace("ab", empty, "-"),
+                std::string{"-a-b-"});
+
+        std::string out{};
+        std::regex_replace(std::back_inserter(out), str.begin(), str.end(), re, "");
+        test_eq("replace output iterator", out, std::string{"a b c"});
+    }
+
+    void regex_test::test_errors()
+    {
+        auto code_of = [](const char* pattern){
+            std::regex re{pattern};
+
+            return re.mark_count();
+        };
+
+        test_eq("unbalanced paren", code_of("(ab"), 0U);
+        test_eq("unbalanced bracket", code_of("[ab"), 0U);
+
+        test("invalid pattern never matches", !std::regex_search("ab", std::regex{"(ab"}));
+        test("invalid repeat", !std::regex_search("ab", std::regex{"*a"}));
+        test("invalid range", !std::regex_search("b", std::regex{"[z-a]"}));
+        test("invalid backref", !std::regex_search("aa", std::regex{"(a)\\2"}));
+        test("invalid braces", !std::regex_search("aaa", std::regex{"a{3,1}"}));
+
+        std::regex_error err{std::regex_constants::error_brack};
+        test_eq("regex_error code", err.code(), std::regex_constants::error_brack);
+    }
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <cstdio>
+#include <regex>
+#include <string>
+
+namespace std::test
+{
+    bool regex_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        reseed();
+        auto log = generate_log_();
+        report_value("input size", log.size(), "B");
+
+        /**
+         * Rejecting the whole input is the common case of
+         * grep-like use, this runs on the DFA only.
+         */
+        std::regex absent{"FATAL [a-z]+: timeout"};
+        bool found{true};
+        measure("search without match", [&](){
+            found = std::regex_search(log, absent);
+        });
+        test("search without match", !found);
+
+        std::regex error{"ERROR (\\w+): request (\\d+) failed"};
+        size_t matches{};
+        size_t id_sum{};
+        measure("iterate over matches with captures", [&](){
+            std::sregex_iterator end{};
+            for (std::sregex_iterator it{log.begin(), log.end(), error}; it != end; ++it)
+            {
+                ++matches;
+                id_sum += (*it)[2].length();
+            }
+        });
+        test("matches found", matches > 0);
+        test("captures found", id_sum >= matches);
+
+        std::regex line{"(\\d{4})-(\\d\\d)-(\\d\\d) [A-Z]+ +\\w+: .*"};
+        size_t lines{};
+        measure("match lines", [&](){
+            auto first = log.cbegin();
+            while (first != log.cend())
+            {
+                auto last = first;
+                while (*last != '\n')
+                    ++last;
+
+                if (std::regex_match(first, last, line))
+                    ++lines;
+                first = last + 1;
+            }
+        });
+        test_eq("all lines matched", lines, line_count);
+
+        /**
+         * Nested quantifiers that make backtracking engines
+         * go exponential are linear for the automata.
+         */
+        std::string as(pathological_size, 'a');
+        std::regex nested{"(a|aa)*c"};
+        measure("pathological pattern", [&](){
+            found = std::regex_search(as, nested);
+        });
+        test("pathological pattern", !found);
+
+        std::regex repeated{"\\b(\\w+) \\1\\b"};
+        size_t repeats{};
+        measure("backreference search", [&](){
+            auto first = log.cbegin();
+            for (size_t i = 0; i < backref_lines; ++i)
+            {
+                auto last = first;
+                while (*last != '\n')
+                    ++last;
+
+                if (std::regex_search(first, last, repeated))
+                    ++repeats;
+                first = last + 1;
+            }
+        });
+        test("backreference search", repeats > 0);
+
+        return end();
+    }
+
+    const char* regex_benchmark::name()
+    {
+        return "regex benchmark";
+    }
+
+    std::string regex_benchmark::generate_log_()
+    {
+        static constexpr const char* levels[] = {
+            "INFO", "DEBUG", "WARN", "ERROR"
+        };
+        static constexpr const char* modules[] = {
+            "vfs", "net", "devman", "loc", "console"
+        };
+        static constexpr const char* words[] = {
+            "request", "the", "the", "block", "read", "write", "cache", "cache"
+        };
+
+        std::string res{};
+        res.reserve(line_count * 80);
+
+        char buf[128];
+        for (size_t i = 0; i < line_count; ++i)
+        {
+            auto level = levels[random() % 4];
+            auto module = modules[random() % 5];
+
+            if (level[0] == 'E')
+            {
+                std::snprintf(buf, sizeof(buf), "2018-10-%02u %s %s: request %u failed\n",
+                              random() % 28 + 1, level, module, random());
+            }
+            else
+            {
+                std::snprintf(buf, sizeof(buf), "2018-10-%02u %s %s: %s %s %s %u\n",
+                              random() % 28 + 1, level, module, words[random() % 8],
+                              words[random() % 8], words[random() % 8], random());
+            }
+
+            res.append(buf);
+        }
+
+        return res;
+    }
+}
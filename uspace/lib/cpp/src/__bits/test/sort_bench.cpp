@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+namespace std::test
+{
+    namespace aux
+    {
+        struct sort_record
+        {
+            unsigned int key;
+            unsigned int idx;
+
+            bool operator<(const sort_record& other) const
+            {
+                return key < other.key;
+            }
+        };
+    }
+
+    bool sort_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        reseed();
+        std::vector<unsigned int> data(element_count);
+        for (auto& x: data)
+            x = random();
+        benchmark_input("random", data);
+
+        std::vector<unsigned int> sorted_data(element_count);
+        for (size_t i = 0; i < element_count; ++i)
+            sorted_data[i] = static_cast<unsigned int>(i);
+        benchmark_input("sorted", sorted_data);
+
+        std::vector<unsigned int> reversed_data(element_count);
+        for (size_t i = 0; i < element_count; ++i)
+            reversed_data[i] = static_cast<unsigned int>(element_count - i);
+        benchmark_input("reversed", reversed_data);
+
+        std::vector<unsigned int> few_unique_data(element_count);
+        for (auto& x: few_unique_data)
+            x = random() % 16;
+        benchmark_input("few unique", few_unique_data);
+
+        benchmark_stability();
+
+        return end();
+    }
+
+    const char* sort_benchmark::name()
+    {
+        return "sort benchmark";
+    }
+
+    void sort_benchmark::benchmark_input(const char* input,
+                                         const std::vector<unsigned int>& data)
+    {
+        char tname[64];
+
+        auto heap_data = data;
+        std::snprintf(tname, sizeof(tname), "heapsort %s", input);
+        measure(tname, [&](){
+            std::make_heap(heap_data.begin(), heap_data.end());
+            std::sort_heap(heap_data.begin(), heap_data.end());
+        });
+        test(tname, std::is_sorted(heap_data.begin(), heap_data.end()));
+
+        auto sort_data = data;
+        std::snprintf(tname, sizeof(tname), "sort %s", input);
+        measure(tname, [&](){
+            std::sort(sort_data.begin(), sort_data.end());
+        });
+        test(tname, std::is_sorted(sort_data.begin(), sort_data.end()));
+
+        auto stable_data = data;
+        std::snprintf(tname, sizeof(tname), "stable_sort %s", input);
+        measure(tname, [&](){
+            std::stable_sort(stable_data.begin(), stable_data.end());
+        });
+        test(tname, std::is_sorted(stable_data.begin(), stable_data.end()));
+    }
+
+    void sort_benchmark::benchmark_stability()
+    {
+        reseed();
+        std::vector<aux::sort_record> data(element_count);
+        for (size_t i = 0; i < element_count; ++i)
+            data[i] = aux::sort_record{random() % 1024, static_cast<unsigned int>(i)};
+
+        auto sort_data = data;
+        measure("sort records", [&](){
+            std::sort(sort_data.begin(), sort_data.end());
+        });
+        test("sort records", std::is_sorted(sort_data.begin(), sort_data.end()));
+
+        auto stable_data = data;
+        measure("stable_sort records", [&](){
+            std::stable_sort(stable_data.begin(), stable_data.end());
+        });
+
+        bool stable{true};
+        for (size_t i = 1; i < element_count; ++i)
+        {
+            const auto& prev = stable_data[i - 1];
+            const auto& curr = stable_data[i];
+
+            if (curr < prev || (curr.key == prev.key && curr.idx < prev.idx))
+                stable = false;
+        }
+        test("stable_sort records", stable);
+    }
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <array>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace std::test
+{
+    bool span_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_construction();
+        test_subviews();
+        test_access();
+
+        return end();
+    }
+
+    const char* span_test::name()
+    {
+        return "span";
+    }
+
+    void span_test::test_construction()
+    {
+        int arr[]{1, 2, 3, 4};
+        std::span<int> s1{arr};
+        test_eq("size from C array", s1.size(), 4ul);
+        test("data from C array", s1.data() == arr);
+
+        std::span<int, 4> s2{arr};
+        test_eq("static extent", s2.extent, 4ul);
+        test_eq("static extent size", s2.size(), 4ul);
+        test("static extent stores no size", sizeof(s2) == sizeof(int*));
+
+        std::span<int> s3{arr + 1, 2};
+        test_eq(
+            "construction from pointer and count",
+            s3.begin(), s3.end(),
+            arr + 1, arr + 3
+        );
+
+        std::span<int> s4{arr + 1, arr + 4};
+        test_eq("construction from pointer range", s4.size(), 3ul);
+
+        std::vector<int> vec{5, 6, 7};
+        std::span<int> s5{vec};
+        test("construction from vector", s5.data() == vec.data() && s5.size() == 3);
+
+        const std::vector<int>& cvec = vec;
+        std::span<const int> s6{cvec};
+        test_eq("construction from const vector", s6.size(), 3ul);
+
+        std::array<int, 3> sarr{8, 9, 10};
+        std::span<int, 3> s7{sarr};
+        test("construction from std::array", s7.data() == sarr.data());
+
+        std::span<const int> s8{s1};
+        test_eq("conversion to const elements", s8.size(), 4ul);
+
+        std::string str{"text"};
+        std::span<const char> s9{str};
+        test_eq("construction from string", s9.size(), 4ul);
+
+        std::span<int> s10{};
+        test("default constructor", s10.empty() && s10.data() == nullptr);
+    }
+
+    void span_test::test_subviews()
+    {
+        int arr[]{1, 2, 3, 4, 5, 6};
+        std::span<int> s{arr};
+
+        auto f = s.first(2);
+        test_eq("first", f.begin(), f.end(), arr, arr + 2);
+
+        auto l = s.last(2);
+        test_eq("last", l.begin(), l.end(), arr + 4, arr + 6);
+
+        auto sub = s.subspan(1, 3);
+        test_eq("subspan", sub.begin(), sub.end(), arr + 1, arr + 4);
+
+        auto rest = s.subspan(4);
+        test_eq("subspan until end", rest.begin(), rest.end(), arr + 4, arr + 6);
+
+        auto sf = s.first<3>();
+        test_eq("static first", sf.extent, 3ul);
+
+        auto sl = s.last<1>();
+        test_eq("static last", sl[0], 6);
+
+        std::span<int, 6> fixed{arr};
+        auto ss = fixed.subspan<2>();
+        test_eq("static subspan extent", ss.extent, 4ul);
+        test_eq("static subspan", ss.begin(), ss.end(), arr + 2, arr + 6);
+    }
+
+    void span_test::test_access()
+    {
+        int arr[]{1, 2, 3};
+        std::span<int> s{arr};
+
+        test_eq("front", s.front(), 1);
+        test_eq("back", s.back(), 3);
+        test_eq("size_bytes", s.size_bytes(), 3 * sizeof(int));
+
+        s[1] = 42;
+        test_eq("write through", arr[1], 42);
+
+        int sum{};
+        for (auto x: s)
+            sum += x;
+        test_eq("range for", sum, 46);
+
+        auto it = s.rbegin();
+        test_eq("reverse iterator", *it, 3);
+    }
+}
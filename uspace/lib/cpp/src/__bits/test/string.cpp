@@ -47,6 +47,7 @@ namespace std::test
         test_find();
         test_substr();
         test_compare();
+        test_small_strings();
 
         return end();
     }
@@ -702,5 +703,64 @@ namespace std::test
             "compare substring equal",
             res, 0
         );
+
+        std::wstring wstr1{L"abcd"};
+        test_eq("wide length", wstr1.size(), 4ul);
+        test_eq("wide compare less", wstr1.compare(L"abce") < 0, true);
+        test_eq("wide compare equal", wstr1.compare(L"abcd"), 0);
+    }
+
+    void string_test::test_small_strings()
+    {
+        std::string str1{"short"};
+        std::string str2{"this string is too long to be stored inline"};
+
+        str1.swap(str2);
+        test_eq(
+            "swap short and long (long)",
+            str1, std::string{"this string is too long to be stored inline"}
+        );
+        test_eq(
+            "swap short and long (short)",
+            str2, std::string{"short"}
+        );
+
+        std::string str3{std::move(str2)};
+        test_eq("move short string", str3, std::string{"short"});
+        test_eq("move short string source empty", str2.size(), 0ul);
+        test_eq("move short string source terminated", str2.c_str()[0], '\0');
+
+        str3.append(" string grown past the inline buffer");
+        test_eq(
+            "append past the inline buffer",
+            str3, std::string{"short string grown past the inline buffer"}
+        );
+
+        str3.erase(5);
+        str3.shrink_to_fit();
+        test_eq("shrink back to the inline buffer", str3, std::string{"short"});
+        test_eq("shrink back size", str3.size(), 5ul);
+
+        std::string str4{};
+        for (char c = 'a'; c <= 'z'; ++c)
+            str4.push_back(c);
+        test_eq(
+            "push_back past the inline buffer",
+            str4, std::string{"abcdefghijklmnopqrstuvwxyz"}
+        );
+
+        str4.resize(3);
+        str4.resize(5, 'x');
+        test_eq("resize with a character", str4, std::string{"abcxx"});
+
+        str4.clear();
+        test_eq("clear keeps terminator", str4.c_str()[0], '\0');
+
+        str4.reserve(100);
+        test("reserve", str4.capacity() >= 100);
+
+        std::string str5{"abcdef"};
+        str5.assign(str5.c_str() + 2);
+        test_eq("assign from own contents", str5, std::string{"cdef"});
     }
 }
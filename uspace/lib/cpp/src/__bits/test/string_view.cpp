@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace std::test
+{
+    bool string_view_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_construction();
+        test_modifiers();
+        test_find();
+        test_compare();
+        test_hash();
+        test_string_interop();
+        test_output();
+
+        return end();
+    }
+
+    const char* string_view_test::name()
+    {
+        return "string_view";
+    }
+
+    void string_view_test::test_construction()
+    {
+        const char* check = "hello";
+
+        std::string_view sv1{};
+        test("default constructor", sv1.empty() && sv1.data() == nullptr);
+
+        std::string_view sv2{check};
+        test_eq("size from cstring", sv2.size(), 5ul);
+        test("no copy from cstring", sv2.data() == check);
+
+        std::string_view sv3{check + 1, 3};
+        test_eq(
+            "construction from pointer and size",
+            sv3.begin(), sv3.end(),
+            check + 1, check + 4
+        );
+
+        using namespace std::literals;
+        auto sv4 = "he\0llo"sv;
+        test_eq("literal with null character", sv4.size(), 6ul);
+        test_eq("front", sv4.front(), 'h');
+        test_eq("back", sv4.back(), 'o');
+
+        const char* check_rev = "cba";
+        std::string_view rev{"abc"};
+        test_eq(
+            "reverse iterators",
+            rev.rbegin(), rev.rend(),
+            check_rev, check_rev + 3
+        );
+    }
+
+    void string_view_test::test_modifiers()
+    {
+        std::string_view sv{"  key = value;"};
+
+        sv.remove_prefix(sv.find_first_not_of(' '));
+        test_eq("remove_prefix", sv, std::string_view{"key = value;"});
+
+        sv.remove_suffix(1);
+        test_eq("remove_suffix", sv, std::string_view{"key = value"});
+
+        auto key = sv.substr(0, sv.find(' '));
+        test_eq("substr", key, std::string_view{"key"});
+        test("substr does not copy", key.data() == sv.data());
+
+        auto val = sv.substr(sv.rfind(' ') + 1);
+        test_eq("substr until end", val, std::string_view{"value"});
+
+        auto all = sv.substr(0, 1000);
+        test_eq("substr with long length", all.size(), sv.size());
+
+        char buffer[4]{};
+        auto copied = val.copy(buffer, 3, 1);
+        test_eq("copy count", copied, 3ul);
+        test_eq("copy contents", std::string_view{buffer, 3}, std::string_view{"alu"});
+
+        std::string_view other{"other"};
+        sv.swap(other);
+        test_eq("swap lhs", sv, std::string_view{"other"});
+        test_eq("swap rhs", other, std::string_view{"key = value"});
+
+        test("starts_with", sv.starts_with("oth") && !sv.starts_with("others"));
+        test("ends_with", sv.ends_with('r') && sv.ends_with("her") && !sv.ends_with("x"));
+    }
+
+    void string_view_test::test_find()
+    {
+        std::string_view sv{"ab cd ab cd ab"};
+        auto npos = std::string_view::npos;
+
+        test_eq("find char", sv.find('c'), 3ul);
+        test_eq("find char from pos", sv.find('c', 4), 9ul);
+        test_eq("find char not found", sv.find('x'), npos);
+        test_eq("find char past end", sv.find('a', 100), npos);
+        test_eq("find view", sv.find("cd ab"), 3ul);
+        test_eq("find view from pos", sv.find("cd ab", 4), 9ul);
+        test_eq("find view not found", sv.find("abc"), npos);
+        test_eq("find empty view", sv.find("", 2), 2ul);
+        test_eq("find longer view", std::string_view{"ab"}.find("abc"), npos);
+
+        test_eq("rfind char", sv.rfind('a'), 12ul);
+        test_eq("rfind char from pos", sv.rfind('a', 11), 6ul);
+        test_eq("rfind char at pos", sv.rfind('a', 6), 6ul);
+        test_eq("rfind view", sv.rfind("ab"), 12ul);
+        test_eq("rfind view from pos", sv.rfind("ab", 11), 6ul);
+        test_eq("rfind view not found", sv.rfind("ba"), npos);
+
+        test_eq("find_first_of", sv.find_first_of("dc"), 3ul);
+        test_eq("find_first_of from pos", sv.find_first_of("dc", 5), 9ul);
+        test_eq("find_first_of not found", sv.find_first_of("xyz"), npos);
+        test_eq("find_last_of", sv.find_last_of("dc"), 10ul);
+        test_eq("find_last_of from pos", sv.find_last_of("dc", 9), 9ul);
+        test_eq("find_last_of not found", sv.find_last_of("xyz"), npos);
+
+        test_eq("find_first_not_of", sv.find_first_not_of("ab "), 3ul);
+        test_eq("find_first_not_of not found", sv.find_first_not_of("abcd "), npos);
+        test_eq("find_last_not_of", sv.find_last_not_of("ab "), 10ul);
+        test_eq("find_last_not_of from pos", sv.find_last_not_of("ab ", 3), 3ul);
+        test_eq("find_last_not_of not found", sv.find_last_not_of("abcd "), npos);
+
+        std::string_view empty{};
+        test_eq("find in empty", empty.find('a'), npos);
+        test_eq("rfind in empty", empty.rfind("a"), npos);
+        test_eq("find_last_of in empty", empty.find_last_of("a"), npos);
+    }
+
+    void string_view_test::test_compare()
+    {
+        std::string_view sv1{"abc"};
+        std::string_view sv2{"abd"};
+        std::string_view sv3{"ab"};
+
+        test("compare less", sv1.compare(sv2) < 0);
+        test("compare greater", sv2.compare(sv1) > 0);
+        test("compare prefix", sv3.compare(sv1) < 0 && sv1.compare(sv3) > 0);
+        test_eq("compare equal", sv1.compare("abc"), 0);
+        test_eq("compare substring", sv1.compare(0, 2, sv3), 0);
+        test_eq("compare two substrings", sv1.compare(1, 1, sv2, 1, 1), 0);
+
+        using namespace std::literals;
+        test("compare with null characters", "a\0b"sv < "a\0c"sv);
+        test("compare as unsigned", "\x7f"sv < "\x80"sv);
+
+        test("operator==", sv1 == "abc");
+        test("operator!=", "abd" != sv1);
+        test("operator<", sv1 < sv2);
+        test("operator>", sv2 > sv1);
+        test("operator<=", sv3 <= sv1 && sv1 <= sv1);
+        test("operator>=", sv1 >= sv3 && sv1 >= sv1);
+    }
+
+    void string_view_test::test_hash()
+    {
+        std::string str{"hash me"};
+        std::string_view sv{str};
+
+        test_eq(
+            "hash equals string hash",
+            std::hash<std::string_view>{}(sv),
+            std::hash<std::string>{}(str)
+        );
+        test_eq(
+            "hash of substring",
+            std::hash<std::string_view>{}(sv.substr(5)),
+            std::hash<std::string_view>{}(std::string_view{"me"})
+        );
+    }
+
+    void string_view_test::test_string_interop()
+    {
+        std::string str{"hello world"};
+
+        std::string_view sv = str;
+        test("conversion from string", sv.data() == str.data() && sv.size() == str.size());
+        test("comparison with string", sv == str && str == sv);
+
+        std::string str2{sv.substr(6)};
+        test_eq("explicit construction", str2, std::string{"world"});
+
+        str2 = sv.substr(0, 5);
+        test_eq("assignment", str2, std::string{"hello"});
+
+        str2 += std::string_view{", "};
+        str2.append(sv, 6, 5);
+        test_eq("append", str2, std::string{"hello, world"});
+
+        str2.insert(5, std::string_view{" there"});
+        test_eq("insert", str2, std::string{"hello there, world"});
+
+        str2.replace(0, 5, std::string_view{"hi"});
+        test_eq("replace", str2, std::string{"hi there, world"});
+
+        str2.assign(std::string_view{"abcabc"}, 1, 4);
+        test_eq("assign", str2, std::string{"bcab"});
+
+        test_eq("find", str.find(std::string_view{"wor"}), 6ul);
+        test_eq("rfind", str.rfind(std::string_view{"o"}), 7ul);
+        test_eq("find_first_of", str.find_first_of(std::string_view{"ow"}), 4ul);
+        test_eq("find_last_of", str.find_last_of(std::string_view{"lo"}), 9ul);
+        test_eq("find_first_not_of", str.find_first_not_of(std::string_view{"hel"}), 4ul);
+        test_eq("find_last_not_of", str.find_last_not_of(std::string_view{"dl"}), 8ul);
+
+        test_eq("compare", str.compare(std::string_view{"hello world"}), 0);
+        test_eq("compare substring", str.compare(6, 5, std::string_view{"world"}), 0);
+        test("compare cstring", str.compare("hello") > 0);
+        test_eq("compare substring with cstring", str.compare(0, 5, "hello"), 0);
+    }
+
+    void string_view_test::test_output()
+    {
+        std::ostringstream ss{};
+        std::string_view sv{"abc"};
+
+        ss << sv << std::string_view{"defgh"}.substr(1, 2);
+        test_eq("output", ss.str(), std::string{"abcef"});
+
+        std::ostringstream padded{};
+        padded.width(5);
+        padded << sv;
+        test_eq("output with padding", padded.str(), std::string{"  abc"});
+
+        std::ostringstream narrow{};
+        narrow.width(2);
+        narrow << sv;
+        test_eq("output wider than width", narrow.str(), std::string{"abc"});
+    }
+}
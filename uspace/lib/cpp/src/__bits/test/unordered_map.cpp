@@ -262,5 +262,17 @@ namespace std::test
         auto res7 = mmap.erase(mmap.find(7));
         test_eq("multi erase by iterator pt1", res7->first, 7);
         test_eq("multi erase by iterator pt2", mmap.count(7), 1U);
+
+        std::unordered_multimap<int, int, std::aux::identity_hash<int>> cmap{};
+        auto bucket_count = static_cast<int>(cmap.bucket_count());
+        cmap.emplace(1, 1);
+        cmap.emplace(1 + bucket_count, 2);
+        cmap.emplace(1 + 2 * bucket_count, 3);
+        test_eq("collision same bucket", cmap.bucket(1), cmap.bucket(1 + bucket_count));
+        test_eq("collision count", cmap.count(1 + bucket_count), 1U);
+
+        cmap.erase(1 + bucket_count);
+        test_eq("collision erase pt1", cmap.count(1), 1U);
+        test_eq("collision erase pt2", cmap.count(1 + 2 * bucket_count), 1U);
     }
 }
@@ -0,0 +1,522 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/tests.hpp>
+#include <cstdlib>
+#include <initializer_list>
+#include <valarray>
+
+namespace std::test
+{
+    bool valarray_test::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        test_construction();
+        test_arithmetic();
+        test_compound_assignment();
+        test_comparison();
+        test_slices();
+        test_masks_and_indices();
+        test_member_functions();
+
+        return end();
+    }
+
+    const char* valarray_test::name()
+    {
+        return "valarray";
+    }
+
+    void valarray_test::test_construction()
+    {
+        std::valarray<int> va1{};
+        test_eq("default construction", va1.size(), 0U);
+        test("begin == end when empty", std::begin(va1) == std::end(va1));
+
+        std::valarray<int> va2(5);
+        auto check1 = {0, 0, 0, 0, 0};
+        test_eq("size construction", va2.size(), 5U);
+        test_eq(
+            "size construction values",
+            check1.begin(), check1.end(),
+            std::begin(va2), std::end(va2)
+        );
+
+        std::valarray<int> va3(7, 3);
+        auto check2 = {7, 7, 7};
+        test_eq(
+            "value construction",
+            check2.begin(), check2.end(),
+            std::begin(va3), std::end(va3)
+        );
+
+        int data[] = {1, 2, 3, 4};
+        std::valarray<int> va4(data, 4);
+        test_eq(
+            "pointer construction",
+            std::begin(data), std::end(data),
+            std::begin(va4), std::end(va4)
+        );
+
+        std::valarray<int> va5{va4};
+        test_eq(
+            "copy construction",
+            std::begin(data), std::end(data),
+            std::begin(va5), std::end(va5)
+        );
+
+        std::valarray<int> va6{std::move(va5)};
+        test_eq("move construction", va6.size(), 4U);
+        test_eq("move construction source", va5.size(), 0U);
+
+        va5 = va6;
+        test_eq(
+            "copy assignment with resize",
+            std::begin(data), std::end(data),
+            std::begin(va5), std::end(va5)
+        );
+
+        va5 = 9;
+        auto check3 = {9, 9, 9, 9};
+        test_eq(
+            "value assignment",
+            check3.begin(), check3.end(),
+            std::begin(va5), std::end(va5)
+        );
+
+        va5 = {1, 2};
+        auto check4 = {1, 2};
+        test_eq(
+            "initializer list assignment",
+            check4.begin(), check4.end(),
+            std::begin(va5), std::end(va5)
+        );
+    }
+
+    void valarray_test::test_arithmetic()
+    {
+        std::valarray<int> va1{1, 2, 3, 4};
+        std::valarray<int> va2{10, 20, 30, 40};
+
+        std::valarray<int> res1 = va1 + va2;
+        auto check1 = {11, 22, 33, 44};
+        test_eq(
+            "addition",
+            check1.begin(), check1.end(),
+            std::begin(res1), std::end(res1)
+        );
+
+        std::valarray<int> res2 = va2 * 2 - va1;
+        auto check2 = {19, 38, 57, 76};
+        test_eq(
+            "scalar on the right",
+            check2.begin(), check2.end(),
+            std::begin(res2), std::end(res2)
+        );
+
+        std::valarray<int> res3 = 100 - va1 * va1;
+        auto check3 = {99, 96, 91, 84};
+        test_eq(
+            "scalar on the left",
+            check3.begin(), check3.end(),
+            std::begin(res3), std::end(res3)
+        );
+
+        std::valarray<int> res4 = (va1 + va2) * (va2 - va1) / 3 % 7;
+        auto check4 = {5, 6, 3, 3};
+        test_eq(
+            "chained expression",
+            check4.begin(), check4.end(),
+            std::begin(res4), std::end(res4)
+        );
+
+        std::valarray<int> res5 = -va1;
+        auto check5 = {-1, -2, -3, -4};
+        test_eq(
+            "unary minus",
+            check5.begin(), check5.end(),
+            std::begin(res5), std::end(res5)
+        );
+
+        std::valarray<int> res6 = abs(-(va1 - 3));
+        auto check6 = {2, 1, 0, 1};
+        test_eq(
+            "abs",
+            check6.begin(), check6.end(),
+            std::begin(res6), std::end(res6)
+        );
+
+        std::valarray<int> res7 = (va1 << 2) | 1;
+        auto check7 = {5, 9, 13, 17};
+        test_eq(
+            "shift and or",
+            check7.begin(), check7.end(),
+            std::begin(res7), std::end(res7)
+        );
+
+        std::valarray<int> res8 = (va2 ^ va1) & ~3;
+        auto check8 = {8, 20, 28, 44};
+        test_eq(
+            "xor, and and not",
+            check8.begin(), check8.end(),
+            std::begin(res8), std::end(res8)
+        );
+
+        /**
+         * The expression reads the elements it overwrites,
+         * which is fine as each element only depends on
+         * itself.
+         */
+        va1 = va1 * va1 + va1;
+        auto check9 = {2, 6, 12, 20};
+        test_eq(
+            "assignment of an aliasing expression",
+            check9.begin(), check9.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        std::valarray<int> res10{};
+        res10 = va1 + va2;
+        auto check10 = {12, 26, 42, 60};
+        test_eq(
+            "expression assignment with resize",
+            check10.begin(), check10.end(),
+            std::begin(res10), std::end(res10)
+        );
+
+        test_eq("expression sum", (va1 + 1).sum(), 44);
+        test_eq("expression min", (va2 - va1).min(), 8);
+        test_eq("expression max", (va2 - va1).max(), 20);
+
+        std::valarray<double> vd{1.0, 2.0, 4.0};
+        std::valarray<double> res11 = vd * 0.5 + 1.0;
+        auto check11 = {1.5, 2.0, 3.0};
+        test_eq(
+            "double expression",
+            check11.begin(), check11.end(),
+            std::begin(res11), std::end(res11)
+        );
+    }
+
+    void valarray_test::test_compound_assignment()
+    {
+        std::valarray<int> va1{1, 2, 3, 4};
+        std::valarray<int> va2{4, 3, 2, 1};
+
+        va1 += va2;
+        auto check1 = {5, 5, 5, 5};
+        test_eq(
+            "operator+= valarray",
+            check1.begin(), check1.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        va1 *= 3;
+        auto check2 = {15, 15, 15, 15};
+        test_eq(
+            "operator*= value",
+            check2.begin(), check2.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        va1 -= va2 * 2;
+        auto check3 = {7, 9, 11, 13};
+        test_eq(
+            "operator-= expression",
+            check3.begin(), check3.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        va1 %= va2 + 1;
+        auto check4 = {2, 1, 2, 1};
+        test_eq(
+            "operator%= expression",
+            check4.begin(), check4.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        va1 <<= 3;
+        va1 >>= 1;
+        va1 /= 2;
+        auto check5 = {4, 2, 4, 2};
+        test_eq(
+            "shift and division",
+            check5.begin(), check5.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        va1 |= 1;
+        va1 ^= va2;
+        va1 &= 6;
+        auto check6 = {0, 0, 6, 2};
+        test_eq(
+            "bitwise compound assignment",
+            check6.begin(), check6.end(),
+            std::begin(va1), std::end(va1)
+        );
+    }
+
+    void valarray_test::test_comparison()
+    {
+        std::valarray<int> va1{1, 5, 3, 7};
+        std::valarray<int> va2{2, 5, 1, 8};
+
+        std::valarray<bool> res1 = va1 < va2;
+        auto check1 = {true, false, false, true};
+        test_eq(
+            "operator<",
+            check1.begin(), check1.end(),
+            std::begin(res1), std::end(res1)
+        );
+
+        std::valarray<bool> res2 = va1 == va2;
+        auto check2 = {false, true, false, false};
+        test_eq(
+            "operator==",
+            check2.begin(), check2.end(),
+            std::begin(res2), std::end(res2)
+        );
+
+        std::valarray<bool> res3 = va1 >= 3;
+        auto check3 = {false, true, true, true};
+        test_eq(
+            "operator>= value",
+            check3.begin(), check3.end(),
+            std::begin(res3), std::end(res3)
+        );
+
+        std::valarray<bool> res4 = (va1 > 2) && (va2 != 8);
+        auto check4 = {false, true, true, false};
+        test_eq(
+            "operator&&",
+            check4.begin(), check4.end(),
+            std::begin(res4), std::end(res4)
+        );
+
+        std::valarray<bool> res5 = !(va1 <= va2) || (va1 == 1);
+        auto check5 = {true, false, true, false};
+        test_eq(
+            "operator|| and operator!",
+            check5.begin(), check5.end(),
+            std::begin(res5), std::end(res5)
+        );
+    }
+
+    void valarray_test::test_slices()
+    {
+        std::valarray<int> va1{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+
+        const auto& cva1 = va1;
+        std::valarray<int> res1 = cva1[std::slice{1, 4, 3}];
+        auto check1 = {1, 4, 7, 10};
+        test_eq(
+            "const slice",
+            check1.begin(), check1.end(),
+            std::begin(res1), std::end(res1)
+        );
+
+        va1[std::slice{0, 3, 4}] = 0;
+        auto check2 = {0, 1, 2, 3, 0, 5, 6, 7, 0, 9, 10, 11};
+        test_eq(
+            "slice value assignment",
+            check2.begin(), check2.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        std::valarray<int> va2{100, 200, 300};
+        va1[std::slice{2, 3, 4}] += va2;
+        auto check3 = {0, 1, 102, 3, 0, 5, 206, 7, 0, 9, 310, 11};
+        test_eq(
+            "slice compound assignment",
+            check3.begin(), check3.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        va1[std::slice{0, 3, 1}] = va1[std::slice{9, 3, 1}];
+        auto check4 = {9, 310, 11, 3, 0, 5, 206, 7, 0, 9, 310, 11};
+        test_eq(
+            "slice to slice assignment",
+            check4.begin(), check4.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        std::valarray<int> va3(12);
+        for (size_t i = 0; i < va3.size(); ++i)
+            va3[i] = static_cast<int>(i);
+
+        /**
+         * Views the 12 elements as a 3x4 matrix, takes
+         * the first two rows and the middle two columns.
+         */
+        std::valarray<size_t> sizes{2, 2};
+        std::valarray<size_t> strides{4, 1};
+        std::gslice gs{1, sizes, strides};
+
+        const auto& cva3 = va3;
+        std::valarray<int> res2 = cva3[gs];
+        auto check5 = {1, 2, 5, 6};
+        test_eq(
+            "const gslice",
+            check5.begin(), check5.end(),
+            std::begin(res2), std::end(res2)
+        );
+
+        va3[gs] *= std::valarray<int>{10, 10, 10, 10};
+        auto check6 = {0, 10, 20, 3, 4, 50, 60, 7, 8, 9, 10, 11};
+        test_eq(
+            "gslice compound assignment",
+            check6.begin(), check6.end(),
+            std::begin(va3), std::end(va3)
+        );
+
+        std::valarray<int> res3 = va3[std::slice{0, 4, 1}];
+        auto check7 = {0, 10, 20, 3};
+        test_eq(
+            "slice_array conversion",
+            check7.begin(), check7.end(),
+            std::begin(res3), std::end(res3)
+        );
+    }
+
+    void valarray_test::test_masks_and_indices()
+    {
+        std::valarray<int> va1{5, -3, 8, -1, 0, 7};
+
+        va1[va1 < 0] = 0;
+        auto check1 = {5, 0, 8, 0, 0, 7};
+        test_eq(
+            "mask assignment",
+            check1.begin(), check1.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        const auto& cva1 = va1;
+        std::valarray<int> res1 = cva1[cva1 > 4];
+        auto check2 = {5, 8, 7};
+        test_eq(
+            "const mask",
+            check2.begin(), check2.end(),
+            std::begin(res1), std::end(res1)
+        );
+
+        va1[va1 > 4] -= std::valarray<int>{1, 2, 3};
+        auto check3 = {4, 0, 6, 0, 0, 4};
+        test_eq(
+            "mask compound assignment",
+            check3.begin(), check3.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        std::valarray<size_t> idx{5, 0, 2};
+        std::valarray<int> res2 = cva1[idx];
+        auto check4 = {4, 4, 6};
+        test_eq(
+            "const indirect",
+            check4.begin(), check4.end(),
+            std::begin(res2), std::end(res2)
+        );
+
+        va1[idx] = std::valarray<int>{1, 2, 3};
+        auto check5 = {2, 0, 3, 0, 0, 1};
+        test_eq(
+            "indirect assignment",
+            check5.begin(), check5.end(),
+            std::begin(va1), std::end(va1)
+        );
+    }
+
+    void valarray_test::test_member_functions()
+    {
+        std::valarray<int> va1{3, 1, 4, 1, 5, 9, 2};
+
+        test_eq("sum", va1.sum(), 25);
+        test_eq("min", va1.min(), 1);
+        test_eq("max", va1.max(), 9);
+
+        std::valarray<int> res1 = va1.shift(2);
+        auto check1 = {4, 1, 5, 9, 2, 0, 0};
+        test_eq(
+            "shift left",
+            check1.begin(), check1.end(),
+            std::begin(res1), std::end(res1)
+        );
+
+        std::valarray<int> res2 = va1.shift(-3);
+        auto check2 = {0, 0, 0, 3, 1, 4, 1};
+        test_eq(
+            "shift right",
+            check2.begin(), check2.end(),
+            std::begin(res2), std::end(res2)
+        );
+
+        std::valarray<int> res3 = va1.cshift(3);
+        auto check3 = {1, 5, 9, 2, 3, 1, 4};
+        test_eq(
+            "cshift left",
+            check3.begin(), check3.end(),
+            std::begin(res3), std::end(res3)
+        );
+
+        std::valarray<int> res4 = va1.cshift(-9);
+        auto check4 = {9, 2, 3, 1, 4, 1, 5};
+        test_eq(
+            "cshift right",
+            check4.begin(), check4.end(),
+            std::begin(res4), std::end(res4)
+        );
+
+        std::valarray<int> res5 = va1.apply([](int x){ return x * x; });
+        auto check5 = {9, 1, 16, 1, 25, 81, 4};
+        test_eq(
+            "apply",
+            check5.begin(), check5.end(),
+            std::begin(res5), std::end(res5)
+        );
+
+        va1.resize(3, 6);
+        auto check6 = {6, 6, 6};
+        test_eq(
+            "resize",
+            check6.begin(), check6.end(),
+            std::begin(va1), std::end(va1)
+        );
+
+        std::valarray<int> va2{1, 2};
+        std::swap(va1, va2);
+        test_eq("swap pt1", va1.size(), 2U);
+        test_eq("swap pt2", va2.size(), 3U);
+
+        std::valarray<float> va3(1.0f, 1001);
+        test_eq("float sum", va3.sum(), 1001.0f);
+
+        std::valarray<double> va4{};
+        test_eq("empty sum", va4.sum(), 0.0);
+    }
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/test/bench.hpp>
+#include <__bits/test/tests.hpp>
+#include <valarray>
+
+namespace std::test
+{
+    bool valarray_benchmark::run(bool report)
+    {
+        report_ = report;
+        start();
+
+        reseed();
+        std::valarray<float> left(sample_count);
+        std::valarray<float> right(sample_count);
+        for (size_t i = 0; i < sample_count; ++i)
+        {
+            left[i] = static_cast<float>(random() % 65536) - 32768.f;
+            right[i] = static_cast<float>(random() % 65536) - 32768.f;
+        }
+
+        /**
+         * Mixing two channels down with a gain is the
+         * reference for the rest, written as a plain loop
+         * over raw pointers.
+         */
+        const float gain{0.7f};
+        std::valarray<float> expected(sample_count);
+        measure("mix by hand", [&](){
+            for (size_t round = 0; round < round_count; ++round)
+            {
+                auto l = std::begin(left);
+                auto r = std::begin(right);
+                auto out = std::begin(expected);
+                for (size_t i = 0; i < sample_count; ++i)
+                    out[i] = (l[i] + r[i]) * gain;
+            }
+        });
+
+        std::valarray<float> mixed(sample_count);
+        measure("mix expression", [&](){
+            for (size_t round = 0; round < round_count; ++round)
+                mixed = (left + right) * gain;
+        });
+        test_eq(
+            "mix expression",
+            std::begin(expected), std::end(expected),
+            std::begin(mixed), std::end(mixed)
+        );
+
+        /**
+         * Longer chains are still evaluated in a single
+         * pass, without temporary arrays.
+         */
+        const float fade{0.25f};
+        measure("crossfade expression", [&](){
+            for (size_t round = 0; round < round_count; ++round)
+                mixed = left * fade + right * (1.f - fade) - (left - right) * 0.5f;
+        });
+        test("crossfade expression", mixed.size() == sample_count);
+
+        measure("gain in place", [&](){
+            for (size_t round = 0; round < round_count; ++round)
+                mixed *= 1.0001f;
+        });
+
+        std::valarray<double> samples(sample_count);
+        for (size_t i = 0; i < sample_count; ++i)
+            samples[i] = static_cast<double>(random() % 1000) / 10.0;
+
+        double mean{};
+        double variance{};
+        measure("mean and variance", [&](){
+            for (size_t round = 0; round < round_count; ++round)
+            {
+                mean = samples.sum() / sample_count;
+                variance = ((samples - mean) * (samples - mean)).sum() / sample_count;
+            }
+        });
+        test("mean in range", 0.0 <= mean && mean < 100.0);
+        test("variance positive", variance > 0.0);
+
+        size_t outliers{};
+        measure("mask selection", [&](){
+            for (size_t round = 0; round < round_count; ++round)
+            {
+                std::valarray<double> selected = samples[samples > mean + 40.0];
+                outliers += selected.size();
+            }
+        });
+        test("mask selection", outliers > 0);
+
+        return end();
+    }
+
+    const char* valarray_benchmark::name()
+    {
+        return "valarray";
+    }
+}
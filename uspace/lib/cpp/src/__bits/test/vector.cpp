@@ -29,11 +29,58 @@
 #include <__bits/test/tests.hpp>
 #include <algorithm>
 #include <initializer_list>
+#include <iterator>
+#include <string>
 #include <utility>
 #include <vector>
 
 namespace std::test
 {
+    namespace
+    {
+        /**
+         * Single pass iterator, vector has to insert
+         * from it without knowing the size in advance.
+         */
+        struct input_iterator
+        {
+            using iterator_category = std::input_iterator_tag;
+            using value_type        = int;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const int*;
+            using reference         = const int&;
+
+            const int* ptr;
+
+            reference operator*() const
+            {
+                return *ptr;
+            }
+
+            input_iterator& operator++()
+            {
+                ++ptr;
+
+                return *this;
+            }
+
+            input_iterator operator++(int)
+            {
+                return input_iterator{ptr++};
+            }
+
+            bool operator==(const input_iterator& other) const
+            {
+                return ptr == other.ptr;
+            }
+
+            bool operator!=(const input_iterator& other) const
+            {
+                return ptr != other.ptr;
+            }
+        };
+    }
+
     bool vector_test::run(bool report)
     {
         report_ = report;
@@ -42,6 +89,8 @@ namespace std::test
         test_construction_and_assignment();
         test_insert();
         test_erase();
+        test_nontrivial();
+        test_growth();
 
         return end();
     }
@@ -85,7 +134,12 @@ namespace std::test
             check3.begin(), check3.end()
         );
 
-        // TODO: iterator constructor when implemented
+        std::vector<int> vec5(check1.begin(), check1.end());
+        test_eq(
+            "iterator constructor",
+            vec5.begin(), vec5.end(),
+            check1.begin(), check1.end()
+        );
 
         std::vector<int> vec6{vec4};
         test_eq(
@@ -189,6 +243,40 @@ namespace std::test
             vec6.begin(), vec6.end(),
             check3.begin(), check3.end()
         );
+
+        /**
+         * Inserting nothing must leave non-trivial
+         * elements untouched.
+         */
+        auto check4 = {
+            std::string{"alpha, long enough not to be short"},
+            std::string{"beta, long enough not to be short"},
+            std::string{"c"}
+        };
+        std::vector<std::string> empty{};
+
+        std::vector<std::string> vec7{check4};
+        auto it7 = vec7.insert(vec7.begin() + 1, empty.begin(), empty.end());
+        test_eq(
+            "empty range insert",
+            vec7.begin(), vec7.end(),
+            check4.begin(), check4.end()
+        );
+        test_eq("empty range insert position", it7, vec7.begin() + 1);
+
+        vec7.insert(vec7.begin(), 0ul, std::string{"x"});
+        test_eq(
+            "zero count insert",
+            vec7.begin(), vec7.end(),
+            check4.begin(), check4.end()
+        );
+
+        vec7.insert(vec7.begin() + 2, std::initializer_list<std::string>{});
+        test_eq(
+            "empty initializer list insert",
+            vec7.begin(), vec7.end(),
+            check4.begin(), check4.end()
+        );
     }
 
     void vector_test::test_erase()
@@ -227,4 +315,134 @@ namespace std::test
             check3.begin(), check3.end()
         );
     }
+
+    void vector_test::test_nontrivial()
+    {
+        /**
+         * Elements that own memory have to be constructed
+         * and destroyed, not assigned into raw storage.
+         */
+        using elem_t = std::vector<int>;
+        elem_t a{1, 2, 3};
+        elem_t b{4, 5};
+        elem_t c{6};
+
+        std::vector<elem_t> vec1(3ul, a);
+        auto check1 = {a, a, a};
+        test_eq(
+            "nontrivial replication constructor",
+            vec1.begin(), vec1.end(),
+            check1.begin(), check1.end()
+        );
+
+        std::vector<elem_t> vec2{vec1};
+        test_eq(
+            "nontrivial copy constructor",
+            vec2.begin(), vec2.end(),
+            check1.begin(), check1.end()
+        );
+
+        std::vector<elem_t> vec3{};
+        vec3.push_back(b);
+        for (int i = 0; i < 20; ++i)
+            vec3.push_back(vec3.front());
+        test_eq("nontrivial push_back of own element pt1", vec3.size(), 21ul);
+        test_eq("nontrivial push_back of own element pt2", vec3.back(), b);
+
+        std::vector<elem_t> vec4{a, b};
+        vec4.resize(5, vec4[1]);
+        auto check2 = {a, b, b, b, b};
+        test_eq(
+            "nontrivial resize up",
+            vec4.begin(), vec4.end(),
+            check2.begin(), check2.end()
+        );
+
+        vec4.resize(1);
+        test_eq("nontrivial resize down pt1", vec4.size(), 1ul);
+        test_eq("nontrivial resize down pt2", vec4.front(), a);
+
+        std::vector<elem_t> vec5{a, c};
+        vec5.insert(vec5.begin() + 1, 2ul, b);
+        vec5.emplace(vec5.begin(), 2ul, 7);
+        auto check3 = {elem_t{7, 7}, a, b, b, c};
+        test_eq(
+            "nontrivial insert",
+            vec5.begin(), vec5.end(),
+            check3.begin(), check3.end()
+        );
+
+        vec5.erase(vec5.begin() + 1, vec5.begin() + 3);
+        auto check4 = {elem_t{7, 7}, b, c};
+        test_eq(
+            "nontrivial erase",
+            vec5.begin(), vec5.end(),
+            check4.begin(), check4.end()
+        );
+    }
+
+    void vector_test::test_growth()
+    {
+        std::vector<int> vec1{};
+        for (int i = 0; i < 1000; ++i)
+            vec1.push_back(i);
+
+        bool ok{true};
+        for (int i = 0; i < 1000; ++i)
+            ok = ok && vec1[i] == i;
+        test("push_back growth", ok && vec1.capacity() >= vec1.size());
+
+        std::vector<std::string> vec2{};
+        for (int i = 0; i < 100; ++i)
+            vec2.emplace_back(20, static_cast<char>('a' + i % 26));
+        test_eq("growth with non trivial elements", vec2[99], std::string(20, 'v'));
+
+        std::vector<int> vec3{};
+        vec3.insert(vec3.end(), vec1.begin(), vec1.end());
+        test_eq("range insert reserves exactly", vec3.capacity(), 1000ul);
+        test_eq(
+            "range insert contents",
+            vec3.begin(), vec3.end(),
+            vec1.begin(), vec1.end()
+        );
+
+        auto check1 = {0, 1, 7, 8, 9, 2, 3};
+        std::vector<int> vec4{0, 1, 2, 3};
+        vec4.shrink_to_fit();
+        vec4.insert(vec4.begin() + 2, {7, 8, 9});
+        test_eq(
+            "insert with reallocation",
+            vec4.begin(), vec4.end(),
+            check1.begin(), check1.end()
+        );
+
+        std::vector<int> vec5{};
+        vec5.reserve(100);
+        auto data = vec5.data();
+        vec5.assign(vec1.begin(), vec1.begin() + 50);
+        test("assign reuses storage", vec5.data() == data && vec5.size() == 50);
+        test_eq("assign contents", vec5[49], 49);
+
+        auto check2 = {0, 1, 5, 6, 7, 2};
+        int input[]{5, 6, 7};
+        std::vector<int> vec6{0, 1, 2};
+        vec6.insert(
+            vec6.begin() + 2, input_iterator{input},
+            input_iterator{input + 3}
+        );
+        test_eq(
+            "input iterator insert",
+            vec6.begin(), vec6.end(),
+            check2.begin(), check2.end()
+        );
+
+        auto check3 = {0, 3, 3, 1, 2};
+        std::vector<int> vec7{0, 1, 2};
+        vec7.insert(vec7.begin() + 1, 2, 3);
+        test_eq(
+            "integral iterator insert",
+            vec7.begin(), vec7.end(),
+            check3.begin(), check3.end()
+        );
+    }
 }
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/thread/thread_pool.hpp>
+#include <cassert>
+#include <thread>
+
+namespace std::aux
+{
+    namespace
+    {
+        size_t pool_size(size_t size)
+        {
+            if (size > 0)
+                return size;
+
+            auto cpus = std::thread::hardware_concurrency();
+
+            return cpus > 0 ? cpus : 4;
+        }
+    }
+
+    thread_local thread_pool::worker* thread_pool::current_worker_{nullptr};
+
+    thread_pool::thread_pool(size_t size)
+        : workers_{}, size_{pool_size(size)},
+          queued_{0}, idle_{0}, next_{0},
+          idle_mtx_{}, idle_cv_{}
+    {
+        threading::mutex::init(idle_mtx_);
+        threading::condvar::init(idle_cv_);
+
+        workers_ = new worker[size_];
+        for (size_t i = 0; i < size_; ++i)
+        {
+            auto& w = workers_[i];
+            w.pool = this;
+            w.idx = i;
+            w.head = nullptr;
+            w.tail = nullptr;
+            threading::mutex::init(w.mtx);
+        }
+
+        threading::thread::enable_multithreaded();
+
+        for (size_t i = 0; i < size_; ++i)
+        {
+            auto fid = threading::thread::create(worker_main_, workers_[i]);
+            assert(fid);
+
+            threading::thread::start(fid);
+        }
+    }
+
+    void thread_pool::submit(pool_task* task)
+    {
+        if (current_worker_ && current_worker_->pool == this)
+            push_(*current_worker_, task);
+        else
+            push_(workers_[next_.fetch_add(1, memory_order_relaxed) % size_], task);
+
+        /**
+         * Pairs with sleep_(), which announces the worker as
+         * idle before checking queued_, so either the worker
+         * sees the new task or we see the idle worker.
+         */
+        if (idle_.load() > 0)
+        {
+            threading::mutex::lock(idle_mtx_);
+            threading::condvar::signal(idle_cv_);
+            threading::mutex::unlock(idle_mtx_);
+        }
+    }
+
+    thread_pool& thread_pool::default_pool()
+    {
+        static thread_pool* pool = new thread_pool{};
+
+        return *pool;
+    }
+
+    void thread_pool::push_(worker& w, pool_task* task)
+    {
+        threading::mutex::lock(w.mtx);
+
+        queued_.fetch_add(1);
+
+        task->next_ = nullptr;
+        task->prev_ = w.tail;
+        if (w.tail)
+            w.tail->next_ = task;
+        else
+            w.head = task;
+        w.tail = task;
+
+        threading::mutex::unlock(w.mtx);
+    }
+
+    pool_task* thread_pool::pop_back_(worker& w)
+    {
+        threading::mutex::lock(w.mtx);
+
+        auto task = w.tail;
+        if (task)
+        {
+            w.tail = task->prev_;
+            if (w.tail)
+                w.tail->next_ = nullptr;
+            else
+                w.head = nullptr;
+
+            queued_.fetch_sub(1);
+        }
+
+        threading::mutex::unlock(w.mtx);
+
+        return task;
+    }
+
+    pool_task* thread_pool::pop_front_(worker& w)
+    {
+        threading::mutex::lock(w.mtx);
+
+        auto task = w.head;
+        if (task)
+        {
+            w.head = task->next_;
+            if (w.head)
+                w.head->prev_ = nullptr;
+            else
+                w.tail = nullptr;
+
+            queued_.fetch_sub(1);
+        }
+
+        threading::mutex::unlock(w.mtx);
+
+        return task;
+    }
+
+    pool_task* thread_pool::take_(worker& w)
+    {
+        if (auto task = pop_back_(w))
+            return task;
+
+        for (size_t i = 1; i < size_; ++i)
+        {
+            if (auto task = pop_front_(workers_[(w.idx + i) % size_]))
+                return task;
+        }
+
+        return nullptr;
+    }
+
+    void thread_pool::sleep_()
+    {
+        threading::mutex::lock(idle_mtx_);
+
+        idle_.fetch_add(1);
+        while (queued_.load() == 0)
+            threading::condvar::wait(idle_cv_, idle_mtx_);
+        idle_.fetch_sub(1);
+
+        threading::mutex::unlock(idle_mtx_);
+    }
+
+    int thread_pool::worker_main_(void* arg)
+    {
+        auto& w = *static_cast<worker*>(arg);
+        auto& pool = *w.pool;
+        current_worker_ = &w;
+
+        while (true)
+        {
+            auto task = pool.take_(w);
+            if (!task)
+            {
+                /**
+                 * If queued_ is not zero the task we missed was
+                 * pushed to a queue we had already checked (or
+                 * another worker got it first), in which case
+                 * sleep_ returns immediately and we retry.
+                 */
+                pool.sleep_();
+                continue;
+            }
+
+            task->run();
+            task->release();
+        }
+
+        return 0;
+    }
+}
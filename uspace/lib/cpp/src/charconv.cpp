@@ -0,0 +1,1649 @@
+/*
+ * Copyright (c) 2019 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace std::hel
+{
+    extern "C" {
+        #include <ieee_double.h>
+    }
+}
+
+namespace std
+{
+    /**
+     * 23.20, primitive numeric conversions:
+     */
+
+    namespace aux
+    {
+        namespace
+        {
+            /**
+             * Two digits per division halves the number of
+             * (expensive) 64bit divisions when formatting.
+             */
+            constexpr char digit_pairs[] =
+                "00010203040506070809"
+                "10111213141516171819"
+                "20212223242526272829"
+                "30313233343536373839"
+                "40414243444546474849"
+                "50515253545556575859"
+                "60616263646566676869"
+                "70717273747576777879"
+                "80818283848586878889"
+                "90919293949596979899";
+
+            constexpr char digit_chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+            int count_digits(unsigned long long value, int base)
+            {
+                if (base == 10)
+                {
+                    int count{1};
+                    while (true)
+                    {
+                        if (value < 10ULL)
+                            return count;
+                        if (value < 100ULL)
+                            return count + 1;
+                        if (value < 1000ULL)
+                            return count + 2;
+                        if (value < 10000ULL)
+                            return count + 3;
+
+                        value /= 10000ULL;
+                        count += 4;
+                    }
+                }
+
+                int count{1};
+                auto ubase = static_cast<unsigned long long>(base);
+                while (value >= ubase)
+                {
+                    value /= ubase;
+                    ++count;
+                }
+
+                return count;
+            }
+
+            int digit_value(char c)
+            {
+                if ('0' <= c && c <= '9')
+                    return c - '0';
+                else if ('a' <= c && c <= 'z')
+                    return c - 'a' + 10;
+                else if ('A' <= c && c <= 'Z')
+                    return c - 'A' + 10;
+                else
+                    return 36;
+            }
+
+            /**
+             * Bounded output used by the floating point
+             * formatting, remembers if anything did not fit.
+             */
+            class char_writer
+            {
+                public:
+                    char_writer(char* first, char* last)
+                        : ptr_{first}, last_{last}, ok_{true}
+                    { /* DUMMY BODY */ }
+
+                    void put(char c)
+                    {
+                        if (ptr_ < last_)
+                            *ptr_++ = c;
+                        else
+                            ok_ = false;
+                    }
+
+                    void put(const char* str, int count)
+                    {
+                        if (count <= 0)
+                            return;
+
+                        if (last_ - ptr_ >= count)
+                        {
+                            for (int i = 0; i < count; ++i)
+                                *ptr_++ = str[i];
+                        }
+                        else
+                            ok_ = false;
+                    }
+
+                    void fill(char c, int count)
+                    {
+                        if (count <= 0)
+                            return;
+
+                        if (last_ - ptr_ >= count)
+                        {
+                            for (int i = 0; i < count; ++i)
+                                *ptr_++ = c;
+                        }
+                        else
+                            ok_ = false;
+                    }
+
+                    to_chars_result result() const
+                    {
+                        if (ok_)
+                            return to_chars_result{ptr_, errc{}};
+                        else
+                            return to_chars_result{last_, errc::value_too_large};
+                    }
+
+                private:
+                    char* ptr_;
+                    char* last_;
+                    bool ok_;
+            };
+
+            /**
+             * Unsigned integer wide enough for the exact decimal
+             * conversion of any double (a bit over 1100 bits).
+             */
+            class big_uint
+            {
+                public:
+                    big_uint()
+                        : size_{0}
+                    { /* DUMMY BODY */ }
+
+                    explicit big_uint(uint64_t value)
+                        : size_{0}
+                    {
+                        while (value != 0)
+                        {
+                            words_[size_++] = static_cast<uint32_t>(value);
+                            value >>= 32;
+                        }
+                    }
+
+                    bool is_zero() const
+                    {
+                        return size_ == 0;
+                    }
+
+                    void mul(uint32_t factor)
+                    {
+                        uint64_t carry{};
+                        for (int i = 0; i < size_; ++i)
+                        {
+                            carry += static_cast<uint64_t>(words_[i]) * factor;
+                            words_[i] = static_cast<uint32_t>(carry);
+                            carry >>= 32;
+                        }
+
+                        if (carry != 0)
+                            push_(static_cast<uint32_t>(carry));
+                    }
+
+                    void mul_pow2(int exp)
+                    {
+                        if (size_ == 0 || exp == 0)
+                            return;
+
+                        int word_shift = exp / 32;
+                        int bit_shift = exp % 32;
+
+                        assert(size_ + word_shift < max_words);
+                        if (bit_shift != 0)
+                        {
+                            words_[size_] = 0;
+                            for (int i = size_; i > 0; --i)
+                            {
+                                words_[i + word_shift] =
+                                    (words_[i] << bit_shift) |
+                                    (words_[i - 1] >> (32 - bit_shift));
+                            }
+                            words_[word_shift] = words_[0] << bit_shift;
+                            size_ += word_shift + 1;
+                        }
+                        else
+                        {
+                            for (int i = size_ - 1; i >= 0; --i)
+                                words_[i + word_shift] = words_[i];
+                            size_ += word_shift;
+                        }
+
+                        for (int i = 0; i < word_shift; ++i)
+                            words_[i] = 0;
+                        trim_();
+                    }
+
+                    void mul_pow10(int exp)
+                    {
+                        // 10^exp == 5^exp * 2^exp and 5^13 fits 32 bits.
+                        constexpr uint32_t pow5[] = {
+                            1U, 5U, 25U, 125U, 625U, 3125U, 15625U, 78125U,
+                            390625U, 1953125U, 9765625U, 48828125U,
+                            244140625U, 1220703125U
+                        };
+
+                        int rest = exp;
+                        for (; rest >= 13; rest -= 13)
+                            mul(pow5[13]);
+                        if (rest > 0)
+                            mul(pow5[rest]);
+
+                        mul_pow2(exp);
+                    }
+
+                    /**
+                     * Subtracts factor * other, which must not
+                     * be greater than this number.
+                     */
+                    void sub_mul(const big_uint& other, uint32_t factor)
+                    {
+                        uint64_t carry{};
+                        uint64_t borrow{};
+                        for (int i = 0; i < size_; ++i)
+                        {
+                            carry += static_cast<uint64_t>(other.word_(i)) * factor;
+                            auto diff = static_cast<uint64_t>(words_[i])
+                                      - static_cast<uint32_t>(carry) - borrow;
+                            words_[i] = static_cast<uint32_t>(diff);
+                            borrow = (diff >> 32) & 1;
+                            carry >>= 32;
+                        }
+
+                        assert(carry == 0 && borrow == 0);
+                        trim_();
+                    }
+
+                    /**
+                     * Number of bits to shift this number by so that
+                     * its most significant word is in [2^27, 2^28).
+                     */
+                    int normalizing_shift() const
+                    {
+                        auto top = words_[size_ - 1];
+
+                        return (27 - (31 - __builtin_clz(top)) + 32) % 32;
+                    }
+
+                    /**
+                     * Returns the (single digit) quotient of this / other
+                     * and replaces this by the remainder. The divisor must
+                     * be normalized and the quotient less than ten.
+                     */
+                    int divide(const big_uint& other)
+                    {
+                        if (size_ < other.size_)
+                            return 0;
+
+                        /**
+                         * The top word of the divisor is large enough for
+                         * this estimate to be at most one less than the
+                         * quotient.
+                         */
+                        int idx = other.size_ - 1;
+                        auto quot = words_[idx] / (other.words_[idx] + 1);
+                        if (quot != 0)
+                            sub_mul(other, quot);
+
+                        while (compare(*this, other) >= 0)
+                        {
+                            sub_mul(other, 1);
+                            ++quot;
+                        }
+
+                        return static_cast<int>(quot);
+                    }
+
+                    friend int compare(const big_uint& lhs, const big_uint& rhs)
+                    {
+                        if (lhs.size_ != rhs.size_)
+                            return lhs.size_ < rhs.size_ ? -1 : 1;
+
+                        for (int i = lhs.size_ - 1; i >= 0; --i)
+                        {
+                            if (lhs.words_[i] != rhs.words_[i])
+                                return lhs.words_[i] < rhs.words_[i] ? -1 : 1;
+                        }
+
+                        return 0;
+                    }
+
+                    /**
+                     * Compares lhs1 + lhs2 to rhs.
+                     */
+                    friend int compare(const big_uint& lhs1, const big_uint& lhs2,
+                                       const big_uint& rhs)
+                    {
+                        big_uint sum{};
+                        sum.size_ = max(lhs1.size_, lhs2.size_);
+
+                        uint64_t carry{};
+                        for (int i = 0; i < sum.size_; ++i)
+                        {
+                            carry += static_cast<uint64_t>(lhs1.word_(i)) + lhs2.word_(i);
+                            sum.words_[i] = static_cast<uint32_t>(carry);
+                            carry >>= 32;
+                        }
+
+                        if (carry != 0)
+                            sum.push_(static_cast<uint32_t>(carry));
+
+                        return compare(sum, rhs);
+                    }
+
+                private:
+                    static constexpr int max_words{40};
+
+                    uint32_t words_[max_words];
+                    int size_;
+
+                    uint32_t word_(int idx) const
+                    {
+                        return idx < size_ ? words_[idx] : 0U;
+                    }
+
+                    void push_(uint32_t word)
+                    {
+                        assert(size_ < max_words);
+                        words_[size_++] = word;
+                    }
+
+                    void trim_()
+                    {
+                        while (size_ > 0 && words_[size_ - 1] == 0)
+                            --size_;
+                    }
+            };
+
+#if defined(__SIZEOF_INT128__)
+            /**
+             * Same as big_uint for numbers that fit 128 bits,
+             * which is enough for doubles of moderate magnitude.
+             */
+            class small_uint
+            {
+                public:
+                    small_uint()
+                        : value_{0}
+                    { /* DUMMY BODY */ }
+
+                    explicit small_uint(uint64_t value)
+                        : value_{value}
+                    { /* DUMMY BODY */ }
+
+                    bool is_zero() const
+                    {
+                        return value_ == 0;
+                    }
+
+                    void mul(uint32_t factor)
+                    {
+                        value_ *= factor;
+                    }
+
+                    void mul_pow2(int exp)
+                    {
+                        value_ <<= exp;
+                    }
+
+                    void mul_pow10(int exp)
+                    {
+                        for (; exp > 0; --exp)
+                            value_ *= 10U;
+                    }
+
+                    int normalizing_shift() const
+                    {
+                        return 0;
+                    }
+
+                    int divide(const small_uint& other)
+                    {
+                        if (((value_ | other.value_) >> 64) == 0)
+                        {
+                            auto lhs = static_cast<uint64_t>(value_);
+                            auto rhs = static_cast<uint64_t>(other.value_);
+                            auto quot = lhs / rhs;
+                            value_ = lhs - quot * rhs;
+
+                            return static_cast<int>(quot);
+                        }
+
+                        // The quotient is a single digit.
+                        int quot{};
+                        while (value_ >= other.value_)
+                        {
+                            value_ -= other.value_;
+                            ++quot;
+                        }
+
+                        return quot;
+                    }
+
+                    friend int compare(const small_uint& lhs, const small_uint& rhs)
+                    {
+                        if (lhs.value_ == rhs.value_)
+                            return 0;
+
+                        return lhs.value_ < rhs.value_ ? -1 : 1;
+                    }
+
+                    friend int compare(const small_uint& lhs1, const small_uint& lhs2,
+                                       const small_uint& rhs)
+                    {
+                        small_uint sum{};
+                        sum.value_ = lhs1.value_ + lhs2.value_;
+
+                        return compare(sum, rhs);
+                    }
+
+                private:
+                    unsigned __int128 value_;
+            };
+#endif
+
+            /**
+             * A double has at most 767 significant decimal
+             * digits, i.e. its conversion is always exact.
+             */
+            constexpr int max_double_digits{768};
+
+            /**
+             * Decimal digits of a double, its value
+             * is (-1)^neg * digits * 10^dec_exp.
+             */
+            struct double_digits
+            {
+                char buf[max_double_digits];
+                int len;
+                int dec_exp;
+                bool neg;
+            };
+
+            void zero_digits(double_digits& d)
+            {
+                d.buf[0] = '0';
+                d.len = 1;
+                d.dec_exp = 0;
+            }
+
+            /**
+             * Returns k such that 10^(k-1) <= value, k is at most
+             * one less than the smallest k such that value < 10^k.
+             * Here value is significand * 2^exp.
+             */
+            int estimate_dec_exp(uint64_t significand, int exp)
+            {
+                // Exponent of the most significant bit of value.
+                int bin_exp = exp + 63 - __builtin_clzll(significand);
+
+                /**
+                 * Approximations of log10(2) that err on the
+                 * side of a smaller result.
+                 */
+                if (bin_exp >= 0)
+                    return ((bin_exp * 78913) >> 18) + 1;
+                else
+                    return -((-bin_exp * 78914 + (1 << 18) - 1) >> 18) + 1;
+            }
+
+            /**
+             * Calls fun with a number of the smallest type that
+             * can hold the (scaled) values needed for the exact
+             * conversion of significand * 2^exp.
+             */
+            template<class Function>
+            auto with_uint_for(uint64_t significand, int exp, Function fun)
+            {
+#if defined(__SIZEOF_INT128__)
+                /**
+                 * Bits of the values scaled by 10^k (k as estimated,
+                 * log2(10) < 107 / 32) plus some for the boundaries and
+                 * the occasional multiplication by ten.
+                 */
+                int k = estimate_dec_exp(significand, exp);
+                int pow10_bits = ((k < 0 ? -k : k) * 107 + 31) / 32;
+                int r_bits = 64 - __builtin_clzll(significand) + max(exp, 0)
+                           + (k < 0 ? pow10_bits : 0);
+                int s_bits = max(-exp, 0) + (k > 0 ? pow10_bits : 0);
+
+                if (max(r_bits, s_bits) <= 128 - 12)
+                    return fun(small_uint{});
+#endif
+
+                return fun(big_uint{});
+            }
+
+            /**
+             * Note: The following mostly follows the %e/%f/%g
+             *       implementation of our printf (minus the width and
+             *       flags handling), except that the digits are exact
+             *       and rounded half to even (our printf rounds using
+             *       only the first 17 or so digits).
+             */
+
+            void trim_trailing_zeros(double_digits& d)
+            {
+                while (2 <= d.len && d.buf[d.len - 1] == '0')
+                {
+                    --d.len;
+                    ++d.dec_exp;
+                }
+            }
+
+            /**
+             * Generates the shortest digits that convert back to val
+             * and out of those the ones closest to val, using
+             * the free-format algorithm of Steele & White (as
+             * improved by Burger & Dybvig).
+             */
+            template<class Uint>
+            void shortest_digits(const hel::ieee_double_t& val, double_digits& d)
+            {
+                auto f = val.pos_val.significand;
+                auto e = val.pos_val.exponent;
+
+                /**
+                 * The value is r / s and the distances to the halfway
+                 * points between val and its neighbours are m_plus / s
+                 * and m_minus / s, the lower one is closer if we are
+                 * at a power of two.
+                 */
+                int shift = val.is_accuracy_step ? 2 : 1;
+                Uint r{f};
+                Uint s{1};
+                Uint m_plus{1};
+                Uint m_minus{1};
+
+                r.mul_pow2(shift);
+                s.mul_pow2(shift);
+                m_plus.mul_pow2(shift - 1);
+                if (e >= 0)
+                {
+                    r.mul_pow2(e);
+                    m_plus.mul_pow2(e);
+                    m_minus.mul_pow2(e);
+                }
+                else
+                    s.mul_pow2(-e);
+
+                int k = estimate_dec_exp(f, e);
+                if (k >= 0)
+                    s.mul_pow10(k);
+                else
+                {
+                    r.mul_pow10(-k);
+                    m_plus.mul_pow10(-k);
+                    m_minus.mul_pow10(-k);
+                }
+
+                /**
+                 * Round to even makes the halfway points
+                 * convert to val if its significand is even.
+                 */
+                bool even = (f % 2 == 0);
+                auto is_low = [&](){
+                    auto cmp = compare(r, m_minus);
+
+                    return even ? cmp <= 0 : cmp < 0;
+                };
+                auto is_high = [&](){
+                    auto cmp = compare(r, m_plus, s);
+
+                    return even ? cmp >= 0 : cmp > 0;
+                };
+
+                while (is_high())
+                {
+                    s.mul(10);
+                    ++k;
+                }
+
+                int norm = s.normalizing_shift();
+                r.mul_pow2(norm);
+                s.mul_pow2(norm);
+                m_plus.mul_pow2(norm);
+                m_minus.mul_pow2(norm);
+
+                d.len = 0;
+                while (true)
+                {
+                    r.mul(10);
+                    m_plus.mul(10);
+                    m_minus.mul(10);
+
+                    int digit = r.divide(s);
+                    bool low = is_low();
+                    bool high = is_high();
+
+                    if (low && high)
+                    {
+                        auto cmp = compare(r, r, s);
+                        if (cmp > 0 || (cmp == 0 && digit % 2 == 1))
+                            ++digit;
+                    }
+                    else if (high)
+                        ++digit;
+
+                    d.buf[d.len++] = static_cast<char>('0' + digit);
+                    if (low || high)
+                        break;
+                }
+
+                d.dec_exp = k - d.len;
+            }
+
+            void shortest_digits(const hel::ieee_double_t& val, double_digits& d)
+            {
+                d.neg = val.is_negative;
+                if (val.pos_val.significand == 0)
+                {
+                    zero_digits(d);
+
+                    return;
+                }
+
+                with_uint_for(
+                    val.pos_val.significand, val.pos_val.exponent,
+                    [&](auto tag){
+                        shortest_digits<decltype(tag)>(val, d);
+                    }
+                );
+            }
+
+            /**
+             * Generates the exact decimal digits of (nonzero)
+             * significand * 2^exp one by one, the value
+             * is 0.d1d2d3... * 10^dec_exp().
+             */
+            template<class Uint>
+            class digit_generator
+            {
+                public:
+                    digit_generator(uint64_t significand, int exp)
+                        : r_{significand}, s_{1}, k_{estimate_dec_exp(significand, exp)}
+                    {
+                        // The rest of the value is r_ / s_ * 10^(k_ - digits so far).
+                        if (exp >= 0)
+                            r_.mul_pow2(exp);
+                        else
+                            s_.mul_pow2(-exp);
+
+                        if (k_ >= 0)
+                            s_.mul_pow10(k_);
+                        else
+                            r_.mul_pow10(-k_);
+
+                        while (compare(r_, s_) >= 0)
+                        {
+                            s_.mul(10);
+                            ++k_;
+                        }
+
+                        int norm = s_.normalizing_shift();
+                        r_.mul_pow2(norm);
+                        s_.mul_pow2(norm);
+                    }
+
+                    int dec_exp() const
+                    {
+                        return k_;
+                    }
+
+                    /**
+                     * All the following digits are zeros.
+                     */
+                    bool done() const
+                    {
+                        return r_.is_zero();
+                    }
+
+                    int next()
+                    {
+                        r_.mul(10);
+
+                        return r_.divide(s_);
+                    }
+
+                    /**
+                     * Compares the rest of the value (the following
+                     * digits) to half of the last generated place.
+                     */
+                    int compare_rest_to_half() const
+                    {
+                        return compare(r_, r_, s_);
+                    }
+
+                private:
+                    Uint r_;
+                    Uint s_;
+                    int k_;
+            };
+
+            /**
+             * Generates the digits of val rounded (half to even)
+             * to signif significant digits or, if signif is negative,
+             * to frac fractional digits.
+             */
+            template<class Uint>
+            void exact_digits(const hel::ieee_double_t& val, double_digits& d,
+                              int signif, int frac)
+            {
+                digit_generator<Uint> gen{val.pos_val.significand, val.pos_val.exponent};
+                int k = gen.dec_exp();
+
+                int count = signif > 0 ? signif : k + frac;
+                if (count <= 0)
+                {
+                    // Rounds either to zero or to one in the last place.
+                    zero_digits(d);
+                    if (count == 0 && gen.compare_rest_to_half() > 0)
+                    {
+                        d.buf[0] = '1';
+                        d.dec_exp = k;
+                    }
+
+                    return;
+                }
+
+                // The remaining digits are zeros once the remainder is.
+                d.len = 0;
+                while (d.len < count && !gen.done())
+                {
+                    assert(d.len < max_double_digits);
+
+                    d.buf[d.len++] = static_cast<char>('0' + gen.next());
+                }
+
+                auto cmp = gen.compare_rest_to_half();
+                if (cmp > 0 || (cmp == 0 && (d.buf[d.len - 1] - '0') % 2 == 1))
+                {
+                    int idx = d.len - 1;
+                    while (0 <= idx && d.buf[idx] == '9')
+                        --idx;
+
+                    if (0 <= idx)
+                    {
+                        ++d.buf[idx];
+                        d.len = idx + 1;
+                    }
+                    else
+                    {
+                        d.buf[0] = '1';
+                        d.len = 1;
+                        ++k;
+                    }
+                }
+
+                d.dec_exp = k - d.len;
+            }
+
+            void exact_digits(const hel::ieee_double_t& val, double_digits& d,
+                              int signif, int frac)
+            {
+                d.neg = val.is_negative;
+                if (val.pos_val.significand == 0)
+                {
+                    zero_digits(d);
+
+                    return;
+                }
+
+                with_uint_for(
+                    val.pos_val.significand, val.pos_val.exponent,
+                    [&](auto tag){
+                        exact_digits<decltype(tag)>(val, d, signif, frac);
+                    }
+                );
+            }
+
+            hel::ieee_double_t extract_ieee_float(float value)
+            {
+                static_assert(sizeof(value) == sizeof(uint32_t));
+
+                uint32_t bits{};
+                memcpy(&bits, &value, sizeof(bits));
+
+                int raw_exponent = static_cast<int>((bits >> 23) & 0xFFU);
+                uint32_t raw_significand = bits & 0x7F'FFFFU;
+
+                hel::ieee_double_t res{};
+                res.is_negative = ((bits >> 31) != 0);
+                res.is_special = (raw_exponent == 0xFF);
+
+                if (res.is_special)
+                {
+                    res.is_infinity = (raw_significand == 0);
+                    res.is_nan = (raw_significand != 0);
+                }
+                else if (raw_exponent == 0)
+                {
+                    res.is_denormal = true;
+                    res.pos_val.significand = raw_significand;
+                    res.pos_val.exponent = 1 - 150;
+                }
+                else
+                {
+                    res.pos_val.significand = raw_significand | 0x80'0000U;
+                    res.pos_val.exponent = raw_exponent - 150;
+                    res.is_accuracy_step = (raw_significand == 0 && raw_exponent != 1);
+                }
+
+                return res;
+            }
+
+            to_chars_result write_special(char* first, char* last,
+                                          const hel::ieee_double_t& val,
+                                          bool uppercase)
+            {
+                char_writer out{first, last};
+
+                if (val.is_negative)
+                    out.put('-');
+
+                if (val.is_nan)
+                    out.put(uppercase ? "NAN" : "nan", 3);
+                else
+                    out.put(uppercase ? "INF" : "inf", 3);
+
+                return out.result();
+            }
+
+            to_chars_result write_fixed(char* first, char* last,
+                                        const double_digits& d, int precision,
+                                        bool trim)
+            {
+                char_writer out{first, last};
+
+                int int_len = max(1, d.len + d.dec_exp);
+                int last_frac_signif_pos = max(0, -d.dec_exp);
+                int leading_frac_zeros = max(0, last_frac_signif_pos - d.len);
+                int signif_frac_figs = min(last_frac_signif_pos, d.len);
+                int trailing_frac_zeros = trim ? 0 : precision - last_frac_signif_pos;
+                int frac_len = leading_frac_zeros + signif_frac_figs + max(0, trailing_frac_zeros);
+
+                if (d.neg)
+                    out.put('-');
+
+                int buf_int_len = min(d.len, d.len + d.dec_exp);
+                if (0 < buf_int_len)
+                {
+                    out.put(d.buf, buf_int_len);
+                    out.fill('0', int_len - buf_int_len);
+                }
+                else
+                    out.put('0');
+
+                if (0 < frac_len)
+                {
+                    out.put('.');
+                    out.fill('0', leading_frac_zeros);
+                    out.put(d.buf + d.len - signif_frac_figs, signif_frac_figs);
+                    out.fill('0', trailing_frac_zeros);
+                }
+
+                return out.result();
+            }
+
+            to_chars_result write_scientific(char* first, char* last,
+                                             const double_digits& d, int precision,
+                                             bool trim, bool uppercase)
+            {
+                char_writer out{first, last};
+
+                int signif_frac_figs = d.len - 1;
+                int trailing_frac_zeros = trim ? 0 : precision - signif_frac_figs;
+                int exp_val = d.dec_exp + d.len - 1;
+
+                if (d.neg)
+                    out.put('-');
+
+                out.put(d.buf[0]);
+                if (0 < signif_frac_figs + max(0, trailing_frac_zeros))
+                {
+                    out.put('.');
+                    out.put(d.buf + 1, signif_frac_figs);
+                    out.fill('0', trailing_frac_zeros);
+                }
+
+                out.put(uppercase ? 'E' : 'e');
+                out.put(exp_val < 0 ? '-' : '+');
+
+                if (exp_val < 0)
+                    exp_val = -exp_val;
+                if (exp_val >= 100)
+                    out.put(static_cast<char>('0' + exp_val / 100));
+                out.put(&digit_pairs[(exp_val % 100) * 2], 2);
+
+                return out.result();
+            }
+
+            to_chars_result to_chars_ieee(char* first, char* last,
+                                          const hel::ieee_double_t& val,
+                                          chars_format fmt, int precision,
+                                          bool uppercase)
+            {
+                if (val.is_special)
+                    return write_special(first, last, val, uppercase);
+
+                double_digits d;
+                if (fmt == chars_format::fixed)
+                {
+                    if (precision < 0)
+                    {
+                        shortest_digits(val, d);
+
+                        return write_fixed(first, last, d, max(0, -d.dec_exp), false);
+                    }
+
+                    exact_digits(val, d, -1, precision);
+
+                    return write_fixed(first, last, d, precision, false);
+                }
+                else if (fmt == chars_format::scientific)
+                {
+                    if (precision < 0)
+                    {
+                        shortest_digits(val, d);
+
+                        return write_scientific(first, last, d, d.len - 1, false, uppercase);
+                    }
+
+                    exact_digits(val, d, precision + 1, -1);
+
+                    return write_scientific(first, last, d, precision, false, uppercase);
+                }
+                else if (precision >= 0)
+                {
+                    /**
+                     * Like %g, precision is the number of significant
+                     * digits and the style depends on the exponent
+                     * (after rounding).
+                     */
+                    precision = max(1, precision);
+
+                    exact_digits(val, d, precision, -1);
+                    trim_trailing_zeros(d);
+
+                    int exp_val = d.dec_exp + d.len - 1;
+                    if (-4 <= exp_val && exp_val < precision)
+                        return write_fixed(first, last, d, precision - (exp_val + 1), true);
+                    else
+                        return write_scientific(first, last, d, precision - 1, true, uppercase);
+                }
+
+                shortest_digits(val, d);
+
+                int exp_val = d.dec_exp + d.len - 1;
+                if (fmt == chars_format::general)
+                {
+                    // %g with the precision of the shortest representation.
+                    if (-4 <= exp_val && exp_val < max(d.len, 1))
+                        return write_fixed(first, last, d, max(0, -d.dec_exp), false);
+                    else
+                        return write_scientific(first, last, d, d.len - 1, false, uppercase);
+                }
+
+                /**
+                 * No format given, we use whichever of fixed and
+                 * scientific is shorter (preferring fixed).
+                 */
+                int fixed_len = max(1, d.len + d.dec_exp) + max(0, -d.dec_exp);
+                if (d.dec_exp < 0)
+                    fixed_len += 1 + max(0, -(d.len + d.dec_exp));
+
+                int sci_len = d.len + (d.len > 1 ? 1 : 0) + 2;
+                sci_len += (exp_val >= 100 || exp_val <= -100) ? 3 : 2;
+
+                if (fixed_len <= sci_len)
+                    return write_fixed(first, last, d, max(0, -d.dec_exp), false);
+                else
+                    return write_scientific(first, last, d, d.len - 1, false, uppercase);
+            }
+        }
+
+        to_chars_result to_chars_unsigned(char* first, char* last,
+                                          unsigned long long value, int base)
+        {
+            assert(2 <= base && base <= 36);
+
+            auto len = count_digits(value, base);
+            if (last - first < len)
+                return to_chars_result{last, errc::value_too_large};
+
+            auto end = first + len;
+            auto ptr = end;
+            if (base == 10)
+            {
+                while (value >= 100ULL)
+                {
+                    auto idx = (value % 100ULL) * 2;
+                    value /= 100ULL;
+
+                    *--ptr = digit_pairs[idx + 1];
+                    *--ptr = digit_pairs[idx];
+                }
+
+                if (value >= 10ULL)
+                {
+                    *--ptr = digit_pairs[value * 2 + 1];
+                    *--ptr = digit_pairs[value * 2];
+                }
+                else
+                    *--ptr = static_cast<char>('0' + value);
+            }
+            else if ((base & (base - 1)) == 0)
+            {
+                int shift = __builtin_ctz(static_cast<unsigned int>(base));
+                auto mask = static_cast<unsigned long long>(base - 1);
+
+                do
+                {
+                    *--ptr = digit_chars[value & mask];
+                    value >>= shift;
+                } while (value != 0);
+            }
+            else
+            {
+                auto ubase = static_cast<unsigned long long>(base);
+
+                do
+                {
+                    *--ptr = digit_chars[value % ubase];
+                    value /= ubase;
+                } while (value != 0);
+            }
+
+            return to_chars_result{end, errc{}};
+        }
+
+        to_chars_result to_chars_signed(char* first, char* last,
+                                        long long value, int base)
+        {
+            auto uvalue = static_cast<unsigned long long>(value);
+            if (value < 0)
+            {
+                if (first == last)
+                    return to_chars_result{last, errc::value_too_large};
+
+                *first++ = '-';
+                uvalue = 0ULL - uvalue;
+            }
+
+            return to_chars_unsigned(first, last, uvalue, base);
+        }
+
+        from_chars_result from_chars_unsigned(const char* first, const char* last,
+                                              unsigned long long& value,
+                                              unsigned long long max, int base)
+        {
+            assert(2 <= base && base <= 36);
+
+            auto ubase = static_cast<unsigned long long>(base);
+            auto limit = max / ubase;
+
+            unsigned long long res{};
+            bool overflow{false};
+
+            auto ptr = first;
+            for (; ptr != last; ++ptr)
+            {
+                auto digit = digit_value(*ptr);
+                if (digit >= base)
+                    break;
+
+                auto udigit = static_cast<unsigned long long>(digit);
+                if (res > limit || res * ubase > max - udigit)
+                    overflow = true;
+                else
+                    res = res * ubase + udigit;
+            }
+
+            if (ptr == first)
+                return from_chars_result{first, errc::invalid_argument};
+            else if (overflow)
+                return from_chars_result{ptr, errc::result_out_of_range};
+
+            value = res;
+
+            return from_chars_result{ptr, errc{}};
+        }
+
+        from_chars_result from_chars_signed(const char* first, const char* last,
+                                            long long& value, long long min,
+                                            long long max, int base)
+        {
+            bool neg = (first != last && *first == '-');
+
+            auto limit = static_cast<unsigned long long>(max);
+            if (neg)
+                limit = 0ULL - static_cast<unsigned long long>(min);
+
+            unsigned long long res{};
+            auto ret = from_chars_unsigned(first + neg, last, res, limit, base);
+
+            if (ret.ec == errc::invalid_argument)
+                return from_chars_result{first, errc::invalid_argument};
+            else if (ret.ec != errc{})
+                return ret;
+
+            if (neg)
+                value = static_cast<long long>(0ULL - res);
+            else
+                value = static_cast<long long>(res);
+
+            return ret;
+        }
+
+        to_chars_result to_chars_double(char* first, char* last, double value,
+                                        chars_format fmt, int precision,
+                                        bool uppercase)
+        {
+            if (fmt == chars_format::hex)
+            {
+                /**
+                 * Note: Hexadecimal output is rare enough for us to
+                 *       keep using snprintf (which writes the 0x prefix
+                 *       that we do not want here though).
+                 */
+                char buf[64];
+                int ret{};
+                if (precision < 0)
+                    ret = snprintf(buf, sizeof(buf), uppercase ? "%A" : "%a", value);
+                else
+                    ret = snprintf(buf, sizeof(buf), uppercase ? "%.*A" : "%.*a", precision, value);
+
+                if (ret < 0)
+                    return to_chars_result{last, errc::value_too_large};
+
+                char_writer out{first, last};
+                for (int i = 0; i < ret && buf[i]; ++i)
+                {
+                    if (buf[i] == '0' && (buf[i + 1] == 'x' || buf[i + 1] == 'X'))
+                        ++i;
+                    else
+                        out.put(buf[i]);
+                }
+
+                return out.result();
+            }
+
+            return to_chars_ieee(
+                first, last, hel::extract_ieee_double(value),
+                fmt, precision, uppercase
+            );
+        }
+
+        to_chars_result to_chars_float(char* first, char* last, float value,
+                                       chars_format fmt, int precision,
+                                       bool uppercase)
+        {
+            /**
+             * Only the shortest representation depends on the type,
+             * the exact value is the same as that of the double.
+             */
+            if (fmt == chars_format::hex)
+                return to_chars_double(first, last, value, fmt, precision, uppercase);
+
+            return to_chars_ieee(
+                first, last, extract_ieee_float(value),
+                fmt, precision, uppercase
+            );
+        }
+
+        namespace
+        {
+            /**
+             * Returns the end of the longest prefix of [first, last)
+             * that is a floating point number in the given format.
+             */
+            const char* scan_float(const char* first, const char* last,
+                                   chars_format fmt)
+            {
+                auto ptr = first;
+                bool hex = (fmt == chars_format::hex);
+
+                auto is_digit = [hex](char c){
+                    return ('0' <= c && c <= '9') || (hex &&
+                           (('a' <= c && c <= 'f') || ('A' <= c && c <= 'F')));
+                };
+
+                size_t digits{};
+                while (ptr != last && is_digit(*ptr))
+                {
+                    ++ptr;
+                    ++digits;
+                }
+
+                if (ptr != last && *ptr == '.')
+                {
+                    ++ptr;
+                    while (ptr != last && is_digit(*ptr))
+                    {
+                        ++ptr;
+                        ++digits;
+                    }
+                }
+
+                if (digits == 0)
+                    return first;
+
+                char exp_char = hex ? 'p' : 'e';
+                bool exp_allowed = (fmt != chars_format::fixed);
+                bool exp_required = (fmt == chars_format::scientific);
+
+                if (exp_allowed && ptr != last && (*ptr == exp_char || *ptr == exp_char - 32))
+                {
+                    auto exp = ptr + 1;
+                    if (exp != last && (*exp == '+' || *exp == '-'))
+                        ++exp;
+
+                    if (exp != last && '0' <= *exp && *exp <= '9')
+                    {
+                        while (exp != last && '0' <= *exp && *exp <= '9')
+                            ++exp;
+
+                        return exp;
+                    }
+                }
+
+                if (exp_required)
+                    return first;
+
+                return ptr;
+            }
+
+            bool match_nocase(const char*& ptr, const char* last, const char* str)
+            {
+                auto tmp = ptr;
+                for (; *str; ++str, ++tmp)
+                {
+                    if (tmp == last || (*tmp | 0x20) != *str)
+                        return false;
+                }
+                ptr = tmp;
+
+                return true;
+            }
+
+            /**
+             * More digits than any halfway point between
+             * two doubles has.
+             */
+            constexpr int max_parse_digits{800};
+
+            /**
+             * Significant digits of a decimal number, its value
+             * is 0.digits * 10^dec_exp.
+             */
+            struct decimal_digits
+            {
+                // One more for a digit that stands for the cut off ones.
+                char buf[max_parse_digits + 1];
+                int len;
+                int dec_exp;
+            };
+
+            /**
+             * Extracts the digits of a decimal number
+             * accepted by scan_float (without the sign).
+             */
+            void parse_decimal(const char* first, const char* last,
+                               decimal_digits& d)
+            {
+                d.len = 0;
+                d.dec_exp = 0;
+
+                auto ptr = first;
+                bool point{false};
+                bool cut_off{false};
+                for (; ptr != last && *ptr != 'e' && *ptr != 'E'; ++ptr)
+                {
+                    if (*ptr == '.')
+                        point = true;
+                    else if (*ptr == '0' && d.len == 0)
+                    {
+                        if (point)
+                            --d.dec_exp;
+                    }
+                    else
+                    {
+                        if (!point)
+                            ++d.dec_exp;
+
+                        if (d.len < max_parse_digits)
+                            d.buf[d.len++] = *ptr;
+                        else if (*ptr != '0')
+                            cut_off = true;
+                    }
+                }
+
+                if (ptr != last)
+                {
+                    ++ptr;
+                    bool exp_neg = (*ptr == '-');
+                    if (*ptr == '+' || *ptr == '-')
+                        ++ptr;
+
+                    // Anything this large over- or underflows anyway.
+                    int exp{};
+                    for (; ptr != last; ++ptr)
+                    {
+                        if (exp < 100'000)
+                            exp = exp * 10 + (*ptr - '0');
+                    }
+
+                    d.dec_exp += exp_neg ? -exp : exp;
+                }
+
+                while (d.len > 0 && d.buf[d.len - 1] == '0')
+                    --d.len;
+                if (cut_off)
+                    d.buf[d.len++] = '1';
+            }
+
+            /**
+             * Compares the (nonzero) decimal number
+             * to the (nonzero) significand * 2^exp.
+             */
+            template<class Uint>
+            int compare(const decimal_digits& d, uint64_t significand, int exp)
+            {
+                digit_generator<Uint> gen{significand, exp};
+                if (d.dec_exp != gen.dec_exp())
+                    return d.dec_exp < gen.dec_exp() ? -1 : 1;
+
+                for (int i = 0; i < d.len; ++i)
+                {
+                    // We have no trailing zeros.
+                    if (gen.done())
+                        return 1;
+
+                    int digit = gen.next();
+                    if (d.buf[i] - '0' != digit)
+                        return d.buf[i] - '0' < digit ? -1 : 1;
+                }
+
+                return gen.done() ? 0 : -1;
+            }
+
+            int compare(const decimal_digits& d, uint64_t significand, int exp)
+            {
+                return with_uint_for(significand, exp, [&](auto tag){
+                    return compare<decltype(tag)>(d, significand, exp);
+                });
+            }
+
+            hel::ieee_double_t extract_ieee(double value)
+            {
+                return hel::extract_ieee_double(value);
+            }
+
+            hel::ieee_double_t extract_ieee(float value)
+            {
+                return extract_ieee_float(value);
+            }
+
+            /**
+             * Moves the (nonnegative) value to the one closest to the
+             * decimal number (ties to even), i.e. to where the halfway
+             * points to its neighbours are on both sides of the number.
+             * Returns false if the number is out of range.
+             */
+            template<class T>
+            bool round_to_nearest(const decimal_digits& d, T& value)
+            {
+                using bits_type = conditional_t<
+                    sizeof(T) == sizeof(uint64_t), uint64_t, uint32_t
+                >;
+
+                T inf = std::numeric_limits<T>::infinity();
+                bits_type inf_bits{};
+                memcpy(&inf_bits, &inf, sizeof(inf_bits));
+
+                bits_type bits{};
+                memcpy(&bits, &value, sizeof(bits));
+                if (bits == inf_bits)
+                    --bits;
+
+                while (true)
+                {
+                    T tmp{};
+                    memcpy(&tmp, &bits, sizeof(bits));
+
+                    auto val = extract_ieee(tmp);
+                    auto sig = val.pos_val.significand;
+                    auto exp = val.pos_val.exponent;
+                    bool odd = (sig % 2 == 1);
+
+                    auto cmp = compare(d, 2 * sig + 1, exp - 1);
+                    if (cmp > 0 || (cmp == 0 && odd))
+                    {
+                        if (++bits == inf_bits)
+                            return false;
+
+                        continue;
+                    }
+
+                    if (sig != 0)
+                    {
+                        if (val.is_accuracy_step)
+                            cmp = compare(d, 4 * sig - 1, exp - 2);
+                        else
+                            cmp = compare(d, 2 * sig - 1, exp - 1);
+
+                        if (cmp < 0 || (cmp == 0 && odd))
+                        {
+                            --bits;
+
+                            continue;
+                        }
+                    }
+
+                    value = tmp;
+
+                    return true;
+                }
+            }
+
+            template<class T>
+            from_chars_result from_chars_float(const char* first, const char* last,
+                                               T& value, chars_format fmt)
+            {
+                auto ptr = first;
+                bool neg = (ptr != last && *ptr == '-');
+                if (neg)
+                    ++ptr;
+
+                if (match_nocase(ptr, last, "inf"))
+                {
+                    match_nocase(ptr, last, "inity");
+                    value = neg ? -std::numeric_limits<T>::infinity()
+                                : std::numeric_limits<T>::infinity();
+
+                    return from_chars_result{ptr, errc{}};
+                }
+                else if (match_nocase(ptr, last, "nan"))
+                {
+                    value = std::numeric_limits<T>::quiet_NaN();
+
+                    return from_chars_result{ptr, errc{}};
+                }
+
+                auto end = scan_float(ptr, last, fmt);
+                if (end == ptr)
+                    return from_chars_result{first, errc::invalid_argument};
+
+                /**
+                 * The input is not null terminated, strtold also
+                 * wants the 0x prefix for hexadecimal numbers.
+                 */
+                char local_buf[128];
+                size_t len = static_cast<size_t>(end - ptr);
+                size_t size = len + 4;
+
+                char* buf = local_buf;
+                if (size > sizeof(local_buf))
+                    buf = new char[size];
+
+                size_t i{};
+                if (neg)
+                    buf[i++] = '-';
+                if (fmt == chars_format::hex)
+                {
+                    buf[i++] = '0';
+                    buf[i++] = 'x';
+                }
+                for (auto it = ptr; it != end; ++it)
+                    buf[i++] = *it;
+                buf[i] = '\0';
+
+                char* conv_end{};
+                long double res = hel::strtold(buf, &conv_end);
+                bool converted = (conv_end != buf);
+
+                if (buf != local_buf)
+                    delete[] buf;
+
+                if (!converted)
+                    return from_chars_result{first, errc::invalid_argument};
+
+                /**
+                 * Note: Values just above max that round to it are
+                 *       fine, we only reject those that overflow.
+                 */
+                auto tmp = static_cast<T>(res);
+                if constexpr (!is_same_v<T, long double>)
+                {
+                    /**
+                     * Neither strtold nor the conversion from long double
+                     * round correctly in all cases, but the shortest
+                     * representations we produce need to round trip.
+                     */
+                    if (fmt != chars_format::hex)
+                    {
+                        decimal_digits digits;
+                        parse_decimal(ptr, end, digits);
+
+                        T mag = neg ? -tmp : tmp;
+                        if (digits.len > 0 && !round_to_nearest(digits, mag))
+                            return from_chars_result{end, errc::result_out_of_range};
+
+                        tmp = neg ? -mag : mag;
+                    }
+                }
+
+                if (tmp > std::numeric_limits<T>::max() || tmp < std::numeric_limits<T>::lowest())
+                    return from_chars_result{end, errc::result_out_of_range};
+
+                value = tmp;
+
+                return from_chars_result{end, errc{}};
+            }
+        }
+    }
+
+    to_chars_result to_chars(char* first, char* last, float value)
+    {
+        return aux::to_chars_float(first, last, value, chars_format{}, -1);
+    }
+
+    to_chars_result to_chars(char* first, char* last, double value)
+    {
+        return aux::to_chars_double(first, last, value, chars_format{}, -1);
+    }
+
+    to_chars_result to_chars(char* first, char* last, long double value)
+    {
+        // Note: Long double is not supported by our printf either.
+        return aux::to_chars_double(first, last, static_cast<double>(value), chars_format{}, -1);
+    }
+
+    to_chars_result to_chars(char* first, char* last, float value, chars_format fmt)
+    {
+        return aux::to_chars_float(first, last, value, fmt, -1);
+    }
+
+    to_chars_result to_chars(char* first, char* last, double value, chars_format fmt)
+    {
+        return aux::to_chars_double(first, last, value, fmt, -1);
+    }
+
+    to_chars_result to_chars(char* first, char* last, long double value, chars_format fmt)
+    {
+        return aux::to_chars_double(first, last, static_cast<double>(value), fmt, -1);
+    }
+
+    to_chars_result to_chars(char* first, char* last, float value,
+                             chars_format fmt, int precision)
+    {
+        return aux::to_chars_float(first, last, value, fmt, max(0, precision));
+    }
+
+    to_chars_result to_chars(char* first, char* last, double value,
+                             chars_format fmt, int precision)
+    {
+        return aux::to_chars_double(first, last, value, fmt, max(0, precision));
+    }
+
+    to_chars_result to_chars(char* first, char* last, long double value,
+                             chars_format fmt, int precision)
+    {
+        return aux::to_chars_double(
+            first, last, static_cast<double>(value), fmt, max(0, precision)
+        );
+    }
+
+    from_chars_result from_chars(const char* first, const char* last,
+                                 float& value, chars_format fmt)
+    {
+        return aux::from_chars_float(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(const char* first, const char* last,
+                                 double& value, chars_format fmt)
+    {
+        return aux::from_chars_float(first, last, value, fmt);
+    }
+
+    from_chars_result from_chars(const char* first, const char* last,
+                                 long double& value, chars_format fmt)
+    {
+        return aux::from_chars_float(first, last, value, fmt);
+    }
+}
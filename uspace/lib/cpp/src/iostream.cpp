@@ -61,4 +61,26 @@ namespace std
         if (--init_cnt_ == 0)
             cout.flush();
     }
+
+    bool ios_base::sync_with_stdio(bool sync)
+    {
+        auto old = sync_;
+        sync_ = sync;
+
+        /**
+         * Once we do not have to keep the order of operations
+         * with C stdio, cout can collect its output in a buffer
+         * of its own instead of handing over every single
+         * operation to stdout separately.
+         */
+        if (old != sync)
+        {
+            if (sync)
+                cout.rdbuf()->pubsetbuf(nullptr, 0);
+            else
+                cout.rdbuf()->pubsetbuf(nullptr, aux::default_stream_buffer_size);
+        }
+
+        return old;
+    }
 }
@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/memory_resource.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace std::hel
+{
+    extern "C" {
+        #include <malloc.h>
+    }
+}
+
+namespace std::pmr
+{
+    memory_resource::~memory_resource()
+    { /* DUMMY BODY */ }
+
+    namespace
+    {
+        class new_delete_memory_resource: public memory_resource
+        {
+            protected:
+                void* do_allocate(size_t bytes, size_t alignment) override
+                {
+                    if (alignment <= aux::max_align)
+                        return ::operator new(bytes);
+
+                    // TODO: We do not have aligned operator new yet.
+                    return hel::memalign(alignment, bytes);
+                }
+
+                void do_deallocate(void* ptr, size_t, size_t alignment) override
+                {
+                    if (alignment <= aux::max_align)
+                        ::operator delete(ptr);
+                    else
+                        hel::free(ptr);
+                }
+
+                bool do_is_equal(const memory_resource& other) const noexcept override
+                {
+                    return this == &other;
+                }
+        };
+
+        class null_memory_resource_: public memory_resource
+        {
+            protected:
+                void* do_allocate(size_t, size_t) override
+                {
+                    // TODO: For this we need stack unwinding support.
+                    /* throw bad_alloc{}; */
+                    return nullptr;
+                }
+
+                void do_deallocate(void*, size_t, size_t) override
+                { /* DUMMY BODY */ }
+
+                bool do_is_equal(const memory_resource& other) const noexcept override
+                {
+                    return this == &other;
+                }
+        };
+
+        atomic<memory_resource*> default_resource{nullptr};
+
+        constexpr size_t round_up(size_t size, size_t alignment) noexcept
+        {
+            return (size + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    memory_resource* new_delete_resource() noexcept
+    {
+        static new_delete_memory_resource res{};
+
+        return &res;
+    }
+
+    memory_resource* null_memory_resource() noexcept
+    {
+        static null_memory_resource_ res{};
+
+        return &res;
+    }
+
+    memory_resource* set_default_resource(memory_resource* res) noexcept
+    {
+        if (!res)
+            res = new_delete_resource();
+
+        auto old = default_resource.exchange(res);
+
+        return old ? old : new_delete_resource();
+    }
+
+    memory_resource* get_default_resource() noexcept
+    {
+        auto res = default_resource.load();
+
+        return res ? res : new_delete_resource();
+    }
+
+    namespace aux
+    {
+        pool_set::pool_set(const pool_options& opts, memory_resource* upstream)
+            : upstream_{upstream}, options_{opts}, pools_{nullptr},
+              pool_count_{}, large_{nullptr}
+        {
+            assert(upstream_);
+
+            if (options_.max_blocks_per_chunk == 0)
+                options_.max_blocks_per_chunk = default_blocks_per_chunk_;
+            options_.max_blocks_per_chunk = std::max(
+                options_.max_blocks_per_chunk, initial_blocks_per_chunk_
+            );
+
+            if (options_.largest_required_pool_block == 0)
+                options_.largest_required_pool_block = default_largest_block_;
+            options_.largest_required_pool_block = std::min(
+                options_.largest_required_pool_block, max_largest_block_
+            );
+
+            /**
+             * Pools have power of two block sizes, starting
+             * with the smallest block that fits a free list
+             * link, the largest block is rounded up.
+             */
+            size_t block = size_t{1} << min_block_shift_;
+            pool_count_ = 1;
+            while (block < options_.largest_required_pool_block)
+            {
+                block <<= 1;
+                ++pool_count_;
+            }
+            options_.largest_required_pool_block = block;
+
+            pools_ = static_cast<pool*>(
+                upstream_->allocate(pool_count_ * sizeof(pool), alignof(pool))
+            );
+
+            for (size_t i = 0; i < pool_count_; ++i)
+                pools_[i] = pool{nullptr, nullptr, initial_blocks_per_chunk_};
+        }
+
+        pool_set::~pool_set()
+        {
+            release();
+
+            upstream_->deallocate(pools_, pool_count_ * sizeof(pool), alignof(pool));
+        }
+
+        void* pool_set::allocate(size_t bytes, size_t alignment)
+        {
+            auto idx = pool_idx_(bytes, alignment);
+
+            if (idx < pool_count_)
+            {
+                auto& p = pools_[idx];
+                if (!p.free)
+                    refill_(idx);
+
+                auto block = p.free;
+                p.free = block->next;
+
+                return block;
+            }
+
+            auto header = large_header_(alignment);
+            auto mem = static_cast<char*>(upstream_->allocate(
+                header + bytes, std::max(alignment, max_align)
+            ));
+
+            auto block = reinterpret_cast<large_block*>(mem + header - sizeof(large_block));
+            block->prev = nullptr;
+            block->next = large_;
+            block->size = bytes;
+            block->alignment = alignment;
+            if (large_)
+                large_->prev = block;
+            large_ = block;
+
+            return mem + header;
+        }
+
+        void pool_set::deallocate(void* ptr, size_t bytes, size_t alignment)
+        {
+            auto idx = pool_idx_(bytes, alignment);
+
+            if (idx < pool_count_)
+            {
+                auto& p = pools_[idx];
+                auto block = static_cast<free_block*>(ptr);
+
+                block->next = p.free;
+                p.free = block;
+
+                return;
+            }
+
+            auto header = large_header_(alignment);
+            auto mem = static_cast<char*>(ptr) - header;
+
+            auto block = reinterpret_cast<large_block*>(mem + header - sizeof(large_block));
+            if (block->prev)
+                block->prev->next = block->next;
+            else
+                large_ = block->next;
+            if (block->next)
+                block->next->prev = block->prev;
+
+            upstream_->deallocate(mem, header + bytes, std::max(alignment, max_align));
+        }
+
+        void pool_set::release()
+        {
+            for (size_t i = 0; i < pool_count_; ++i)
+            {
+                auto& p = pools_[i];
+                while (p.chunks)
+                {
+                    auto tmp = p.chunks;
+                    p.chunks = tmp->next;
+
+                    upstream_->deallocate(tmp, tmp->size, max_align);
+                }
+
+                p = pool{nullptr, nullptr, initial_blocks_per_chunk_};
+            }
+
+            while (large_)
+            {
+                auto tmp = large_;
+                large_ = tmp->next;
+
+                auto header = large_header_(tmp->alignment);
+                upstream_->deallocate(
+                    reinterpret_cast<char*>(tmp + 1) - header,
+                    header + tmp->size, std::max(tmp->alignment, max_align)
+                );
+            }
+        }
+
+        size_t pool_set::pool_idx_(size_t bytes, size_t alignment) const noexcept
+        {
+            /**
+             * Blocks of a pool are aligned to their size
+             * up to max_align, so over-aligned requests
+             * have to go directly upstream.
+             */
+            if (alignment > max_align)
+                return pool_count_;
+
+            auto size = std::max(bytes, alignment);
+            if (size > options_.largest_required_pool_block)
+                return pool_count_;
+
+            size_t idx{};
+            size_t block = size_t{1} << min_block_shift_;
+            while (block < size)
+            {
+                block <<= 1;
+                ++idx;
+            }
+
+            return idx;
+        }
+
+        void pool_set::refill_(size_t idx)
+        {
+            auto& p = pools_[idx];
+            auto block_size = size_t{1} << (idx + min_block_shift_);
+            auto header = round_up(sizeof(chunk), max_align);
+            auto count = p.next_blocks;
+            auto size = header + count * block_size;
+
+            auto mem = static_cast<char*>(upstream_->allocate(size, max_align));
+
+            auto c = reinterpret_cast<chunk*>(mem);
+            c->next = p.chunks;
+            c->size = size;
+            p.chunks = c;
+
+            /**
+             * Thread the blocks in address order, so that
+             * consecutive allocations are adjacent in memory.
+             */
+            auto first = mem + header;
+            for (size_t i = count; i > 0; --i)
+            {
+                auto block = reinterpret_cast<free_block*>(first + (i - 1) * block_size);
+                block->next = p.free;
+                p.free = block;
+            }
+
+            p.next_blocks = std::min(count * 2, options_.max_blocks_per_chunk);
+        }
+
+        size_t pool_set::large_header_(size_t alignment) noexcept
+        {
+            return round_up(sizeof(large_block), std::max(alignment, max_align));
+        }
+    }
+
+    synchronized_pool_resource::synchronized_pool_resource(
+        const pool_options& opts, memory_resource* upstream
+    )
+        : mtx_{}, pools_{opts, upstream}
+    {
+        std::aux::threading::mutex::init(mtx_);
+    }
+
+    synchronized_pool_resource::~synchronized_pool_resource()
+    { /* DUMMY BODY */ }
+
+    void synchronized_pool_resource::release()
+    {
+        std::aux::threading::mutex::lock(mtx_);
+        pools_.release();
+        std::aux::threading::mutex::unlock(mtx_);
+    }
+
+    void* synchronized_pool_resource::do_allocate(size_t bytes, size_t alignment)
+    {
+        std::aux::threading::mutex::lock(mtx_);
+        auto res = pools_.allocate(bytes, alignment);
+        std::aux::threading::mutex::unlock(mtx_);
+
+        return res;
+    }
+
+    void synchronized_pool_resource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+    {
+        std::aux::threading::mutex::lock(mtx_);
+        pools_.deallocate(ptr, bytes, alignment);
+        std::aux::threading::mutex::unlock(mtx_);
+    }
+
+    bool synchronized_pool_resource::do_is_equal(const memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    unsynchronized_pool_resource::~unsynchronized_pool_resource()
+    { /* DUMMY BODY */ }
+
+    void* unsynchronized_pool_resource::do_allocate(size_t bytes, size_t alignment)
+    {
+        return pools_.allocate(bytes, alignment);
+    }
+
+    void unsynchronized_pool_resource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+    {
+        pools_.deallocate(ptr, bytes, alignment);
+    }
+
+    bool unsynchronized_pool_resource::do_is_equal(const memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    monotonic_buffer_resource::monotonic_buffer_resource(
+        size_t initial_size, memory_resource* upstream
+    )
+        : upstream_{upstream}, current_{nullptr}, space_{},
+          next_size_{initial_size ? initial_size : default_size_},
+          chunks_{nullptr}, initial_buffer_{nullptr}, initial_size_{}
+    {
+        assert(upstream_);
+    }
+
+    monotonic_buffer_resource::monotonic_buffer_resource(
+        void* buffer, size_t buffer_size, memory_resource* upstream
+    )
+        : upstream_{upstream}, current_{static_cast<char*>(buffer)},
+          space_{buffer ? buffer_size : 0},
+          next_size_{buffer && buffer_size ? buffer_size * growth_factor_ : default_size_},
+          chunks_{nullptr}, initial_buffer_{buffer}, initial_size_{space_}
+    {
+        assert(upstream_);
+    }
+
+    monotonic_buffer_resource::~monotonic_buffer_resource()
+    {
+        release();
+    }
+
+    void monotonic_buffer_resource::release()
+    {
+        while (chunks_)
+        {
+            auto tmp = chunks_;
+            chunks_ = tmp->next;
+
+            upstream_->deallocate(tmp, tmp->size, tmp->alignment);
+        }
+
+        current_ = static_cast<char*>(initial_buffer_);
+        space_ = initial_size_;
+    }
+
+    void* monotonic_buffer_resource::do_allocate(size_t bytes, size_t alignment)
+    {
+        if (auto res = allocate_from_chunk_(bytes, alignment); res)
+            return res;
+
+        /**
+         * The new chunk has to fit the request even in the
+         * worst case of its alignment, chunks grow geometrically
+         * so that the number of upstream calls stays logarithmic.
+         */
+        auto header = round_up(sizeof(chunk), aux::max_align);
+        auto chunk_alignment = std::max(alignment, aux::max_align);
+        auto size = std::max(next_size_, header + bytes + alignment);
+
+        auto mem = static_cast<char*>(upstream_->allocate(size, chunk_alignment));
+
+        auto c = reinterpret_cast<chunk*>(mem);
+        c->next = chunks_;
+        c->size = size;
+        c->alignment = chunk_alignment;
+        chunks_ = c;
+
+        current_ = mem + header;
+        space_ = size - header;
+        next_size_ = size * growth_factor_;
+
+        return allocate_from_chunk_(bytes, alignment);
+    }
+
+    void* monotonic_buffer_resource::allocate_from_chunk_(size_t bytes, size_t alignment)
+    {
+        if (!current_)
+            return nullptr;
+
+        auto addr = reinterpret_cast<uintptr_t>(current_);
+        auto padding = round_up(addr, alignment) - addr;
+        if (padding + bytes > space_)
+            return nullptr;
+
+        auto res = current_ + padding;
+        current_ = res + bytes;
+        space_ -= padding + bytes;
+
+        return res;
+    }
+}
@@ -89,7 +89,10 @@ namespace std
         if (owner_ != this_thread::get_id())
             return;
         else if (--lock_level_ == 0)
+        {
+            owner_ = thread::id{};
             aux::threading::mutex::unlock(mtx_);
+        }
     }
 
     recursive_mutex::native_handle_type recursive_mutex::native_handle()
@@ -165,11 +168,32 @@ namespace std
         if (owner_ != this_thread::get_id())
             return;
         else if (--lock_level_ == 0)
+        {
+            owner_ = thread::id{};
             aux::threading::mutex::unlock(mtx_);
+        }
     }
 
     recursive_timed_mutex::native_handle_type recursive_timed_mutex::native_handle()
     {
         return &mtx_;
     }
+
+    bool recursive_timed_mutex::try_lock_for_(aux::time_unit_t time)
+    {
+        if (owner_ == this_thread::get_id())
+        {
+            ++lock_level_;
+
+            return true;
+        }
+
+        if (!aux::threading::mutex::try_lock_for(mtx_, time))
+            return false;
+
+        owner_ = this_thread::get_id();
+        lock_level_ = 1;
+
+        return true;
+    }
 }
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/random/sampling.hpp>
+
+namespace std::aux
+{
+    ziggurat_tables::ziggurat_tables()
+    {
+        /**
+         * The area of every layer (and of the base layer
+         * together with the tail) is v, the base layer is
+         * treated as a rectangle of width v / f(r) and the
+         * tail is sampled separately.
+         */
+        constexpr double scale{0x1p53};
+
+        constexpr double normal_v{9.91256303526217e-3};
+        auto x = normal_r;
+        auto f = aux::exp(-0.5 * x * x);
+        auto q = normal_v / f;
+        auto last = normal_layers - 1;
+
+        normal_k[0] = static_cast<uint64_t>(x / q * scale);
+        normal_k[1] = 0;
+        normal_w[0] = q / scale;
+        normal_w[last] = x / scale;
+        normal_f[0] = 1;
+        normal_f[last] = f;
+
+        for (auto i = last - 1; i > 0; --i)
+        {
+            auto next = aux::sqrt(-2 * aux::log(normal_v / x + aux::exp(-0.5 * x * x)));
+            normal_k[i + 1] = static_cast<uint64_t>(next / x * scale);
+            x = next;
+            normal_f[i] = aux::exp(-0.5 * x * x);
+            normal_w[i] = x / scale;
+        }
+
+        constexpr double exponential_v{3.949659822581572e-3};
+        x = exponential_r;
+        f = aux::exp(-x);
+        q = exponential_v / f;
+        last = exponential_layers - 1;
+
+        exponential_k[0] = static_cast<uint64_t>(x / q * scale);
+        exponential_k[1] = 0;
+        exponential_w[0] = q / scale;
+        exponential_w[last] = x / scale;
+        exponential_f[0] = 1;
+        exponential_f[last] = f;
+
+        for (auto i = last - 1; i > 0; --i)
+        {
+            auto next = -aux::log(exponential_v / x + aux::exp(-x));
+            exponential_k[i + 1] = static_cast<uint64_t>(next / x * scale);
+            x = next;
+            exponential_f[i] = aux::exp(-x);
+            exponential_w[i] = x / scale;
+        }
+    }
+
+    const ziggurat_tables& ziggurat()
+    {
+        static const ziggurat_tables tables{};
+
+        return tables;
+    }
+}
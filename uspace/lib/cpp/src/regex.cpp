@@ -0,0 +1,1209 @@
+/*
+ * Copyright (c) 2018 Jaroslav Jindrak
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * - Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * - Redistributions in binary form must reproduce the above copyright
+ *   notice, this list of conditions and the following disclaimer in the
+ *   documentation and/or other materials provided with the distribution.
+ * - The name of the author may not be used to endorse or promote products
+ *   derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <__bits/regex/engine.hpp>
+#include <algorithm>
+#include <limits>
+#include <regex>
+#include <utility>
+#include <vector>
+
+namespace std
+{
+    namespace
+    {
+        const char* regex_error_message(regex_constants::error_type code)
+        {
+            switch (code)
+            {
+                case regex_constants::error_collate:
+                    return "invalid collating element name";
+                case regex_constants::error_ctype:
+                    return "invalid character class name";
+                case regex_constants::error_escape:
+                    return "invalid escaped character or trailing escape";
+                case regex_constants::error_backref:
+                    return "invalid back reference";
+                case regex_constants::error_brack:
+                    return "mismatched [ and ]";
+                case regex_constants::error_paren:
+                    return "mismatched ( and ) or unsupported group";
+                case regex_constants::error_brace:
+                    return "mismatched { and }";
+                case regex_constants::error_badbrace:
+                    return "invalid range in a {} expression";
+                case regex_constants::error_range:
+                    return "invalid character range";
+                case regex_constants::error_space:
+                    return "insufficient memory to compile the regex";
+                case regex_constants::error_badrepeat:
+                    return "repeat not preceded by a valid expression";
+                case regex_constants::error_complexity:
+                    return "match too complex";
+                case regex_constants::error_stack:
+                    return "insufficient memory to match the regex";
+                default:
+                    return "unknown regex error";
+            }
+        }
+    }
+
+    regex_error::regex_error(regex_constants::error_type ecode)
+        : runtime_error{regex_error_message(ecode)}, code_{ecode}
+    { /* DUMMY BODY */ }
+
+    regex_constants::error_type regex_error::code() const
+    {
+        return code_;
+    }
+}
+
+namespace std::aux
+{
+    namespace
+    {
+        enum class regex_node_kind
+        {
+            empty, unit, dot, cls, concat, alternation,
+            repeat, group, assertion, backref
+        };
+
+        struct regex_node
+        {
+            regex_node_kind kind;
+            uint32_t value;
+            size_t min;
+            size_t max;
+            bool greedy;
+            vector<size_t> children;
+        };
+
+        using regex_ranges = vector<pair<uint32_t, uint32_t>>;
+
+        constexpr size_t npos = std::numeric_limits<size_t>::max();
+        constexpr size_t unbounded = std::numeric_limits<size_t>::max();
+        constexpr uint32_t max_unit = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * Counted repetition copies the repeated expression,
+         * so the size of the program has to be limited.
+         */
+        constexpr size_t max_insts = 1U << 16;
+        constexpr size_t max_count = 1U << 16;
+
+        const regex_ranges digit_ranges{{'0', '9'}};
+        const regex_ranges word_ranges{
+            {'0', '9'}, {'A', 'Z'}, {'_', '_'}, {'a', 'z'}
+        };
+        const regex_ranges space_ranges{
+            {0x09, 0x0D}, {0x20, 0x20}, {0xA0, 0xA0}, {0x1680, 0x1680},
+            {0x2000, 0x200A}, {0x2028, 0x2029}, {0x202F, 0x202F},
+            {0x205F, 0x205F}, {0x3000, 0x3000}, {0xFEFF, 0xFEFF}
+        };
+
+        bool is_digit(uint32_t c)
+        {
+            return '0' <= c && c <= '9';
+        }
+
+        int hex_value(uint32_t c)
+        {
+            if ('0' <= c && c <= '9')
+                return c - '0';
+            else if ('a' <= c && c <= 'f')
+                return c - 'a' + 10;
+            else if ('A' <= c && c <= 'F')
+                return c - 'A' + 10;
+            else
+                return -1;
+        }
+
+        uint32_t other_case(uint32_t c)
+        {
+            if ('a' <= c && c <= 'z')
+                return c - 'a' + 'A';
+            else if ('A' <= c && c <= 'Z')
+                return c - 'A' + 'a';
+            else
+                return c;
+        }
+    }
+
+    /**
+     * Recursive descent parser of the ECMAScript grammar,
+     * which builds a syntax tree that is then compiled into
+     * the instructions of the program.
+     */
+    class regex_compiler
+    {
+        public:
+            regex_compiler(regex_program& prog, const uint32_t* pattern, size_t len,
+                           regex_constants::syntax_option_type flags)
+                : prog_{prog}, pattern_{pattern}, len_{len}, pos_{},
+                  flags_{flags}, nodes_{}, group_count_{}, max_backref_{},
+                  error_{}
+            { /* DUMMY BODY */ }
+
+            regex_constants::error_type compile()
+            {
+                prog_.icase_ = flags_ & regex_constants::icase;
+                prog_.multiline_ = flags_ & regex_constants::multiline;
+
+                auto root = disjunction_();
+                if (!error_ && pos_ < len_)
+                    error_ = regex_constants::error_paren;
+                if (!error_ && max_backref_ > group_count_)
+                    error_ = regex_constants::error_backref;
+
+                if (!error_)
+                {
+                    emit_(regex_op::save, 0U);
+                    if (emit_node_(root))
+                    {
+                        emit_(regex_op::save, 1U);
+                        emit_(regex_op::match);
+
+                        /**
+                         * Searches start with a lazy loop over the
+                         * input, so that matches that start earlier
+                         * have higher priority.
+                         */
+                        auto loop = emit_(regex_op::split, 0U, 0U);
+                        prog_.insts_[loop].y = loop + 1;
+                        emit_(regex_op::any);
+                        emit_(regex_op::jump, loop);
+
+                        prog_.unanchored_start_ = loop;
+                        prog_.mark_count_ = group_count_;
+                    }
+                }
+
+                if (error_)
+                {
+                    prog_.insts_.clear();
+                    prog_.classes_.clear();
+                }
+
+                return error_;
+            }
+
+        private:
+            regex_program& prog_;
+            const uint32_t* pattern_;
+            size_t len_;
+            size_t pos_;
+            regex_constants::syntax_option_type flags_;
+
+            vector<regex_node> nodes_;
+            size_t group_count_;
+            size_t max_backref_;
+            regex_constants::error_type error_;
+
+            bool eof_() const
+            {
+                return pos_ >= len_;
+            }
+
+            bool peek_(uint32_t c) const
+            {
+                return pos_ < len_ && pattern_[pos_] == c;
+            }
+
+            bool accept_(uint32_t c)
+            {
+                if (peek_(c))
+                {
+                    ++pos_;
+                    return true;
+                }
+                else
+                    return false;
+            }
+
+            size_t add_(regex_node_kind kind, uint32_t value = 0U)
+            {
+                nodes_.push_back(regex_node{kind, value, 0U, 0U, true, {}});
+
+                return nodes_.size() - 1;
+            }
+
+            size_t fail_(regex_constants::error_type err)
+            {
+                if (!error_)
+                    error_ = err;
+
+                return npos;
+            }
+
+            /**
+             * 15.10.1, disjunction:
+             *   alternative | alternative '|' disjunction
+             */
+            size_t disjunction_()
+            {
+                auto first = alternative_();
+                if (error_ || !peek_('|'))
+                    return first;
+
+                vector<size_t> alternatives{first};
+                while (accept_('|'))
+                {
+                    auto alt = alternative_();
+                    if (error_)
+                        return npos;
+
+                    alternatives.push_back(alt);
+                }
+
+                auto res = add_(regex_node_kind::alternation);
+                nodes_[res].children = move(alternatives);
+
+                return res;
+            }
+
+            /**
+             * alternative:
+             *   [empty] | alternative term
+             */
+            size_t alternative_()
+            {
+                vector<size_t> terms{};
+                while (!eof_() && !peek_('|') && !peek_(')'))
+                {
+                    auto t = term_();
+                    if (error_)
+                        return npos;
+
+                    terms.push_back(t);
+                }
+
+                if (terms.empty())
+                    return add_(regex_node_kind::empty);
+                else if (terms.size() == 1)
+                    return terms.front();
+
+                auto res = add_(regex_node_kind::concat);
+                nodes_[res].children = move(terms);
+
+                return res;
+            }
+
+            /**
+             * term:
+             *   assertion | atom | atom quantifier
+             */
+            size_t term_()
+            {
+                auto c = pattern_[pos_];
+                size_t res{npos};
+
+                if (c == '^')
+                    res = add_(regex_node_kind::assertion, static_cast<uint32_t>(regex_op::bol));
+                else if (c == '$')
+                    res = add_(regex_node_kind::assertion, static_cast<uint32_t>(regex_op::eol));
+                else if (c == '\\' && pos_ + 1 < len_ && pattern_[pos_ + 1] == 'b')
+                    res = add_(regex_node_kind::assertion,
+                               static_cast<uint32_t>(regex_op::word_boundary));
+                else if (c == '\\' && pos_ + 1 < len_ && pattern_[pos_ + 1] == 'B')
+                    res = add_(regex_node_kind::assertion,
+                               static_cast<uint32_t>(regex_op::not_word_boundary));
+
+                if (res != npos)
+                {
+                    pos_ += (c == '\\') ? 2 : 1;
+
+                    size_t min, max, end;
+                    if (quantifier_(min, max, end))
+                        return fail_(regex_constants::error_badrepeat);
+
+                    return res;
+                }
+
+                auto atom = atom_();
+                if (error_)
+                    return npos;
+
+                size_t min, max, end;
+                if (!quantifier_(min, max, end))
+                    return atom;
+
+                if (min > max)
+                    return fail_(regex_constants::error_badbrace);
+                if (min > max_count || (max != unbounded && max > max_count))
+                    return fail_(regex_constants::error_complexity);
+
+                pos_ = end;
+                bool greedy = !accept_('?');
+
+                size_t dummy_min, dummy_max, dummy_end;
+                if (quantifier_(dummy_min, dummy_max, dummy_end))
+                    return fail_(regex_constants::error_badrepeat);
+
+                res = add_(regex_node_kind::repeat);
+                nodes_[res].min = min;
+                nodes_[res].max = max;
+                nodes_[res].greedy = greedy;
+                nodes_[res].children.push_back(atom);
+
+                return res;
+            }
+
+            /**
+             * Checks (without consuming it) whether a quantifier
+             * follows, end is set to the position after it.
+             * Note: As in Annex B of ECMAScript, braces that do
+             *       not form a quantifier are ordinary characters.
+             */
+            bool quantifier_(size_t& min, size_t& max, size_t& end) const
+            {
+                if (eof_())
+                    return false;
+
+                auto c = pattern_[pos_];
+                end = pos_ + 1;
+                if (c == '*')
+                {
+                    min = 0;
+                    max = unbounded;
+                    return true;
+                }
+                else if (c == '+')
+                {
+                    min = 1;
+                    max = unbounded;
+                    return true;
+                }
+                else if (c == '?')
+                {
+                    min = 0;
+                    max = 1;
+                    return true;
+                }
+                else if (c != '{')
+                    return false;
+
+                auto pos = pos_ + 1;
+                if (!number_(pos, min))
+                    return false;
+
+                max = min;
+                if (pos < len_ && pattern_[pos] == ',')
+                {
+                    ++pos;
+                    if (!number_(pos, max))
+                        max = unbounded;
+                }
+
+                if (pos >= len_ || pattern_[pos] != '}')
+                    return false;
+
+                end = pos + 1;
+
+                return true;
+            }
+
+            bool number_(size_t& pos, size_t& res) const
+            {
+                if (pos >= len_ || !is_digit(pattern_[pos]))
+                    return false;
+
+                res = 0;
+                while (pos < len_ && is_digit(pattern_[pos]))
+                {
+                    if (res <= max_count)
+                        res = res * 10 + (pattern_[pos] - '0');
+                    ++pos;
+                }
+
+                return true;
+            }
+
+            size_t atom_()
+            {
+                auto c = pattern_[pos_++];
+
+                switch (c)
+                {
+                    case '.':
+                        return add_(regex_node_kind::dot);
+                    case '(':
+                        return group_();
+                    case '[':
+                        return class_();
+                    case '\\':
+                        return atom_escape_();
+                    case '*':
+                    case '+':
+                    case '?':
+                        return fail_(regex_constants::error_badrepeat);
+                    case '{':
+                    {
+                        size_t min, max, end;
+                        --pos_;
+                        if (quantifier_(min, max, end))
+                            return fail_(regex_constants::error_badrepeat);
+                        ++pos_;
+
+                        return literal_(c);
+                    }
+                    default:
+                        return literal_(c);
+                }
+            }
+
+            /**
+             * Note: Lookahead assertions are not supported.
+             */
+            size_t group_()
+            {
+                bool capture{true};
+                if (accept_('?'))
+                {
+                    if (!accept_(':'))
+                        return fail_(regex_constants::error_paren);
+
+                    capture = false;
+                }
+
+                /**
+                 * Groups are numbered by their opening
+                 * parentheses, so the index is taken before
+                 * the nested groups are parsed.
+                 */
+                bool nosubs = flags_ & regex_constants::nosubs;
+                size_t idx{};
+                if (capture && !nosubs)
+                    idx = ++group_count_;
+
+                auto inner = disjunction_();
+                if (error_)
+                    return npos;
+
+                if (!accept_(')'))
+                    return fail_(regex_constants::error_paren);
+
+                if (idx == 0)
+                    return inner;
+
+                auto res = add_(regex_node_kind::group, static_cast<uint32_t>(idx));
+                nodes_[res].children.push_back(inner);
+
+                return res;
+            }
+
+            size_t literal_(uint32_t c)
+            {
+                if (prog_.icase_ && other_case(c) != c)
+                {
+                    regex_class cls{};
+                    cls.ranges.emplace_back(c, c);
+
+                    return add_(regex_node_kind::cls, finish_class_(move(cls)));
+                }
+
+                return add_(regex_node_kind::unit, c);
+            }
+
+            size_t atom_escape_()
+            {
+                if (eof_())
+                    return fail_(regex_constants::error_escape);
+
+                auto c = pattern_[pos_];
+                if ('1' <= c && c <= '9')
+                {
+                    size_t n{};
+                    number_(pos_, n);
+                    if (flags_ & regex_constants::nosubs)
+                        return fail_(regex_constants::error_backref);
+
+                    max_backref_ = std::max(max_backref_, n);
+                    prog_.has_backrefs_ = true;
+
+                    return add_(regex_node_kind::backref, static_cast<uint32_t>(n));
+                }
+
+                regex_class cls{};
+                if (class_escape_(cls))
+                    return add_(regex_node_kind::cls, finish_class_(move(cls)));
+
+                uint32_t unit{};
+                if (!char_escape_(unit))
+                    return npos;
+
+                return literal_(unit);
+            }
+
+            /**
+             * Parses \d, \D, \s, \S, \w and \W (the backslash has
+             * already been consumed) and adds the set to the class.
+             */
+            bool class_escape_(regex_class& cls)
+            {
+                auto c = pattern_[pos_];
+                const regex_ranges* set{nullptr};
+
+                switch (c)
+                {
+                    case 'd':
+                    case 'D':
+                        set = &digit_ranges;
+                        break;
+                    case 's':
+                    case 'S':
+                        set = &space_ranges;
+                        break;
+                    case 'w':
+                    case 'W':
+                        set = &word_ranges;
+                        break;
+                    default:
+                        return false;
+                }
+
+                ++pos_;
+                if ('a' <= c && c <= 'z')
+                {
+                    cls.ranges.insert(cls.ranges.end(), set->begin(), set->end());
+
+                    return true;
+                }
+
+                uint32_t next{};
+                for (const auto& range: *set)
+                {
+                    if (next < range.first)
+                        cls.ranges.emplace_back(next, range.first - 1);
+                    next = range.second + 1;
+                }
+                cls.ranges.emplace_back(next, max_unit);
+
+                return true;
+            }
+
+            /**
+             * Parses the escape of a single character (the backslash
+             * has already been consumed).
+             */
+            bool char_escape_(uint32_t& res)
+            {
+                auto c = pattern_[pos_++];
+
+                switch (c)
+                {
+                    case 'n':
+                        res = '\n';
+                        return true;
+                    case 'r':
+                        res = '\r';
+                        return true;
+                    case 't':
+                        res = '\t';
+                        return true;
+                    case 'v':
+                        res = '\v';
+                        return true;
+                    case 'f':
+                        res = '\f';
+                        return true;
+                    case '0':
+                        res = 0U;
+                        return true;
+                    case 'c':
+                        if (eof_() || other_case(pattern_[pos_]) == pattern_[pos_])
+                        {
+                            fail_(regex_constants::error_escape);
+                            return false;
+                        }
+
+                        res = pattern_[pos_++] % 32;
+                        return true;
+                    case 'x':
+                        return hex_(2, res);
+                    case 'u':
+                        return hex_(4, res);
+                    default:
+                        res = c;
+                        return true;
+                }
+            }
+
+            bool hex_(size_t digits, uint32_t& res)
+            {
+                res = 0U;
+                for (size_t i = 0; i < digits; ++i)
+                {
+                    auto val = eof_() ? -1 : hex_value(pattern_[pos_]);
+                    if (val < 0)
+                    {
+                        fail_(regex_constants::error_escape);
+                        return false;
+                    }
+
+                    res = res * 16 + val;
+                    ++pos_;
+                }
+
+                return true;
+            }
+
+            size_t class_()
+            {
+                regex_class cls{};
+                cls.negated = accept_('^');
+
+                while (true)
+                {
+                    if (eof_())
+                        return fail_(regex_constants::error_brack);
+
+                    if (accept_(']'))
+                        break;
+
+                    uint32_t low{};
+                    bool set{};
+                    if (!class_atom_(cls, low, set))
+                        return npos;
+
+                    if (set)
+                        continue;
+
+                    if (pos_ + 1 < len_ && pattern_[pos_] == '-' &&
+                        pattern_[pos_ + 1] != ']')
+                    {
+                        ++pos_;
+
+                        uint32_t high{};
+                        if (!class_atom_(cls, high, set))
+                            return npos;
+
+                        /**
+                         * Note: As in Annex B of ECMAScript, ranges
+                         *       with a class escape are taken as
+                         *       their separate characters.
+                         */
+                        if (set)
+                        {
+                            cls.ranges.emplace_back(low, low);
+                            cls.ranges.emplace_back('-', '-');
+                            continue;
+                        }
+
+                        if (low > high)
+                            return fail_(regex_constants::error_range);
+
+                        cls.ranges.emplace_back(low, high);
+                    }
+                    else
+                        cls.ranges.emplace_back(low, low);
+                }
+
+                return add_(regex_node_kind::cls, finish_class_(move(cls)));
+            }
+
+            bool class_atom_(regex_class& cls, uint32_t& unit, bool& set)
+            {
+                set = false;
+                if (!accept_('\\'))
+                {
+                    unit = pattern_[pos_++];
+                    return true;
+                }
+
+                if (eof_())
+                {
+                    fail_(regex_constants::error_escape);
+                    return false;
+                }
+
+                if (class_escape_(cls))
+                {
+                    set = true;
+                    return true;
+                }
+
+                if (accept_('b'))
+                {
+                    unit = '\b';
+                    return true;
+                }
+
+                return char_escape_(unit);
+            }
+
+            uint32_t finish_class_(regex_class&& cls)
+            {
+                for (uint32_t c = 0; c < 256; ++c)
+                {
+                    bool member{false};
+                    for (const auto& range: cls.ranges)
+                    {
+                        auto alt = prog_.icase_ ? other_case(c) : c;
+                        if ((range.first <= c && c <= range.second) ||
+                            (range.first <= alt && alt <= range.second))
+                        {
+                            member = true;
+                            break;
+                        }
+                    }
+
+                    if (member != cls.negated)
+                        cls.bits[c >> 6] |= uint64_t{1} << (c & 63);
+                }
+
+                prog_.classes_.push_back(move(cls));
+
+                return static_cast<uint32_t>(prog_.classes_.size() - 1);
+            }
+
+            size_t emit_(regex_op op, size_t x = 0U, size_t y = 0U)
+            {
+                prog_.insts_.push_back(regex_inst{
+                    op, static_cast<uint32_t>(x), static_cast<uint32_t>(y)
+                });
+
+                return prog_.insts_.size() - 1;
+            }
+
+            bool nullable_(size_t idx) const
+            {
+                const auto& node = nodes_[idx];
+
+                switch (node.kind)
+                {
+                    case regex_node_kind::unit:
+                    case regex_node_kind::dot:
+                    case regex_node_kind::cls:
+                        return false;
+                    case regex_node_kind::concat:
+                        for (auto child: node.children)
+                        {
+                            if (!nullable_(child))
+                                return false;
+                        }
+                        return true;
+                    case regex_node_kind::alternation:
+                        for (auto child: node.children)
+                        {
+                            if (nullable_(child))
+                                return true;
+                        }
+                        return false;
+                    case regex_node_kind::repeat:
+                        return node.min == 0 || nullable_(node.children.front());
+                    case regex_node_kind::group:
+                        return nullable_(node.children.front());
+                    default:
+                        return true;
+                }
+            }
+
+            bool emit_node_(size_t idx)
+            {
+                if (prog_.insts_.size() > max_insts)
+                {
+                    fail_(regex_constants::error_space);
+                    return false;
+                }
+
+                const auto& node = nodes_[idx];
+                switch (node.kind)
+                {
+                    case regex_node_kind::empty:
+                        return true;
+                    case regex_node_kind::unit:
+                        emit_(regex_op::unit, node.value);
+                        return true;
+                    case regex_node_kind::dot:
+                        emit_(regex_op::dot);
+                        return true;
+                    case regex_node_kind::cls:
+                        emit_(regex_op::cls, node.value);
+                        return true;
+                    case regex_node_kind::assertion:
+                    {
+                        auto op = static_cast<regex_op>(node.value);
+                        if (op == regex_op::word_boundary || op == regex_op::not_word_boundary)
+                            prog_.has_word_assertions_ = true;
+                        emit_(op);
+                        return true;
+                    }
+                    case regex_node_kind::backref:
+                        emit_(regex_op::backref, node.value);
+                        return true;
+                    case regex_node_kind::group:
+                        emit_(regex_op::save, 2 * node.value);
+                        if (!emit_node_(node.children.front()))
+                            return false;
+                        emit_(regex_op::save, 2 * node.value + 1);
+                        return true;
+                    case regex_node_kind::concat:
+                        for (auto child: node.children)
+                        {
+                            if (!emit_node_(child))
+                                return false;
+                        }
+                        return true;
+                    case regex_node_kind::alternation:
+                        return emit_alternation_(node);
+                    case regex_node_kind::repeat:
+                        return emit_repeat_(node);
+                }
+
+                return false;
+            }
+
+            bool emit_alternation_(const regex_node& node)
+            {
+                vector<size_t> jumps{};
+                auto count = node.children.size();
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    size_t split{};
+                    if (i + 1 < count)
+                        split = emit_(regex_op::split, prog_.insts_.size() + 1);
+
+                    if (!emit_node_(node.children[i]))
+                        return false;
+
+                    if (i + 1 < count)
+                    {
+                        jumps.push_back(emit_(regex_op::jump));
+                        prog_.insts_[split].y = prog_.insts_.size();
+                    }
+                }
+
+                for (auto jump: jumps)
+                    prog_.insts_[jump].x = prog_.insts_.size();
+
+                return true;
+            }
+
+            bool emit_repeat_(const regex_node& node)
+            {
+                auto child = node.children.front();
+                for (size_t i = 0; i < node.min; ++i)
+                {
+                    if (!emit_node_(child))
+                        return false;
+                }
+
+                if (node.max == unbounded)
+                {
+                    /**
+                     * ECMAScript stops an iteration that did not
+                     * consume any input, which the backtracker checks
+                     * with a counter. The automata do not need it, as
+                     * they never visit a state twice at a position.
+                     */
+                    bool nullable = nullable_(child);
+                    auto counter = prog_.counter_count_;
+                    if (nullable)
+                        ++prog_.counter_count_;
+
+                    auto loop = emit_(regex_op::split);
+                    auto body = prog_.insts_.size();
+                    if (nullable)
+                        emit_(regex_op::mark, counter);
+
+                    if (!emit_node_(child))
+                        return false;
+
+                    if (nullable)
+                        emit_(regex_op::check, counter);
+                    emit_(regex_op::jump, loop);
+
+                    set_split_(loop, body, prog_.insts_.size(), node.greedy);
+
+                    return true;
+                }
+
+                vector<size_t> splits{};
+                for (size_t i = node.min; i < node.max; ++i)
+                {
+                    splits.push_back(emit_(regex_op::split));
+                    if (!emit_node_(child))
+                        return false;
+                }
+
+                auto end = prog_.insts_.size();
+                for (auto split: splits)
+                    set_split_(split, split + 1, end, node.greedy);
+
+                return true;
+            }
+
+            void set_split_(size_t split, size_t body, size_t out, bool greedy)
+            {
+                auto& inst = prog_.insts_[split];
+                inst.x = static_cast<uint32_t>(greedy ? body : out);
+                inst.y = static_cast<uint32_t>(greedy ? out : body);
+            }
+    };
+
+    regex_constants::error_type regex_program::compile(
+        const uint32_t* pattern, size_t len,
+        regex_constants::syntax_option_type flags
+    )
+    {
+        *this = regex_program{};
+
+        regex_compiler compiler{*this, pattern, len, flags};
+
+        return compiler.compile();
+    }
+
+    regex_dfa::regex_dfa(const regex_program& prog)
+        : prog_{prog}, unit_classes_{}, representatives_{}, class_count_{1},
+          stride_{}, max_states_{}, keys_{}, states_{}, next_{}, accept_{},
+          idle_{}, stack_{}, visited_(prog.size()), generation_{}
+    {
+        /**
+         * Refine the partition of the units by every
+         * predicate the program can test them with.
+         */
+        auto refine = [this](auto pred){
+            int16_t ids[256][2];
+            for (auto& id: ids)
+                id[0] = id[1] = -1;
+
+            size_t count{};
+            for (uint32_t c = 0; c < 256; ++c)
+            {
+                auto& id = ids[unit_classes_[c]][pred(c) ? 1 : 0];
+                if (id < 0)
+                    id = static_cast<int16_t>(count++);
+
+                unit_classes_[c] = static_cast<uint8_t>(id);
+            }
+
+            class_count_ = count;
+        };
+
+        bool seen[256]{};
+        for (size_t pc = 0; pc < prog_.size(); ++pc)
+        {
+            const auto& inst = prog_[pc];
+            if (inst.op == regex_op::unit && inst.x < 256 && !seen[inst.x])
+            {
+                seen[inst.x] = true;
+                refine([&inst](uint32_t c){ return c == inst.x; });
+            }
+        }
+
+        for (size_t idx = 0; idx < prog_.class_count(); ++idx)
+        {
+            const auto& cls = prog_.get_class(idx);
+            refine([&cls](uint32_t c){ return cls.contains(c); });
+        }
+
+        refine([](uint32_t c){ return regex_program::is_line_terminator(c); });
+        if (prog_.has_word_assertions())
+            refine([](uint32_t c){ return regex_program::is_word(c); });
+
+        for (uint32_t c = 256; c > 0; --c)
+            representatives_[unit_classes_[c - 1]] = static_cast<uint8_t>(c - 1);
+
+        stride_ = class_count_ + 1;
+        max_states_ = std::max(
+            size_t{16}, memory_budget / (stride_ * (sizeof(int) + sizeof(uint8_t)))
+        );
+    }
+
+    int regex_dfa::start(bool anchored, bool bol, bool prev_word)
+    {
+        if (keys_.empty())
+            flush_();
+
+        uint32_t flags{};
+        if (bol)
+            flags |= bol_flag;
+        if (prev_word && prog_.has_word_assertions())
+            flags |= word_flag;
+
+        vector<uint32_t> key{
+            static_cast<uint32_t>(anchored ? prog_.anchored_start() : prog_.unanchored_start()),
+            flags
+        };
+
+        auto res = insert_(key);
+        if (res < 0)
+        {
+            flush_();
+            res = insert_(key);
+        }
+
+        return res;
+    }
+
+    int regex_dfa::compute_(int state, size_t cls, bool& accept)
+    {
+        const auto& key = keys_[state];
+        auto flags = key.back();
+        bool at_end = cls == class_count_;
+        uint32_t c = at_end ? 0U : representatives_[cls];
+
+        regex_context ctx{};
+        ctx.bol = flags & bol_flag;
+        ctx.eol = at_end || (prog_.multiline() && regex_program::is_line_terminator(c));
+        ctx.boundary = static_cast<bool>(flags & word_flag) !=
+                       (!at_end && regex_program::is_word(c));
+
+        if (++generation_ == 0)
+        {
+            fill(visited_.begin(), visited_.end(), 0U);
+            generation_ = 1;
+        }
+
+        stack_.assign(key.begin(), key.end() - 1);
+
+        vector<uint32_t> next_key{};
+        accept = false;
+        while (!stack_.empty())
+        {
+            auto pc = stack_.back();
+            stack_.pop_back();
+
+            if (visited_[pc] == generation_)
+                continue;
+            visited_[pc] = generation_;
+
+            const auto& inst = prog_[pc];
+            switch (inst.op)
+            {
+                case regex_op::jump:
+                    stack_.push_back(inst.x);
+                    break;
+                case regex_op::split:
+                    stack_.push_back(inst.y);
+                    stack_.push_back(inst.x);
+                    break;
+                case regex_op::save:
+                case regex_op::mark:
+                case regex_op::check:
+                    stack_.push_back(pc + 1);
+                    break;
+                case regex_op::bol:
+                case regex_op::eol:
+                case regex_op::word_boundary:
+                case regex_op::not_word_boundary:
+                    if (regex_program::holds(inst, ctx))
+                        stack_.push_back(pc + 1);
+                    break;
+                case regex_op::match:
+                    accept = true;
+                    break;
+                case regex_op::backref:
+                    break;
+                default:
+                    if (!at_end && prog_.matches(inst, c))
+                        next_key.push_back(pc + 1);
+                    break;
+            }
+        }
+
+        int res{dead};
+        if (!next_key.empty())
+        {
+            sort(next_key.begin(), next_key.end());
+            next_key.erase(unique(next_key.begin(), next_key.end()), next_key.end());
+
+            uint32_t next_flags{};
+            if (prog_.multiline() && regex_program::is_line_terminator(c))
+                next_flags |= bol_flag;
+            if (prog_.has_word_assertions() && regex_program::is_word(c))
+                next_flags |= word_flag;
+            next_key.push_back(next_flags);
+
+            res = insert_(next_key);
+            if (res < 0)
+            {
+                /**
+                 * The cache is full, start over with the new
+                 * state, the transition table of the current
+                 * state is gone with the rest of the cache.
+                 */
+                flush_();
+
+                return insert_(next_key);
+            }
+        }
+
+        auto idx = static_cast<size_t>(state) * stride_ + cls;
+        next_[idx] = res;
+        accept_[idx] = accept;
+
+        return res;
+    }
+
+    int regex_dfa::insert_(const vector<uint32_t>& key)
+    {
+        auto it = states_.find(key);
+        if (it != states_.end())
+            return it->second;
+
+        if (keys_.size() >= max_states_)
+            return -1;
+
+        bool idle{true};
+        for (auto pc = key.begin(); pc != key.end() - 1; ++pc)
+        {
+            if (*pc < prog_.unanchored_start())
+            {
+                idle = false;
+                break;
+            }
+        }
+
+        auto res = static_cast<int>(keys_.size());
+        keys_.push_back(key);
+        states_.emplace(key, res);
+        next_.resize(next_.size() + stride_, -1);
+        accept_.resize(accept_.size() + stride_, 0U);
+        idle_.push_back(idle);
+
+        return res;
+    }
+
+    void regex_dfa::flush_()
+    {
+        keys_.clear();
+        states_.clear();
+        next_.clear();
+        accept_.clear();
+        idle_.clear();
+
+        /**
+         * The dead state has no NFA states, all of its
+         * transitions lead back to it.
+         */
+        insert_(vector<uint32_t>{0U});
+        fill(next_.begin(), next_.end(), dead);
+    }
+}
@@ -27,6 +27,8 @@
  */
 
 #include <cassert>
+#include <charconv>
+#include <limits>
 #include <string>
 
 namespace std
@@ -105,108 +107,79 @@ namespace std
         return 0.0l;
     }
 
-    namespace hel
-    {
-        extern "C" int asprintf(char**, const char*, ...);
-    }
-
     string to_string(int val)
     {
-        char* tmp;
-        hel::asprintf(&tmp, "%d", val);
+        char buf[numeric_limits<int>::digits10 + 3];
+        auto res = to_chars(buf, buf + sizeof(buf), val);
 
-        std::string res{tmp};
-        free(tmp);
-
-        return res;
+        return string{buf, static_cast<size_t>(res.ptr - buf)};
     }
 
     string to_string(unsigned val)
     {
-        char* tmp;
-        hel::asprintf(&tmp, "%u", val);
-
-        std::string res{tmp};
-        free(tmp);
+        char buf[numeric_limits<unsigned>::digits10 + 3];
+        auto res = to_chars(buf, buf + sizeof(buf), val);
 
-        return res;
+        return string{buf, static_cast<size_t>(res.ptr - buf)};
     }
 
     string to_string(long val)
     {
-        char* tmp;
-        hel::asprintf(&tmp, "%ld", val);
-
-        std::string res{tmp};
-        free(tmp);
+        char buf[numeric_limits<long>::digits10 + 3];
+        auto res = to_chars(buf, buf + sizeof(buf), val);
 
-        return res;
+        return string{buf, static_cast<size_t>(res.ptr - buf)};
     }
 
     string to_string(unsigned long val)
     {
-        char* tmp;
-        hel::asprintf(&tmp, "%lu", val);
+        char buf[numeric_limits<unsigned long>::digits10 + 3];
+        auto res = to_chars(buf, buf + sizeof(buf), val);
 
-        std::string res{tmp};
-        free(tmp);
-
-        return res;
+        return string{buf, static_cast<size_t>(res.ptr - buf)};
     }
 
     string to_string(long long val)
     {
-        char* tmp;
-        hel::asprintf(&tmp, "%lld", val);
-
-        std::string res{tmp};
-        free(tmp);
+        char buf[numeric_limits<long long>::digits10 + 3];
+        auto res = to_chars(buf, buf + sizeof(buf), val);
 
-        return res;
+        return string{buf, static_cast<size_t>(res.ptr - buf)};
     }
 
     string to_string(unsigned long long val)
     {
-        char* tmp;
-        hel::asprintf(&tmp, "%llu", val);
-
-        std::string res{tmp};
-        free(tmp);
+        char buf[numeric_limits<unsigned long long>::digits10 + 3];
+        auto res = to_chars(buf, buf + sizeof(buf), val);
 
-        return res;
+        return string{buf, static_cast<size_t>(res.ptr - buf)};
     }
 
     string to_string(float val)
     {
-        char* tmp;
-        hel::asprintf(&tmp, "%f", val);
+        // Note: Same as %f, but the buffer has to fit DBL_MAX.
+        char buf[numeric_limits<double>::max_exponent10 + 16];
+        auto res = to_chars(buf, buf + sizeof(buf), val, chars_format::fixed, 6);
 
-        std::string res{tmp};
-        free(tmp);
-
-        return res;
+        return string{buf, static_cast<size_t>(res.ptr - buf)};
     }
 
     string to_string(double val)
     {
-        char* tmp;
-        hel::asprintf(&tmp, "%f", val);
-
-        std::string res{tmp};
-        free(tmp);
+        // Note: Same as %f, but the buffer has to fit DBL_MAX.
+        char buf[numeric_limits<double>::max_exponent10 + 16];
+        auto res = to_chars(buf, buf + sizeof(buf), val, chars_format::fixed, 6);
 
-        return res;
+        return string{buf, static_cast<size_t>(res.ptr - buf)};
     }
 
     string to_string(long double val)
     {
-        char* tmp;
-        hel::asprintf(&tmp, "%Lf", val);
-
-        std::string res{tmp};
-        free(tmp);
+        // Note: Same as %f, but the buffer has to fit DBL_MAX.
+        char buf[numeric_limits<double>::max_exponent10 + 16];
+        auto res = to_chars(buf, buf + sizeof(buf), val, chars_format::fixed, 6);
 
-        return res;
+        return string{buf, static_cast<size_t>(res.ptr - buf)};
     }
 
     int stoi(const wstring& str, size_t* idx, int base)
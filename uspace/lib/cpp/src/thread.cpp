@@ -32,6 +32,19 @@
 #include <thread>
 #include <utility>
 
+namespace std::hel
+{
+    extern "C" {
+        #include <abi/sysinfo.h>
+
+        /**
+         * Note: Declared here, because <stats.h> includes
+         *       <task.h>, which does not compile as C++.
+         */
+        stats_cpu_t* stats_get_cpus(size_t*);
+    }
+}
+
 namespace std
 {
     thread::thread() noexcept
@@ -97,7 +110,8 @@ namespace std
 
         if (joinable_wrapper_)
         {
-            joinable_wrapper_->detach();
+            if (joinable_wrapper_->detach())
+                delete joinable_wrapper_;
             joinable_wrapper_ = nullptr;
         }
     }
@@ -119,9 +133,20 @@ namespace std
 
     unsigned thread::hardware_concurrency() noexcept
     {
-        // TODO:
-        __unimplemented();
-        return 0;
+        size_t count{};
+        auto cpus = hel::stats_get_cpus(&count);
+        if (!cpus)
+            return 0;
+
+        unsigned res{};
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (cpus[i].active)
+                ++res;
+        }
+        hel::free(cpus);
+
+        return res;
     }
 
     void swap(thread& x, thread& y) noexcept